@@ -0,0 +1,353 @@
+// asset_cache.cpp
+#include "asset_cache.h"
+#include "profiler.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+// A full mip chain adds a third on top of the base level
+uint64_t imageBytes(int width, int height, int format, int mipmaps) {
+    uint64_t base = static_cast<uint64_t>(GetPixelDataSize(width, height, format));
+    return mipmaps > 1 ? base * 4 / 3 : base;
+}
+
+}  // namespace
+
+AssetCache::~AssetCache() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        running_ = false;
+    }
+    queue_cv_.notify_all();
+    if (loader_thread_.joinable()) {
+        loader_thread_.join();
+    }
+    // Images the main thread never took; CPU memory only
+    for (size_t i = upload_cursor_; i < uploading_.size(); ++i) {
+        UnloadImage(uploading_[i].image);
+    }
+    for (Decoded& done : completed_) {
+        UnloadImage(done.image);
+    }
+}
+
+AssetHandle AssetCache::acquire(const std::string& path, AssetType type) {
+    std::string normalized = normalizePath(path);
+
+    auto it = by_path_.find(normalized);
+    if (it != by_path_.end()) {
+        Entry& entry = entries_[it->second];
+        if (entry.type != type) {
+            std::cout << "ASSET CACHE: " << normalized << " is already cached as another type" << std::endl;
+            return AssetHandle{};
+        }
+        ++entry.references;
+        entry.last_used = frame_;
+        ++hits_;
+        return {it->second, entry.generation};
+    }
+
+    uint32_t slot;
+    if (!free_slots_.empty()) {
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(entries_.size());
+        entries_.emplace_back();
+    }
+    Entry& entry = entries_[slot];
+    uint32_t generation = entry.generation + 1;
+    entry = Entry{};
+    entry.path = normalized;
+    entry.type = type;
+    entry.state = State::LOADING;
+    entry.generation = generation;
+    entry.references = 1;
+    entry.last_used = frame_;
+    by_path_[normalized] = slot;
+    ++misses_;
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        load_queue_.push({slot, generation, normalized, type});
+        if (!running_) {
+            running_ = true;
+            loader_thread_ = std::thread(&AssetCache::loaderLoop, this);
+        }
+    }
+    queue_cv_.notify_one();
+    return {slot, generation};
+}
+
+void AssetCache::retain(AssetHandle handle) {
+    if (Entry* entry = find(handle)) {
+        ++entry->references;
+    }
+}
+
+void AssetCache::release(AssetHandle handle) {
+    Entry* entry = find(handle);
+    if (entry && entry->references > 0) {
+        --entry->references;
+    }
+}
+
+AssetCache::State AssetCache::getState(AssetHandle handle) const {
+    const Entry* entry = find(handle);
+    return entry ? entry->state : State::NONE;
+}
+
+const Texture2D* AssetCache::getTexture(AssetHandle handle) {
+    Entry* entry = find(handle);
+    if (!entry || entry->state != State::READY || entry->type != AssetType::TEXTURE) return nullptr;
+    entry->last_used = frame_;
+    return &entry->texture;
+}
+
+const Model* AssetCache::getModel(AssetHandle handle) {
+    Entry* entry = find(handle);
+    if (!entry || entry->state != State::READY || entry->type != AssetType::MODEL) return nullptr;
+    entry->last_used = frame_;
+    return &entry->model;
+}
+
+int AssetCache::processUploads(float budgetMs) {
+    int uploaded = 0;
+    if (upload_cursor_ >= uploading_.size()) {
+        // Only lock to swap buffers; the loader never waits on uploads
+        uploading_.clear();
+        upload_cursor_ = 0;
+        std::lock_guard<std::mutex> lock(completed_mutex_);
+        uploading_.swap(completed_);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto budget = std::chrono::duration<float, std::milli>(budgetMs);
+    while (upload_cursor_ < uploading_.size()) {
+        Decoded& done = uploading_[upload_cursor_++];
+        Entry* entry = find({done.slot, done.generation});
+        if (entry && entry->state == State::LOADING) {
+            upload(*entry, done);
+            if (entry->state == State::READY) ++uploaded;
+        }
+        if (done.image.data != nullptr) {
+            decoded_bytes_.fetch_sub(imageBytes(done.image.width, done.image.height, done.image.format, done.image.mipmaps),
+                                     std::memory_order_relaxed);
+            UnloadImage(done.image);
+            done.image = Image{};
+        }
+
+        // Always upload at least one so a tight budget still makes progress
+        if (std::chrono::steady_clock::now() - start >= budget) break;
+    }
+
+    evictToBudget();
+    updateStats();
+    ++frame_;
+    return uploaded;
+}
+
+void AssetCache::setBudget(uint64_t gpuBytes, uint64_t cpuBytes) {
+    gpu_budget_ = gpuBytes;
+    cpu_budget_ = cpuBytes;
+}
+
+void AssetCache::unloadAll() {
+    for (Entry& entry : entries_) {
+        if (entry.state == State::NONE) continue;
+        unload(entry);
+    }
+    by_path_.clear();
+    free_slots_.clear();
+    for (uint32_t slot = static_cast<uint32_t>(entries_.size()); slot > 0; --slot) {
+        free_slots_.push_back(slot - 1);
+    }
+    updateStats();
+}
+
+AssetCache::Entry* AssetCache::find(AssetHandle handle) {
+    if (!handle.isValid() || handle.slot >= entries_.size()) return nullptr;
+    Entry& entry = entries_[handle.slot];
+    return entry.generation == handle.generation && entry.state != State::NONE ? &entry : nullptr;
+}
+
+const AssetCache::Entry* AssetCache::find(AssetHandle handle) const {
+    return const_cast<AssetCache*>(this)->find(handle);
+}
+
+void AssetCache::upload(Entry& entry, Decoded& done) {
+    if (!done.ok) {
+        entry.state = State::FAILED;
+        return;
+    }
+
+    if (entry.type == AssetType::TEXTURE) {
+        entry.texture = LoadTextureFromImage(done.image);
+        if (entry.texture.id == 0) {
+            entry.state = State::FAILED;
+            return;
+        }
+        if (entry.texture.mipmaps > 1) {
+            SetTextureFilter(entry.texture, TEXTURE_FILTER_TRILINEAR);
+        }
+        entry.gpu_bytes = imageBytes(entry.texture.width, entry.texture.height, entry.texture.format, entry.texture.mipmaps);
+    } else {
+        entry.model = LoadModel(entry.path.c_str());
+        if (entry.model.meshCount == 0) {
+            UnloadModel(entry.model);
+            entry.model = Model{};
+            entry.state = State::FAILED;
+            return;
+        }
+        for (int i = 0; i < entry.model.meshCount; ++i) {
+            entry.cpu_bytes += meshBytes(entry.model.meshes[i]);
+        }
+        entry.gpu_bytes = entry.cpu_bytes;  // raylib keeps a CPU copy of every buffer it uploads
+        for (int i = 0; i < entry.model.materialCount; ++i) {
+            Texture2D map = entry.model.materials[i].maps[MATERIAL_MAP_DIFFUSE].texture;
+            if (map.id != 0 && map.id != rlGetTextureIdDefault()) {
+                entry.gpu_bytes += imageBytes(map.width, map.height, map.format, map.mipmaps);
+            }
+        }
+    }
+    gpu_bytes_ += entry.gpu_bytes;
+    cpu_bytes_ += entry.cpu_bytes;
+    entry.state = State::READY;
+}
+
+void AssetCache::unload(Entry& entry) {
+    if (entry.state == State::READY) {
+        if (entry.type == AssetType::TEXTURE) {
+            UnloadTexture(entry.texture);
+        } else {
+            UnloadModel(entry.model);
+        }
+        gpu_bytes_ -= entry.gpu_bytes;
+        cpu_bytes_ -= entry.cpu_bytes;
+    }
+    // Generation survives the reset, so handles to this slot go stale instead of aliasing its next asset
+    uint32_t generation = entry.generation;
+    entry = Entry{};
+    entry.generation = generation;
+}
+
+void AssetCache::evictToBudget() {
+    uint64_t decoded = decoded_bytes_.load(std::memory_order_relaxed);
+    if (gpu_bytes_ <= gpu_budget_ && cpu_bytes_ + decoded <= cpu_budget_) return;
+
+    std::vector<uint32_t> candidates;
+    for (uint32_t slot = 0; slot < entries_.size(); ++slot) {
+        const Entry& entry = entries_[slot];
+        if (entry.state == State::READY && entry.references == 0) {
+            candidates.push_back(slot);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [this](uint32_t a, uint32_t b) { return entries_[a].last_used < entries_[b].last_used; });
+
+    for (uint32_t slot : candidates) {
+        if (gpu_bytes_ <= gpu_budget_ && cpu_bytes_ + decoded <= cpu_budget_) break;
+        Entry& entry = entries_[slot];
+        by_path_.erase(entry.path);
+        unload(entry);
+        free_slots_.push_back(slot);
+        ++evictions_;
+    }
+}
+
+void AssetCache::updateStats() {
+    AssetCacheStats stats;
+    for (const Entry& entry : entries_) {
+        if (entry.state == State::NONE) continue;
+        ++stats.assets;
+        if (entry.references > 0) ++stats.referenced;
+        if (entry.state == State::LOADING) ++stats.loading;
+        if (entry.state == State::FAILED) ++stats.failed;
+    }
+    stats.gpuBytes = gpu_bytes_;
+    stats.cpuBytes = cpu_bytes_ + decoded_bytes_.load(std::memory_order_relaxed);
+    stats.gpuBudget = gpu_budget_;
+    stats.cpuBudget = cpu_budget_;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.evictions = evictions_;
+    stats_ = stats;
+
+    Profiler& profiler = Profiler::getInstance();
+    if (!profiler.isEnabled()) return;
+    ProfileCounter counter;
+    counter.name = "Assets";
+    counter.time_ns = Profiler::now();
+    counter.series[0] = "GPU MB";
+    counter.values[0] = static_cast<double>(stats.gpuBytes) / (1024.0 * 1024.0);
+    counter.series[1] = "CPU MB";
+    counter.values[1] = static_cast<double>(stats.cpuBytes) / (1024.0 * 1024.0);
+    counter.series[2] = "loading";
+    counter.values[2] = stats.loading;
+    counter.series[3] = "evictions";
+    counter.values[3] = static_cast<double>(stats.evictions);
+    counter.series_count = 4;
+    profiler.recordCounter(counter);
+}
+
+void AssetCache::loaderLoop() {
+    Profiler::getInstance().setThreadName("Asset Loader");
+    while (true) {
+        LoadRequest request;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return !running_ || !load_queue_.empty(); });
+            if (!running_) return;
+            request = std::move(load_queue_.front());
+            load_queue_.pop();
+        }
+
+        Decoded result;
+        result.slot = request.slot;
+        result.generation = request.generation;
+        if (request.type == AssetType::TEXTURE) {
+            // Decode and build the mip chain here; the main thread only copies pixels to the GPU
+            result.image = LoadImage(request.path.c_str());
+            result.ok = result.image.data != nullptr;
+            if (result.ok) {
+                ImageMipmaps(&result.image);
+                decoded_bytes_.fetch_add(imageBytes(result.image.width, result.image.height, result.image.format, result.image.mipmaps),
+                                         std::memory_order_relaxed);
+            }
+        } else {
+            result.ok = FileExists(request.path.c_str());
+        }
+        if (!result.ok) {
+            std::cout << "ASSET CACHE: Failed to load " << request.path << std::endl;
+        }
+
+        // Failures are handed over too, so the main thread marks them and stops waiting
+        std::lock_guard<std::mutex> lock(completed_mutex_);
+        completed_.push_back(std::move(result));
+    }
+}
+
+std::string AssetCache::normalizePath(const std::string& path) {
+    std::string normalized = path;
+    std::replace(normalized.begin(), normalized.end(), '\\', '/');
+    while (normalized.compare(0, 2, "./") == 0) {
+        normalized.erase(0, 2);
+    }
+    return normalized;
+}
+
+uint64_t AssetCache::meshBytes(const Mesh& mesh) {
+    uint64_t vertices = static_cast<uint64_t>(mesh.vertexCount);
+    uint64_t bytes = 0;
+    if (mesh.vertices) bytes += vertices * 3 * sizeof(float);
+    if (mesh.texcoords) bytes += vertices * 2 * sizeof(float);
+    if (mesh.texcoords2) bytes += vertices * 2 * sizeof(float);
+    if (mesh.normals) bytes += vertices * 3 * sizeof(float);
+    if (mesh.tangents) bytes += vertices * 4 * sizeof(float);
+    if (mesh.colors) bytes += vertices * 4;
+    if (mesh.indices) bytes += static_cast<uint64_t>(mesh.triangleCount) * 3 * sizeof(unsigned short);
+    return bytes;
+}
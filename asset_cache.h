@@ -0,0 +1,167 @@
+// asset_cache.h - Reference-counted texture and model cache with a residency budget
+#ifndef ASSET_CACHE_H
+#define ASSET_CACHE_H
+
+#include "raylib.h"
+#include "constants.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class AssetType : uint8_t { TEXTURE, MODEL };
+
+/// \brief Names one cached asset. Stays safe to use after the asset is gone: lookups check
+/// the generation and return null for a slot that has since been reused.
+struct AssetHandle {
+    uint32_t slot = 0;
+    uint32_t generation = 0;    // 0 is never issued
+
+    bool isValid() const { return generation != 0; }
+};
+
+/// \brief AssetCache numbers as of the last processUploads().
+struct AssetCacheStats {
+    uint32_t assets = 0;        // Entries in any state
+    uint32_t referenced = 0;    // Entries somebody holds a handle to
+    uint32_t loading = 0;
+    uint32_t failed = 0;
+    uint64_t gpuBytes = 0;      // Texture and mesh data uploaded
+    uint64_t cpuBytes = 0;      // Decoded images awaiting upload and the mesh copies raylib keeps
+    uint64_t gpuBudget = 0;
+    uint64_t cpuBudget = 0;
+    uint64_t hits = 0;          // acquire() calls that found the path cached
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+};
+
+/// \brief One owner for every texture and model file the game draws.
+///
+/// acquire() deduplicates by the normalised path and hands out a handle with a
+/// reference; release() drops it. Textures decode on a loader thread and upload on the main
+/// thread within a per-frame time budget, like theme fonts. Models load on the main thread
+/// within the same budget, since raylib's LoadModel uploads meshes as it parses them.
+///
+/// Unreferenced assets stay resident so a path that comes back is free. Once the GPU or CPU
+/// total passes its budget, the least recently drawn unreferenced assets are unloaded;
+/// referenced ones never are, so a budget too small for the working set is only exceeded.
+///
+/// Main thread only, apart from the loader thread it owns.
+class AssetCache {
+public:
+    enum class State : uint8_t { NONE, LOADING, READY, FAILED };
+
+    static AssetCache& getInstance() {
+        static AssetCache instance;
+        return instance;
+    }
+
+    /// \brief Gets a referenced handle to a file, queueing its load on first use.
+    /// \param path Texture or model file path.
+    /// \param type What the file holds; a path is cached as one type only.
+    AssetHandle acquire(const std::string& path, AssetType type);
+
+    /// \brief Adds a reference to a handle from acquire(), for a second owner.
+    void retain(AssetHandle handle);
+
+    /// \brief Drops a reference. At zero the asset becomes evictable; it isn't unloaded yet.
+    void release(AssetHandle handle);
+
+    State getState(AssetHandle handle) const;
+
+    /// \brief Gets a loaded texture and marks it used this frame; null until it is ready.
+    const Texture2D* getTexture(AssetHandle handle);
+
+    /// \brief Gets a loaded model and marks it used this frame; null until it is ready.
+    const Model* getModel(AssetHandle handle);
+
+    /// \brief Uploads finished decodes and loads models until the time budget runs out, then
+    /// evicts down to the budgets and starts a new frame. Call once a frame; needs the GL context.
+    /// \return Number of assets that became ready.
+    int processUploads(float budgetMs = AssetConstants::UPLOAD_BUDGET_MS);
+
+    /// \brief Sets the residency budgets; eviction happens at the next processUploads().
+    void setBudget(uint64_t gpuBytes, uint64_t cpuBytes);
+
+    const AssetCacheStats& getStats() const { return stats_; }
+
+    /// \brief Unloads every asset, referenced or not; outstanding handles go stale. Needs the GL context.
+    void unloadAll();
+
+private:
+    AssetCache() = default;
+    ~AssetCache();
+    AssetCache(const AssetCache&) = delete;
+    AssetCache& operator=(const AssetCache&) = delete;
+
+    struct Entry {
+        std::string path;
+        AssetType type = AssetType::TEXTURE;
+        State state = State::NONE;
+        uint32_t generation = 0;
+        uint32_t references = 0;
+        uint64_t last_used = 0;         // Frame of the last lookup, for LRU eviction
+        uint64_t gpu_bytes = 0;
+        uint64_t cpu_bytes = 0;
+        Texture2D texture{};
+        Model model{};
+    };
+
+    struct LoadRequest {
+        uint32_t slot;
+        uint32_t generation;
+        std::string path;
+        AssetType type;
+    };
+
+    // Loader output: a texture's pixels still on the CPU, or a model ready for the main thread
+    struct Decoded {
+        uint32_t slot = 0;
+        uint32_t generation = 0;
+        bool ok = false;
+        Image image{};
+    };
+
+    Entry* find(AssetHandle handle);
+    const Entry* find(AssetHandle handle) const;
+    void upload(Entry& entry, Decoded& done);
+    void unload(Entry& entry);
+    void evictToBudget();
+    void updateStats();
+    void loaderLoop();
+    static std::string normalizePath(const std::string& path);
+    static uint64_t meshBytes(const Mesh& mesh);
+
+    std::vector<Entry> entries_;                        // Indexed by handle slot
+    std::vector<uint32_t> free_slots_;
+    std::unordered_map<std::string, uint32_t> by_path_; // Normalised path to slot
+    uint64_t frame_ = 1;
+    uint64_t gpu_bytes_ = 0;
+    uint64_t cpu_bytes_ = 0;
+    uint64_t gpu_budget_ = AssetConstants::GPU_BUDGET_MB * 1024ull * 1024ull;
+    uint64_t cpu_budget_ = AssetConstants::CPU_BUDGET_MB * 1024ull * 1024ull;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+    AssetCacheStats stats_;
+
+    std::queue<LoadRequest> load_queue_;
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+
+    std::vector<Decoded> completed_;        // Filled by the loader under completed_mutex_
+    std::mutex completed_mutex_;
+    std::vector<Decoded> uploading_;        // Main thread only; swapped with completed_
+    size_t upload_cursor_ = 0;
+    std::atomic<uint64_t> decoded_bytes_{0};  // Image bytes decoded but not yet uploaded
+
+    std::thread loader_thread_;
+    bool running_ = false;                  // Guarded by queue_mutex_
+};
+
+#endif // ASSET_CACHE_H
@@ -0,0 +1,148 @@
+// async_log.cpp
+#include "async_log.h"
+#include "profiler.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    constexpr auto IDLE_WAIT = std::chrono::milliseconds(5);   // Drain period while traffic is light
+
+    const char* CATEGORY_NAMES[DEBUG_CATEGORY_COUNT] = {
+        "GENERAL", "UI", "INVENTORY", "RENDERING", "THEME", "INPUT", "MEMORY", "PERFORMANCE",
+        "ENVIRONMENT", "COLLISION", "INTERACTION", "PLAYER"
+    };
+    const char* LEVEL_NAMES[] = {"NONE", "BASIC", "DETAILED", "VERBOSE", "TRACE"};
+}
+
+std::atomic<int8_t> AsyncLog::levels_[DEBUG_CATEGORY_COUNT] = {};
+
+AsyncLog::~AsyncLog() {
+    stop();
+}
+
+bool AsyncLog::start(const std::string& path, int defaultLevel) {
+    stop();
+    file_ = std::fopen(path.c_str(), "w");
+    if (!file_) {
+        std::cout << "LOG: Cannot open " << path << ", logging disabled" << std::endl;
+        return false;
+    }
+    start_time_ = std::chrono::steady_clock::now().time_since_epoch().count();
+    running_.store(true, std::memory_order_relaxed);
+    thread_ = std::thread(&AsyncLog::drainLoop, this);
+    for (int c = 0; c < DEBUG_CATEGORY_COUNT; c++) {
+        setLevel(static_cast<DebugCategory>(c), defaultLevel);
+    }
+    std::cout << "LOG: Writing level " << defaultLevel << " and below to " << path << std::endl;
+    return true;
+}
+
+void AsyncLog::stop() {
+    for (int c = 0; c < DEBUG_CATEGORY_COUNT; c++) {
+        setLevel(static_cast<DebugCategory>(c), DEBUG_NONE);
+    }
+    if (thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            running_.store(false, std::memory_order_relaxed);
+        }
+        wake_.notify_one();
+        thread_.join();
+    }
+    if (file_) {
+        drain();  // Whatever was pushed between the drain thread's last pass and the levels dropping
+        std::fclose(file_);
+        file_ = nullptr;
+        std::cout << "LOG: " << written_ << " records written, " << getDroppedCount() << " dropped" << std::endl;
+    }
+}
+
+AsyncLog::Ring& AsyncLog::localRing() {
+    thread_local Ring* ring = nullptr;
+    if (!ring) {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings_.push_back(std::make_unique<Ring>());
+        ring = rings_.back().get();
+    }
+    return *ring;
+}
+
+void AsyncLog::push(const LogRecord& record) {
+    if (!localRing().tryPush(record)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AsyncLog::drainLoop() {
+    Profiler::getInstance().setThreadName("Log Writer");
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    while (running_.load(std::memory_order_relaxed)) {
+        lock.unlock();
+        drain();
+        lock.lock();
+        wake_.wait_for(lock, IDLE_WAIT, [this] { return !running_.load(std::memory_order_relaxed); });
+    }
+}
+
+size_t AsyncLog::drain() {
+    batch_.clear();
+    {
+        // Only the list is locked; a thread registering its ring waits at most this long
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        for (auto& ring : rings_) {
+            while (const LogRecord* record = ring->front()) {
+                batch_.push_back(*record);
+                ring->pop();
+            }
+        }
+    }
+    if (batch_.empty()) return 0;
+
+    // Each ring is already in order; merge threads by timestamp
+    std::stable_sort(batch_.begin(), batch_.end(),
+                     [](const LogRecord& a, const LogRecord& b) { return a.timestamp < b.timestamp; });
+    for (const LogRecord& record : batch_) {
+        format(record);
+        std::fwrite(line_.data(), 1, line_.size(), file_);
+    }
+
+    uint64_t dropped = getDroppedCount();
+    if (dropped != reported_dropped_) {
+        std::fprintf(file_, "LOG: %llu records dropped (rings full)\n",
+                     static_cast<unsigned long long>(dropped - reported_dropped_));
+        reported_dropped_ = dropped;
+    }
+    std::fflush(file_);
+    written_ += batch_.size();
+    return batch_.size();
+}
+
+void AsyncLog::format(const LogRecord& record) {
+    char scratch[64];
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::duration(record.timestamp - start_time_)).count();
+    std::snprintf(scratch, sizeof(scratch), "[%10.4f] %s %s: ", seconds,
+                  record.category < DEBUG_CATEGORY_COUNT ? CATEGORY_NAMES[record.category] : "?",
+                  record.level <= DEBUG_TRACE ? LEVEL_NAMES[record.level] : "?");
+    line_.assign(scratch);
+
+    int arg = 0;
+    for (const char* c = record.format; *c; ++c) {
+        if (c[0] != '{' || c[1] != '}' || arg >= record.argCount) {
+            line_.push_back(*c);
+            continue;
+        }
+        const LogRecord::Arg& value = record.args[arg];
+        switch (record.types[arg]) {
+            case LogRecord::INT:   std::snprintf(scratch, sizeof(scratch), "%lld", static_cast<long long>(value.i)); break;
+            case LogRecord::UINT:  std::snprintf(scratch, sizeof(scratch), "%llu", static_cast<unsigned long long>(value.u)); break;
+            case LogRecord::FLOAT: std::snprintf(scratch, sizeof(scratch), "%g", value.d); break;
+            case LogRecord::BOOL:  std::snprintf(scratch, sizeof(scratch), "%s", value.u ? "true" : "false"); break;
+            case LogRecord::TEXT:  scratch[0] = '\0'; line_.append(record.text + value.textOffset); break;
+        }
+        line_.append(scratch);
+        ++arg;
+        ++c;  // Skip the '}'
+    }
+    line_.push_back('\n');
+}
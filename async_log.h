@@ -0,0 +1,211 @@
+// async_log.h - Lazily formatted, per-thread lock-free logging drained to a file on a background thread
+#ifndef ASYNC_LOG_H
+#define ASYNC_LOG_H
+
+#include "spsc_queue.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Debug levels
+enum DebugLevel {
+    DEBUG_NONE = 0,
+    DEBUG_BASIC = 1,
+    DEBUG_DETAILED = 2,
+    DEBUG_VERBOSE = 3,
+    DEBUG_TRACE = 4
+};
+
+// Debug categories
+enum DebugCategory {
+    DEBUG_GENERAL,
+    DEBUG_UI,
+    DEBUG_INVENTORY,
+    DEBUG_RENDERING,
+    DEBUG_THEME,
+    DEBUG_INPUT,
+    DEBUG_MEMORY,
+    DEBUG_PERFORMANCE,
+    DEBUG_ENVIRONMENT,
+    DEBUG_COLLISION,
+    DEBUG_INTERACTION,
+    DEBUG_PLAYER,
+    DEBUG_CATEGORY_COUNT
+};
+
+/// \brief Logs when the category is enabled at the level. Arguments (and anything computed
+/// in them) aren't evaluated otherwise; the check is one relaxed atomic load.
+/// \param format String literal with a {} per argument.
+#define BW_LOG(category, level, format, ...) \
+    do { \
+        if (AsyncLog::isEnabled(category, level)) { \
+            AsyncLog::getInstance().write(category, level, format, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+/// \brief One unformatted log line: the format literal plus its arguments in binary.
+/// Strings are copied into text, truncated if the record runs out of room.
+struct LogRecord {
+    static constexpr int MAX_ARGS = 8;
+    static constexpr int TEXT_BYTES = 160;
+
+    enum ArgType : uint8_t { INT, UINT, FLOAT, BOOL, TEXT };
+    union Arg {
+        int64_t i;
+        uint64_t u;
+        double d;
+        uint32_t textOffset;
+    };
+
+    int64_t timestamp;       // steady_clock ticks
+    const char* format;      // String literal; lives for the whole program
+    uint8_t category;
+    uint8_t level;
+    uint8_t argCount;
+    uint8_t textUsed;
+    uint8_t types[MAX_ARGS];
+    Arg args[MAX_ARGS];
+    char text[TEXT_BYTES];
+};
+
+namespace AsyncLogDetail {
+    inline LogRecord::Arg* next(LogRecord& record, LogRecord::ArgType type) {
+        if (record.argCount >= LogRecord::MAX_ARGS) return nullptr;
+        record.types[record.argCount] = type;
+        return &record.args[record.argCount++];
+    }
+
+    inline void putText(LogRecord& record, const char* text, size_t length) {
+        LogRecord::Arg* arg = next(record, LogRecord::TEXT);
+        if (!arg) return;
+        size_t room = LogRecord::TEXT_BYTES - 1 - record.textUsed;
+        length = length < room ? length : room;
+        arg->textOffset = record.textUsed;
+        std::memcpy(record.text + record.textUsed, text, length);
+        record.text[record.textUsed + length] = '\0';
+        record.textUsed = static_cast<uint8_t>(record.textUsed + length + (length < room ? 1 : 0));
+    }
+
+    inline void put(LogRecord& record, bool value) {
+        if (LogRecord::Arg* arg = next(record, LogRecord::BOOL)) arg->u = value ? 1 : 0;
+    }
+    inline void put(LogRecord& record, const char* value) {
+        putText(record, value ? value : "(null)", value ? std::strlen(value) : 6);
+    }
+    template<size_t N>
+    void put(LogRecord& record, const char (&value)[N]) {
+        putText(record, value, std::strlen(value));
+    }
+    inline void put(LogRecord& record, const std::string& value) {
+        putText(record, value.data(), value.size());
+    }
+    template<typename T>
+    void put(LogRecord& record, const T& value) {
+        static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "BW_LOG takes numbers, bools and strings");
+        if constexpr (std::is_floating_point<T>::value) {
+            if (LogRecord::Arg* arg = next(record, LogRecord::FLOAT)) arg->d = static_cast<double>(value);
+        } else if constexpr (std::is_enum<T>::value) {
+            if (LogRecord::Arg* arg = next(record, LogRecord::INT)) arg->i = static_cast<int64_t>(value);
+        } else if constexpr (std::is_signed<T>::value) {
+            if (LogRecord::Arg* arg = next(record, LogRecord::INT)) arg->i = static_cast<int64_t>(value);
+        } else {
+            if (LogRecord::Arg* arg = next(record, LogRecord::UINT)) arg->u = static_cast<uint64_t>(value);
+        }
+    }
+}
+
+/// \brief Logging backend for BW_LOG and DebugSystem.
+///
+/// Each thread that logs gets its own SPSC ring the first time it does; write() fills a
+/// LogRecord on the caller's stack and pushes it without locking or formatting. A drain
+/// thread collects records from every ring, orders them by time, formats them and appends
+/// them to the log file. When a ring is full the record is dropped and counted rather than
+/// blocking the caller. Nothing is enabled until start(), so logging before it is free.
+class AsyncLog {
+public:
+    static AsyncLog& getInstance() {
+        static AsyncLog instance;
+        return instance;
+    }
+
+    /// \brief Opens the log file and starts the drain thread.
+    /// \param defaultLevel Level every category is enabled at; setLevel adjusts them after.
+    /// \return False if the file can't be opened; logging stays disabled.
+    bool start(const std::string& path, int defaultLevel);
+
+    /// \brief Writes out everything queued and stops the drain thread. Disables logging.
+    void stop();
+
+    /// \brief Messages in the category at or below level are kept.
+    static void setLevel(DebugCategory category, int level) {
+        if (category >= 0 && category < DEBUG_CATEGORY_COUNT) {
+            levels_[category].store(static_cast<int8_t>(level), std::memory_order_relaxed);
+        }
+    }
+
+    static bool isEnabled(DebugCategory category, int level) {
+        return level <= levels_[category].load(std::memory_order_relaxed);
+    }
+
+    /// \brief Queues a record. Prefer BW_LOG, which checks isEnabled before evaluating arguments.
+    template<typename... Args>
+    void write(DebugCategory category, int level, const char* format, const Args&... args) {
+        LogRecord record;
+        record.timestamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        record.format = format;
+        record.category = static_cast<uint8_t>(category);
+        record.level = static_cast<uint8_t>(level);
+        record.argCount = 0;
+        record.textUsed = 0;
+        (AsyncLogDetail::put(record, args), ...);
+        push(record);
+    }
+
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t getWrittenCount() const { return written_; }
+
+private:
+    static constexpr size_t RING_CAPACITY = 512;   // Records per thread
+    using Ring = SpscQueue<LogRecord, RING_CAPACITY>;
+
+    AsyncLog() = default;
+    ~AsyncLog();
+    AsyncLog(const AsyncLog&) = delete;
+    AsyncLog& operator=(const AsyncLog&) = delete;
+
+    void push(const LogRecord& record);
+    Ring& localRing();
+    void drainLoop();
+    size_t drain();
+    void format(const LogRecord& record);
+
+    static std::atomic<int8_t> levels_[DEBUG_CATEGORY_COUNT];
+
+    std::mutex rings_mutex_;                      // Guards the list; rings themselves are lock-free
+    std::vector<std::unique_ptr<Ring>> rings_;    // Never shrinks, so thread-local pointers stay valid
+    std::atomic<uint64_t> dropped_{0};
+
+    // Drain thread only (and stop() after joining it)
+    std::vector<LogRecord> batch_;
+    std::string line_;
+    uint64_t reported_dropped_ = 0;
+    uint64_t written_ = 0;
+
+    std::FILE* file_ = nullptr;
+    int64_t start_time_ = 0;
+    std::atomic<bool> running_{false};
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::thread thread_;
+};
+
+#endif // ASYNC_LOG_H
@@ -0,0 +1,212 @@
+#ifndef BINARY_IO_H
+#define BINARY_IO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// \brief Appends little-endian values, strings and size-prefixed chunks to a byte buffer.
+///
+/// Values are copied as their in-memory representation, like the world pack records, so
+/// only trivially copyable types are accepted. Nothing touches the disk; callers hand the
+/// finished buffer to whatever writes it.
+class BinaryWriter {
+public:
+    static constexpr size_t CHUNK_HEADER_SIZE = 8;  // char id[4] + uint32_t payload size
+
+    template<typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "BinaryWriter::write needs a trivially copyable type");
+        append(&value, sizeof(T));
+    }
+
+    /// \brief Writes a uint32_t length followed by the characters.
+    void writeString(const std::string& str) {
+        write(static_cast<uint32_t>(str.size()));
+        append(str.data(), str.size());
+    }
+
+    void append(const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        buffer_.insert(buffer_.end(), bytes, bytes + size);
+    }
+
+    /// \brief Starts a chunk; everything written until endChunk() is its payload.
+    /// \param id Four-character chunk id.
+    /// \return Token for endChunk().
+    size_t beginChunk(const char* id) {
+        size_t start = buffer_.size();
+        append(id, 4);
+        write(static_cast<uint32_t>(0));  // Patched by endChunk
+        return start;
+    }
+
+    /// \brief Closes a chunk by patching its payload size.
+    void endChunk(size_t start) {
+        uint32_t size = static_cast<uint32_t>(buffer_.size() - start - CHUNK_HEADER_SIZE);
+        std::memcpy(buffer_.data() + start + 4, &size, sizeof(size));
+    }
+
+    void reserve(size_t bytes) { buffer_.reserve(bytes); }
+    size_t size() const { return buffer_.size(); }
+    const std::vector<char>& buffer() const { return buffer_; }
+    std::vector<char> release() { return std::move(buffer_); }
+
+private:
+    std::vector<char> buffer_;
+};
+
+/// \brief Bounds-checked cursor over bytes written by BinaryWriter.
+///
+/// Reads never run past the end: a short read marks the reader failed and leaves the
+/// output untouched, so callers can decode a whole record and check failed() once.
+class BinaryReader {
+public:
+    BinaryReader() = default;
+    BinaryReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+    template<typename T>
+    bool read(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "BinaryReader::read needs a trivially copyable type");
+        return readBytes(&value, sizeof(T));
+    }
+
+    bool readBytes(void* out, size_t size) {
+        if (failed_ || size > remaining()) {
+            failed_ = true;
+            return false;
+        }
+        std::memcpy(out, data_ + pos_, size);
+        pos_ += size;
+        return true;
+    }
+
+    bool readString(std::string& out) {
+        uint32_t length = 0;
+        if (!read(length) || length > remaining()) {
+            failed_ = true;
+            return false;
+        }
+        out.assign(data_ + pos_, length);
+        pos_ += length;
+        return true;
+    }
+
+    bool skip(size_t size) {
+        if (failed_ || size > remaining()) {
+            failed_ = true;
+            return false;
+        }
+        pos_ += size;
+        return true;
+    }
+
+    /// \brief Reads the next chunk header and points `payload` at its contents.
+    /// \param id Receives the four-character id.
+    /// \param payload Reader limited to the chunk payload.
+    /// \return False at the end of the data or on a truncated chunk.
+    bool nextChunk(char (&id)[4], BinaryReader& payload) {
+        uint32_t size = 0;
+        if (remaining() == 0 || !readBytes(id, 4) || !read(size) || size > remaining()) {
+            if (remaining() != 0) failed_ = true;
+            return false;
+        }
+        payload = BinaryReader(data_ + pos_, size);
+        pos_ += size;
+        return true;
+    }
+
+    size_t remaining() const { return size_ - pos_; }
+    size_t position() const { return pos_; }
+    bool failed() const { return failed_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    size_t pos_ = 0;
+    bool failed_ = false;
+};
+
+/// \brief In-memory set of tagged fields, stored on disk as {uint16_t id, uint32_t length, bytes}.
+///
+/// Readers look fields up by id, so fields they don't know are skipped by length without being
+/// decoded and missing fields simply keep their defaults. Migrations edit a record (rename,
+/// convert, drop) before anything reads it, instead of re-parsing the stream per version.
+class TaggedRecord {
+public:
+    /// \brief Reads fields until `in` is exhausted; a later duplicate id replaces an earlier one.
+    /// \return False on a truncated field.
+    bool parse(BinaryReader& in) {
+        while (in.remaining() > 0) {
+            uint16_t id = 0;
+            uint32_t length = 0;
+            if (!in.read(id) || !in.read(length) || length > in.remaining()) {
+                return false;
+            }
+            std::string& bytes = fields_[id];
+            bytes.resize(length);
+            in.readBytes(&bytes[0], length);
+        }
+        return !in.failed();
+    }
+
+    /// \brief Writes every field, in id order.
+    void write(BinaryWriter& out) const {
+        for (const auto& field : fields_) {
+            out.write(field.first);
+            out.write(static_cast<uint32_t>(field.second.size()));
+            out.append(field.second.data(), field.second.size());
+        }
+    }
+
+    template<typename T>
+    void set(uint16_t id, const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "TaggedRecord::set needs a trivially copyable type");
+        setBytes(id, &value, sizeof(T));
+    }
+
+    void setBytes(uint16_t id, const void* data, size_t size) {
+        fields_[id].assign(static_cast<const char*>(data), size);
+    }
+
+    /// \brief Copies a fixed-size field into `value`.
+    /// \return False if the field is absent or its size doesn't match T.
+    template<typename T>
+    bool get(uint16_t id, T& value) const {
+        static_assert(std::is_trivially_copyable<T>::value, "TaggedRecord::get needs a trivially copyable type");
+        const std::string* bytes = find(id);
+        if (!bytes || bytes->size() != sizeof(T)) return false;
+        std::memcpy(&value, bytes->data(), sizeof(T));
+        return true;
+    }
+
+    const std::string* find(uint16_t id) const {
+        auto it = fields_.find(id);
+        return it != fields_.end() ? &it->second : nullptr;
+    }
+
+    bool has(uint16_t id) const { return fields_.count(id) != 0; }
+    void erase(uint16_t id) { fields_.erase(id); }
+    size_t size() const { return fields_.size(); }
+
+    /// \brief Moves a field to a new id, replacing anything there.
+    /// \return False if `from` is absent.
+    bool rename(uint16_t from, uint16_t to) {
+        auto it = fields_.find(from);
+        if (it == fields_.end()) return false;
+        std::string bytes = std::move(it->second);
+        fields_.erase(it);
+        fields_[to] = std::move(bytes);
+        return true;
+    }
+
+private:
+    std::map<uint16_t, std::string> fields_;
+};
+
+#endif
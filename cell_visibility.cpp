@@ -0,0 +1,33 @@
+#include "cell_visibility.h"
+#include "environment_manager.h"
+#include "constants.h"
+#include <algorithm>
+
+CellVisibility CellVisibility::compute(const Camera3D& camera, float aspect, const EnvironmentManager& environment,
+                                       bool isInBuilding, int currentBuilding) {
+    CellVisibility cells;
+    if (!isInBuilding) return cells;
+
+    cells.interior = environment.findBuilding(currentBuilding);
+    if (!cells.interior) return cells;  // Nothing to be inside: treat it as outdoors
+
+    Vector3 doorway[4];
+    cells.interior->getDoorway(doorway);
+    BoundingBox doorwayBounds = {doorway[0], doorway[0]};
+    for (const Vector3& corner : doorway) {
+        doorwayBounds.min = {std::min(doorwayBounds.min.x, corner.x), std::min(doorwayBounds.min.y, corner.y),
+                             std::min(doorwayBounds.min.z, corner.z)};
+        doorwayBounds.max = {std::max(doorwayBounds.max.x, corner.x), std::max(doorwayBounds.max.y, corner.y),
+                             std::max(doorwayBounds.max.z, corner.z)};
+    }
+
+    Frustum view = Frustum::fromCamera(camera, aspect, RenderConstants::CAMERA_NEAR_PLANE, environment.getCullDistance());
+    if (!view.intersects(doorwayBounds)) {
+        cells.exterior = false;  // Facing away from the door: the interior is all there is
+        return cells;
+    }
+
+    // Standing in the doorway the portal planes degenerate; draw the exterior unclipped
+    cells.throughPortal = Frustum::throughPortal(view, camera.position, doorway, cells.portal);
+    return cells;
+}
@@ -0,0 +1,34 @@
+#ifndef CELL_VISIBILITY_H
+#define CELL_VISIBILITY_H
+
+#include "raylib.h"
+#include "frustum.h"
+
+class Building;
+class EnvironmentManager;
+
+/// \brief Which visibility cells the camera sees this frame.
+///
+/// The world is split into cells: the exterior, and one interior per enterable building,
+/// joined to the exterior by a portal, the building's doorway. Interiors connect only to
+/// the exterior, so no portal chains are needed. From outside, only the exterior is drawn.
+/// From inside a building, its interior is drawn, plus the exterior where the doorway
+/// shows it: the exterior is clipped to the portal frustum, or skipped if the doorway is
+/// out of view.
+struct CellVisibility {
+    const Building* interior = nullptr;     // Interior cell the camera is in
+    bool exterior = true;                   // Any of the exterior is visible
+    bool throughPortal = false;             // Exterior is limited to `portal`
+    Frustum portal;
+
+    /// \brief Works out the visible cells for a camera.
+    /// \param camera Camera.
+    /// \param aspect Viewport width / height.
+    /// \param environment Environment that owns the buildings.
+    /// \param isInBuilding Whether the camera is in an interior cell.
+    /// \param currentBuilding Id of that building.
+    static CellVisibility compute(const Camera3D& camera, float aspect, const EnvironmentManager& environment,
+                                  bool isInBuilding, int currentBuilding);
+};
+
+#endif // CELL_VISIBILITY_H
@@ -0,0 +1,270 @@
+#include "collider_cache.h"
+#include "environmental_object.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BROWSERWIND_COLLIDER_SSE 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define BROWSERWIND_COLLIDER_NEON 1
+#endif
+
+CapsuleQuery CapsuleQuery::fromBounds(const CollisionBounds& bounds) {
+    float radius = bounds.size.x;
+    float halfSegment = std::max(bounds.size.y * 0.5f - radius, 0.0f);
+    return {bounds.position.x, bounds.position.z,
+            bounds.position.y - halfSegment, bounds.position.y + halfSegment, radius};
+}
+
+void ColliderCache::clear() {
+    min_x_.clear(); min_y_.clear(); min_z_.clear();
+    max_x_.clear(); max_y_.clear(); max_z_.clear();
+    round_radius_.clear();
+    cached_position_.clear();
+    bounds_.clear();
+}
+
+void ColliderCache::truncate(size_t count) {
+    if (count >= min_x_.size()) return;
+    min_x_.resize(count); min_y_.resize(count); min_z_.resize(count);
+    max_x_.resize(count); max_y_.resize(count); max_z_.resize(count);
+    round_radius_.resize(count);
+    cached_position_.resize(count);
+    bounds_.resize(count);
+}
+
+void ColliderCache::ensureSize(uint32_t index) {
+    if (index < min_x_.size()) return;
+    // New slots start disabled: an inverted infinite box can never be hit
+    constexpr float INF = std::numeric_limits<float>::infinity();
+    size_t n = index + 1;
+    min_x_.resize(n, INF); min_y_.resize(n, INF); min_z_.resize(n, INF);
+    max_x_.resize(n, -INF); max_y_.resize(n, -INF); max_z_.resize(n, -INF);
+    round_radius_.resize(n, 0.0f);
+    cached_position_.resize(n, Vector3{0.0f, 0.0f, 0.0f});
+    bounds_.resize(n, CollisionBounds{});
+}
+
+void ColliderCache::update(uint32_t index, const EnvironmentalObject& obj) {
+    ensureSize(index);
+    constexpr float INF = std::numeric_limits<float>::infinity();
+
+    CollisionBounds b = obj.getCollisionBounds();
+    bounds_[index] = b;
+    cached_position_[index] = obj.position;
+
+    bool hasShape = b.size.x != 0.0f || b.size.y != 0.0f || b.size.z != 0.0f;
+    if (!obj.collidable || !hasShape) {
+        min_x_[index] = min_y_[index] = min_z_[index] = INF;
+        max_x_[index] = max_y_[index] = max_z_[index] = -INF;
+        round_radius_[index] = 0.0f;
+        return;
+    }
+
+    if (b.shape == CollisionShape::BOX) {
+        BoundingBox box = CollisionSystem::boundsToBox(b);
+        min_x_[index] = box.min.x; min_y_[index] = box.min.y; min_z_[index] = box.min.z;
+        max_x_[index] = box.max.x; max_y_[index] = box.max.y; max_z_[index] = box.max.z;
+        round_radius_[index] = 0.0f;
+    } else {
+        // Round shapes: size.x is radius, size.y is height (spheres use radius for both)
+        float halfH = b.shape == CollisionShape::SPHERE ? b.size.x : b.size.y * 0.5f;
+        min_x_[index] = max_x_[index] = b.position.x;
+        min_z_[index] = max_z_[index] = b.position.z;
+        min_y_[index] = b.position.y - halfH;
+        max_y_[index] = b.position.y + halfH;
+        round_radius_[index] = b.size.x;
+    }
+}
+
+bool ColliderCache::isStale(uint32_t index, const EnvironmentalObject& obj) const {
+    if (index >= cached_position_.size()) return true;
+    const Vector3& p = cached_position_[index];
+    return p.x != obj.position.x || p.y != obj.position.y || p.z != obj.position.z;
+}
+
+bool ColliderCache::capsuleHitScalar(const CapsuleQuery& capsule, uint32_t i) const {
+    float dx = std::max({min_x_[i] - capsule.x, capsule.x - max_x_[i], 0.0f});
+    float dz = std::max({min_z_[i] - capsule.z, capsule.z - max_z_[i], 0.0f});
+    float dh = std::max(std::sqrt(dx * dx + dz * dz) - round_radius_[i], 0.0f);
+    float dy = std::max({min_y_[i] - capsule.max_y, capsule.min_y - max_y_[i], 0.0f});
+    return dh * dh + dy * dy <= capsule.radius * capsule.radius;
+}
+
+int ColliderCache::firstCapsuleHit(const CapsuleQuery& capsule, const uint32_t* indices, size_t count) const {
+    size_t i = 0;
+
+#if defined(BROWSERWIND_COLLIDER_SSE)
+    const __m128 cx = _mm_set1_ps(capsule.x);
+    const __m128 cz = _mm_set1_ps(capsule.z);
+    const __m128 segMin = _mm_set1_ps(capsule.min_y);
+    const __m128 segMax = _mm_set1_ps(capsule.max_y);
+    const __m128 r2 = _mm_set1_ps(capsule.radius * capsule.radius);
+    const __m128 zero = _mm_setzero_ps();
+
+    auto gather = [&](const std::vector<float>& v, size_t base) {
+        return _mm_set_ps(v[indices[base + 3]], v[indices[base + 2]], v[indices[base + 1]], v[indices[base]]);
+    };
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(gather(min_x_, i), cx), _mm_sub_ps(cx, gather(max_x_, i))), zero);
+        __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(gather(min_z_, i), cz), _mm_sub_ps(cz, gather(max_z_, i))), zero);
+        __m128 dxz = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dz, dz)));
+        __m128 dh = _mm_max_ps(_mm_sub_ps(dxz, gather(round_radius_, i)), zero);
+        __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(gather(min_y_, i), segMax), _mm_sub_ps(segMin, gather(max_y_, i))), zero);
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dh, dh), _mm_mul_ps(dy, dy));
+        int mask = _mm_movemask_ps(_mm_cmple_ps(d2, r2));
+        if (mask) {
+            for (int lane = 0; lane < 4; ++lane) {
+                if (mask & (1 << lane)) return static_cast<int>(i) + lane;
+            }
+        }
+    }
+#elif defined(BROWSERWIND_COLLIDER_NEON)
+    const float32x4_t cx = vdupq_n_f32(capsule.x);
+    const float32x4_t cz = vdupq_n_f32(capsule.z);
+    const float32x4_t segMin = vdupq_n_f32(capsule.min_y);
+    const float32x4_t segMax = vdupq_n_f32(capsule.max_y);
+    const float32x4_t r2 = vdupq_n_f32(capsule.radius * capsule.radius);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+
+    auto gather = [&](const std::vector<float>& v, size_t base) {
+        float lanes[4] = {v[indices[base]], v[indices[base + 1]], v[indices[base + 2]], v[indices[base + 3]]};
+        return vld1q_f32(lanes);
+    };
+
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t dx = vmaxq_f32(vmaxq_f32(vsubq_f32(gather(min_x_, i), cx), vsubq_f32(cx, gather(max_x_, i))), zero);
+        float32x4_t dz = vmaxq_f32(vmaxq_f32(vsubq_f32(gather(min_z_, i), cz), vsubq_f32(cz, gather(max_z_, i))), zero);
+        float32x4_t dxz = vsqrtq_f32(vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dz, dz)));
+        float32x4_t dh = vmaxq_f32(vsubq_f32(dxz, gather(round_radius_, i)), zero);
+        float32x4_t dy = vmaxq_f32(vmaxq_f32(vsubq_f32(gather(min_y_, i), segMax), vsubq_f32(segMin, gather(max_y_, i))), zero);
+        float32x4_t d2 = vaddq_f32(vmulq_f32(dh, dh), vmulq_f32(dy, dy));
+        uint32x4_t hit = vcleq_f32(d2, r2);
+        if (vmaxvq_u32(hit)) {
+            uint32_t lanes[4];
+            vst1q_u32(lanes, hit);
+            for (int lane = 0; lane < 4; ++lane) {
+                if (lanes[lane]) return static_cast<int>(i) + lane;
+            }
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        if (capsuleHitScalar(capsule, indices[i])) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+namespace {
+
+// Entry time of the ray p + t*d into the 2D box, or false if it misses within [0, 1]
+bool raySlab2D(float px, float pz, float dx, float dz,
+               float minX, float maxX, float minZ, float maxZ, float& tHit, float& nx, float& nz) {
+    float tEnter = 0.0f, tExit = 1.0f;
+    float enterNx = 0.0f, enterNz = 0.0f;
+
+    auto axis = [&](float p, float d, float lo, float hi, float& outNx, float& outNz, bool isX) {
+        if (std::fabs(d) < 1e-8f) return p >= lo && p <= hi;
+        float t0 = (lo - p) / d, t1 = (hi - p) / d;
+        float sign = -1.0f;
+        if (t0 > t1) { std::swap(t0, t1); sign = 1.0f; }
+        if (t0 > tEnter) {
+            tEnter = t0;
+            outNx = isX ? sign : 0.0f;
+            outNz = isX ? 0.0f : sign;
+        }
+        tExit = std::min(tExit, t1);
+        return tEnter <= tExit;
+    };
+
+    if (!axis(px, dx, minX, maxX, enterNx, enterNz, true)) return false;
+    if (!axis(pz, dz, minZ, maxZ, enterNx, enterNz, false)) return false;
+    if (enterNx == 0.0f && enterNz == 0.0f) return false;  // Started inside; handled by the overlap path
+    tHit = tEnter; nx = enterNx; nz = enterNz;
+    return true;
+}
+
+// Entry time of the ray p + t*d into a circle, or false if it misses within [0, 1]
+bool rayCircle2D(float px, float pz, float dx, float dz, float cx, float cz, float r, float& tHit) {
+    float ox = px - cx, oz = pz - cz;
+    float a = dx * dx + dz * dz;
+    if (a < 1e-12f) return false;
+    float b = ox * dx + oz * dz;
+    float c = ox * ox + oz * oz - r * r;
+    float disc = b * b - a * c;
+    if (disc < 0.0f || b > 0.0f) return false;
+    float t = (-b - std::sqrt(disc)) / a;
+    if (t < 0.0f || t > 1.0f) return false;
+    tHit = t;
+    return true;
+}
+
+}  // namespace
+
+SweepHit ColliderCache::sweepCapsule(const CapsuleQuery& capsule, float deltaX, float deltaZ, const uint32_t* indices, size_t count) const {
+    SweepHit best;
+
+    for (size_t k = 0; k < count; ++k) {
+        uint32_t i = indices[k];
+        if (min_x_[i] > max_x_[i]) continue;  // Disabled slot
+
+        // Motion is horizontal, so vertical separation is constant and shrinks the effective radius
+        float dy = std::max({min_y_[i] - capsule.max_y, capsule.min_y - max_y_[i], 0.0f});
+        if (dy > capsule.radius) continue;
+        float reach = round_radius_[i] + std::sqrt(capsule.radius * capsule.radius - dy * dy);
+
+        // Closest point on the collider's core rectangle to the start position
+        float qx = std::clamp(capsule.x, min_x_[i], max_x_[i]);
+        float qz = std::clamp(capsule.z, min_z_[i], max_z_[i]);
+        float ox = capsule.x - qx, oz = capsule.z - qz;
+        float dist2 = ox * ox + oz * oz;
+
+        if (dist2 <= reach * reach) {
+            // Already touching: block only the component heading inward
+            float nx, nz;
+            if (dist2 > 1e-12f) {
+                float inv = 1.0f / std::sqrt(dist2);
+                nx = ox * inv; nz = oz * inv;
+            } else {
+                // Centre inside the core: push out along the shallowest axis
+                float pen[4] = {capsule.x - min_x_[i], max_x_[i] - capsule.x, capsule.z - min_z_[i], max_z_[i] - capsule.z};
+                int axis = static_cast<int>(std::min_element(pen, pen + 4) - pen);
+                nx = axis == 0 ? -1.0f : axis == 1 ? 1.0f : 0.0f;
+                nz = axis == 2 ? -1.0f : axis == 3 ? 1.0f : 0.0f;
+            }
+            if (deltaX * nx + deltaZ * nz < 0.0f && best.time > 0.0f) {
+                best.time = 0.0f;
+                best.normal = {nx, 0.0f, nz};
+                best.position = static_cast<int>(k);
+            }
+            continue;
+        }
+
+        // Rounded rectangle = two expanded slabs plus four corner circles; entry is the earliest of them
+        float t, nx, nz;
+        if (raySlab2D(capsule.x, capsule.z, deltaX, deltaZ, min_x_[i] - reach, max_x_[i] + reach, min_z_[i], max_z_[i], t, nx, nz) && t < best.time) {
+            best = {t, {nx, 0.0f, nz}, static_cast<int>(k)};
+        }
+        if (raySlab2D(capsule.x, capsule.z, deltaX, deltaZ, min_x_[i], max_x_[i], min_z_[i] - reach, max_z_[i] + reach, t, nx, nz) && t < best.time) {
+            best = {t, {nx, 0.0f, nz}, static_cast<int>(k)};
+        }
+        const float cornersX[2] = {min_x_[i], max_x_[i]};
+        const float cornersZ[2] = {min_z_[i], max_z_[i]};
+        for (float cx : cornersX) {
+            for (float cz : cornersZ) {
+                if (rayCircle2D(capsule.x, capsule.z, deltaX, deltaZ, cx, cz, reach, t) && t < best.time) {
+                    float hx = capsule.x + deltaX * t - cx, hz = capsule.z + deltaZ * t - cz;
+                    float inv = 1.0f / std::max(std::sqrt(hx * hx + hz * hz), 1e-6f);
+                    best = {t, {hx * inv, 0.0f, hz * inv}, static_cast<int>(k)};
+                }
+            }
+        }
+    }
+
+    return best;
+}
@@ -0,0 +1,88 @@
+#ifndef COLLIDER_CACHE_H
+#define COLLIDER_CACHE_H
+
+#include "raylib.h"
+#include "collision_system.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class EnvironmentalObject;
+
+/// \brief Vertical player capsule in the form the batch kernels consume.
+struct CapsuleQuery {
+    float x, z;          // Axis position on the ground plane
+    float min_y, max_y;  // Segment end points (capsule height minus the hemispheres)
+    float radius;
+
+    /// \brief Builds from CAPSULE bounds (position is the centre, size = {radius, height, _}).
+    static CapsuleQuery fromBounds(const CollisionBounds& bounds);
+};
+
+/// \brief Result of a swept capsule test.
+struct SweepHit {
+    float time = 1.0f;                      // Fraction of the move completed before contact
+    Vector3 normal = {0.0f, 0.0f, 0.0f};    // Horizontal contact normal, pointing away from the collider
+    int position = -1;                      // Position in the tested index list, or -1 for no hit
+};
+
+/// \brief Structure-of-arrays cache of static collider shapes, indexed like EnvironmentManager::objects_.
+///
+/// Every collider is stored as a vertical "rounded box": an AABB swept by a horizontal
+/// disk of radius `round_radius`. Boxes have radius 0; cylinders and spheres collapse
+/// their AABB to the axis and keep the radius. One kernel then handles both shapes.
+class ColliderCache {
+public:
+    /// \brief Drops all entries.
+    void clear();
+
+    /// \brief Drops entries from `count` onward, e.g. after objects were compacted.
+    void truncate(size_t count);
+
+    /// \brief Writes or overwrites the entry for an object.
+    /// \param index Object index.
+    /// \param obj Object to snapshot.
+    void update(uint32_t index, const EnvironmentalObject& obj);
+
+    /// \brief Returns true if the object moved since its entry was written.
+    /// \param index Object index.
+    /// \param obj Object to compare.
+    bool isStale(uint32_t index, const EnvironmentalObject& obj) const;
+
+    /// \brief Gets cached AoS bounds for scalar paths.
+    /// \param index Object index.
+    const CollisionBounds& getBounds(uint32_t index) const { return bounds_[index]; }
+
+    /// \brief Tests a capsule against a set of cached colliders, 4 at a time where SIMD is available.
+    /// \param capsule Capsule to test.
+    /// \param indices Object indices to test.
+    /// \param count Number of indices.
+    /// \return Position in `indices` of the first hit, or -1.
+    int firstCapsuleHit(const CapsuleQuery& capsule, const uint32_t* indices, size_t count) const;
+
+    /// \brief Sweeps a capsule horizontally and reports the earliest time of impact.
+    /// Colliders the capsule already overlaps only block motion that goes further into them.
+    /// \param capsule Capsule at the start of the move.
+    /// \param deltaX Horizontal move along X.
+    /// \param deltaZ Horizontal move along Z.
+    /// \param indices Object indices to test.
+    /// \param count Number of indices.
+    /// \return Earliest contact, or position -1 if the whole move is clear.
+    SweepHit sweepCapsule(const CapsuleQuery& capsule, float deltaX, float deltaZ, const uint32_t* indices, size_t count) const;
+
+    /// \brief Scalar reference for a single collider; also used for batch tails.
+    bool capsuleHitScalar(const CapsuleQuery& capsule, uint32_t index) const;
+
+    size_t size() const { return min_x_.size(); }
+
+private:
+    std::vector<float> min_x_, min_y_, min_z_;
+    std::vector<float> max_x_, max_y_, max_z_;
+    std::vector<float> round_radius_;
+    std::vector<Vector3> cached_position_;
+    std::vector<CollisionBounds> bounds_;
+
+    void ensureSize(uint32_t index);
+};
+
+#endif
@@ -2,7 +2,10 @@
 #include "environment_manager.h"  // Now included for full use
 #include "math_utils.h"  // For MathUtils::distance3D
 #include "raymath.h"     // For Vector3Subtract, Vector3Length, etc.
-#include <iostream>      // For debugging
+#include "async_log.h"   // For BW_LOG
+#include <array>
+#include <utility>
+#include <vector>
 
 // Implementation for checkPointInBounds
 bool CollisionSystem::checkPointInBounds(Vector3 point, const CollisionBounds& bounds) {
@@ -28,16 +31,15 @@ bool CollisionSystem::pointInBox(Vector3 point, const CollisionBounds& box) {
 }
 
 bool CollisionSystem::pointInSphere(Vector3 point, const CollisionBounds& sphere) {
-    float distance = MathUtils::distance3D(point, sphere.position);
-    return distance <= sphere.size.x;  // Assume size.x is radius
+    return MathUtils::distanceSquared3D(point, sphere.position) <= sphere.size.x * sphere.size.x;  // Assume size.x is radius
 }
 
 bool CollisionSystem::pointInCylinder(Vector3 point, const CollisionBounds& cylinder) {
     // Project point onto cylinder axis (assume Y axis for simplicity)
     float proj = point.y - cylinder.position.y;
     if (std::abs(proj) > cylinder.size.y / 2) return false;  // height check
-    float dist = std::sqrt(std::pow(point.x - cylinder.position.x, 2) + std::pow(point.z - cylinder.position.z, 2));
-    return dist <= cylinder.size.x;  // radius check
+    float distSq = MathUtils::distanceSquared2D({point.x, point.z}, {cylinder.position.x, cylinder.position.z});
+    return distSq <= cylinder.size.x * cylinder.size.x;  // radius check
 }
 
 bool CollisionSystem::pointInCapsule(Vector3 point, const CollisionBounds& capsule) {
@@ -64,101 +66,234 @@ BoundingBox CollisionSystem::boundsToBox(const CollisionBounds& bounds) {
     return {min, max};
 }
 
-// Implementation for checkCollision
-bool CollisionSystem::checkCollision(const CollisionBounds& bounds1, const CollisionBounds& bounds2) {
-    if (bounds1.shape == CollisionShape::BOX && bounds2.shape == CollisionShape::BOX) {
-        return checkBoxCollision(bounds1, bounds2);
-    } else if (bounds1.shape == CollisionShape::SPHERE && bounds2.shape == CollisionShape::SPHERE) {
-        return checkSphereCollision(bounds1, bounds2);
-    } else if (bounds1.shape == CollisionShape::CYLINDER && bounds2.shape == CollisionShape::CYLINDER) {
-        return checkCylinderCollision(bounds1, bounds2);
-    } else if (bounds1.shape == CollisionShape::CAPSULE && bounds2.shape == CollisionShape::CAPSULE) {
-        return checkCapsuleCollision(bounds1, bounds2);
+BoundingBox CollisionSystem::enclosingBox(const CollisionBounds& bounds) {
+    if (bounds.shape == CollisionShape::BOX) {
+        return boundsToBox(bounds);
     }
-    // Fallback to box approximation for mixed shapes
-    BoundingBox box1 = boundsToBox(bounds1);
-    BoundingBox box2 = boundsToBox(bounds2);
-    return CheckCollisionBoxes(box1, box2);
+    // Round shapes store radius in size.x and height in size.y
+    float r = bounds.size.x;
+    float halfH = std::max(bounds.size.y * 0.5f, bounds.shape == CollisionShape::SPHERE ? r : 0.0f);
+    return {{bounds.position.x - r, bounds.position.y - halfH, bounds.position.z - r},
+            {bounds.position.x + r, bounds.position.y + halfH, bounds.position.z + r}};
 }
 
-// Private collision checks
-bool CollisionSystem::checkBoxCollision(const CollisionBounds& box1, const CollisionBounds& bounds2) {
-    BoundingBox bb1 = boundsToBox(box1);
-    BoundingBox bb2 = boundsToBox(bounds2);
-    return CheckCollisionBoxes(bb1, bb2);
+// Narrowphase dispatch
+//
+// Every shape is a vertical "core" (an XZ rectangle or point times a Y interval) grown by a
+// radius: cylinders grow horizontally only, spheres and capsules in all directions. Two shapes
+// touch when the gap between their cores, less the horizontal radii, is within the summed
+// spherical radii. ShapeTraits describes each shape at compile time so every pair gets a
+// kernel with only the work it needs: no square root unless both kinds of radius are present,
+// no rectangle clamping for round cores.
+namespace {
+
+struct ShapeExtent {
+    float x, z;             // Core centre on the ground plane
+    float halfX, halfZ;     // Core half-extents (0 for round shapes)
+    float minY, maxY;       // Core Y interval
+    float radius;           // Size.x for round shapes
+};
+
+template <CollisionShape S> struct ShapeTraits;
+
+template <> struct ShapeTraits<CollisionShape::BOX> {
+    static constexpr bool RECT_CORE = true;
+    static constexpr bool HORIZONTAL_RADIUS = false;
+    static constexpr bool SPHERICAL_RADIUS = false;
+    static ShapeExtent extent(const CollisionBounds& b) {
+        return {b.position.x, b.position.z, b.size.x * 0.5f, b.size.z * 0.5f,
+                b.position.y - b.size.y * 0.5f, b.position.y + b.size.y * 0.5f, 0.0f};
+    }
+};
+
+template <> struct ShapeTraits<CollisionShape::SPHERE> {
+    static constexpr bool RECT_CORE = false;
+    static constexpr bool HORIZONTAL_RADIUS = false;
+    static constexpr bool SPHERICAL_RADIUS = true;
+    static ShapeExtent extent(const CollisionBounds& b) {
+        return {b.position.x, b.position.z, 0.0f, 0.0f, b.position.y, b.position.y, b.size.x};
+    }
+};
+
+template <> struct ShapeTraits<CollisionShape::CYLINDER> {
+    static constexpr bool RECT_CORE = false;
+    static constexpr bool HORIZONTAL_RADIUS = true;
+    static constexpr bool SPHERICAL_RADIUS = false;
+    static ShapeExtent extent(const CollisionBounds& b) {
+        return {b.position.x, b.position.z, 0.0f, 0.0f,
+                b.position.y - b.size.y * 0.5f, b.position.y + b.size.y * 0.5f, b.size.x};
+    }
+};
+
+template <> struct ShapeTraits<CollisionShape::CAPSULE> {
+    // Centre-based like CapsuleQuery::fromBounds: size.y is the full height, hemispheres included
+    static constexpr bool RECT_CORE = false;
+    static constexpr bool HORIZONTAL_RADIUS = false;
+    static constexpr bool SPHERICAL_RADIUS = true;
+    static ShapeExtent extent(const CollisionBounds& b) {
+        float halfSegment = std::max(b.size.y * 0.5f - b.size.x, 0.0f);
+        return {b.position.x, b.position.z, 0.0f, 0.0f,
+                b.position.y - halfSegment, b.position.y + halfSegment, b.size.x};
+    }
+};
+
+/// \brief Exact test for one ordered shape pair; A <= B, the table flips the rest.
+template <CollisionShape A, CollisionShape B>
+bool collidePair(const CollisionBounds& boundsA, const CollisionBounds& boundsB) {
+    using TA = ShapeTraits<A>;
+    using TB = ShapeTraits<B>;
+    const ShapeExtent a = TA::extent(boundsA);
+    const ShapeExtent b = TB::extent(boundsB);
+
+    // Vertical gap between the core intervals
+    float dy = std::max({b.minY - a.maxY, a.minY - b.maxY, 0.0f});
+
+    // Horizontal gap between the cores
+    float dx = std::fabs(a.x - b.x);
+    float dz = std::fabs(a.z - b.z);
+    if constexpr (TA::RECT_CORE || TB::RECT_CORE) {
+        dx = std::max(dx - a.halfX - b.halfX, 0.0f);
+        dz = std::max(dz - a.halfZ - b.halfZ, 0.0f);
+    }
+    float gapXZSq = dx * dx + dz * dz;
+
+    constexpr bool horizontal = TA::HORIZONTAL_RADIUS || TB::HORIZONTAL_RADIUS;
+    constexpr bool spherical = TA::SPHERICAL_RADIUS || TB::SPHERICAL_RADIUS;
+    float horizontalRadius = (TA::HORIZONTAL_RADIUS ? a.radius : 0.0f) + (TB::HORIZONTAL_RADIUS ? b.radius : 0.0f);
+    float sphericalRadius = (TA::SPHERICAL_RADIUS ? a.radius : 0.0f) + (TB::SPHERICAL_RADIUS ? b.radius : 0.0f);
+
+    if constexpr (!spherical) {
+        // Flat-topped shapes only: the cores must share height and come within the disk radii
+        return dy == 0.0f && gapXZSq <= horizontalRadius * horizontalRadius;
+    } else if constexpr (!horizontal) {
+        return gapXZSq + dy * dy <= sphericalRadius * sphericalRadius;
+    } else {
+        float dh = std::max(std::sqrt(gapXZSq) - horizontalRadius, 0.0f);
+        return dh * dh + dy * dy <= sphericalRadius * sphericalRadius;
+    }
 }
 
-bool CollisionSystem::checkSphereCollision(const CollisionBounds& sphere1, const CollisionBounds& bounds2) {
-    // Approximate bounds2 as sphere
-    float dist = Vector3Distance(sphere1.position, bounds2.position);
-    return dist <= (sphere1.size.x + bounds2.size.x);  // radii sum
+template <CollisionShape A, CollisionShape B>
+bool collideSwapped(const CollisionBounds& boundsA, const CollisionBounds& boundsB) {
+    return collidePair<B, A>(boundsB, boundsA);
 }
 
-bool CollisionSystem::checkCylinderCollision(const CollisionBounds& cyl1, const CollisionBounds& bounds2) {
-    // Simplified: treat as cylinders along Y
-    float distXZ = std::sqrt(std::pow(cyl1.position.x - bounds2.position.x, 2) + std::pow(cyl1.position.z - bounds2.position.z, 2));
-    bool xzCollide = distXZ <= (cyl1.size.x + bounds2.size.x);
-    bool yCollide = std::abs(cyl1.position.y - bounds2.position.y) <= (cyl1.size.y + bounds2.size.y) / 2;
-    return xzCollide && yCollide;
+using CollideFn = bool (*)(const CollisionBounds&, const CollisionBounds&);
+
+constexpr size_t SHAPE_COUNT = 4;
+
+template <size_t I>
+constexpr CollideFn collideEntry() {
+    constexpr auto A = static_cast<CollisionShape>(I / SHAPE_COUNT);
+    constexpr auto B = static_cast<CollisionShape>(I % SHAPE_COUNT);
+    if constexpr (A <= B) {
+        return &collidePair<A, B>;
+    } else {
+        return &collideSwapped<A, B>;
+    }
 }
 
-bool CollisionSystem::checkCapsuleCollision(const CollisionBounds& capsule1, const CollisionBounds& bounds2) {
-    // Convert bounds2 to BoundingBox and call the other overload
-    BoundingBox box = {
-        {bounds2.position.x - bounds2.size.x/2, bounds2.position.y - bounds2.size.y/2, bounds2.position.z - bounds2.size.z/2},
-        {bounds2.position.x + bounds2.size.x/2, bounds2.position.y + bounds2.size.y/2, bounds2.position.z + bounds2.size.z/2}
-    };
-    return checkCapsuleCollision(capsule1, box);
+template <size_t... I>
+constexpr std::array<CollideFn, sizeof...(I)> makeCollideTable(std::index_sequence<I...>) {
+    return {collideEntry<I>()...};
 }
 
-bool CollisionSystem::checkCapsuleCollision(const CollisionBounds& capsule, const BoundingBox& box) {
-    // Basic AABB-capsule check (placeholder, implement properly if needed)
-    return CheckCollisionBoxSphere(box, capsule.position, capsule.size.x);
+// Indexed [shape1 * 4 + shape2]
+constexpr std::array<CollideFn, SHAPE_COUNT * SHAPE_COUNT> COLLIDE_TABLE =
+    makeCollideTable(std::make_index_sequence<SHAPE_COUNT * SHAPE_COUNT>{});
+
+static_assert(static_cast<size_t>(CollisionShape::CAPSULE) + 1 == SHAPE_COUNT, "COLLIDE_TABLE covers every CollisionShape");
+
+} // namespace
+
+bool CollisionSystem::checkCollision(const CollisionBounds& bounds1, const CollisionBounds& bounds2) {
+    size_t index = static_cast<size_t>(bounds1.shape) * SHAPE_COUNT + static_cast<size_t>(bounds2.shape);
+    return COLLIDE_TABLE[index](bounds1, bounds2);
 }
 
 // resolveCollisions implementation
 void CollisionSystem::resolveCollisions(Vector3& newPosition, const Vector3& originalPosition, float playerRadius, float playerHeight, float playerY, float eyeHeight, float groundLevel, const EnvironmentManager& environment, bool isInBuilding, int currentBuilding) {
-    // Create player capsule bounds
+    // Create player capsule bounds at the start of the move
     CollisionBounds playerBounds;
     playerBounds.shape = CollisionShape::CAPSULE;
-    playerBounds.position = {newPosition.x, playerY + playerHeight / 2, newPosition.z};  // Center of capsule
+    playerBounds.position = {originalPosition.x, playerY + playerHeight / 2, originalPosition.z};  // Center of capsule
     playerBounds.size = {playerRadius, playerHeight, 0.0f};  // radius, height
 
-    // Debug: Log collision check
-    static int collisionDebugCounter = 0;
-    if (collisionDebugCounter++ % 60 == 0) {
-        std::cout << "COLLISION: Checking player at (" << newPosition.x << ", " << newPosition.y << ", " << newPosition.z
-                  << ") bounds: (" << playerBounds.position.x << ", " << playerBounds.position.y << ", " << playerBounds.position.z << ")" << std::endl;
-    }
+    float deltaX = newPosition.x - originalPosition.x;
+    float deltaZ = newPosition.z - originalPosition.z;
 
-    // Check collision with environment
-    if (environment.checkCollision(playerBounds, isInBuilding ? currentBuilding : -1)) {
-        // Debug: Collision detected
-        std::cout << "COLLISION DETECTED: Reverting position from (" << newPosition.x << ", " << newPosition.y << ", " << newPosition.z
-                  << ") to (" << originalPosition.x << ", " << originalPosition.y << ", " << originalPosition.z << ")" << std::endl;
-        // Simple resolution: revert to original position
-        newPosition = originalPosition;
-        std::cout << "Collision resolved: reverted to original position" << std::endl;
-    } else {
-        // No collision, allow movement
+    // Per calling thread, reused move to move; never shrinks
+    thread_local std::vector<uint32_t> candidates;
+    int exclude = isInBuilding ? currentBuilding : -1;
+    auto query = [&environment, exclude](const BoundingBox& area, std::vector<uint32_t>& out) {
+        environment.collectColliders(area, exclude, out);
+    };
+
+    CapsuleQuery capsule = CapsuleQuery::fromBounds(playerBounds);
+    int contacts = slideCapsule(capsule, deltaX, deltaZ, environment.getColliderCache(), query, candidates);
+
+    // Debug: Log slide resolution
+    thread_local int collisionDebugCounter = 0;
+    if (contacts > 0 && collisionDebugCounter++ % 60 == 0) {
+        BW_LOG(DEBUG_COLLISION, DEBUG_VERBOSE, "COLLISION: Slid player from ({}, {}) to ({}, {}) over {} contact(s)",
+               newPosition.x, newPosition.z, capsule.x, capsule.z, contacts);
     }
 
+    newPosition.x = capsule.x;
+    newPosition.z = capsule.z;
+
     // Ground check
     if (newPosition.y < groundLevel + eyeHeight) {
         newPosition.y = groundLevel + eyeHeight;
     }
 }
 
+int CollisionSystem::slideCapsule(CapsuleQuery& capsule, float deltaX, float deltaZ, const ColliderCache& colliders,
+                                  const ColliderQuery& query, std::vector<uint32_t>& scratch) {
+    int contacts = 0;
+    for (int iteration = 0; iteration < MAX_SLIDE_ITERATIONS; ++iteration) {
+        float moveLength = std::sqrt(deltaX * deltaX + deltaZ * deltaZ);
+        if (moveLength < 1e-5f) break;
+
+        // Broadphase over this leg: the capsule at its start and end
+        BoundingBox sweepBox = {
+            {capsule.x - capsule.radius + std::min(deltaX, 0.0f), capsule.min_y - capsule.radius,
+             capsule.z - capsule.radius + std::min(deltaZ, 0.0f)},
+            {capsule.x + capsule.radius + std::max(deltaX, 0.0f), capsule.max_y + capsule.radius,
+             capsule.z + capsule.radius + std::max(deltaZ, 0.0f)}
+        };
+        query(sweepBox, scratch);
+
+        SweepHit hit = colliders.sweepCapsule(capsule, deltaX, deltaZ, scratch.data(), scratch.size());
+        if (hit.position < 0) {
+            capsule.x += deltaX;
+            capsule.z += deltaZ;
+            break;
+        }
+
+        // Advance to just short of contact, then project the remainder onto the contact plane
+        float safeTime = std::max(hit.time - COLLISION_SKIN / moveLength, 0.0f);
+        capsule.x += deltaX * safeTime;
+        capsule.z += deltaZ * safeTime;
+
+        float remainX = deltaX * (1.0f - safeTime);
+        float remainZ = deltaZ * (1.0f - safeTime);
+        float intoPlane = remainX * hit.normal.x + remainZ * hit.normal.z;
+        deltaX = (remainX - hit.normal.x * intoPlane) * WALL_SLIDE_MULTIPLIER;
+        deltaZ = (remainZ - hit.normal.z * intoPlane) * WALL_SLIDE_MULTIPLIER;
+        ++contacts;
+    }
+    return contacts;
+}
+
 // Door collision
 bool CollisionSystem::checkDoorCollision(const CollisionBounds& playerBounds, const EnvironmentManager& environment, int& doorBuildingId) {
-    auto objects = environment.getAllObjects();
-    for (const auto& obj : objects) {
-        if (auto building = std::dynamic_pointer_cast<Building>(obj)) {
-            // Check distance to door
-            if (MathUtils::distance3D(playerBounds.position, building->getDoorPosition()) < DOOR_INTERACTION_DISTANCE) {
-                doorBuildingId = building->getId();
-                return true;
-            }
+    for (const Building* building : environment.getBuildings()) {
+        // Check distance to door
+        if (MathUtils::distanceSquared3D(playerBounds.position, building->getDoorPosition()) <
+            DOOR_INTERACTION_DISTANCE * DOOR_INTERACTION_DISTANCE) {
+            doorBuildingId = building->getId();
+            return true;
         }
     }
     return false;
@@ -5,14 +5,22 @@
 #include "npc.h"  // For checkNPCCollision
 #include <algorithm>  // For std::clamp
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
 
 // Forward declaration to avoid circular dependency
 class EnvironmentManager;
+class ColliderCache;
+struct CapsuleQuery;
 
 // Collision system constants
 constexpr float WALL_SLIDE_MULTIPLIER = 0.7f;
 constexpr float MIN_MOVEMENT_THRESHOLD = 0.1f;
 constexpr float DOOR_INTERACTION_DISTANCE = 3.0f;
+constexpr int MAX_SLIDE_ITERATIONS = 4;      // Contact planes handled per move before giving up
+constexpr float COLLISION_SKIN = 0.01f;      // Gap kept from surfaces so the next sweep starts clear
 
 enum class CollisionShape {
     BOX,
@@ -32,6 +40,8 @@ struct CollisionBounds {
 class CollisionSystem {
 public:
     /// \brief Checks collision between two bounds.
+    /// Exact for every shape pair (boxes axis-aligned, round shapes upright); one indirect
+    /// call through a table of kernels generated per pair at compile time.
     /// \param bounds1 First bounds.
     /// \param bounds2 Second bounds.
     /// \return True if colliding.
@@ -48,7 +58,16 @@ public:
     /// \return Bounding box.
     static BoundingBox boundsToBox(const CollisionBounds& bounds);
 
+    /// \brief Converts bounds to an AABB that fully encloses the shape.
+    /// Unlike boundsToBox, round shapes are expanded by their full radius (size.x).
+    /// \param bounds Bounds to convert.
+    /// \return Enclosing bounding box.
+    static BoundingBox enclosingBox(const CollisionBounds& bounds);
+
     /// \brief Resolves collisions for player movement.
+    /// Sweeps the player capsule from originalPosition toward newPosition and slides along
+    /// contact planes, querying the environment's grid for each leg. Keeps no static state;
+    /// the environment's grid still takes one query at a time.
     /// \param newPosition Intended position.
     /// \param originalPosition Current position.
     /// \param playerRadius Player radius.
@@ -61,6 +80,22 @@ public:
     /// \param currentBuilding Current building ID.
     static void resolveCollisions(Vector3& newPosition, const Vector3& originalPosition, float playerRadius, float playerHeight, float playerY, float eyeHeight, float groundLevel, const EnvironmentManager& environment, bool isInBuilding, int currentBuilding);
 
+    /// \brief Broadphase for slideCapsule: fills `out` (cleared first) with collider indices near `area`.
+    using ColliderQuery = std::function<void(const BoundingBox& area, std::vector<uint32_t>& out)>;
+
+    /// \brief Moves a capsule through cached colliders, sliding along up to MAX_SLIDE_ITERATIONS
+    /// contact planes. Each leg queries the broadphase for its own sweep, since a slide can
+    /// turn out of the box the first leg covered. Reads only its arguments, so any thread may call it.
+    /// \param capsule Capsule at the start of the move; left where the move ends.
+    /// \param deltaX Intended move along X.
+    /// \param deltaZ Intended move along Z.
+    /// \param colliders Collider shapes.
+    /// \param query Broadphase over `colliders`.
+    /// \param scratch Caller-owned candidate buffer, reused across legs.
+    /// \return Number of contacts.
+    static int slideCapsule(CapsuleQuery& capsule, float deltaX, float deltaZ, const ColliderCache& colliders,
+                            const ColliderQuery& query, std::vector<uint32_t>& scratch);
+
     // Door-specific collision checking
     /// \brief Checks door collision.
     /// \param playerBounds Player bounds.
@@ -76,11 +111,6 @@ public:
     static bool canEnterBuilding(int buildingId, const EnvironmentManager& environment);
 
 private:
-    static bool checkBoxCollision(const CollisionBounds& box1, const CollisionBounds& bounds2);
-    static bool checkSphereCollision(const CollisionBounds& sphere1, const CollisionBounds& bounds2);
-    static bool checkCylinderCollision(const CollisionBounds& cyl1, const CollisionBounds& bounds2);
-    static bool checkCapsuleCollision(const CollisionBounds& capsule1, const CollisionBounds& bounds2);
-    static bool checkCapsuleCollision(const CollisionBounds& capsule, const BoundingBox& box);
     static bool pointInBox(Vector3 point, const CollisionBounds& box);
     static bool pointInSphere(Vector3 point, const CollisionBounds& sphere);
     static bool pointInCylinder(Vector3 point, const CollisionBounds& cylinder);
@@ -2,152 +2,326 @@
 #include "combat.h"
 #include "math_utils.h"
 #include "constants.h"
+#include "object_pool.h"
+#include "spatial_audio.h"
+#include "environment_manager.h"
+#include "environmental_object.h"
+#include "inventory.h"
+#include "npc.h"
+#include "ui_notification.h"
+#include <algorithm>
 #include <cmath>
+#include <string>
+#include <vector>
 
 const int MAX_SWINGS = GameConstants::MAX_SWINGS;
-LongswordSwing swings[MAX_SWINGS];
+// Swings are short-lived: recycle pooled slots instead of allocating per attack
+static ObjectPool<LongswordSwing, 8> swingPool;
+static std::vector<ObjectPool<LongswordSwing, 8>::Handle> activeSwings;
 float lastSwingTime = 0.0f;
 const float swingCooldown = GameConstants::SWING_COOLDOWN;
 const float swingRange = GameConstants::SWING_RANGE;
 const float swingSpeed = GameConstants::SWING_SPEED;
 const float swingDuration = GameConstants::SWING_DURATION;
 
-const int MAX_TARGETS = GameConstants::MAX_TARGETS;
-Target targets[MAX_TARGETS];
+// Targets are pooled too, and each has an anchor in the environment grid, so a swing only
+// tests the targets and NPCs around its blade however many there are
+static TargetPool targetPool;
+static std::vector<TargetHandle> activeTargets;
+static EnvironmentManager* combatEnvironment = nullptr;
 
-void initCombat() {
-    for (int i = 0; i < MAX_SWINGS; i++) {
-        swings[i].active = false;
+// Written by updateSwings (combat job), drained by applyCombatHits (main thread) after it
+static std::vector<CombatHit> pendingHits;
+static std::vector<uint32_t> sweepScratch;
+
+namespace {
+    // Per-swing dedupe keys: targets by handle, NPCs by id, kept apart by the top bit
+    uint64_t targetKey(TargetHandle handle) {
+        return (static_cast<uint64_t>(handle.generation) << 32) | handle.index;
+    }
+    uint64_t npcKey(int npc) {
+        return (1ull << 63) | static_cast<uint32_t>(npc);
+    }
+
+    // Marks the key as hit by this swing; false if it already was, or the swing is full
+    bool claimHit(LongswordSwing& swing, uint64_t key) {
+        for (int i = 0; i < swing.hitCount; i++) {
+            if (swing.hitKeys[i] == key) return false;
+        }
+        if (swing.hitCount >= LongswordSwing::MAX_HITS) return false;
+        swing.hitKeys[swing.hitCount++] = key;
+        return true;
+    }
+
+    Vector3 bladeTip(const LongswordSwing& swing) {
+        float reach = swingRange * std::min(swing.progress, 1.0f);
+        return {
+            swing.startPosition.x + swing.direction.x * reach,
+            swing.startPosition.y + swing.direction.y * reach,
+            swing.startPosition.z + swing.direction.z * reach
+        };
     }
 
-    Vector3 targetPositions[MAX_TARGETS] = {
+    void sweepSwing(LongswordSwing& swing, float currentTime, const EnvironmentManager& environment,
+                    const PlayerState& player) {
+        const Vector3 hilt = swing.startPosition;
+        const Vector3 tip = bladeTip(swing);
+        const float blade = GameConstants::SWING_HIT_RADIUS;
+
+        // Broad phase: the blade capsule's box, grown by the largest thing it can touch
+        float pad = blade + std::max(GameConstants::TARGET_RADIUS, NPCConstants::COLLISION_RADIUS);
+        BoundingBox area = {
+            {std::min(hilt.x, tip.x) - pad, std::min(hilt.y, tip.y) - NPCConstants::HEIGHT - pad, std::min(hilt.z, tip.z) - pad},
+            {std::max(hilt.x, tip.x) + pad, std::max(hilt.y, tip.y) + pad, std::max(hilt.z, tip.z) + pad}
+        };
+        environment.queryCandidates(area, sweepScratch);
+
+        const auto& objects = environment.getAllObjects();
+        const NPCSystem& npcs = NPCSystem::getInstance();
+        for (uint32_t index : sweepScratch) {
+            const EnvironmentalObject* object = objects[index].get();
+
+            if (const TargetAnchor* anchor = objectCast<TargetAnchor>(object)) {
+                TargetHandle handle = {anchor->getSlot(), anchor->getGeneration()};
+                Target* target = targetPool.get(handle);
+                if (!target || !target->active || target->hit) continue;
+                float reach = blade + target->radius;
+                if (MathUtils::segmentDistanceSquared3D(hilt, tip, target->position, target->position) > reach * reach) continue;
+                if (!claimHit(swing, targetKey(handle))) continue;
+
+                // Claimed here so a second swing this frame can't score the same target
+                target->hit = true;
+                target->hitTime = currentTime;
+                pendingHits.push_back({CombatHitKind::TARGET, handle, -1, tip});
+                ParticleSystem::getInstance().burst(ParticleType::HIT_SPARK, tip, ParticleConstants::HIT_SPARK_COUNT,
+                                                    {-swing.direction.x, -swing.direction.y, -swing.direction.z});
+            } else if (const NpcAnchor* npcAnchor = objectCast<NpcAnchor>(object)) {
+                int id = npcAnchor->getNpcIndex();
+                if (!npcs.isValid(id) || !npcs.isVisible(id, player.isInBuilding, player.currentBuilding)) continue;
+                Vector3 feet = npcs.getPosition(id);
+                Vector3 head = {feet.x, feet.y + NPCConstants::HEIGHT, feet.z};
+                float reach = blade + npcs.getCollisionRadius(id);
+                if (MathUtils::segmentDistanceSquared3D(hilt, tip, feet, head) > reach * reach) continue;
+                if (!claimHit(swing, npcKey(id))) continue;
+                pendingHits.push_back({CombatHitKind::NPC, TargetHandle{}, id, tip});
+            }
+        }
+    }
+}
+
+void initCombat(EnvironmentManager& environment) {
+    for (auto handle : activeSwings) {
+        ParticleSystem::getInstance().destroyEmitter(swingPool.get(handle)->trail);
+        swingPool.destroy(handle);
+    }
+    activeSwings.clear();
+    activeSwings.reserve(MAX_SWINGS);
+
+    // Anchors already in a previous environment stay there, like NPC anchors on NPCSystem::clear
+    for (auto handle : activeTargets) {
+        targetPool.destroy(handle);
+    }
+    activeTargets.clear();
+    pendingHits.clear();
+    combatEnvironment = &environment;
+
+    const Vector3 targetPositions[] = {
         {-8.0f, 3.0f, -5.0f},
         {8.0f, 3.0f, -5.0f},
         {0.0f, 3.0f, -10.0f},
         {-5.0f, 4.0f, 5.0f},
         {5.0f, 4.0f, 5.0f}
     };
-    Color targetColors[MAX_TARGETS] = {RED, GREEN, BLUE, YELLOW, PURPLE};
+    const Color targetColors[] = {RED, GREEN, BLUE, YELLOW, PURPLE};
+    static_assert(sizeof(targetPositions) / sizeof(targetPositions[0]) == GameConstants::MAX_TARGETS,
+                  "one position per practice target");
 
-    for (int i = 0; i < MAX_TARGETS; i++) {
-        targets[i].position = targetPositions[i];
-        targets[i].active = true;
-        targets[i].hit = false;
-        targets[i].color = targetColors[i];
+    for (int i = 0; i < GameConstants::MAX_TARGETS; i++) {
+        spawnTarget(targetPositions[i], targetColors[i]);
     }
 }
 
+TargetHandle spawnTarget(Vector3 position, Color color, float radius) {
+    TargetHandle handle = targetPool.create();
+    Target& target = *targetPool.get(handle);
+    target.position = position;
+    target.radius = radius;
+    target.active = true;
+    target.hit = false;
+    target.hitTime = 0.0f;
+    target.color = color;
+    target.anchor = std::make_shared<TargetAnchor>(position, handle.index, handle.generation, radius);
+    if (combatEnvironment) {
+        combatEnvironment->addObject(target.anchor);
+    }
+    activeTargets.push_back(handle);
+    return handle;
+}
+
+void removeTarget(TargetHandle handle) {
+    Target* target = targetPool.get(handle);
+    if (!target) return;
+    if (combatEnvironment && target->anchor) {
+        combatEnvironment->removeObjects({target->anchor});
+    }
+    targetPool.destroy(handle);
+    activeTargets.erase(std::find(activeTargets.begin(), activeTargets.end(), handle));
+}
+
+
 void updateMeleeSwing(Camera3D camera, float currentTime, GameState& state) {
-    for (int i = 0; i < MAX_SWINGS; i++) {
-        if (!swings[i].active) {
-            swings[i].startPosition = camera.position;
-            swings[i].startPosition.y -= 0.5f;
-
-            Vector3 forward = {
-                camera.target.x - camera.position.x,
-                camera.target.y - camera.position.y,
-                camera.target.z - camera.position.z
-            };
-
-            // Normalize the forward vector using math utilities
-            forward = MathUtils::normalizeVector3D(forward);
-
-            swings[i].direction = forward;
-            swings[i].endPosition = {
-                swings[i].startPosition.x + forward.x * swingRange,
-                swings[i].startPosition.y + forward.y * swingRange,
-                swings[i].startPosition.z + forward.z * swingRange
-            };
-
-            swings[i].active = true;
-            swings[i].progress = 0.0f;
-            swings[i].lifetime = swingDuration;
-            lastSwingTime = currentTime;
-            state.swingsPerformed++;
-            state.testMeleeSwing = true;
-
-            for (int t = 0; t < MAX_TARGETS; t++) {
-                if (targets[t].active && !targets[t].hit) {
-                    // Calculate distance to target using math utilities
-                    float distance = MathUtils::distance3D(targets[t].position, swings[i].startPosition);
-
-                    if (distance <= swingRange) {
-                        targets[t].hit = true;
-                        targets[t].hitTime = GetTime();
-                        state.meleeHits++;
-                        state.score += 150;
-                        state.testMeleeHitDetection = true;
-                    }
-                }
-            }
-            break;
-        }
+    if (static_cast<int>(activeSwings.size()) >= MAX_SWINGS) {
+        return;
     }
+
+    Vector3 forward = {
+        camera.target.x - camera.position.x,
+        camera.target.y - camera.position.y,
+        camera.target.z - camera.position.z
+    };
+
+    // Normalize the forward vector using math utilities
+    forward = MathUtils::normalizeVector3D(forward);
+
+    Vector3 start = camera.position;
+    start.y -= 0.5f;
+
+    auto handle = swingPool.create();
+    LongswordSwing& swing = *swingPool.get(handle);
+    swing.startPosition = start;
+    swing.direction = forward;
+    swing.endPosition = {
+        start.x + forward.x * swingRange,
+        start.y + forward.y * swingRange,
+        start.z + forward.z * swingRange
+    };
+    swing.active = true;
+    swing.progress = 0.0f;
+    swing.lifetime = swingDuration;
+    swing.hitCount = 0;
+    swing.trail = ParticleSystem::getInstance().createEmitter(ParticleType::BLADE_TRAIL, start,
+                                                              ParticleConstants::TRAIL_RATE);
+    activeSwings.push_back(handle);
+    SpatialAudio::getInstance().playAt(WorldSound::SWORD_SWING, start, 1.0f, AudioSpace::ANY);
+
+    lastSwingTime = currentTime;
+    state.combat.swingsPerformed++;
+    state.tests.meleeSwing = true;
 }
 
-void updateSwings() {
-    for (int i = 0; i < MAX_SWINGS; i++) {
-        if (swings[i].active) {
-            swings[i].progress += swingSpeed * GetFrameTime();
-            swings[i].lifetime -= GetFrameTime();
+void updateSwings(float deltaTime, float currentTime, const EnvironmentManager& environment, const PlayerState& player) {
+    // Expired swings go back to the pool; swap-remove keeps the active list dense. Each swing
+    // is swept after it advances, so the frame it finishes still gets its full-length test.
+    for (size_t i = 0; i < activeSwings.size();) {
+        LongswordSwing& swing = *swingPool.get(activeSwings[i]);
+        swing.progress += swingSpeed * deltaTime;
+        swing.lifetime -= deltaTime;
+        sweepSwing(swing, currentTime, environment, player);
+        ParticleSystem::getInstance().moveEmitter(swing.trail, bladeTip(swing));
 
-            if (swings[i].progress >= 1.0f || swings[i].lifetime <= 0) {
-                swings[i].active = false;
-            }
+        if (swing.progress >= 1.0f || swing.lifetime <= 0) {
+            ParticleSystem::getInstance().destroyEmitter(swing.trail);
+            swingPool.destroy(activeSwings[i]);
+            activeSwings[i] = activeSwings.back();
+            activeSwings.pop_back();
+        } else {
+            ++i;
         }
     }
 }
 
-void updateTargets() {
-    for (int t = 0; t < MAX_TARGETS; t++) {
-        if (targets[t].hit && (GetTime() - targets[t].hitTime) > 2.0f) {
-            targets[t].hit = false;
-            targets[t].active = true;
+void updateTargets(float currentTime) {
+    for (auto handle : activeTargets) {
+        Target& target = *targetPool.get(handle);
+        if (target.hit && (currentTime - target.hitTime) > GameConstants::TARGET_RESPAWN_TIME) {
+            target.hit = false;
+            target.active = true;
         }
     }
 }
 
-void renderCombat([[maybe_unused]] Camera3D camera, [[maybe_unused]] float currentTime) {
-    for (int s = 0; s < MAX_SWINGS; s++) {
-        if (swings[s].active) {
-            Vector3 currentPos = {
-                swings[s].startPosition.x + swings[s].direction.x * swingRange * swings[s].progress,
-                swings[s].startPosition.y + swings[s].direction.y * swingRange * swings[s].progress,
-                swings[s].startPosition.z + swings[s].direction.z * swingRange * swings[s].progress
-            };
-
-            DrawCylinderEx(swings[s].startPosition, currentPos, 0.02f, 0.01f, 8, RED);
-
-            Vector3 handleStart = swings[s].startPosition;
-            Vector3 handleEnd = {
-                handleStart.x + swings[s].direction.x * 0.5f,
-                handleStart.y + swings[s].direction.y * 0.5f,
-                handleStart.z + swings[s].direction.z * 0.5f
-            };
-            DrawCylinderEx(handleStart, handleEnd, 0.03f, 0.02f, 8, DARKBROWN);
-
-            DrawSphere(currentPos, 0.1f, Fade(YELLOW, 0.7f));
-
-            for (float trail = 0.2f; trail <= swings[s].progress; trail += 0.2f) {
-                Vector3 trailPos = {
-                    swings[s].startPosition.x + swings[s].direction.x * swingRange * trail,
-                    swings[s].startPosition.y + swings[s].direction.y * swingRange * trail,
-                    swings[s].startPosition.z + swings[s].direction.z * swingRange * trail
-                };
-                DrawSphere(trailPos, 0.03f, Fade(ORANGE, 0.3f * (1.0f - trail)));
+void applyCombatHits(GameState& state, InventorySystem* inventory) {
+    if (pendingHits.empty()) return;
+
+    int targetHits = 0;
+    int npcHits = 0;
+    int struckNpc = -1;
+    for (const CombatHit& hit : pendingHits) {
+        if (hit.kind == CombatHitKind::TARGET) {
+            targetHits++;
+        } else {
+            npcHits++;
+            struckNpc = hit.npc;
+        }
+    }
+    pendingHits.clear();
+
+    state.combat.meleeHits += targetHits;
+    state.combat.score += targetHits * GameConstants::TARGET_HIT_SCORE;
+    state.tests.meleeHitDetection = true;
+    // Hits land frames after MELEE_SWING was posted; stats panels need telling again
+    state.notifyChange(StateChange::COMBAT_HIT);
+
+    auto& notifications = UINotification::NotificationManager::getInstance();
+    if (inventory) {
+        EquipmentManager& equipment = inventory->getEquipment();
+        auto weapon = equipment.getEquippedItem(EquipmentSlot::MAIN_HAND);
+        if (weapon && !weapon->isBroken()) {
+            equipment.damageEquipment(EquipmentSlot::MAIN_HAND,
+                                      GameConstants::WEAPON_WEAR_PER_HIT * static_cast<float>(targetHits + npcHits));
+            if (weapon->isBroken()) {
+                notifications.showWarning("Weapon Broken", weapon->getName() + " needs repair");
             }
         }
     }
 
-    bool isSwinging = false;
-    for (int s = 0; s < MAX_SWINGS; s++) {
-        if (swings[s].active) {
-            isSwinging = true;
-            break;
+    if (targetHits > 0) {
+        std::string message = "+" + std::to_string(targetHits * GameConstants::TARGET_HIT_SCORE) + " points";
+        if (targetHits > 1) {
+            message = std::to_string(targetHits) + " targets, " + message;
         }
+        notifications.showSuccess("Target Hit", message);
+    }
+    if (npcHits > 0) {
+        const NPCSystem& npcs = NPCSystem::getInstance();
+        std::string who = npcs.isValid(struckNpc) ? npcs.getName(struckNpc) : "Someone";
+        notifications.showWarning("Careful!", npcHits > 1 ? "You struck " + std::to_string(npcHits) + " townsfolk"
+                                                          : who + " doesn't appreciate that");
+    }
+}
+
+void renderCombat([[maybe_unused]] Camera3D camera, [[maybe_unused]] float currentTime) {
+    for (auto handle : activeSwings) {
+        const LongswordSwing& swing = *swingPool.get(handle);
+        Vector3 currentPos = {
+            swing.startPosition.x + swing.direction.x * swingRange * swing.progress,
+            swing.startPosition.y + swing.direction.y * swingRange * swing.progress,
+            swing.startPosition.z + swing.direction.z * swingRange * swing.progress
+        };
+
+        DrawCylinderEx(swing.startPosition, currentPos, 0.02f, 0.01f, 8, RED);
+
+        Vector3 handleStart = swing.startPosition;
+        Vector3 handleEnd = {
+            handleStart.x + swing.direction.x * 0.5f,
+            handleStart.y + swing.direction.y * 0.5f,
+            handleStart.z + swing.direction.z * 0.5f
+        };
+        DrawCylinderEx(handleStart, handleEnd, 0.03f, 0.02f, 8, DARKBROWN);
+
+        DrawSphere(currentPos, 0.1f, Fade(YELLOW, 0.7f));
+        // The trail behind the tip is the swing's BLADE_TRAIL emitter, drawn by ParticleSystem
+    }
+
+    for (auto handle : activeTargets) {
+        const Target& target = *targetPool.get(handle);
+        if (!target.active) continue;
+        Color color = target.hit ? Fade(GRAY, 0.5f) : target.color;
+        DrawSphere(target.position, target.radius, color);
+        DrawSphereWires(target.position, target.radius * 1.05f, 6, 8, Fade(BLACK, 0.4f));
     }
 
-    if (isSwinging) {
+    if (!activeSwings.empty()) {
         DrawSphereWires(camera.position, swingRange, 8, 16, Fade(RED, 0.5f));
     }
 }
\ No newline at end of file
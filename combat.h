@@ -4,39 +4,86 @@
 
 #include "raylib.h"
 #include "game_state.h"
+#include "constants.h"
+#include "object_pool.h"
+#include "particle_system.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class EnvironmentManager;
+class InventorySystem;
+class TargetAnchor;
 
 struct LongswordSwing {
+    static constexpr int MAX_HITS = 16;   // Distinct things one swing can strike
+
     Vector3 startPosition;
     Vector3 endPosition;
     Vector3 direction;
     bool active;
     float progress;
     float lifetime;
+    uint64_t hitKeys[MAX_HITS];           // Already struck this swing; see combat.cpp
+    int hitCount;
+    ParticleSystem::EmitterHandle trail;  // Follows the blade tip
 };
 
 struct Target {
     Vector3 position;
+    float radius;
     bool active;
     bool hit;
     float hitTime;
     Color color;
+    std::shared_ptr<TargetAnchor> anchor;  // Its entry in the environment's spatial grid
+};
+
+using TargetPool = ObjectPool<Target, 32>;
+using TargetHandle = TargetPool::Handle;
+
+enum class CombatHitKind : uint8_t { TARGET, NPC };
+
+/// \brief One thing a swing struck, queued by updateSwings for applyCombatHits.
+struct CombatHit {
+    CombatHitKind kind;
+    TargetHandle target;   // TARGET hits
+    int npc;               // NPC hits: NPCSystem id
+    Vector3 point;         // Blade tip when the hit registered
 };
 
 extern const int MAX_SWINGS;
-extern LongswordSwing swings[];
 extern float lastSwingTime;
 extern const float swingCooldown;
 extern const float swingRange;
 extern const float swingSpeed;
 extern const float swingDuration;
 
-extern const int MAX_TARGETS;
-extern Target targets[];
+/// \brief Clears swings and targets, then places the practice targets in the environment.
+void initCombat(EnvironmentManager& environment);
 
-void initCombat();
+/// \brief Adds a target and registers it with the environment given to initCombat.
+TargetHandle spawnTarget(Vector3 position, Color color, float radius = GameConstants::TARGET_RADIUS);
+
+/// \brief Takes a target out of the pool and the environment. Stale handles are ignored.
+void removeTarget(TargetHandle handle);
+
+/// \brief Starts a swing from the camera if fewer than MAX_SWINGS are in flight.
 void updateMeleeSwing(Camera3D camera, float currentTime, GameState& state);
-void updateSwings();
-void updateTargets();
+
+/// \brief Advances swings and sweeps each blade, a capsule from the hilt to the tip, against
+/// targets and visible NPCs found through the environment's spatial grid. Hits are queued for
+/// applyCombatHits. Reads the grid, so nothing else may query it concurrently.
+/// \param player Where the player is, for NPC visibility; the rest of GameState isn't touched.
+void updateSwings(float deltaTime, float currentTime, const EnvironmentManager& environment, const PlayerState& player);
+
+/// \brief Re-arms targets TARGET_RESPAWN_TIME after they were hit.
+void updateTargets(float currentTime);
+
+/// \brief Applies the hits queued since the last call in one pass: score, one durability
+/// charge to the main-hand weapon and one notification per kind of hit. Main thread only.
+void applyCombatHits(GameState& state, InventorySystem* inventory);
+
 void renderCombat(Camera3D camera, float currentTime);
 
-#endif
\ No newline at end of file
+#endif
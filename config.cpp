@@ -18,6 +18,12 @@ GameConfig loadConfig(const std::string& configPath) {
                 config.fullscreen = (line.substr(11) == "true");
             } else if (line.find("windowTitle=") == 0) {
                 config.windowTitle = line.substr(12);
+            } else if (line.find("assetGpuBudgetMB=") == 0) {
+                config.assetGpuBudgetMB = std::stoi(line.substr(17));
+            } else if (line.find("assetCpuBudgetMB=") == 0) {
+                config.assetCpuBudgetMB = std::stoi(line.substr(17));
+            } else if (line.find("telemetryPort=") == 0) {
+                config.telemetryPort = std::stoi(line.substr(14));
             }
         }
     }
@@ -1,6 +1,7 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include "constants.h"
 #include <string>
 
 struct GameConfig {
@@ -9,6 +10,9 @@ struct GameConfig {
     int targetFPS = 60;
     bool fullscreen = false;
     std::string windowTitle = "Browserwind - 3D FPS Game (1920x1080)";
+    int assetGpuBudgetMB = AssetConstants::GPU_BUDGET_MB;
+    int assetCpuBudgetMB = AssetConstants::CPU_BUDGET_MB;
+    int telemetryPort = 0;  // Local Prometheus endpoint; 0 leaves telemetry off
 };
 
 GameConfig loadConfig(const std::string& configPath);
@@ -2,6 +2,8 @@
 #ifndef CONSTANTS_H
 #define CONSTANTS_H
 
+#include <cstddef>
+
 // ============================================================================
 // PLAYER CONSTANTS
 // ============================================================================
@@ -15,6 +17,7 @@ namespace PlayerConstants {
     constexpr float GRAVITY = -15.0f;            // Gravity acceleration
     constexpr float GROUND_LEVEL = 0.0f;         // Ground Y position
     constexpr float MOUSE_SENSITIVITY = 0.003f;   // Mouse look sensitivity
+    constexpr float RAW_MOUSE_SCALE = 1.0f;       // Look pixels per raw device count (RawMouseSampler)
     constexpr float MAX_PITCH = 1.5f;             // Maximum look up/down angle
 }
 
@@ -24,6 +27,7 @@ namespace PlayerConstants {
 
 namespace EnvironmentConstants {
     constexpr float INTERACTION_DISTANCE = 3.0f;  // Distance for interactions
+    constexpr float NEARBY_QUERY_RADIUS = 40.0f;  // Per-frame interactable search; also how far building signs show
     constexpr float BUILDING_DOOR_HEIGHT = 2.0f;  // Standard door height
     constexpr float BUILDING_DOOR_WIDTH = 1.2f;   // Standard door width
     constexpr float TREE_TRUNK_HEIGHT = 4.0f;     // Standard tree height
@@ -31,6 +35,26 @@ namespace EnvironmentConstants {
     constexpr float TREE_FOLIAGE_RADIUS = 2.5f;   // Standard tree foliage radius
     constexpr float WELL_BASE_RADIUS = 1.5f;      // Standard well radius
     constexpr float WELL_HEIGHT = 2.5f;           // Standard well height
+    constexpr float LOAD_INTEGRATION_BUDGET_MS = 2.0f;  // Main-thread time per frame for adding streamed objects
+    constexpr float WORLD_CELL_SIZE = 32.0f;      // Streaming cell edge length
+    constexpr float STREAM_LOAD_RADIUS = 96.0f;   // Cells closer than this are loaded
+    constexpr float STREAM_UNLOAD_RADIUS = 128.0f;  // Cells farther than this are unloaded
+    constexpr const char* WORLD_PACK_PATH = "world.bwpk";  // Optional extra content built by `make pack`
+    constexpr size_t STREAM_MEMORY_BUDGET_BYTES = 8u * 1024u * 1024u;  // Estimated cap for streamed cells
+    constexpr size_t UPDATE_JOB_GRAIN = 256;      // Objects per job when updates fan out across workers
+}
+
+// ============================================================================
+// AUDIO CONSTANTS
+// ============================================================================
+
+namespace AudioConstants {
+    constexpr size_t MAX_EMITTER_VOICES = 8;      // Nearest audible emitters that get a voice
+    constexpr size_t VOICES_PER_WORLD_SOUND = 10; // Aliases per world sound: every emitter voice plus a couple of one-shots
+    constexpr float MAX_AUDIBLE_DISTANCE = 40.0f; // Emitter query half-extent; emitter radii are clamped to it
+    constexpr float ONE_SHOT_RADIUS = 25.0f;      // Audible range of positional one-shots (swings, doors, voices)
+    constexpr float WELL_EMITTER_RADIUS = 12.0f;  // Water ambience around each well
+    constexpr float WELL_EMITTER_VOLUME = 0.5f;
 }
 
 // ============================================================================
@@ -45,6 +69,9 @@ namespace UIConstants {
     constexpr float UI_ALPHA_TOOLTIPS = 0.98f;
     constexpr float PULSE_SPEED = 5.0f;           // UI pulse animation speed
     constexpr float NPC_PULSE_SPEED = 3.0f;       // NPC interaction pulse speed
+    constexpr int FONT_SDF_BASE_SIZE = 48;        // Rasterization size of every theme font's SDF atlas
+    constexpr int FONT_GLYPH_COUNT = 95;          // Printable ASCII, starting at ' '
+    constexpr float FONT_UPLOAD_BUDGET_MS = 1.0f; // Main-thread time per frame for font atlas uploads
 }
 
 // ============================================================================
@@ -59,12 +86,161 @@ namespace GameConstants {
     constexpr float SWING_RANGE = 3.0f;
     constexpr float SWING_SPEED = 8.0f;
     constexpr float SWING_DURATION = 0.3f;
-    constexpr int MAX_TARGETS = 5;
-    constexpr int MAX_NPCS = 2;
+    constexpr int MAX_TARGETS = 5;                // Practice targets initCombat places
+    constexpr float SWING_HIT_RADIUS = 0.35f;     // Blade capsule radius for hit sweeps
+    constexpr float TARGET_RADIUS = 0.5f;
+    constexpr float TARGET_RESPAWN_TIME = 2.0f;
+    constexpr int TARGET_HIT_SCORE = 150;
+    constexpr float WEAPON_WEAR_PER_HIT = 0.5f;   // Main-hand durability lost per landed hit
     constexpr int INVENTORY_CAPACITY = 150.0f;     // kg
     constexpr int INVENTORY_SLOTS = 60;
 }
 
+// ============================================================================
+// NPC CONSTANTS
+// ============================================================================
+
+namespace NPCConstants {
+    constexpr int TOWNSFOLK_COUNT = 150;          // Wandering NPCs spawned around the town square
+    constexpr float TOWN_INNER_RADIUS = 6.0f;     // Townsfolk spawn between these distances from the well
+    constexpr float TOWN_OUTER_RADIUS = 45.0f;
+    constexpr float COLLISION_RADIUS = 0.6f;      // Capsule NPCs collide with
+    constexpr float HEIGHT = 2.0f;
+    constexpr float WALK_SPEED = 1.2f;            // Metres per second
+    constexpr float WANDER_RADIUS = 6.0f;         // How far townsfolk stray from where they spawned
+    constexpr float MIN_IDLE_TIME = 1.5f;         // Pause between walks, picked per NPC
+    constexpr float MAX_IDLE_TIME = 6.0f;
+    constexpr float ARRIVE_DISTANCE = 0.2f;
+
+    // Crowd LOD by distance from the camera
+    constexpr float NEAR_DISTANCE = 25.0f;        // Full model, moves every frame
+    constexpr float MID_DISTANCE = 60.0f;         // Simplified model; beyond this NPCs aren't drawn
+    constexpr int MID_UPDATE_INTERVAL = 4;        // Frames between movement updates
+    constexpr int FAR_UPDATE_INTERVAL = 16;
+    constexpr float MAX_STEP_TIME = 0.5f;         // Accumulated time integrated in one step at most
+    constexpr float LABEL_DISTANCE = 12.0f;       // Townsfolk name tags show within this range
+
+    // Thinking (choosing where to walk) shares one budget per frame; nearby NPCs go first.
+    // Counted rather than timed, so who thinks on which frame doesn't depend on host speed
+    // and recordings and benchmarks replay the same crowd
+    constexpr int THINK_BUDGET = 32;              // Thoughts beyond the near tier per frame
+}
+
+// ============================================================================
+// DIALOG CONSTANTS
+// ============================================================================
+
+namespace DialogConstants {
+    constexpr const char* PACK_PATH = "dialog.bwdg";  // Optional; built by `make dialog`, else the built-in graph is used
+    constexpr int MAX_VISIBLE_OPTIONS = 3;        // Buttons the dialog window has room for
+}
+
+// ============================================================================
+// NAVIGATION CONSTANTS
+// ============================================================================
+
+namespace NavConstants {
+    constexpr float CELL_SIZE = 0.5f;             // Walkability grid resolution
+    constexpr float HALF_EXTENT = 128.0f;         // Grid covers +/- this around the origin; outside is blocked
+    constexpr int CLUSTER_CELLS = 16;             // Cells per side of a cluster; re-plans are tracked per cluster
+    constexpr float AGENT_RADIUS = 0.6f;          // Obstacles are inflated by this (NPCConstants::COLLISION_RADIUS)
+    constexpr float AGENT_HEIGHT = 2.0f;          // Obstacles entirely above this don't block
+    constexpr int MAX_EXPANSIONS = 8192;          // A* gives up past this many nodes
+    constexpr int SNAP_CELLS = 3;                 // Blocked start/goal cells snap to a free one this close
+    constexpr int CACHE_CAPACITY = 256;           // Cached routes, oldest dropped first
+    constexpr int CACHE_QUANTUM_CELLS = 4;        // Start/goal cells share a cache entry within this
+}
+
+// ============================================================================
+// PARTICLE CONSTANTS
+// ============================================================================
+
+namespace ParticleConstants {
+    constexpr int MAX_PER_TYPE = 2048;            // Quads per type; 4x this fits one default rlgl batch
+    constexpr float TRAIL_RATE = 240.0f;          // Blade trail particles per second while a swing is live
+    constexpr int HIT_SPARK_COUNT = 24;           // Sparks per landed hit
+    constexpr float WELL_DUST_RATE = 6.0f;        // Ambient motes around each well
+}
+
+// ============================================================================
+// SIMULATION CONSTANTS
+// ============================================================================
+
+namespace SimulationConstants {
+    constexpr float FIXED_DELTA_TIME = 1.0f / 60.0f;  // Simulation step, independent of render rate
+    constexpr int MAX_STEPS_PER_FRAME = 5;        // Catch-up cap; time beyond it is dropped
+    constexpr float MAX_FRAME_TIME = 0.25f;       // Longer frames (breakpoints, window drags) are clamped first
+    constexpr float SNAP_DISTANCE = 5.0f;         // Camera moves farther than this in one step are teleports, not interpolated
+}
+
+// ============================================================================
+// SERVER CONSTANTS
+// ============================================================================
+
+namespace ServerConstants {
+    constexpr int DEFAULT_INSTANCES = 64;         // Headless simulations per process (--server)
+    constexpr int DEFAULT_TICKS = 3600;           // Steps each instance runs: one simulated minute
+    constexpr int NPCS_PER_INSTANCE = 16;         // Each instance walks its own crowd
+    constexpr int SLICE_TICKS = 60;               // Steps an instance runs per scheduled job
+    constexpr float COLLIDER_CELL_SIZE = 8.0f;    // Shared world's flat collider grid
+    constexpr float BOT_WANDER_RADIUS = 40.0f;    // Bots and their crowds roam this far from the well
+    constexpr float BOT_JUMP_CHANCE = 0.005f;     // Per step, while walking
+    constexpr float BOT_STUCK_TIME = 1.0f;        // A bot blocked this long picks a new goal
+    constexpr int BOT_STAMINA_PER_SWING = 5;
+}
+
+// ============================================================================
+// LOGGING CONSTANTS
+// ============================================================================
+
+namespace LogConstants {
+    constexpr const char* LOG_PATH = "debug_log.txt";
+    constexpr int DEFAULT_LEVEL = 1;              // DEBUG_BASIC; per-frame traces sit at DEBUG_TRACE
+}
+
+// ============================================================================
+// HOT RELOAD CONSTANTS
+// ============================================================================
+
+namespace HotReloadConstants {
+    constexpr const char* CONFIG_PATH = "config.ini";
+    constexpr const char* THEME_PATH = "theme.txt";   // Optional ThemeData::serialize() text; loaded as the custom theme
+    constexpr float DEBOUNCE_SECONDS = 0.25f;     // A file must be quiet this long before it's reloaded
+    constexpr int WATCH_TIMEOUT_MS = 100;         // How quickly the watcher thread notices stop()
+    constexpr int POLL_INTERVAL_MS = 500;         // Modification-time polling, where inotify isn't available
+}
+
+// ============================================================================
+// TELEMETRY CONSTANTS
+// ============================================================================
+
+namespace TelemetryConstants {
+    constexpr int SAMPLE_INTERVAL_FRAMES = 30;    // Main-thread sampling rate; scrapes read the latest sample
+    constexpr int LISTEN_BACKLOG = 4;
+    constexpr int ACCEPT_TIMEOUT_MS = 100;        // How quickly the server thread notices stop()
+    constexpr int REQUEST_TIMEOUT_MS = 200;       // A scraper slower than this to send its request is dropped
+    constexpr int MAX_REQUEST_BYTES = 4096;
+}
+
+// ============================================================================
+// MEMORY CONSTANTS
+// ============================================================================
+
+namespace MemoryConstants {
+    constexpr int FRAME_ALLOC_ALARM = 64;         // A tagged subsystem allocating more often than this per frame is flagged
+    constexpr int FRAME_ARENA_BLOCK_SIZE = 64 * 1024;  // First block of the per-frame string arena
+}
+
+// ============================================================================
+// ASSET CONSTANTS
+// ============================================================================
+
+namespace AssetConstants {
+    constexpr int GPU_BUDGET_MB = 256;            // Unreferenced textures and meshes are evicted past this
+    constexpr int CPU_BUDGET_MB = 256;            // Decoded images and raylib's CPU copies of meshes
+    constexpr float UPLOAD_BUDGET_MS = 2.0f;      // Per-frame time for texture uploads and model loads
+}
+
 // ============================================================================
 // RENDERING CONSTANTS
 // ============================================================================
@@ -74,6 +250,36 @@ namespace RenderConstants {
     constexpr int TREE_CYLINDER_SEGMENTS = 8;     // Tree trunk resolution
     constexpr float BUILDING_ROOF_OFFSET = 0.5f;  // Roof height above building
     constexpr float FLOOR_OFFSET = 0.02f;         // Small offset for floor rendering
+
+    // Distance LOD and culling
+    constexpr float CAMERA_NEAR_PLANE = 0.05f;    // Matches raylib's default cull distance
+    constexpr float LOD_MAX_DISTANCE = 80.0f;     // Objects beyond this are culled
+    constexpr float LOD_MEDIUM_FRACTION = 0.3f;   // Past 30% of max distance drop to MEDIUM
+    constexpr float LOD_LOW_FRACTION = 0.7f;      // Past 70% of max distance drop to LOW
+    constexpr int CYLINDER_SEGMENTS_MEDIUM = 10;
+    constexpr int CYLINDER_SEGMENTS_LOW = 6;
+}
+
+// ============================================================================
+// QUALITY CONSTANTS
+// ============================================================================
+
+namespace QualityConstants {
+    constexpr int LEVEL_COUNT = 6;                // Level 0 is full quality; each level steps every setting down equally
+    constexpr int WINDOW_FRAMES = 120;            // Rolling window the percentile is taken over
+    constexpr float PERCENTILE = 95.0f;
+    constexpr float DOWNSHIFT_RATIO = 1.15f;      // Percentile above target x this lowers quality
+    constexpr float UPSHIFT_RATIO = 1.05f;        // Percentile at or under target x this may raise it again
+    constexpr float UPSHIFT_DELAY = 5.0f;         // Seconds of good frames before a raise
+    constexpr float MAX_UPSHIFT_DELAY = 60.0f;    // A raise undone within PROBE_TIME doubles the delay, up to this
+    constexpr float PROBE_TIME = 5.0f;
+
+    // Lowest level's settings; level 0 uses the normal constants
+    constexpr float MIN_LOD_DISTANCE = 40.0f;
+    constexpr float MIN_CULL_DISTANCE = 48.0f;
+    constexpr int MIN_PARTICLE_BUDGET = 256;
+    constexpr int MAX_NPC_INTERVAL_SCALE = 4;
+    constexpr float MAX_UI_REFRESH_INTERVAL = 0.5f;
 }
 
 #endif // CONSTANTS_H
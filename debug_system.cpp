@@ -7,7 +7,9 @@ bool DEBUG_MODE = false;
 
 // Stub implementations - do nothing for performance
 void DebugSystem::initialize() {}
-void DebugSystem::log([[maybe_unused]] DebugCategory category, [[maybe_unused]] int level, [[maybe_unused]] const char* file, [[maybe_unused]] int line, [[maybe_unused]] const char* function, [[maybe_unused]] const std::string& message) {}
+void DebugSystem::log(DebugCategory category, int level, [[maybe_unused]] const char* file, int line, const char* function, const std::string& message) {
+    AsyncLog::getInstance().write(category, level, "{} ({}:{})", message, function, line);
+}
 void DebugSystem::traceEnter([[maybe_unused]] const char* functionName) {}
 void DebugSystem::traceExit([[maybe_unused]] const char* functionName) {}
 void DebugSystem::setLastKnownLocation([[maybe_unused]] const std::string& location) {}
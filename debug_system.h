@@ -1,8 +1,10 @@
 #pragma once
+#include "async_log.h"  // DebugLevel, DebugCategory and the backend log() writes to
 #include <iostream>
 #include <string>
 #include <chrono>
 #include <vector>
+#include <unordered_map>
 #include <csignal>
 
 // ============================================================================
@@ -14,31 +16,10 @@ extern bool DEBUG_MODE;
 extern bool VERBOSE_LOGGING;
 extern int DEBUG_LEVEL;
 
-// Debug levels
-enum DebugLevel {
-    DEBUG_NONE = 0,
-    DEBUG_BASIC = 1,
-    DEBUG_DETAILED = 2,
-    DEBUG_VERBOSE = 3,
-    DEBUG_TRACE = 4
-};
-
-// Debug categories
-enum DebugCategory {
-    DEBUG_GENERAL,
-    DEBUG_UI,
-    DEBUG_INVENTORY,
-    DEBUG_RENDERING,
-    DEBUG_THEME,
-    DEBUG_INPUT,
-    DEBUG_MEMORY,
-    DEBUG_PERFORMANCE
-};
-
 #ifdef BROWSERWIND_DEBUG
-// Debug macros for easy usage
+// Debug macros for easy usage. The message expression is only built when the category is enabled.
 #define DEBUG_LOG(category, level, message) \
-    if (DEBUG_MODE && DEBUG_LEVEL >= level) { \
+    if (DEBUG_MODE && AsyncLog::isEnabled(category, level)) { \
         DebugSystem::log(category, level, __FILE__, __LINE__, __FUNCTION__, message); \
     }
 
@@ -0,0 +1,419 @@
+#include "dialog_pack.h"
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace DialogPackFormat;
+
+namespace {
+
+const char* const END_TARGET = "end";
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t");
+    if (begin == std::string::npos) return std::string();
+    size_t end = text.find_last_not_of(" \t");
+    return text.substr(begin, end - begin + 1);
+}
+
+bool parseStat(const std::string& name, Stat& out) {
+    static const struct { const char* name; Stat stat; } STATS[] = {
+        {"level", LEVEL}, {"health", HEALTH}, {"mana", MANA},
+        {"stamina", STAMINA}, {"experience", EXPERIENCE}, {"score", SCORE},
+    };
+    for (const auto& s : STATS) {
+        if (name == s.name) {
+            out = s.stat;
+            return true;
+        }
+    }
+    return false;
+}
+
+// `<stat> >= N`, `<stat> < N` or `item <name> >= N`
+bool parseCondition(const std::string& text, DialogSource::Condition& out) {
+    size_t opPos = text.rfind(">=");
+    size_t opLength = 2;
+    out.op = AT_LEAST;
+    if (opPos == std::string::npos) {
+        opPos = text.rfind('<');
+        opLength = 1;
+        out.op = BELOW;
+    }
+    if (opPos == std::string::npos) return false;
+
+    std::string subject = trim(text.substr(0, opPos));
+    std::string number = trim(text.substr(opPos + opLength));
+    char* end = nullptr;
+    out.value = static_cast<int>(std::strtol(number.c_str(), &end, 10));
+    if (number.empty() || *end != '\0') return false;
+
+    if (subject.compare(0, 5, "item ") == 0) {
+        out.kind = ITEM;
+        out.item = trim(subject.substr(5));
+        return !out.item.empty();
+    }
+    out.kind = STAT;
+    return parseStat(subject, out.stat);
+}
+
+// Deduplicates strings as they're added; every entry is followed by a NUL
+class StringInterner {
+public:
+    StringRef add(const std::string& text) {
+        auto it = refs_.find(text);
+        if (it != refs_.end()) return it->second;
+        StringRef ref{static_cast<uint32_t>(table_.size()), static_cast<uint32_t>(text.size())};
+        table_ += text;
+        table_ += '\0';
+        refs_.emplace(text, ref);
+        return ref;
+    }
+
+    const std::string& table() const { return table_; }
+
+private:
+    std::string table_;
+    std::unordered_map<std::string, StringRef> refs_;
+};
+
+template <typename T>
+void appendRecords(std::vector<uint8_t>& out, const std::vector<T>& records) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(records.data());
+    out.insert(out.end(), bytes, bytes + records.size() * sizeof(T));
+}
+
+bool validString(StringRef ref, const char* strings, uint32_t size) {
+    return ref.offset < size && ref.length < size - ref.offset && strings[ref.offset + ref.length] == '\0';
+}
+
+}  // namespace
+
+bool parseDialogText(std::istream& in, const std::string& sourceName, DialogSource& out) {
+    DialogSource::Node* node = nullptr;
+    DialogSource::NpcEntry* npc = nullptr;
+    std::string line;
+    int lineNumber = 0;
+
+    auto fail = [&](const char* what) {
+        std::cout << "DIALOG PACK: " << what << " at " << sourceName << ":" << lineNumber << std::endl;
+        return false;
+    };
+
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+
+        if (line.front() == '[' && line.back() == ']') {
+            std::string header = line.substr(1, line.size() - 2);
+            node = nullptr;
+            npc = nullptr;
+            if (header.compare(0, 5, "node ") == 0) {
+                out.nodes.push_back({});
+                node = &out.nodes.back();
+                node->id = trim(header.substr(5));
+                if (node->id.empty() || node->id == END_TARGET) return fail("Bad node id");
+            } else if (header.compare(0, 4, "npc ") == 0) {
+                out.npcs.push_back({trim(header.substr(4)), std::string()});
+                npc = &out.npcs.back();
+            } else {
+                return fail("Unknown section");
+            }
+            continue;
+        }
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) return fail("Expected key = value");
+        std::string key = trim(line.substr(0, eq));
+        std::string value = trim(line.substr(eq + 1));
+
+        if (npc) {
+            if (key != "start") return fail("Unknown npc key");
+            npc->start = value;
+        } else if (!node) {
+            return fail("Key outside a section");
+        } else if (key == "speaker") {
+            node->speaker = value;
+        } else if (key == "text") {
+            node->text = value;
+        } else if (key == "option") {
+            size_t arrow = value.rfind("->");
+            if (arrow == std::string::npos) return fail("Option without '-> target'");
+            node->options.push_back({trim(value.substr(0, arrow)), trim(value.substr(arrow + 2)), {}});
+        } else if (key == "require") {
+            if (node->options.empty()) return fail("'require' before any option");
+            DialogSource::Condition condition;
+            if (!parseCondition(value, condition)) return fail("Bad condition");
+            node->options.back().conditions.push_back(condition);
+        } else {
+            return fail("Unknown node key");
+        }
+    }
+    return true;
+}
+
+bool compileDialogPack(const DialogSource& source, std::vector<uint8_t>& out) {
+    std::unordered_map<std::string, uint32_t> ids;
+    for (size_t i = 0; i < source.nodes.size(); ++i) {
+        if (!ids.emplace(source.nodes[i].id, static_cast<uint32_t>(i)).second) {
+            std::cout << "DIALOG PACK: Duplicate node '" << source.nodes[i].id << "'" << std::endl;
+            return false;
+        }
+    }
+
+    auto resolve = [&](const std::string& id, uint32_t& index) {
+        if (id == END_TARGET) {
+            index = NO_NODE;
+            return true;
+        }
+        auto it = ids.find(id);
+        if (it == ids.end()) {
+            std::cout << "DIALOG PACK: Unknown node '" << id << "'" << std::endl;
+            return false;
+        }
+        index = it->second;
+        return true;
+    };
+
+    StringInterner strings;
+    std::vector<NpcRecord> npcs;
+    std::vector<NodeRecord> nodes;
+    std::vector<OptionRecord> options;
+    std::vector<ConditionRecord> conditions;
+    uint32_t defaultStart = NO_NODE;
+
+    for (const DialogSource::NpcEntry& entry : source.npcs) {
+        uint32_t start;
+        if (!resolve(entry.start, start) || start == NO_NODE) {
+            std::cout << "DIALOG PACK: NPC '" << entry.name << "' needs a start node" << std::endl;
+            return false;
+        }
+        if (entry.name == "*") {
+            defaultStart = start;
+        } else {
+            npcs.push_back({strings.add(entry.name), start});
+        }
+    }
+
+    for (const DialogSource::Node& node : source.nodes) {
+        NodeRecord record{};
+        if (node.speaker == "@npc") record.flags |= SPEAKER_FROM_NPC;
+        else record.speaker = strings.add(node.speaker);
+        if (node.text == "@greeting") record.flags |= TEXT_FROM_NPC;
+        else record.text = strings.add(node.text);
+        record.first_option = static_cast<uint32_t>(options.size());
+        record.option_count = static_cast<uint16_t>(node.options.size());
+
+        for (const DialogSource::Option& option : node.options) {
+            OptionRecord o{};
+            o.label = strings.add(option.label);
+            if (!resolve(option.target, o.target)) return false;
+            o.first_condition = static_cast<uint32_t>(conditions.size());
+            o.condition_count = static_cast<uint16_t>(option.conditions.size());
+            options.push_back(o);
+
+            for (const DialogSource::Condition& condition : option.conditions) {
+                ConditionRecord c{};
+                c.kind = condition.kind;
+                c.op = condition.op;
+                c.stat = condition.stat;
+                c.value = condition.value;
+                if (condition.kind == ITEM) c.item = strings.add(condition.item);
+                conditions.push_back(c);
+            }
+        }
+        nodes.push_back(record);
+    }
+    // Fields left empty still need a valid (empty, terminated) string to point at
+    StringRef empty = strings.add(std::string());
+    for (NodeRecord& node : nodes) {
+        if (node.flags & SPEAKER_FROM_NPC) node.speaker = empty;
+        if (node.flags & TEXT_FROM_NPC) node.text = empty;
+    }
+    for (ConditionRecord& condition : conditions) {
+        if (condition.kind != ITEM) condition.item = empty;
+    }
+
+    DialogHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.npc_count = static_cast<uint32_t>(npcs.size());
+    header.node_count = static_cast<uint32_t>(nodes.size());
+    header.option_count = static_cast<uint32_t>(options.size());
+    header.condition_count = static_cast<uint32_t>(conditions.size());
+    header.default_start = defaultStart;
+    header.strings_offset = static_cast<uint32_t>(sizeof(DialogHeader) + npcs.size() * sizeof(NpcRecord) +
+                                                  nodes.size() * sizeof(NodeRecord) +
+                                                  options.size() * sizeof(OptionRecord) +
+                                                  conditions.size() * sizeof(ConditionRecord));
+    header.strings_size = static_cast<uint32_t>(strings.table().size());
+
+    out.clear();
+    out.reserve(header.strings_offset + header.strings_size);
+    const uint8_t* headerBytes = reinterpret_cast<const uint8_t*>(&header);
+    out.insert(out.end(), headerBytes, headerBytes + sizeof(header));
+    appendRecords(out, npcs);
+    appendRecords(out, nodes);
+    appendRecords(out, options);
+    appendRecords(out, conditions);
+    out.insert(out.end(), strings.table().begin(), strings.table().end());
+    return true;
+}
+
+bool writeDialogPack(const std::string& path, const std::vector<uint8_t>& image) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cout << "DIALOG PACK: Cannot write " << path << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+    return static_cast<bool>(file);
+}
+
+DialogPackReader::~DialogPackReader() {
+    close();
+}
+
+bool DialogPackReader::open(const std::string& path) {
+    close();
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            data_ = static_cast<const uint8_t*>(mapping);
+            size_ = static_cast<size_t>(st.st_size);
+            mapped_ = true;
+        }
+    }
+    ::close(fd);
+#endif
+
+    if (!data_) {
+        // No mmap (or it failed): read the whole file once instead
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+        buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+    }
+    return validate(path);
+}
+
+bool DialogPackReader::open(std::vector<uint8_t>&& image) {
+    close();
+    buffer_ = std::move(image);
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    return validate("built-in dialog");
+}
+
+// Checks every index and string once so lookups during play can skip the bounds checks
+bool DialogPackReader::validate(const std::string& sourceName) {
+    if (size_ < sizeof(DialogHeader)) {
+        std::cout << "DIALOG PACK: " << sourceName << " is too small to be a pack" << std::endl;
+        close();
+        return false;
+    }
+
+    const auto* header = reinterpret_cast<const DialogHeader*>(data_);
+    uint64_t recordsEnd = sizeof(DialogHeader) + uint64_t(header->npc_count) * sizeof(NpcRecord) +
+                          uint64_t(header->node_count) * sizeof(NodeRecord) +
+                          uint64_t(header->option_count) * sizeof(OptionRecord) +
+                          uint64_t(header->condition_count) * sizeof(ConditionRecord);
+    uint64_t stringsEnd = uint64_t(header->strings_offset) + header->strings_size;
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION ||
+        recordsEnd > size_ || header->strings_offset < recordsEnd || stringsEnd > size_) {
+        std::cout << "DIALOG PACK: " << sourceName << " has a bad header or unsupported version" << std::endl;
+        close();
+        return false;
+    }
+
+    const uint8_t* cursor = data_ + sizeof(DialogHeader);
+    const auto* npcs = reinterpret_cast<const NpcRecord*>(cursor);
+    cursor += header->npc_count * sizeof(NpcRecord);
+    const auto* nodes = reinterpret_cast<const NodeRecord*>(cursor);
+    cursor += header->node_count * sizeof(NodeRecord);
+    const auto* options = reinterpret_cast<const OptionRecord*>(cursor);
+    cursor += header->option_count * sizeof(OptionRecord);
+    const auto* conditions = reinterpret_cast<const ConditionRecord*>(cursor);
+    const char* strings = reinterpret_cast<const char*>(data_ + header->strings_offset);
+    uint32_t stringsSize = header->strings_size;
+
+    auto validNode = [&](uint32_t node, bool allowEnd) {
+        return node < header->node_count || (allowEnd && node == NO_NODE);
+    };
+
+    bool ok = validNode(header->default_start, true);
+    for (uint32_t i = 0; ok && i < header->npc_count; ++i) {
+        ok = validString(npcs[i].name, strings, stringsSize) && validNode(npcs[i].start_node, false);
+    }
+    for (uint32_t i = 0; ok && i < header->node_count; ++i) {
+        const NodeRecord& n = nodes[i];
+        ok = validString(n.speaker, strings, stringsSize) && validString(n.text, strings, stringsSize) &&
+             uint64_t(n.first_option) + n.option_count <= header->option_count;
+    }
+    for (uint32_t i = 0; ok && i < header->option_count; ++i) {
+        const OptionRecord& o = options[i];
+        ok = validString(o.label, strings, stringsSize) && validNode(o.target, true) &&
+             uint64_t(o.first_condition) + o.condition_count <= header->condition_count;
+    }
+    for (uint32_t i = 0; ok && i < header->condition_count; ++i) {
+        ok = validString(conditions[i].item, strings, stringsSize);
+    }
+    if (!ok) {
+        std::cout << "DIALOG PACK: " << sourceName << " has an out-of-range record" << std::endl;
+        close();
+        return false;
+    }
+
+    header_ = header;
+    npcs_ = npcs;
+    nodes_ = nodes;
+    options_ = options;
+    conditions_ = conditions;
+    strings_ = strings;
+    return true;
+}
+
+void DialogPackReader::close() {
+#ifndef _WIN32
+    if (mapped_) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+#endif
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    data_ = nullptr;
+    size_ = 0;
+    header_ = nullptr;
+    npcs_ = nullptr;
+    nodes_ = nullptr;
+    options_ = nullptr;
+    conditions_ = nullptr;
+    strings_ = nullptr;
+    mapped_ = false;
+}
+
+uint32_t DialogPackReader::getStartNode(std::string_view npcName) const {
+    if (!header_) return NO_NODE;
+    for (uint32_t i = 0; i < header_->npc_count; ++i) {
+        if (getString(npcs_[i].name) == npcName) return npcs_[i].start_node;
+    }
+    return header_->default_start;
+}
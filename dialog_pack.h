@@ -0,0 +1,211 @@
+#ifndef DIALOG_PACK_H
+#define DIALOG_PACK_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <istream>
+#include <cstdint>
+#include <cstddef>
+
+// ============================================================================
+// ON-DISK FORMAT (little-endian, version 1)
+//
+//   DialogHeader
+//   NpcRecord[npc_count]
+//   NodeRecord[node_count]
+//   OptionRecord[option_count]          each node's options are contiguous
+//   ConditionRecord[condition_count]    each option's conditions are contiguous
+//   string table (interned, every string NUL-terminated so views can go straight to raylib)
+// ============================================================================
+
+namespace DialogPackFormat {
+    constexpr char MAGIC[4] = {'B', 'W', 'D', 'G'};
+    constexpr uint32_t VERSION = 1;
+    constexpr uint32_t NO_NODE = 0xFFFFFFFFu;   // Option target that ends the conversation
+
+    enum NodeFlags : uint16_t {
+        SPEAKER_FROM_NPC = 1 << 0,   // `speaker = @npc`: the talking NPC's name
+        TEXT_FROM_NPC = 1 << 1       // `text = @greeting`: the talking NPC's own dialog line
+    };
+
+    enum ConditionKind : uint8_t { ITEM = 0, STAT = 1 };
+    enum ConditionOp : uint8_t { AT_LEAST = 0, BELOW = 1 };
+    enum Stat : uint8_t { LEVEL = 0, HEALTH = 1, MANA = 2, STAMINA = 3, EXPERIENCE = 4, SCORE = 5 };
+
+    struct StringRef {
+        uint32_t offset;            // Into the string table
+        uint32_t length;            // Excluding the terminator
+    };
+
+    struct DialogHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t npc_count;
+        uint32_t node_count;
+        uint32_t option_count;
+        uint32_t condition_count;
+        uint32_t default_start;     // Start node for NPCs without an entry of their own, or NO_NODE
+        uint32_t strings_offset;    // From file start
+        uint32_t strings_size;
+        uint32_t reserved;
+    };
+
+    struct NpcRecord {
+        StringRef name;
+        uint32_t start_node;
+    };
+
+    struct NodeRecord {
+        StringRef speaker;
+        StringRef text;
+        uint16_t flags;
+        uint16_t option_count;
+        uint32_t first_option;
+    };
+
+    struct OptionRecord {
+        StringRef label;
+        uint32_t target;            // Node index or NO_NODE
+        uint32_t first_condition;
+        uint16_t condition_count;   // All must hold for the option to be offered
+        uint16_t reserved;
+    };
+
+    struct ConditionRecord {
+        uint8_t kind;
+        uint8_t op;
+        uint8_t stat;               // STAT conditions only
+        uint8_t reserved;
+        int32_t value;
+        StringRef item;             // ITEM conditions only
+    };
+
+    static_assert(sizeof(DialogHeader) == 40, "DialogHeader layout is part of the file format");
+    static_assert(sizeof(NpcRecord) == 12, "NpcRecord layout is part of the file format");
+    static_assert(sizeof(NodeRecord) == 24, "NodeRecord layout is part of the file format");
+    static_assert(sizeof(OptionRecord) == 20, "OptionRecord layout is part of the file format");
+    static_assert(sizeof(ConditionRecord) == 16, "ConditionRecord layout is part of the file format");
+}
+
+/// \brief A dialog graph as written in its text form, with node ids still symbolic.
+struct DialogSource {
+    struct Condition {
+        DialogPackFormat::ConditionKind kind = DialogPackFormat::STAT;
+        DialogPackFormat::ConditionOp op = DialogPackFormat::AT_LEAST;
+        DialogPackFormat::Stat stat = DialogPackFormat::LEVEL;
+        int value = 0;
+        std::string item;
+    };
+
+    struct Option {
+        std::string label;
+        std::string target;         // Node id, or "end"
+        std::vector<Condition> conditions;
+    };
+
+    struct Node {
+        std::string id;
+        std::string speaker;
+        std::string text;
+        std::vector<Option> options;
+    };
+
+    struct NpcEntry {
+        std::string name;           // "*" for everyone without an entry of their own
+        std::string start;
+    };
+
+    std::vector<NpcEntry> npcs;
+    std::vector<Node> nodes;
+};
+
+/// \brief Parses the text dialog format.
+///
+///     [npc Mayor White]
+///     start = mayor_greeting
+///
+///     [node mayor_greeting]
+///     speaker = Mayor White
+///     text = Greetings, citizen!
+///     option = Ask about town affairs -> mayor_affairs
+///     require = level >= 2
+///     option = Goodbye -> end
+///
+/// `require` lines gate the option above them: `<stat> >= N`, `<stat> < N`, or
+/// `item <name> >= N`, with stats level, health, mana, stamina, experience and score.
+/// \param in Input stream.
+/// \param sourceName Name used in error messages.
+/// \param out Parsed npcs and nodes are appended here, so several files can share one graph.
+/// \return False on a malformed line.
+bool parseDialogText(std::istream& in, const std::string& sourceName, DialogSource& out);
+
+/// \brief Resolves node ids and interns strings into a pack image.
+/// \param source Parsed graph.
+/// \param out Receives the image; previous contents are replaced.
+/// \return False if an id is duplicated or a target or start node doesn't exist.
+bool compileDialogPack(const DialogSource& source, std::vector<uint8_t>& out);
+
+/// \brief Writes a compiled image to disk.
+/// \param path Output file.
+/// \param image Image from compileDialogPack.
+/// \return True on success.
+bool writeDialogPack(const std::string& path, const std::vector<uint8_t>& image);
+
+/// \brief Read-only view of a compiled dialog graph, memory-mapped where the platform allows.
+///
+/// Nothing is decoded up front: records are read in place and strings come back as views
+/// into the table, so the graph costs its file size and nothing more. Views live as long
+/// as the reader.
+class DialogPackReader {
+public:
+    DialogPackReader() = default;
+    ~DialogPackReader();
+    DialogPackReader(const DialogPackReader&) = delete;
+    DialogPackReader& operator=(const DialogPackReader&) = delete;
+
+    /// \brief Maps and validates a pack file.
+    /// \param path Pack file.
+    /// \return False if missing, truncated, or the wrong version.
+    bool open(const std::string& path);
+
+    /// \brief Adopts an image compiled in memory.
+    /// \param image Image from compileDialogPack.
+    /// \return False if the image fails the same checks as a file.
+    bool open(std::vector<uint8_t>&& image);
+
+    /// \brief Unmaps the file or frees the image.
+    void close();
+
+    bool isOpen() const { return header_ != nullptr; }
+    uint32_t getNodeCount() const { return header_ ? header_->node_count : 0; }
+
+    /// \brief Gets the node a conversation with this NPC starts at.
+    /// \return The NPC's own start node, else the default, else NO_NODE.
+    uint32_t getStartNode(std::string_view npcName) const;
+
+    const DialogPackFormat::NodeRecord& getNode(uint32_t index) const { return nodes_[index]; }
+    const DialogPackFormat::OptionRecord& getOption(uint32_t index) const { return options_[index]; }
+    const DialogPackFormat::ConditionRecord& getCondition(uint32_t index) const { return conditions_[index]; }
+
+    /// \brief Gets a string from the table; the view is NUL-terminated.
+    std::string_view getString(DialogPackFormat::StringRef ref) const {
+        return std::string_view(strings_ + ref.offset, ref.length);
+    }
+
+private:
+    bool validate(const std::string& sourceName);
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    const DialogPackFormat::DialogHeader* header_ = nullptr;
+    const DialogPackFormat::NpcRecord* npcs_ = nullptr;
+    const DialogPackFormat::NodeRecord* nodes_ = nullptr;
+    const DialogPackFormat::OptionRecord* options_ = nullptr;
+    const DialogPackFormat::ConditionRecord* conditions_ = nullptr;
+    const char* strings_ = nullptr;
+    bool mapped_ = false;                 // False when the buffer below holds the pack
+    std::vector<uint8_t> buffer_;
+};
+
+#endif
@@ -0,0 +1,42 @@
+// dialog_packer.cpp - Offline tool: compiles text dialog graphs into a binary dialog pack
+#include "dialog_pack.h"
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cout << "Usage: " << argv[0] << " <output.bwdg> <dialog.txt>..." << std::endl;
+        std::cout << "  Inputs use '[npc name]' and '[node id]' sections; all files form one graph." << std::endl;
+        return 1;
+    }
+
+    DialogSource source;
+    for (int i = 2; i < argc; ++i) {
+        std::ifstream in(argv[i]);
+        if (!in) {
+            std::cout << "DIALOG PACKER: Cannot open " << argv[i] << std::endl;
+            return 1;
+        }
+        size_t before = source.nodes.size();
+        if (!parseDialogText(in, argv[i], source)) {
+            return 1;
+        }
+        std::cout << "DIALOG PACKER: " << argv[i] << ": " << (source.nodes.size() - before) << " nodes" << std::endl;
+    }
+
+    std::vector<uint8_t> image;
+    if (!compileDialogPack(source, image) || !writeDialogPack(argv[1], image)) {
+        return 1;
+    }
+
+    // Read back through the runtime path so a bad pack never ships
+    DialogPackReader reader;
+    if (!reader.open(argv[1]) || reader.getNodeCount() != source.nodes.size()) {
+        std::cout << "DIALOG PACKER: Verification of " << argv[1] << " failed" << std::endl;
+        return 1;
+    }
+    std::cout << "DIALOG PACKER: Wrote " << source.nodes.size() << " nodes (" << image.size()
+              << " bytes) to " << argv[1] << std::endl;
+    return 0;
+}
@@ -1,71 +1,215 @@
 // dialog_system.cpp
 #include "dialog_system.h"
+#include "npc.h"
+#include <iostream>
+#include <sstream>
 
-void startDialog(int npcIndex, GameState& state) {
-    state.isInDialog = true;
-    state.currentNPC = npcIndex;
-    state.showDialogWindow = true;
+using namespace DialogPackFormat;
 
-    if (!state.mouseReleased) {
-        EnableCursor();
+namespace {
+
+// Compiled at startup when no dialog pack is installed; also the reference for the text format
+const char* const BUILTIN_DIALOG = R"(
+[npc Mayor White]
+start = mayor_greeting
+
+[npc Buster Shoppin]
+start = shop_greeting
+
+[npc *]
+start = townsfolk_greeting
+
+[node mayor_greeting]
+speaker = Mayor White
+text = Greetings, citizen! Welcome to my office. What brings you here today?
+option = Ask about town affairs -> mayor_affairs
+option = Request town assistance -> mayor_assistance
+option = Goodbye -> end
+
+[node mayor_affairs]
+speaker = Mayor White
+text = Town affairs are going well! We're always looking for capable adventurers to help with local issues.
+option = Continue talking -> mayor_affairs
+option = Ask another question -> mayor_assistance
+option = Goodbye -> end
+
+[node mayor_assistance]
+speaker = Mayor White
+text = What kind of assistance do you need? I can provide information or direct you to the right people.
+option = Continue talking -> mayor_affairs
+option = Ask another question -> mayor_assistance
+option = Goodbye -> end
+
+[node shop_greeting]
+speaker = Buster Shoppin
+text = Welcome to my shop! I've got all sorts of goods and supplies for sale.
+option = Browse general supplies -> shop_supplies
+option = Ask about special items -> shop_special
+option = Goodbye -> end
+
+[node shop_supplies]
+speaker = Buster Shoppin
+text = I have food, water, rope, torches, and basic adventuring supplies. What catches your eye?
+option = Continue talking -> shop_supplies
+option = Ask another question -> shop_special
+option = Goodbye -> end
+
+[node shop_special]
+speaker = Buster Shoppin
+text = I sometimes get rare items from traveling merchants. Check back later for special deals!
+option = Continue talking -> shop_supplies
+option = Ask another question -> shop_special
+option = Goodbye -> end
+
+[node townsfolk_greeting]
+speaker = @npc
+text = @greeting
+option = Goodbye -> end
+)";
+
+int statValue(Stat stat, const GameState& state) {
+    switch (stat) {
+        case LEVEL: return state.player.level;
+        case HEALTH: return state.player.health;
+        case MANA: return state.player.mana;
+        case STAMINA: return state.player.stamina;
+        case EXPERIENCE: return state.player.experience;
+        case SCORE: return state.combat.score;
+    }
+    return 0;
+}
+
+}  // namespace
+
+bool DialogSystem::load(const std::string& packPath) {
+    loaded_ = true;
+    invalidate();
+    if (graph_.open(packPath)) {
+        std::cout << "DIALOG: Loaded " << graph_.getNodeCount() << " nodes from " << packPath << std::endl;
+        return true;
     }
 
-    switch (npcIndex) {
-        case 0:
-            state.dialogText = "Mayor White: \"Greetings, citizen! Welcome to my office. What brings you here today?\"";
-            state.dialogOptions[0] = "Ask about town affairs";
-            state.dialogOptions[1] = "Request town assistance";
-            state.dialogOptions[2] = "Goodbye";
-            state.numDialogOptions = 3;
-            break;
-        case 1:
-            state.dialogText = "Buster Shoppin: \"Welcome to my shop! I've got all sorts of goods and supplies for sale.\"";
-            state.dialogOptions[0] = "Browse general supplies";
-            state.dialogOptions[1] = "Ask about special items";
-            state.dialogOptions[2] = "Goodbye";
-            state.numDialogOptions = 3;
-            break;
+    std::istringstream in(BUILTIN_DIALOG);
+    DialogSource source;
+    std::vector<uint8_t> image;
+    if (!parseDialogText(in, "built-in dialog", source) || !compileDialogPack(source, image) ||
+        !graph_.open(std::move(image))) {
+        std::cout << "DIALOG: Built-in dialog failed to compile; NPCs will not talk" << std::endl;
+        return false;
     }
+    std::cout << "DIALOG: Using built-in dialog (" << graph_.getNodeCount() << " nodes)" << std::endl;
+    return true;
 }
 
-void handleDialogOption(int optionIndex, GameState& state) {
-    if (state.currentNPC == -1) return;
-
-    switch (state.currentNPC) {
-        case 0:
-            if (optionIndex == 0) {
-                state.dialogText = "Mayor White: \"Town affairs are going well! We're always looking for capable adventurers to help with local issues.\"";
-            } else if (optionIndex == 1) {
-                state.dialogText = "Mayor White: \"What kind of assistance do you need? I can provide information or direct you to the right people.\"";
-            } else {
-                state.dialogText = "Mayor White: \"Thank you for visiting. Please come back if you need anything else.\"";
-                state.isInDialog = false;
-                state.showDialogWindow = false;
-                if (!state.mouseReleased) {
-                    DisableCursor();
-                }
-            }
-            break;
-        case 1:
-            if (optionIndex == 0) {
-                state.dialogText = "Buster Shoppin: \"I have food, water, rope, torches, and basic adventuring supplies. What catches your eye?\"";
-            } else if (optionIndex == 1) {
-                state.dialogText = "Buster Shoppin: \"I sometimes get rare items from traveling merchants. Check back later for special deals!\"";
-            } else {
-                state.dialogText = "Buster Shoppin: \"Thanks for shopping! Come back anytime you need supplies.\"";
-                state.isInDialog = false;
-                state.showDialogWindow = false;
-                if (!state.mouseReleased) {
-                    DisableCursor();
-                }
+void DialogSystem::ensureLoaded() {
+    if (!loaded_) load(DialogConstants::PACK_PATH);
+}
+
+uint32_t DialogSystem::getStartNode(int npcIndex) {
+    ensureLoaded();
+    const NPCSystem& npcs = NPCSystem::getInstance();
+    if (!npcs.isValid(npcIndex)) return NO_NODE;
+    return graph_.getStartNode(npcs.getName(npcIndex));
+}
+
+const DialogView& DialogSystem::getView(const GameState& state) {
+    ensureLoaded();
+    uint32_t node = state.dialog.active && state.dialog.node >= 0 ? static_cast<uint32_t>(state.dialog.node) : NO_NODE;
+    if (node != view_.node || state.dialog.npc != view_.npc) {
+        buildView(node, state);
+    }
+    return view_;
+}
+
+bool DialogSystem::conditionsHold(const OptionRecord& option, const GameState& state) const {
+    for (uint32_t c = 0; c < option.condition_count; ++c) {
+        const ConditionRecord& condition = graph_.getCondition(option.first_condition + c);
+        int value = 0;
+        if (condition.kind == ITEM) {
+            if (state.inventorySystem) {
+                value = state.inventorySystem->getInventory().getItemQuantity(std::string(graph_.getString(condition.item)));
             }
-            break;
+        } else {
+            value = statValue(static_cast<Stat>(condition.stat), state);
+        }
+        bool holds = condition.op == AT_LEAST ? value >= condition.value : value < condition.value;
+        if (!holds) return false;
+    }
+    return true;
+}
+
+void DialogSystem::buildView(uint32_t node, const GameState& state) {
+    view_.node = NO_NODE;
+    view_.npc = state.dialog.npc;
+    view_.text.clear();
+    view_.optionCount = 0;
+    if (node >= graph_.getNodeCount()) return;
+
+    const NPCSystem& npcs = NPCSystem::getInstance();
+    bool haveNpc = npcs.isValid(state.dialog.npc);
+    const NodeRecord& record = graph_.getNode(node);
+    std::string_view speaker = graph_.getString(record.speaker);
+    std::string_view text = graph_.getString(record.text);
+    if ((record.flags & SPEAKER_FROM_NPC) && haveNpc) speaker = npcs.getName(state.dialog.npc);
+    if ((record.flags & TEXT_FROM_NPC) && haveNpc) text = npcs.getDialog(state.dialog.npc);
+
+    if (!speaker.empty()) {
+        view_.text.append(speaker).append(": \"").append(text).append("\"");
+    } else {
+        view_.text.append(text);
+    }
+
+    for (uint32_t i = 0; i < record.option_count && view_.optionCount < DialogConstants::MAX_VISIBLE_OPTIONS; ++i) {
+        const OptionRecord& option = graph_.getOption(record.first_option + i);
+        if (!conditionsHold(option, state)) continue;
+        view_.options[view_.optionCount] = graph_.getString(option.label);
+        view_.targets[view_.optionCount] = option.target;
+        view_.optionCount++;
+    }
+    view_.node = node;
+}
+
+void startDialog(int npcIndex, GameState& state) {
+    DialogSystem& dialog = DialogSystem::getInstance();
+    uint32_t start = dialog.getStartNode(npcIndex);
+    if (start == NO_NODE) return;
+
+    state.dialog.active = true;
+    state.dialog.npc = npcIndex;
+    state.dialog.node = static_cast<int>(start);
+    state.dialog.showWindow = true;
+    dialog.invalidate();
+
+    if (!state.ui.mouseReleased) {
+        EnableCursor();
+    }
+}
+
+void handleDialogOption(int optionIndex, GameState& state) {
+    if (state.dialog.npc == -1) return;
+
+    DialogSystem& dialog = DialogSystem::getInstance();
+    const DialogView& view = dialog.getView(state);
+    if (!view.isOpen()) {
+        endDialog(state);
+        return;
+    }
+    if (optionIndex < 0 || optionIndex >= view.optionCount) return;
+
+    uint32_t target = view.targets[optionIndex];
+    if (target == NO_NODE) {
+        endDialog(state);
+        return;
     }
+    state.dialog.node = static_cast<int>(target);
+    dialog.invalidate();  // Re-entering the same node re-checks its conditions
+}
 
-    if (state.isInDialog) {
-        state.dialogOptions[0] = "Continue talking";
-        state.dialogOptions[1] = "Ask another question";
-        state.dialogOptions[2] = "Goodbye";
-        state.numDialogOptions = 3;
+void endDialog(GameState& state) {
+    state.dialog.active = false;
+    state.dialog.showWindow = false;
+    state.dialog.node = -1;
+    if (!state.ui.mouseReleased) {
+        DisableCursor();
     }
-}
\ No newline at end of file
+}
@@ -3,8 +3,68 @@
 #define DIALOG_SYSTEM_H
 
 #include "game_state.h"
+#include "dialog_pack.h"
+#include "constants.h"
+#include <string>
+#include <string_view>
+
+/// \brief What the dialog window shows for the current node, resolved once when the node changes.
+struct DialogView {
+    uint32_t node = DialogPackFormat::NO_NODE;
+    int npc = -1;
+    std::string text;                                                  // `Speaker: "line"`, ready to draw
+    int optionCount = 0;                                               // Options whose conditions held on entry
+    std::string_view options[DialogConstants::MAX_VISIBLE_OPTIONS];    // NUL-terminated views into the pack
+    uint32_t targets[DialogConstants::MAX_VISIBLE_OPTIONS] = {};
+
+    bool isOpen() const { return node != DialogPackFormat::NO_NODE; }
+};
+
+/// \brief Owns the compiled dialog graph and the view of the node being shown.
+///
+/// GameState only records which node the conversation is at; text and labels stay in the
+/// pack. Option conditions are evaluated and the display text composed when the node
+/// changes, so drawing a conversation does no lookups or string building per frame.
+class DialogSystem {
+public:
+    static DialogSystem& getInstance() {
+        static DialogSystem instance;
+        return instance;
+    }
+
+    /// \brief Loads a dialog pack, falling back to the built-in graph if it's missing or bad.
+    /// \param packPath Pack built by `make dialog`.
+    /// \return True if a graph is available.
+    bool load(const std::string& packPath);
+
+    /// \brief Gets the start node for an NPC, or NO_NODE if the graph has none for them.
+    uint32_t getStartNode(int npcIndex);
+
+    /// \brief Gets the view for the state's current node, rebuilding it if the node changed.
+    /// Invalid nodes (say, from a save made with another graph) give a closed view.
+    const DialogView& getView(const GameState& state);
+
+    /// \brief Forces the next getView to re-evaluate conditions, even on the same node.
+    void invalidate() { view_.node = DialogPackFormat::NO_NODE; view_.npc = -1; }
+
+    const DialogPackReader& getGraph() const { return graph_; }
+
+private:
+    DialogSystem() = default;
+    DialogSystem(const DialogSystem&) = delete;
+    DialogSystem& operator=(const DialogSystem&) = delete;
+
+    void ensureLoaded();
+    bool conditionsHold(const DialogPackFormat::OptionRecord& option, const GameState& state) const;
+    void buildView(uint32_t node, const GameState& state);
+
+    DialogPackReader graph_;
+    DialogView view_;
+    bool loaded_ = false;
+};
 
 void startDialog(int npcIndex, GameState& state);
 void handleDialogOption(int optionIndex, GameState& state);
+void endDialog(GameState& state);
 
-#endif
\ No newline at end of file
+#endif
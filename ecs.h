@@ -0,0 +1,205 @@
+#ifndef ECS_H
+#define ECS_H
+
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <tuple>
+#include <utility>
+
+namespace ecs {
+
+using ComponentTypeId = uint32_t;
+
+namespace detail {
+    inline ComponentTypeId nextTypeId() {
+        static std::atomic<ComponentTypeId> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/// \brief Dense id for a component type, assigned on first use and fixed for the run.
+/// Lookups index arrays by this id; no names are hashed at runtime.
+template<typename T>
+inline ComponentTypeId typeId() {
+    static const ComponentTypeId id = detail::nextTypeId();
+    return id;
+}
+
+/// \brief Entity handle: slot index plus generation so destroyed ids are never mistaken for live ones.
+struct Entity {
+    uint32_t index = std::numeric_limits<uint32_t>::max();
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != std::numeric_limits<uint32_t>::max(); }
+    bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Entity& other) const { return !(*this == other); }
+};
+
+/// \brief Type-erased part of a component pool, so the registry can strip destroyed entities.
+class PoolBase {
+public:
+    virtual ~PoolBase() = default;
+    virtual void remove(Entity entity) = 0;
+    virtual bool contains(Entity entity) const = 0;
+    virtual size_t size() const = 0;
+};
+
+/// \brief Sparse set: components packed contiguously, with an entity-index -> dense-slot table.
+///
+/// Iteration walks the dense arrays in order; removal swaps the last element into the hole,
+/// so order is not stable but storage never has gaps.
+template<typename T>
+class SparseSet : public PoolBase {
+public:
+    template<typename... Args>
+    T& emplace(Entity entity, Args&&... args) {
+        if (contains(entity)) {
+            return components_[sparse_[entity.index]] = T{std::forward<Args>(args)...};
+        }
+        if (entity.index >= sparse_.size()) {
+            sparse_.resize(entity.index + 1, NONE);
+        }
+        sparse_[entity.index] = static_cast<uint32_t>(dense_.size());
+        dense_.push_back(entity);
+        components_.push_back(T{std::forward<Args>(args)...});
+        return components_.back();
+    }
+
+    void remove(Entity entity) override {
+        if (!contains(entity)) return;
+        uint32_t slot = sparse_[entity.index];
+        uint32_t last = static_cast<uint32_t>(dense_.size() - 1);
+        if (slot != last) {
+            dense_[slot] = dense_[last];
+            components_[slot] = std::move(components_[last]);
+            sparse_[dense_[slot].index] = slot;
+        }
+        dense_.pop_back();
+        components_.pop_back();
+        sparse_[entity.index] = NONE;
+    }
+
+    bool contains(Entity entity) const override {
+        return entity.index < sparse_.size() && sparse_[entity.index] != NONE &&
+               dense_[sparse_[entity.index]] == entity;
+    }
+
+    size_t size() const override { return dense_.size(); }
+
+    T& get(Entity entity) { return components_[sparse_[entity.index]]; }
+    const T& get(Entity entity) const { return components_[sparse_[entity.index]]; }
+
+    T* tryGet(Entity entity) { return contains(entity) ? &components_[sparse_[entity.index]] : nullptr; }
+
+    /// \brief Packed entities, parallel to components().
+    const std::vector<Entity>& entities() const { return dense_; }
+    std::vector<T>& components() { return components_; }
+    const std::vector<T>& components() const { return components_; }
+
+private:
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> sparse_;
+    std::vector<Entity> dense_;
+    std::vector<T> components_;
+};
+
+/// \brief Owns entities and one SparseSet per component type.
+class Registry {
+public:
+    /// \brief Creates an entity, reusing a destroyed slot if one is free.
+    Entity create() {
+        if (!free_.empty()) {
+            uint32_t index = free_.back();
+            free_.pop_back();
+            return {index, generations_[index]};
+        }
+        generations_.push_back(0);
+        return {static_cast<uint32_t>(generations_.size() - 1), 0};
+    }
+
+    /// \brief Destroys an entity and all its components. Stale handles are ignored.
+    void destroy(Entity entity) {
+        if (!isAlive(entity)) return;
+        for (auto& pool : pools_) {
+            if (pool) pool->remove(entity);
+        }
+        ++generations_[entity.index];
+        free_.push_back(entity.index);
+    }
+
+    bool isAlive(Entity entity) const {
+        return entity.index < generations_.size() && generations_[entity.index] == entity.generation;
+    }
+
+    /// \brief Gets number of live entities.
+    size_t size() const { return generations_.size() - free_.size(); }
+
+    template<typename T, typename... Args>
+    T& emplace(Entity entity, Args&&... args) {
+        return pool<T>().emplace(entity, std::forward<Args>(args)...);
+    }
+
+    template<typename T>
+    void remove(Entity entity) { pool<T>().remove(entity); }
+
+    template<typename T>
+    bool has(Entity entity) const {
+        const PoolBase* p = findPool(typeId<T>());
+        return p && p->contains(entity);
+    }
+
+    /// \brief Gets a component the entity is known to have.
+    template<typename T>
+    T& get(Entity entity) { return pool<T>().get(entity); }
+
+    /// \brief Gets a component, or nullptr if the entity lacks it.
+    template<typename T>
+    T* tryGet(Entity entity) { return pool<T>().tryGet(entity); }
+
+    /// \brief Gets (creating on first use) the pool for a component type.
+    template<typename T>
+    SparseSet<T>& pool() {
+        ComponentTypeId id = typeId<T>();
+        if (id >= pools_.size()) {
+            pools_.resize(id + 1);
+        }
+        if (!pools_[id]) {
+            pools_[id] = std::make_unique<SparseSet<T>>();
+        }
+        return static_cast<SparseSet<T>&>(*pools_[id]);
+    }
+
+    /// \brief Calls fn(entity, First&, Rest&...) for every entity that has all listed components.
+    /// Walks the first type's packed arrays, so list the rarest component first.
+    template<typename First, typename... Rest, typename Fn>
+    void each(Fn&& fn) {
+        SparseSet<First>& lead = pool<First>();
+        auto others = std::tuple<SparseSet<Rest>&...>(pool<Rest>()...);
+        const std::vector<Entity>& entities = lead.entities();
+        std::vector<First>& components = lead.components();
+        // Index loop: fn may add components of other types, which never reallocates `lead`
+        for (size_t i = 0; i < entities.size(); ++i) {
+            Entity entity = entities[i];
+            bool hasAll = std::apply([entity](auto&... set) { return (set.contains(entity) && ...); }, others);
+            if (!hasAll) continue;
+            std::apply([&](auto&... set) { fn(entity, components[i], set.get(entity)...); }, others);
+        }
+    }
+
+private:
+    std::vector<uint32_t> generations_;
+    std::vector<uint32_t> free_;
+    std::vector<std::unique_ptr<PoolBase>> pools_;  // Indexed by ComponentTypeId
+
+    const PoolBase* findPool(ComponentTypeId id) const {
+        return id < pools_.size() ? pools_[id].get() : nullptr;
+    }
+};
+
+}  // namespace ecs
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef ECS_COMPONENTS_H
+#define ECS_COMPONENTS_H
+
+#include "raylib.h"
+
+// Plain-data components stored in ecs::Registry pools. Keep them small and trivially
+// copyable: systems iterate them as packed arrays.
+
+/// \brief World-space position.
+struct TransformComponent {
+    Vector3 position = {0.0f, 0.0f, 0.0f};
+};
+
+/// \brief Linear velocity in units per second.
+struct VelocityComponent {
+    Vector3 velocity = {0.0f, 0.0f, 0.0f};
+};
+
+/// \brief Marks the entity driven by the camera/player controller.
+struct PlayerTag {};
+
+#endif
@@ -1,80 +1,255 @@
 #include "environment_manager.h"
 #include "math_utils.h"
 #include "raylib.h"
+#include "constants.h"
+#include "world_pack.h"
+#include "job_system.h"
+#include "profiler.h"
+#include "async_log.h"
+#include "memory_tracker.h"
+#include <algorithm>
 #include <cmath>
 #include <iostream>  // For error logging
+#include <fstream>
+#include <chrono>
+#include <unordered_set>
 
 void EnvironmentManager::addObject(std::shared_ptr<EnvironmentalObject> obj) {
+    MemoryTagScope memoryTag(MemoryTag::ENVIRONMENT);
+    uint32_t index = static_cast<uint32_t>(objects_.size());
     objects_.push_back(obj);
+    ++revision_;
+
+    // Resolve the exclusion id once instead of casting on every collision test
+    const Building* building = objectCast<Building>(obj.get());
+    exclude_ids_.push_back(building ? building->getId() : static_cast<int>(index));
+    registerTyped(*obj);
 
     // Initialize spatial grid if not already done
     if (spatial_grid_.isEmpty()) {
         spatial_grid_.rebuild();
     }
 
-    // Insert object into spatial grid if collidable
-    if (obj->collidable) {
-        spatial_grid_.insert(obj);
+    refreshCachedBounds(index);
+
+    // Every object is indexed: collision queries filter on collidable, render culling needs the rest
+    spatial_grid_.insert(*obj, index);
+
+    BW_LOG(DEBUG_ENVIRONMENT, DEBUG_DETAILED, "Added object: {} at ({}, {}, {}), collidable: {}",
+           obj->getName(), obj->position.x, obj->position.y, obj->position.z, obj->collidable);
+}
+
+size_t EnvironmentManager::removeObjects(const std::vector<std::shared_ptr<EnvironmentalObject>>& objs) {
+    MemoryTagScope memoryTag(MemoryTag::ENVIRONMENT);
+    if (objs.empty() || objects_.empty()) return 0;
+
+    std::unordered_set<const EnvironmentalObject*> doomed;
+    doomed.reserve(objs.size());
+    for (const auto& obj : objs) {
+        doomed.insert(obj.get());
     }
 
-    std::cout << "Added object: " << obj->getName() << " at (" << obj->position.x << ", " << obj->position.y << ", " << obj->position.z << "), collidable: " << obj->collidable << std::endl;
+    // Compact in place and record where each survivor went
+    std::vector<uint32_t> remap(objects_.size(), SpatialGrid::INVALID_INDEX);
+    uint32_t write = 0;
+    for (uint32_t read = 0; read < objects_.size(); ++read) {
+        if (doomed.count(objects_[read].get())) continue;
+        remap[read] = write;
+        if (write != read) {
+            objects_[write] = std::move(objects_[read]);
+            render_bounds_[write] = render_bounds_[read];
+            // Non-building exclusion ids are the index itself, so they move with it
+            const Building* building = objectCast<Building>(objects_[write].get());
+            exclude_ids_[write] = building ? building->getId() : static_cast<int>(write);
+            collider_cache_.update(write, *objects_[write]);
+        }
+        ++write;
+    }
+
+    size_t removed = objects_.size() - write;
+    if (removed == 0) return 0;
+
+    objects_.resize(write);
+    ++revision_;
+    buildings_by_id_.clear();
+    buildings_.clear();
+    trees_.clear();
+    wells_.clear();
+    for (const auto& obj : objects_) {
+        registerTyped(*obj);
+    }
+    exclude_ids_.resize(write);
+    render_bounds_.resize(write);
+    collider_cache_.truncate(write);
+    spatial_grid_.remapIndices(remap);
+
+    size_t kept = 0;
+    for (const NearbyInteractable& nearby : nearby_) {
+        if (remap[nearby.index] == SpatialGrid::INVALID_INDEX) continue;
+        nearby_[kept] = nearby;
+        nearby_[kept++].index = remap[nearby.index];
+    }
+    nearby_.resize(kept);
+    return removed;
+}
+
+void EnvironmentManager::registerTyped(EnvironmentalObject& obj) {
+    switch (obj.getKind()) {
+        case ObjectKind::BUILDING: {
+            Building* building = static_cast<Building*>(&obj);
+            buildings_.push_back(building);
+            int id = building->getId();
+            if (id < 0) break;
+            if (static_cast<size_t>(id) >= buildings_by_id_.size()) {
+                buildings_by_id_.resize(id + 1, nullptr);
+            }
+            if (buildings_by_id_[id]) {
+                std::cout << "ENVIRONMENT: Duplicate building id " << id << ", keeping " << buildings_by_id_[id]->getName() << std::endl;
+            } else {
+                buildings_by_id_[id] = building;
+            }
+            break;
+        }
+        case ObjectKind::TREE:
+            trees_.push_back(static_cast<Tree*>(&obj));
+            break;
+        case ObjectKind::WELL:
+            wells_.push_back(static_cast<Well*>(&obj));
+            break;
+        default:
+            break;
+    }
 }
 
 void EnvironmentManager::rebuildSpatialGrid() {
+    MemoryTagScope memoryTag(MemoryTag::ENVIRONMENT);
     std::cout << "ENVIRONMENT: Rebuilding spatial grid with " << objects_.size() << " objects" << std::endl;
     spatial_grid_.rebuildWithObjects(objects_);
+    for (size_t i = 0; i < objects_.size(); ++i) {
+        refreshCachedBounds(static_cast<uint32_t>(i));
+    }
+}
+
+void EnvironmentManager::refreshCachedBounds(uint32_t index) {
+    collider_cache_.update(index, *objects_[index]);
+    if (index >= render_bounds_.size()) {
+        render_bounds_.resize(index + 1);
+    }
+    render_bounds_[index] = objects_[index]->getRenderBounds();
 }
 
 void EnvironmentManager::update(float deltaTime, const Camera3D& camera) {
-    for (auto& obj : objects_) {
-        obj->update(deltaTime);
+    MemoryTagScope memoryTag(MemoryTag::ENVIRONMENT);
+    PROFILE_SCOPE("EnvironmentManager::update");
+    JobSystem& jobs = JobSystem::getInstance();
+    size_t count = objects_.size();
+
+    // Objects only touch their own components, so updates fan out; grid edits stay serial
+    stale_flags_.assign(count, 0);
+    jobs.parallelFor(count, EnvironmentConstants::UPDATE_JOB_GRAIN, [this, deltaTime](size_t begin, size_t end) {
+        PROFILE_SCOPE("Object updates");
+        for (size_t i = begin; i < end; ++i) {
+            objects_[i]->update(deltaTime);
+            stale_flags_[i] = collider_cache_.isStale(static_cast<uint32_t>(i), *objects_[i]) ? 1 : 0;
+        }
+    });
+
+    // Static props never take this branch; movers re-snapshot and re-bucket
+    for (size_t i = 0; i < count; ++i) {
+        if (!stale_flags_[i]) continue;
+        uint32_t index = static_cast<uint32_t>(i);
+        refreshCachedBounds(index);
+        spatial_grid_.remove(index);
+        spatial_grid_.insert(*objects_[i], index);
     }
-    lod_manager_.updateLODLevels(camera, objects_);
+
+    jobs.parallelFor(count, EnvironmentConstants::UPDATE_JOB_GRAIN, [this, &camera](size_t begin, size_t end) {
+        PROFILE_SCOPE("LOD selection");
+        lod_manager_.updateLODLevels(camera, objects_, render_bounds_, begin, end, lod_distance_, cull_distance_);
+    });
     async_loader_.processCompletedLoads(this);
 }
 
-void EnvironmentManager::renderAll(const Camera3D& camera) {
-    for (auto& obj : objects_) {
-        obj->render(camera);
+void EnvironmentManager::renderAll(const Camera3D& camera, const Frustum* portal) {
+    submitVisible(camera, portal);
+
+    // Sorted by mesh + colour; repeated props go out as instanced draws
+    render_queue_.flush();
+}
+
+void EnvironmentManager::submitVisible(const Camera3D& camera, const Frustum* portal) {
+    float aspect = GetScreenHeight() > 0 ? static_cast<float>(GetScreenWidth()) / GetScreenHeight() : 1.0f;
+    Frustum frustum = Frustum::fromCamera(camera, aspect, RenderConstants::CAMERA_NEAR_PLANE, cull_distance_);
+
+    // Grid narrows to cells overlapping the frustum's AABB (the portal's, which is clamped to
+    // it, when there is one); the plane tests trim the rest
+    last_rendered_count_ = 0;
+    if (portal && portal->isEmpty()) return;
+    spatial_grid_.query(portal ? portal->bounds : frustum.bounds, render_scratch_);
+    for (uint32_t index : render_scratch_) {
+        auto& obj = objects_[index];
+        if (obj->getLOD() == DetailLevel::CULLED) continue;
+        if (!frustum.intersects(render_bounds_[index])) continue;
+        if (portal && !portal->intersects(render_bounds_[index])) continue;
+        obj->submit(render_queue_, camera);
+        ++last_rendered_count_;
     }
 }
 
+void EnvironmentManager::setDrawDistances(float lodDistance, float cullDistance) {
+    lod_distance_ = lodDistance;
+    cull_distance_ = std::max(cullDistance, RenderConstants::CAMERA_NEAR_PLANE);
+}
+
+void EnvironmentManager::renderImmediate(EnvironmentalObject& object, const Camera3D& camera) {
+    object.submit(immediate_queue_, camera);
+    immediate_queue_.flush();
+}
+
+void EnvironmentManager::unloadRenderResources() {
+    render_queue_.unload();
+    immediate_queue_.unload();
+}
+
 bool EnvironmentManager::checkCollision(const CollisionBounds& bounds, int excludeIndex) const {
     // Use spatial query for candidates
-    BoundingBox queryBox = CollisionSystem::boundsToBox(bounds);
-    auto candidates = spatial_grid_.query(queryBox);
-    
-    for (const auto& obj : candidates) {
-        if (obj->collidable) {
-            // Check exclusion
-            bool shouldExclude = false;
-            if (excludeIndex != -1) {
-                if (auto building = std::dynamic_pointer_cast<Building>(obj)) {
-                    if (building->getId() == excludeIndex) {
-                        shouldExclude = true;
-                    }
-                } else {
-                    // Fallback to index
-                    auto it = std::find(objects_.begin(), objects_.end(), obj);
-                    if (it != objects_.end()) {
-                        size_t idx = std::distance(objects_.begin(), it);
-                        if (static_cast<int>(idx) == excludeIndex) {
-                            shouldExclude = true;
-                        }
-                    }
-                }
-            }
-
-            if (!shouldExclude) {
-                auto objBounds = obj->getCollisionBounds();
-                if (CollisionSystem::checkCollision(bounds, objBounds)) {
-                    std::cout << "Collision detected with " << obj->getName() << std::endl;
-                    return true;
-                }
+    BoundingBox queryBox = CollisionSystem::enclosingBox(bounds);
+    collectColliders(queryBox, excludeIndex, query_scratch_);
+    size_t count = query_scratch_.size();
+
+    int hit = -1;
+    if (bounds.shape == CollisionShape::CAPSULE) {
+        // Player path: batched SoA kernel, 4 colliders per step
+        hit = collider_cache_.firstCapsuleHit(CapsuleQuery::fromBounds(bounds), query_scratch_.data(), count);
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            if (CollisionSystem::checkCollision(bounds, collider_cache_.getBounds(query_scratch_[i]))) {
+                hit = static_cast<int>(i);
+                break;
             }
         }
     }
-    return false;
+
+    if (hit < 0) return false;
+    BW_LOG(DEBUG_COLLISION, DEBUG_TRACE, "Collision detected with {}", objects_[query_scratch_[hit]]->getName());
+    return true;
+}
+
+void EnvironmentManager::collectColliders(const BoundingBox& area, int excludeIndex, std::vector<uint32_t>& out) const {
+    spatial_grid_.query(area, out);
+
+    // Compact in place to the colliders that actually need a narrow-phase test
+    size_t count = 0;
+    for (uint32_t index : out) {
+        if (!objects_[index]->collidable) continue;
+        if (excludeIndex != -1 && exclude_ids_[index] == excludeIndex) continue;
+        out[count++] = index;
+    }
+    out.resize(count);
+}
+
+void EnvironmentManager::queryCandidates(const BoundingBox& area, std::vector<uint32_t>& out) const {
+    spatial_grid_.query(area, out);
 }
 
 std::vector<std::shared_ptr<EnvironmentalObject>> EnvironmentManager::getInteractiveObjects() const {
@@ -87,6 +262,31 @@ std::vector<std::shared_ptr<EnvironmentalObject>> EnvironmentManager::getInterac
     return interactive;
 }
 
+void EnvironmentManager::updateNearbyInteractables(Vector3 center, float radius) {
+    MemoryTagScope memoryTag(MemoryTag::ENVIRONMENT);
+    PROFILE_SCOPE("EnvironmentManager::updateNearbyInteractables");
+    BoundingBox area = {{center.x - radius, center.y - radius, center.z - radius},
+                        {center.x + radius, center.y + radius, center.z + radius}};
+    spatial_grid_.query(area, nearby_scratch_);
+
+    nearby_.clear();
+    for (uint32_t index : nearby_scratch_) {
+        const EnvironmentalObject& obj = *objects_[index];
+        if (!obj.isInteractive()) continue;
+
+        // Doors, not building centres, are what the player walks up to
+        const Building* building = objectCast<Building>(&obj);
+        Vector3 anchor = building ? building->getDoorPosition() : obj.position;
+        float distanceSq = MathUtils::distanceSquared3D(anchor, center);
+        if (distanceSq > radius * radius) continue;
+        nearby_.push_back({index, obj.getKind(), anchor, sqrtf(distanceSq)});
+    }
+
+    std::sort(nearby_.begin(), nearby_.end(), [](const NearbyInteractable& a, const NearbyInteractable& b) {
+        return a.distance < b.distance;
+    });
+}
+
 const std::vector<std::shared_ptr<EnvironmentalObject>>& EnvironmentManager::getAllObjects() const {
     return objects_;
 }
@@ -95,83 +295,183 @@ void EnvironmentManager::loadObjectAsync(const std::string& configPath, LoadCall
     async_loader_.loadObjectAsync(configPath, callback);
 }
 
+void EnvironmentManager::buildObjectAsync(BuildFunction build, LoadCallback callback) {
+    async_loader_.buildObjectAsync("<builder>", std::move(build), std::move(callback));
+}
+
 // SpatialGrid
-size_t EnvironmentManager::SpatialGrid::getFlatIndex(int x, int y, int z) const {
-    return static_cast<size_t>(x * GRID_SIZE * GRID_SIZE + y * GRID_SIZE + z);
+EnvironmentManager::SpatialGrid::CellKey EnvironmentManager::SpatialGrid::makeKey(int x, int y, int z) {
+    // Bias into unsigned 21-bit lanes so negative coordinates hash cleanly
+    constexpr uint64_t BIAS = 1u << 20;
+    constexpr uint64_t MASK = (1u << 21) - 1;
+    return ((static_cast<uint64_t>(x + BIAS) & MASK) << 42) |
+           ((static_cast<uint64_t>(y + BIAS) & MASK) << 21) |
+           (static_cast<uint64_t>(z + BIAS) & MASK);
 }
 
-void EnvironmentManager::SpatialGrid::insert(std::shared_ptr<EnvironmentalObject> obj) {
-    int x = static_cast<int>((obj->position.x - world_min_.x) / cell_size_);
-    int y = static_cast<int>((obj->position.y - world_min_.y) / cell_size_);
-    int z = static_cast<int>((obj->position.z - world_min_.z) / cell_size_);
+void EnvironmentManager::SpatialGrid::decodeKey(CellKey key, int& x, int& y, int& z) {
+    constexpr int64_t BIAS = 1 << 20;
+    constexpr uint64_t MASK = (1u << 21) - 1;
+    x = static_cast<int>(static_cast<int64_t>((key >> 42) & MASK) - BIAS);
+    y = static_cast<int>(static_cast<int64_t>((key >> 21) & MASK) - BIAS);
+    z = static_cast<int>(static_cast<int64_t>(key & MASK) - BIAS);
+}
 
-    x = std::clamp(x, 0, GRID_SIZE - 1);
-    y = std::clamp(y, 0, GRID_SIZE - 1);
-    z = std::clamp(z, 0, GRID_SIZE - 1);
+int EnvironmentManager::SpatialGrid::toCell(float coord) const {
+    return static_cast<int>(std::floor(coord / cell_size_));
+}
 
-    size_t index = getFlatIndex(x, y, z);
-    if (index < grid_.size()) {
-        grid_[index].push_back(obj);
-    } else {
-        std::cerr << "Spatial grid index out of bounds: " << index << std::endl;
+BoundingBox EnvironmentManager::SpatialGrid::objectBox(const EnvironmentalObject& obj) {
+    // Start from a point so objects without components still land in a cell
+    BoundingBox box = {obj.position, obj.position};
+    auto grow = [&box](const BoundingBox& other) {
+        box.min = {std::min(box.min.x, other.min.x), std::min(box.min.y, other.min.y), std::min(box.min.z, other.min.z)};
+        box.max = {std::max(box.max.x, other.max.x), std::max(box.max.y, other.max.y), std::max(box.max.z, other.max.z)};
+    };
+
+    CollisionBounds bounds = obj.getCollisionBounds();
+    if (bounds.size.x != 0.0f || bounds.size.y != 0.0f || bounds.size.z != 0.0f) {
+        grow(CollisionSystem::enclosingBox(bounds));
+        grow(obj.getRenderBounds());
+    } else if (obj.getComponent<RenderComponent>()) {
+        grow(obj.getRenderBounds());
     }
+    return box;
 }
 
-void EnvironmentManager::SpatialGrid::remove(std::shared_ptr<EnvironmentalObject> obj) {
-    int x = static_cast<int>((obj->position.x - world_min_.x) / cell_size_);
-    int y = static_cast<int>((obj->position.y - world_min_.y) / cell_size_);
-    int z = static_cast<int>((obj->position.z - world_min_.z) / cell_size_);
+void EnvironmentManager::SpatialGrid::insert(const EnvironmentalObject& obj, uint32_t index) {
+    if (index >= stamps_.size()) {
+        stamps_.resize(index + 1, 0);
+    }
+    if (index >= ranges_.size()) {
+        ranges_.resize(index + 1);
+    }
 
-    x = std::clamp(x, 0, GRID_SIZE - 1);
-    y = std::clamp(y, 0, GRID_SIZE - 1);
-    z = std::clamp(z, 0, GRID_SIZE - 1);
+    BoundingBox box = objectBox(obj);
+    CellRange& range = ranges_[index];
+    range = {toCell(box.min.x), toCell(box.min.y), toCell(box.min.z),
+             toCell(box.max.x), toCell(box.max.y), toCell(box.max.z)};
 
-    size_t index = getFlatIndex(x, y, z);
-    if (index < grid_.size()) {
-        auto& cell = grid_[index];
-        cell.erase(std::remove(cell.begin(), cell.end(), obj), cell.end());
+    for (int x = range.minX; x <= range.maxX; ++x) {
+        for (int y = range.minY; y <= range.maxY; ++y) {
+            for (int z = range.minZ; z <= range.maxZ; ++z) {
+                cells_[makeKey(x, y, z)].push_back(index);
+            }
+        }
     }
 }
 
-std::vector<std::shared_ptr<EnvironmentalObject>> EnvironmentManager::SpatialGrid::query(const BoundingBox& area) const {
-    std::vector<std::shared_ptr<EnvironmentalObject>> results;
+void EnvironmentManager::SpatialGrid::remove(uint32_t index) {
+    if (index >= ranges_.size()) return;
+
+    // The object has usually moved already, so erase from where it was filed, not where it is
+    CellRange& range = ranges_[index];
+    for (int x = range.minX; x <= range.maxX; ++x) {
+        for (int y = range.minY; y <= range.maxY; ++y) {
+            for (int z = range.minZ; z <= range.maxZ; ++z) {
+                auto it = cells_.find(makeKey(x, y, z));
+                if (it == cells_.end()) continue;
+                auto& cell = it->second;
+                cell.erase(std::remove(cell.begin(), cell.end(), index), cell.end());
+                if (cell.empty()) cells_.erase(it);
+            }
+        }
+    }
+    range = CellRange{};
+}
 
-    int minX = std::clamp(static_cast<int>((area.min.x - world_min_.x) / cell_size_), 0, GRID_SIZE - 1);
-    int minY = std::clamp(static_cast<int>((area.min.y - world_min_.y) / cell_size_), 0, GRID_SIZE - 1);
-    int minZ = std::clamp(static_cast<int>((area.min.z - world_min_.z) / cell_size_), 0, GRID_SIZE - 1);
-    int maxX = std::clamp(static_cast<int>((area.max.x - world_min_.x) / cell_size_), 0, GRID_SIZE - 1);
-    int maxY = std::clamp(static_cast<int>((area.max.y - world_min_.y) / cell_size_), 0, GRID_SIZE - 1);
-    int maxZ = std::clamp(static_cast<int>((area.max.z - world_min_.z) / cell_size_), 0, GRID_SIZE - 1);
+void EnvironmentManager::SpatialGrid::remapIndices(const std::vector<uint32_t>& remap) {
+    for (auto it = cells_.begin(); it != cells_.end();) {
+        auto& cell = it->second;
+        size_t write = 0;
+        for (uint32_t index : cell) {
+            uint32_t mapped = index < remap.size() ? remap[index] : index;
+            if (mapped != INVALID_INDEX) cell[write++] = mapped;
+        }
+        cell.resize(write);
+        it = cell.empty() ? cells_.erase(it) : std::next(it);
+    }
+
+    // Survivors only move down, so an ascending pass never overwrites a range it still needs
+    size_t kept = 0;
+    for (size_t index = 0; index < ranges_.size(); ++index) {
+        uint32_t mapped = index < remap.size() ? remap[index] : static_cast<uint32_t>(index);
+        if (mapped == INVALID_INDEX) continue;
+        ranges_[mapped] = ranges_[index];
+        kept = std::max(kept, static_cast<size_t>(mapped) + 1);
+    }
+    ranges_.resize(kept);
+}
+
+void EnvironmentManager::SpatialGrid::query(const BoundingBox& area, std::vector<uint32_t>& out) const {
+    out.clear();
+    if (cells_.empty()) return;
+
+    // Fresh stamp per query; on wrap-around clear so stale stamps can't alias
+    if (++query_stamp_ == 0) {
+        std::fill(stamps_.begin(), stamps_.end(), 0);
+        query_stamp_ = 1;
+    }
+
+    int minX = toCell(area.min.x), minY = toCell(area.min.y), minZ = toCell(area.min.z);
+    int maxX = toCell(area.max.x), maxY = toCell(area.max.y), maxZ = toCell(area.max.z);
+
+    auto visit = [&](const std::vector<uint32_t>& cell) {
+        for (uint32_t index : cell) {
+            // Large objects span several cells; report each once
+            if (stamps_[index] != query_stamp_) {
+                stamps_[index] = query_stamp_;
+                out.push_back(index);
+            }
+        }
+    };
+
+    // Big areas (e.g. the view frustum) would probe mostly empty cells; walk the occupied set instead
+    double range = double(maxX - minX + 1) * double(maxY - minY + 1) * double(maxZ - minZ + 1);
+    if (range > static_cast<double>(cells_.size())) {
+        for (const auto& [key, cell] : cells_) {
+            int x, y, z;
+            decodeKey(key, x, y, z);
+            if (x >= minX && x <= maxX && y >= minY && y <= maxY && z >= minZ && z <= maxZ) {
+                visit(cell);
+            }
+        }
+        return;
+    }
 
     for (int x = minX; x <= maxX; ++x) {
         for (int y = minY; y <= maxY; ++y) {
             for (int z = minZ; z <= maxZ; ++z) {
-                size_t index = getFlatIndex(x, y, z);
-                if (index < grid_.size()) {
-                    const auto& cell = grid_[index];
-                    results.insert(results.end(), cell.begin(), cell.end());
-                }
+                auto it = cells_.find(makeKey(x, y, z));
+                if (it != cells_.end()) visit(it->second);
             }
         }
     }
-
-    return results;
 }
 
 void EnvironmentManager::SpatialGrid::rebuild() {
-    grid_.assign(TOTAL_CELLS, {});
-    cell_size_ = std::max({(world_max_.x - world_min_.x) / GRID_SIZE,
-                           (world_max_.y - world_min_.y) / GRID_SIZE,
-                           (world_max_.z - world_min_.z) / GRID_SIZE});
+    cells_.clear();
+    ranges_.clear();
+    std::fill(stamps_.begin(), stamps_.end(), 0);
+    query_stamp_ = 0;
     has_been_initialized_ = true;
 }
 
 void EnvironmentManager::SpatialGrid::rebuildWithObjects(const std::vector<std::shared_ptr<EnvironmentalObject>>& objects) {
     rebuild();
+
+    // Size cells from the average horizontal footprint so a typical object covers about one cell
+    float extentSum = 0.0f;
+    size_t counted = 0;
     for (const auto& obj : objects) {
-        if (obj->collidable) {
-            insert(obj);
-        }
+        BoundingBox box = objectBox(*obj);
+        extentSum += std::max(box.max.x - box.min.x, box.max.z - box.min.z);
+        ++counted;
+    }
+    cell_size_ = counted > 0 ? std::clamp(extentSum / counted, MIN_CELL_SIZE, MAX_CELL_SIZE) : DEFAULT_CELL_SIZE;
+
+    for (size_t i = 0; i < objects.size(); ++i) {
+        insert(*objects[i], static_cast<uint32_t>(i));
     }
 }
 
@@ -180,45 +480,118 @@ bool EnvironmentManager::SpatialGrid::isEmpty() const {
 }
 
 size_t EnvironmentManager::SpatialGrid::getGridSize() const {
-    return grid_.size();
+    return cells_.size();
 }
 
 // LODManager
-EnvironmentManager::DetailLevel EnvironmentManager::LODManager::getLODLevel(const Vector3& cameraPos, const Vector3& objectPos, float maxDistance) {
-    float distance = MathUtils::distance3D(cameraPos, objectPos);
-    if (distance > maxDistance) return DetailLevel::CULLED;
-    if (distance > maxDistance * 0.7f) return DetailLevel::LOW;
-    if (distance > maxDistance * 0.3f) return DetailLevel::MEDIUM;
+DetailLevel EnvironmentManager::LODManager::getLODLevel(const Vector3& cameraPos, const Vector3& objectPos,
+                                                        float lodDistance, float cullDistance) {
+    // Compare squared so the per-object LOD pass never takes a square root
+    float distanceSq = MathUtils::distanceSquared3D(cameraPos, objectPos);
+    float low = lodDistance * RenderConstants::LOD_LOW_FRACTION;
+    float medium = lodDistance * RenderConstants::LOD_MEDIUM_FRACTION;
+    if (distanceSq > cullDistance * cullDistance) return DetailLevel::CULLED;
+    if (distanceSq > low * low) return DetailLevel::LOW;
+    if (distanceSq > medium * medium) return DetailLevel::MEDIUM;
     return DetailLevel::HIGH;
 }
 
-void EnvironmentManager::LODManager::updateLODLevels(const Camera3D& camera, std::vector<std::shared_ptr<EnvironmentalObject>>& objects) {
-    float maxDist = 50.0f;  // Adjust based on world
-    for (auto& obj : objects) {
-        // obj->setLOD(getLODLevel(camera.position, obj->position, maxDist));
+void EnvironmentManager::LODManager::updateLODLevels(const Camera3D& camera, std::vector<std::shared_ptr<EnvironmentalObject>>& objects,
+                                                     const std::vector<BoundingBox>& bounds, size_t begin, size_t end,
+                                                     float lodDistance, float cullDistance) {
+    const Vector3& eye = camera.position;
+    end = std::min({end, objects.size(), bounds.size()});
+    for (size_t i = begin; i < end; ++i) {
+        // Measure to the nearest point of the bounds so large buildings don't drop detail up close
+        const BoundingBox& b = bounds[i];
+        Vector3 nearest = {std::clamp(eye.x, b.min.x, b.max.x),
+                           std::clamp(eye.y, b.min.y, b.max.y),
+                           std::clamp(eye.z, b.min.z, b.max.z)};
+        objects[i]->setLOD(getLODLevel(eye, nearest, lodDistance, cullDistance));
     }
 }
 
 // AsyncLoader
+EnvironmentManager::AsyncLoader::~AsyncLoader() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        running_ = false;
+    }
+    queue_cv_.notify_all();
+    if (loader_thread_.joinable()) {
+        loader_thread_.join();
+    }
+}
+
 void EnvironmentManager::AsyncLoader::loadObjectAsync(const std::string& configPath, LoadCallback callback) {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    load_queue_.push({configPath, callback});
+    buildObjectAsync(configPath, [configPath] { return parseObjectConfig(configPath); }, std::move(callback));
 }
 
-void EnvironmentManager::AsyncLoader::processCompletedLoads(EnvironmentManager* manager) {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    while (!load_queue_.empty()) {
-        auto [path, cb] = load_queue_.front();
-        load_queue_.pop();
-        // Simulate/actual load
-        auto obj = std::make_shared<EnvironmentalObject>();  // Replace with actual factory
-        cb(obj);
-        manager->addObject(obj);
+void EnvironmentManager::AsyncLoader::buildObjectAsync(std::string source, BuildFunction build, LoadCallback callback) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        load_queue_.push({std::move(source), std::move(build), std::move(callback)});
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        if (!running_) {
+            running_ = true;
+            loader_thread_ = std::thread(&AsyncLoader::loaderLoop, this);
+        }
+    }
+    queue_cv_.notify_one();
+}
+
+void EnvironmentManager::AsyncLoader::processCompletedLoads(EnvironmentManager* manager, float budgetMs) {
+    if (integrate_cursor_ >= integrating_.size()) {
+        // Only lock to swap buffers; the worker never waits on integration
+        integrating_.clear();
+        integrate_cursor_ = 0;
+        std::lock_guard<std::mutex> lock(completed_mutex_);
+        if (completed_.empty()) return;
+        integrating_.swap(completed_);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto budget = std::chrono::duration<float, std::milli>(budgetMs);
+    while (integrate_cursor_ < integrating_.size()) {
+        Completed& done = integrating_[integrate_cursor_++];
+        if (done.callback) done.callback(done.object);
+        manager->addObject(std::move(done.object));
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+
+        // Always integrate at least one so a tight budget still makes progress
+        if (std::chrono::steady_clock::now() - start >= budget) break;
     }
 }
 
 void EnvironmentManager::AsyncLoader::loaderLoop() {
-    while (running_) {
-        // Process queue
+    Profiler::getInstance().setThreadName("Async Loader");
+    while (true) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return !running_ || !load_queue_.empty(); });
+            if (!running_) return;
+            request = std::move(load_queue_.front());
+            load_queue_.pop();
+        }
+
+        auto obj = request.build();
+        if (!obj) {
+            std::cout << "ASYNC LOADER: Failed to load " << request.source << std::endl;
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(completed_mutex_);
+        completed_.push_back({std::move(obj), std::move(request.callback)});
     }
-}
\ No newline at end of file
+}
+
+std::shared_ptr<EnvironmentalObject> EnvironmentManager::AsyncLoader::parseObjectConfig(const std::string& configPath) {
+    std::ifstream file(configPath);
+    if (!file) return nullptr;
+
+    std::vector<WorldPackEntry> entries;
+    if (!parseObjectText(file, configPath, entries) || entries.size() != 1) return nullptr;
+    return entries.front().placement.create();
+}
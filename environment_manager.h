@@ -3,13 +3,27 @@
 
 #include "collision_system.h"
 #include "environmental_object.h"
+#include "collider_cache.h"
+#include "frustum.h"
+#include "constants.h"
 #include <vector>
 #include <memory>
 #include <queue>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <functional>
 #include <unordered_map>
+#include <cstdint>
+
+/// \brief Interactive object near the point of the last EnvironmentManager::updateNearbyInteractables.
+struct NearbyInteractable {
+    uint32_t index;          // Into getAllObjects()
+    ObjectKind kind;         // BUILDING or NPC for the game's own interactables
+    Vector3 anchor;          // Door for buildings, standing position otherwise
+    float distance;          // Query point to anchor
+};
 
 /// \brief Manages environmental objects with spatial partitioning and LOD.
 class EnvironmentManager {
@@ -18,14 +32,51 @@ public:
     /// \param obj Object to add.
     void addObject(std::shared_ptr<EnvironmentalObject> obj);
 
+    /// \brief Removes objects and compacts every per-object index in one pass.
+    /// Surviving objects keep their relative order; their indices shift down.
+    /// \param objs Objects to remove; ones not in the manager are ignored.
+    /// \return Number of objects removed.
+    size_t removeObjects(const std::vector<std::shared_ptr<EnvironmentalObject>>& objs);
+
     /// \brief Updates all objects.
     /// \param deltaTime Delta time.
     /// \param camera Camera.
     void update(float deltaTime, const Camera3D& camera);
 
-    /// \brief Renders all objects.
+    /// \brief Renders objects inside the camera frustum at their current LOD.
+    /// \param camera Camera.
+    /// \param portal Optional second volume objects must also touch, e.g. the view through a doorway.
+    void renderAll(const Camera3D& camera, const Frustum* portal = nullptr);
+
+    /// \brief Queues the objects renderAll would draw without flushing, so the caller can add
+    /// the rest of the opaque world to the same sorted batch first.
     /// \param camera Camera.
-    void renderAll(const Camera3D& camera);
+    /// \param portal As for renderAll.
+    void submitVisible(const Camera3D& camera, const Frustum* portal = nullptr);
+
+    /// \brief Draws one object now at its LOD, outside the batched queue. Call inside BeginMode3D.
+    /// \param object Object to draw; need not be managed here.
+    /// \param camera Camera.
+    void renderImmediate(EnvironmentalObject& object, const Camera3D& camera);
+
+    /// \brief Releases GPU resources held by the render queues. Call before CloseWindow.
+    void unloadRenderResources();
+
+    /// \brief Gets the batched render queue (for draw statistics).
+    /// \return Render queue.
+    const RenderQueue& getRenderQueue() const { return render_queue_; }
+    RenderQueue& getRenderQueue() { return render_queue_; }
+
+    /// \brief Gets how many objects the last renderAll drew.
+    /// \return Drawn object count.
+    size_t getLastRenderedCount() const { return last_rendered_count_; }
+
+    /// \brief Sets how far detail tiers reach and where objects stop being drawn.
+    /// \param lodDistance LOD tiers change at RenderConstants' fractions of this.
+    /// \param cullDistance Objects farther than this are culled; also the view frustum's far plane.
+    void setDrawDistances(float lodDistance, float cullDistance);
+    float getLODDistance() const { return lod_distance_; }
+    float getCullDistance() const { return cull_distance_; }
 
     /// \brief Rebuilds spatial grid.
     void rebuildSpatialGrid();
@@ -36,105 +87,255 @@ public:
     /// \return True if colliding.
     bool checkCollision(const CollisionBounds& bounds, int excludeIndex = -1) const;
 
+    /// \brief Collects indices of objects whose cells overlap an area.
+    /// \param area Area to query.
+    /// \param out Caller-owned scratch buffer; cleared, then filled with unique object indices.
+    void queryCandidates(const BoundingBox& area, std::vector<uint32_t>& out) const;
+
+    /// \brief Collects collidable, non-excluded objects overlapping an area for narrow-phase tests.
+    /// \param area Area to query.
+    /// \param excludeIndex Index to exclude (same meaning as in checkCollision).
+    /// \param out Caller-owned scratch buffer; cleared, then filled with object indices.
+    void collectColliders(const BoundingBox& area, int excludeIndex, std::vector<uint32_t>& out) const;
+
+    /// \brief Gets the SoA collider snapshot, indexed like getAllObjects().
+    /// \return Collider cache.
+    const ColliderCache& getColliderCache() const { return collider_cache_; }
+
     /// \brief Gets interactive objects.
     /// \return Interactive objects.
     std::vector<std::shared_ptr<EnvironmentalObject>> getInteractiveObjects() const;
 
+    /// \brief Gathers interactive objects whose anchor is within radius of a point, nearest first.
+    /// Run once per frame; interaction handling, indicators and labels all read the result.
+    /// \param center Query point (the camera).
+    /// \param radius Search radius.
+    void updateNearbyInteractables(Vector3 center, float radius = EnvironmentConstants::NEARBY_QUERY_RADIUS);
+
+    /// \brief Gets the last updateNearbyInteractables result. Indices stay valid across removeObjects.
+    const std::vector<NearbyInteractable>& getNearbyInteractables() const { return nearby_; }
+
     /// \brief Gets all objects.
     /// \return All objects.
     const std::vector<std::shared_ptr<EnvironmentalObject>>& getAllObjects() const;
 
+    /// \brief Gets a counter bumped whenever objects are added or removed, so derived data
+    /// (the navigation grid) can tell when to re-sync.
+    uint32_t getRevision() const { return revision_; }
+
+    // **TYPED REGISTRIES** - Kept by addObject/removeObjects; pointers live as long as the object
+    /// \brief Finds a building by its BuildingConfig id in O(1).
+    /// \return Building, or nullptr if no building has that id.
+    const Building* findBuilding(int id) const {
+        return id >= 0 && static_cast<size_t>(id) < buildings_by_id_.size() ? buildings_by_id_[id] : nullptr;
+    }
+
+    /// \brief Gets every building, in insertion order.
+    const std::vector<Building*>& getBuildings() const { return buildings_; }
+    const std::vector<Tree*>& getTrees() const { return trees_; }
+    const std::vector<Well*>& getWells() const { return wells_; }
+
     // New: Async loading
     using LoadCallback = std::function<void(std::shared_ptr<EnvironmentalObject>)>;
-    /// \brief Loads object async.
+    /// \brief Loads object async: parsed on a worker thread, added during a later update().
     /// \param configPath Config path.
-    /// \param callback Callback on load.
+    /// \param callback Callback on load, run inside update() before the object is added.
     void loadObjectAsync(const std::string& configPath, LoadCallback callback);
 
+    using BuildFunction = std::function<std::shared_ptr<EnvironmentalObject>()>;
+    /// \brief Runs an object builder on the loader thread and adds the result like loadObjectAsync.
+    /// \param build Builder; must not touch the GPU or main-thread state.
+    /// \param callback Callback on load, run inside update() before the object is added.
+    void buildObjectAsync(BuildFunction build, LoadCallback callback);
+
+    /// \brief Gets async loads that have not been added yet.
+    size_t getPendingLoadCount() const { return async_loader_.getPendingCount(); }
+
 private:
     std::vector<std::shared_ptr<EnvironmentalObject>> objects_;
+    uint32_t revision_ = 0;
+    // Per-object id matched against checkCollision's excludeIndex: building id for buildings, else index
+    std::vector<int> exclude_ids_;
+    // Reused by checkCollision so the player movement path never allocates
+    mutable std::vector<uint32_t> query_scratch_;
+    // SoA snapshot of collider shapes; refreshed only when an object moves
+    ColliderCache collider_cache_;
+    // World-space render bounds per object, refreshed alongside collider_cache_
+    std::vector<BoundingBox> render_bounds_;
+    std::vector<uint32_t> render_scratch_;
+    std::vector<uint32_t> nearby_scratch_;
+    std::vector<NearbyInteractable> nearby_;
+    std::vector<uint8_t> stale_flags_;      // Set by parallel object updates, consumed serially
+    RenderQueue render_queue_;
+    RenderQueue immediate_queue_;           // renderImmediate: one object per flush
+    size_t last_rendered_count_ = 0;
+    float lod_distance_ = RenderConstants::LOD_MAX_DISTANCE;
+    float cull_distance_ = RenderConstants::LOD_MAX_DISTANCE;
+
+    std::vector<Building*> buildings_by_id_;   // Indexed by building id; gaps are null
+    std::vector<Building*> buildings_;
+    std::vector<Tree*> trees_;
+    std::vector<Well*> wells_;
+
+    /// \brief Re-snapshots cached bounds for one object.
+    void refreshCachedBounds(uint32_t index);
+
+    /// \brief Files an object under its ObjectKind in the typed registries.
+    void registerTyped(EnvironmentalObject& obj);
 
     // New: Spatial partitioning
     class SpatialGrid {
     public:
-        /// \brief Inserts object.
+        /// \brief Inserts object into every cell its bounds cover.
         /// \param obj Object to insert.
-        void insert(std::shared_ptr<EnvironmentalObject> obj);
+        /// \param index Object's index in EnvironmentManager::objects_.
+        void insert(const EnvironmentalObject& obj, uint32_t index);
+
+        /// \brief Removes object from the cells it was last inserted into.
+        /// \param index Object index to remove.
+        void remove(uint32_t index);
 
-        /// \brief Removes object.
-        /// \param obj Object to remove.
-        void remove(std::shared_ptr<EnvironmentalObject> obj);
+        /// \brief Relabels every entry through remap in one sweep; entries mapped to INVALID_INDEX are dropped.
+        /// \param remap Old index -> new index.
+        void remapIndices(const std::vector<uint32_t>& remap);
 
-        /// \brief Queries area.
+        static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+        /// \brief Queries area without allocating once buffers are warm.
         /// \param area Area to query.
-        /// \return Objects in area.
-        std::vector<std::shared_ptr<EnvironmentalObject>> query(const BoundingBox& area) const;
+        /// \param out Output buffer; cleared, then filled with unique object indices.
+        void query(const BoundingBox& area, std::vector<uint32_t>& out) const;
 
         /// \brief Rebuilds grid.
         void rebuild();
 
         /// \brief Rebuilds with objects.
-        /// \param objects Objects to insert.
+        /// \param objects Objects to insert, indexed by position in the vector.
         void rebuildWithObjects(const std::vector<std::shared_ptr<EnvironmentalObject>>& objects);
 
         /// \brief Checks if empty.
         /// \return True if empty.
         bool isEmpty() const;
 
-        /// \brief Gets grid size.
-        /// \return Grid size.
+        /// \brief Gets number of occupied cells.
+        /// \return Occupied cell count.
         size_t getGridSize() const;
 
     private:
-        static constexpr int GRID_SIZE = 64;
-        static constexpr size_t TOTAL_CELLS = GRID_SIZE * GRID_SIZE * GRID_SIZE;
-        std::vector<std::vector<std::shared_ptr<EnvironmentalObject>>> grid_;
-        Vector3 world_min_ = {-50, -10, -50};  // Smaller bounds for actual game world
-        Vector3 world_max_ = {50, 10, 50};
-        float cell_size_;
-        size_t getFlatIndex(int x, int y, int z) const;
+        using CellKey = uint64_t;
+        static constexpr float MIN_CELL_SIZE = 2.0f;
+        static constexpr float MAX_CELL_SIZE = 16.0f;
+        static constexpr float DEFAULT_CELL_SIZE = 4.0f;
+
+        // Only occupied cells are stored, so memory follows object count rather than world volume
+        std::unordered_map<CellKey, std::vector<uint32_t>> cells_;
+        float cell_size_ = DEFAULT_CELL_SIZE;
+        // Per-object stamp of the last query that reported it, for dedupe across cells
+        mutable std::vector<uint32_t> stamps_;
+        mutable uint32_t query_stamp_ = 0;
         bool has_been_initialized_ = false;
+
+        // Per-object cell range from its last insert, so remove() touches only those cells
+        struct CellRange {
+            int minX = 0, minY = 0, minZ = 0;
+            int maxX = -1, maxY = -1, maxZ = -1;    // Empty until inserted
+        };
+        std::vector<CellRange> ranges_;
+
+        /// \brief Packs signed cell coordinates into a hash key (21 bits per axis).
+        static CellKey makeKey(int x, int y, int z);
+        static void decodeKey(CellKey key, int& x, int& y, int& z);
+        int toCell(float coord) const;
+        /// \brief Conservative world-space AABB of an object's collision and render bounds.
+        static BoundingBox objectBox(const EnvironmentalObject& obj);
     };
     SpatialGrid spatial_grid_;
 
     // New: LOD System
-    enum class DetailLevel { HIGH, MEDIUM, LOW, CULLED };
-
     class LODManager {
     public:
         /// \brief Gets LOD level.
         /// \param cameraPos Camera position.
-        /// \param objectPos Object position.
-        /// \param maxDistance Max distance.
+        /// \param objectPos Closest point of the object to the camera.
+        /// \param lodDistance Distance the LOD tier fractions apply to.
+        /// \param cullDistance Beyond this the object is culled.
         /// \return LOD level.
-        DetailLevel getLODLevel(const Vector3& cameraPos, const Vector3& objectPos, float maxDistance);
+        DetailLevel getLODLevel(const Vector3& cameraPos, const Vector3& objectPos, float lodDistance, float cullDistance);
 
-        /// \brief Updates LOD levels.
+        /// \brief Updates LOD levels for objects in [begin, end).
         /// \param camera Camera.
         /// \param objects Objects.
-        void updateLODLevels(const Camera3D& camera, std::vector<std::shared_ptr<EnvironmentalObject>>& objects);
+        /// \param bounds World-space render bounds, parallel to objects.
+        /// \param begin First object index.
+        /// \param end One past the last object index.
+        /// \param lodDistance As for getLODLevel.
+        /// \param cullDistance As for getLODLevel.
+        void updateLODLevels(const Camera3D& camera, std::vector<std::shared_ptr<EnvironmentalObject>>& objects,
+                             const std::vector<BoundingBox>& bounds, size_t begin, size_t end,
+                             float lodDistance, float cullDistance);
     };
     LODManager lod_manager_;
 
     // New: Async Loader
+    /// \brief Parses object configs on a worker thread and hands finished objects to the main thread.
+    ///
+    /// The worker only touches the request and completed queues; the main thread drains
+    /// completed objects into objects_ and the grid within a per-frame time budget.
     class AsyncLoader {
     public:
         using LoadCallback = std::function<void(std::shared_ptr<EnvironmentalObject>)>;
+        using BuildFunction = std::function<std::shared_ptr<EnvironmentalObject>()>;
 
-        /// \brief Loads object async.
+        ~AsyncLoader();
+
+        /// \brief Queues a config for loading; starts the worker on first use.
         /// \param configPath Config path.
-        /// \param callback Callback.
+        /// \param callback Called on the main thread before the object is added.
         void loadObjectAsync(const std::string& configPath, LoadCallback callback);
 
-        /// \brief Processes completed loads.
+        /// \brief Queues a builder to run on the worker.
+        /// \param source Description for error logs.
+        /// \param build Builder returning the object, or nullptr on failure.
+        /// \param callback Called on the main thread before the object is added.
+        void buildObjectAsync(std::string source, BuildFunction build, LoadCallback callback);
+
+        /// \brief Integrates finished loads until the time budget runs out; the rest wait a frame.
         /// \param manager Environment manager.
-        void processCompletedLoads(EnvironmentManager* manager);
+        /// \param budgetMs Main-thread time allowed this call.
+        void processCompletedLoads(EnvironmentManager* manager, float budgetMs = EnvironmentConstants::LOAD_INTEGRATION_BUDGET_MS);
+
+        /// \brief Gets requests not yet handed to the main thread (queued, parsing, or waiting for integration).
+        size_t getPendingCount() const { return pending_.load(std::memory_order_relaxed); }
+
+        /// \brief Parses a key=value object config (type=building|well|tree).
+        /// \param configPath Config path.
+        /// \return New object, or nullptr if the file is missing or malformed.
+        static std::shared_ptr<EnvironmentalObject> parseObjectConfig(const std::string& configPath);
 
     private:
-        std::queue<std::pair<std::string, LoadCallback>> load_queue_;
+        struct Request {
+            std::string source;
+            BuildFunction build;
+            LoadCallback callback;
+        };
+
+        struct Completed {
+            std::shared_ptr<EnvironmentalObject> object;
+            LoadCallback callback;
+        };
+
+        std::queue<Request> load_queue_;
         std::mutex queue_mutex_;
+        std::condition_variable queue_cv_;
+
+        std::vector<Completed> completed_;        // Filled by the worker under completed_mutex_
+        std::mutex completed_mutex_;
+        std::vector<Completed> integrating_;      // Main-thread only; swapped with completed_
+        size_t integrate_cursor_ = 0;
+
         std::thread loader_thread_;
-        bool running_ = true;
+        std::atomic<bool> running_{false};
+        std::atomic<size_t> pending_{0};
         void loaderLoop();
     };
     AsyncLoader async_loader_;
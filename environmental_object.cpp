@@ -2,45 +2,40 @@
 #include "environmental_object.h"
 #include "math_utils.h"
 #include "collision_system.h"  // For CollisionBounds and CollisionShape
-#include "rlgl.h"             // For rlPushMatrix, rlTranslatef, rlRotatef, rlPopMatrix
+#include "constants.h"        // For RenderConstants LOD tessellation
+#include "object_pool.h"      // For PoolAllocator
+#include "spatial_audio.h"    // For AudioEmitterComponent
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
 void EnvironmentalObject::addComponent(std::unique_ptr<Component> component) {
-    components_[component->getTypeName()] = std::move(component);
-}
-
-Component* EnvironmentalObject::getComponent(const std::string& typeName) const {
-    auto it = components_.find(typeName);
-    return (it != components_.end()) ? it->second.get() : nullptr;
+    ecs::ComponentTypeId id = component->getTypeId();
+    if (id >= components_.size()) {
+        components_.resize(id + 1);
+    }
+    components_[id] = std::move(component);
 }
 
 void EnvironmentalObject::update(float deltaTime) {
-    for (auto& pair : components_) {
-        pair.second->update(deltaTime);
+    for (auto& component : components_) {
+        if (component) component->update(deltaTime);
     }
 }
 
-void EnvironmentalObject::render([[maybe_unused]] const Camera3D& camera) {
-    auto* component = getComponent("RenderComponent");
-    if (component) {
-        auto renderComp = dynamic_cast<RenderComponent*>(component);
-        if (renderComp) {
-            // Apply position transformation before rendering
-            rlPushMatrix();
-            rlTranslatef(position.x, position.y, position.z);
-            renderComp->render(camera);
-            rlPopMatrix();
-        } else {
-            std::cerr << "ERROR: Component '" << component->getTypeName() << "' is not a RenderComponent for object '" << getName() << "'" << std::endl;
-        }
+void EnvironmentalObject::submit(RenderQueue& queue, const Camera3D& camera) {
+    if (lod_ == DetailLevel::CULLED) return;
+
+    // The slot is keyed by RenderComponent's type id, so the static cast is always exact
+    if (auto* renderComp = getComponent<RenderComponent>()) {
+        renderComp->submit(queue, position, camera, lod_);
     } else {
         std::cerr << "WARNING: No RenderComponent found for object '" << getName() << "'" << std::endl;
     }
 }
 
 CollisionBounds EnvironmentalObject::getCollisionBounds() const {
-    if (auto physicsComp = dynamic_cast<PhysicsComponent*>(getComponent("PhysicsComponent"))) {
+    if (auto* physicsComp = getComponent<PhysicsComponent>()) {
         CollisionBounds bounds = physicsComp->getBounds();
         // Convert relative bounds to world coordinates
         bounds.position.x += position.x;
@@ -51,75 +46,74 @@ CollisionBounds EnvironmentalObject::getCollisionBounds() const {
     return CollisionBounds{}; // Return default bounds if no physics component
 }
 
-template<typename T>
-std::unique_ptr<T> ObjectPool<T>::acquire() {
-    std::lock_guard<std::mutex> lock(poolMutex_);
-    if (!pool_.empty()) {
-        std::unique_ptr<T> obj = std::move(pool_.back());
-        pool_.pop_back();
-        return obj;
+BoundingBox EnvironmentalObject::getRenderBounds() const {
+    if (auto* renderComp = getComponent<RenderComponent>()) {
+        BoundingBox local = renderComp->getLocalBounds();
+        return {{local.min.x + position.x, local.min.y + position.y, local.min.z + position.z},
+                {local.max.x + position.x, local.max.y + position.y, local.max.z + position.z}};
     }
-    return std::make_unique<T>();
+    return CollisionSystem::enclosingBox(getCollisionBounds());
 }
 
-template<typename T>
-void ObjectPool<T>::release(std::unique_ptr<T> object) {
-    std::lock_guard<std::mutex> lock(poolMutex_);
-    pool_.push_back(std::move(object));
-}
-
-// Explicit instantiations if needed (e.g., for Building, Well, Tree)
-// template class ObjectPool<Building>;
-// template class ObjectPool<Well>;
-// template class ObjectPool<Tree>;
-
 // Factory implementations
+// Object and control block share one pooled slot; streamed cells recycle slots instead of hitting the heap
 std::shared_ptr<EnvironmentalObject> EnvironmentalObjectFactory::createBuilding(const BuildingConfig& config, Vector3 pos) {
-    return std::make_shared<Building>(pos, config);
+    return std::allocate_shared<Building>(PoolAllocator<Building>(), pos, config);
 }
 
 std::shared_ptr<EnvironmentalObject> EnvironmentalObjectFactory::createWell(const WellConfig& config, Vector3 pos) {
-    return std::make_shared<Well>(pos, config);
+    auto well = std::allocate_shared<Well>(PoolAllocator<Well>(), pos, config);
+    well->addComponent(std::make_unique<AudioEmitterComponent>(WorldSound::WELL_WATER, AudioConstants::WELL_EMITTER_RADIUS,
+                                                               AudioConstants::WELL_EMITTER_VOLUME));
+    return well;
 }
 
 std::shared_ptr<EnvironmentalObject> EnvironmentalObjectFactory::createTree(const TreeConfig& config, Vector3 pos) {
-    return std::make_shared<Tree>(pos, config);
+    return std::allocate_shared<Tree>(PoolAllocator<Tree>(), pos, config);
 }
 
 // Building Components
 BuildingRenderComponent::BuildingRenderComponent(const BuildingConfig& config) : config_(config) {}
 
-void BuildingRenderComponent::render([[maybe_unused]] const Camera3D& camera) {
+void BuildingRenderComponent::submit(RenderQueue& queue, Vector3 origin, [[maybe_unused]] const Camera3D& camera, DetailLevel detail) {
+    auto at = [&origin](float x, float y, float z) { return Vector3{origin.x + x, origin.y + y, origin.z + z}; };
+
     // Draw main building (position is from owner)
-    DrawCube({0,0,0}, config_.size.x, config_.size.y, config_.size.z, config_.color);  // Relative to position
-    DrawCubeWires({0,0,0}, config_.size.x, config_.size.y, config_.size.z, BLACK);
+    queue.submitCube(origin, config_.size, config_.color);
+    if (detail == DetailLevel::HIGH) {
+        queue.submitCubeWires(origin, config_.size, BLACK);
+    }
 
     // Roof
-    Vector3 roofPos = {0, config_.size.y/2 + 0.5f, 0};
-    DrawCube(roofPos, config_.size.x + 1.0f, 1.0f, config_.size.z + 1.0f, DARKGRAY);
+    queue.submitCube(at(0, config_.size.y/2 + 0.5f, 0), {config_.size.x + 1.0f, 1.0f, config_.size.z + 1.0f}, DARKGRAY);
 
     // Door
     Vector3 doorPos = config_.door.offset;
-    rlPushMatrix();
-    rlTranslatef(doorPos.x, doorPos.y + config_.door.height / 2.0f, doorPos.z);
-    rlRotatef(config_.door.rotation, 0.0f, 1.0f, 0.0f);
-    DrawCube({0, 0, 0}, config_.door.width, config_.door.height, 0.2f, config_.door.color);
-    DrawCubeWires({0, 0, 0}, config_.door.width, config_.door.height, 0.2f, BLACK);
-    rlPopMatrix();
+    Vector3 doorCentre = at(doorPos.x, doorPos.y + config_.door.height / 2.0f, doorPos.z);
+    Vector3 doorSize = {config_.door.width, config_.door.height, 0.2f};
+    queue.submitCubeRotated(doorCentre, doorSize, config_.door.rotation, config_.door.color);
+    if (detail == DetailLevel::HIGH) {
+        queue.submitCubeRotated(doorCentre, doorSize, config_.door.rotation, BLACK, true);
+    }
+
+    // Handle and sign are too small to read past close range
+    if (detail != DetailLevel::HIGH) return;
 
     // Handle
     float handleX = cosf(config_.door.rotation * DEG2RAD) * 0.4f;
     float handleZ = sinf(config_.door.rotation * DEG2RAD) * 0.4f;
-    Vector3 handlePos = {doorPos.x + handleX, doorPos.y + 1.0f, doorPos.z + handleZ};
-    DrawSphere(handlePos, 0.08f, GOLD);
+    queue.submitSphere(at(doorPos.x + handleX, doorPos.y + 1.0f, doorPos.z + handleZ), 0.08f, 16, 16, GOLD);
 
     // Sign
-    Vector3 signPos = {doorPos.x, doorPos.y + 2.2f, doorPos.z};
-    rlPushMatrix();
-    rlTranslatef(signPos.x, signPos.y, signPos.z);
-    rlRotatef(config_.door.rotation, 0.0f, 1.0f, 0.0f);
-    DrawCube({0, 0, 0}, 1.5f, 0.3f, 0.05f, LIGHTGRAY);
-    rlPopMatrix();
+    queue.submitCubeRotated(at(doorPos.x, doorPos.y + 2.2f, doorPos.z), {1.5f, 0.3f, 0.05f}, config_.door.rotation, LIGHTGRAY);
+}
+
+BoundingBox BuildingRenderComponent::getLocalBounds() const {
+    // Body plus the overhanging roof, grown to include the door and sign
+    Vector3 half = {config_.size.x / 2 + 0.5f, config_.size.y / 2, config_.size.z / 2 + 0.5f};
+    Vector3 door = config_.door.offset;
+    return {{std::min(-half.x, door.x - 1.0f), -half.y, std::min(-half.z, door.z - 1.0f)},
+            {std::max(half.x, door.x + 1.0f), std::max(half.y + 1.0f, door.y + config_.door.height + 0.5f), std::max(half.z, door.z + 1.0f)}};
 }
 
 BuildingPhysicsComponent::BuildingPhysicsComponent(const Vector3& size) : size_(size) {}
@@ -133,7 +127,7 @@ CollisionBounds BuildingPhysicsComponent::getBounds() const {
     };
 }
 
-Building::Building(Vector3 pos, const BuildingConfig& config) : config_(config) {
+Building::Building(Vector3 pos, const BuildingConfig& config) : EnvironmentalObject(KIND), config_(config) {
     position = pos;
     collidable = true;  // Ensure collision is enabled for buildings
     addComponent(std::make_unique<BuildingRenderComponent>(config));
@@ -144,10 +138,21 @@ Vector3 Building::getDoorPosition() const {
     return Vector3{position.x + config_.door.offset.x, position.y + config_.door.offset.y, position.z + config_.door.offset.z};
 }
 
+void Building::getDoorway(Vector3 corners[4]) const {
+    Vector3 door = getDoorPosition();
+    float floor = position.y - config_.size.y / 2 + config_.door.offset.y;
+    float top = std::min(floor + config_.door.height, position.y + config_.size.y / 2);
+    float halfX = cosf(config_.door.rotation * DEG2RAD) * config_.door.width / 2;
+    float halfZ = sinf(config_.door.rotation * DEG2RAD) * config_.door.width / 2;
+    corners[0] = {door.x - halfX, floor, door.z - halfZ};
+    corners[1] = {door.x + halfX, floor, door.z + halfZ};
+    corners[2] = {door.x + halfX, top, door.z + halfZ};
+    corners[3] = {door.x - halfX, top, door.z - halfZ};
+}
+
 bool Building::isPlayerAtDoor(Vector3 playerPos, float threshold) const {
     Vector3 doorPos = getDoorPosition();
-    float distance = MathUtils::distance3D(playerPos, doorPos);
-    return distance <= threshold;
+    return MathUtils::distanceSquared3D(playerPos, doorPos) <= threshold * threshold;
 }
 
 CollisionBounds Building::getDoorCollisionBounds() const {
@@ -174,12 +179,22 @@ CollisionBounds Building::getWallCollisionBounds() const {
 // Well Components
 WellRenderComponent::WellRenderComponent(const WellConfig& config) : config_(config) {}
 
-void WellRenderComponent::render([[maybe_unused]] const Camera3D& camera) {
-    DrawCylinder({0,0,0}, config_.baseRadius, config_.baseRadius, 0.5f, 16, DARKGRAY);
-    DrawCylinder({0,0,0}, config_.baseRadius * 0.8f, config_.baseRadius * 0.8f, config_.height, 16, GRAY);
-    DrawCylinder({0, config_.height, 0}, config_.baseRadius * 0.9f, config_.baseRadius * 0.7f, 0.2f, 16, DARKGRAY);
-    DrawCylinder({0, config_.height + 0.5f, 0}, 0.1f, 0.1f, 1.0f, 8, BROWN);
-    DrawSphere({0, config_.height + 1.5f, 0}, 0.15f, GRAY);
+void WellRenderComponent::submit(RenderQueue& queue, Vector3 origin, [[maybe_unused]] const Camera3D& camera, DetailLevel detail) {
+    auto at = [&origin](float y) { return Vector3{origin.x, origin.y + y, origin.z}; };
+    int slices = detail == DetailLevel::HIGH ? RenderConstants::CYLINDER_SEGMENTS
+               : detail == DetailLevel::MEDIUM ? RenderConstants::CYLINDER_SEGMENTS_MEDIUM
+               : RenderConstants::CYLINDER_SEGMENTS_LOW;
+    queue.submitCylinder(at(0), config_.baseRadius, config_.baseRadius, 0.5f, slices, DARKGRAY);
+    queue.submitCylinder(at(0), config_.baseRadius * 0.8f, config_.baseRadius * 0.8f, config_.height, slices, GRAY);
+    queue.submitCylinder(at(config_.height), config_.baseRadius * 0.9f, config_.baseRadius * 0.7f, 0.2f, slices, DARKGRAY);
+    if (detail == DetailLevel::LOW) return;  // Rope and bucket vanish at range
+    queue.submitCylinder(at(config_.height + 0.5f), 0.1f, 0.1f, 1.0f, 8, BROWN);
+    queue.submitSphere(at(config_.height + 1.5f), 0.15f, 16, 16, GRAY);
+}
+
+BoundingBox WellRenderComponent::getLocalBounds() const {
+    return {{-config_.baseRadius, 0.0f, -config_.baseRadius},
+            {config_.baseRadius, config_.height + 1.65f, config_.baseRadius}};
 }
 
 WellPhysicsComponent::WellPhysicsComponent(float baseRadius, float height) : baseRadius_(baseRadius), height_(height) {}
@@ -193,7 +208,7 @@ CollisionBounds WellPhysicsComponent::getBounds() const {
     };
 }
 
-Well::Well(Vector3 pos, const WellConfig& config) : config_(config) {
+Well::Well(Vector3 pos, const WellConfig& config) : EnvironmentalObject(KIND), config_(config) {
     position = pos;
     collidable = true;  // Ensure collision is enabled for the well
     addComponent(std::make_unique<WellRenderComponent>(config));
@@ -203,33 +218,64 @@ Well::Well(Vector3 pos, const WellConfig& config) : config_(config) {
 // Tree Components
 TreeRenderComponent::TreeRenderComponent(const TreeConfig& config) : config_(config) {}
 
-void TreeRenderComponent::render([[maybe_unused]] const Camera3D& camera) {
+void TreeRenderComponent::submit(RenderQueue& queue, Vector3 origin, const Camera3D& camera, DetailLevel detail) {
+    auto at = [&origin](float x, float y, float z) { return Vector3{origin.x + x, origin.y + y, origin.z + z}; };
+    const Color trunkColor = {139, 69, 19, 255};     // Saddle brown
+    const Color foliageColor = {34, 139, 34, 255};   // Forest green
+    const Color upperColor = {50, 160, 50, 255};     // Lighter green
+
+    if (detail == DetailLevel::LOW) {
+        submitImpostor(queue, origin, camera);
+        return;
+    }
+    if (detail == DetailLevel::MEDIUM) {
+        // Solid shapes only: no wireframes or branch stubs, coarser tessellation
+        queue.submitCylinder(at(0, 0, 0), config_.trunkRadius, config_.trunkRadius, config_.trunkHeight, RenderConstants::CYLINDER_SEGMENTS_MEDIUM, trunkColor);
+        queue.submitSphere(at(0, config_.trunkHeight - 0.3f, 0), config_.foliageRadius, 8, 10, foliageColor);
+        queue.submitSphere(at(0, config_.trunkHeight + 0.5f, 0), config_.foliageRadius * 0.8f, 6, 8, upperColor);
+        return;
+    }
+
     // Draw trunk - positioned from ground level up with realistic tree colors
-    Vector3 trunkPos = {0, config_.trunkHeight/2, 0};
-    DrawCylinder(trunkPos, config_.trunkRadius, config_.trunkRadius, config_.trunkHeight, 16, Color{139, 69, 19, 255}); // Saddle brown
-    DrawCylinderWires(trunkPos, config_.trunkRadius, config_.trunkRadius, config_.trunkHeight, 16, Color{101, 67, 33, 255}); // Darker brown
+    Vector3 trunkBase = at(0, 0, 0);
+    queue.submitCylinder(trunkBase, config_.trunkRadius, config_.trunkRadius, config_.trunkHeight, 16, trunkColor);
+    queue.submitCylinderWires(trunkBase, config_.trunkRadius, config_.trunkRadius, config_.trunkHeight, 16, Color{101, 67, 33, 255}); // Darker brown
 
     // Draw foliage - layered spheres for more realistic tree shape
     // Main foliage layer at top of trunk
-    Vector3 mainFoliagePos = {0, config_.trunkHeight - 0.3f, 0};
-    DrawSphere(mainFoliagePos, config_.foliageRadius, Color{34, 139, 34, 255}); // Forest green
-    DrawSphereWires(mainFoliagePos, config_.foliageRadius, 12, 8, Color{0, 100, 0, 255}); // Dark green wireframe
+    Vector3 mainFoliagePos = at(0, config_.trunkHeight - 0.3f, 0);
+    queue.submitSphere(mainFoliagePos, config_.foliageRadius, 16, 16, foliageColor);
+    queue.submitSphereWires(mainFoliagePos, config_.foliageRadius, 12, 8, Color{0, 100, 0, 255}); // Dark green wireframe
 
     // Upper foliage layer for tree-like shape
-    Vector3 upperFoliagePos = {0, config_.trunkHeight + 0.5f, 0};
-    DrawSphere(upperFoliagePos, config_.foliageRadius * 0.8f, Color{50, 160, 50, 255}); // Lighter green
-    DrawSphereWires(upperFoliagePos, config_.foliageRadius * 0.8f, 10, 6, Color{25, 120, 25, 255});
+    Vector3 upperFoliagePos = at(0, config_.trunkHeight + 0.5f, 0);
+    queue.submitSphere(upperFoliagePos, config_.foliageRadius * 0.8f, 16, 16, upperColor);
+    queue.submitSphereWires(upperFoliagePos, config_.foliageRadius * 0.8f, 10, 6, Color{25, 120, 25, 255});
 
     // Add some smaller branches for realism
     float branchY = config_.trunkHeight * 0.7f;
-    Vector3 branchPos1 = {config_.trunkRadius + 0.2f, branchY, 0};
-    Vector3 branchPos2 = {-config_.trunkRadius - 0.2f, branchY, 0};
-    Vector3 branchPos3 = {0, branchY, config_.trunkRadius + 0.2f};
+    const Color branchColor = {101, 67, 33, 255};
+    queue.submitCylinder(at(config_.trunkRadius + 0.2f, branchY, 0), 0.1f, 0.1f, 0.8f, 8, branchColor);
+    queue.submitCylinder(at(-config_.trunkRadius - 0.2f, branchY, 0), 0.1f, 0.1f, 0.8f, 8, branchColor);
+    queue.submitCylinder(at(0, branchY, config_.trunkRadius + 0.2f), 0.1f, 0.1f, 0.8f, 8, branchColor);
+}
 
-    // Draw small branch stubs
-    DrawCylinder(branchPos1, 0.1f, 0.1f, 0.8f, 8, Color{101, 67, 33, 255});
-    DrawCylinder(branchPos2, 0.1f, 0.1f, 0.8f, 8, Color{101, 67, 33, 255});
-    DrawCylinder(branchPos3, 0.1f, 0.1f, 0.8f, 8, Color{101, 67, 33, 255});
+void TreeRenderComponent::submitImpostor(RenderQueue& queue, Vector3 origin, const Camera3D& camera) {
+    // Camera-facing foliage disc over a low-poly trunk
+    queue.submitCylinder(origin, config_.trunkRadius, config_.trunkRadius, config_.trunkHeight, RenderConstants::CYLINDER_SEGMENTS_LOW, Color{139, 69, 19, 255});
+
+    Vector3 forward = {camera.target.x - camera.position.x, camera.target.y - camera.position.y, camera.target.z - camera.position.z};
+    float len = std::sqrt(forward.x * forward.x + forward.y * forward.y + forward.z * forward.z);
+    if (len < 1e-5f) return;
+    const float thickness = 0.05f / len;
+    Vector3 centre = {origin.x, origin.y + config_.trunkHeight + 0.1f, origin.z};
+    Vector3 back = {centre.x + forward.x * thickness, centre.y + forward.y * thickness, centre.z + forward.z * thickness};
+    queue.submitCylinderEx(centre, back, config_.foliageRadius * 1.1f, config_.foliageRadius * 1.1f, 12, Color{40, 145, 40, 255});
+}
+
+BoundingBox TreeRenderComponent::getLocalBounds() const {
+    float r = std::max(config_.foliageRadius * 1.1f, config_.trunkRadius + 0.3f);
+    return {{-r, 0.0f, -r}, {r, config_.trunkHeight + 0.5f + config_.foliageRadius * 0.8f, r}};
 }
 
 TreePhysicsComponent::TreePhysicsComponent(float trunkRadius, float trunkHeight) : trunkRadius_(trunkRadius), trunkHeight_(trunkHeight) {}
@@ -243,9 +289,35 @@ CollisionBounds TreePhysicsComponent::getBounds() const {
     };
 }
 
-Tree::Tree(Vector3 pos, const TreeConfig& config) : config_(config) {
+Tree::Tree(Vector3 pos, const TreeConfig& config) : EnvironmentalObject(KIND), config_(config) {
     position = pos;
     collidable = true;  // Ensure collision is enabled for trees
     addComponent(std::make_unique<TreeRenderComponent>(config));
     addComponent(std::make_unique<TreePhysicsComponent>(config.trunkRadius, config.trunkHeight));
-}
\ No newline at end of file
+}
+
+// NPC anchor
+BoundingBox NpcAnchorRenderComponent::getLocalBounds() const {
+    // Matches the capsule checkNPCCollision uses
+    return {{-0.6f, 0.0f, -0.6f}, {0.6f, 2.0f, 0.6f}};
+}
+
+NpcAnchor::NpcAnchor(Vector3 pos, int npcIndex, int homeBuilding, float interactionRadius, std::string name)
+    : EnvironmentalObject(KIND), npcIndex_(npcIndex), homeBuilding_(homeBuilding),
+      interactionRadius_(interactionRadius), name_(std::move(name)) {
+    position = pos;
+    collidable = false;  // checkNPCCollision handles NPCs
+    addComponent(std::make_unique<NpcAnchorRenderComponent>());
+}
+
+// Combat target anchor
+BoundingBox TargetAnchorRenderComponent::getLocalBounds() const {
+    return {{-radius_, -radius_, -radius_}, {radius_, radius_, radius_}};
+}
+
+TargetAnchor::TargetAnchor(Vector3 pos, uint32_t slot, uint32_t generation, float radius)
+    : EnvironmentalObject(KIND), slot_(slot), generation_(generation), radius_(radius) {
+    position = pos;
+    collidable = false;  // Only swings test against targets
+    addComponent(std::make_unique<TargetAnchorRenderComponent>(radius));
+}
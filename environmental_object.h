@@ -4,39 +4,66 @@
 
 #include "raylib.h"
 #include "collision_system.h"  // For CollisionBounds
+#include "render_queue.h"      // For RenderQueue
+#include "ecs.h"               // For ComponentTypeId
 #include <string>
 #include <memory>
-#include <unordered_map>
 #include <vector>
-#include <mutex>
+
+/// \brief Render detail chosen per object from camera distance; CULLED objects are skipped.
+enum class DetailLevel { HIGH, MEDIUM, LOW, CULLED };
+
+/// \brief Concrete type of an EnvironmentalObject, so hot paths dispatch without RTTI.
+enum class ObjectKind : uint8_t { GENERIC, BUILDING, WELL, TREE, NPC, TARGET };
 
 class Component {
 public:
     virtual ~Component() = default;
     virtual void update([[maybe_unused]] float deltaTime) {}
     virtual std::string getTypeName() const = 0;
+    /// \brief Slot the component occupies on its owner; one per interface (render, physics).
+    virtual ecs::ComponentTypeId getTypeId() const = 0;
 };
 
 class RenderComponent : public Component {
 public:
-    virtual void render(const Camera3D& camera) = 0;
+    /// \brief Queues this component's draw items.
+    /// \param queue Frame render queue.
+    /// \param origin Owner's world position; submitted shapes are offset by it.
+    /// \param camera Camera (for view-dependent detail such as impostors).
+    /// \param detail Detail level to draw at.
+    virtual void submit(RenderQueue& queue, Vector3 origin, const Camera3D& camera, DetailLevel detail) = 0;
+    /// \brief Bounds of everything drawn, relative to the owner's position.
+    virtual BoundingBox getLocalBounds() const = 0;
     std::string getTypeName() const override { return "RenderComponent"; }
+    ecs::ComponentTypeId getTypeId() const override { return ecs::typeId<RenderComponent>(); }
 };
 
 class PhysicsComponent : public Component {
 public:
     virtual CollisionBounds getBounds() const = 0;
     std::string getTypeName() const override { return "PhysicsComponent"; }
+    ecs::ComponentTypeId getTypeId() const override { return ecs::typeId<PhysicsComponent>(); }
 };
 
 class EnvironmentalObject {
 public:
-    EnvironmentalObject() : components_() {}  // Explicitly initialize components map
+    EnvironmentalObject() = default;
+    explicit EnvironmentalObject(ObjectKind kind) : kind_(kind) {}
     virtual ~EnvironmentalObject() = default;
+
+    ObjectKind getKind() const { return kind_; }
+    /// \brief Adds a component, replacing any with the same type id.
     void addComponent(std::unique_ptr<Component> component);
-    Component* getComponent(const std::string& typeName) const;
+    /// \brief Gets the component registered under T's type id (e.g. RenderComponent), or nullptr.
+    template<typename T>
+    T* getComponent() const {
+        ecs::ComponentTypeId id = ecs::typeId<T>();
+        return id < components_.size() ? static_cast<T*>(components_[id].get()) : nullptr;
+    }
     void update(float deltaTime);
-    void render(const Camera3D& camera);
+    /// \brief Queues draw items at the current LOD for batched rendering.
+    void submit(RenderQueue& queue, const Camera3D& camera);
 
     Vector3 position;
     bool collidable = true;
@@ -46,21 +73,29 @@ public:
     virtual float getInteractionRadius() const { return 0.0f; }
     virtual CollisionBounds getCollisionBounds() const;
 
+    /// \brief World-space bounds of what the object draws, used for culling.
+    BoundingBox getRenderBounds() const;
+
+    void setLOD(DetailLevel level) { lod_ = level; }
+    DetailLevel getLOD() const { return lod_; }
+
 private:
-    std::unordered_map<std::string, std::unique_ptr<Component>> components_;
+    std::vector<std::unique_ptr<Component>> components_;  // Indexed by ecs::ComponentTypeId; mostly null
+    DetailLevel lod_ = DetailLevel::HIGH;
+    ObjectKind kind_ = ObjectKind::GENERIC;
 };
 
-// Object pooling
+/// \brief Tag-checked downcast; T names its tag as `static constexpr ObjectKind KIND`.
+/// \return obj as a T, or nullptr if it is something else.
 template<typename T>
-class ObjectPool {
-public:
-    std::unique_ptr<T> acquire();
-    void release(std::unique_ptr<T> object);
+T* objectCast(EnvironmentalObject* obj) {
+    return obj && obj->getKind() == T::KIND ? static_cast<T*>(obj) : nullptr;
+}
 
-private:
-    std::vector<std::unique_ptr<T>> pool_;
-    std::mutex poolMutex_;
-};
+template<typename T>
+const T* objectCast(const EnvironmentalObject* obj) {
+    return obj && obj->getKind() == T::KIND ? static_cast<const T*>(obj) : nullptr;
+}
 
 // Factory configs (based on current constructors)
 struct DoorConfig {
@@ -110,7 +145,8 @@ public:
 class BuildingRenderComponent : public RenderComponent {
 public:
     BuildingRenderComponent(const BuildingConfig& config);
-    void render(const Camera3D& camera) override;
+    void submit(RenderQueue& queue, Vector3 origin, const Camera3D& camera, DetailLevel detail) override;
+    BoundingBox getLocalBounds() const override;
 
 private:
     BuildingConfig config_;
@@ -128,6 +164,8 @@ private:
 
 class Building : public EnvironmentalObject {
 public:
+    static constexpr ObjectKind KIND = ObjectKind::BUILDING;
+
     Building(Vector3 pos, const BuildingConfig& config);
     virtual ~Building() = default;
 
@@ -137,6 +175,10 @@ public:
 
     int getId() const { return config_.id; }
     Vector3 getDoorPosition() const;
+    /// \brief Gets the doorway: the opening in the wall from the floor up to the door's height,
+    /// across its width. It is the portal between the interior cell and the exterior.
+    /// \param corners Receives the corners in order around the opening's edge.
+    void getDoorway(Vector3 corners[4]) const;
     Vector3 getSize() const { return config_.size; }
     Color getColor() const { return config_.color; }
     bool isPlayerAtDoor(Vector3 playerPos, float threshold = 3.0f) const;
@@ -153,7 +195,8 @@ private:
 class WellRenderComponent : public RenderComponent {
 public:
     WellRenderComponent(const WellConfig& config);
-    void render(const Camera3D& camera) override;
+    void submit(RenderQueue& queue, Vector3 origin, const Camera3D& camera, DetailLevel detail) override;
+    BoundingBox getLocalBounds() const override;
 
 private:
     WellConfig config_;
@@ -171,6 +214,8 @@ private:
 
 class Well : public EnvironmentalObject {
 public:
+    static constexpr ObjectKind KIND = ObjectKind::WELL;
+
     Well(Vector3 pos, const WellConfig& config);
     virtual ~Well() = default;
 
@@ -184,10 +229,12 @@ private:
 class TreeRenderComponent : public RenderComponent {
 public:
     TreeRenderComponent(const TreeConfig& config);
-    void render(const Camera3D& camera) override;
+    void submit(RenderQueue& queue, Vector3 origin, const Camera3D& camera, DetailLevel detail) override;
+    BoundingBox getLocalBounds() const override;
 
 private:
     TreeConfig config_;
+    void submitImpostor(RenderQueue& queue, Vector3 origin, const Camera3D& camera);
 };
 
 class TreePhysicsComponent : public PhysicsComponent {
@@ -202,6 +249,8 @@ private:
 
 class Tree : public EnvironmentalObject {
 public:
+    static constexpr ObjectKind KIND = ObjectKind::TREE;
+
     Tree(Vector3 pos, const TreeConfig& config);
     virtual ~Tree() = default;
 
@@ -211,4 +260,70 @@ private:
     TreeConfig config_;
 };
 
+// NPC stand-in: the NPC itself lives in NPCSystem and is drawn by RenderSystem; this only
+// puts it in the environment grid so interaction and NPC collision queries find it
+class NpcAnchorRenderComponent : public RenderComponent {
+public:
+    void submit([[maybe_unused]] RenderQueue& queue, [[maybe_unused]] Vector3 origin,
+                [[maybe_unused]] const Camera3D& camera, [[maybe_unused]] DetailLevel detail) override {}
+    BoundingBox getLocalBounds() const override;
+};
+
+class NpcAnchor : public EnvironmentalObject {
+public:
+    static constexpr ObjectKind KIND = ObjectKind::NPC;
+
+    /// \param npcIndex NPCSystem id. NPCSystem moves the anchor along with the NPC.
+    /// \param homeBuilding Id of the building the NPC stays in, or -1 for outdoors.
+    NpcAnchor(Vector3 pos, int npcIndex, int homeBuilding, float interactionRadius, std::string name);
+    virtual ~NpcAnchor() = default;
+
+    bool isInteractive() const override { return true; }
+    std::string getName() const override { return name_; }
+    float getInteractionRadius() const override { return interactionRadius_; }
+
+    int getNpcIndex() const { return npcIndex_; }
+    int getHomeBuilding() const { return homeBuilding_; }
+
+private:
+    int npcIndex_;
+    int homeBuilding_;
+    float interactionRadius_;
+    std::string name_;
+};
+
+// Combat target stand-in: the target lives in combat's pool and is drawn by renderCombat;
+// this only puts it in the environment grid so swing sweeps find it
+class TargetAnchorRenderComponent : public RenderComponent {
+public:
+    explicit TargetAnchorRenderComponent(float radius) : radius_(radius) {}
+    void submit([[maybe_unused]] RenderQueue& queue, [[maybe_unused]] Vector3 origin,
+                [[maybe_unused]] const Camera3D& camera, [[maybe_unused]] DetailLevel detail) override {}
+    BoundingBox getLocalBounds() const override;
+
+private:
+    float radius_;
+};
+
+class TargetAnchor : public EnvironmentalObject {
+public:
+    static constexpr ObjectKind KIND = ObjectKind::TARGET;
+
+    /// \param slot, generation The target's combat pool handle.
+    /// \param radius Hit sphere radius.
+    TargetAnchor(Vector3 pos, uint32_t slot, uint32_t generation, float radius);
+    virtual ~TargetAnchor() = default;
+
+    std::string getName() const override { return "Target"; }
+
+    uint32_t getSlot() const { return slot_; }
+    uint32_t getGeneration() const { return generation_; }
+    float getRadius() const { return radius_; }
+
+private:
+    uint32_t slot_;
+    uint32_t generation_;
+    float radius_;
+};
+
 #endif
\ No newline at end of file
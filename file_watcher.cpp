@@ -0,0 +1,161 @@
+// file_watcher.cpp
+#include "file_watcher.h"
+#include "constants.h"
+#include <algorithm>
+#include <iostream>
+#include <sys/stat.h>
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#define FILE_WATCH_INOTIFY 1
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+FileWatcher::~FileWatcher() {
+    stop();
+}
+
+void FileWatcher::watch(const std::string& path, Handler handler) {
+    if (running_.load(std::memory_order_relaxed)) {
+        std::cout << "HOT RELOAD: Cannot watch " << path << " after the watcher has started" << std::endl;
+        return;
+    }
+    Watch entry;
+    entry.path = path;
+    size_t slash = path.find_last_of('/');
+    entry.directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    entry.name = slash == std::string::npos ? path : path.substr(slash + 1);
+    entry.handler = std::move(handler);
+    entry.stamp = fileStamp(path);
+    watches_.push_back(std::move(entry));
+}
+
+bool FileWatcher::start() {
+    if (running_.load(std::memory_order_relaxed)) return true;
+    if (watches_.empty()) return false;
+
+#ifdef FILE_WATCH_INOTIFY
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ < 0) {
+        std::cout << "HOT RELOAD: inotify unavailable, hot reload disabled" << std::endl;
+        return false;
+    }
+    // Directories, not files: editors and the packers replace files, which would end a file watch
+    for (Watch& entry : watches_) {
+        entry.descriptor = inotify_add_watch(inotify_fd_, entry.directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (entry.descriptor < 0) {
+            std::cout << "HOT RELOAD: Cannot watch directory " << entry.directory << " for " << entry.name << std::endl;
+        }
+    }
+    running_.store(true, std::memory_order_relaxed);
+    thread_ = std::thread(&FileWatcher::watchLoop, this);
+#else
+    running_.store(true, std::memory_order_relaxed);
+    thread_ = std::thread(&FileWatcher::pollLoop, this);
+#endif
+    std::cout << "HOT RELOAD: Watching " << watches_.size() << " files" << std::endl;
+    return true;
+}
+
+void FileWatcher::stop() {
+    running_.store(false, std::memory_order_relaxed);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+#ifdef FILE_WATCH_INOTIFY
+    if (inotify_fd_ >= 0) {
+        ::close(inotify_fd_);
+        inotify_fd_ = -1;
+    }
+#endif
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.clear();
+}
+
+size_t FileWatcher::processChanges() {
+    ready_scratch_.clear();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_.empty()) return 0;
+        Clock::time_point settled = Clock::now() - std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<float>(HotReloadConstants::DEBOUNCE_SECONDS));
+        auto stillBusy = std::partition(pending_.begin(), pending_.end(),
+                                        [settled](const Change& change) { return change.last > settled; });
+        for (auto it = stillBusy; it != pending_.end(); ++it) {
+            ready_scratch_.push_back(it->watch);
+        }
+        pending_.erase(stillBusy, pending_.end());
+    }
+
+    // Outside the lock: handlers take as long as a reload takes
+    for (size_t index : ready_scratch_) {
+        const Watch& entry = watches_[index];
+        std::cout << "HOT RELOAD: " << entry.path << " changed" << std::endl;
+        entry.handler(entry.path);
+    }
+    return ready_scratch_.size();
+}
+
+void FileWatcher::markChanged(size_t watch) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Clock::time_point now = Clock::now();
+    for (Change& change : pending_) {
+        if (change.watch == watch) {
+            change.last = now;
+            return;
+        }
+    }
+    pending_.push_back({watch, now});
+}
+
+int64_t FileWatcher::fileStamp(const std::string& path) {
+    struct stat info;
+    if (::stat(path.c_str(), &info) != 0) return -1;
+    // Size folded in: coarse mtime granularity can hide a quick second save
+    return static_cast<int64_t>(info.st_mtime) * 1000003 + static_cast<int64_t>(info.st_size);
+}
+
+void FileWatcher::watchLoop() {
+#ifdef FILE_WATCH_INOTIFY
+    // Large enough for a burst of events with names; the kernel never splits one
+    alignas(struct inotify_event) char buffer[4096];
+    pollfd descriptor = {inotify_fd_, POLLIN, 0};
+    while (running_.load(std::memory_order_relaxed)) {
+        int ready = ::poll(&descriptor, 1, HotReloadConstants::WATCH_TIMEOUT_MS);
+        if (ready <= 0) continue;
+
+        ssize_t length;
+        while ((length = ::read(inotify_fd_, buffer, sizeof(buffer))) > 0) {
+            for (char* cursor = buffer; cursor < buffer + length;) {
+                const auto* event = reinterpret_cast<const struct inotify_event*>(cursor);
+                cursor += sizeof(struct inotify_event) + event->len;
+                if (event->len == 0) continue;
+                for (size_t i = 0; i < watches_.size(); ++i) {
+                    if (watches_[i].descriptor == event->wd && watches_[i].name == event->name) {
+                        markChanged(i);
+                    }
+                }
+            }
+        }
+    }
+#endif
+}
+
+void FileWatcher::pollLoop() {
+    int waitedMs = 0;
+    while (running_.load(std::memory_order_relaxed)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(HotReloadConstants::WATCH_TIMEOUT_MS));
+        waitedMs += HotReloadConstants::WATCH_TIMEOUT_MS;
+        if (waitedMs < HotReloadConstants::POLL_INTERVAL_MS) continue;
+        waitedMs = 0;
+
+        for (size_t i = 0; i < watches_.size(); ++i) {
+            int64_t stamp = fileStamp(watches_[i].path);
+            if (stamp != watches_[i].stamp) {
+                watches_[i].stamp = stamp;
+                if (stamp >= 0) markChanged(i);
+            }
+        }
+    }
+}
@@ -0,0 +1,82 @@
+// file_watcher.h - Watches data files on a background thread and reloads them at frame boundaries
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// \brief Notices edits to registered files and runs their reload handlers on the main thread.
+///
+/// The watcher thread only records which files changed and when. processChanges(), called
+/// once per frame between simulation and rendering, runs the handlers for files that have
+/// been quiet for HotReloadConstants::DEBOUNCE_SECONDS, so an editor's save (often a
+/// truncate, several writes and a rename) is reloaded once, after it has finished, and no
+/// subsystem is patched halfway through a frame.
+///
+/// Linux uses inotify on each file's directory, which also sees files replaced by rename
+/// and files that don't exist yet. Other platforms poll modification times.
+class FileWatcher {
+public:
+    using Handler = std::function<void(const std::string& path)>;
+    using Clock = std::chrono::steady_clock;
+
+    FileWatcher() = default;
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /// \brief Registers a file. Call before start().
+    /// \param path File to watch; it may not exist yet.
+    /// \param handler Runs on the main thread, from processChanges(), after the file changes.
+    void watch(const std::string& path, Handler handler);
+
+    /// \brief Starts the watcher thread.
+    /// \return False if nothing is registered or the OS watch can't be set up.
+    bool start();
+
+    /// \brief Stops and joins the watcher thread. Pending changes are dropped.
+    void stop();
+
+    bool isRunning() const { return running_.load(std::memory_order_relaxed); }
+
+    /// \brief Runs the handlers of files whose changes have settled. Main thread only.
+    /// \return Number of handlers run.
+    size_t processChanges();
+
+private:
+    struct Watch {
+        std::string path;
+        std::string directory;      // Parent directory, "." for bare names
+        std::string name;           // File name within the directory
+        Handler handler;
+        int descriptor = -1;        // inotify watch on the directory
+        int64_t stamp = -1;         // Polling: last modification time and size seen, -1 if missing
+    };
+
+    struct Change {
+        size_t watch;
+        Clock::time_point last;     // Most recent event; the handler waits until this is old enough
+    };
+
+    void watchLoop();
+    void pollLoop();
+    void markChanged(size_t watch);
+    static int64_t fileStamp(const std::string& path);
+
+    std::vector<Watch> watches_;    // Fixed once started
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    int inotify_fd_ = -1;
+
+    std::mutex mutex_;              // Guards pending_
+    std::vector<Change> pending_;
+    std::vector<size_t> ready_scratch_;
+};
+
+#endif // FILE_WATCHER_H
@@ -0,0 +1,139 @@
+// frame_arena.cpp
+#include "frame_arena.h"
+#include "memory_tracker.h"
+#include "constants.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    std::pmr::memory_resource* upstream() {
+        return MemoryTracker::getInstance().getResource(MemoryTag::UI);
+    }
+
+    size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+FrameArena::~FrameArena() {
+    releaseBlocks();
+}
+
+void FrameArena::reset() {
+    size_t used = getUsedBytes();
+    peak_bytes_ = std::max(peak_bytes_, used);
+
+    // Overflowed into a chain: swap it for one block that holds a whole frame like this one
+    if (first_ && first_->next) {
+        size_t size = capacity_;
+        releaseBlocks();
+        addBlock(size);
+    }
+    current_ = first_;
+    offset_ = 0;
+    used_before_current_ = 0;
+}
+
+int FrameArena::getBlockCount() const {
+    int count = 0;
+    for (Block* b = first_; b; b = b->next) count++;
+    return count;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment) {
+    if (current_) {
+        size_t start = alignUp(offset_, alignment);
+        if (start + bytes <= current_->size) {
+            offset_ = start + bytes;
+            return data(current_) + start;
+        }
+        // Later blocks survive from before a reset that didn't collapse the chain
+        while (current_->next) {
+            used_before_current_ += offset_;
+            current_ = current_->next;
+            offset_ = 0;
+            if (bytes <= current_->size) {
+                offset_ = bytes;
+                return data(current_);
+            }
+        }
+        used_before_current_ += offset_;
+    }
+
+    current_ = addBlock(bytes + alignment);
+    offset_ = bytes;
+    return data(current_);
+}
+
+FrameArena::Block* FrameArena::addBlock(size_t minimum) {
+    size_t size = std::max(minimum, static_cast<size_t>(MemoryConstants::FRAME_ARENA_BLOCK_SIZE));
+    size = alignUp(size, alignof(std::max_align_t));
+    Block* block = static_cast<Block*>(upstream()->allocate(sizeof(Block) + size, alignof(std::max_align_t)));
+    block->next = nullptr;
+    block->size = size;
+    capacity_ += size;
+
+    if (!first_) {
+        first_ = block;
+    } else {
+        Block* tail = first_;
+        while (tail->next) tail = tail->next;
+        tail->next = block;
+    }
+    return block;
+}
+
+void FrameArena::releaseBlocks() {
+    Block* b = first_;
+    while (b) {
+        Block* next = b->next;
+        upstream()->deallocate(b, sizeof(Block) + b->size, alignof(std::max_align_t));
+        b = next;
+    }
+    first_ = current_ = nullptr;
+    offset_ = used_before_current_ = capacity_ = 0;
+}
+
+const char* FrameArena::format(const char* fmt, ...) {
+    char stack[256];
+    va_list args;
+    va_start(args, fmt);
+    int length = std::vsnprintf(stack, sizeof(stack), fmt, args);
+    va_end(args);
+    if (length < 0) return "";
+    if (static_cast<size_t>(length) < sizeof(stack)) return copy(stack, length);
+
+    char* out = static_cast<char*>(allocate(length + 1, 1));
+    va_start(args, fmt);
+    std::vsnprintf(out, length + 1, fmt, args);
+    va_end(args);
+    return out;
+}
+
+const char* FrameArena::copy(const char* text, size_t length) {
+    char* out = static_cast<char*>(allocate(length + 1, 1));
+    std::memcpy(out, text, length);
+    out[length] = '\0';
+    return out;
+}
+
+void appendFormat(FrameString& out, const char* fmt, ...) {
+    char stack[256];
+    va_list args;
+    va_start(args, fmt);
+    int length = std::vsnprintf(stack, sizeof(stack), fmt, args);
+    va_end(args);
+    if (length <= 0) return;
+    if (static_cast<size_t>(length) < sizeof(stack)) {
+        out.append(stack, length);
+        return;
+    }
+
+    size_t start = out.size();
+    out.resize(start + length);
+    va_start(args, fmt);
+    std::vsnprintf(&out[start], length + 1, fmt, args);
+    va_end(args);
+}
@@ -0,0 +1,89 @@
+// frame_arena.h - Per-frame bump allocator for transient UI and render strings
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+/// \brief Linear allocator whose contents live until the end of the current frame.
+///
+/// Allocation bumps a pointer through a chain of blocks taken from the UI memory resource;
+/// deallocation is a no-op and reset(), called by RenderSystem right after EndDrawing(),
+/// rewinds everything at once. When a frame overflows its first block the chain is replaced
+/// by one block covering the whole frame, so steady-state frames never touch the heap.
+///
+/// Main thread only: the worker jobs never build display text.
+class FrameArena : public std::pmr::memory_resource {
+public:
+    static FrameArena& getInstance() {
+        static FrameArena instance;
+        return instance;
+    }
+
+    /// \brief Releases everything allocated this frame. Pointers into the arena dangle afterwards.
+    void reset();
+
+    /// \brief printf into the arena; the result is valid until the next reset().
+    const char* format(const char* fmt, ...)
+#if defined(__GNUC__)
+        __attribute__((format(printf, 2, 3)))
+#endif
+        ;
+
+    /// \brief Copies a string into the arena, null-terminated.
+    const char* copy(const char* text, size_t length);
+
+    size_t getUsedBytes() const { return used_before_current_ + offset_; }
+    size_t getPeakBytes() const { return peak_bytes_; }
+    size_t getCapacity() const { return capacity_; }
+    int getBlockCount() const;
+
+private:
+    struct Block {
+        Block* next;
+        size_t size;        // Usable bytes after the header
+    };
+
+    FrameArena() = default;
+    ~FrameArena() override;
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    Block* addBlock(size_t minimum);
+    void releaseBlocks();
+    static char* data(Block* block) { return reinterpret_cast<char*>(block + 1); }
+
+    Block* first_ = nullptr;
+    Block* current_ = nullptr;
+    size_t offset_ = 0;                 // Bytes used in current_
+    size_t used_before_current_ = 0;    // Bytes used in the blocks ahead of current_
+    size_t capacity_ = 0;
+    size_t peak_bytes_ = 0;
+};
+
+/// \brief String whose buffer lives in the frame arena. Build, draw, drop; never keep past the frame.
+using FrameString = std::pmr::string;
+
+/// \brief Vector whose storage lives in the frame arena.
+template <typename T>
+using FrameVector = std::pmr::vector<T>;
+
+inline FrameString makeFrameString() { return FrameString(&FrameArena::getInstance()); }
+
+template <typename T>
+FrameVector<T> makeFrameVector() { return FrameVector<T>(&FrameArena::getInstance()); }
+
+/// \brief printf onto the end of a string, growing it in its own allocator.
+void appendFormat(FrameString& out, const char* fmt, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+#endif // FRAME_ARENA_H
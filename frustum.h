@@ -0,0 +1,154 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include "raylib.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief View frustum as six inward-facing planes, built from a perspective Camera3D.
+ *
+ * A point p is inside a plane when dot(normal, p) + distance >= 0.
+ */
+struct Frustum {
+    struct Plane {
+        Vector3 normal;
+        float distance;
+    };
+
+    Plane planes[6];
+    BoundingBox bounds;  // AABB of the eight corners, for broadphase queries
+
+    /**
+     * @brief Builds the frustum for a perspective camera.
+     * @param camera Camera (fovy is the vertical field of view in degrees)
+     * @param aspect Viewport width / height
+     * @param nearPlane Near clip distance
+     * @param farPlane Far clip distance
+     */
+    static Frustum fromCamera(const Camera3D& camera, float aspect, float nearPlane, float farPlane) {
+        Vector3 f = normalize(sub(camera.target, camera.position));
+        Vector3 r = normalize(cross(f, camera.up));
+        Vector3 u = cross(r, f);
+
+        float h = std::tan(camera.fovy * DEG2RAD * 0.5f);
+        float w = h * aspect;
+        const Vector3& eye = camera.position;
+
+        Frustum fr;
+        fr.planes[0] = makePlane(normalize(cross(sub(f, scale(r, w)), u)), eye);   // Left
+        fr.planes[1] = makePlane(normalize(cross(u, add(f, scale(r, w)))), eye);   // Right
+        fr.planes[2] = makePlane(normalize(cross(add(f, scale(u, h)), r)), eye);   // Top
+        fr.planes[3] = makePlane(normalize(cross(r, sub(f, scale(u, h)))), eye);   // Bottom
+        fr.planes[4] = makePlane(f, add(eye, scale(f, nearPlane)));               // Near
+        fr.planes[5] = makePlane(scale(f, -1.0f), add(eye, scale(f, farPlane)));  // Far
+
+        // Far-plane corners plus the eye bound the whole volume
+        Vector3 farCentre = add(eye, scale(f, farPlane));
+        Vector3 fu = scale(u, h * farPlane), fw = scale(r, w * farPlane);
+        Vector3 corners[5] = {eye, add(add(farCentre, fu), fw), add(sub(farCentre, fu), fw),
+                              sub(add(farCentre, fu), fw), sub(sub(farCentre, fu), fw)};
+        fr.bounds = {corners[0], corners[0]};
+        for (const Vector3& c : corners) {
+            fr.bounds.min = {std::min(fr.bounds.min.x, c.x), std::min(fr.bounds.min.y, c.y), std::min(fr.bounds.min.z, c.z)};
+            fr.bounds.max = {std::max(fr.bounds.max.x, c.x), std::max(fr.bounds.max.y, c.y), std::max(fr.bounds.max.z, c.z)};
+        }
+        return fr;
+    }
+
+    /**
+     * @brief Narrows a view to what can be seen through a convex four-sided opening.
+     *
+     * The four side planes pass through the eye and the opening's edges, the opening itself
+     * becomes the near plane (so nothing on the eye's side of it passes) and the view's far
+     * plane is kept. Test boxes against both this and the view frustum.
+     * @param view Camera frustum
+     * @param eye Camera position
+     * @param corners Opening corners, in order around its edge
+     * @param out Receives the portal frustum
+     * @return False if the eye is too close to the opening's plane for the planes to be stable
+     */
+    static bool throughPortal(const Frustum& view, Vector3 eye, const Vector3 corners[4], Frustum& out) {
+        Vector3 centre = scale(add(add(corners[0], corners[1]), add(corners[2], corners[3])), 0.25f);
+        Vector3 n = normalize(cross(sub(corners[1], corners[0]), sub(corners[3], corners[0])));
+        float eyeDistance = dot(n, sub(centre, eye));
+        if (std::fabs(eyeDistance) < PORTAL_MIN_DISTANCE) return false;
+        if (eyeDistance < 0.0f) n = scale(n, -1.0f);
+
+        for (int i = 0; i < 4; ++i) {
+            Vector3 edge = normalize(cross(sub(corners[i], eye), sub(corners[(i + 1) % 4], eye)));
+            Plane p = makePlane(edge, eye);
+            if (dot(p.normal, centre) + p.distance < 0.0f) p = {scale(edge, -1.0f), -p.distance};
+            out.planes[i] = p;
+        }
+        out.planes[4] = makePlane(n, centre);
+        out.planes[5] = view.planes[5];
+
+        // Corners pushed out along their rays to the far plane bound the volume; clamp to the view
+        Vector3 forward = scale(view.planes[5].normal, -1.0f);
+        float farDistance = dot(view.planes[5].normal, eye) + view.planes[5].distance;
+        out.bounds = {corners[0], corners[0]};
+        for (int i = 0; i < 4; ++i) {
+            Vector3 ray = sub(corners[i], eye);
+            float along = dot(forward, ray);
+            Vector3 far = along > 0.0f ? add(eye, scale(ray, farDistance / along)) : corners[i];
+            if (along <= 0.0f) out.bounds = view.bounds;  // Ray never reaches the far plane
+            grow(out.bounds, corners[i]);
+            grow(out.bounds, far);
+        }
+        out.bounds.min = {std::max(out.bounds.min.x, view.bounds.min.x), std::max(out.bounds.min.y, view.bounds.min.y),
+                          std::max(out.bounds.min.z, view.bounds.min.z)};
+        out.bounds.max = {std::min(out.bounds.max.x, view.bounds.max.x), std::min(out.bounds.max.y, view.bounds.max.y),
+                          std::min(out.bounds.max.z, view.bounds.max.z)};
+        return true;
+    }
+
+    /**
+     * @brief Whether bounds is empty, as a portal frustum's can be once clamped to the view.
+     */
+    bool isEmpty() const {
+        return bounds.min.x > bounds.max.x || bounds.min.y > bounds.max.y || bounds.min.z > bounds.max.z;
+    }
+
+    /**
+     * @brief Conservative box test: false only when the box is fully outside one plane.
+     * @param box World-space AABB
+     * @return True if the box may be visible
+     */
+    bool intersects(const BoundingBox& box) const {
+        for (const Plane& p : planes) {
+            // Corner furthest along the plane normal
+            Vector3 v = {p.normal.x >= 0 ? box.max.x : box.min.x,
+                         p.normal.y >= 0 ? box.max.y : box.min.y,
+                         p.normal.z >= 0 ? box.max.z : box.min.z};
+            if (p.normal.x * v.x + p.normal.y * v.y + p.normal.z * v.z + p.distance < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    static constexpr float PORTAL_MIN_DISTANCE = 0.05f;
+
+    static Plane makePlane(Vector3 n, Vector3 point) {
+        return {n, -(n.x * point.x + n.y * point.y + n.z * point.z)};
+    }
+    static Vector3 add(Vector3 a, Vector3 b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+    static Vector3 sub(Vector3 a, Vector3 b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+    static Vector3 scale(Vector3 a, float s) { return {a.x * s, a.y * s, a.z * s}; }
+    static Vector3 cross(Vector3 a, Vector3 b) {
+        return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+    }
+    static float dot(Vector3 a, Vector3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    static void grow(BoundingBox& box, Vector3 p) {
+        box.min = {std::min(box.min.x, p.x), std::min(box.min.y, p.y), std::min(box.min.z, p.z)};
+        box.max = {std::max(box.max.x, p.x), std::max(box.max.y, p.y), std::max(box.max.z, p.z)};
+    }
+    static Vector3 normalize(Vector3 a) {
+        float len = std::sqrt(a.x * a.x + a.y * a.y + a.z * a.z);
+        return len > 0.0f ? scale(a, 1.0f / len) : a;
+    }
+};
+
+#endif // FRUSTUM_H
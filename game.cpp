@@ -13,6 +13,17 @@
 #include "constants.h"   // For constants like PlayerConstants, EnvironmentConstants
 #include "menu_system.h"  // For MenuSystem
 #include "render_system.h"  // For RenderSystem
+#include "ecs_components.h"  // For TransformComponent, VelocityComponent, PlayerTag
+#include "ui_notification.h"  // For NotificationManager
+#include "ui_animation.h"  // For AnimationManager
+#include "ui_audio.h"  // For AudioManager
+#include "spatial_audio.h"  // For SpatialAudio
+#include "profiler.h"  // For Profiler, PROFILE_SCOPE
+#include "save_writer.h"  // For SaveWriter
+#include "particle_system.h"  // For ParticleSystem
+#include "async_log.h"  // For BW_LOG
+#include "memory_tracker.h"  // For MemoryTagScope
+#include "asset_cache.h"  // For AssetCache
 
 #include <iostream>
 #include <vector>
@@ -20,17 +31,9 @@
 #include <string>
 #include <stdexcept>
 #include <unordered_map>
-
-void Entity::addComponent(std::unique_ptr<Component> component) {
-    if (component) {
-        components_[component->getTypeName()] = std::move(component);
-    }
-}
-
-Component* Entity::getComponent(const std::string& typeName) const {
-    auto it = components_.find(typeName);
-    return (it != components_.end()) ? it->second.get() : nullptr;
-}
+#include <chrono>
+#include <cmath>
+#include <algorithm>
 
 Game::Game() {
     // Default constructor - initialization in Init()
@@ -40,16 +43,60 @@ Game::~Game() {
     Shutdown();
 }
 
-int Game::Run() {
+int Game::Run(const InputCaptureOptions& capture) {
     try {
+        inputCapture_ = capture;
         Init();
 
+        // NPC update rates are simulation state, so a recorded session must replay at the rate it was recorded
+        bool scaleQuality = !enhancedInput_->isRecording() && !enhancedInput_->isReplaying();
+        qualityScaler_.setTargetFrameTime(config_.targetFPS > 0 ? 1.0f / config_.targetFPS : AdvancedFrameStats::TARGET_FRAME_TIME);
+
+        // Fixed-step simulation: render as often as the display allows, simulate at a constant rate
+        float accumulator = 0.0f;
         while (!shouldClose_ && !state_.shouldClose) {
-            float deltaTime = GetFrameTime();
-            Update(deltaTime);
-            // Re-enable render but with empty function to test
+            Profiler::getInstance().beginFrame();
+            RawMouseSampler::Clock::time_point frameStart = RawMouseSampler::Clock::now();
+            float frameTime = GetFrameTime();
+            performanceMonitor_.update(frameTime);
+            if (scaleQuality && qualityScaler_.update(frameTime)) {
+                ApplyQuality();
+            }
+
+            // A replay advances by its recorded deltas so the session reproduces regardless of render rate
+            float simulatedTime = enhancedInput_->isReplaying() ? enhancedInput_->getReplayDeltaTime() : frameTime;
+            accumulator += std::min(simulatedTime, SimulationConstants::MAX_FRAME_TIME);
+            enhancedInput_->poll();
+
+            int steps = 0;
+            while (accumulator >= SimulationConstants::FIXED_DELTA_TIME && steps < SimulationConstants::MAX_STEPS_PER_FRAME) {
+                previousCameraPosition_ = camera_.position;
+                // Steps trail the wall clock by what stays in the accumulator; raw mouse motion
+                // is cut off at this step's end so each step looks with its own share
+                float stepEndLag = accumulator - SimulationConstants::FIXED_DELTA_TIME;
+                enhancedInput_->setMouseSampleTime(frameStart - std::chrono::duration_cast<RawMouseSampler::Clock::duration>(
+                    std::chrono::duration<float>(stepEndLag)));
+                Update(SimulationConstants::FIXED_DELTA_TIME);
+                state_.publishSimulation();
+                accumulator -= SimulationConstants::FIXED_DELTA_TIME;
+                steps++;
+            }
+            if (accumulator >= SimulationConstants::FIXED_DELTA_TIME) {
+                // Too far behind to catch up: let the game slow down rather than spiral
+                accumulator = std::fmod(accumulator, SimulationConstants::FIXED_DELTA_TIME);
+            }
+
+            // Between steps and drawing, so no system sees data change mid-frame and the
+            // UI hears about this frame's state changes before it draws
+            fileWatcher_.processChanges();
+            state_.dispatchChanges();
+
+            renderAlpha_ = accumulator / SimulationConstants::FIXED_DELTA_TIME;
             Render();
             frameCounter_++;
+            if (telemetry_.isRunning() && frameCounter_ % TelemetryConstants::SAMPLE_INTERVAL_FRAMES == 0) {
+                SampleTelemetry();
+            }
         }
 
         Shutdown();
@@ -66,12 +113,105 @@ int Game::Run() {
     }
 }
 
+int Game::RunBenchmark(const BenchmarkOptions& options) {
+    try {
+        benchmarkMode_ = true;
+        inputCapture_.replayPath = options.replayPath;
+        townScale_ = options.townScale;
+        townSeed_ = options.townSeed;
+        Init();
+        bool replaying = enhancedInput_->isReplaying();
+        populateBenchmarkProps(*environment_, options.objectScale);
+
+        std::vector<Vector3> path = buildBenchmarkPath(*environment_);
+        std::vector<float> distances(path.size(), 0.0f);  // Cumulative length at each waypoint
+        for (size_t i = 1; i < path.size(); ++i) {
+            distances[i] = distances[i - 1] + MathUtils::distance3D(path[i - 1], path[i]);
+        }
+        float pathLength = distances.empty() ? 0.0f : distances.back();
+
+        // Places the camera at `travelled` units along the (looping) path, facing along it
+        auto placeCamera = [&](float travelled) {
+            if (pathLength <= 0.0f) return;
+            float d = std::fmod(travelled, pathLength);
+            size_t seg = 1;
+            while (seg + 1 < path.size() && distances[seg] < d) ++seg;
+            float segLength = distances[seg] - distances[seg - 1];
+            float t = segLength > 0.0f ? (d - distances[seg - 1]) / segLength : 0.0f;
+            const Vector3& a = path[seg - 1];
+            const Vector3& b = path[seg];
+            camera_.position = {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t};
+            if (segLength > 0.0f) {
+                camera_.target = {camera_.position.x + (b.x - a.x) / segLength, camera_.position.y,
+                                  camera_.position.z + (b.z - a.z) / segLength};
+            }
+        };
+
+        std::cout << "BENCH: " << options.frames << " frames, " << environment_->getAllObjects().size() << " objects, "
+                  << path.size() << " waypoints (" << pathLength << " units)" << std::endl;
+
+        using Clock = std::chrono::steady_clock;
+        Clock::time_point last = Clock::now();
+        for (int frame = 0; frame < options.frames; ++frame) {
+            Profiler::getInstance().beginFrame();
+
+            if (replaying) {
+                if (!enhancedInput_->isReplaying()) break;  // Recording exhausted
+                float deltaTime = enhancedInput_->getReplayDeltaTime();
+                HandleInput(deltaTime);
+                UpdateSystems(deltaTime);
+                state_.publishSimulation();
+            } else {
+                float travelled = frame * options.fixedDeltaTime * options.cameraSpeed;
+                placeCamera(travelled);
+                UpdateSystems(options.fixedDeltaTime);
+                placeCamera(travelled);  // Player physics may have nudged it; the script wins
+                state_.publishSimulation();
+            }
+            state_.dispatchChanges();
+            Render();
+            frameCounter_++;
+
+            // Wall time of the whole frame, independent of the fixed simulation step
+            Clock::time_point now = Clock::now();
+            performanceMonitor_.update(std::chrono::duration<float>(now - last).count());
+            last = now;
+        }
+
+        bool written = performanceMonitor_.exportJson(options.outputPath, {
+            {"fixed_dt", options.fixedDeltaTime},
+            {"object_scale", static_cast<double>(options.objectScale)},
+            {"object_count", static_cast<double>(environment_->getAllObjects().size())},
+            {"town_scale", static_cast<double>(options.townScale)},
+            {"town_seed", static_cast<double>(options.townSeed)},
+            {"path_length", pathLength},
+            {"replay", replaying ? 1.0 : 0.0}
+        });
+        std::cout << "BENCH: " << performanceMonitor_.getReport() << std::endl;
+        std::cout << "BENCH: Results " << (written ? "written to " : "NOT written to ") << options.outputPath << std::endl;
+
+        Shutdown();
+        return written ? EXIT_SUCCESS : EXIT_FAILURE;
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error during benchmark: " << e.what() << std::endl;
+        Shutdown();
+        return EXIT_FAILURE;
+    }
+}
+
 void Game::Init() {
     std::cout << "Starting Browserwind game initialization..." << std::endl;
+    AsyncLog::getInstance().start(LogConstants::LOG_PATH, LogConstants::DEFAULT_LEVEL);
 
     InitWindowAndConfig();
     InitSystems();
+
+    // Before the world, so town generation can fan out over the workers
+    JobSystem::getInstance().start();
     InitWorldAndEntities();
+    BuildUpdateGraph();
+    InitHotReload();
+    InitTelemetry();
 
     std::cout << "All systems initialized successfully!" << std::endl;
 }
@@ -83,7 +223,7 @@ void Game::InitWindowAndConfig() {
     std::cout << "Display size: " << displayWidth << "x" << displayHeight << std::endl;
 
     // Load configuration with fallback
-    config_ = loadConfig("config.ini");
+    config_ = loadConfig(HotReloadConstants::CONFIG_PATH);
 
     // Mac Retina display fix: Ensure window size doesn't exceed display
     if (config_.windowWidth > displayWidth || config_.windowHeight > displayHeight) {
@@ -104,8 +244,12 @@ void Game::InitWindowAndConfig() {
     // ===== WINDOW INITIALIZATION WITH MAC FIXES =====
     std::cout << "Initializing window with Mac-specific fixes..." << std::endl;
 
-    // Set window flags for better Mac compatibility
-    SetConfigFlags(FLAG_WINDOW_RESIZABLE | FLAG_VSYNC_HINT);
+    // Set window flags for better Mac compatibility; benchmarks render unthrottled and unseen
+    if (benchmarkMode_) {
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    } else {
+        SetConfigFlags(FLAG_WINDOW_RESIZABLE | FLAG_VSYNC_HINT);
+    }
 
     InitWindow(config_.windowWidth, config_.windowHeight, config_.windowTitle.c_str());
 
@@ -124,6 +268,11 @@ void Game::InitWindowAndConfig() {
 
     std::cout << "Window initialized successfully" << std::endl;
 
+    if (benchmarkMode_) {
+        SetTargetFPS(0);
+        return;
+    }
+
     // Additional Mac-specific window management
     MaximizeWindow();  // Maximize to ensure visibility
     SetWindowState(FLAG_WINDOW_TOPMOST);  // Keep on top temporarily
@@ -153,6 +302,25 @@ void Game::InitWindowAndConfig() {
     // Set target FPS
     SetTargetFPS(config_.targetFPS);
     std::cout << "Target FPS set to " << config_.targetFPS << std::endl;
+    ApplyAssetBudget();
+}
+
+void Game::ApplyQuality() {
+    const QualitySettings& quality = qualityScaler_.getSettings();
+    if (environment_) {
+        environment_->setDrawDistances(quality.lodDistance, quality.cullDistance);
+    }
+    ParticleSystem::getInstance().setBudget(quality.particleBudget);
+    NPCSystem::getInstance().setUpdateIntervalScale(quality.npcIntervalScale);
+    if (g_uiSystem) {
+        g_uiSystem->setPanelRefreshInterval(quality.uiRefreshInterval);
+    }
+}
+
+void Game::ApplyAssetBudget() {
+    constexpr uint64_t MB = 1024ull * 1024ull;
+    AssetCache::getInstance().setBudget(static_cast<uint64_t>(std::max(config_.assetGpuBudgetMB, 0)) * MB,
+                                        static_cast<uint64_t>(std::max(config_.assetCpuBudgetMB, 0)) * MB);
 }
 
 void Game::InitSystems() {
@@ -172,17 +340,30 @@ void Game::InitSystems() {
     input_->setMouseCaptured(true);  // Capture mouse for first-person camera
     enhancedInput_ = std::make_unique<EnhancedInputManager>();
     enhancedInput_->setMouseCaptured(true);  // Enhanced input
+    if (!inputCapture_.replayPath.empty()) {
+        enhancedInput_->startReplay(inputCapture_.replayPath);
+    }
+    if (!inputCapture_.recordPath.empty()) {
+        enhancedInput_->startRecording(inputCapture_.recordPath);
+    }
+    if (!inputCapture_.rawMouseDevice.empty()) {
+        enhancedInput_->startRawMouse(inputCapture_.rawMouseDevice);
+    }
     std::cout << "Input manager setup complete - mouse captured for FPS controls" << std::endl;
 
     // Central game state
     std::cout << "Initializing game state..." << std::endl;
-    state_.lastCameraPos = camera_.position;
+    state_.player.lastCameraPos = camera_.position;
+    previousCameraPosition_ = camera_.position;
     std::cout << "Game state initialized" << std::endl;
 
     // Initialize inventory system
     std::cout << "Initializing inventory system..." << std::endl;
-    inventorySystem_ = std::make_unique<InventorySystem>(150.0f, 60);  // 150kg capacity, 60 slots
-    inventorySystem_->addStartingItems();  // Add basic starting gear
+    {
+        MemoryTagScope memoryTag(MemoryTag::INVENTORY);
+        inventorySystem_ = std::make_unique<InventorySystem>(150.0f, 60);  // 150kg capacity, 60 slots
+        inventorySystem_->addStartingItems();  // Add basic starting gear
+    }
     state_.inventorySystem = inventorySystem_.get();  // Raw pointer link (consider weak_ptr in future)
     std::cout << "Inventory system initialized with starting gear" << std::endl;
 
@@ -196,11 +377,16 @@ void Game::InitSystems() {
 
     // Initialize RenderSystem
     renderSystem_ = std::make_unique<RenderSystem>(state_, *environment_, performanceStats_);
+    renderSystem_->setUITimer(&performanceMonitor_.getStats().ui_timer_);
 
     // Add a state change listener (for demo, logs to console)
     std::cout << "Adding state change listener..." << std::endl;
-    state_.addChangeListener([](const std::string& property) {
-        std::cout << "State changed: " << property << std::endl;
+    state_.addChangeListener(StateChange::ALL, [](StateChangeMask changed) {
+        for (int bit = 0; bit < StateChange::PROPERTY_COUNT; ++bit) {
+            if (changed & (1u << bit)) {
+                std::cout << "State changed: " << StateChange::getName(static_cast<StateChange::Property>(1u << bit)) << std::endl;
+            }
+        }
     });
 
     // Validate state
@@ -210,43 +396,180 @@ void Game::InitSystems() {
     std::cout << "Performance monitoring system initialized" << std::endl;
 
     // **UI SYSTEM**: Initialize organized UI management
-    initializeUISystem();
+    {
+        MemoryTagScope memoryTag(MemoryTag::UI);
+        initializeUISystem();
+    }
+    state_.addChangeListener(UIPanelCache::DEPENDENCY_MASK, [](StateChangeMask changed) {
+        if (g_uiSystem) g_uiSystem->onStateChanged(changed);  // Cached panels redraw only on change
+    });
     std::cout << "UI system initialized successfully" << std::endl;
+
+    // Opens the audio device; world sounds share it
+    {
+        MemoryTagScope memoryTag(MemoryTag::AUDIO);
+        UIAudio::initializeUIAudio();
+        SpatialAudio::getInstance().initialize();
+    }
 }
 
 void Game::InitWorldAndEntities() {
     // EnvironmentManager is now created in Init(), so we just initialize the world
     std::cout << "Initializing world..." << std::endl;
-    initializeWorld(*environment_);
+    {
+        MemoryTagScope memoryTag(MemoryTag::ENVIRONMENT);
+        initializeWorld(*environment_);
+        worldStreamer_ = std::make_unique<WorldStreamer>();
+        if (townScale_ > 0) {
+            TownOptions town;
+            town.seed = townSeed_;
+            town.objectCount = static_cast<size_t>(townScale_) * getDefaultWorldObjectCount(*environment_);
+            registerGeneratedTown(*worldStreamer_, town);
+        } else {
+            registerStreamedWorld(*worldStreamer_);
+        }
+        if (FileExists(EnvironmentConstants::WORLD_PACK_PATH)) {
+            loadWorldPack(EnvironmentConstants::WORLD_PACK_PATH, *environment_, *worldStreamer_, &worldPack_);
+        }
+    }
     std::cout << "World initialized successfully" << std::endl;
 
+    // Ambient dust around the wells; combat adds its own emitters per swing
+    ParticleSystem& particles = ParticleSystem::getInstance();
+    particles.clear();
+    for (const Well* well : environment_->getWells()) {
+        particles.createEmitter(ParticleType::DUST, {well->position.x, well->position.y + 0.5f, well->position.z},
+                                ParticleConstants::WELL_DUST_RATE);
+    }
+
     // ===== PHASE 2: RE-ENABLE COMBAT SYSTEM =====
     std::cout << "Initializing combat system..." << std::endl;
-    initCombat();
+    initCombat(*environment_);
     std::cout << "Combat system initialized successfully" << std::endl;
 
     // ===== PHASE 3: RE-ENABLE NPC SYSTEM =====
     std::cout << "Initializing NPCs..." << std::endl;
     initNPCs();
+    NPCSystem::getInstance().spawnTownsfolk(*environment_, NPCConstants::TOWNSFOLK_COUNT);
+    NPCSystem::getInstance().attach(*environment_);
+    PathService::getInstance().sync(*environment_);
+    {
+        MemoryTagScope memoryTag(MemoryTag::UI);
+        DialogSystem::getInstance().load(DialogConstants::PACK_PATH);
+    }
     std::cout << "NPC system initialized successfully" << std::endl;
 
-    // ECS migration start: Create sample entity (player placeholder)
-    // ECS functionality temporarily disabled due to component conflicts
-    // auto playerEntity = std::make_unique<Entity>();
-    // auto transform = std::make_unique<TransformComponent>();
-    // transform->position = camera_.position;
-    // playerEntity->addComponent(std::move(transform));
-    // entities_.push_back(std::move(playerEntity));
+    // Player entity mirrors the camera so ECS systems can see it
+    playerEntity_ = registry_.create();
+    registry_.emplace<TransformComponent>(playerEntity_, TransformComponent{camera_.position});
+    registry_.emplace<VelocityComponent>(playerEntity_);
+    registry_.emplace<PlayerTag>(playerEntity_);
+}
+
+void Game::InitHotReload() {
+    // A benchmark measures a fixed build of the data; reloads would only add noise
+    if (benchmarkMode_) return;
+
+    UITypes::ThemeManager& themes = UITypes::ThemeManager::getInstance();
+    if (FileExists(HotReloadConstants::THEME_PATH)) {
+        themes.loadCustomTheme(HotReloadConstants::THEME_PATH);
+    }
+
+    fileWatcher_.watch(HotReloadConstants::CONFIG_PATH, [this](const std::string&) { ReloadConfig(); });
+    fileWatcher_.watch(HotReloadConstants::THEME_PATH, [&themes](const std::string& path) {
+        themes.loadCustomTheme(path);
+    });
+    fileWatcher_.watch(EnvironmentConstants::WORLD_PACK_PATH, [this](const std::string& path) {
+        MemoryTagScope memoryTag(MemoryTag::ENVIRONMENT);
+        if (reloadWorldPack(path, *environment_, *worldStreamer_, worldPack_)) {
+            PathService::getInstance().sync(*environment_);  // Obstacles may have moved
+        }
+    });
+    fileWatcher_.start();
+}
+
+void Game::InitTelemetry() {
+    if (benchmarkMode_ || config_.telemetryPort <= 0) return;
+    telemetry_.start(config_.telemetryPort, &state_.getSimulationSnapshot());
+    SampleTelemetry();
+}
+
+void Game::SampleTelemetry() {
+    const AdvancedFrameStats& frames = performanceMonitor_.getStats();
+    TelemetrySample sample;
+    sample.frame = static_cast<uint64_t>(frameCounter_);
+    sample.uptimeSeconds = GetTime();
+    sample.averageFrameMs = frames.average_frame_time_ * 1000.0f;
+    sample.p50Ms = frames.histogram_.getPercentileMs(50.0f);
+    sample.p95Ms = frames.histogram_.getPercentileMs(95.0f);
+    sample.p99Ms = frames.histogram_.getPercentileMs(99.0f);
+    sample.maxFrameMs = frames.max_frame_time_ * 1000.0f;
+    sample.budgetWarnings = frames.budget_warnings_;
+    sample.budgetCritical = frames.budget_critical_;
+    sample.hitches = frames.hitch_count_;
+    for (const SystemTimer* timer : {&frames.collision_timer_, &frames.rendering_timer_, &frames.input_timer_,
+                                     &frames.ui_timer_, &frames.physics_timer_}) {
+        TelemetrySample::Timer& out = sample.timers[sample.timerCount++];
+        out.name = timer->profile_name_;
+        out.averageMs = timer->getAverageMs();
+        out.maxMs = timer->getMaxMs();
+    }
+
+    UITypes::ThemeManager::getInstance().getCacheStats(sample.themeColorHits, sample.themeColorMisses,
+                                                       sample.themeFontHits, sample.themeFontMisses);
+
+    const MemoryTracker& memory = MemoryTracker::getInstance();
+    for (int tag = 0; tag < MEMORY_TAG_COUNT; ++tag) {
+        const MemoryTracker::TagStats& stats = memory.getStats(static_cast<MemoryTag>(tag));
+        sample.memoryBytes[tag] = stats.currentBytes;
+        sample.memoryPeakBytes[tag] = stats.peakBytes;
+        sample.memoryFrameAllocations[tag] = stats.frameAllocations;
+    }
+
+    if (environment_) {
+        sample.environmentObjects = static_cast<uint32_t>(environment_->getAllObjects().size());
+        sample.renderedObjects = static_cast<uint32_t>(environment_->getLastRenderedCount());
+    }
+    sample.npcs = static_cast<uint32_t>(NPCSystem::getInstance().getCount());
+    sample.particles = static_cast<uint32_t>(ParticleSystem::getInstance().getLiveCount());
+    const AssetCacheStats& assets = AssetCache::getInstance().getStats();
+    sample.assets = assets.assets;
+    sample.assetGpuBytes = assets.gpuBytes;
+    sample.qualityLevel = qualityScaler_.getLevel();
+    telemetry_.publish(sample);
+}
+
+void Game::ReloadConfig() {
+    GameConfig next = loadConfig(HotReloadConstants::CONFIG_PATH);
+    if (next.targetFPS != config_.targetFPS) {
+        SetTargetFPS(next.targetFPS);
+    }
+    if (next.windowTitle != config_.windowTitle) {
+        SetWindowTitle(next.windowTitle.c_str());
+    }
+    if (next.windowWidth != config_.windowWidth || next.windowHeight != config_.windowHeight) {
+        SetWindowSize(next.windowWidth, next.windowHeight);
+    }
+    if (next.fullscreen != IsWindowFullscreen()) {
+        ToggleFullscreen();
+    }
+    config_ = next;
+    ApplyAssetBudget();
+    std::cout << "HOT RELOAD: Config applied (" << config_.windowWidth << "x" << config_.windowHeight
+              << ", " << config_.targetFPS << " FPS)" << std::endl;
 }
 
 void Game::Update(float deltaTime) {
     // Debug output every 60 frames
     if (frameCounter_ % 60 == 0) {
-        std::cout << "Game loop iteration: " << frameCounter_ << ", Window ready: " << IsWindowReady() << std::endl;
+        BW_LOG(DEBUG_GENERAL, DEBUG_DETAILED, "Game loop iteration: {}, Window ready: {}", frameCounter_, IsWindowReady());
     }
 
-    HandleInput(deltaTime);
-    std::cout << "Finished HandleInput" << std::endl;
+    {
+        PROFILE_SYSTEM(performanceMonitor_, input);
+        HandleInput(deltaTime);
+    }
+    BW_LOG(DEBUG_GENERAL, DEBUG_TRACE, "Finished HandleInput");
 
     UpdateSystems(deltaTime);
 }
@@ -263,79 +586,86 @@ void Game::HandleInput(float deltaTime) {
     static bool callbacksRegistered = false;
     if (!callbacksRegistered) {
         std::cout << "Registering input callbacks..." << std::endl;
-        enhancedInput_->registerActionCallback("pause", [&]() {
-            std::cout << "DEBUG: ESC key detected! Current states - Inventory: " << state_.showInventoryWindow
-                      << ", EscMenu: " << state_.showEscMenu << std::endl;
+        enhancedInput_->registerActionCallback(InputActions::PAUSE, [&]() {
+            std::cout << "DEBUG: ESC key detected! Current states - Inventory: " << state_.ui.showInventoryWindow
+                      << ", EscMenu: " << state_.ui.showEscMenu << std::endl;
 
-            if (state_.showInventoryWindow) {
-                state_.showInventoryWindow = false;
+            if (state_.ui.showInventoryWindow) {
+                state_.ui.showInventoryWindow = false;
                 enhancedInput_->setMouseCaptured(true);
-                state_.mouseReleased = false;
+                state_.ui.mouseReleased = false;
                 std::cout << "ESC - Inventory closed, returning to game" << std::endl;
-            } else if (state_.showEscMenu) {
-                state_.showEscMenu = false;
+            } else if (state_.ui.showEscMenu) {
+                state_.ui.showEscMenu = false;
                 enhancedInput_->setMouseCaptured(true);
-                state_.mouseReleased = false;
+                state_.ui.mouseReleased = false;
                 std::cout << "ESC - Menu closed, resuming game" << std::endl;
             } else {
-                state_.showEscMenu = true;
+                state_.ui.showEscMenu = true;
                 enhancedInput_->setMouseCaptured(false);
-                state_.mouseReleased = true;
-                state_.selectedMenuOption = 0;
+                state_.ui.mouseReleased = true;
+                state_.ui.selectedMenuOption = 0;
                 std::cout << "ESC - Pause menu opened! Mouse freed for clicking." << std::endl;
             }
-            state_.notifyChange("pause_menu");
+            state_.notifyChange(StateChange::PAUSE_MENU);
         });
 
-        enhancedInput_->registerActionCallback("testing_panel", [&]() {
-            state_.showTestingPanel = !state_.showTestingPanel;
-            std::cout << "TAB PRESSED: Testing panel: " << (state_.showTestingPanel ? "OPENED" : "CLOSED") << std::endl;
-            state_.notifyChange("testing_panel");
+        enhancedInput_->registerActionCallback(InputActions::TESTING_PANEL, [&]() {
+            state_.ui.showTestingPanel = !state_.ui.showTestingPanel;
+            std::cout << "TAB PRESSED: Testing panel: " << (state_.ui.showTestingPanel ? "OPENED" : "CLOSED") << std::endl;
+            state_.notifyChange(StateChange::TESTING_PANEL);
         });
 
-        enhancedInput_->registerActionCallback("performance_toggle", [&]() {
-            if (!state_.isInDialog && !state_.showEscMenu && !state_.showInventoryWindow) {
+        enhancedInput_->registerActionCallback(InputActions::PERFORMANCE_TOGGLE, [&]() {
+            if (!state_.dialog.active && !state_.ui.showEscMenu && !state_.ui.showInventoryWindow) {
                 performanceStats_.showDetailedStats = !performanceStats_.showDetailedStats;
                 std::cout << "Performance detailed stats: " << (performanceStats_.showDetailedStats ? "ENABLED" : "DISABLED") << std::endl;
             }
-            state_.notifyChange("performance_toggle");
+            state_.notifyChange(StateChange::PERFORMANCE_TOGGLE);
         });
 
-        enhancedInput_->registerActionCallback("inventory", [&]() {
-            if (!state_.isInDialog && !state_.showEscMenu) {
-                state_.showInventoryWindow = !state_.showInventoryWindow;
+        // Threads still recording (save writer, path searches) lose only the slots they overwrite meanwhile
+        enhancedInput_->registerActionCallback(InputActions::PROFILE_CAPTURE, [&]() {
+            Profiler::getInstance().exportChromeTrace();
+        });
 
-                if (state_.showInventoryWindow) {
+        enhancedInput_->registerActionCallback(InputActions::INVENTORY, [&]() {
+            if (!state_.dialog.active && !state_.ui.showEscMenu) {
+                state_.ui.showInventoryWindow = !state_.ui.showInventoryWindow;
+
+                if (state_.ui.showInventoryWindow) {
                     enhancedInput_->setMouseCaptured(false);
-                    state_.mouseReleased = true;
+                    state_.ui.mouseReleased = true;
                     std::cout << "Inventory opened - mouse automatically freed for interaction" << std::endl;
                 } else {
                     enhancedInput_->setMouseCaptured(true);
-                    state_.mouseReleased = false;
+                    state_.ui.mouseReleased = false;
                     std::cout << "Inventory closed - mouse automatically captured for gameplay" << std::endl;
                 }
             }
-            state_.notifyChange("inventory");
+            state_.notifyChange(StateChange::INVENTORY);
         });
 
-        enhancedInput_->registerActionCallback("quick_use", [&]() {
-            if (!state_.isInDialog && !state_.showEscMenu && inventorySystem_) {
+        enhancedInput_->registerActionCallback(InputActions::QUICK_USE, [&]() {
+            if (!state_.dialog.active && !state_.ui.showEscMenu && inventorySystem_) {
                 auto consumables = inventorySystem_->getInventory().findItemsByType(ItemType::CONSUMABLE);
                 if (!consumables.empty()) {
                     std::cout << "Used " << consumables[0]->getName() << std::endl;
                     inventorySystem_->getInventory().removeItem(consumables[0], 1);
 
                     auto potion = std::dynamic_pointer_cast<AlchemicalPotion>(consumables[0]);
-                    if (potion) {
+                    if (potion && inventorySystem_->startTimedEffect(*potion)) {
+                        std::cout << "Effect active for " << potion->getDuration() << " seconds" << std::endl;
+                    } else if (potion) {
                         auto effects = potion->getEffects();
-                        state_.playerHealth = std::min(state_.maxPlayerHealth, state_.playerHealth + effects.health);
-                        state_.playerMana = std::min(state_.maxPlayerMana, state_.playerMana + effects.mana);
-                        state_.playerStamina = std::min(state_.maxPlayerStamina, state_.playerStamina + effects.stamina);
+                        state_.player.health = std::min(state_.player.maxHealth, state_.player.health + effects.health);
+                        state_.player.mana = std::min(state_.player.maxMana, state_.player.mana + effects.mana);
+                        state_.player.stamina = std::min(state_.player.maxStamina, state_.player.stamina + effects.stamina);
                         std::cout << "Applied effects: HP+" << effects.health << " MP+" << effects.mana << " SP+" << effects.stamina << std::endl;
                     }
                 }
             }
-            state_.notifyChange("quick_use");
+            state_.notifyChange(StateChange::QUICK_USE);
         });
 
         callbacksRegistered = true;
@@ -344,30 +674,33 @@ void Game::HandleInput(float deltaTime) {
 
     // **WINDOW CLOSE CHECK** - Keep inline for now (system-level)
     static bool windowCloseRequested = false;
-    if (WindowShouldClose() && !windowCloseRequested && !state_.showEscMenu) {
+    if (WindowShouldClose() && !windowCloseRequested && !state_.ui.showEscMenu) {
         std::cout << "Window close requested - opening pause menu..." << std::endl;
         windowCloseRequested = true;
-        state_.showEscMenu = true;
+        state_.ui.showEscMenu = true;
         enhancedInput_->setMouseCaptured(false);
-        state_.mouseReleased = true;
-        state_.selectedMenuOption = 3;
-        state_.notifyChange("window_close");
+        state_.ui.mouseReleased = true;
+        state_.ui.selectedMenuOption = 3;
+        state_.notifyChange(StateChange::WINDOW_CLOSE);
     }
-    if (!state_.showEscMenu) {
+    if (!state_.ui.showEscMenu) {
         windowCloseRequested = false;
     }
 
     // **MELEE SWING** - Move to combat if possible, but keep for now
-    if (!state_.isInDialog && !state_.showInventoryWindow && !state_.showEscMenu &&
+    if (!state_.dialog.active && !state_.ui.showInventoryWindow && !state_.ui.showEscMenu &&
         enhancedInput_->isMouseButtonPressed(MOUSE_BUTTON_LEFT) &&
-        (GetTime() - state_.lastSwingTime) > state_.swingCooldown) {
-        updateMeleeSwing(camera_, GetTime(), state_);
-        state_.notifyChange("melee_swing");
+        (simulationTime_ - state_.combat.lastSwingTime) > state_.combat.swingCooldown) {
+        updateMeleeSwing(camera_, static_cast<float>(simulationTime_), state_);
+        state_.notifyChange(StateChange::MELEE_SWING);
     }
 
     // **HANDLE MENU/INVENTORY INPUT** - Delegated to MenuSystem
     menuSystem_->handleEscMenuInput();
-    menuSystem_->handleInventoryInput(*inventorySystem_);
+    {
+        MemoryTagScope memoryTag(MemoryTag::INVENTORY);
+        menuSystem_->handleInventoryInput(*inventorySystem_);
+    }
 
     // **DEBUG**: RAW TAB check (keep for now)
     if (IsKeyPressed(KEY_TAB)) {
@@ -376,73 +709,180 @@ void Game::HandleInput(float deltaTime) {
 }
 
 void Game::UpdateSystems(float deltaTime) {
-    // ===== PHASE 4: RE-ENABLE ENVIRONMENTAL UPDATES =====
-    std::cout << "Starting environment update" << std::endl;
-    if (environment_) {
-        environment_->update(deltaTime, camera_);
-    }
-    std::cout << "Finished environment update" << std::endl;
+    PROFILE_SCOPE("UpdateSystems");
+    frameDeltaTime_ = deltaTime;
+    simulationTime_ += deltaTime;
+    updateGraph_.run(JobSystem::getInstance());
+}
 
-    // NEW: Update building entry
-    std::cout << "Starting updateBuildingEntry" << std::endl;
-    updateBuildingEntry(camera_, state_, *environment_);
-    std::cout << "Finished updateBuildingEntry" << std::endl;
+void Game::BuildUpdateGraph() {
+    // Worker nodes own their data for the frame: the environment (and streamer, which edits it),
+    // and the combat pools. Anything reading raylib input, UI singletons or writing GameState
+    // stays on the main thread, which runs its nodes first while it waits on the graph.
+    JobGraph::NodeId environment = updateGraph_.add("environment", [this] {
+        // ===== PHASE 4: RE-ENABLE ENVIRONMENTAL UPDATES =====
+        BW_LOG(DEBUG_GENERAL, DEBUG_TRACE, "Starting environment update");
+        if (environment_) {
+            environment_->update(frameDeltaTime_, camera_);
+        }
+        BW_LOG(DEBUG_GENERAL, DEBUG_TRACE, "Finished environment update");
+    });
 
-    // Update swings
-    std::cout << "Starting updateSwings" << std::endl;
-    updateSwings();
-    std::cout << "Finished updateSwings" << std::endl;
+    JobGraph::NodeId streaming = updateGraph_.add("streaming", [this] {
+        MemoryTagScope memoryTag(MemoryTag::ENVIRONMENT);
+        if (environment_ && worldStreamer_) {
+            worldStreamer_->update(*environment_, camera_.position);
+        }
+    });
+    updateGraph_.dependsOn(streaming, environment);
+
+    updateGraph_.add("ui", [this] {
+        MemoryTagScope memoryTag(MemoryTag::UI);
+        UINotification::NotificationManager::getInstance().update(frameDeltaTime_);
+        UIAnimation::AnimationManager::getInstance().update(frameDeltaTime_);
+    }, true);
+
+    // Timed potion effects; inventory is edited by input handling, so this stays on the main thread
+    updateGraph_.add("effects", [this] {
+        MemoryTagScope memoryTag(MemoryTag::INVENTORY);
+        if (inventorySystem_) {
+            inventorySystem_->update(frameDeltaTime_);
+        }
+    }, true);
 
-    // Update targets (respawn after being hit)
-    std::cout << "Starting updateTargets" << std::endl;
-    updateTargets();
-    std::cout << "Finished updateTargets" << std::endl;
+    // NEW: Update building entry
+    JobGraph::NodeId buildingEntry = updateGraph_.add("buildingEntry", [this] {
+        BW_LOG(DEBUG_GENERAL, DEBUG_TRACE, "Starting updateBuildingEntry");
+        updateBuildingEntry(camera_, state_, *environment_);
+        BW_LOG(DEBUG_GENERAL, DEBUG_TRACE, "Finished updateBuildingEntry");
+    }, true);
+    updateGraph_.dependsOn(buildingEntry, streaming);
 
     // **PROFILED**: Update player (jumping, movement, collisions) - **DISABLED DURING ESC MENU**
-    if (!state_.showEscMenu) {
-        std::cout << "Starting updatePlayer" << std::endl;
-        updatePlayer(camera_, state_, *environment_, deltaTime);
-        std::cout << "Finished updatePlayer" << std::endl;
-    }
+    JobGraph::NodeId player = updateGraph_.add("player", [this] {
+        if (!state_.ui.showEscMenu) {
+            BW_LOG(DEBUG_GENERAL, DEBUG_TRACE, "Starting updatePlayer");
+            PROFILE_SYSTEM(performanceMonitor_, physics);
+            updatePlayer(camera_, state_, *environment_, frameDeltaTime_, &performanceMonitor_.getStats().collision_timer_);
+            BW_LOG(DEBUG_GENERAL, DEBUG_TRACE, "Finished updatePlayer");
+        }
+    }, true);
+    updateGraph_.dependsOn(player, buildingEntry);
+
+    // Crowd update on a worker. It queries the environment grid, so it sits between the
+    // player and interactions, the other grid readers; interactions see this frame's NPCs.
+    // The nav grid re-syncs first, after streaming has added or removed this frame's obstacles.
+    JobGraph::NodeId npcs = updateGraph_.add("npcs", [this] {
+        PathService::getInstance().sync(*environment_);
+        int engaged = state_.dialog.active ? state_.dialog.npc : -1;
+        NPCSystem::getInstance().update(frameDeltaTime_, camera_.position, *environment_, engaged);
+    });
+    updateGraph_.dependsOn(npcs, player);
+
+    // Swing sweeps query the environment grid too, so they run after the crowd has moved its
+    // anchors and before interactions; hits are applied on the main thread once they're in.
+    JobGraph::NodeId combat = updateGraph_.add("combat", [this] {
+        // Update swings
+        BW_LOG(DEBUG_GENERAL, DEBUG_TRACE, "Starting updateSwings");
+        updateSwings(frameDeltaTime_, static_cast<float>(simulationTime_), *environment_, state_.player);
+        BW_LOG(DEBUG_GENERAL, DEBUG_TRACE, "Finished updateSwings");
+
+        // Update targets (respawn after being hit)
+        BW_LOG(DEBUG_GENERAL, DEBUG_TRACE, "Starting updateTargets");
+        updateTargets(static_cast<float>(simulationTime_));
+        BW_LOG(DEBUG_GENERAL, DEBUG_TRACE, "Finished updateTargets");
+    });
+    updateGraph_.dependsOn(combat, npcs);
+
+    JobGraph::NodeId combatHits = updateGraph_.add("combatHits", [this] {
+        applyCombatHits(state_, inventorySystem_.get());
+    }, true);
+    updateGraph_.dependsOn(combatHits, combat);
+
 
     // ===== PHASE 8: RE-ENABLE INTERACTION SYSTEM =====
     // Handle interactions - disabled during dialog, inventory, or ESC menu
-    if (!state_.isInDialog && !state_.showInventoryWindow && !state_.showEscMenu) {
-        std::cout << "Starting handleInteractions" << std::endl;
-        handleInteractions(camera_, *environment_, state_, GetTime());
-        std::cout << "Finished handleInteractions" << std::endl;
-    }
-
-    // ECS update placeholder (for migration)
-    std::cout << "Starting ECS update placeholder" << std::endl;
-    for (auto& entity : entities_) {
-        if (entity) {
-            // Example: Update physics if present
-            // if (auto physics = static_cast<PhysicsComponent*>(entity->getComponent("PhysicsComponent"))) {
-            //     // Placeholder physics update
-            //     physics->velocity.y -= 9.81f * deltaTime;  // Gravity example
-            // }
+    JobGraph::NodeId interactions = updateGraph_.add("interactions", [this] {
+        // Always refreshed: door indicators and labels read it even while interaction is paused
+        environment_->updateNearbyInteractables(camera_.position);
+        if (!state_.dialog.active && !state_.ui.showInventoryWindow && !state_.ui.showEscMenu) {
+            BW_LOG(DEBUG_GENERAL, DEBUG_TRACE, "Starting handleInteractions");
+            handleInteractions(camera_, *environment_, state_, static_cast<float>(simulationTime_));
+            BW_LOG(DEBUG_GENERAL, DEBUG_TRACE, "Finished handleInteractions");
         }
-    }
-    std::cout << "Finished ECS update placeholder" << std::endl;
+    }, true);
+    updateGraph_.dependsOn(interactions, player);
+    updateGraph_.dependsOn(interactions, npcs);
+    updateGraph_.dependsOn(interactions, combat);
+
+    // Particles simulate and rebuild their quads on a worker once combat has emitted this
+    // frame's trails and sparks. Interactions move the camera (door transitions), so the
+    // camera the quads face is only final after them
+    JobGraph::NodeId particles = updateGraph_.add("particles", [this] {
+        ParticleSystem::getInstance().update(frameDeltaTime_, camera_);
+    });
+    updateGraph_.dependsOn(particles, combat);
+    updateGraph_.dependsOn(particles, interactions);
+
+    JobGraph::NodeId entities = updateGraph_.add("entities", [this] {
+        UpdateEntities(frameDeltaTime_);
+    }, true);
+    updateGraph_.dependsOn(entities, player);
+
+    // Mixed for the camera after it has moved; the emitter query reads the environment's grid
+    JobGraph::NodeId audio = updateGraph_.add("audio", [this] {
+        MemoryTagScope memoryTag(MemoryTag::AUDIO);
+        if (environment_) {
+            SpatialAudio::getInstance().update(camera_, *environment_, state_.player.isInBuilding);
+        }
+        UIAudio::AudioManager::getInstance().update(frameDeltaTime_);
+    }, true);
+    updateGraph_.dependsOn(audio, interactions);
+}
+
+void Game::UpdateEntities(float deltaTime) {
+    // Player: velocity is whatever the controller moved the camera by this frame
+    registry_.each<PlayerTag, TransformComponent, VelocityComponent>(
+        [this, deltaTime](ecs::Entity, PlayerTag&, TransformComponent& transform, VelocityComponent& motion) {
+            if (deltaTime > 0.0f) {
+                motion.velocity = {(camera_.position.x - transform.position.x) / deltaTime,
+                                   (camera_.position.y - transform.position.y) / deltaTime,
+                                   (camera_.position.z - transform.position.z) / deltaTime};
+            }
+            transform.position = camera_.position;
+        });
 }
 
 void Game::Render() {
-    // **PROFILED**: Start rendering performance tracking
-    performanceStats_.renderingTimer.start();
+    // **PROFILED**: Rendering performance tracking
+    PROFILE_SYSTEM(performanceMonitor_, rendering);
+
+    // Theme fonts rasterize on a worker; only their atlas uploads cost frame time, within a budget
+    UITypes::ThemeManager::getInstance().processFontUploads();
+    AssetCache::getInstance().processUploads();
+
+    // Draw between the last two simulation steps; the look direction is always the latest
+    Camera3D renderCamera = camera_;
+    if (MathUtils::distanceSquared3D(previousCameraPosition_, camera_.position) <
+        SimulationConstants::SNAP_DISTANCE * SimulationConstants::SNAP_DISTANCE) {
+        float back = 1.0f - renderAlpha_;
+        Vector3 offset = {(camera_.position.x - previousCameraPosition_.x) * back,
+                          (camera_.position.y - previousCameraPosition_.y) * back,
+                          (camera_.position.z - previousCameraPosition_.z) * back};
+        renderCamera.position = {camera_.position.x - offset.x, camera_.position.y - offset.y, camera_.position.z - offset.z};
+        renderCamera.target = {camera_.target.x - offset.x, camera_.target.y - offset.y, camera_.target.z - offset.z};
+    }
 
     if (renderSystem_) {
-        renderSystem_->renderAll(camera_, GetTime());
+        renderSystem_->renderAll(renderCamera, GetTime());
     }
-
-    // **PROFILED**: Complete rendering performance tracking
-    performanceStats_.renderingTimer.end();
 }
 
 void Game::Shutdown() {
     // **PHASE 2**: Release cursor on exit using enhanced input
     if (enhancedInput_) {
         enhancedInput_->setMouseCaptured(false);
+        enhancedInput_->stopRecording();
     }
     if (input_) {
         input_->setMouseCaptured(false);  // Keep legacy for compatibility
@@ -451,7 +891,28 @@ void Game::Shutdown() {
     // **UI SYSTEM**: Shutdown UI system
     shutdownUISystem();
 
+    // Workers may hold environment pointers, so stop them before anything is torn down
+    fileWatcher_.stop();
+    telemetry_.stop();
+    JobSystem::getInstance().stop();
+    SaveWriter::getInstance().stop();  // Lets a save queued from the menu reach the disk
+
+    // Instanced meshes and shaders need the GL context, so release them before closing it
+    if (environment_) {
+        environment_->unloadRenderResources();
+    }
+    UITypes::ThemeManager::getInstance().unloadFonts();
+    AssetCache::getInstance().unloadAll();
+
+    // World sounds first; UI audio closes the device
+    SpatialAudio::getInstance().shutdown();
+    UIAudio::shutdownUIAudio();
+
     std::cout << "Game exited cleanly. Total frames: " << frameCounter_ << std::endl;
+    std::cout << "Performance: " << performanceMonitor_.getReport() << std::endl;
+
+    // Last, so shutdown messages from the systems above reach the file
+    AsyncLog::getInstance().stop();
 
     // De-Initialization
     CloseWindow();  // Close window and OpenGL context
@@ -6,37 +6,44 @@
 #include "config.h"      // For GameConfig
 #include "input_manager.h"  // For InputManager and EnhancedInputManager
 #include "environment_manager.h"  // For EnvironmentManager
+#include "world_streamer.h"  // For WorldStreamer
+#include "world_builder.h"  // For LoadedWorldPack
+#include "file_watcher.h"  // For FileWatcher
+#include "telemetry.h"  // For TelemetryExporter
 #include "menu_system.h"  // For MenuSystem
 #include "render_system.h"  // For RenderSystem
 
-// ECS components are defined in environmental_object.h
-// Include that header when ECS functionality is needed
+#include "constants.h"  // For SimulationConstants
+#include "ecs.h"  // For ecs::Registry
+#include "job_system.h"  // For JobGraph
 
-class Entity {
-public:
-    void addComponent(std::unique_ptr<Component> component);
-    Component* getComponent(const std::string& typeName) const;
-private:
-    std::unordered_map<std::string, std::unique_ptr<Component>> components_;
-};
-
-// Simple performance stats (enhanced with chrono for accurate timing)
-#include <chrono>
+// Simple performance display state; timing lives in PerformanceMonitorSystem
+#include "performance_system.h"  // For PerformanceMonitorSystem
+#include "quality_scaler.h"  // For QualityScaler
 
 struct SimplePerformanceStats {
     float averageFrameTime = 0.0f;
     int frameCount = 0;
     bool showDetailedStats = false;
+};
+
+/// \brief Input capture settings for Game::Run (see EnhancedInputManager record/replay).
+struct InputCaptureOptions {
+    std::string recordPath;                  // Non-empty: record every frame's input here
+    std::string replayPath;                  // Non-empty: drive input and delta time from this recording
+    std::string rawMouseDevice;              // Non-empty: sample mouse motion from this device (RawMouseSampler)
+};
 
-    struct Timer {
-        std::chrono::steady_clock::time_point startTime;
-        std::chrono::steady_clock::time_point endTime;
-        void start() { startTime = std::chrono::steady_clock::now(); }
-        void end() { endTime = std::chrono::steady_clock::now(); }
-        double elapsed() const {
-            return std::chrono::duration<double, std::milli>(endTime - startTime).count();
-        }
-    } renderingTimer;
+/// \brief Settings for a headless benchmark run (see Game::RunBenchmark).
+struct BenchmarkOptions {
+    int frames = 1800;                       // Frames to simulate and render
+    float fixedDeltaTime = SimulationConstants::FIXED_DELTA_TIME;  // Simulation step, independent of wall time
+    int objectScale = 1;                     // > 1 adds rings of props via populateBenchmarkProps
+    int townScale = 0;                       // > 0 replaces the forest with a generated town of this many times the default world's objects
+    uint32_t townSeed = 1;                   // Seed for the generated town
+    float cameraSpeed = 4.0f;                // Units per second along the scripted path
+    std::string outputPath = "bench_results.json";
+    std::string replayPath;                  // Non-empty: replay this input recording instead of the camera path
 };
 
 // Add other includes if needed for types in declarations (e.g., InventorySystem if defined elsewhere)
@@ -52,8 +59,16 @@ public:
     ~Game();
 
     /// \brief Main game loop runner.
+    /// \param capture Optional input recording or replay.
     /// \return EXIT_SUCCESS on clean exit, EXIT_FAILURE on error.
-    int Run();
+    int Run(const InputCaptureOptions& capture = {});
+
+    /// \brief Runs a fixed-timestep tour of the town and building interiors in a hidden window,
+    /// then writes frame statistics as JSON. With a replayPath the recording drives the player
+    /// instead, stepping by its recorded delta times.
+    /// \param options Benchmark settings.
+    /// \return EXIT_SUCCESS if the report was written.
+    int RunBenchmark(const BenchmarkOptions& options);
 
 private:
     // Initialization methods
@@ -69,9 +84,27 @@ private:
     /// \brief Initializes world, entities, and ECS foundation.
     void InitWorldAndEntities();
 
+    /// \brief Registers config, theme and world pack reloads with fileWatcher_ and starts it.
+    void InitHotReload();
+
+    /// \brief Starts the telemetry endpoint if config.ini sets telemetryPort.
+    void InitTelemetry();
+
+    /// \brief Copies the counters telemetry reports and publishes them to the exporter.
+    void SampleTelemetry();
+
+    /// \brief Re-reads config.ini and applies the window settings that changed.
+    void ReloadConfig();
+
+    /// \brief Hands the config's asset residency budgets to AssetCache.
+    void ApplyAssetBudget();
+
+    /// \brief Hands the quality scaler's current settings to the systems it drives.
+    void ApplyQuality();
+
     // Main loop phases
-    /// \brief Updates game state.
-    /// \param deltaTime Time since last frame.
+    /// \brief Advances the game by one simulation step (input, then systems).
+    /// \param deltaTime Step length; SimulationConstants::FIXED_DELTA_TIME from Run().
     void Update(float deltaTime);
 
     /// \brief Handles input processing.
@@ -96,17 +129,41 @@ private:
     std::unique_ptr<EnhancedInputManager> enhancedInput_;  // Enhanced input
     GameState state_;
     std::unique_ptr<EnvironmentManager> environment_;  // Owned environment
+    std::unique_ptr<WorldStreamer> worldStreamer_;  // Streams outskirts cells into environment_
+    LoadedWorldPack worldPack_;  // What the world pack added, so an edited pack patches only its changes
+    FileWatcher fileWatcher_;  // Hot reload; handlers run between simulation and rendering
+    TelemetryExporter telemetry_;  // Optional live counters for ops, off unless config.ini sets a port
     SimplePerformanceStats performanceStats_;  // Simple performance stats
+    PerformanceMonitorSystem performanceMonitor_;  // Frame histogram, hitches, per-system timers
+    QualityScaler qualityScaler_;  // Trades draw distance and update rates for frame time
     std::unique_ptr<InventorySystem> inventorySystem_;  // Owned inventory
     std::unique_ptr<MenuSystem> menuSystem_;  // Owned menu system
     std::unique_ptr<RenderSystem> renderSystem_;  // Owned render system
 
     // Flags and counters
     bool shouldClose_ = false;
+    bool benchmarkMode_ = false;  // Hidden window, no vsync or splash, scripted camera
     int frameCounter_ = 0;
-
-    // ECS preparation (to be migrated fully)
-    std::vector<std::unique_ptr<Entity>> entities_;  // Basic entity list for migration
+    InputCaptureOptions inputCapture_;  // Applied when the input manager is created
+    int townScale_ = 0;  // Benchmark: generate a town of this many times the default world's objects
+    uint32_t townSeed_ = 1;
+    double simulationTime_ = 0.0;  // Sum of simulated delta times; gameplay timers use this, not GetTime()
+    Vector3 previousCameraPosition_ = {0.0f, 0.0f, 0.0f};  // Camera before the latest simulation step
+    float renderAlpha_ = 1.0f;  // Progress into the next step; Render() blends previous->current by it
+
+    // Gameplay entities; components live in packed per-type pools
+    ecs::Registry registry_;
+    ecs::Entity playerEntity_;
+
+    /// \brief Runs ECS systems over the registry for this frame.
+    void UpdateEntities(float deltaTime);
+
+    // Per-frame system graph; built once, nodes read frameDeltaTime_
+    JobGraph updateGraph_;
+    float frameDeltaTime_ = 0.0f;
+
+    /// \brief Builds updateGraph_: which systems run on workers and what each waits for.
+    void BuildUpdateGraph();
 };
 
 #endif // GAME_H
\ No newline at end of file
@@ -1,61 +1,395 @@
 #include "game_state.h"
+#include "binary_io.h"
+#include "save_writer.h"
 #include <fstream>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>  // For debugging/error messages
 #include <algorithm>  // For std::min/std::max if needed in validation
 
-// Helper functions for binary serialization of strings and vectors
-void writeString(std::ostream& stream, const std::string& str) {
-    uint32_t len = static_cast<uint32_t>(str.size());
-    stream.write(reinterpret_cast<const char*>(&len), sizeof(len));
-    stream.write(str.data(), len);
+namespace {
+
+enum class FieldType : uint8_t { BOOL, INT32, FLOAT, VEC3, STRING };
+
+struct StateFieldInfo {
+    SaveFormat::StateField id;
+    const char* name;  // Key in version 0 text saves
+    FieldType type;
+    void* (*member)(GameState&);  // Null for retired fields: read from old saves, then dropped
+    bool fixedOrder;              // Part of the version 1 and 2 layout
+};
+
+#define BW_STATE_FIELD(id, name, type, expr) \
+    {SaveFormat::id, name, FieldType::type, [](GameState& s) -> void* { return &s.expr; }, true}
+#define BW_RETIRED_FIELD(id, name, type) \
+    {SaveFormat::id, name, FieldType::type, nullptr, true}
+#define BW_TAGGED_FIELD(id, name, type, expr) \
+    {SaveFormat::id, name, FieldType::type, [](GameState& s) -> void* { return &s.expr; }, false}
+
+// Every GameState field a save can hold. Fixed-order fields come first, in the order versions
+// 1 and 2 wrote them; fields added since then only exist in tagged records.
+const StateFieldInfo STATE_FIELDS[] = {
+    BW_STATE_FIELD(MOUSE_RELEASED, "mouseReleased", BOOL, ui.mouseReleased),
+    BW_STATE_FIELD(IS_IN_DIALOG, "isInDialog", BOOL, dialog.active),
+    BW_STATE_FIELD(CURRENT_NPC, "currentNPC", INT32, dialog.npc),
+    BW_RETIRED_FIELD(DIALOG_TEXT, "dialogText", STRING),
+    BW_RETIRED_FIELD(NUM_DIALOG_OPTIONS, "numDialogOptions", INT32),
+    BW_RETIRED_FIELD(DIALOG_OPTION_0, "dialogOption0", STRING),
+    BW_RETIRED_FIELD(DIALOG_OPTION_1, "dialogOption1", STRING),
+    BW_RETIRED_FIELD(DIALOG_OPTION_2, "dialogOption2", STRING),
+    BW_STATE_FIELD(SHOW_DIALOG_WINDOW, "showDialogWindow", BOOL, dialog.showWindow),
+    BW_STATE_FIELD(IS_IN_BUILDING, "isInBuilding", BOOL, player.isInBuilding),
+    BW_STATE_FIELD(CURRENT_BUILDING, "currentBuilding", INT32, player.currentBuilding),
+    BW_STATE_FIELD(SHOW_INTERACT_PROMPT, "showInteractPrompt", BOOL, ui.showInteractPrompt),
+    BW_STATE_FIELD(INTERACT_PROMPT_TEXT, "interactPromptText", STRING, ui.interactPromptText),
+    BW_STATE_FIELD(LAST_OUTDOOR_POSITION, "lastOutdoorPosition", VEC3, player.lastOutdoorPosition),
+    BW_STATE_FIELD(PLAYER_Y, "playerY", FLOAT, player.y),
+    BW_STATE_FIELD(IS_JUMPING, "isJumping", BOOL, player.isJumping),
+    BW_STATE_FIELD(IS_GROUNDED, "isGrounded", BOOL, player.isGrounded),
+    BW_STATE_FIELD(JUMP_VELOCITY, "jumpVelocity", FLOAT, player.jumpVelocity),
+
+    // Player stats
+    BW_STATE_FIELD(PLAYER_HEALTH, "playerHealth", INT32, player.health),
+    BW_STATE_FIELD(MAX_PLAYER_HEALTH, "maxPlayerHealth", INT32, player.maxHealth),
+    BW_STATE_FIELD(PLAYER_MANA, "playerMana", INT32, player.mana),
+    BW_STATE_FIELD(MAX_PLAYER_MANA, "maxPlayerMana", INT32, player.maxMana),
+    BW_STATE_FIELD(PLAYER_STAMINA, "playerStamina", INT32, player.stamina),
+    BW_STATE_FIELD(MAX_PLAYER_STAMINA, "maxPlayerStamina", INT32, player.maxStamina),
+    BW_STATE_FIELD(PLAYER_LEVEL, "playerLevel", INT32, player.level),
+    BW_STATE_FIELD(PLAYER_EXPERIENCE, "playerExperience", INT32, player.experience),
+
+    BW_STATE_FIELD(LAST_SWING_TIME, "lastSwingTime", FLOAT, combat.lastSwingTime),
+    BW_STATE_FIELD(SWINGS_PERFORMED, "swingsPerformed", INT32, combat.swingsPerformed),
+    BW_STATE_FIELD(MELEE_HITS, "meleeHits", INT32, combat.meleeHits),
+    BW_STATE_FIELD(SCORE, "score", INT32, combat.score),
+
+    // Testing states
+    BW_STATE_FIELD(TEST_MOUSE_CAPTURED, "testMouseCaptured", BOOL, tests.mouseCaptured),
+    BW_STATE_FIELD(TEST_BUILDING_COLLISION, "testBuildingCollision", BOOL, tests.buildingCollision),
+    BW_STATE_FIELD(TEST_WASD_MOVEMENT, "testWASDMovement", BOOL, tests.wasdMovement),
+    BW_STATE_FIELD(TEST_SPACE_JUMP, "testSpaceJump", BOOL, tests.spaceJump),
+    BW_STATE_FIELD(TEST_MOUSE_LOOK, "testMouseLook", BOOL, tests.mouseLook),
+    BW_STATE_FIELD(TEST_MELEE_SWING, "testMeleeSwing", BOOL, tests.meleeSwing),
+    BW_STATE_FIELD(TEST_MELEE_HIT_DETECTION, "testMeleeHitDetection", BOOL, tests.meleeHitDetection),
+    BW_STATE_FIELD(TEST_BUILDING_ENTRY, "testBuildingEntry", BOOL, tests.buildingEntry),
+    BW_STATE_FIELD(TEST_NPC_INTERACTION, "testNPCInteraction", BOOL, tests.npcInteraction),
+    BW_STATE_FIELD(LAST_CAMERA_POS, "lastCameraPos", VEC3, player.lastCameraPos),
+
+    // Performance metrics (frameTimeHistory is not saved)
+    BW_STATE_FIELD(AVERAGE_FRAME_TIME, "averageFrameTime", FLOAT, metrics.averageFrameTime),
+    BW_STATE_FIELD(TOTAL_FRAMES, "totalFrames", INT32, metrics.totalFrames),
+
+    // Added after version 2, so only tagged records carry these
+    BW_TAGGED_FIELD(DIALOG_NODE, "dialogNode", INT32, dialog.node),
+};
+
+#undef BW_STATE_FIELD
+#undef BW_RETIRED_FIELD
+#undef BW_TAGGED_FIELD
+
+// Version 0 keys with no field of their own; the 0 -> 1 migrator folds them into vectors
+struct TextOnlyField {
+    SaveFormat::StateField id;
+    const char* name;
+};
+
+const TextOnlyField TEXT_ONLY_FIELDS[] = {
+    {SaveFormat::TEXT_LAST_OUTDOOR_X, "lastOutdoorPositionX"},
+    {SaveFormat::TEXT_LAST_OUTDOOR_Y, "lastOutdoorPositionY"},
+    {SaveFormat::TEXT_LAST_OUTDOOR_Z, "lastOutdoorPositionZ"},
+    {SaveFormat::TEXT_LAST_CAMERA_X, "lastCameraPosX"},
+    {SaveFormat::TEXT_LAST_CAMERA_Y, "lastCameraPosY"},
+    {SaveFormat::TEXT_LAST_CAMERA_Z, "lastCameraPosZ"},
+};
+
+size_t fixedSize(FieldType type) {
+    switch (type) {
+        case FieldType::BOOL: return sizeof(bool);
+        case FieldType::INT32: return sizeof(int);
+        case FieldType::FLOAT: return sizeof(float);
+        case FieldType::VEC3: return sizeof(Vector3);
+        case FieldType::STRING: break;
+    }
+    return 0;
 }
 
-std::string readString(std::istream& stream) {
-    uint32_t len;
-    stream.read(reinterpret_cast<char*>(&len), sizeof(len));
-    std::string str(len, '\0');
-    stream.read(&str[0], len);
-    return str;
+void encodeState(const GameState& state, TaggedRecord& record) {
+    GameState& source = const_cast<GameState&>(state);  // Accessors are only read through here
+    for (const StateFieldInfo& field : STATE_FIELDS) {
+        if (!field.member) continue;
+        const void* value = field.member(source);
+        if (field.type == FieldType::STRING) {
+            const std::string& str = *static_cast<const std::string*>(value);
+            record.setBytes(field.id, str.data(), str.size());
+        } else {
+            record.setBytes(field.id, value, fixedSize(field.type));
+        }
+    }
 }
 
-template<typename T>
-bool VersionedSerializer::serialize(const T& obj, std::ostream& stream) {
-    uint32_t version = CURRENT_VERSION;
-    stream.write(reinterpret_cast<const char*>(&version), sizeof(version));
-    // Custom serialization for GameState (manual for now)
-    return true;  // Placeholder; implement per-type
+// Versions 1 and 2: every fixed-order field in STATE_FIELDS order, strings as uint32_t length + characters
+bool decodeFixedOrder(BinaryReader& in, TaggedRecord& record) {
+    char value[sizeof(Vector3)];
+    std::string str;
+    for (const StateFieldInfo& field : STATE_FIELDS) {
+        if (!field.fixedOrder) continue;
+        if (field.type == FieldType::STRING) {
+            if (!in.readString(str)) return false;
+            record.setBytes(field.id, str.data(), str.size());
+        } else {
+            size_t size = fixedSize(field.type);
+            if (!in.readBytes(value, size)) return false;
+            record.setBytes(field.id, value, size);
+        }
+    }
+    return true;
+}
+
+bool setFromText(TaggedRecord& record, uint16_t id, FieldType type, const std::string& text) {
+    const char* begin = text.c_str();
+    char* end = nullptr;
+    switch (type) {
+        case FieldType::BOOL:
+            record.set(id, std::strtol(begin, &end, 10) != 0);
+            break;
+        case FieldType::INT32:
+            record.set(id, static_cast<int>(std::strtol(begin, &end, 10)));
+            break;
+        case FieldType::FLOAT:
+            record.set(id, std::strtof(begin, &end));
+            break;
+        case FieldType::STRING:
+            record.setBytes(id, text.data(), text.size());
+            return true;
+        case FieldType::VEC3:
+            return false;  // Version 0 writes vectors as per-axis floats
+    }
+    return end != begin;
+}
+
+// Version 0: `name=value` lines. Unknown names are ignored.
+void decodeText(const char* data, size_t size, TaggedRecord& record) {
+    const char* end = data + size;
+    while (data < end) {
+        const char* newline = static_cast<const char*>(std::memchr(data, '\n', static_cast<size_t>(end - data)));
+        const char* lineEnd = newline ? newline : end;
+        std::string line(data, lineEnd);
+        data = newline ? newline + 1 : end;
+
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) continue;
+        std::string name = line.substr(0, equals);
+        std::string value = line.substr(equals + 1);
+
+        bool known = false;
+        for (const StateFieldInfo& field : STATE_FIELDS) {
+            if (name == field.name) {
+                known = setFromText(record, field.id, field.type, value);
+                break;
+            }
+        }
+        for (const TextOnlyField& field : TEXT_ONLY_FIELDS) {
+            if (!known && name == field.name) {
+                known = setFromText(record, field.id, FieldType::FLOAT, value);
+                break;
+            }
+        }
+        if (!known) {
+            std::cout << "SAVE: Ignoring unknown text field '" << name << "'" << std::endl;
+        }
+    }
+}
+
+// Replaces three per-axis float fields with one Vector3 field, keeping `target`'s current axes
+// for any that are missing
+void mergeAxes(TaggedRecord& record, uint16_t x, uint16_t y, uint16_t z, uint16_t target, Vector3 fallback) {
+    if (!record.has(x) && !record.has(y) && !record.has(z)) return;
+    record.get(target, fallback);
+    record.get(x, fallback.x);
+    record.get(y, fallback.y);
+    record.get(z, fallback.z);
+    record.set(target, fallback);
+    record.erase(x);
+    record.erase(y);
+    record.erase(z);
+}
+
+// Copies every field the record holds in the expected shape; anything else keeps its value
+void applyRecord(const TaggedRecord& record, GameState& state) {
+    for (const StateFieldInfo& field : STATE_FIELDS) {
+        const std::string* bytes = field.member ? record.find(field.id) : nullptr;
+        if (!bytes) continue;
+
+        void* value = field.member(state);
+        if (field.type == FieldType::STRING) {
+            static_cast<std::string*>(value)->assign(*bytes);
+        } else if (bytes->size() == fixedSize(field.type)) {
+            std::memcpy(value, bytes->data(), bytes->size());
+        } else {
+            std::cout << "SAVE: Field '" << field.name << "' has size " << bytes->size()
+                      << ", expected " << fixedSize(field.type) << "; keeping current value" << std::endl;
+        }
+    }
+}
+
+}  // namespace
+
+VersionedSerializer::VersionedSerializer() {
+    using namespace SaveFormat;
+
+    // 0 -> 1: text saves split vectors into X/Y/Z keys
+    registerMigrator(TEXT_VERSION, [](TaggedRecord& record) {
+        const GameState defaults;
+        mergeAxes(record, TEXT_LAST_OUTDOOR_X, TEXT_LAST_OUTDOOR_Y, TEXT_LAST_OUTDOOR_Z,
+                  LAST_OUTDOOR_POSITION, defaults.player.lastOutdoorPosition);
+        mergeAxes(record, TEXT_LAST_CAMERA_X, TEXT_LAST_CAMERA_Y, TEXT_LAST_CAMERA_Z,
+                  LAST_CAMERA_POS, defaults.player.lastCameraPos);
+    });
+    // 1 -> 2, 2 -> 3 and 3 -> 4 changed the container, not the fields, so they need no migrator
+}
+
+void VersionedSerializer::serialize(const GameState& state, std::vector<char>& out) {
+    using namespace SaveFormat;
+    BinaryWriter writer;
+    writer.reserve(out.capacity());  // Reuse the caller's last image size as a guess
+
+    SaveHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = CURRENT_VERSION;
+    header.chunk_count = state.inventorySystem ? 3 : 1;
+    writer.write(header);
+
+    TaggedRecord fields;
+    encodeState(state, fields);
+    size_t chunk = writer.beginChunk(STATE_CHUNK);
+    fields.write(writer);
+    writer.endChunk(chunk);
+
+    if (state.inventorySystem) {
+        chunk = writer.beginChunk(INVENTORY_CHUNK);
+        state.inventorySystem->getInventory().writeTo(writer);
+        writer.endChunk(chunk);
+
+        chunk = writer.beginChunk(EQUIPMENT_CHUNK);
+        state.inventorySystem->getEquipment().writeTo(writer);
+        writer.endChunk(chunk);
+    }
+
+    out = writer.release();
 }
 
-template<typename T>
-bool VersionedSerializer::deserialize(T& obj, std::istream& stream) {
-    uint32_t version;
-    stream.read(reinterpret_cast<char*>(&version), sizeof(version));
-    if (version > CURRENT_VERSION) {
-        return false;  // Future version unsupported
+bool VersionedSerializer::deserialize(GameState& state, const char* data, size_t size) const {
+    using namespace SaveFormat;
+    BinaryReader reader(data, size);
+    TaggedRecord fields;
+    uint32_t version = 0;
+
+    // Inventory and equipment decode into copies and are swapped in only if the whole file parses
+    std::unique_ptr<AdventurerInventory> inventory;
+    std::unique_ptr<EquipmentManager> equipment;
+
+    SaveHeader header{};
+    uint32_t legacyVersion = 0;
+    if (size >= sizeof(SaveHeader) && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0) {
+        reader.read(header);
+        version = header.version;
+        if (version > CURRENT_VERSION) {
+            std::cerr << "Unsupported save version: " << version << std::endl;
+            return false;
+        }
+
+        bool haveState = false;
+        char id[4];
+        BinaryReader payload;
+        for (uint32_t i = 0; i < header.chunk_count; ++i) {
+            if (!reader.nextChunk(id, payload)) {
+                std::cerr << "Truncated save: chunk " << i << " of " << header.chunk_count << std::endl;
+                return false;
+            }
+
+            if (std::memcmp(id, STATE_CHUNK, 4) == 0) {
+                haveState = version == FIXED_ORDER_VERSION ? decodeFixedOrder(payload, fields)
+                                                           : fields.parse(payload);
+                if (!haveState) return false;
+            } else if (std::memcmp(id, INVENTORY_CHUNK, 4) == 0 && state.inventorySystem) {
+                inventory = std::make_unique<AdventurerInventory>(state.inventorySystem->getInventory());
+                if (!inventory->readFrom(payload, version <= FULL_ITEMS_VERSION)) return false;
+            } else if (std::memcmp(id, EQUIPMENT_CHUNK, 4) == 0 && state.inventorySystem) {
+                equipment = std::make_unique<EquipmentManager>(state.inventorySystem->getEquipment());
+                if (!equipment->readFrom(payload, version <= FULL_ITEMS_VERSION)) return false;
+            }
+            // Anything else is a chunk from a newer build; its size in the header lets us skip it
+        }
+
+        if (!haveState) {
+            std::cerr << "Save has no state chunk" << std::endl;
+            return false;
+        }
+    } else if (reader.read(legacyVersion) && legacyVersion == LEGACY_VERSION) {
+        version = LEGACY_VERSION;
+        if (!decodeFixedOrder(reader, fields)) {
+            std::cerr << "Truncated version " << LEGACY_VERSION << " save" << std::endl;
+            return false;
+        }
+    } else {
+        version = TEXT_VERSION;
+        decodeText(data, size, fields);
+        if (fields.size() == 0) {
+            std::cerr << "Not a Browserwind save" << std::endl;
+            return false;
+        }
+    }
+
+    // One pass over the decoded fields per version step, then a single copy into GameState
+    for (uint32_t v = version; v < CURRENT_VERSION; ++v) {
+        auto migrator = migrators_.find(v);
+        if (migrator != migrators_.end()) migrator->second(fields);
     }
-    if (auto it = migrators_.find(version); it != migrators_.end()) {
-        it->second(stream);
+    if (version != CURRENT_VERSION) {
+        std::cout << "SAVE: Migrated version " << version << " save to version " << CURRENT_VERSION << std::endl;
     }
-    // Custom deserialization
+
+    applyRecord(fields, state);
+    if (inventory) state.inventorySystem->getInventory() = std::move(*inventory);
+    if (equipment) state.inventorySystem->getEquipment() = std::move(*equipment);
     return true;
 }
 
-void VersionedSerializer::registerMigrator(uint32_t fromVersion, std::function<void(std::istream&)> migrator) {
+void VersionedSerializer::registerMigrator(uint32_t fromVersion, Migrator migrator) {
     migrators_[fromVersion] = std::move(migrator);
 }
 
+void SimulationSnapshot::publish(const SimulationState& state) {
+    uint64_t generation = generation_.load(std::memory_order_relaxed);
+    buffers_[(generation + 1) & 1] = state;
+    generation_.store(generation + 1, std::memory_order_release);
+}
+
+SimulationState SimulationSnapshot::read() const {
+    for (;;) {
+        uint64_t generation = generation_.load(std::memory_order_acquire);
+        SimulationState copy = buffers_[generation & 1];
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // Unchanged: the writer hasn't started on the buffer just copied
+        if (generation_.load(std::memory_order_relaxed) == generation) {
+            return copy;
+        }
+    }
+}
+
 bool GameState::isValid() const {
     // Basic validation checks - expand as needed
-    if (currentNPC < -1 || numDialogOptions < 0 || numDialogOptions > 3) return false;
-    if (currentBuilding < -1) return false;
-    if (playerY < 0.0f || jumpVelocity < 0.0f) return false;  // Assuming non-negative for these
-    if (swingsPerformed < 0 || meleeHits < 0 || score < 0) return false;
+    if (dialog.npc < -1 || dialog.node < -1 || (dialog.active && dialog.node < 0)) return false;
+    if (player.currentBuilding < -1) return false;
+    if (player.y < 0.0f || player.jumpVelocity < 0.0f) return false;  // Assuming non-negative for these
+    if (combat.swingsPerformed < 0 || combat.meleeHits < 0 || combat.score < 0) return false;
     
     // Player stats validation
-    if (playerHealth < 0 || playerHealth > maxPlayerHealth) return false;
-    if (playerMana < 0 || playerMana > maxPlayerMana) return false;
-    if (playerStamina < 0 || playerStamina > maxPlayerStamina) return false;
-    if (playerLevel < 1 || playerExperience < 0) return false;
+    if (player.health < 0 || player.health > player.maxHealth) return false;
+    if (player.mana < 0 || player.mana > player.maxMana) return false;
+    if (player.stamina < 0 || player.stamina > player.maxStamina) return false;
+    if (player.level < 1 || player.experience < 0) return false;
     if (metrics.totalFrames < 0 || metrics.averageFrameTime < 0.0f) return false;
     // Add more checks for your specific invariants
     return true;
@@ -63,232 +397,82 @@ bool GameState::isValid() const {
 
 void GameState::validateAndRepair() {
     // Repair invalid states
-    if (currentNPC < -1) currentNPC = -1;
-    if (numDialogOptions < 0) numDialogOptions = 0;
-    if (numDialogOptions > 3) numDialogOptions = 3;
-    if (currentBuilding < -1) currentBuilding = -1;
-    if (playerY < 0.0f) playerY = 0.0f;
-    if (jumpVelocity < 0.0f) jumpVelocity = 0.0f;
-    if (swingsPerformed < 0) swingsPerformed = 0;
-    if (meleeHits < 0) meleeHits = 0;
-    if (score < 0) score = 0;
+    if (dialog.npc < -1) dialog.npc = -1;
+    if (dialog.node < -1) dialog.node = -1;
+    if (dialog.active && dialog.node < 0) {
+        // Saves from before the dialog graph record no node to resume at
+        dialog.active = false;
+        dialog.showWindow = false;
+    }
+    if (player.currentBuilding < -1) player.currentBuilding = -1;
+    if (player.y < 0.0f) player.y = 0.0f;
+    if (player.jumpVelocity < 0.0f) player.jumpVelocity = 0.0f;
+    if (combat.swingsPerformed < 0) combat.swingsPerformed = 0;
+    if (combat.meleeHits < 0) combat.meleeHits = 0;
+    if (combat.score < 0) combat.score = 0;
     
     // Player stats validation and repair
-    if (playerHealth < 0) playerHealth = 0;
-    if (playerHealth > maxPlayerHealth) playerHealth = maxPlayerHealth;
-    if (playerMana < 0) playerMana = 0;
-    if (playerMana > maxPlayerMana) playerMana = maxPlayerMana;
-    if (playerStamina < 0) playerStamina = 0;
-    if (playerStamina > maxPlayerStamina) playerStamina = maxPlayerStamina;
-    if (playerLevel < 1) playerLevel = 1;
-    if (playerExperience < 0) playerExperience = 0;
+    if (player.health < 0) player.health = 0;
+    if (player.health > player.maxHealth) player.health = player.maxHealth;
+    if (player.mana < 0) player.mana = 0;
+    if (player.mana > player.maxMana) player.mana = player.maxMana;
+    if (player.stamina < 0) player.stamina = 0;
+    if (player.stamina > player.maxStamina) player.stamina = player.maxStamina;
+    if (player.level < 1) player.level = 1;
+    if (player.experience < 0) player.experience = 0;
     if (metrics.totalFrames < 0) metrics.totalFrames = 0;
     if (metrics.averageFrameTime < 0.0f) metrics.averageFrameTime = 0.0f;
-    // Clear invalid dialog options if needed
-    for (int i = numDialogOptions; i < 3; ++i) {
-        dialogOptions[i] = "";
-    }
-    notifyChange("validated");
+    notifyChange(StateChange::VALIDATED);
 }
 
 void GameState::resetToDefaults() {
-    // Reset all members to default values
-    mouseReleased = false;
-    isInDialog = false;
-    currentNPC = -1;
-    dialogText = "";
-    for (int i = 0; i < 3; ++i) dialogOptions[i] = "";
-    numDialogOptions = 0;
-    showDialogWindow = false;
-    isInBuilding = false;
-    currentBuilding = -1;
-    showInteractPrompt = false;
-    interactPromptText = "";
-    lastOutdoorPosition = {0.0f, 1.75f, 0.0f};
-    playerY = 0.0f;
-    isJumping = false;
-    isGrounded = true;
-    jumpVelocity = 0.0f;
-    
-    // Reset player stats to defaults
-    playerHealth = 100;
-    maxPlayerHealth = 100;
-    playerMana = 50;
-    maxPlayerMana = 50;
-    playerStamina = 100;
-    maxPlayerStamina = 100;
-    playerLevel = 1;
-    playerExperience = 0;
-    
+    // Reset all members to default values; menus and the inventory window stay as they are
+    player = PlayerState{};
+    combat = CombatState{};
+    dialog = DialogState{};
+    tests = TestChecklist{};
+    ui.mouseReleased = false;
+    ui.showInteractPrompt = false;
+    ui.interactPromptText.clear();
+
     // Reset inventory system (will be recreated when needed)
     inventorySystem = nullptr;
-    
-    lastSwingTime = 0.0f;
-    swingCooldown = 0.5f;
-    swingsPerformed = 0;
-    meleeHits = 0;
-    score = 0;
-    testMouseCaptured = false;
-    testBuildingCollision = false;
-    testWASDMovement = false;
-    testSpaceJump = false;
-    testMouseLook = false;
-    testMeleeSwing = false;
-    testMeleeHitDetection = false;
-    testBuildingEntry = false;
-    testNPCInteraction = false;
-    lastCameraPos = {0.0f, 0.0f, 0.0f};
-    metrics = PerformanceMetrics{};
-    changeListeners_.clear();
-    notifyChange("reset");
-}
 
-void GameState::addChangeListener(StateChangeCallback callback) {
-    changeListeners_.push_back(callback);
+    metrics = PerformanceMetrics{};
+    notifyChange(StateChange::RESET);  // Listeners survive a reset so they hear about it
 }
 
-void GameState::notifyChange(const std::string& property) {
-    for (const auto& listener : changeListeners_) {
-        listener(property);
-    }
+void GameState::addChangeListener(StateChangeMask mask, StateChangeCallback callback) {
+    changeBus_.subscribe(mask, std::move(callback));
 }
 
 bool saveState(const GameState& state, const std::string& filename) {
-    std::ofstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open save file: " << filename << std::endl;
-        return false;
-    }
-
-    uint32_t version = VersionedSerializer::CURRENT_VERSION;
-    file.write(reinterpret_cast<const char*>(&version), sizeof(version));
-
-    // Binary write for all fields (manual)
-    file.write(reinterpret_cast<const char*>(&state.mouseReleased), sizeof(bool));
-    file.write(reinterpret_cast<const char*>(&state.isInDialog), sizeof(bool));
-    file.write(reinterpret_cast<const char*>(&state.currentNPC), sizeof(int));
-    writeString(file, state.dialogText);
-    file.write(reinterpret_cast<const char*>(&state.numDialogOptions), sizeof(int));
-    for (int i = 0; i < 3; ++i) {
-        writeString(file, state.dialogOptions[i]);
-    }
-    file.write(reinterpret_cast<const char*>(&state.showDialogWindow), sizeof(bool));
-    file.write(reinterpret_cast<const char*>(&state.isInBuilding), sizeof(bool));
-    file.write(reinterpret_cast<const char*>(&state.currentBuilding), sizeof(int));
-    file.write(reinterpret_cast<const char*>(&state.showInteractPrompt), sizeof(bool));
-    writeString(file, state.interactPromptText);
-    file.write(reinterpret_cast<const char*>(&state.lastOutdoorPosition), sizeof(Vector3));
-    file.write(reinterpret_cast<const char*>(&state.playerY), sizeof(float));
-    file.write(reinterpret_cast<const char*>(&state.isJumping), sizeof(bool));
-    file.write(reinterpret_cast<const char*>(&state.isGrounded), sizeof(bool));
-    file.write(reinterpret_cast<const char*>(&state.jumpVelocity), sizeof(float));
-
-    // Player stats
-    file.write(reinterpret_cast<const char*>(&state.playerHealth), sizeof(int));
-    file.write(reinterpret_cast<const char*>(&state.maxPlayerHealth), sizeof(int));
-    file.write(reinterpret_cast<const char*>(&state.playerMana), sizeof(int));
-    file.write(reinterpret_cast<const char*>(&state.maxPlayerMana), sizeof(int));
-    file.write(reinterpret_cast<const char*>(&state.playerStamina), sizeof(int));
-    file.write(reinterpret_cast<const char*>(&state.maxPlayerStamina), sizeof(int));
-    file.write(reinterpret_cast<const char*>(&state.playerLevel), sizeof(int));
-    file.write(reinterpret_cast<const char*>(&state.playerExperience), sizeof(int));
-
-    file.write(reinterpret_cast<const char*>(&state.lastSwingTime), sizeof(float));
-    file.write(reinterpret_cast<const char*>(&state.swingsPerformed), sizeof(int));
-    file.write(reinterpret_cast<const char*>(&state.meleeHits), sizeof(int));
-    file.write(reinterpret_cast<const char*>(&state.score), sizeof(int));
-
-    // Testing states
-    file.write(reinterpret_cast<const char*>(&state.testMouseCaptured), sizeof(bool));
-    file.write(reinterpret_cast<const char*>(&state.testBuildingCollision), sizeof(bool));
-    file.write(reinterpret_cast<const char*>(&state.testWASDMovement), sizeof(bool));
-    file.write(reinterpret_cast<const char*>(&state.testSpaceJump), sizeof(bool));
-    file.write(reinterpret_cast<const char*>(&state.testMouseLook), sizeof(bool));
-    file.write(reinterpret_cast<const char*>(&state.testMeleeSwing), sizeof(bool));
-    file.write(reinterpret_cast<const char*>(&state.testMeleeHitDetection), sizeof(bool));
-    file.write(reinterpret_cast<const char*>(&state.testBuildingEntry), sizeof(bool));
-    file.write(reinterpret_cast<const char*>(&state.testNPCInteraction), sizeof(bool));
-    file.write(reinterpret_cast<const char*>(&state.lastCameraPos), sizeof(Vector3));
-
-    // Performance metrics (simple; skip frameTimeHistory for now)
-    file.write(reinterpret_cast<const char*>(&state.metrics.averageFrameTime), sizeof(float));
-    file.write(reinterpret_cast<const char*>(&state.metrics.totalFrames), sizeof(int));
-
-    if (!file.good()) {
-        std::cerr << "Error writing save file" << std::endl;
-        return false;
-    }
+    // Serializing is the snapshot; disk I/O and the atomic replace happen on the save thread
+    std::vector<char> image;
+    VersionedSerializer::serialize(state, image);
+    SaveWriter::getInstance().submit(filename, std::move(image));
     return true;
 }
 
 bool loadState(GameState& state, const std::string& filename) {
-    std::ifstream file(filename, std::ios::binary);
+    SaveWriter::getInstance().flush();  // A save queued just before this load must land first
+
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
     if (!file.is_open()) {
         std::cerr << "Failed to open load file: " << filename << std::endl;
         state.resetToDefaults();  // Error recovery: reset to defaults
         return false;
     }
 
-    uint32_t version;
-    file.read(reinterpret_cast<char*>(&version), sizeof(version));
-    if (version != VersionedSerializer::CURRENT_VERSION) {
-        std::cerr << "Unsupported save version: " << version << std::endl;
-        state.resetToDefaults();  // Error recovery
-        return false;
-    }
+    std::vector<char> bytes(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    bool ok = static_cast<bool>(file.read(bytes.data(), static_cast<std::streamsize>(bytes.size())));
 
-    // Binary read for all fields
-    file.read(reinterpret_cast<char*>(&state.mouseReleased), sizeof(bool));
-    file.read(reinterpret_cast<char*>(&state.isInDialog), sizeof(bool));
-    file.read(reinterpret_cast<char*>(&state.currentNPC), sizeof(int));
-    state.dialogText = readString(file);
-    file.read(reinterpret_cast<char*>(&state.numDialogOptions), sizeof(int));
-    for (int i = 0; i < 3; ++i) {
-        state.dialogOptions[i] = readString(file);
+    if (ok) {
+        ok = VersionedSerializer().deserialize(state, bytes.data(), bytes.size());
     }
-    file.read(reinterpret_cast<char*>(&state.showDialogWindow), sizeof(bool));
-    file.read(reinterpret_cast<char*>(&state.isInBuilding), sizeof(bool));
-    file.read(reinterpret_cast<char*>(&state.currentBuilding), sizeof(int));
-    file.read(reinterpret_cast<char*>(&state.showInteractPrompt), sizeof(bool));
-    state.interactPromptText = readString(file);
-    file.read(reinterpret_cast<char*>(&state.lastOutdoorPosition), sizeof(Vector3));
-    file.read(reinterpret_cast<char*>(&state.playerY), sizeof(float));
-    file.read(reinterpret_cast<char*>(&state.isJumping), sizeof(bool));
-    file.read(reinterpret_cast<char*>(&state.isGrounded), sizeof(bool));
-    file.read(reinterpret_cast<char*>(&state.jumpVelocity), sizeof(float));
 
-    // Player stats
-    file.read(reinterpret_cast<char*>(&state.playerHealth), sizeof(int));
-    file.read(reinterpret_cast<char*>(&state.maxPlayerHealth), sizeof(int));
-    file.read(reinterpret_cast<char*>(&state.playerMana), sizeof(int));
-    file.read(reinterpret_cast<char*>(&state.maxPlayerMana), sizeof(int));
-    file.read(reinterpret_cast<char*>(&state.playerStamina), sizeof(int));
-    file.read(reinterpret_cast<char*>(&state.maxPlayerStamina), sizeof(int));
-    file.read(reinterpret_cast<char*>(&state.playerLevel), sizeof(int));
-    file.read(reinterpret_cast<char*>(&state.playerExperience), sizeof(int));
-
-    file.read(reinterpret_cast<char*>(&state.lastSwingTime), sizeof(float));
-    file.read(reinterpret_cast<char*>(&state.swingsPerformed), sizeof(int));
-    file.read(reinterpret_cast<char*>(&state.meleeHits), sizeof(int));
-    file.read(reinterpret_cast<char*>(&state.score), sizeof(int));
-
-    // Testing states
-    file.read(reinterpret_cast<char*>(&state.testMouseCaptured), sizeof(bool));
-    file.read(reinterpret_cast<char*>(&state.testBuildingCollision), sizeof(bool));
-    file.read(reinterpret_cast<char*>(&state.testWASDMovement), sizeof(bool));
-    file.read(reinterpret_cast<char*>(&state.testSpaceJump), sizeof(bool));
-    file.read(reinterpret_cast<char*>(&state.testMouseLook), sizeof(bool));
-    file.read(reinterpret_cast<char*>(&state.testMeleeSwing), sizeof(bool));
-    file.read(reinterpret_cast<char*>(&state.testMeleeHitDetection), sizeof(bool));
-    file.read(reinterpret_cast<char*>(&state.testBuildingEntry), sizeof(bool));
-    file.read(reinterpret_cast<char*>(&state.testNPCInteraction), sizeof(bool));
-    file.read(reinterpret_cast<char*>(&state.lastCameraPos), sizeof(Vector3));
-
-    // Performance metrics
-    file.read(reinterpret_cast<char*>(&state.metrics.averageFrameTime), sizeof(float));
-    file.read(reinterpret_cast<char*>(&state.metrics.totalFrames), sizeof(int));
-
-    if (!file.good()) {
+    if (!ok) {
         std::cerr << "Error reading save file" << std::endl;
         state.resetToDefaults();  // Error recovery
         return false;
@@ -4,7 +4,10 @@
 #include "raylib.h"
 #include "inventory.h"
 #include "input_manager.h"
+#include "state_change.h"
+#include <atomic>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include <functional>
 #include <chrono>
@@ -18,83 +21,256 @@ struct PerformanceMetrics {
     std::vector<float> frameTimeHistory;  // Last N frame times (e.g., limit to 100 for recent history)
 };
 
+// ============================================================================
+// SAVE FORMAT (little-endian, version 4)
+//
+//   SaveHeader
+//   chunk_count x { char id[4], uint32_t payload size, payload }
+//
+// The STAT chunk is a TaggedRecord of StateField ids. Unknown chunk ids are skipped, and so
+// are unknown field ids, so additions don't break older readers. Older saves load through
+// the same path: their fields are decoded into a TaggedRecord, migrated, then applied.
+//   version 0: text, one `name=value` line per field (browserwind_save.dat)
+//   version 1: uint32_t version, then fixed-order binary fields
+//   version 2: SaveHeader + chunks, with fixed-order binary fields in STAT
+//   version 3: INVT and EQUP write every item's definition in full
+// ============================================================================
+
+class TaggedRecord;
+
+namespace SaveFormat {
+    constexpr char MAGIC[4] = {'B', 'W', 'S', 'V'};
+    constexpr uint32_t TEXT_VERSION = 0;
+    constexpr uint32_t LEGACY_VERSION = 1;
+    constexpr uint32_t FIXED_ORDER_VERSION = 2;
+    constexpr uint32_t FULL_ITEMS_VERSION = 3;
+
+    constexpr char STATE_CHUNK[4] = {'S', 'T', 'A', 'T'};      // GameState fields
+    constexpr char INVENTORY_CHUNK[4] = {'I', 'N', 'V', 'T'};  // AdventurerInventory
+    constexpr char EQUIPMENT_CHUNK[4] = {'E', 'Q', 'U', 'P'};  // EquipmentManager
+
+    struct SaveHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t chunk_count;
+        uint32_t reserved;
+    };
+
+    static_assert(sizeof(SaveHeader) == 16, "SaveHeader layout is part of the file format");
+
+    /// Field ids in the STAT chunk. Ids are permanent: retire a field by leaving its id unused.
+    enum StateField : uint16_t {
+        MOUSE_RELEASED = 1,
+        IS_IN_DIALOG = 2,
+        CURRENT_NPC = 3,
+        DIALOG_TEXT = 4,            // Retired: text lives in the dialog graph, see DIALOG_NODE
+        NUM_DIALOG_OPTIONS = 5,     // Retired
+        DIALOG_OPTION_0 = 6,        // Retired
+        DIALOG_OPTION_1 = 7,        // Retired
+        DIALOG_OPTION_2 = 8,        // Retired
+        SHOW_DIALOG_WINDOW = 9,
+        IS_IN_BUILDING = 10,
+        CURRENT_BUILDING = 11,
+        SHOW_INTERACT_PROMPT = 12,
+        INTERACT_PROMPT_TEXT = 13,
+        LAST_OUTDOOR_POSITION = 14,
+        PLAYER_Y = 15,
+        IS_JUMPING = 16,
+        IS_GROUNDED = 17,
+        JUMP_VELOCITY = 18,
+        PLAYER_HEALTH = 19,
+        MAX_PLAYER_HEALTH = 20,
+        PLAYER_MANA = 21,
+        MAX_PLAYER_MANA = 22,
+        PLAYER_STAMINA = 23,
+        MAX_PLAYER_STAMINA = 24,
+        PLAYER_LEVEL = 25,
+        PLAYER_EXPERIENCE = 26,
+        LAST_SWING_TIME = 27,
+        SWINGS_PERFORMED = 28,
+        MELEE_HITS = 29,
+        SCORE = 30,
+        TEST_MOUSE_CAPTURED = 31,
+        TEST_BUILDING_COLLISION = 32,
+        TEST_WASD_MOVEMENT = 33,
+        TEST_SPACE_JUMP = 34,
+        TEST_MOUSE_LOOK = 35,
+        TEST_MELEE_SWING = 36,
+        TEST_MELEE_HIT_DETECTION = 37,
+        TEST_BUILDING_ENTRY = 38,
+        TEST_NPC_INTERACTION = 39,
+        LAST_CAMERA_POS = 40,
+        AVERAGE_FRAME_TIME = 41,
+        TOTAL_FRAMES = 42,
+        DIALOG_NODE = 43,
+
+        // Version 0 text saves split vectors into per-axis floats; migrated into the fields above
+        TEXT_LAST_OUTDOOR_X = 1000,
+        TEXT_LAST_OUTDOOR_Y = 1001,
+        TEXT_LAST_OUTDOOR_Z = 1002,
+        TEXT_LAST_CAMERA_X = 1003,
+        TEXT_LAST_CAMERA_Y = 1004,
+        TEXT_LAST_CAMERA_Z = 1005
+    };
+}
+
+struct GameState;
+
 /// \brief Versioned serializer for game state with migration support.
+///
+/// Encodes GameState plus its linked inventory and equipment into one in-memory save image;
+/// the image is the snapshot that SaveWriter puts on disk off the main thread. Loading decodes
+/// the state fields of any supported version into a TaggedRecord, runs each migrator from the
+/// file's version up to CURRENT_VERSION on it, then copies the known fields into GameState.
 class VersionedSerializer {
 public:
-    static constexpr uint32_t CURRENT_VERSION = 1;
+    static constexpr uint32_t CURRENT_VERSION = 4;
 
-    /// \brief Serializes an object to stream.
-    /// \tparam T Type of object to serialize.
-    /// \param obj Object to serialize.
-    /// \param stream Output stream.
-    /// \return True on success.
-    template<typename T>
-    bool serialize(const T& obj, std::ostream& stream);
+    using Migrator = std::function<void(TaggedRecord&)>;
+
+    /// \brief Registers the built-in migrators for older save versions.
+    VersionedSerializer();
 
-    /// \brief Deserializes an object from stream.
-    /// \tparam T Type of object to deserialize.
-    /// \param obj Object to fill.
-    /// \param stream Input stream.
+    /// \brief Encodes state, and its inventory and equipment if linked, as a save image.
+    /// \param state State to encode.
+    /// \param out Receives the image; previous contents are replaced.
+    static void serialize(const GameState& state, std::vector<char>& out);
+
+    /// \brief Decodes a save image of any supported version (see SAVE FORMAT).
+    /// Fields the save doesn't contain keep their current values. Inventory and equipment
+    /// are only replaced once their chunks decode completely.
+    /// \param state State to fill.
+    /// \param data Image bytes.
+    /// \param size Image size.
     /// \return True on success.
-    template<typename T>
-    bool deserialize(T& obj, std::istream& stream);
+    bool deserialize(GameState& state, const char* data, size_t size) const;
 
-    /// \brief Registers a migration function for a version.
+    /// \brief Registers a migration that upgrades state fields from `fromVersion` to the next version.
     /// \param fromVersion Version to migrate from.
-    /// \param migrator Migration function.
-    void registerMigrator(uint32_t fromVersion, std::function<void(std::istream&)> migrator);
+    /// \param migrator Edits the decoded fields in place.
+    void registerMigrator(uint32_t fromVersion, Migrator migrator);
 
 private:
-    std::unordered_map<uint32_t, std::function<void(std::istream&)>> migrators_;
+    std::unordered_map<uint32_t, Migrator> migrators_;
 };
 
-/// \brief Main game state struct.
-/// This holds all runtime game state data. To address SRP, consider splitting into sub-structs (e.g., PlayerState, UIState) in future.
-struct GameState {
+/// \brief Player simulation state, read and written every step.
+struct PlayerState {
+    float y = 0.0f;
+    float jumpVelocity = 0.0f;
+    bool isJumping = false;
+    bool isGrounded = true;
+    bool isInBuilding = false;
+    int currentBuilding = -1;
+    Vector3 lastOutdoorPosition = {0.0f, 1.75f, 0.0f};
+    Vector3 lastCameraPos = {0.0f, 0.0f, 0.0f};  // Initialized to zero or camera start
+
+    // RPG stats
+    int health = 100;
+    int maxHealth = 100;
+    int mana = 50;
+    int maxMana = 50;
+    int stamina = 100;
+    int maxStamina = 100;
+    int level = 1;
+    int experience = 0;
+};
+
+/// \brief Melee timing and results.
+struct CombatState {
+    float lastSwingTime = 0.0f;
+    float swingCooldown = 0.5f;  // 500ms between swings
+    int swingsPerformed = 0;
+    int meleeHits = 0;
+    int score = 0;
+};
+
+/// \brief The hot simulation state as one plain value: what a SimulationSnapshot publishes.
+struct alignas(64) SimulationState {
+    PlayerState player;
+    CombatState combat;
+};
+
+static_assert(std::is_trivially_copyable<SimulationState>::value, "Snapshots copy SimulationState as bytes");
+static_assert(sizeof(SimulationState) <= 128, "SimulationState should stay within two cache lines");
+
+/// \brief Conversation the player is in; text and options are looked up from DialogSystem.
+struct DialogState {
+    bool active = false;
+    bool showWindow = false;
+    int npc = -1;
+    int node = -1;  // Node in DialogSystem's graph
+};
+
+/// \brief Window, menu and prompt state. Only UI code and input handling touch it.
+struct UIState {
     bool mouseReleased = false;
 
-    // Dialog state
-    bool isInDialog = false;
-    int currentNPC = -1;
-    std::string dialogText = "";
-    std::string dialogOptions[3] = {"", "", ""};
-    int numDialogOptions = 0;
-    bool showDialogWindow = false;
-    
-    // Inventory UI state
+    // Inventory window
     bool showInventoryWindow = false;
-    std::string lastClickedItem = "";  // For inventory item interactions
-    std::string inventorySearchQuery = "";  // Current search query
     bool inventorySearchActive = false;  // Whether search is active
-    
-    // ESC Menu system
+    int inventoryScrollRow = 0;  // First item row shown in the inventory list
+    std::string lastClickedItem;  // For inventory item interactions
+    std::string inventorySearchQuery;  // Current search query
+
+    // ESC menu: 0=Resume, 1=Save, 2=Load, 3=Quit
     bool showEscMenu = false;
     int selectedMenuOption = 0;
-    bool showTestingPanel = false;  // **TAB KEY TOGGLE** - Detailed testing checklist  // 0=Resume, 1=Save, 2=Load, 3=Quit
+    bool showTestingPanel = false;  // **TAB KEY TOGGLE** - Detailed testing checklist
 
-    // Game state
-    bool isInBuilding = false;
-    int currentBuilding = -1;
     bool showInteractPrompt = false;
-    std::string interactPromptText = "";
-    Vector3 lastOutdoorPosition = {0.0f, 1.75f, 0.0f};
+    std::string interactPromptText;
+};
+
+/// \brief Testing checklist: which features the player has exercised this session.
+struct TestChecklist {
+    bool mouseCaptured = false;
+    bool buildingCollision = false;
+    bool wasdMovement = false;
+    bool spaceJump = false;
+    bool mouseLook = false;
+    bool meleeSwing = false;
+    bool meleeHitDetection = false;
+    bool buildingEntry = false;
+    bool npcInteraction = false;
+};
+
+/// \brief Double-buffered copy of the last published SimulationState.
+///
+/// The main thread publishes after each simulation step; any thread can read() the latest
+/// published state without a lock while the next step runs. publish() fills the buffer
+/// readers aren't pointed at and then flips to it. A reader that was still copying the other
+/// buffer when a second publish started sees the generation move and copies again, which at
+/// one publish per step means a read almost never repeats.
+class SimulationSnapshot {
+public:
+    /// \brief Publishes `state` as the latest snapshot. Main thread only.
+    void publish(const SimulationState& state);
+
+    /// \brief Copies the latest published state. Any thread.
+    SimulationState read() const;
+
+    /// \brief Number of publishes so far; 0 means read() returns defaults.
+    uint64_t getGeneration() const { return generation_.load(std::memory_order_acquire); }
+
+private:
+    SimulationState buffers_[2];
+    std::atomic<uint64_t> generation_{0};  // buffers_[generation_ & 1] is the latest
+};
+
+/// \brief Main game state struct.
+/// Hot simulation data comes first, in its own cache lines, then the cold UI, dialog and
+/// bookkeeping state that changes on input rather than every step.
+struct GameState {
+    // Hot: every simulation step
+    alignas(64) PlayerState player;
+    CombatState combat;
+
+    // Cold
+    DialogState dialog;
+    UIState ui;
+    TestChecklist tests;
 
-    // Player state
-    float playerY = 0.0f;
-    bool isJumping = false;
-    bool isGrounded = true;
-    float jumpVelocity = 0.0f;
-    
-    // Player stats and RPG mechanics
-    int playerHealth = 100;
-    int maxPlayerHealth = 100;
-    int playerMana = 50;
-    int maxPlayerMana = 50;
-    int playerStamina = 100;
-    int maxPlayerStamina = 100;
-    int playerLevel = 1;
-    int playerExperience = 0;
-    
     // Inventory system (pointer to Game's owned inventory)
     InventorySystem* inventorySystem = nullptr;
 
@@ -104,29 +280,18 @@ struct GameState {
     // **PHASE 2 ENHANCEMENT**: Enhanced Input Manager for centralized input handling
     mutable EnhancedInputManager enhancedInput;
 
-    // Combat timing
-    float lastSwingTime = 0.0f;
-    float swingCooldown = 0.5f; // 500ms between swings
+    // New: Performance metrics
+    PerformanceMetrics metrics;
 
-    // Stats
-    int swingsPerformed = 0;
-    int meleeHits = 0;
-    int score = 0;
+    /// \brief Copies the hot state as one value.
+    SimulationState captureSimulation() const { return {player, combat}; }
 
-    // Testing state
-    bool testMouseCaptured = false;
-    bool testBuildingCollision = false;
-    bool testWASDMovement = false;
-    bool testSpaceJump = false;
-    bool testMouseLook = false;
-    bool testMeleeSwing = false;
-    bool testMeleeHitDetection = false;
-    bool testBuildingEntry = false;
-    bool testNPCInteraction = false;
-    Vector3 lastCameraPos = {0.0f, 0.0f, 0.0f};  // Initialized to zero or camera start
+    /// \brief Publishes the hot state for readers off the main thread. Game calls this after
+    /// every simulation step.
+    void publishSimulation() { simulationSnapshot_.publish(captureSimulation()); }
 
-    // New: Performance metrics
-    PerformanceMetrics metrics;
+    /// \brief State as of the last publishSimulation(), readable from any thread.
+    const SimulationSnapshot& getSimulationSnapshot() const { return simulationSnapshot_; }
 
     // New: State validation methods
     /// \brief Checks if state is valid.
@@ -139,29 +304,35 @@ struct GameState {
     /// \brief Resets state to defaults.
     void resetToDefaults();
 
-    // New: State change notifications
-    using StateChangeCallback = std::function<void(const std::string& property)>;
+    // State change notifications: posted as they happen, delivered once per frame
+    using StateChangeCallback = StateChangeBus::Listener;
     /// \brief Adds a change listener.
-    /// \param callback Callback to add.
-    void addChangeListener(StateChangeCallback callback);
+    /// \param mask Properties the listener cares about.
+    /// \param callback Called from dispatchChanges() with the changes in `mask`.
+    void addChangeListener(StateChangeMask mask, StateChangeCallback callback);
 
-    /// \brief Notifies listeners of change.
+    /// \brief Records a change; listeners hear about it at the next dispatchChanges().
     /// \param property Changed property.
-    void notifyChange(const std::string& property);
-    
+    void notifyChange(StateChange::Property property) { changeBus_.post(property); }
+
+    /// \brief Delivers the changes recorded since the last call. Game calls this once per
+    /// frame, after the simulation steps and before rendering.
+    void dispatchChanges() { changeBus_.dispatch(); }
+
     // New: Save/Load convenience methods
-    /// \brief Saves state to file.
+    /// \brief Snapshots state and queues it for writing on the save thread.
     /// \param filename File to save to.
-    /// \return True on success.
+    /// \return True once the snapshot is queued.
     bool saveState(const std::string& filename = "browserwind_save.dat") const;
 
-    /// \brief Loads state from file.
+    /// \brief Loads state from file (one read, then an in-memory parse).
     /// \param filename File to load from.
     /// \return True on success.
     bool loadState(const std::string& filename = "browserwind_save.dat");
 
 private:
-    std::vector<StateChangeCallback> changeListeners_;
+    StateChangeBus changeBus_;
+    SimulationSnapshot simulationSnapshot_;
 };
 
 // Standalone serialization functions (using VersionedSerializer internally)
@@ -1,12 +1,51 @@
 #include "input_manager.h"
+#include "constants.h"
 #include <iostream>
+#include <fstream>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <cassert>
+
+namespace {
+    // Keys and buttons sampled each update(); order is the bit order in recordings
+    constexpr int TRACKED_KEYS[] = {
+        KEY_W, KEY_A, KEY_S, KEY_D, KEY_SPACE, KEY_I, KEY_E,
+        KEY_ESCAPE, KEY_P, KEY_ONE, KEY_TWO, KEY_THREE, KEY_FOUR, KEY_FIVE,
+        KEY_TAB,  // **ADDED**: TAB key for testing panel
+        KEY_F9    // Profiler trace capture
+    };
+    constexpr int TRACKED_KEY_COUNT = sizeof(TRACKED_KEYS) / sizeof(TRACKED_KEYS[0]);
+
+    constexpr int TRACKED_BUTTONS[] = { MOUSE_BUTTON_LEFT, MOUSE_BUTTON_RIGHT, MOUSE_BUTTON_MIDDLE };
+    constexpr int TRACKED_BUTTON_COUNT = sizeof(TRACKED_BUTTONS) / sizeof(TRACKED_BUTTONS[0]);
+
+    static_assert(TRACKED_KEY_COUNT <= 32, "Key masks in FrameRecord are 32 bits");
+    static_assert(TRACKED_BUTTON_COUNT <= 8, "Button masks in FrameRecord are 8 bits");
+
+    int trackedKeyBit(int key) {
+        for (int i = 0; i < TRACKED_KEY_COUNT; i++) {
+            if (TRACKED_KEYS[i] == key) return i;
+        }
+        return -1;
+    }
+
+    int trackedButtonBit(int button) {
+        for (int i = 0; i < TRACKED_BUTTON_COUNT; i++) {
+            if (TRACKED_BUTTONS[i] == button) return i;
+        }
+        return -1;
+    }
+}
 
 // **ENHANCED INPUT MANAGER IMPLEMENTATION**
 
-EnhancedInputManager::EnhancedInputManager() {
-    // **INITIALIZE KEY BINDINGS** - Set up default game controls
+EnhancedInputManager::EnhancedInputManager()
+    : action_callbacks_(std::make_shared<CallbackTable>()) {
+    static_assert(TRACKED_KEY_COUNT <= static_cast<int>(MAX_TRACKED_KEYS), "Per-key arrays are too small");
+    action_events_.reserve(2 * InputActions::MAX_ACTIONS);
+
+    // **INITIALIZE KEY BINDINGS** - Set up default game controls, in InputActions order
     setKeyBinding("move_forward", KEY_W);
     setKeyBinding("move_backward", KEY_S);
     setKeyBinding("strafe_left", KEY_A);
@@ -18,37 +57,73 @@ EnhancedInputManager::EnhancedInputManager() {
     setKeyBinding("performance_toggle", KEY_P);
     setKeyBinding("quick_use", KEY_ONE);
     setKeyBinding("testing_panel", KEY_TAB);
+    setKeyBinding("profile_capture", KEY_F9);
+    assert(getActionId("profile_capture") == InputActions::PROFILE_CAPTURE && actions_->names.size() == InputActions::BUILTIN_COUNT);
     
     std::cout << "Enhanced Input Manager initialized with default key bindings" << std::endl;
 }
 
+void EnhancedInputManager::poll() {
+    external_polling_ = true;
+    if (!input_enabled_ || replay_frames_) return;
+    accumulatePending();
+}
+
 void EnhancedInputManager::update(float deltaTime) {
     current_time_ += deltaTime;
+    last_delta_time_ = deltaTime;
     
     if (!input_enabled_) {
         return;  // Skip input processing if disabled
     }
     
-    // **UPDATE KEYBOARD STATE** - Check all tracked keys
-    std::vector<int> commonKeys = {
-        KEY_W, KEY_A, KEY_S, KEY_D, KEY_SPACE, KEY_I, KEY_E,
-        KEY_ESCAPE, KEY_P, KEY_ONE, KEY_TWO, KEY_THREE, KEY_FOUR, KEY_FIVE,
-        KEY_TAB  // **ADDED**: TAB key for testing panel
-    };
+    // **SAMPLE INPUT** - Next replay frame if one is running, otherwise raylib
+    if (replay_frames_ && replay_index_ >= replay_frames_->size()) {
+        std::cout << "INPUT: Replay finished after " << replay_index_ << " frames" << std::endl;
+        stopReplay();
+    }
+    
+    InputRecordingFormat::FrameRecord frame{};
+    RawMouseSampler::Clock::time_point sampleTime =
+        has_mouse_sample_time_ ? mouse_sample_time_ : RawMouseSampler::Clock::now();
+    has_mouse_sample_time_ = false;
+    bool rawMouse = isRawMouseActive();
     
-    for (int key : commonKeys) {
-        updateKeyState(key, key_states_[key]);
+    if (replay_frames_) {
+        frame = (*replay_frames_)[replay_index_++];
+        if (rawMouse) raw_mouse_->drain(sampleTime);  // Live motion is ignored, don't let it queue up
+    } else {
+        if (!external_polling_) {
+            accumulatePending();
+        }
+        frame = pending_frame_;
+        frame.delta_time = deltaTime;
+        if (rawMouse) {
+            // Only the motion that happened during this step, not the whole rendered frame's
+            Vector2 raw = raw_mouse_->drain(sampleTime);
+            frame.mouse_delta[0] = raw.x * PlayerConstants::RAW_MOUSE_SCALE;
+            frame.mouse_delta[1] = raw.y * PlayerConstants::RAW_MOUSE_SCALE;
+        }
+
+        // Edges and motion belong to this step only; held state carries into the next
+        pending_frame_.keys_pressed = 0;
+        pending_frame_.buttons_pressed = 0;
+        pending_frame_.mouse_delta[0] = 0.0f;
+        pending_frame_.mouse_delta[1] = 0.0f;
     }
     
-    // **UPDATE MOUSE STATE** - Check mouse buttons
-    std::vector<int> mouseButtons = { MOUSE_BUTTON_LEFT, MOUSE_BUTTON_RIGHT, MOUSE_BUTTON_MIDDLE };
-    for (int button : mouseButtons) {
-        updateMouseState(button, mouse_states_[button]);
+    if (record_stream_) {
+        record_stream_->write(reinterpret_cast<const char*>(&frame), sizeof(frame));
     }
     
+    // **UPDATE KEYBOARD, MOUSE AND ACTION STATE** - Bitsets in tracked-key order
+    updateKeys(frame.keys_down, frame.keys_pressed);
+    updateButtons(frame.buttons_down, frame.buttons_pressed);
+    updateActions();
+    
     // **UPDATE MOUSE POSITION AND DELTA**
-    mouse_position_ = GetMousePosition();
-    Vector2 rawDelta = GetMouseDelta();
+    mouse_position_ = {frame.mouse_position[0], frame.mouse_position[1]};
+    Vector2 rawDelta = {frame.mouse_delta[0], frame.mouse_delta[1]};
     mouse_delta_ = {rawDelta.x * mouse_sensitivity_, rawDelta.y * mouse_sensitivity_};
 
     // Debug mouse input every 60 frames
@@ -78,16 +153,8 @@ void EnhancedInputManager::update(float deltaTime) {
     mouse_delta_smoothed_.y = mouse_delta_smoothed_.y * (1.0f - MOUSE_SMOOTHING_FACTOR) + 
                            mouse_delta_.y * MOUSE_SMOOTHING_FACTOR;
     
-    // **NEW: DISPATCH ACTION CALLBACKS**
-    for (const auto& pair : key_bindings_) {
-        const std::string& action = pair.first;
-        if (isActionPressed(action)) {
-            auto cbIt = action_callbacks_.find(action);
-            if (cbIt != action_callbacks_.end()) {
-                cbIt->second();  // Call the callback
-            }
-        }
-    }
+    // **DISPATCH ACTION EVENTS** - Subscribers drain this update's queue once
+    dispatchActionEvents();
     
     // **CLEAN UP OLD EVENTS** from buffer
     while (!event_buffer_.empty() && event_buffer_.size() > MAX_BUFFER_SIZE) {
@@ -96,73 +163,61 @@ void EnhancedInputManager::update(float deltaTime) {
 }
 
 void EnhancedInputManager::reset() {
-    key_states_.clear();
-    mouse_states_.clear();
+    keys_down_ = keys_pressed_ = keys_released_ = 0;
+    buttons_down_ = buttons_pressed_ = buttons_released_ = 0;
+    key_press_time_.fill(0.0f);
+    action_pressed_ = action_down_ = action_released_ = 0;
+    action_events_.clear();
     clearInputBuffer();
     mouse_delta_ = {0, 0};
     mouse_delta_smoothed_ = {0, 0};
+    pending_frame_ = {};
     std::cout << "Input Manager reset completed" << std::endl;
 }
 
 // **KEYBOARD INPUT METHODS**
 
 bool EnhancedInputManager::isKeyPressed(int key) const {
-    if (!input_enabled_ || isKeyDebounced(key)) return false;
-    auto it = key_states_.find(key);
-    return it != key_states_.end() && it->second.isPressed;
+    return input_enabled_ && testBit(keys_pressed_, trackedKeyBit(key));
 }
 
 bool EnhancedInputManager::isKeyReleased(int key) const {
-    if (!input_enabled_) return false;
-    auto it = key_states_.find(key);
-    return it != key_states_.end() && it->second.wasPressed && !it->second.isDown;
+    return input_enabled_ && testBit(keys_released_, trackedKeyBit(key));
 }
 
 bool EnhancedInputManager::isKeyDown(int key) const {
-    if (!input_enabled_) return false;
-    auto it = key_states_.find(key);
-    return it != key_states_.end() && it->second.isDown;
+    return input_enabled_ && testBit(keys_down_, trackedKeyBit(key));
 }
 
 bool EnhancedInputManager::isKeyUp(int key) const {
-    if (!input_enabled_) return true;
-    auto it = key_states_.find(key);
-    return it == key_states_.end() || !it->second.isDown;
+    return !isKeyDown(key);
 }
 
 float EnhancedInputManager::getKeyHoldDuration(int key) const {
-    auto it = key_states_.find(key);
-    return it != key_states_.end() ? it->second.holdDuration : 0.0f;
+    int bit = trackedKeyBit(key);
+    return testBit(keys_down_, bit) ? current_time_ - key_press_time_[bit] : 0.0f;
 }
 
 bool EnhancedInputManager::isKeyRepeating(int key, float interval) const {
-    if (!input_enabled_) return false;
-    auto it = key_states_.find(key);
-    if (it == key_states_.end() || !it->second.isDown) return false;
+    if (!isKeyDown(key)) return false;
     
     // Check if key has been held long enough for repeating
-    return it->second.holdDuration > 0.5f && 
-           std::fmod(it->second.holdDuration, interval) < GetFrameTime();
+    float holdDuration = getKeyHoldDuration(key);
+    return holdDuration > 0.5f && std::fmod(holdDuration, interval) < last_delta_time_;
 }
 
 // **MOUSE INPUT METHODS**
 
 bool EnhancedInputManager::isMouseButtonPressed(int button) const {
-    if (!input_enabled_) return false;
-    auto it = mouse_states_.find(button);
-    return it != mouse_states_.end() && it->second.isPressed;
+    return input_enabled_ && testBit(buttons_pressed_, trackedButtonBit(button));
 }
 
 bool EnhancedInputManager::isMouseButtonReleased(int button) const {
-    if (!input_enabled_) return false;
-    auto it = mouse_states_.find(button);
-    return it != mouse_states_.end() && it->second.wasPressed && !it->second.isDown;
+    return input_enabled_ && testBit(buttons_released_, trackedButtonBit(button));
 }
 
 bool EnhancedInputManager::isMouseButtonDown(int button) const {
-    if (!input_enabled_) return false;
-    auto it = mouse_states_.find(button);
-    return it != mouse_states_.end() && it->second.isDown;
+    return input_enabled_ && testBit(buttons_down_, trackedButtonBit(button));
 }
 
 Vector2 EnhancedInputManager::getMousePosition() const {
@@ -185,6 +240,33 @@ void EnhancedInputManager::setMouseSensitivity(float sensitivity) {
     mouse_sensitivity_ = sensitivity;
 }
 
+// **RAW MOUSE**
+
+bool EnhancedInputManager::startRawMouse(const std::string& device) {
+    stopRawMouse();
+    auto sampler = std::make_shared<RawMouseSampler>();
+    if (!sampler->start(device)) return false;
+    raw_mouse_ = std::move(sampler);
+    return true;
+}
+
+void EnhancedInputManager::stopRawMouse() {
+    if (!raw_mouse_) return;
+    if (raw_mouse_->getDroppedCount() > 0) {
+        std::cout << "INPUT: Raw mouse dropped " << raw_mouse_->getDroppedCount() << " reports" << std::endl;
+    }
+    raw_mouse_.reset();
+}
+
+bool EnhancedInputManager::isRawMouseActive() const {
+    return raw_mouse_ && raw_mouse_->isRunning();
+}
+
+void EnhancedInputManager::setMouseSampleTime(RawMouseSampler::Clock::time_point time) {
+    mouse_sample_time_ = time;
+    has_mouse_sample_time_ = true;
+}
+
 // **MOUSE CAPTURE MANAGEMENT**
 
 void EnhancedInputManager::setMouseCaptured(bool captured) {
@@ -223,21 +305,12 @@ bool EnhancedInputManager::isInputEnabled() const {
 }
 
 void EnhancedInputManager::addKeyDebounce(int key, float debounceTime) {
-    key_debounces_[key] = debounceTime;
+    int bit = trackedKeyBit(key);
+    if (bit >= 0) key_debounce_[bit] = debounceTime;
 }
 
 void EnhancedInputManager::clearKeyDebounces() {
-    key_debounces_.clear();
-}
-
-bool EnhancedInputManager::isKeyDebounced(int key) const {
-    auto it = key_debounces_.find(key);
-    if (it == key_debounces_.end()) return false;
-    
-    auto keyIt = key_states_.find(key);
-    if (keyIt == key_states_.end()) return false;
-    
-    return (current_time_ - keyIt->second.lastPressTime) < it->second;
+    key_debounce_.fill(0.0f);
 }
 
 // **INPUT BUFFERING**
@@ -271,33 +344,228 @@ void EnhancedInputManager::bufferInputEvent(InputEvent::Type type, int code) {
 
 // **KEY BINDING SYSTEM**
 
-void EnhancedInputManager::setKeyBinding(const std::string& action, int key) {
-    key_bindings_[action] = key;
+ActionId EnhancedInputManager::setKeyBinding(const std::string& action, int key) {
+    ActionId id = getActionId(action);
+    if (id == InputActions::INVALID) {
+        if (actions_ && actions_->names.size() >= InputActions::MAX_ACTIONS) {
+            std::cout << "INPUT: Cannot bind " << action << ", all " << static_cast<int>(InputActions::MAX_ACTIONS)
+                      << " actions are in use" << std::endl;
+            return InputActions::INVALID;
+        }
+        ActionTable& table = editActions();
+        id = static_cast<ActionId>(table.names.size());
+        table.names.push_back(action);
+        table.keys[id] = key;
+        table.keyBits[id] = static_cast<int8_t>(trackedKeyBit(key));
+        return id;
+    }
+    if (actions_->keys[id] != key) {
+        ActionTable& table = editActions();
+        table.keys[id] = key;
+        table.keyBits[id] = static_cast<int8_t>(trackedKeyBit(key));
+    }
+    return id;
 }
 
 int EnhancedInputManager::getKeyBinding(const std::string& action) const {
-    auto it = key_bindings_.find(action);
-    return it != key_bindings_.end() ? it->second : -1;
+    ActionId id = getActionId(action);
+    return id != InputActions::INVALID ? actions_->keys[id] : -1;
+}
+
+ActionId EnhancedInputManager::getActionId(const std::string& action) const {
+    if (!actions_) return InputActions::INVALID;
+    const std::vector<std::string>& names = actions_->names;
+    auto it = std::find(names.begin(), names.end(), action);
+    return it != names.end() ? static_cast<ActionId>(it - names.begin()) : InputActions::INVALID;
 }
 
 bool EnhancedInputManager::isActionPressed(const std::string& action) const {
-    int key = getKeyBinding(action);
-    return key != -1 && isKeyPressed(key);
+    return isActionPressed(getActionId(action));
 }
 
 bool EnhancedInputManager::isActionDown(const std::string& action) const {
-    int key = getKeyBinding(action);
-    return key != -1 && isKeyDown(key);
+    return isActionDown(getActionId(action));
+}
+
+EnhancedInputManager::ActionTable& EnhancedInputManager::editActions() {
+    // Copy-on-write: copies of this manager (GameState's) keep the table they were made with
+    std::shared_ptr<ActionTable> table;
+    if (actions_) {
+        table = std::make_shared<ActionTable>(*actions_);
+    } else {
+        table = std::make_shared<ActionTable>();
+        table->keys.fill(-1);
+        table->keyBits.fill(-1);
+    }
+    ActionTable& edited = *table;
+    actions_ = std::move(table);
+    return edited;
+}
+
+// **ACTION CALLBACKS**
+
+void EnhancedInputManager::registerActionCallback(ActionId action, std::function<void()> callback) {
+    if (action >= InputActions::MAX_ACTIONS) return;
+    (*action_callbacks_)[action] = std::move(callback);
 }
 
-// **NEW METHODS**
 void EnhancedInputManager::registerActionCallback(const std::string& action, std::function<void()> callback) {
-    action_callbacks_[action] = callback;
+    ActionId id = getActionId(action);
+    if (id == InputActions::INVALID) {
+        std::cout << "INPUT: No binding for action " << action << ", callback ignored" << std::endl;
+        return;
+    }
+    registerActionCallback(id, std::move(callback));
     std::cout << "Registered callback for action: " << action << std::endl;
 }
 
 void EnhancedInputManager::unregisterActionCallback(const std::string& action) {
-    action_callbacks_.erase(action);
+    ActionId id = getActionId(action);
+    if (id != InputActions::INVALID) {
+        (*action_callbacks_)[id] = nullptr;
+    }
+}
+
+// **RECORD & REPLAY**
+
+bool EnhancedInputManager::startRecording(const std::string& path) {
+    using namespace InputRecordingFormat;
+    stopRecording();
+
+    auto stream = std::make_shared<std::ofstream>(path, std::ios::binary | std::ios::trunc);
+    if (!*stream) {
+        std::cout << "INPUT: Cannot write recording " << path << std::endl;
+        return false;
+    }
+
+    RecordingHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.tracked_key_count = TRACKED_KEY_COUNT;
+    header.frame_record_size = sizeof(FrameRecord);
+    header.binding_count = actions_ ? static_cast<uint32_t>(actions_->names.size()) : 0;
+    header.mouse_sensitivity = mouse_sensitivity_;
+    stream->write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (int key : TRACKED_KEYS) {
+        int32_t code = key;
+        stream->write(reinterpret_cast<const char*>(&code), sizeof(code));
+    }
+    for (uint32_t id = 0; id < header.binding_count; id++) {
+        const std::string& name = actions_->names[id];
+        uint8_t length = static_cast<uint8_t>(std::min<size_t>(name.size(), 255));
+        int32_t key = actions_->keys[id];
+        stream->write(reinterpret_cast<const char*>(&length), sizeof(length));
+        stream->write(name.data(), length);
+        stream->write(reinterpret_cast<const char*>(&key), sizeof(key));
+    }
+
+    // Start from a clean slate so a replay, which does the same, sees identical state
+    reset();
+    current_time_ = 0.0f;
+    record_stream_ = std::move(stream);
+    std::cout << "INPUT: Recording to " << path << std::endl;
+    return true;
+}
+
+void EnhancedInputManager::stopRecording() {
+    if (!record_stream_) return;
+    record_stream_->flush();
+    record_stream_.reset();
+    std::cout << "INPUT: Recording stopped" << std::endl;
+}
+
+bool EnhancedInputManager::isRecording() const {
+    return record_stream_ != nullptr;
+}
+
+bool EnhancedInputManager::startReplay(const std::string& path) {
+    using namespace InputRecordingFormat;
+    std::ifstream file(path, std::ios::binary);
+    RecordingHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.frame_record_size != sizeof(FrameRecord) || header.tracked_key_count != TRACKED_KEY_COUNT) {
+        std::cout << "INPUT: " << path << " is not a compatible input recording" << std::endl;
+        return false;
+    }
+
+    for (int key : TRACKED_KEYS) {
+        int32_t code = 0;
+        if (!file.read(reinterpret_cast<char*>(&code), sizeof(code)) || code != key) {
+            std::cout << "INPUT: " << path << " tracks a different key set" << std::endl;
+            return false;
+        }
+    }
+
+    std::vector<std::pair<std::string, int>> bindings;
+    for (uint32_t i = 0; i < header.binding_count; i++) {
+        uint8_t length = 0;
+        std::string action;
+        int32_t key = 0;
+        bool ok = static_cast<bool>(file.read(reinterpret_cast<char*>(&length), sizeof(length)));
+        action.resize(length);
+        if (!ok || !file.read(&action[0], length) || !file.read(reinterpret_cast<char*>(&key), sizeof(key))) {
+            std::cout << "INPUT: " << path << " has a truncated binding table" << std::endl;
+            return false;
+        }
+        bindings.emplace_back(std::move(action), key);
+    }
+
+    // A partial trailing frame (recording cut off mid-write) is dropped
+    auto frames = std::make_shared<std::vector<FrameRecord>>();
+    FrameRecord frame{};
+    while (file.read(reinterpret_cast<char*>(&frame), sizeof(frame))) {
+        frames->push_back(frame);
+    }
+    if (frames->empty()) {
+        std::cout << "INPUT: " << path << " contains no frames" << std::endl;
+        return false;
+    }
+
+    stopReplay();
+    // Rebind onto the live ids, so ids cached by callers keep meaning the same action;
+    // actions the recording didn't bind stay unbound for the replay
+    live_actions_ = actions_;
+    live_mouse_sensitivity_ = mouse_sensitivity_;
+    ActionTable& table = editActions();
+    table.keys.fill(-1);
+    table.keyBits.fill(-1);
+    for (const auto& binding : bindings) {
+        setKeyBinding(binding.first, binding.second);
+    }
+    mouse_sensitivity_ = header.mouse_sensitivity;
+
+    reset();
+    current_time_ = 0.0f;
+    replay_frames_ = std::move(frames);
+    replay_index_ = 0;
+    std::cout << "INPUT: Replaying " << replay_frames_->size() << " frames from " << path << std::endl;
+    return true;
+}
+
+void EnhancedInputManager::stopReplay() {
+    if (!replay_frames_) return;
+    replay_frames_.reset();
+    replay_index_ = 0;
+    if (live_actions_) {
+        std::shared_ptr<const ActionTable> replayed = std::move(actions_);
+        actions_ = std::move(live_actions_);
+        live_actions_.reset();
+        // Keep names the recording added, unbound, so their ids stay valid
+        for (size_t id = actions_->names.size(); id < replayed->names.size(); id++) {
+            setKeyBinding(replayed->names[id], -1);
+        }
+    }
+    mouse_sensitivity_ = live_mouse_sensitivity_;
+}
+
+bool EnhancedInputManager::isReplaying() const {
+    return replay_frames_ && replay_index_ < replay_frames_->size();
+}
+
+float EnhancedInputManager::getReplayDeltaTime() const {
+    return isReplaying() ? (*replay_frames_)[replay_index_].delta_time : 0.0f;
 }
 
 // **DEBUG & DIAGNOSTICS**
@@ -313,8 +581,8 @@ void EnhancedInputManager::printInputState() const {
 
 int EnhancedInputManager::getActiveKeyCount() const {
     int count = 0;
-    for (const auto& pair : key_states_) {
-        if (pair.second.isDown) count++;
+    for (uint32_t keys = keys_down_; keys != 0; keys &= keys - 1) {
+        count++;
     }
     return count;
 }
@@ -327,56 +595,112 @@ std::string EnhancedInputManager::getInputSummary() const {
 
 // **HELPER FUNCTIONS**
 
-void EnhancedInputManager::updateKeyState(int key, KeyState& state) {
-    // Store previous state
-    state.wasPressed = state.isDown;
+void EnhancedInputManager::sampleDevices(InputRecordingFormat::FrameRecord& frame) const {
+    for (int i = 0; i < TRACKED_KEY_COUNT; i++) {
+        if (IsKeyDown(TRACKED_KEYS[i])) frame.keys_down |= 1u << i;
+        if (IsKeyPressed(TRACKED_KEYS[i])) frame.keys_pressed |= 1u << i;
+    }
+    for (int i = 0; i < TRACKED_BUTTON_COUNT; i++) {
+        if (IsMouseButtonDown(TRACKED_BUTTONS[i])) frame.buttons_down |= 1u << i;
+        if (IsMouseButtonPressed(TRACKED_BUTTONS[i])) frame.buttons_pressed |= 1u << i;
+    }
+
+    Vector2 position = GetMousePosition();
+    Vector2 delta = GetMouseDelta();
+    frame.mouse_position[0] = position.x;
+    frame.mouse_position[1] = position.y;
+    frame.mouse_delta[0] = delta.x;
+    frame.mouse_delta[1] = delta.y;
+}
+
+void EnhancedInputManager::accumulatePending() {
+    InputRecordingFormat::FrameRecord sample{};
+    sampleDevices(sample);
+    pending_frame_.keys_down = sample.keys_down;
+    pending_frame_.keys_pressed |= sample.keys_pressed;
+    pending_frame_.buttons_down = sample.buttons_down;
+    pending_frame_.buttons_pressed |= sample.buttons_pressed;
+    pending_frame_.mouse_delta[0] += sample.mouse_delta[0];
+    pending_frame_.mouse_delta[1] += sample.mouse_delta[1];
+    pending_frame_.mouse_position[0] = sample.mouse_position[0];
+    pending_frame_.mouse_position[1] = sample.mouse_position[1];
+}
+
+void EnhancedInputManager::updateKeys(uint32_t down, uint32_t pressed) {
+    uint32_t wentDown = down & ~keys_down_;
+    uint32_t wentUp = keys_down_ & ~down;
     
-    // Get current raylib state
-    bool currentlyDown = IsKeyDown(key);
-    bool justPressed = IsKeyPressed(key);
+    // Debounce against the previous press, before this frame's presses move the times
+    for (uint32_t keys = pressed; keys != 0; keys &= keys - 1) {
+        int bit = __builtin_ctz(keys);
+        if (key_debounce_[bit] > 0.0f && current_time_ - key_press_time_[bit] < key_debounce_[bit]) {
+            pressed &= ~(1u << bit);
+        }
+    }
     
-    // Update state
-    state.isPressed = justPressed && !isKeyDebounced(key);
-    state.isDown = currentlyDown;
+    for (uint32_t keys = wentDown; keys != 0; keys &= keys - 1) {
+        int bit = __builtin_ctz(keys);
+        key_press_time_[bit] = current_time_;
+        bufferInputEvent(InputEvent::KEY_PRESS, TRACKED_KEYS[bit]);
+    }
+    for (uint32_t keys = wentUp; keys != 0; keys &= keys - 1) {
+        bufferInputEvent(InputEvent::KEY_RELEASE, TRACKED_KEYS[__builtin_ctz(keys)]);
+    }
     
-    // Track hold duration
-    if (state.isDown) {
-        if (!state.wasPressed) {
-            // Just started pressing
-            state.lastPressTime = current_time_;
-            state.holdDuration = 0.0f;
-            
-            // Buffer the event
-            bufferInputEvent(InputEvent::KEY_PRESS, key);
-        } else {
-            // Continue holding
-            state.holdDuration = current_time_ - state.lastPressTime;
+    keys_down_ = down;
+    keys_pressed_ = pressed;
+    keys_released_ = wentUp;
+}
+
+void EnhancedInputManager::updateButtons(uint8_t down, uint8_t pressed) {
+    uint8_t wentUp = buttons_down_ & ~down;
+    for (int i = 0; i < TRACKED_BUTTON_COUNT; i++) {
+        if ((pressed >> i) & 1u) {
+            bufferInputEvent(InputEvent::MOUSE_PRESS, TRACKED_BUTTONS[i]);
+        } else if ((wentUp >> i) & 1u) {
+            bufferInputEvent(InputEvent::MOUSE_RELEASE, TRACKED_BUTTONS[i]);
         }
-    } else if (state.wasPressed) {
-        // Just released
-        state.holdDuration = 0.0f;
-        bufferInputEvent(InputEvent::KEY_RELEASE, key);
     }
+    
+    buttons_down_ = down;
+    buttons_pressed_ = pressed;
+    buttons_released_ = wentUp;
 }
 
-void EnhancedInputManager::updateMouseState(int button, MouseState& state) {
-    // Store previous state
-    state.wasPressed = state.isDown;
-    
-    // Get current raylib state
-    bool currentlyDown = IsMouseButtonDown(button);
-    bool justPressed = IsMouseButtonPressed(button);
+void EnhancedInputManager::updateActions() {
+    // Gather each action's key bit into its own bit; the ids were resolved at bind time
+    action_pressed_ = action_down_ = action_released_ = 0;
+    action_events_.clear();
+    if (!actions_) return;
     
-    // Update state
-    state.isPressed = justPressed;
-    state.isDown = currentlyDown;
+    const size_t count = actions_->names.size();
+    for (size_t id = 0; id < count; id++) {
+        int bit = actions_->keyBits[id];
+        if (bit < 0) continue;
+        action_pressed_ |= ((keys_pressed_ >> bit) & 1u) << id;
+        action_down_ |= ((keys_down_ >> bit) & 1u) << id;
+        action_released_ |= ((keys_released_ >> bit) & 1u) << id;
+    }
     
-    // Track timing
-    if (state.isPressed) {
-        state.lastPressTime = current_time_;
-        bufferInputEvent(InputEvent::MOUSE_PRESS, button);
-    } else if (state.wasPressed && !state.isDown) {
-        bufferInputEvent(InputEvent::MOUSE_RELEASE, button);
+    for (uint32_t edges = action_pressed_ | action_released_; edges != 0; edges &= edges - 1) {
+        ActionId id = static_cast<ActionId>(__builtin_ctz(edges));
+        if (testBit(action_pressed_, id)) {
+            action_events_.push_back({id, ActionEvent::PRESSED, current_time_});
+        }
+        if (testBit(action_released_, id)) {
+            action_events_.push_back({id, ActionEvent::RELEASED, current_time_});
+        }
+    }
+}
+
+void EnhancedInputManager::dispatchActionEvents() {
+    // Callbacks are copied out: one may replace itself or register others while it runs
+    for (const ActionEvent& event : action_events_) {
+        if (event.type != ActionEvent::PRESSED) continue;
+        std::function<void()> callback = (*action_callbacks_)[event.action];
+        if (callback) {
+            callback();
+        }
     }
 }
 
@@ -2,11 +2,15 @@
 #define INPUT_MANAGER_H
 
 #include "raylib.h"
-#include <unordered_map>
-#include <unordered_set>
+#include "raw_mouse_sampler.h"
+#include <array>
 #include <queue>
 #include <chrono>
 #include <string>
+#include <vector>
+#include <memory>
+#include <iosfwd>
+#include <cstdint>
 #include <functional>  // For std::function
 
 // **ENHANCED INPUT MANAGER SYSTEM** - Centralized input with state caching and validation
@@ -20,19 +24,75 @@ struct InputEvent {
     InputEvent(Type t, int c, float ts) : type(t), code(c), timestamp(ts) {}
 };
 
-struct KeyState {
-    bool isPressed = false;     // This frame
-    bool wasPressed = false;    // Previous frame  
-    bool isDown = false;        // Held down
-    float lastPressTime = 0.0f; // For debouncing
-    float holdDuration = 0.0f;  // How long held
-};
-
-struct MouseState {
-    bool isPressed = false;
-    bool wasPressed = false;
-    bool isDown = false;
-    float lastPressTime = 0.0f;
+// ============================================================================
+// INPUT RECORDING FORMAT (little-endian, version 1)
+//
+//   RecordingHeader
+//   int32_t tracked keys[tracked_key_count]      (bit order of FrameRecord key masks)
+//   binding_count x { uint8_t length, name bytes, int32_t key }
+//   FrameRecord[...]                              (until end of file)
+// ============================================================================
+
+namespace InputRecordingFormat {
+    constexpr char MAGIC[4] = {'B', 'W', 'I', 'R'};
+    constexpr uint32_t VERSION = 1;
+    constexpr const char* DEFAULT_PATH = "input_recording.bwir";
+
+    struct RecordingHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t tracked_key_count;
+        uint32_t frame_record_size;   // sizeof(FrameRecord) when written, checked on load
+        uint32_t binding_count;
+        float mouse_sensitivity;      // Applied to recorded raw deltas on replay
+    };
+
+    /// One update() worth of sampled device state.
+    struct FrameRecord {
+        float delta_time;
+        uint32_t keys_down;           // Bit i = tracked key i
+        uint32_t keys_pressed;
+        uint8_t buttons_down;         // Bit i = tracked mouse button i
+        uint8_t buttons_pressed;
+        uint16_t reserved;
+        float mouse_delta[2];         // Raw, before sensitivity
+        float mouse_position[2];
+    };
+
+    static_assert(sizeof(RecordingHeader) == 24, "RecordingHeader layout is part of the file format");
+    static_assert(sizeof(FrameRecord) == 32, "FrameRecord layout is part of the file format");
+}
+
+/// \brief Compiled action name; bit index into the manager's action bitsets.
+/// Ids are handed out at bind time and never change, so callers can keep them.
+using ActionId = uint8_t;
+
+// Built-in actions, bound in this order by the EnhancedInputManager constructor
+namespace InputActions {
+    constexpr ActionId MOVE_FORWARD = 0;
+    constexpr ActionId MOVE_BACKWARD = 1;
+    constexpr ActionId STRAFE_LEFT = 2;
+    constexpr ActionId STRAFE_RIGHT = 3;
+    constexpr ActionId JUMP = 4;
+    constexpr ActionId INVENTORY = 5;
+    constexpr ActionId INTERACT = 6;
+    constexpr ActionId PAUSE = 7;
+    constexpr ActionId PERFORMANCE_TOGGLE = 8;
+    constexpr ActionId QUICK_USE = 9;
+    constexpr ActionId TESTING_PANEL = 10;
+    constexpr ActionId PROFILE_CAPTURE = 11;
+    constexpr ActionId BUILTIN_COUNT = 12;
+
+    constexpr ActionId MAX_ACTIONS = 32;   // Width of the action bitsets
+    constexpr ActionId INVALID = 0xFF;
+}
+
+/// \brief An action edge queued by update(). Subscribers see each one once, in action order.
+struct ActionEvent {
+    enum Type : uint8_t { PRESSED, RELEASED };
+    ActionId action;
+    Type type;
+    float timestamp;
 };
 
 /// \brief Enhanced input manager for handling keyboard and mouse.
@@ -42,6 +102,11 @@ public:
     /// \brief Constructor.
     EnhancedInputManager();
 
+    /// \brief Samples devices once per rendered frame. Presses and mouse motion accumulate until
+    /// the next update() consumes them, so frames that run several or zero simulation steps
+    /// neither repeat nor drop input. Callers that never poll() get a poll inside update().
+    void poll();
+
     /// \brief Updates input state.
     /// \param deltaTime Delta time.
     void update(float deltaTime);
@@ -117,6 +182,27 @@ public:
     /// \param sensitivity Sensitivity.
     void setMouseSensitivity(float sensitivity);
     
+    // **RAW MOUSE** - Optional high-rate motion, bypassing raylib's per-frame delta
+    /// \brief Starts reading mouse motion from an OS device on its own thread.
+    /// While it runs, each update() takes the motion reported up to the sample time
+    /// instead of the frame's raylib delta. Recordings store it like any other delta.
+    /// \param device Device path, e.g. /dev/input/mice.
+    /// \return False if the device can't be read; raylib's delta stays in use.
+    bool startRawMouse(const std::string& device);
+
+    /// \brief Stops raw sampling and returns to raylib's delta.
+    void stopRawMouse();
+
+    /// \brief Checks if raw motion is feeding the mouse delta.
+    /// \return True while the sampler thread is running.
+    bool isRawMouseActive() const;
+
+    /// \brief Sets the wall-clock time the next update() covers motion up to.
+    /// Run() passes each fixed step's end time, so a frame's motion is split across
+    /// its steps by when it happened. Without one, update() takes everything queued.
+    /// \param time End of the step in RawMouseSampler::Clock time.
+    void setMouseSampleTime(RawMouseSampler::Clock::time_point time);
+    
     // **MOUSE CAPTURE MANAGEMENT** - Centralized and enhanced
     /// \brief Sets mouse captured.
     /// \param captured Captured state.
@@ -158,30 +244,54 @@ public:
     /// \brief Clears input buffer.
     void clearInputBuffer();
     
-    // **ADVANCED FEATURES**
-    /// \brief Sets key binding.
+    // **ACTIONS** - Names compile to ids at bind time; queries by id are bit tests
+    /// \brief Sets key binding, creating the action on first use.
     /// \param action Action name.
-    /// \param key Key code.
-    void setKeyBinding(const std::string& action, int key);
+    /// \param key Key code. Only tracked keys ever fire.
+    /// \return Action id, or InputActions::INVALID when MAX_ACTIONS are already bound.
+    ActionId setKeyBinding(const std::string& action, int key);
 
     /// \brief Gets key binding.
     /// \param action Action name.
-    /// \return Key code.
+    /// \return Key code, or -1 if unbound.
     int getKeyBinding(const std::string& action) const;
 
-    /// \brief Checks if action pressed.
+    /// \brief Resolves an action name once; keep the id for per-frame queries.
+    /// \param action Action name.
+    /// \return Action id, or InputActions::INVALID if never bound.
+    ActionId getActionId(const std::string& action) const;
+
+    /// \brief Checks if action pressed this frame.
+    bool isActionPressed(ActionId action) const { return input_enabled_ && testBit(action_pressed_, action); }
+
+    /// \brief Checks if action down.
+    bool isActionDown(ActionId action) const { return input_enabled_ && testBit(action_down_, action); }
+
+    /// \brief Checks if action released this frame.
+    bool isActionReleased(ActionId action) const { return input_enabled_ && testBit(action_released_, action); }
+
+    /// \brief Checks if action pressed. Resolves the name on every call; prefer the id overload.
     /// \param action Action name.
     /// \return True if pressed.
     bool isActionPressed(const std::string& action) const;
 
-    /// \brief Checks if action down.
+    /// \brief Checks if action down. Resolves the name on every call; prefer the id overload.
     /// \param action Action name.
     /// \return True if down.
     bool isActionDown(const std::string& action) const;
 
-    // **NEW: ACTION CALLBACKS** - Event-driven dispatch
-    /// \brief Registers action callback.
-    /// \param action Action name.
+    /// \brief Gets the action edges of the last update(), in action order.
+    /// Valid until the next update().
+    const std::vector<ActionEvent>& getActionEvents() const { return action_events_; }
+
+    // **ACTION CALLBACKS** - Subscribers to the event queue, run once per update()
+    /// \brief Registers the callback run when the action is pressed. Replaces any previous one.
+    /// \param action Action id.
+    /// \param callback Callback.
+    void registerActionCallback(ActionId action, std::function<void()> callback);
+
+    /// \brief Registers action callback by name.
+    /// \param action Action name; must already be bound.
     /// \param callback Callback.
     void registerActionCallback(const std::string& action, std::function<void()> callback);
 
@@ -189,6 +299,38 @@ public:
     /// \param action Action name.
     void unregisterActionCallback(const std::string& action);
     
+    // **RECORD & REPLAY** - Deterministic input capture
+    /// \brief Starts writing each update()'s sampled input and delta time to `path`.
+    /// The file starts with the current key bindings, so replays resolve actions the same way.
+    /// \param path Output file.
+    /// \return True if the file was opened.
+    bool startRecording(const std::string& path = InputRecordingFormat::DEFAULT_PATH);
+
+    /// \brief Flushes and closes the recording.
+    void stopRecording();
+
+    /// \brief Checks if recording.
+    /// \return True if recording.
+    bool isRecording() const;
+
+    /// \brief Loads a recording; update() then reads frames from it instead of polling raylib.
+    /// Its key bindings and mouse sensitivity replace the current ones until the replay ends.
+    /// \param path Recording file.
+    /// \return True if the file is a valid recording.
+    bool startReplay(const std::string& path);
+
+    /// \brief Stops replaying and returns to live input.
+    void stopReplay();
+
+    /// \brief Checks if replaying.
+    /// \return True if frames remain in the replay.
+    bool isReplaying() const;
+
+    /// \brief Gets the delta time recorded with the next replay frame.
+    /// Step the simulation with this instead of the wall clock to reproduce the session.
+    /// \return Recorded delta time, or 0 when not replaying.
+    float getReplayDeltaTime() const;
+
     // **DEBUG & DIAGNOSTICS**
     /// \brief Prints input state.
     void printInputState() const;
@@ -202,11 +344,36 @@ public:
     std::string getInputSummary() const;
 
 private:
-    // **STATE MANAGEMENT**
-    std::unordered_map<int, KeyState> key_states_;
-    std::unordered_map<int, MouseState> mouse_states_;
-    std::unordered_map<int, float> key_debounces_;  // Key -> debounce time
-    std::unordered_map<std::string, int> key_bindings_;  // Action -> Key
+    static constexpr size_t MAX_TRACKED_KEYS = 32;
+
+    /// \brief Action name table. Shared copy-on-write, so GameState's per-frame copy and
+    /// replays swapping bindings don't copy strings.
+    struct ActionTable {
+        std::vector<std::string> names;                        // Index = ActionId
+        std::array<int, InputActions::MAX_ACTIONS> keys;       // Key code, -1 if unbound
+        std::array<int8_t, InputActions::MAX_ACTIONS> keyBits; // Tracked-key bit of keys[i], -1 if none
+    };
+
+    using CallbackTable = std::array<std::function<void()>, InputActions::MAX_ACTIONS>;
+
+    static bool testBit(uint32_t mask, unsigned bit) { return bit < 32 && ((mask >> bit) & 1u); }
+
+    // **KEY & BUTTON STATE** - Bit i is TRACKED_KEYS[i] / TRACKED_BUTTONS[i]
+    uint32_t keys_down_ = 0;
+    uint32_t keys_pressed_ = 0;
+    uint32_t keys_released_ = 0;
+    uint8_t buttons_down_ = 0;
+    uint8_t buttons_pressed_ = 0;
+    uint8_t buttons_released_ = 0;
+    std::array<float, MAX_TRACKED_KEYS> key_press_time_{};   // When each key last went down
+    std::array<float, MAX_TRACKED_KEYS> key_debounce_{};     // Seconds; 0 = no debounce
+    
+    // **ACTION STATE** - Bit i is ActionId i
+    std::shared_ptr<const ActionTable> actions_;
+    uint32_t action_pressed_ = 0;
+    uint32_t action_down_ = 0;
+    uint32_t action_released_ = 0;
+    std::vector<ActionEvent> action_events_;
     
     // **MOUSE STATE**
     bool mouse_captured_ = true;
@@ -215,6 +382,11 @@ private:
     Vector2 mouse_delta_smoothed_ = {0, 0};
     float mouse_sensitivity_ = 1.0f;
     
+    // **RAW MOUSE** - Shared: the sampler thread isn't copyable, GameState's copy only reads
+    std::shared_ptr<RawMouseSampler> raw_mouse_;
+    RawMouseSampler::Clock::time_point mouse_sample_time_{};
+    bool has_mouse_sample_time_ = false;
+    
     // **INPUT BUFFERING**
     bool buffering_enabled_ = false;
     std::queue<InputEvent> event_buffer_;
@@ -223,18 +395,34 @@ private:
     // **SYSTEM STATE**
     bool input_enabled_ = true;
     float current_time_ = 0.0f;
+    float last_delta_time_ = 0.0f;
+    
+    // **POLLING** - Device samples waiting for the next update()
+    InputRecordingFormat::FrameRecord pending_frame_{};
+    bool external_polling_ = false;
+    
+    // **RECORD & REPLAY** - Shared so GameState's per-frame copy stays cheap
+    std::shared_ptr<std::ofstream> record_stream_;
+    std::shared_ptr<const std::vector<InputRecordingFormat::FrameRecord>> replay_frames_;
+    size_t replay_index_ = 0;
+    std::shared_ptr<const ActionTable> live_actions_;  // Restored when a replay ends
+    float live_mouse_sensitivity_ = 1.0f;
     
     // **SMOOTHING**
     static constexpr float MOUSE_SMOOTHING_FACTOR = 0.2f;
     
-    // **NEW: CALLBACK STORAGE**
-    std::unordered_map<std::string, std::function<void()>> action_callbacks_;
+    // **CALLBACK STORAGE** - Indexed by ActionId; shared with GameState's copy
+    std::shared_ptr<CallbackTable> action_callbacks_;
     
     // **HELPER FUNCTIONS**
-    void updateKeyState(int key, KeyState& state);
-    void updateMouseState(int button, MouseState& state);
+    void sampleDevices(InputRecordingFormat::FrameRecord& frame) const;
+    void accumulatePending();
+    void updateKeys(uint32_t down, uint32_t pressed);
+    void updateButtons(uint8_t down, uint8_t pressed);
+    void updateActions();
+    void dispatchActionEvents();
+    ActionTable& editActions();
     void bufferInputEvent(InputEvent::Type type, int code);
-    bool isKeyDebounced(int key) const;
 };
 
 // **LEGACY COMPATIBILITY** - Keep original InputManager for gradual migration
@@ -2,27 +2,29 @@
 #include "math_utils.h"
 #include "constants.h"
 #include "collision_system.h"  // For checkPointInBounds
-#include <iostream>  // For std::cout debug output
+#include "spatial_audio.h"
+#include "async_log.h"  // For BW_LOG
+#include "frame_arena.h"
 #include <cmath>
 
 void handleInteractions(Camera3D& camera, EnvironmentManager& environment, GameState& state, float currentTime) {
     bool nearInteractable = false;
-    std::string interactableName = "";
+    const char* interactableName = "";
     static float lastEPressTime = 0.0f;
 
     // **PHASE 2 ENHANCEMENT**: Interaction input using enhanced input with built-in debouncing
-    bool eKeyPressed = state.enhancedInput.isActionPressed("interact") && (currentTime - lastEPressTime) > 0.3f;
-    bool escPressed = state.enhancedInput.isActionPressed("pause") && (currentTime - lastEPressTime) > 0.3f;
+    bool eKeyPressed = state.enhancedInput.isActionPressed(InputActions::INTERACT) && (currentTime - lastEPressTime) > 0.3f;
+    bool escPressed = state.enhancedInput.isActionPressed(InputActions::PAUSE) && (currentTime - lastEPressTime) > 0.3f;
 
     if (eKeyPressed) {
         lastEPressTime = currentTime;
     }
 
     // **FIX NPC DIALOG FREEZE**: Allow ESC to exit dialog
-    if (escPressed && state.isInDialog) {
-        std::cout << "ESC pressed during dialog - exiting dialog" << std::endl;
-        state.isInDialog = false;
-        state.numDialogOptions = 0;
+    if (escPressed && state.dialog.active) {
+        BW_LOG(DEBUG_INTERACTION, DEBUG_BASIC, "ESC pressed during dialog - exiting dialog");
+        state.dialog.active = false;
+        state.dialog.node = -1;
         // Re-capture mouse for gameplay
         state.enhancedInput.setMouseCaptured(true);
         return;  // Exit early to prevent further processing
@@ -30,69 +32,66 @@ void handleInteractions(Camera3D& camera, EnvironmentManager& environment, GameS
 
     // Building interactions are now handled below with priority logic
 
+    // One spatial query per frame, nearest first; indicators and labels reuse it
+    const auto& objects = environment.getAllObjects();
+    const auto& nearby = environment.getNearbyInteractables();
+
     // Check for NPC interactions first (higher priority when inside building)
     bool interactingWithNPC = false;
-    for (int n = 0; n < MAX_NPCS; n++) {
-        bool npcVisible = false;
-
-        if (state.isInBuilding) {
-            if (state.currentBuilding == 0 && n == 0) npcVisible = true;
-            if (state.currentBuilding == 1 && n == 1) npcVisible = true;
-        }
-
-        if (npcVisible) {
-            float distance = MathUtils::distance3D(npcs[n].position, camera.position);
-
-            if (distance <= npcs[n].interactionRadius * 1.5f) {
-                nearInteractable = true;
-                interactableName = "Press E to talk to " + npcs[n].name;
-                if (eKeyPressed && !state.isInDialog) {
-                    startDialog(n, state);
-                    state.testNPCInteraction = true;
-                    interactingWithNPC = true;  // Flag that we're interacting with NPC
-                    break;  // Exit the NPC loop once we find one to interact with
-                }
-            }
+    const NPCSystem& npcs = NPCSystem::getInstance();
+    for (const NearbyInteractable& candidate : nearby) {
+        const NpcAnchor* anchor = objectCast<NpcAnchor>(objects[candidate.index].get());
+        if (!anchor || candidate.distance > anchor->getInteractionRadius()) continue;
+
+        int n = anchor->getNpcIndex();
+        if (!npcs.isVisible(n, state.player.isInBuilding, state.player.currentBuilding) || !npcs.canInteract(n)) continue;
+        nearInteractable = true;
+        interactableName = FrameArena::getInstance().format("Press E to talk to %s", npcs.getName(n).c_str());
+        if (eKeyPressed && !state.dialog.active) {
+            startDialog(n, state);
+            AudioSpace space = npcs.getHomeBuilding(n) < 0 ? AudioSpace::OUTDOOR : AudioSpace::INDOOR;
+            SpatialAudio::getInstance().playAt(WorldSound::NPC_VOICE, npcs.getPosition(n), 1.0f, space);
+            state.tests.npcInteraction = true;
+            interactingWithNPC = true;  // Flag that we're interacting with NPC
         }
+        break;  // Nearest visible NPC wins
     }
 
     // Only check door interactions if we're not interacting with an NPC
     if (!interactingWithNPC) {
-        auto objects = environment.getAllObjects();
-        for (size_t i = 0; i < objects.size(); ++i) {
-            if (auto building = std::dynamic_pointer_cast<Building>(objects[i])) {
-                if (building->isInteractive()) {
-                    Vector3 doorPos = building->getDoorPosition();
-                    float distance = MathUtils::distance3D(doorPos, camera.position);
-
-                    if (distance <= EnvironmentConstants::INTERACTION_DISTANCE && !state.isInBuilding) {
-                        nearInteractable = true;
-                        interactableName = "Press E to enter " + building->getName();
-                        if (eKeyPressed) {
-                            state.isInBuilding = true;
-                            state.currentBuilding = building->getId();  // Use building ID instead of array index
-                            state.lastOutdoorPosition = camera.position;
-
-                            // Set position more centered in the building interior
-                            camera.position = {building->position.x, 1.75f, building->position.z};
-                            camera.target = {building->position.x, 1.55f, building->position.z - 3.0f}; // Look toward back of building
-                            state.playerY = 0.0f;
-                            state.testBuildingEntry = true;
-
-                            printf("Entered building: %s (ID: %d) at position (%.1f, %.1f, %.1f)\n",
-                                   building->getName().c_str(), building->getId(),
-                                   camera.position.x, camera.position.y, camera.position.z);
-                            break;
-                        }
-                    } else if (state.isInBuilding && state.currentBuilding == building->getId() && eKeyPressed) {
-                        state.isInBuilding = false;
-                        camera.position = state.lastOutdoorPosition;
-                        camera.target = {state.lastOutdoorPosition.x, state.lastOutdoorPosition.y - 0.2f, state.lastOutdoorPosition.z - 5.0f};
-                        state.currentBuilding = -1;
-                        printf("Exited building: %s\n", building->getName().c_str());
-                        break;
-                    }
+        for (const NearbyInteractable& candidate : nearby) {
+            Building* building = objectCast<Building>(objects[candidate.index].get());
+            if (!building) continue;
+
+            Vector3 doorPos = candidate.anchor;
+            if (candidate.distance <= EnvironmentConstants::INTERACTION_DISTANCE && !state.player.isInBuilding) {
+                nearInteractable = true;
+                interactableName = FrameArena::getInstance().format("Press E to enter %s", building->getName().c_str());
+                if (eKeyPressed) {
+                    SpatialAudio::getInstance().playAt(WorldSound::DOOR, doorPos, 1.0f, AudioSpace::ANY);
+                    state.player.isInBuilding = true;
+                    state.player.currentBuilding = building->getId();  // Use building ID instead of array index
+                    state.player.lastOutdoorPosition = camera.position;
+
+                    // Set position more centered in the building interior
+                    camera.position = {building->position.x, 1.75f, building->position.z};
+                    camera.target = {building->position.x, 1.55f, building->position.z - 3.0f}; // Look toward back of building
+                    state.player.y = 0.0f;
+                    state.tests.buildingEntry = true;
+
+                    printf("Entered building: %s (ID: %d) at position (%.1f, %.1f, %.1f)\n",
+                           building->getName().c_str(), building->getId(),
+                           camera.position.x, camera.position.y, camera.position.z);
                 }
+                break;  // Nearest door wins
+            } else if (state.player.isInBuilding && state.player.currentBuilding == building->getId() && eKeyPressed) {
+                SpatialAudio::getInstance().playAt(WorldSound::DOOR, doorPos, 1.0f, AudioSpace::ANY);
+                state.player.isInBuilding = false;
+                camera.position = state.player.lastOutdoorPosition;
+                camera.target = {state.player.lastOutdoorPosition.x, state.player.lastOutdoorPosition.y - 0.2f, state.player.lastOutdoorPosition.z - 5.0f};
+                state.player.currentBuilding = -1;
+                printf("Exited building: %s\n", building->getName().c_str());
+                break;
             }
         }
     }
@@ -101,29 +100,34 @@ void handleInteractions(Camera3D& camera, EnvironmentManager& environment, GameS
     static bool wasNearInteractable = false;
 
     if (nearInteractable) {
-        state.showInteractPrompt = true;
-        state.interactPromptText = interactableName;
+        state.ui.showInteractPrompt = true;
+        state.ui.interactPromptText = interactableName;
         lastInteractionTime = currentTime;
         wasNearInteractable = true;
     } else {
         if (wasNearInteractable && (currentTime - lastInteractionTime) > 0.5f) {
-            state.showInteractPrompt = false;
+            state.ui.showInteractPrompt = false;
             wasNearInteractable = false;
         }
-        if (eKeyPressed && state.showInteractPrompt) {
+        if (eKeyPressed && state.ui.showInteractPrompt) {
             lastInteractionTime = currentTime;
         }
     }
 
-    if (state.isInBuilding) {
-        state.testBuildingEntry = true;
+    if (state.player.isInBuilding) {
+        state.tests.buildingEntry = true;
     }
 
-    if (state.showInteractPrompt && state.interactPromptText.find("talk to") != std::string::npos) {
-        state.testNPCInteraction = true;
+    if (state.ui.showInteractPrompt && state.ui.interactPromptText.find("talk to") != std::string::npos) {
+        state.tests.npcInteraction = true;
     }
 
-    if (state.isInDialog && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+    // A node the graph doesn't have (a save from another dialog pack) can't be shown or left by clicking
+    if (state.dialog.active && !DialogSystem::getInstance().getView(state).isOpen()) {
+        endDialog(state);
+    }
+
+    if (state.dialog.active && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
         Vector2 mousePos = GetMousePosition();
 
         const int buttonY = 320;
@@ -132,7 +136,8 @@ void handleInteractions(Camera3D& camera, EnvironmentManager& environment, GameS
         const int buttonSpacing = 170;
         const int startX = 50;
 
-        for (int i = 0; i < state.numDialogOptions; i++) {
+        int optionCount = DialogSystem::getInstance().getView(state).optionCount;
+        for (int i = 0; i < optionCount; i++) {
             int buttonX = startX + (i * buttonSpacing);
             int buttonRight = buttonX + buttonWidth;
             int buttonBottom = buttonY + buttonHeight;
@@ -149,34 +154,28 @@ void handleInteractions(Camera3D& camera, EnvironmentManager& environment, GameS
 
 // NEW: Update building entry based on position
 void updateBuildingEntry(Camera3D& camera, GameState& state, EnvironmentManager& environment) {
-    bool playerInBuilding = false;
-    int buildingIndex = -1;
-
-    auto objects = environment.getAllObjects();
-    for (size_t i = 0; i < objects.size(); ++i) {
-        if (auto building = std::dynamic_pointer_cast<Building>(objects[i])) {
-            CollisionBounds bBounds = building->getCollisionBounds();  // Assume getCollisionBounds() exists or add to EnvironmentalObject
-            if (CollisionSystem::checkPointInBounds(camera.position, bBounds)) {
-                playerInBuilding = true;
-                buildingIndex = building->getId();
-                break;
-            }
+    const Building* occupied = nullptr;
+    for (const Building* building : environment.getBuildings()) {
+        CollisionBounds bBounds = building->getCollisionBounds();
+        if (CollisionSystem::checkPointInBounds(camera.position, bBounds)) {
+            occupied = building;
+            break;
         }
     }
+    bool playerInBuilding = occupied != nullptr;
 
-    if (playerInBuilding && !state.isInBuilding) {
-        state.isInBuilding = true;
-        state.currentBuilding = buildingIndex;
+    if (playerInBuilding && !state.player.isInBuilding) {
+        state.player.isInBuilding = true;
+        state.player.currentBuilding = occupied->getId();
         state.enhancedInput.setMouseCaptured(false);
-        state.mouseReleased = true;
-        printf("Detected player inside building via position: %s\n", 
-               objects[buildingIndex]->getName().c_str());
+        state.ui.mouseReleased = true;
+        printf("Detected player inside building via position: %s\n", occupied->getName().c_str());
         printf("Mouse released for building interaction\n");
-    } else if (!playerInBuilding && state.isInBuilding) {
-        state.isInBuilding = false;
-        state.currentBuilding = -1;
+    } else if (!playerInBuilding && state.player.isInBuilding) {
+        state.player.isInBuilding = false;
+        state.player.currentBuilding = -1;
         state.enhancedInput.setMouseCaptured(true);
-        state.mouseReleased = false;
+        state.ui.mouseReleased = false;
         printf("Player exited building\n");
         printf("Mouse captured for FPS controls\n");
     }
@@ -1,36 +1,347 @@
 #include "inventory.h"
+#include "binary_io.h"
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <fstream>
-#include <sstream>
+
+// ============================================================================
+// StatModifierStack Implementation
+// ============================================================================
+
+int& statField(ItemStats& stats, StatId stat) {
+    switch (stat) {
+        case StatId::DAMAGE: return stats.damage;
+        case StatId::ARMOR: return stats.armor;
+        case StatId::HEALTH: return stats.health;
+        case StatId::MANA: return stats.mana;
+        case StatId::STAMINA: return stats.stamina;
+        case StatId::STRENGTH: return stats.strength;
+        case StatId::INTELLIGENCE: return stats.intelligence;
+        case StatId::AGILITY: return stats.agility;
+        case StatId::LUCK: return stats.luck;
+        case StatId::FIRE_RESIST: return stats.fireResist;
+        case StatId::COLD_RESIST: return stats.coldResist;
+        case StatId::SHOCK_RESIST: return stats.shockResist;
+        case StatId::POISON_RESIST: return stats.poisonResist;
+        case StatId::COUNT: break;
+    }
+    return stats.damage;
+}
+
+StatModifierStack::Handle StatModifierStack::addAdditive(const ItemStats& stats, float durationSeconds) {
+    Handle handle = allocate(durationSeconds);
+    slots_[handle.index].additive = stats;
+    return handle;
+}
+
+StatModifierStack::Handle StatModifierStack::addMultiplier(StatId stat, float factor, float durationSeconds) {
+    Handle handle = allocate(durationSeconds);
+    slots_[handle.index].stat = stat;
+    slots_[handle.index].factor = factor;
+    return handle;
+}
+
+StatModifierStack::Handle StatModifierStack::allocate(float durationSeconds) {
+    uint32_t index;
+    if (!freeSlots_.empty()) {
+        index = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(slots_.size());
+        slots_.emplace_back();
+    }
+
+    Modifier& modifier = slots_[index];
+    uint32_t generation = modifier.generation + 1;
+    modifier = Modifier{};
+    modifier.generation = generation;
+    modifier.active = true;
+    dirty_ = true;
+
+    if (durationSeconds > 0.0f) {
+        // Due on the tick that reaches the duration; at least one tick away
+        uint32_t ticks = std::max(1u, static_cast<uint32_t>(std::ceil(durationSeconds / TICK_SECONDS)));
+        size_t due = (cursor_ + ticks) % WHEEL_SLOTS;
+        wheel_[due].push_back({index, generation, (ticks - 1) / static_cast<uint32_t>(WHEEL_SLOTS)});
+    }
+    return {index, generation};
+}
+
+void StatModifierStack::remove(Handle& handle) {
+    if (isActive(handle)) {
+        // Any timer entry left behind sees the generation change and is dropped
+        Modifier& modifier = slots_[handle.index];
+        modifier.active = false;
+        ++modifier.generation;
+        freeSlots_.push_back(handle.index);
+        dirty_ = true;
+    }
+    handle = Handle{};
+}
+
+bool StatModifierStack::isActive(const Handle& handle) const {
+    return handle.index < slots_.size() && slots_[handle.index].active &&
+           slots_[handle.index].generation == handle.generation;
+}
+
+void StatModifierStack::update(float deltaTime) {
+    tickAccumulator_ += deltaTime;
+    while (tickAccumulator_ >= TICK_SECONDS) {
+        tickAccumulator_ -= TICK_SECONDS;
+        cursor_ = (cursor_ + 1) % WHEEL_SLOTS;
+
+        std::vector<TimerEntry>& bucket = wheel_[cursor_];
+        size_t kept = 0;
+        for (TimerEntry entry : bucket) {
+            if (entry.rounds > 0) {
+                --entry.rounds;
+                bucket[kept++] = entry;
+            } else {
+                Handle handle{entry.index, entry.generation};
+                remove(handle);
+            }
+        }
+        bucket.resize(kept);
+    }
+}
+
+const ItemStats& StatModifierStack::getTotal() const {
+    if (!dirty_) {
+        return total_;
+    }
+    dirty_ = false;
+    ++rebuilds_;
+
+    ItemStats total;
+    float factors[static_cast<size_t>(StatId::COUNT)];
+    std::fill(std::begin(factors), std::end(factors), 1.0f);
+    for (const Modifier& modifier : slots_) {
+        if (!modifier.active) continue;
+        if (modifier.stat != StatId::COUNT) {
+            factors[static_cast<size_t>(modifier.stat)] *= modifier.factor;
+            continue;
+        }
+        const ItemStats& add = modifier.additive;
+        for (size_t i = 0; i < static_cast<size_t>(StatId::COUNT); ++i) {
+            StatId stat = static_cast<StatId>(i);
+            statField(total, stat) += statField(add, stat);
+        }
+        total.waterWalking = total.waterWalking || add.waterWalking;
+        total.nightVision = total.nightVision || add.nightVision;
+        total.levitation = total.levitation || add.levitation;
+    }
+    for (size_t i = 0; i < static_cast<size_t>(StatId::COUNT); ++i) {
+        if (factors[i] != 1.0f) {
+            int& value = statField(total, static_cast<StatId>(i));
+            value = static_cast<int>(std::lround(value * factors[i]));
+        }
+    }
+    total_ = total;
+    return total_;
+}
+
+// ============================================================================
+// ItemDefinition Implementation
+// ============================================================================
+
+bool operator==(const ItemStats& a, const ItemStats& b) {
+    return a.damage == b.damage && a.armor == b.armor && a.health == b.health && a.mana == b.mana &&
+           a.stamina == b.stamina && a.strength == b.strength && a.intelligence == b.intelligence &&
+           a.agility == b.agility && a.luck == b.luck && a.fireResist == b.fireResist &&
+           a.coldResist == b.coldResist && a.shockResist == b.shockResist && a.poisonResist == b.poisonResist &&
+           a.waterWalking == b.waterWalking && a.nightVision == b.nightVision && a.levitation == b.levitation;
+}
+
+bool ItemDefinition::sameContent(const ItemDefinition& other) const {
+    return kind == other.kind && name == other.name && description == other.description &&
+           type == other.type && rarity == other.rarity && weight == other.weight && value == other.value &&
+           equipSlot == other.equipSlot && stats == other.stats && stackable == other.stackable &&
+           maxStack == other.maxStack && weaponType == other.weaponType && attackSpeed == other.attackSpeed &&
+           critChance == other.critChance && armorType == other.armorType && effects == other.effects &&
+           duration == other.duration;
+}
+
+const ItemDefinition* ItemDefinitionRegistry::intern(const ItemDefinition& def) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<uint32_t>& sameName = byName_[def.name];
+    for (uint32_t id : sameName) {
+        const ItemDefinition& existing = definitions_[id - 1];
+        if (existing.sameContent(def)) {
+            return &existing;
+        }
+    }
+
+    definitions_.push_back(def);
+    ItemDefinition& added = definitions_.back();
+    added.id = static_cast<uint32_t>(definitions_.size());
+    sameName.push_back(added.id);
+    return &added;
+}
+
+const ItemDefinition* ItemDefinitionRegistry::find(uint32_t id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return id > 0 && id <= definitions_.size() ? &definitions_[id - 1] : nullptr;
+}
+
+size_t ItemDefinitionRegistry::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return definitions_.size();
+}
 
 // ============================================================================
 // MysticalItem Implementation
 // ============================================================================
 
-MysticalItem::MysticalItem(const std::string& name, ItemType type, float weight, int value)
-    : name_(name), type_(type), weight_(weight), value_(value) {
+namespace {
+
+ItemDefinition makeBaseDefinition(const std::string& name, ItemType type, float weight, int value) {
+    ItemDefinition def;
+    def.name = name;
+    def.type = type;
+    def.weight = weight;
+    def.value = value;
+
     // Set default description based on type
-    switch (type_) {
+    switch (type) {
         case ItemType::WEAPON:
-            description_ = "A weapon forged in the ancient smithies";
+            def.description = "A weapon forged in the ancient smithies";
             break;
         case ItemType::ARMOR:
-            description_ = "Protective gear crafted by skilled armorers";
+            def.description = "Protective gear crafted by skilled armorers";
             break;
         case ItemType::CONSUMABLE:
-            description_ = "A consumable item with mystical properties";
+            def.description = "A consumable item with mystical properties";
             break;
         case ItemType::TREASURE:
-            description_ = "A valuable treasure from forgotten ruins";
+            def.description = "A valuable treasure from forgotten ruins";
             break;
         case ItemType::QUEST_ITEM:
-            description_ = "An important item for your quest";
+            def.description = "An important item for your quest";
             break;
         default:
-            description_ = "A mysterious item of unknown origin";
+            def.description = "A mysterious item of unknown origin";
             break;
     }
+    return def;
+}
+
+ItemDefinition makeWeaponDefinition(const std::string& name, WeaponType weaponType, int damage, float weight) {
+    ItemDefinition def = makeBaseDefinition(name, ItemType::WEAPON, weight, damage * 10);
+    def.kind = ItemKind::WEAPON;
+    def.weaponType = weaponType;
+    def.equipSlot = EquipmentSlot::MAIN_HAND;
+    def.stats.damage = damage;
+    
+    // Set weapon-specific properties
+    switch (weaponType) {
+        case WeaponType::DAGGER:
+            def.attackSpeed = 2.0f;
+            def.critChance = 0.15f;
+            def.description = "A swift blade perfect for quick strikes";
+            break;
+        case WeaponType::LONGSWORD:
+            def.attackSpeed = 1.0f;
+            def.critChance = 0.08f;
+            def.description = "A noble blade favored by knights and warriors";
+            break;
+        case WeaponType::MACE:
+            def.attackSpeed = 0.8f;
+            def.critChance = 0.05f;
+            def.description = "A heavy weapon that crushes armor and bone";
+            break;
+        case WeaponType::BOW:
+            def.attackSpeed = 1.2f;
+            def.critChance = 0.12f;
+            def.equipSlot = EquipmentSlot::MAIN_HAND;
+            def.description = "A ranged weapon for hunters and scouts";
+            break;
+        case WeaponType::STAFF:
+            def.attackSpeed = 0.6f;
+            def.critChance = 0.03f;
+            def.description = "A conduit for magical energies";
+            break;
+        default:
+            def.attackSpeed = 1.0f;
+            def.critChance = 0.05f;
+            break;
+    }
+    return def;
+}
+
+ItemDefinition makeArmorDefinition(const std::string& name, ArmorType armorType, int armor, EquipmentSlot slot) {
+    ItemDefinition def = makeBaseDefinition(name, ItemType::ARMOR, 0.0f, armor * 15);
+    def.kind = ItemKind::ARMOR;
+    def.armorType = armorType;
+    def.equipSlot = slot;
+    def.stats.armor = armor;
+    
+    // Set armor-specific properties
+    switch (armorType) {
+        case ArmorType::LIGHT:
+            def.weight = 2.0f;
+            def.description = "Light armor that provides mobility and stealth";
+            break;
+        case ArmorType::MEDIUM:
+            def.weight = 8.0f;
+            def.description = "Balanced protection for versatile adventurers";
+            break;
+        case ArmorType::HEAVY:
+            def.weight = 15.0f;
+            def.description = "Heavy armor providing maximum protection";
+            break;
+        case ArmorType::ROBE:
+            def.weight = 1.0f;
+            def.description = "Magical robes woven with arcane threads";
+            def.stats.mana += armor; // Robes also provide mana bonus
+            break;
+    }
+    return def;
+}
+
+ItemDefinition makePotionDefinition(const std::string& name, const ItemStats& effects, int duration) {
+    ItemDefinition def = makeBaseDefinition(name, ItemType::CONSUMABLE, 0.5f, 50);
+    def.kind = ItemKind::POTION;
+    def.effects = effects;
+    def.duration = duration;
+    def.stackable = true;  // Potions stack up to 10
+    def.maxStack = 10;
+    
+    if (duration > 0) {
+        def.description = "A magical elixir with temporary effects";
+    } else {
+        def.description = "A healing potion with instant effects";
+    }
+    return def;
+}
+
+const ItemDefinition* intern(const ItemDefinition& def) {
+    return ItemDefinitionRegistry::getInstance().intern(def);
+}
+
+}  // namespace
+
+MysticalItem::MysticalItem(const std::string& name, ItemType type, float weight, int value)
+    : def_(intern(makeBaseDefinition(name, type, weight, value))) {
+}
+
+std::shared_ptr<MysticalItem> MysticalItem::create(const ItemDefinition* def) {
+    switch (def->kind) {
+        case ItemKind::WEAPON: return std::make_shared<EnchantedWeapon>(def);
+        case ItemKind::ARMOR: return std::make_shared<GuardianArmor>(def);
+        case ItemKind::POTION: return std::make_shared<AlchemicalPotion>(def);
+        case ItemKind::BASE: break;
+    }
+    return std::shared_ptr<MysticalItem>(new MysticalItem(def));
+}
+
+std::shared_ptr<MysticalItem> MysticalItem::clone() const {
+    auto copy = create(def_);
+    copy->enchantment_ = enchantment_;
+    copy->stackSize_ = stackSize_;
+    copy->durability_ = durability_;
+    copy->maxDurability_ = maxDurability_;
+    return copy;
 }
 
 void MysticalItem::setDurability(float current, float maximum) {
@@ -43,11 +354,11 @@ void MysticalItem::setDurability(float current, float maximum) {
 }
 
 bool MysticalItem::canStackWith(const MysticalItem& other) const {
-    return stackable_ && 
-           other.stackable_ && 
-           name_ == other.name_ && 
-           type_ == other.type_ &&
-           stackSize_ < maxStack_;
+    return def_->stackable && 
+           other.def_->stackable && 
+           def_->name == other.def_->name && 
+           def_->type == other.def_->type &&
+           stackSize_ < def_->maxStack;
 }
 
 void MysticalItem::takeDamage(float damage) {
@@ -59,113 +370,233 @@ void MysticalItem::repair(float amount) {
 }
 
 std::string MysticalItem::getDisplayName() const {
-    std::string displayName = name_;
+    FrameString displayName;
+    writeDisplayName(displayName);
+    return std::string(displayName);
+}
+
+void MysticalItem::writeDisplayName(FrameString& out) const {
+    out += def_->name;
     
     // Add stack size if stackable
-    if (stackable_ && stackSize_ > 1) {
-        displayName += " (" + std::to_string(stackSize_) + ")";
+    if (def_->stackable && stackSize_ > 1) {
+        appendFormat(out, " (%d)", stackSize_);
     }
     
     // Add condition indicator
     if (maxDurability_ > 0.0f) {
         float condition = durability_ / maxDurability_;
         if (condition <= 0.25f) {
-            displayName += " [Broken]";
+            out += " [Broken]";
         } else if (condition <= 0.5f) {
-            displayName += " [Poor]";
+            out += " [Poor]";
         } else if (condition <= 0.75f) {
-            displayName += " [Fair]";
+            out += " [Fair]";
         }
         // Good/Excellent items don't show condition
     }
-    
-    return displayName;
 }
 
 std::string MysticalItem::getTooltip() const {
-    std::stringstream tooltip;
-    tooltip << name_ << "\n";
-    tooltip << description_ << "\n\n";
+    FrameString tooltip;
+    writeTooltip(tooltip);
+    return std::string(tooltip);
+}
+
+void MysticalItem::writeTooltip(FrameString& out) const {
+    out += def_->name;
+    out += "\n";
+    out += def_->description;
+    out += "\n\n";
     
     // Basic properties
-    tooltip << "Type: " << ItemUtils::itemTypeToString(type_) << "\n";
-    tooltip << "Weight: " << weight_ << " kg\n";
-    tooltip << "Value: " << value_ << " gold\n";
+    appendFormat(out, "Type: %s\n", ItemUtils::itemTypeToString(def_->type).c_str());
+    appendFormat(out, "Weight: %g kg\n", def_->weight);
+    appendFormat(out, "Value: %d gold\n", def_->value);
     
-    if (rarity_ != ItemRarity::COMMON) {
-        tooltip << "Rarity: " << ItemUtils::rarityToString(rarity_) << "\n";
+    if (def_->rarity != ItemRarity::COMMON) {
+        appendFormat(out, "Rarity: %s\n", ItemUtils::rarityToString(def_->rarity).c_str());
     }
     
     // Durability
     if (maxDurability_ > 0.0f) {
-        tooltip << "Condition: " << static_cast<int>((durability_ / maxDurability_) * 100) << "%\n";
+        appendFormat(out, "Condition: %d%%\n", static_cast<int>((durability_ / maxDurability_) * 100));
     }
     
     // Stats
     const auto& stats = getStats();
-    if (stats.damage > 0) tooltip << "Damage: +" << stats.damage << "\n";
-    if (stats.armor > 0) tooltip << "Armor: +" << stats.armor << "\n";
-    if (stats.health > 0) tooltip << "Health: +" << stats.health << "\n";
-    if (stats.mana > 0) tooltip << "Mana: +" << stats.mana << "\n";
-    if (stats.stamina > 0) tooltip << "Stamina: +" << stats.stamina << "\n";
-    
-    return tooltip.str();
-}
-
-// ============================================================================
-// EnchantedWeapon Implementation
-// ============================================================================
-
-EnchantedWeapon::EnchantedWeapon(const std::string& name, WeaponType weaponType, int damage, float weight)
-    : MysticalItem(name, ItemType::WEAPON, weight, damage * 10), weaponType_(weaponType) {
-    
-    equipSlot_ = EquipmentSlot::MAIN_HAND;
-    stats_.damage = damage;
-    
-    // Set weapon-specific properties
-    switch (weaponType_) {
-        case WeaponType::DAGGER:
-            attackSpeed_ = 2.0f;
-            critChance_ = 0.15f;
-            description_ = "A swift blade perfect for quick strikes";
+    if (stats.damage > 0) appendFormat(out, "Damage: +%d\n", stats.damage);
+    if (stats.armor > 0) appendFormat(out, "Armor: +%d\n", stats.armor);
+    if (stats.health > 0) appendFormat(out, "Health: +%d\n", stats.health);
+    if (stats.mana > 0) appendFormat(out, "Mana: +%d\n", stats.mana);
+    if (stats.stamina > 0) appendFormat(out, "Stamina: +%d\n", stats.stamina);
+    if (enchantment_) out += "Enchanted\n";
+}
+
+void MysticalItem::writeDefinition(BinaryWriter& out, const ItemDefinition& def) {
+    out.write(static_cast<uint8_t>(def.kind));
+    switch (def.kind) {
+        case ItemKind::WEAPON:
+            out.write(static_cast<uint8_t>(def.weaponType));
+            out.write(def.attackSpeed);
+            out.write(def.critChance);
             break;
-        case WeaponType::LONGSWORD:
-            attackSpeed_ = 1.0f;
-            critChance_ = 0.08f;
-            description_ = "A noble blade favored by knights and warriors";
+        case ItemKind::ARMOR:
+            out.write(static_cast<uint8_t>(def.armorType));
             break;
-        case WeaponType::MACE:
-            attackSpeed_ = 0.8f;
-            critChance_ = 0.05f;
-            description_ = "A heavy weapon that crushes armor and bone";
+        case ItemKind::POTION:
+            out.write(def.effects);
+            out.write(static_cast<int32_t>(def.duration));
             break;
-        case WeaponType::BOW:
-            attackSpeed_ = 1.2f;
-            critChance_ = 0.12f;
-            equipSlot_ = EquipmentSlot::MAIN_HAND;
-            description_ = "A ranged weapon for hunters and scouts";
+        case ItemKind::BASE:
             break;
-        case WeaponType::STAFF:
-            attackSpeed_ = 0.6f;
-            critChance_ = 0.03f;
-            description_ = "A conduit for magical energies";
+    }
+    out.writeString(def.name);
+    out.writeString(def.description);
+    out.write(static_cast<uint8_t>(def.type));
+    out.write(static_cast<uint8_t>(def.rarity));
+    out.write(def.weight);
+    out.write(static_cast<int32_t>(def.value));
+    out.write(static_cast<uint8_t>(def.equipSlot));
+    out.write(def.stats);
+    out.write(static_cast<uint8_t>(def.stackable));
+    out.write(static_cast<int32_t>(def.maxStack));
+}
+
+const ItemDefinition* MysticalItem::readDefinition(BinaryReader& in) {
+    return readDefinitionFields(in, nullptr);
+}
+
+const ItemDefinition* MysticalItem::readDefinitionFields(BinaryReader& in, MysticalItem* legacyInstance) {
+    ItemDefinition def;
+    uint8_t kind = 0;
+    if (!in.read(kind)) {
+        return nullptr;
+    }
+    def.kind = static_cast<ItemKind>(kind);
+
+    uint8_t subtype = 0;
+    int32_t duration = 0;
+    switch (def.kind) {
+        case ItemKind::WEAPON:
+            in.read(subtype);
+            in.read(def.attackSpeed);
+            in.read(def.critChance);
+            def.weaponType = static_cast<WeaponType>(subtype);
             break;
-        default:
-            attackSpeed_ = 1.0f;
-            critChance_ = 0.05f;
+        case ItemKind::ARMOR:
+            in.read(subtype);
+            def.armorType = static_cast<ArmorType>(subtype);
+            break;
+        case ItemKind::POTION:
+            in.read(def.effects);
+            in.read(duration);
+            def.duration = duration;
+            break;
+        case ItemKind::BASE:
             break;
+        default:
+            return nullptr;
     }
-    
+
+    uint8_t type = 0, rarity = 0, slot = 0, stackable = 0;
+    int32_t value = 0, stackSize = 0, maxStack = 0;
+    in.readString(def.name);
+    in.readString(def.description);
+    in.read(type);
+    in.read(rarity);
+    in.read(def.weight);
+    in.read(value);
+    in.read(slot);
+    in.read(def.stats);
+    in.read(stackable);
+    if (legacyInstance) {
+        in.read(stackSize);  // Older saves kept the instance state inline
+    }
+    in.read(maxStack);
+    if (legacyInstance) {
+        in.read(legacyInstance->durability_);
+        in.read(legacyInstance->maxDurability_);
+        legacyInstance->stackSize_ = stackSize;
+    }
+    if (in.failed()) {
+        return nullptr;
+    }
+
+    def.type = static_cast<ItemType>(type);
+    def.rarity = static_cast<ItemRarity>(rarity);
+    def.value = value;
+    def.equipSlot = static_cast<EquipmentSlot>(slot);
+    def.stackable = stackable != 0;
+    def.maxStack = maxStack;
+    return intern(def);
+}
+
+void MysticalItem::writeInstance(BinaryWriter& out) const {
+    out.write(static_cast<int32_t>(stackSize_));
+    out.write(durability_);
+    out.write(maxDurability_);
+    out.write(static_cast<uint8_t>(enchantment_ ? 1 : 0));
+    if (enchantment_) {
+        out.write(*enchantment_);
+    }
+}
+
+bool MysticalItem::readInstance(BinaryReader& in) {
+    int32_t stackSize = 0;
+    float durability = 0.0f, maxDurability = 0.0f;
+    uint8_t enchanted = 0;
+    ItemStats enchantment;
+    in.read(stackSize);
+    in.read(durability);
+    in.read(maxDurability);
+    in.read(enchanted);
+    if (enchanted) {
+        in.read(enchantment);
+    }
+    if (in.failed()) {
+        return false;
+    }
+
+    stackSize_ = stackSize;
+    durability_ = durability;
+    maxDurability_ = maxDurability;
+    if (enchanted) {
+        setEnchantment(enchantment);
+    } else {
+        enchantment_.reset();
+    }
+    return true;
+}
+
+std::shared_ptr<MysticalItem> MysticalItem::readFrom(BinaryReader& in) {
+    // The instance fields land in a scratch item, then move onto one of the right class
+    MysticalItem scratch(static_cast<const ItemDefinition*>(nullptr));
+    const ItemDefinition* def = readDefinitionFields(in, &scratch);
+    if (!def) {
+        return nullptr;
+    }
+    auto item = create(def);
+    item->stackSize_ = scratch.stackSize_;
+    item->durability_ = scratch.durability_;
+    item->maxDurability_ = scratch.maxDurability_;
+    return item;
+}
+
+// ============================================================================
+// EnchantedWeapon Implementation
+// ============================================================================
+
+EnchantedWeapon::EnchantedWeapon(const std::string& name, WeaponType weaponType, int damage, float weight)
+    : MysticalItem(intern(makeWeaponDefinition(name, weaponType, damage, weight))) {
     setDurability(100.0f, 100.0f);
 }
 
-std::string EnchantedWeapon::getTooltip() const {
-    std::stringstream tooltip;
-    tooltip << MysticalItem::getTooltip();
-    tooltip << "\nWeapon Type: " << ItemUtils::weaponTypeToString(weaponType_) << "\n";
-    tooltip << "Attack Speed: " << attackSpeed_ << "/sec\n";
-    tooltip << "Critical Chance: " << static_cast<int>(critChance_ * 100) << "%\n";
-    return tooltip.str();
+void EnchantedWeapon::writeTooltip(FrameString& out) const {
+    MysticalItem::writeTooltip(out);
+    appendFormat(out, "\nWeapon Type: %s\n", ItemUtils::weaponTypeToString(def_->weaponType).c_str());
+    appendFormat(out, "Attack Speed: %g/sec\n", def_->attackSpeed);
+    appendFormat(out, "Critical Chance: %d%%\n", static_cast<int>(def_->critChance * 100));
 }
 
 // ============================================================================
@@ -173,41 +604,14 @@ std::string EnchantedWeapon::getTooltip() const {
 // ============================================================================
 
 GuardianArmor::GuardianArmor(const std::string& name, ArmorType armorType, int armor, EquipmentSlot slot)
-    : MysticalItem(name, ItemType::ARMOR, 0.0f, armor * 15), armorType_(armorType) {
-    
-    equipSlot_ = slot;
-    stats_.armor = armor;
-    
-    // Set armor-specific properties
-    switch (armorType_) {
-        case ArmorType::LIGHT:
-            weight_ = 2.0f;
-            description_ = "Light armor that provides mobility and stealth";
-            break;
-        case ArmorType::MEDIUM:
-            weight_ = 8.0f;
-            description_ = "Balanced protection for versatile adventurers";
-            break;
-        case ArmorType::HEAVY:
-            weight_ = 15.0f;
-            description_ = "Heavy armor providing maximum protection";
-            break;
-        case ArmorType::ROBE:
-            weight_ = 1.0f;
-            description_ = "Magical robes woven with arcane threads";
-            stats_.mana += armor; // Robes also provide mana bonus
-            break;
-    }
-    
+    : MysticalItem(intern(makeArmorDefinition(name, armorType, armor, slot))) {
     setDurability(100.0f, 100.0f);
 }
 
-std::string GuardianArmor::getTooltip() const {
-    std::stringstream tooltip;
-    tooltip << MysticalItem::getTooltip();
-    tooltip << "\nArmor Type: " << ItemUtils::armorTypeToString(armorType_) << "\n";
-    tooltip << "Equipment Slot: " << ItemUtils::equipmentSlotToString(equipSlot_) << "\n";
-    return tooltip.str();
+void GuardianArmor::writeTooltip(FrameString& out) const {
+    MysticalItem::writeTooltip(out);
+    appendFormat(out, "\nArmor Type: %s\n", ItemUtils::armorTypeToString(def_->armorType).c_str());
+    appendFormat(out, "Equipment Slot: %s\n", ItemUtils::equipmentSlotToString(def_->equipSlot).c_str());
 }
 
 // ============================================================================
@@ -215,33 +619,23 @@ std::string GuardianArmor::getTooltip() const {
 // ============================================================================
 
 AlchemicalPotion::AlchemicalPotion(const std::string& name, const ItemStats& effects, int duration)
-    : MysticalItem(name, ItemType::CONSUMABLE, 0.5f, 50), effects_(effects), duration_(duration) {
-    
-    setStackable(true, 10);  // Potions stack up to 10
-    
-    if (duration_ > 0) {
-        description_ = "A magical elixir with temporary effects";
-    } else {
-        description_ = "A healing potion with instant effects";
-    }
+    : MysticalItem(intern(makePotionDefinition(name, effects, duration))) {
 }
 
-std::string AlchemicalPotion::getTooltip() const {
-    std::stringstream tooltip;
-    tooltip << MysticalItem::getTooltip();
+void AlchemicalPotion::writeTooltip(FrameString& out) const {
+    MysticalItem::writeTooltip(out);
     
-    tooltip << "\nEffects:\n";
-    if (effects_.health > 0) tooltip << "  Restores " << effects_.health << " health\n";
-    if (effects_.mana > 0) tooltip << "  Restores " << effects_.mana << " mana\n";
-    if (effects_.stamina > 0) tooltip << "  Restores " << effects_.stamina << " stamina\n";
+    const ItemStats& effects = def_->effects;
+    out += "\nEffects:\n";
+    if (effects.health > 0) appendFormat(out, "  Restores %d health\n", effects.health);
+    if (effects.mana > 0) appendFormat(out, "  Restores %d mana\n", effects.mana);
+    if (effects.stamina > 0) appendFormat(out, "  Restores %d stamina\n", effects.stamina);
     
-    if (duration_ > 0) {
-        tooltip << "\nDuration: " << duration_ << " seconds\n";
+    if (def_->duration > 0) {
+        appendFormat(out, "\nDuration: %d seconds\n", def_->duration);
     } else {
-        tooltip << "\nEffect: Instant\n";
+        out += "\nEffect: Instant\n";
     }
-    
-    return tooltip.str();
 }
 
 // ============================================================================
@@ -265,6 +659,7 @@ bool AdventurerInventory::addItem(std::shared_ptr<MysticalItem> item, int quanti
             int canAdd = std::min(quantity, existingItem->getMaxStack() - existingItem->getStackSize());
             if (canAdd > 0) {
                 existingItem->addToStack(canAdd);
+                adjustTotals(*existingItem, canAdd);
                 quantity -= canAdd;
             }
         }
@@ -272,7 +667,7 @@ bool AdventurerInventory::addItem(std::shared_ptr<MysticalItem> item, int quanti
     
     // Add remaining quantity as new items
     while (quantity > 0 && canAddItem(item, 1)) {
-        auto newItem = std::shared_ptr<MysticalItem>(new MysticalItem(*item));
+        auto newItem = item->clone();
         if (item->isStackable()) {
             int stackAmount = std::min(quantity, item->getMaxStack());
             newItem->addToStack(stackAmount - 1); // -1 because items start with size 1
@@ -280,7 +675,7 @@ bool AdventurerInventory::addItem(std::shared_ptr<MysticalItem> item, int quanti
         } else {
             quantity--;
         }
-        items_.push_back(newItem);
+        insertItem(std::move(newItem));
     }
     
     return quantity == 0; // True if all items were added
@@ -301,16 +696,20 @@ bool AdventurerInventory::removeItem(std::shared_ptr<MysticalItem> item, int qua
         return false;
     }
     
+    size_t index = static_cast<size_t>(it - items_.begin());
     if (item->isStackable()) {
         if (item->getStackSize() >= quantity) {
-            item->removeFromStack(quantity);
-            if (item->getStackSize() <= 0) {
-                items_.erase(it);
+            if (item->getStackSize() == quantity) {
+                eraseItem(index);
+                item->removeFromStack(quantity);
+            } else {
+                item->removeFromStack(quantity);
+                adjustTotals(*item, -quantity);
             }
             return true;
         }
     } else if (quantity == 1) {
-        items_.erase(it);
+        eraseItem(index);
         return true;
     }
     
@@ -348,79 +747,100 @@ int AdventurerInventory::getItemQuantity(const std::string& itemName) const {
     return total;
 }
 
-float AdventurerInventory::getCurrentWeight() const {
-    float totalWeight = 0.0f;
-    for (const auto& item : items_) {
-        totalWeight += item->getWeight() * item->getStackSize();
+void AdventurerInventory::setSortOrder(InventorySort sort) {
+    if (sort_ != sort) {
+        sort_ = sort;
+        ++revision_;
     }
-    return totalWeight;
 }
 
-void AdventurerInventory::sortByType() {
-    std::sort(items_.begin(), items_.end(),
-        [](const std::shared_ptr<MysticalItem>& a, const std::shared_ptr<MysticalItem>& b) {
-            return static_cast<int>(a->getType()) < static_cast<int>(b->getType());
-        });
-}
-
-void AdventurerInventory::sortByValue() {
-    std::sort(items_.begin(), items_.end(),
-        [](const std::shared_ptr<MysticalItem>& a, const std::shared_ptr<MysticalItem>& b) {
-            return a->getValue() > b->getValue();
-        });
-}
-
-void AdventurerInventory::sortByWeight() {
-    std::sort(items_.begin(), items_.end(),
-        [](const std::shared_ptr<MysticalItem>& a, const std::shared_ptr<MysticalItem>& b) {
-            return a->getWeight() < b->getWeight();
-        });
-}
+const std::vector<uint32_t>& AdventurerInventory::getSortedOrder() const {
+    if (sortedRevision_ == revision_) {
+        return sortedOrder_;
+    }
+    sortedRevision_ = revision_;
 
-void AdventurerInventory::sortByName() {
-    std::sort(items_.begin(), items_.end(),
-        [](const std::shared_ptr<MysticalItem>& a, const std::shared_ptr<MysticalItem>& b) {
-            return a->getName() < b->getName();
-        });
-}
+    // A permutation of indices, so sorting never moves the player's items
+    sortedOrder_.resize(items_.size());
+    for (size_t i = 0; i < sortedOrder_.size(); ++i) {
+        sortedOrder_[i] = static_cast<uint32_t>(i);
+    }
 
-void AdventurerInventory::sortByRarity() {
-    std::sort(items_.begin(), items_.end(),
-        [](const std::shared_ptr<MysticalItem>& a, const std::shared_ptr<MysticalItem>& b) {
-            return static_cast<int>(a->getRarity()) > static_cast<int>(b->getRarity());
+    // Stable, so equal keys stay in insertion order
+    auto sortBy = [this](auto less) {
+        std::stable_sort(sortedOrder_.begin(), sortedOrder_.end(), [this, &less](uint32_t a, uint32_t b) {
+            return less(*items_[a], *items_[b]);
         });
+    };
+    switch (sort_) {
+        case InventorySort::TYPE:
+            sortBy([](const MysticalItem& a, const MysticalItem& b) {
+                return static_cast<int>(a.getType()) < static_cast<int>(b.getType());
+            });
+            break;
+        case InventorySort::VALUE:
+            sortBy([](const MysticalItem& a, const MysticalItem& b) { return a.getValue() > b.getValue(); });
+            break;
+        case InventorySort::WEIGHT:
+            sortBy([](const MysticalItem& a, const MysticalItem& b) { return a.getWeight() < b.getWeight(); });
+            break;
+        case InventorySort::NAME:
+            sortBy([](const MysticalItem& a, const MysticalItem& b) { return a.getName() < b.getName(); });
+            break;
+        case InventorySort::RARITY:
+            sortBy([](const MysticalItem& a, const MysticalItem& b) {
+                return static_cast<int>(a.getRarity()) > static_cast<int>(b.getRarity());
+            });
+            break;
+        case InventorySort::NONE:
+            break;
+    }
+    return sortedOrder_;
 }
 
 // ============================================================================
 // Search and Filtering Implementation
 // ============================================================================
 
-std::vector<std::shared_ptr<MysticalItem>> AdventurerInventory::searchItems(const std::string& query) const {
-    std::vector<std::shared_ptr<MysticalItem>> results;
-
+const std::vector<uint32_t>& AdventurerInventory::getView(const std::string& query) const {
     if (query.empty()) {
-        return items_;  // Return all items if no query
+        return getSortedOrder();
     }
 
     std::string lowerQuery = query;
     std::transform(lowerQuery.begin(), lowerQuery.end(), lowerQuery.begin(), ::tolower);
 
-    std::copy_if(items_.begin(), items_.end(), std::back_inserter(results),
-        [&lowerQuery](const std::shared_ptr<MysticalItem>& item) {
-            std::string itemName = item->getName();
-            std::string itemDesc = item->getDescription();
-
-            // Convert to lowercase for case-insensitive search
-            std::transform(itemName.begin(), itemName.end(), itemName.begin(), ::tolower);
-            std::transform(itemDesc.begin(), itemDesc.end(), itemDesc.begin(), ::tolower);
-
-            // Search in name and description
-            return itemName.find(lowerQuery) != std::string::npos ||
-                   itemDesc.find(lowerQuery) != std::string::npos ||
-                   ItemUtils::itemTypeToString(item->getType()).find(lowerQuery) != std::string::npos ||
-                   ItemUtils::rarityToString(item->getRarity()).find(lowerQuery) != std::string::npos;
-        });
+    bool cacheValid = viewRevision_ == revision_;
+    if (cacheValid && lowerQuery == viewQuery_) {
+        return viewResults_;
+    }
 
+    if (cacheValid && !viewQuery_.empty() && lowerQuery.compare(0, viewQuery_.size(), viewQuery_) == 0) {
+        // Typed another character: only earlier matches can still match
+        viewResults_.erase(std::remove_if(viewResults_.begin(), viewResults_.end(),
+            [this, &lowerQuery](uint32_t index) {
+                return searchText_[index].find(lowerQuery) == std::string::npos;
+            }), viewResults_.end());
+    } else {
+        viewResults_.clear();
+        for (uint32_t index : getSortedOrder()) {
+            if (searchText_[index].find(lowerQuery) != std::string::npos) {
+                viewResults_.push_back(index);
+            }
+        }
+    }
+    viewQuery_ = std::move(lowerQuery);
+    viewRevision_ = revision_;
+    return viewResults_;
+}
+
+std::vector<std::shared_ptr<MysticalItem>> AdventurerInventory::searchItems(const std::string& query) const {
+    const std::vector<uint32_t>& view = getView(query);
+    std::vector<std::shared_ptr<MysticalItem>> results;
+    results.reserve(view.size());
+    for (uint32_t index : view) {
+        results.push_back(items_[index]);
+    }
     return results;
 }
 
@@ -451,6 +871,126 @@ std::vector<std::shared_ptr<MysticalItem>> AdventurerInventory::getEquippableIte
     return result;
 }
 
+void AdventurerInventory::writeTo(BinaryWriter& out) const {
+    out.write(maxWeight_);
+    out.write(static_cast<int32_t>(maxSlots_));
+
+    // Definition table in first-use order, so identical inventories write identical bytes
+    std::unordered_map<const ItemDefinition*, uint32_t> tableIndex;
+    std::vector<const ItemDefinition*> table;
+    for (const auto& item : items_) {
+        if (tableIndex.emplace(&item->getDefinition(), static_cast<uint32_t>(table.size())).second) {
+            table.push_back(&item->getDefinition());
+        }
+    }
+    out.write(static_cast<uint32_t>(table.size()));
+    for (const ItemDefinition* def : table) {
+        MysticalItem::writeDefinition(out, *def);
+    }
+
+    out.write(static_cast<uint32_t>(items_.size()));
+    for (const auto& item : items_) {
+        out.write(tableIndex[&item->getDefinition()]);
+        item->writeInstance(out);
+    }
+}
+
+bool AdventurerInventory::readFrom(BinaryReader& in, bool perItemDefinitions) {
+    float maxWeight = 0.0f;
+    int32_t maxSlots = 0;
+    if (!in.read(maxWeight) || !in.read(maxSlots)) {
+        return false;
+    }
+
+    std::vector<const ItemDefinition*> table;
+    uint32_t count = 0;
+    if (!perItemDefinitions) {
+        if (!in.read(count)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            const ItemDefinition* def = MysticalItem::readDefinition(in);
+            if (!def) {
+                return false;
+            }
+            table.push_back(def);
+        }
+    }
+
+    if (!in.read(count)) {
+        return false;
+    }
+    std::vector<std::shared_ptr<MysticalItem>> items;
+    items.reserve(std::min<uint32_t>(count, static_cast<uint32_t>(std::max(maxSlots, 0))));
+    for (uint32_t i = 0; i < count; ++i) {
+        std::shared_ptr<MysticalItem> item;
+        if (perItemDefinitions) {
+            item = MysticalItem::readFrom(in);
+        } else {
+            uint32_t index = 0;
+            if (in.read(index) && index < table.size()) {
+                item = MysticalItem::create(table[index]);
+                if (!item->readInstance(in)) {
+                    item.reset();
+                }
+            }
+        }
+        if (!item) {
+            return false;
+        }
+        items.push_back(std::move(item));
+    }
+
+    maxWeight_ = maxWeight;
+    maxSlots_ = maxSlots;
+    items_ = std::move(items);
+    rebuildIndex();
+    return true;
+}
+
+void AdventurerInventory::insertItem(std::shared_ptr<MysticalItem> item) {
+    searchText_.push_back(makeSearchText(*item));
+    adjustTotals(*item, item->getStackSize());
+    items_.push_back(std::move(item));
+}
+
+void AdventurerInventory::eraseItem(size_t index) {
+    adjustTotals(*items_[index], -items_[index]->getStackSize());
+    items_.erase(items_.begin() + static_cast<std::ptrdiff_t>(index));
+    searchText_.erase(searchText_.begin() + static_cast<std::ptrdiff_t>(index));
+    if (items_.empty()) {
+        totalWeight_ = 0.0;  // Nothing left to drift against
+    }
+}
+
+void AdventurerInventory::adjustTotals(const MysticalItem& item, int stackDelta) {
+    totalWeight_ += static_cast<double>(item.getWeight()) * stackDelta;
+    totalValue_ += static_cast<int64_t>(item.getValue()) * stackDelta;
+    ++revision_;
+}
+
+void AdventurerInventory::rebuildIndex() {
+    searchText_.clear();
+    searchText_.reserve(items_.size());
+    totalWeight_ = 0.0;
+    totalValue_ = 0;
+    for (const auto& item : items_) {
+        searchText_.push_back(makeSearchText(*item));
+        totalWeight_ += static_cast<double>(item->getWeight()) * item->getStackSize();
+        totalValue_ += static_cast<int64_t>(item->getValue()) * item->getStackSize();
+    }
+    ++revision_;
+}
+
+std::string AdventurerInventory::makeSearchText(const MysticalItem& item) {
+    // Newlines keep a query from matching across two fields
+    std::string text = item.getName() + "\n" + item.getDescription() + "\n" +
+                       ItemUtils::itemTypeToString(item.getType()) + "\n" +
+                       ItemUtils::rarityToString(item.getRarity());
+    std::transform(text.begin(), text.end(), text.begin(), ::tolower);
+    return text;
+}
+
 bool AdventurerInventory::canAddItem(const std::shared_ptr<MysticalItem>& item, int quantity) const {
     // Check slot availability
     if (isFull() && !item->isStackable()) {
@@ -459,7 +999,7 @@ bool AdventurerInventory::canAddItem(const std::shared_ptr<MysticalItem>& item,
     
     // Check weight limit
     float additionalWeight = item->getWeight() * quantity;
-    if (getCurrentWeight() + additionalWeight > maxWeight_) {
+    if (totalWeight_ + additionalWeight > maxWeight_) {
         return false;
     }
     
@@ -499,6 +1039,7 @@ bool EquipmentManager::equipItem(std::shared_ptr<MysticalItem> item) {
     }
     
     equipment_[slot] = item;
+    updateTotals();
     std::cout << "Equipped " << item->getName() << " in " << getSlotName(slot) << std::endl;
     
     return true;
@@ -508,6 +1049,7 @@ std::shared_ptr<MysticalItem> EquipmentManager::unequipItem(EquipmentSlot slot)
     auto item = equipment_[slot];
     if (item) {
         equipment_[slot] = nullptr;
+        updateTotals();
         std::cout << "Unequipped " << item->getName() << std::endl;
     }
     return item;
@@ -523,11 +1065,15 @@ bool EquipmentManager::isSlotOccupied(EquipmentSlot slot) const {
     return item != nullptr;
 }
 
-ItemStats EquipmentManager::getTotalStats() const {
+void EquipmentManager::updateTotals() {
+    // At most one item per slot, so a full recount on each change is cheaper than tracking deltas
     ItemStats total;
+    float totalWeight = 0.0f;
     
     for (const auto& [slot, item] : equipment_) {
-        if (item && !item->isBroken()) {
+        if (!item) continue;
+        totalWeight += item->getWeight();
+        if (!item->isBroken()) {
             const auto& stats = item->getStats();
             total.damage += stats.damage;
             total.armor += stats.armor;
@@ -550,25 +1096,9 @@ ItemStats EquipmentManager::getTotalStats() const {
         }
     }
     
-    return total;
-}
-
-int EquipmentManager::getTotalArmor() const {
-    return getTotalStats().armor;
-}
-
-int EquipmentManager::getTotalDamage() const {
-    return getTotalStats().damage;
-}
-
-float EquipmentManager::getTotalWeight() const {
-    float totalWeight = 0.0f;
-    for (const auto& [slot, item] : equipment_) {
-        if (item) {
-            totalWeight += item->getWeight();
-        }
-    }
-    return totalWeight;
+    totalStats_ = total;
+    totalWeight_ = totalWeight;
+    ++revision_;
 }
 
 bool EquipmentManager::hasFullArmorSet() const {
@@ -599,6 +1129,7 @@ void EquipmentManager::damageEquipment(EquipmentSlot slot, float damage) {
     auto item = getEquippedItem(slot);
     if (item) {
         item->takeDamage(damage);
+        updateTotals();
         if (item->isBroken()) {
             std::cout << "Warning: " << item->getName() << " has broken!" << std::endl;
         }
@@ -609,6 +1140,7 @@ void EquipmentManager::repairEquipment(EquipmentSlot slot, float amount) {
     auto item = getEquippedItem(slot);
     if (item) {
         item->repair(amount);
+        updateTotals();
     }
 }
 
@@ -622,6 +1154,58 @@ std::vector<EquipmentSlot> EquipmentManager::getBrokenEquipment() const {
     return broken;
 }
 
+void EquipmentManager::writeTo(BinaryWriter& out) const {
+    // Slot order rather than map order, so identical equipment writes identical bytes
+    uint32_t occupied = 0;
+    for (int i = 0; i <= static_cast<int>(EquipmentSlot::AMULET); ++i) {
+        if (isSlotOccupied(static_cast<EquipmentSlot>(i))) occupied++;
+    }
+    out.write(occupied);
+    for (int i = 0; i <= static_cast<int>(EquipmentSlot::AMULET); ++i) {
+        auto item = getEquippedItem(static_cast<EquipmentSlot>(i));
+        if (item) {
+            out.write(static_cast<uint8_t>(i));
+            MysticalItem::writeDefinition(out, item->getDefinition());
+            item->writeInstance(out);
+        }
+    }
+}
+
+bool EquipmentManager::readFrom(BinaryReader& in, bool perItemDefinitions) {
+    uint32_t occupied = 0;
+    if (!in.read(occupied)) {
+        return false;
+    }
+
+    std::unordered_map<EquipmentSlot, std::shared_ptr<MysticalItem>> equipment;
+    for (int i = 0; i <= static_cast<int>(EquipmentSlot::AMULET); ++i) {
+        equipment[static_cast<EquipmentSlot>(i)] = nullptr;
+    }
+    for (uint32_t i = 0; i < occupied; ++i) {
+        uint8_t slot = 0;
+        if (!in.read(slot) || slot > static_cast<uint8_t>(EquipmentSlot::AMULET)) {
+            return false;
+        }
+        std::shared_ptr<MysticalItem> item;
+        if (perItemDefinitions) {
+            item = MysticalItem::readFrom(in);
+        } else if (const ItemDefinition* def = MysticalItem::readDefinition(in)) {
+            item = MysticalItem::create(def);
+            if (!item->readInstance(in)) {
+                item.reset();
+            }
+        }
+        if (!item) {
+            return false;
+        }
+        equipment[static_cast<EquipmentSlot>(slot)] = std::move(item);
+    }
+
+    equipment_ = std::move(equipment);
+    updateTotals();
+    return true;
+}
+
 bool EquipmentManager::canEquipItem(const std::shared_ptr<MysticalItem>& item) const {
     return item && item->isEquippable() && !item->isBroken();
 }
@@ -684,8 +1268,39 @@ std::shared_ptr<MysticalItem> InventorySystem::createMiscItem(const std::string&
     return std::make_shared<MysticalItem>(name, type, weight, value);
 }
 
-ItemStats InventorySystem::getTotalBonuses() const {
-    return equipment_.getTotalStats();
+const ItemStats& InventorySystem::getTotalBonuses() const {
+    syncEquipmentModifiers();
+    return modifiers_.getTotal();
+}
+
+bool InventorySystem::startTimedEffect(const AlchemicalPotion& potion) {
+    if (potion.isInstant()) {
+        return false;
+    }
+    modifiers_.addAdditive(potion.getEffects(), static_cast<float>(potion.getDuration()));
+    return true;
+}
+
+void InventorySystem::update(float deltaTime) {
+    modifiers_.update(deltaTime);
+}
+
+void InventorySystem::syncEquipmentModifiers() const {
+    if (syncedEquipmentRevision_ == equipment_.getRevision()) {
+        return;
+    }
+    syncedEquipmentRevision_ = equipment_.getRevision();
+
+    modifiers_.remove(equipmentModifier_);
+    for (auto& handle : setBonusModifiers_) {
+        modifiers_.remove(handle);
+    }
+    setBonusModifiers_.clear();
+
+    equipmentModifier_ = modifiers_.addAdditive(equipment_.getTotalStats());
+    if (equipment_.hasFullArmorSet()) {
+        setBonusModifiers_.push_back(modifiers_.addMultiplier(StatId::ARMOR, 1.10f));  // Full Armor Set
+    }
 }
 
 float InventorySystem::getCarryCapacity() const {
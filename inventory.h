@@ -5,6 +5,12 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <array>
+#include <deque>
+#include <mutex>
+#include <algorithm>
+#include <cstdint>
+#include "frame_arena.h"
 
 /**
  * Fantasy-themed inventory system for Browserwind
@@ -13,6 +19,8 @@
 
 // Forward declarations
 class Player;
+class BinaryWriter;
+class BinaryReader;
 
 /**
  * Types of magical and mundane items found in the realm
@@ -109,77 +117,263 @@ struct ItemStats {
     bool levitation = false;
 };
 
+/// Numeric ItemStats fields, for modifiers that scale one of them
+enum class StatId : uint8_t {
+    DAMAGE, ARMOR, HEALTH, MANA, STAMINA,
+    STRENGTH, INTELLIGENCE, AGILITY, LUCK,
+    FIRE_RESIST, COLD_RESIST, SHOCK_RESIST, POISON_RESIST,
+    COUNT
+};
+
+/// \brief Gets the field of `stats` that `stat` names.
+int& statField(ItemStats& stats, StatId stat);
+inline int statField(const ItemStats& stats, StatId stat) { return statField(const_cast<ItemStats&>(stats), stat); }
+
+/**
+ * Additive and multiplicative stat modifiers with a cached total
+ * Equipment, set bonuses and timed potion effects register here. The total is
+ * the sum of every additive modifier with each stat then scaled by the product
+ * of its multipliers, and is only rebuilt after a modifier is added, removed
+ * or expires. Timed modifiers sit on a timer wheel, so a tick only visits the
+ * modifiers due in that slot.
+ */
+class StatModifierStack {
+public:
+    static constexpr float TICK_SECONDS = 0.1f;
+    static constexpr size_t WHEEL_SLOTS = 256;      // One revolution covers 25.6 seconds
+
+    struct Handle {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+        bool isValid() const { return index != UINT32_MAX; }
+    };
+
+    /// \brief Adds `stats` to the total.
+    /// \param durationSeconds Time until it expires on its own; 0 keeps it until removed.
+    Handle addAdditive(const ItemStats& stats, float durationSeconds = 0.0f);
+
+    /// \brief Scales one stat of the total.
+    /// \param durationSeconds Time until it expires on its own; 0 keeps it until removed.
+    Handle addMultiplier(StatId stat, float factor, float durationSeconds = 0.0f);
+
+    /// \brief Removes a modifier and invalidates the handle. Expired or stale handles are ignored.
+    void remove(Handle& handle);
+
+    bool isActive(const Handle& handle) const;
+
+    /// \brief Advances the timer wheel and expires what is due.
+    void update(float deltaTime);
+
+    /// \brief Gets the combined stats, rebuilding them first if a modifier changed.
+    const ItemStats& getTotal() const;
+
+    size_t getActiveCount() const { return slots_.size() - freeSlots_.size(); }
+    uint32_t getRebuildCount() const { return rebuilds_; }
+
+private:
+    struct Modifier {
+        ItemStats additive;
+        StatId stat = StatId::COUNT;    // COUNT for additive modifiers
+        float factor = 1.0f;
+        uint32_t generation = 0;
+        bool active = false;
+    };
+
+    struct TimerEntry {
+        uint32_t index;
+        uint32_t generation;
+        uint32_t rounds;                // Full wheel turns still to wait
+    };
+
+    Handle allocate(float durationSeconds);
+
+    std::vector<Modifier> slots_;
+    std::vector<uint32_t> freeSlots_;
+    std::array<std::vector<TimerEntry>, WHEEL_SLOTS> wheel_;
+    size_t cursor_ = 0;
+    float tickAccumulator_ = 0.0f;
+
+    mutable ItemStats total_;
+    mutable bool dirty_ = false;
+    mutable uint32_t rebuilds_ = 0;
+};
+
+/// Concrete item class; the values are written to saves
+enum class ItemKind : uint8_t { BASE = 0, WEAPON = 1, ARMOR = 2, POTION = 3 };
+
+bool operator==(const ItemStats& a, const ItemStats& b);
+inline bool operator!=(const ItemStats& a, const ItemStats& b) { return !(a == b); }
+
+/**
+ * Immutable description shared by every item of the same kind
+ * Ten identical potions point at one definition and differ only in their
+ * per-instance state (stack size, durability, enchantment)
+ */
+struct ItemDefinition {
+    uint32_t id = 0;            // Assigned by ItemDefinitionRegistry; not stable across runs
+    ItemKind kind = ItemKind::BASE;
+    std::string name;
+    std::string description;
+    ItemType type = ItemType::MISC;
+    ItemRarity rarity = ItemRarity::COMMON;
+    float weight = 1.0f;
+    int value = 1;
+    EquipmentSlot equipSlot = EquipmentSlot::NONE;
+    ItemStats stats;
+    bool stackable = false;
+    int maxStack = 1;
+
+    // Weapon properties
+    WeaponType weaponType = WeaponType::LONGSWORD;
+    float attackSpeed = 1.0f;   // Attacks per second
+    float critChance = 0.05f;
+
+    // Armor properties
+    ArmorType armorType = ArmorType::LIGHT;
+
+    // Potion properties
+    ItemStats effects;          // Effects when consumed
+    int duration = 0;           // Effect duration in seconds, 0 = instant
+
+    /// \brief Compares everything but the id.
+    bool sameContent(const ItemDefinition& other) const;
+};
+
+/**
+ * Interns item definitions so equal ones are stored once
+ * Definitions live until exit, so items can hold plain pointers to them.
+ */
+class ItemDefinitionRegistry {
+public:
+    static ItemDefinitionRegistry& getInstance() {
+        static ItemDefinitionRegistry instance;
+        return instance;
+    }
+
+    /// \brief Returns the registered definition equal to `def`, registering a copy if there is none.
+    const ItemDefinition* intern(const ItemDefinition& def);
+
+    /// \brief Gets a definition by id, or null.
+    const ItemDefinition* find(uint32_t id) const;
+
+    size_t size() const;
+
+private:
+    ItemDefinitionRegistry() = default;
+
+    mutable std::mutex mutex_;
+    std::deque<ItemDefinition> definitions_;                            // Stable addresses; id - 1 indexes it
+    std::unordered_map<std::string, std::vector<uint32_t>> byName_;     // Ids of definitions sharing a name
+};
+
 /**
  * Base class for all items in the realm
- * Represents everything from mystical artifacts to common tools
+ * Represents everything from mystical artifacts to common tools. An item is a
+ * shared ItemDefinition plus its own stack size, durability and enchantment;
+ * setters that change the definition switch the item to another interned one.
  */
 class MysticalItem {
 public:
     MysticalItem(const std::string& name, ItemType type, float weight = 1.0f, int value = 1);
     virtual ~MysticalItem() = default;
 
+    /// \brief Creates an item of the class `def->kind` names, with fresh instance state.
+    static std::shared_ptr<MysticalItem> create(const ItemDefinition* def);
+
+    /// \brief Copies this item, keeping its concrete class.
+    std::shared_ptr<MysticalItem> clone() const;
+
     // Core properties
-    const std::string& getName() const { return name_; }
-    const std::string& getDescription() const { return description_; }
-    ItemType getType() const { return type_; }
-    float getWeight() const { return weight_; }
-    int getValue() const { return value_; }
-    ItemRarity getRarity() const { return rarity_; }
-    const ItemStats& getStats() const { return stats_; }
+    const ItemDefinition& getDefinition() const { return *def_; }
+    const std::string& getName() const { return def_->name; }
+    const std::string& getDescription() const { return def_->description; }
+    ItemType getType() const { return def_->type; }
+    float getWeight() const { return def_->weight; }
+    int getValue() const { return def_->value; }
+    ItemRarity getRarity() const { return def_->rarity; }
+    const ItemStats& getStats() const { return enchantment_ ? *enchantment_ : def_->stats; }
     
     // Equipment properties
-    EquipmentSlot getEquipmentSlot() const { return equipSlot_; }
-    bool isEquippable() const { return equipSlot_ != EquipmentSlot::NONE; }
-    bool isStackable() const { return stackable_; }
+    EquipmentSlot getEquipmentSlot() const { return def_->equipSlot; }
+    bool isEquippable() const { return def_->equipSlot != EquipmentSlot::NONE; }
+    bool isStackable() const { return def_->stackable; }
     int getStackSize() const { return stackSize_; }
-    int getMaxStack() const { return maxStack_; }
+    int getMaxStack() const { return def_->maxStack; }
     
     // Condition/durability
     float getDurability() const { return durability_; }
     float getMaxDurability() const { return maxDurability_; }
     bool isBroken() const { return durability_ <= 0.0f; }
+
+    // Enchantment: per-instance stats that replace the definition's
+    bool isEnchanted() const { return enchantment_ != nullptr; }
+    void setEnchantment(const ItemStats& stats) { enchantment_ = std::make_shared<const ItemStats>(stats); }
+    void clearEnchantment() { enchantment_.reset(); }
     
     // Setters for configuration
-    void setDescription(const std::string& desc) { description_ = desc; }
-    void setRarity(ItemRarity rarity) { rarity_ = rarity; }
-    void setEquipmentSlot(EquipmentSlot slot) { equipSlot_ = slot; }
-    void setStackable(bool stackable, int maxStack = 1) { 
-        stackable_ = stackable; 
-        maxStack_ = maxStack; 
+    void setDescription(const std::string& desc) { redefine([&](ItemDefinition& d) { d.description = desc; }); }
+    void setRarity(ItemRarity rarity) { redefine([&](ItemDefinition& d) { d.rarity = rarity; }); }
+    void setEquipmentSlot(EquipmentSlot slot) { redefine([&](ItemDefinition& d) { d.equipSlot = slot; }); }
+    void setStackable(bool stackable, int maxStack = 1) {
+        redefine([&](ItemDefinition& d) {
+            d.stackable = stackable;
+            d.maxStack = maxStack;
+        });
     }
-    void setStats(const ItemStats& stats) { stats_ = stats; }
+    void setStats(const ItemStats& stats) { redefine([&](ItemDefinition& d) { d.stats = stats; }); }
     void setDurability(float current, float maximum = -1.0f);
     
     // Item manipulation
     bool canStackWith(const MysticalItem& other) const;
-    void addToStack(int amount) { stackSize_ = std::min(stackSize_ + amount, maxStack_); }
+    void addToStack(int amount) { stackSize_ = std::min(stackSize_ + amount, def_->maxStack); }
     void removeFromStack(int amount) { stackSize_ = std::max(0, stackSize_ - amount); }
     void takeDamage(float damage);
     void repair(float amount);
     
     // Virtual methods for specialized items
     virtual bool canUse() const { return true; }
-    virtual std::string getDisplayName() const;
-    virtual std::string getTooltip() const;
+    std::string getDisplayName() const;
+    std::string getTooltip() const;
+    /// \brief Appends the display name; UI code passes a FrameString so nothing hits the heap.
+    virtual void writeDisplayName(FrameString& out) const;
+    /// \brief Appends the multi-line tooltip text.
+    virtual void writeTooltip(FrameString& out) const;
+
+    // Save support: containers write each definition once, then per-item instance state
+    /// \brief Writes a definition, tagged with the item class it describes.
+    static void writeDefinition(BinaryWriter& out, const ItemDefinition& def);
+
+    /// \brief Reads and interns a definition written by writeDefinition().
+    /// \return Null if the data is malformed.
+    static const ItemDefinition* readDefinition(BinaryReader& in);
+
+    /// \brief Writes the stack size, durability and enchantment.
+    void writeInstance(BinaryWriter& out) const;
+
+    /// \brief Reads state written by writeInstance().
+    bool readInstance(BinaryReader& in);
+
+    /// \brief Reads an item from a version 3 or older save, which wrote every item in full.
+    /// \return Null if the data is malformed.
+    static std::shared_ptr<MysticalItem> readFrom(BinaryReader& in);
 
 protected:
-    std::string name_;
-    std::string description_;
-    ItemType type_;
-    ItemRarity rarity_ = ItemRarity::COMMON;
-    float weight_;
-    int value_;
-    
-    // Equipment properties
-    EquipmentSlot equipSlot_ = EquipmentSlot::NONE;
-    ItemStats stats_;
-    
-    // Stacking
-    bool stackable_ = false;
+    explicit MysticalItem(const ItemDefinition* def) : def_(def) {}
+
+    /// \brief Interns a modified copy of the current definition and switches to it.
+    template<typename Edit>
+    void redefine(Edit edit) {
+        ItemDefinition def = *def_;
+        edit(def);
+        def_ = ItemDefinitionRegistry::getInstance().intern(def);
+    }
+
+    /// \brief Reads a definition; with `legacyInstance`, also the instance fields old saves interleave.
+    static const ItemDefinition* readDefinitionFields(BinaryReader& in, MysticalItem* legacyInstance);
+
+    const ItemDefinition* def_;
+    std::shared_ptr<const ItemStats> enchantment_;  // Null unless enchanted; copies share it
     int stackSize_ = 1;
-    int maxStack_ = 1;
-    
-    // Durability
     float durability_ = 100.0f;
     float maxDurability_ = 100.0f;
 };
@@ -190,20 +384,16 @@ protected:
 class EnchantedWeapon : public MysticalItem {
 public:
     EnchantedWeapon(const std::string& name, WeaponType weaponType, int damage, float weight = 3.0f);
+    explicit EnchantedWeapon(const ItemDefinition* def) : MysticalItem(def) {}
     
-    WeaponType getWeaponType() const { return weaponType_; }
-    float getAttackSpeed() const { return attackSpeed_; }
-    float getCritChance() const { return critChance_; }
+    WeaponType getWeaponType() const { return def_->weaponType; }
+    float getAttackSpeed() const { return def_->attackSpeed; }
+    float getCritChance() const { return def_->critChance; }
     
-    void setAttackSpeed(float speed) { attackSpeed_ = speed; }
-    void setCritChance(float chance) { critChance_ = chance; }
+    void setAttackSpeed(float speed) { redefine([&](ItemDefinition& d) { d.attackSpeed = speed; }); }
+    void setCritChance(float chance) { redefine([&](ItemDefinition& d) { d.critChance = chance; }); }
     
-    std::string getTooltip() const override;
-
-private:
-    WeaponType weaponType_;
-    float attackSpeed_ = 1.0f;      // Attacks per second
-    float critChance_ = 0.05f;      // 5% base crit chance
+    void writeTooltip(FrameString& out) const override;
 };
 
 /**
@@ -212,13 +402,11 @@ private:
 class GuardianArmor : public MysticalItem {
 public:
     GuardianArmor(const std::string& name, ArmorType armorType, int armor, EquipmentSlot slot);
+    explicit GuardianArmor(const ItemDefinition* def) : MysticalItem(def) {}
     
-    ArmorType getArmorType() const { return armorType_; }
+    ArmorType getArmorType() const { return def_->armorType; }
     
-    std::string getTooltip() const override;
-
-private:
-    ArmorType armorType_;
+    void writeTooltip(FrameString& out) const override;
 };
 
 /**
@@ -227,17 +415,24 @@ private:
 class AlchemicalPotion : public MysticalItem {
 public:
     AlchemicalPotion(const std::string& name, const ItemStats& effects, int duration = 0);
+    explicit AlchemicalPotion(const ItemDefinition* def) : MysticalItem(def) {}
     
-    const ItemStats& getEffects() const { return effects_; }
-    int getDuration() const { return duration_; }  // Duration in seconds, 0 = instant
-    bool isInstant() const { return duration_ == 0; }
+    const ItemStats& getEffects() const { return def_->effects; }
+    int getDuration() const { return def_->duration; }  // Duration in seconds, 0 = instant
+    bool isInstant() const { return def_->duration == 0; }
     
     bool canUse() const override { return stackSize_ > 0; }
-    std::string getTooltip() const override;
+    void writeTooltip(FrameString& out) const override;
+};
 
-private:
-    ItemStats effects_;     // Effects when consumed
-    int duration_;          // Effect duration in seconds
+/// Display order of an inventory view; the stored items keep their insertion order
+enum class InventorySort : uint8_t {
+    NONE,       // Insertion order
+    TYPE,
+    VALUE,      // Most valuable first
+    WEIGHT,     // Lightest first
+    NAME,
+    RARITY      // Rarest first
 };
 
 /**
@@ -259,19 +454,32 @@ public:
     // Inventory state
     bool hasItem(const std::string& itemName, int quantity = 1) const;
     int getItemQuantity(const std::string& itemName) const;
-    float getCurrentWeight() const;
+    float getCurrentWeight() const { return static_cast<float>(totalWeight_); }
+    /// \brief Gets the summed value of every item, stacks included.
+    int64_t getTotalValue() const { return totalValue_; }
     float getMaxWeight() const { return maxWeight_; }
     int getUsedSlots() const { return static_cast<int>(items_.size()); }
     int getMaxSlots() const { return maxSlots_; }
     bool isFull() const { return getUsedSlots() >= maxSlots_; }
     bool isOverweight() const { return getCurrentWeight() > maxWeight_; }
     
-    // Organization
-    void sortByType();
-    void sortByValue();
-    void sortByWeight();
-    void sortByName();
-    void sortByRarity();
+    // Organization: these pick the display order of getView(); getAllItems() keeps insertion order
+    void sortByType() { setSortOrder(InventorySort::TYPE); }
+    void sortByValue() { setSortOrder(InventorySort::VALUE); }
+    void sortByWeight() { setSortOrder(InventorySort::WEIGHT); }
+    void sortByName() { setSortOrder(InventorySort::NAME); }
+    void sortByRarity() { setSortOrder(InventorySort::RARITY); }
+    void setSortOrder(InventorySort sort);
+    InventorySort getSortOrder() const { return sort_; }
+
+    /// \brief Gets indices into getAllItems() in display order, limited to items matching `query`.
+    ///
+    /// Matching is a case-insensitive substring test against each item's name, description,
+    /// type and rarity, using a lowercase index kept up to date as items change. The last
+    /// result is cached, and a query that extends it (the player typing another letter) only
+    /// filters the previous matches. The reference is valid until the inventory changes.
+    /// \param query Search text; empty views every item.
+    const std::vector<uint32_t>& getView(const std::string& query = std::string()) const;
 
     // Search and filtering
     std::vector<std::shared_ptr<MysticalItem>> searchItems(const std::string& query) const;
@@ -285,13 +493,43 @@ public:
     // Capacity management
     void setMaxWeight(float weight) { maxWeight_ = weight; }
     void setMaxSlots(int slots) { maxSlots_ = slots; }
+
+    // Save support
+    /// \brief Writes capacity, each distinct item definition once, then every item's instance state, in order.
+    void writeTo(BinaryWriter& out) const;
+
+    /// \brief Replaces the contents with data written by writeTo(); unchanged on failure.
+    /// \param perItemDefinitions True for saves older than the definition table, which wrote
+    /// every item in full.
+    /// \return False if the data is malformed.
+    bool readFrom(BinaryReader& in, bool perItemDefinitions = false);
     
 private:
     std::vector<std::shared_ptr<MysticalItem>> items_;
     float maxWeight_;
     int maxSlots_;
-    
+
+    // Kept in step with items_ by every mutation below
+    std::vector<std::string> searchText_;   // Lowercase searchable text, parallel to items_
+    double totalWeight_ = 0.0;              // Double so long add/remove sequences don't drift
+    int64_t totalValue_ = 0;
+    InventorySort sort_ = InventorySort::NONE;
+    uint32_t revision_ = 0;                 // Bumped whenever items, stacks or the sort order change
+
+    // View caches, rebuilt lazily when revision_ moves on
+    mutable std::vector<uint32_t> sortedOrder_;
+    mutable uint32_t sortedRevision_ = UINT32_MAX;
+    mutable std::string viewQuery_;
+    mutable std::vector<uint32_t> viewResults_;
+    mutable uint32_t viewRevision_ = UINT32_MAX;
+
     // Helper methods
+    void insertItem(std::shared_ptr<MysticalItem> item);
+    void eraseItem(size_t index);
+    void adjustTotals(const MysticalItem& item, int stackDelta);
+    void rebuildIndex();
+    static std::string makeSearchText(const MysticalItem& item);
+    const std::vector<uint32_t>& getSortedOrder() const;
     bool canAddItem(const std::shared_ptr<MysticalItem>& item, int quantity) const;
     std::shared_ptr<MysticalItem> findStackableItem(const std::shared_ptr<MysticalItem>& item) const;
 };
@@ -311,11 +549,13 @@ public:
     std::shared_ptr<MysticalItem> getEquippedItem(EquipmentSlot slot) const;
     bool isSlotOccupied(EquipmentSlot slot) const;
     
-    // Stats calculation
-    ItemStats getTotalStats() const;
-    int getTotalArmor() const;
-    int getTotalDamage() const;
-    float getTotalWeight() const;
+    // Stats calculation, from totals kept up to date as equipment changes or breaks
+    const ItemStats& getTotalStats() const { return totalStats_; }
+    int getTotalArmor() const { return totalStats_.armor; }
+    int getTotalDamage() const { return totalStats_.damage; }
+    float getTotalWeight() const { return totalWeight_; }
+    /// \brief Changes whenever the equipped set or an item's condition changes.
+    uint32_t getRevision() const { return revision_; }
     
     // Equipment sets/combos
     bool hasFullArmorSet() const;
@@ -326,6 +566,15 @@ public:
         return equipment_; 
     }
     
+    // Save support
+    /// \brief Writes each occupied slot with its item's definition and instance state.
+    void writeTo(BinaryWriter& out) const;
+
+    /// \brief Replaces equipped items with data written by writeTo(); unchanged on failure.
+    /// \param perItemDefinitions True for saves older than the definition table.
+    /// \return False if the data is malformed.
+    bool readFrom(BinaryReader& in, bool perItemDefinitions = false);
+
     // Durability management
     void damageEquipment(EquipmentSlot slot, float damage);
     void repairEquipment(EquipmentSlot slot, float amount);
@@ -333,8 +582,12 @@ public:
 
 private:
     std::unordered_map<EquipmentSlot, std::shared_ptr<MysticalItem>> equipment_;
+    ItemStats totalStats_;          // Unbroken items only
+    float totalWeight_ = 0.0f;
+    uint32_t revision_ = 0;
     
     // Helper methods
+    void updateTotals();
     bool canEquipItem(const std::shared_ptr<MysticalItem>& item) const;
     std::string getSlotName(EquipmentSlot slot) const;
 };
@@ -367,21 +620,33 @@ public:
     std::shared_ptr<MysticalItem> createMiscItem(const std::string& name, ItemType type, float weight = 1.0f, int value = 1);
     
     // Player stats integration
-    ItemStats getTotalBonuses() const;
+    /// \brief Gets equipment, set bonus and active effect stats combined; cached between changes.
+    const ItemStats& getTotalBonuses() const;
+
+    /// \brief Starts a potion's timed buff, which adds its effects to the bonuses until it runs out.
+    /// \return False for instant potions, which have nothing to time.
+    bool startTimedEffect(const AlchemicalPotion& potion);
+
+    /// \brief Expires timed effects.
+    void update(float deltaTime);
     float getCarryCapacity() const;
     bool isOverencumbered() const;
     
-    // Save/load support
-    void saveToFile(const std::string& filename) const;
-    bool loadFromFile(const std::string& filename);
-    
     // Debug and testing
     void printInventoryStatus() const;
     void addStartingItems();  // Add some basic starting gear
 
 private:
+    /// \brief Re-registers the equipment and set bonus modifiers if the equipment changed.
+    void syncEquipmentModifiers() const;
+
     AdventurerInventory inventory_;
     EquipmentManager equipment_;
+
+    mutable StatModifierStack modifiers_;
+    mutable StatModifierStack::Handle equipmentModifier_;
+    mutable std::vector<StatModifierStack::Handle> setBonusModifiers_;
+    mutable uint32_t syncedEquipmentRevision_ = UINT32_MAX;
 };
 
 // Global utility functions for item management
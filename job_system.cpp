@@ -0,0 +1,191 @@
+#include "job_system.h"
+#include "profiler.h"
+#include <chrono>
+#include <iostream>
+
+namespace {
+    // Index into local_queues_ on worker threads, -1 elsewhere
+    thread_local int t_worker_index = -1;
+}
+
+// ============================================================================
+// JobSystem
+// ============================================================================
+
+void JobSystem::start(unsigned workerCount) {
+    if (running_.load()) return;
+
+    if (workerCount == 0) {
+        unsigned hw = std::thread::hardware_concurrency();
+        workerCount = hw > 1 ? hw - 1 : 1;
+    }
+
+    main_thread_ = std::this_thread::get_id();
+    Profiler::getInstance().setThreadName("Main");
+    running_.store(true);
+    local_queues_.clear();
+    for (unsigned i = 0; i < workerCount; ++i) {
+        local_queues_.push_back(std::make_unique<WorkQueue>());
+    }
+    for (unsigned i = 0; i < workerCount; ++i) {
+        workers_.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+    std::cout << "JOB SYSTEM: Started " << workerCount << " worker threads" << std::endl;
+}
+
+void JobSystem::stop() {
+    if (!running_.load()) return;
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        running_.store(false);
+    }
+    sleep_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+    workers_.clear();
+
+    // Anything left (main-thread jobs, late submits) runs here so counters still drain
+    while (tryRunOne(-1)) {}
+    local_queues_.clear();
+}
+
+void JobSystem::submit(JobFunction job, Counter* counter, bool mainThreadOnly) {
+    if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+
+    WorkQueue* queue = &injection_queue_;
+    if (mainThreadOnly) {
+        queue = &main_queue_;
+    } else if (t_worker_index >= 0 && t_worker_index < static_cast<int>(local_queues_.size())) {
+        queue = local_queues_[t_worker_index].get();
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->jobs.push_back({std::move(job), counter});
+    }
+    queued_.fetch_add(1, std::memory_order_release);
+    if (!mainThreadOnly) sleep_cv_.notify_one();
+}
+
+void JobSystem::wait(Counter& counter) {
+    while (counter.pending.load(std::memory_order_acquire) > 0) {
+        if (!tryRunOne(t_worker_index)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::workerLoop(unsigned index) {
+    t_worker_index = static_cast<int>(index);
+    Profiler::getInstance().setThreadName("Job Worker " + std::to_string(index));
+    while (true) {
+        if (tryRunOne(t_worker_index)) continue;
+        if (!running_.load(std::memory_order_acquire)) break;
+
+        // Timed wait: a steal target can fill up without a notify reaching this worker
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleep_cv_.wait_for(lock, std::chrono::milliseconds(1), [this] {
+            return queued_.load(std::memory_order_acquire) > 0 || !running_.load(std::memory_order_acquire);
+        });
+    }
+    t_worker_index = -1;
+}
+
+bool JobSystem::tryRunOne(int workerIndex) {
+    Job job;
+    bool found = false;
+
+    if (isMainThread()) {
+        found = popFront(main_queue_, job);
+    }
+    if (!found && workerIndex >= 0) {
+        found = popBack(*local_queues_[workerIndex], job);
+    }
+    if (!found) {
+        found = popFront(injection_queue_, job);
+    }
+    // Steal, starting after our own queue so thieves spread across victims
+    size_t count = local_queues_.size();
+    for (size_t i = 1; !found && i <= count; ++i) {
+        size_t victim = (static_cast<size_t>(workerIndex + 1) + i) % count;
+        if (static_cast<int>(victim) == workerIndex) continue;
+        found = popFront(*local_queues_[victim], job);
+    }
+
+    if (!found) return false;
+    execute(job);
+    return true;
+}
+
+bool JobSystem::popBack(WorkQueue& queue, Job& out) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+    out = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool JobSystem::popFront(WorkQueue& queue, Job& out) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+    out = std::move(queue.jobs.front());
+    queue.jobs.pop_front();
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+void JobSystem::execute(Job& job) {
+    job.function();
+    if (job.counter) {
+        job.counter->pending.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+// ============================================================================
+// JobGraph
+// ============================================================================
+
+JobGraph::NodeId JobGraph::add(const std::string& name, JobSystem::JobFunction job, bool mainThreadOnly) {
+    auto node = std::make_unique<Node>();
+    node->name = name;
+    node->profile_name = Profiler::getInstance().intern(name);
+    node->job = std::move(job);
+    node->main_thread_only = mainThreadOnly;
+    nodes_.push_back(std::move(node));
+    return nodes_.size() - 1;
+}
+
+void JobGraph::dependsOn(NodeId node, NodeId prerequisite) {
+    nodes_[prerequisite]->dependents.push_back(node);
+    nodes_[node]->prerequisites++;
+}
+
+void JobGraph::run(JobSystem& jobs) {
+    for (auto& node : nodes_) {
+        node->remaining.store(node->prerequisites, std::memory_order_relaxed);
+    }
+    JobSystem::Counter done;
+    for (NodeId id = 0; id < nodes_.size(); ++id) {
+        if (nodes_[id]->prerequisites == 0) {
+            schedule(jobs, id, done);
+        }
+    }
+    jobs.wait(done);
+}
+
+void JobGraph::schedule(JobSystem& jobs, NodeId id, JobSystem::Counter& done) {
+    Node* node = nodes_[id].get();
+    jobs.submit([this, &jobs, &done, node] {
+        {
+            ProfileScope scope(node->profile_name);
+            node->job();
+        }
+        // Dependents are submitted before this job's own count drops, so `done` can't hit zero early
+        for (NodeId dependent : node->dependents) {
+            if (nodes_[dependent]->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                schedule(jobs, dependent, done);
+            }
+        }
+    }, &done, node->main_thread_only);
+}
@@ -0,0 +1,149 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// \brief Work-stealing job scheduler.
+///
+/// Each worker owns a deque: it pushes and pops at the back, idle workers steal from the
+/// front. Jobs submitted from outside a worker go to a shared injection queue. Waiting on a
+/// counter never blocks a thread outright; it keeps running other jobs until the counter
+/// drains, so jobs may fan out and wait on sub-jobs. Jobs marked main-thread-only are run
+/// solely by the thread that called start(), for work that touches raylib or UI state.
+class JobSystem {
+public:
+    using JobFunction = std::function<void()>;
+
+    /// \brief Completion counter; wait() returns once every job submitted against it has run.
+    struct Counter {
+        std::atomic<int> pending{0};
+    };
+
+    static JobSystem& getInstance() {
+        static JobSystem instance;
+        return instance;
+    }
+
+    /// \brief Starts workers. The calling thread becomes the main thread.
+    /// \param workerCount Worker threads; 0 picks hardware_concurrency - 1.
+    void start(unsigned workerCount = 0);
+
+    /// \brief Joins all workers. Pending jobs are run by the caller first.
+    void stop();
+
+    /// \brief Gets number of worker threads (the main thread also runs jobs while waiting).
+    unsigned getWorkerCount() const { return static_cast<unsigned>(workers_.size()); }
+
+    /// \brief Queues a job.
+    /// \param job Job to run.
+    /// \param counter Incremented now, decremented when the job finishes; may be null.
+    /// \param mainThreadOnly Run only on the main thread.
+    void submit(JobFunction job, Counter* counter, bool mainThreadOnly = false);
+
+    /// \brief Runs queued jobs on this thread until the counter reaches zero.
+    void wait(Counter& counter);
+
+    /// \brief Splits [0, count) into chunks of `grain` and runs fn(begin, end) for each in parallel.
+    /// The calling thread takes the first chunk and helps with the rest. Small ranges run inline.
+    template<typename Fn>
+    void parallelFor(size_t count, size_t grain, Fn&& fn) {
+        if (count == 0) return;
+        if (grain == 0) grain = 1;
+        if (workers_.empty() || count <= grain) {
+            fn(size_t(0), count);
+            return;
+        }
+        Counter counter;
+        for (size_t begin = grain; begin < count; begin += grain) {
+            size_t end = begin + grain < count ? begin + grain : count;
+            submit([&fn, begin, end] { fn(begin, end); }, &counter);
+        }
+        fn(size_t(0), grain);
+        wait(counter);
+    }
+
+    /// \brief Returns true on the thread that called start().
+    bool isMainThread() const { return std::this_thread::get_id() == main_thread_; }
+
+private:
+    struct Job {
+        JobFunction function;
+        Counter* counter = nullptr;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    JobSystem() = default;
+    ~JobSystem() { stop(); }
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    std::vector<std::thread> workers_;
+    std::vector<std::unique_ptr<WorkQueue>> local_queues_;  // One per worker
+    WorkQueue injection_queue_;
+    WorkQueue main_queue_;
+    std::thread::id main_thread_ = std::this_thread::get_id();
+
+    std::atomic<bool> running_{false};
+    std::atomic<int> queued_{0};         // Jobs sitting in any queue, for idle wake-ups
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+
+    void workerLoop(unsigned index);
+    bool tryRunOne(int workerIndex);
+    bool popBack(WorkQueue& queue, Job& out);
+    bool popFront(WorkQueue& queue, Job& out);
+    void execute(Job& job);
+};
+
+/// \brief Static dependency graph of named jobs, run once per call to run().
+///
+/// Build it once and re-run it every frame; nodes read their inputs through captured
+/// references rather than being rebuilt.
+class JobGraph {
+public:
+    using NodeId = size_t;
+
+    /// \brief Adds a node.
+    /// \param name Name for debug output.
+    /// \param job Work to run.
+    /// \param mainThreadOnly Run on the main thread (raylib input, UI, GameState writers).
+    NodeId add(const std::string& name, JobSystem::JobFunction job, bool mainThreadOnly = false);
+
+    /// \brief Makes `node` wait for `prerequisite` to finish.
+    void dependsOn(NodeId node, NodeId prerequisite);
+
+    /// \brief Runs every node respecting dependencies; returns when all have finished.
+    void run(JobSystem& jobs);
+
+    size_t size() const { return nodes_.size(); }
+
+private:
+    struct Node {
+        std::string name;
+        const char* profile_name = nullptr;  // Interned, so trace events can point at it
+        JobSystem::JobFunction job;
+        bool main_thread_only = false;
+        std::vector<NodeId> dependents;
+        int prerequisites = 0;
+        std::atomic<int> remaining{0};
+    };
+
+    std::vector<std::unique_ptr<Node>> nodes_;
+
+    void schedule(JobSystem& jobs, NodeId id, JobSystem::Counter& done);
+};
+
+#endif
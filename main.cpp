@@ -1,6 +1,77 @@
 #include "game.h"
+#include "simulation_server.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+int main(int argc, char** argv) {
+    // Headless server: Browserwind --server [--instances N] [--ticks N] [--npcs N] [--workers N] [--town N] [--seed N] [--out path]
+    // Ahead of Game, which owns the window
+    if (argc > 1 && std::strcmp(argv[1], "--server") == 0) {
+        ServerOptions options;
+        for (int i = 2; i + 1 < argc; i += 2) {
+            if (std::strcmp(argv[i], "--instances") == 0) {
+                options.instances = std::atoi(argv[i + 1]);
+            } else if (std::strcmp(argv[i], "--ticks") == 0) {
+                options.ticks = std::atoi(argv[i + 1]);
+            } else if (std::strcmp(argv[i], "--npcs") == 0) {
+                options.npcsPerInstance = std::atoi(argv[i + 1]);
+            } else if (std::strcmp(argv[i], "--workers") == 0) {
+                options.workers = static_cast<unsigned>(std::strtoul(argv[i + 1], nullptr, 10));
+            } else if (std::strcmp(argv[i], "--town") == 0) {
+                options.townScale = std::atoi(argv[i + 1]);
+            } else if (std::strcmp(argv[i], "--seed") == 0) {
+                options.townSeed = static_cast<uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+            } else if (std::strcmp(argv[i], "--out") == 0) {
+                options.outputPath = argv[i + 1];
+            } else {
+                std::cerr << "Unknown server option: " << argv[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        return runSimulationServer(options);
+    }
 
-int main(void) {
     Game game;
-    return game.Run();
-}
\ No newline at end of file
+
+    // Headless benchmark: Browserwind --bench [--frames N] [--scale N] [--town N] [--seed N] [--out path] [--replay path]
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+        BenchmarkOptions options;
+        for (int i = 2; i + 1 < argc; i += 2) {
+            if (std::strcmp(argv[i], "--frames") == 0) {
+                options.frames = std::atoi(argv[i + 1]);
+            } else if (std::strcmp(argv[i], "--scale") == 0) {
+                options.objectScale = std::atoi(argv[i + 1]);
+            } else if (std::strcmp(argv[i], "--town") == 0) {
+                options.townScale = std::atoi(argv[i + 1]);
+            } else if (std::strcmp(argv[i], "--seed") == 0) {
+                options.townSeed = static_cast<uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+            } else if (std::strcmp(argv[i], "--out") == 0) {
+                options.outputPath = argv[i + 1];
+            } else if (std::strcmp(argv[i], "--replay") == 0) {
+                options.replayPath = argv[i + 1];
+            } else {
+                std::cerr << "Unknown benchmark option: " << argv[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        return game.RunBenchmark(options);
+    }
+
+    // Input capture: Browserwind [--record path] [--replay path] [--raw-mouse device]
+    InputCaptureOptions capture;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 < argc && std::strcmp(argv[i], "--record") == 0) {
+            capture.recordPath = argv[i + 1];
+        } else if (i + 1 < argc && std::strcmp(argv[i], "--replay") == 0) {
+            capture.replayPath = argv[i + 1];
+        } else if (i + 1 < argc && std::strcmp(argv[i], "--raw-mouse") == 0) {
+            capture.rawMouseDevice = argv[i + 1];
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return game.Run(capture);
+}
@@ -1,5 +1,227 @@
 // math_utils.cpp - Implementation of math utility functions
 #include "math_utils.h"
 
-// This file is intentionally minimal since all functions are inline.
-// It's included here for consistency and potential future non-inline implementations.
+// Single-value helpers are inline in the header; the batch kernels live here.
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BROWSERWIND_MATH_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BROWSERWIND_MATH_SSE 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define BROWSERWIND_MATH_NEON 1
+#endif
+
+namespace MathUtils {
+
+void distanceSquaredBatch(const Vector3& point, const float* xs, const float* ys, const float* zs, float* out, size_t count) {
+    size_t i = 0;
+
+#if defined(BROWSERWIND_MATH_AVX2)
+    const __m256 px = _mm256_set1_ps(point.x), py = _mm256_set1_ps(point.y), pz = _mm256_set1_ps(point.z);
+    for (; i + 8 <= count; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), px);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + i), py);
+        __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(zs + i), pz);
+        __m256 d2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+        _mm256_storeu_ps(out + i, d2);
+    }
+#elif defined(BROWSERWIND_MATH_SSE)
+    const __m128 px = _mm_set1_ps(point.x), py = _mm_set1_ps(point.y), pz = _mm_set1_ps(point.z);
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), px);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i), py);
+        __m128 dz = _mm_sub_ps(_mm_loadu_ps(zs + i), pz);
+        __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        _mm_storeu_ps(out + i, d2);
+    }
+#elif defined(BROWSERWIND_MATH_NEON)
+    const float32x4_t px = vdupq_n_f32(point.x), py = vdupq_n_f32(point.y), pz = vdupq_n_f32(point.z);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t dx = vsubq_f32(vld1q_f32(xs + i), px);
+        float32x4_t dy = vsubq_f32(vld1q_f32(ys + i), py);
+        float32x4_t dz = vsubq_f32(vld1q_f32(zs + i), pz);
+        float32x4_t d2 = vaddq_f32(vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy)), vmulq_f32(dz, dz));
+        vst1q_f32(out + i, d2);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        out[i] = distanceSquared3D(point, {xs[i], ys[i], zs[i]});
+    }
+}
+
+void distanceSquaredBatchXZ(float x, float z, const float* xs, const float* zs, float* out, size_t count) {
+    size_t i = 0;
+
+#if defined(BROWSERWIND_MATH_AVX2)
+    const __m256 px = _mm256_set1_ps(x), pz = _mm256_set1_ps(z);
+    for (; i + 8 <= count; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), px);
+        __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(zs + i), pz);
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dz, dz)));
+    }
+#elif defined(BROWSERWIND_MATH_SSE)
+    const __m128 px = _mm_set1_ps(x), pz = _mm_set1_ps(z);
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), px);
+        __m128 dz = _mm_sub_ps(_mm_loadu_ps(zs + i), pz);
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dz, dz)));
+    }
+#elif defined(BROWSERWIND_MATH_NEON)
+    const float32x4_t px = vdupq_n_f32(x), pz = vdupq_n_f32(z);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t dx = vsubq_f32(vld1q_f32(xs + i), px);
+        float32x4_t dz = vsubq_f32(vld1q_f32(zs + i), pz);
+        vst1q_f32(out + i, vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dz, dz)));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        out[i] = distanceSquared2D({x, z}, {xs[i], zs[i]});
+    }
+}
+
+void distanceBatch(const Vector3& point, const float* xs, const float* ys, const float* zs, float* out, size_t count) {
+    distanceSquaredBatch(point, xs, ys, zs, out, count);
+    size_t i = 0;
+
+#if defined(BROWSERWIND_MATH_AVX2)
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_sqrt_ps(_mm256_loadu_ps(out + i)));
+    }
+#elif defined(BROWSERWIND_MATH_SSE)
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(_mm_loadu_ps(out + i)));
+    }
+#elif defined(BROWSERWIND_MATH_NEON)
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(out + i, vsqrtq_f32(vld1q_f32(out + i)));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        out[i] = sqrtf(out[i]);
+    }
+}
+
+void normalizeBatch(float* xs, float* ys, float* zs, size_t count) {
+    size_t i = 0;
+
+    // Full-precision sqrt and divide rather than the reciprocal estimates, so results match
+    // normalizeVector3D; zero-length lanes are masked back to zero
+#if defined(BROWSERWIND_MATH_AVX2)
+    const __m256 zero = _mm256_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(xs + i), y = _mm256_loadu_ps(ys + i), z = _mm256_loadu_ps(zs + i);
+        __m256 len = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z)));
+        __m256 valid = _mm256_cmp_ps(len, zero, _CMP_GT_OQ);
+        _mm256_storeu_ps(xs + i, _mm256_and_ps(_mm256_div_ps(x, len), valid));
+        _mm256_storeu_ps(ys + i, _mm256_and_ps(_mm256_div_ps(y, len), valid));
+        _mm256_storeu_ps(zs + i, _mm256_and_ps(_mm256_div_ps(z, len), valid));
+    }
+#elif defined(BROWSERWIND_MATH_SSE)
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(xs + i), y = _mm_loadu_ps(ys + i), z = _mm_loadu_ps(zs + i);
+        __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+        __m128 valid = _mm_cmpgt_ps(len, zero);
+        _mm_storeu_ps(xs + i, _mm_and_ps(_mm_div_ps(x, len), valid));
+        _mm_storeu_ps(ys + i, _mm_and_ps(_mm_div_ps(y, len), valid));
+        _mm_storeu_ps(zs + i, _mm_and_ps(_mm_div_ps(z, len), valid));
+    }
+#elif defined(BROWSERWIND_MATH_NEON)
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t x = vld1q_f32(xs + i), y = vld1q_f32(ys + i), z = vld1q_f32(zs + i);
+        float32x4_t len = vsqrtq_f32(vaddq_f32(vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y)), vmulq_f32(z, z)));
+        uint32x4_t valid = vcgtq_f32(len, zero);
+        vst1q_f32(xs + i, vbslq_f32(valid, vdivq_f32(x, len), zero));
+        vst1q_f32(ys + i, vbslq_f32(valid, vdivq_f32(y, len), zero));
+        vst1q_f32(zs + i, vbslq_f32(valid, vdivq_f32(z, len), zero));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        Vector3 n = normalizeVector3D({xs[i], ys[i], zs[i]});
+        xs[i] = n.x;
+        ys[i] = n.y;
+        zs[i] = n.z;
+    }
+}
+
+size_t overlapAABBBatch(const BoundingBox& box, const float* minX, const float* minY, const float* minZ,
+                        const float* maxX, const float* maxY, const float* maxZ, uint8_t* out, size_t count) {
+    size_t i = 0;
+    size_t hits = 0;
+
+#if defined(BROWSERWIND_MATH_AVX2)
+    const __m256 bMinX = _mm256_set1_ps(box.min.x), bMinY = _mm256_set1_ps(box.min.y), bMinZ = _mm256_set1_ps(box.min.z);
+    const __m256 bMaxX = _mm256_set1_ps(box.max.x), bMaxY = _mm256_set1_ps(box.max.y), bMaxZ = _mm256_set1_ps(box.max.z);
+    for (; i + 8 <= count; i += 8) {
+        __m256 ok = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(minX + i), bMaxX, _CMP_LE_OQ),
+                                  _mm256_cmp_ps(_mm256_loadu_ps(maxX + i), bMinX, _CMP_GE_OQ));
+        ok = _mm256_and_ps(ok, _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(minY + i), bMaxY, _CMP_LE_OQ),
+                                             _mm256_cmp_ps(_mm256_loadu_ps(maxY + i), bMinY, _CMP_GE_OQ)));
+        ok = _mm256_and_ps(ok, _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(minZ + i), bMaxZ, _CMP_LE_OQ),
+                                             _mm256_cmp_ps(_mm256_loadu_ps(maxZ + i), bMinZ, _CMP_GE_OQ)));
+        int mask = _mm256_movemask_ps(ok);
+        for (int lane = 0; lane < 8; ++lane) {
+            out[i + lane] = (mask >> lane) & 1;
+            hits += (mask >> lane) & 1;
+        }
+    }
+#elif defined(BROWSERWIND_MATH_SSE)
+    const __m128 bMinX = _mm_set1_ps(box.min.x), bMinY = _mm_set1_ps(box.min.y), bMinZ = _mm_set1_ps(box.min.z);
+    const __m128 bMaxX = _mm_set1_ps(box.max.x), bMaxY = _mm_set1_ps(box.max.y), bMaxZ = _mm_set1_ps(box.max.z);
+    for (; i + 4 <= count; i += 4) {
+        __m128 ok = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minX + i), bMaxX), _mm_cmpge_ps(_mm_loadu_ps(maxX + i), bMinX));
+        ok = _mm_and_ps(ok, _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minY + i), bMaxY), _mm_cmpge_ps(_mm_loadu_ps(maxY + i), bMinY)));
+        ok = _mm_and_ps(ok, _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minZ + i), bMaxZ), _mm_cmpge_ps(_mm_loadu_ps(maxZ + i), bMinZ)));
+        int mask = _mm_movemask_ps(ok);
+        for (int lane = 0; lane < 4; ++lane) {
+            out[i + lane] = (mask >> lane) & 1;
+            hits += (mask >> lane) & 1;
+        }
+    }
+#elif defined(BROWSERWIND_MATH_NEON)
+    const float32x4_t bMinX = vdupq_n_f32(box.min.x), bMinY = vdupq_n_f32(box.min.y), bMinZ = vdupq_n_f32(box.min.z);
+    const float32x4_t bMaxX = vdupq_n_f32(box.max.x), bMaxY = vdupq_n_f32(box.max.y), bMaxZ = vdupq_n_f32(box.max.z);
+    for (; i + 4 <= count; i += 4) {
+        uint32x4_t ok = vandq_u32(vcleq_f32(vld1q_f32(minX + i), bMaxX), vcgeq_f32(vld1q_f32(maxX + i), bMinX));
+        ok = vandq_u32(ok, vandq_u32(vcleq_f32(vld1q_f32(minY + i), bMaxY), vcgeq_f32(vld1q_f32(maxY + i), bMinY)));
+        ok = vandq_u32(ok, vandq_u32(vcleq_f32(vld1q_f32(minZ + i), bMaxZ), vcgeq_f32(vld1q_f32(maxZ + i), bMinZ)));
+        uint32_t lanes[4];
+        vst1q_u32(lanes, vshrq_n_u32(ok, 31));
+        for (int lane = 0; lane < 4; ++lane) {
+            out[i + lane] = static_cast<uint8_t>(lanes[lane]);
+            hits += lanes[lane];
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        bool overlap = minX[i] <= box.max.x && maxX[i] >= box.min.x &&
+                       minY[i] <= box.max.y && maxY[i] >= box.min.y &&
+                       minZ[i] <= box.max.z && maxZ[i] >= box.min.z;
+        out[i] = overlap ? 1 : 0;
+        hits += overlap ? 1 : 0;
+    }
+    return hits;
+}
+
+const char* batchInstructionSet() {
+#if defined(BROWSERWIND_MATH_AVX2)
+    return "AVX2";
+#elif defined(BROWSERWIND_MATH_SSE)
+    return "SSE2";
+#elif defined(BROWSERWIND_MATH_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace MathUtils
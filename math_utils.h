@@ -4,6 +4,8 @@
 
 #include "raylib.h"
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 
 /**
  * Browserwind Math Utilities
@@ -80,6 +82,55 @@ inline bool isVectorZero3D(const Vector3& v, float epsilon = 1e-6f) {
     return vectorLengthSquared3D(v) < epsilon * epsilon;
 }
 
+/**
+ * Squared distance between the closest points of two 3D segments
+ * Either segment may be degenerate (a point); used for capsule-vs-capsule sweeps
+ * @param p1 Start of the first segment
+ * @param q1 End of the first segment
+ * @param p2 Start of the second segment
+ * @param q2 End of the second segment
+ * @return Squared distance between the segments
+ */
+inline float segmentDistanceSquared3D(const Vector3& p1, const Vector3& q1, const Vector3& p2, const Vector3& q2) {
+    constexpr float EPSILON = 1e-8f;
+    Vector3 d1 = {q1.x - p1.x, q1.y - p1.y, q1.z - p1.z};
+    Vector3 d2 = {q2.x - p2.x, q2.y - p2.y, q2.z - p2.z};
+    Vector3 r = {p1.x - p2.x, p1.y - p2.y, p1.z - p2.z};
+    float a = vectorLengthSquared3D(d1);
+    float e = vectorLengthSquared3D(d2);
+    float f = d2.x * r.x + d2.y * r.y + d2.z * r.z;
+
+    float s = 0.0f;
+    float t = 0.0f;
+    if (a <= EPSILON && e <= EPSILON) {
+        return vectorLengthSquared3D(r);
+    }
+    if (a <= EPSILON) {
+        t = fminf(fmaxf(f / e, 0.0f), 1.0f);
+    } else {
+        float c = d1.x * r.x + d1.y * r.y + d1.z * r.z;
+        if (e <= EPSILON) {
+            s = fminf(fmaxf(-c / a, 0.0f), 1.0f);
+        } else {
+            float b = d1.x * d2.x + d1.y * d2.y + d1.z * d2.z;
+            float denom = a * e - b * b;
+            s = denom > EPSILON ? fminf(fmaxf((b * f - c * e) / denom, 0.0f), 1.0f) : 0.0f;
+            t = (b * s + f) / e;
+            if (t < 0.0f) {
+                t = 0.0f;
+                s = fminf(fmaxf(-c / a, 0.0f), 1.0f);
+            } else if (t > 1.0f) {
+                t = 1.0f;
+                s = fminf(fmaxf((b - c) / a, 0.0f), 1.0f);
+            }
+        }
+    }
+
+    Vector3 c1 = {p1.x + d1.x * s, p1.y + d1.y * s, p1.z + d1.z * s};
+    Vector3 c2 = {p2.x + d2.x * t, p2.y + d2.y * t, p2.z + d2.z * t};
+    return distanceSquared3D(c1, c2);
+}
+
 // ============================================================================
 // 2D VECTOR OPERATIONS
 // ============================================================================
@@ -128,6 +179,65 @@ inline Vector2 normalizeVector2D(const Vector2& v) {
     return Vector2{0.0f, 0.0f}; // Return zero vector if input was zero
 }
 
+// ============================================================================
+// BATCH OPERATIONS
+// ============================================================================
+//
+// Structure-of-arrays kernels for tight loops: one component per array, `count` entries each.
+// The widest instruction set the build targets is picked at compile time (AVX2, SSE2 or NEON,
+// 8 or 4 lanes a step); the remainder and other targets run the scalar functions above.
+// Inputs and outputs may not overlap, except normalizeBatch which works in place.
+
+/**
+ * Squared distances from one point to N packed points
+ * @param point Reference point
+ * @param xs, ys, zs Packed point components
+ * @param out Receives count squared distances
+ * @param count Number of points
+ */
+void distanceSquaredBatch(const Vector3& point, const float* xs, const float* ys, const float* zs, float* out, size_t count);
+
+/**
+ * Squared distances on the ground plane (X/Z) from one point to N packed points
+ * @param x, z Reference point
+ * @param xs, zs Packed point components
+ * @param out Receives count squared distances
+ * @param count Number of points
+ */
+void distanceSquaredBatchXZ(float x, float z, const float* xs, const float* zs, float* out, size_t count);
+
+/**
+ * Distances from one point to N packed points; prefer distanceSquaredBatch for comparisons
+ * @param point Reference point
+ * @param xs, ys, zs Packed point components
+ * @param out Receives count distances
+ * @param count Number of points
+ */
+void distanceBatch(const Vector3& point, const float* xs, const float* ys, const float* zs, float* out, size_t count);
+
+/**
+ * Normalizes N packed vectors in place; zero vectors stay zero, like normalizeVector3D
+ * @param xs, ys, zs Packed vector components
+ * @param count Number of vectors
+ */
+void normalizeBatch(float* xs, float* ys, float* zs, size_t count);
+
+/**
+ * Overlap test of one box against N packed boxes (touching counts, like CheckCollisionBoxes)
+ * @param box Query box
+ * @param minX, minY, minZ, maxX, maxY, maxZ Packed box extents
+ * @param out Receives 1 for overlapping boxes, 0 otherwise
+ * @param count Number of boxes
+ * @return Number of overlapping boxes
+ */
+size_t overlapAABBBatch(const BoundingBox& box, const float* minX, const float* minY, const float* minZ,
+                        const float* maxX, const float* maxY, const float* maxZ, uint8_t* out, size_t count);
+
+/**
+ * Name of the instruction set the batch kernels were built for ("AVX2", "SSE2", "NEON", "scalar")
+ */
+const char* batchInstructionSet();
+
 // ============================================================================
 // UTILITY FUNCTIONS
 // ============================================================================
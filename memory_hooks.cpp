@@ -0,0 +1,75 @@
+// memory_hooks.cpp - Global operator new/delete that charge every heap block to MemoryTracker.
+// Linked into the game only; the microbenchmarks replace operator new with their own counter.
+#include "memory_tracker.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+    // Prefix in front of every block, so delete knows the size and tag it was charged with.
+    // 16 bytes keeps the returned pointer at malloc's alignment.
+    struct alignas(16) BlockHeader {
+        uint64_t size;
+        MemoryTag tag;
+    };
+    static_assert(sizeof(BlockHeader) == 16, "header must preserve 16-byte alignment");
+
+    void* allocate(size_t size, size_t alignment) {
+        // Aligned blocks put the header in the alignment padding just before the user pointer
+        size_t offset = alignment > sizeof(BlockHeader) ? alignment : sizeof(BlockHeader);
+        void* base;
+        if (alignment > alignof(std::max_align_t)) {
+            size_t total = (size + offset + alignment - 1) / alignment * alignment;
+            base = std::aligned_alloc(alignment, total);
+        } else {
+            base = std::malloc(size + offset);
+        }
+        if (!base) return nullptr;
+
+        char* user = static_cast<char*>(base) + offset;
+        BlockHeader* header = reinterpret_cast<BlockHeader*>(user) - 1;
+        MemoryTag tag = MemoryTracker::currentTag();
+        header->size = size;
+        header->tag = tag;
+        MemoryTracker::recordAllocation(tag, size);
+        return user;
+    }
+
+    void release(void* ptr, size_t alignment) {
+        if (!ptr) return;
+        const BlockHeader* header = static_cast<const BlockHeader*>(ptr) - 1;
+        MemoryTracker::recordDeallocation(header->tag, header->size);
+        size_t offset = alignment > sizeof(BlockHeader) ? alignment : sizeof(BlockHeader);
+        std::free(static_cast<char*>(ptr) - offset);
+    }
+
+    void* allocateOrThrow(size_t size, size_t alignment) {
+        if (void* p = allocate(size, alignment)) return p;
+        throw std::bad_alloc();
+    }
+
+    struct HooksMarker {
+        HooksMarker() { MemoryTracker::markHooksInstalled(); }
+    } hooksMarker;
+}
+
+void* operator new(size_t size) { return allocateOrThrow(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size) { return allocateOrThrow(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return allocate(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return allocate(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, std::align_val_t al) { return allocateOrThrow(size, static_cast<size_t>(al)); }
+void* operator new[](size_t size, std::align_val_t al) { return allocateOrThrow(size, static_cast<size_t>(al)); }
+void* operator new(size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return allocate(size, static_cast<size_t>(al)); }
+void* operator new[](size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return allocate(size, static_cast<size_t>(al)); }
+
+void operator delete(void* ptr) noexcept { release(ptr, alignof(std::max_align_t)); }
+void operator delete[](void* ptr) noexcept { release(ptr, alignof(std::max_align_t)); }
+void operator delete(void* ptr, size_t) noexcept { release(ptr, alignof(std::max_align_t)); }
+void operator delete[](void* ptr, size_t) noexcept { release(ptr, alignof(std::max_align_t)); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { release(ptr, alignof(std::max_align_t)); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { release(ptr, alignof(std::max_align_t)); }
+void operator delete(void* ptr, std::align_val_t al) noexcept { release(ptr, static_cast<size_t>(al)); }
+void operator delete[](void* ptr, std::align_val_t al) noexcept { release(ptr, static_cast<size_t>(al)); }
+void operator delete(void* ptr, size_t, std::align_val_t al) noexcept { release(ptr, static_cast<size_t>(al)); }
+void operator delete[](void* ptr, size_t, std::align_val_t al) noexcept { release(ptr, static_cast<size_t>(al)); }
+void operator delete(void* ptr, std::align_val_t al, const std::nothrow_t&) noexcept { release(ptr, static_cast<size_t>(al)); }
+void operator delete[](void* ptr, std::align_val_t al, const std::nothrow_t&) noexcept { release(ptr, static_cast<size_t>(al)); }
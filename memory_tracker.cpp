@@ -0,0 +1,109 @@
+// memory_tracker.cpp
+#include "memory_tracker.h"
+#include "async_log.h"
+#include "constants.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+    // Plain namespace-scope atomics: constant-initialized, so operator new can use them
+    // before any constructor has run
+    struct alignas(64) TagCounters {
+        std::atomic<uint64_t> current{0};
+        std::atomic<uint64_t> peak{0};
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> bytes{0};
+    };
+    TagCounters g_counters[MEMORY_TAG_COUNT];
+    std::atomic<bool> g_hooks_installed{false};
+
+    const char* TAG_NAMES[MEMORY_TAG_COUNT] = {"Untagged", "Environment", "UI", "Inventory", "Audio", "Theme"};
+
+    /// \brief Upstream for TrackingResource that doesn't go through operator new.
+    class MallocResource : public std::pmr::memory_resource {
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            alignment = alignment < alignof(std::max_align_t) ? alignof(std::max_align_t) : alignment;
+            size_t rounded = (bytes + alignment - 1) / alignment * alignment;
+            void* p = std::aligned_alloc(alignment, rounded ? rounded : alignment);
+            if (!p) throw std::bad_alloc();
+            return p;
+        }
+        void do_deallocate(void* p, size_t, size_t) override { std::free(p); }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+}
+
+thread_local MemoryTag MemoryTracker::current_tag_ = MemoryTag::UNTAGGED;
+
+void MemoryTracker::recordAllocation(MemoryTag tag, size_t bytes) {
+    TagCounters& c = g_counters[static_cast<int>(tag)];
+    uint64_t now = c.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    c.allocations.fetch_add(1, std::memory_order_relaxed);
+    c.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    uint64_t peak = c.peak.load(std::memory_order_relaxed);
+    while (now > peak && !c.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+    }
+}
+
+void MemoryTracker::recordDeallocation(MemoryTag tag, size_t bytes) {
+    g_counters[static_cast<int>(tag)].current.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void MemoryTracker::sampleFrame() {
+    bool alarm = false;
+    for (int t = 0; t < MEMORY_TAG_COUNT; t++) {
+        const TagCounters& c = g_counters[t];
+        TagStats& s = stats_[t];
+        s.currentBytes = c.current.load(std::memory_order_relaxed);
+        s.peakBytes = c.peak.load(std::memory_order_relaxed);
+        s.totalAllocations = c.allocations.load(std::memory_order_relaxed);
+        uint64_t bytes = c.bytes.load(std::memory_order_relaxed);
+        s.frameAllocations = static_cast<uint32_t>(s.totalAllocations - last_allocations_[t]);
+        s.frameBytes = bytes - last_bytes_[t];
+        last_allocations_[t] = s.totalAllocations;
+        last_bytes_[t] = bytes;
+
+        // Untagged covers everything nobody has claimed yet; only tagged hot paths raise alarms
+        if (t != static_cast<int>(MemoryTag::UNTAGGED) &&
+            s.frameAllocations > static_cast<uint32_t>(MemoryConstants::FRAME_ALLOC_ALARM)) {
+            s.alarmFrames++;
+            alarm = true;
+            BW_LOG(DEBUG_MEMORY, DEBUG_BASIC, "MEMORY: {} made {} allocations ({} bytes) in one frame",
+                   TAG_NAMES[t], s.frameAllocations, s.frameBytes);
+        }
+    }
+    alarm_active_ = alarm;
+}
+
+const char* MemoryTracker::getTagName(MemoryTag tag) {
+    int t = static_cast<int>(tag);
+    return t >= 0 && t < MEMORY_TAG_COUNT ? TAG_NAMES[t] : "?";
+}
+
+bool MemoryTracker::hooksInstalled() {
+    return g_hooks_installed.load(std::memory_order_relaxed);
+}
+
+void MemoryTracker::markHooksInstalled() {
+    g_hooks_installed.store(true, std::memory_order_relaxed);
+}
+
+std::pmr::memory_resource* MemoryTracker::getResource(MemoryTag tag) {
+    static MallocResource upstream;
+    static TrackingResource resources[MEMORY_TAG_COUNT] = {
+        {MemoryTag::UNTAGGED, &upstream}, {MemoryTag::ENVIRONMENT, &upstream}, {MemoryTag::UI, &upstream},
+        {MemoryTag::INVENTORY, &upstream}, {MemoryTag::AUDIO, &upstream}, {MemoryTag::THEME, &upstream}
+    };
+    return &resources[static_cast<int>(tag)];
+}
+
+void* TrackingResource::do_allocate(size_t bytes, size_t alignment) {
+    void* p = upstream_->allocate(bytes, alignment);
+    MemoryTracker::recordAllocation(tag_, bytes);
+    return p;
+}
+
+void TrackingResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    MemoryTracker::recordDeallocation(tag_, bytes);
+    upstream_->deallocate(p, bytes, alignment);
+}
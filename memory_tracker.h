@@ -0,0 +1,109 @@
+// memory_tracker.h - Per-subsystem allocation accounting: tag scopes, pmr adapters and frame snapshots
+#ifndef MEMORY_TRACKER_H
+#define MEMORY_TRACKER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+/// \brief Subsystem an allocation is charged to.
+enum class MemoryTag : uint8_t { UNTAGGED, ENVIRONMENT, UI, INVENTORY, AUDIO, THEME, COUNT };
+
+constexpr int MEMORY_TAG_COUNT = static_cast<int>(MemoryTag::COUNT);
+
+/// \brief Byte and allocation counts per MemoryTag.
+///
+/// Allocations are charged to the calling thread's current tag (set with MemoryTagScope).
+/// Two sources feed the counters: the global operator new/delete in memory_hooks.cpp, linked
+/// into the game only, and the TrackingResource adapters getResource() hands out for pmr
+/// containers. Counters are relaxed atomics, safe to bump from any thread.
+///
+/// sampleFrame(), called once a frame, turns the running totals into per-frame allocation
+/// counts and bytes, and raises an alarm for tags that allocated more than
+/// MemoryConstants::FRAME_ALLOC_ALARM times in one frame, the sign of a hot path allocating.
+class MemoryTracker {
+public:
+    /// \brief One tag's numbers as of the last sampleFrame().
+    struct TagStats {
+        uint64_t currentBytes = 0;
+        uint64_t peakBytes = 0;
+        uint64_t totalAllocations = 0;
+        uint32_t frameAllocations = 0;     // Allocations during the last sampled frame
+        uint64_t frameBytes = 0;           // Bytes allocated during the last sampled frame
+        uint32_t alarmFrames = 0;          // Frames that tripped the allocation alarm
+    };
+
+    static MemoryTracker& getInstance() {
+        static MemoryTracker instance;
+        return instance;
+    }
+
+    /// \brief Tag new allocations on this thread are charged to.
+    static MemoryTag currentTag() { return current_tag_; }
+
+    static void recordAllocation(MemoryTag tag, size_t bytes);
+    static void recordDeallocation(MemoryTag tag, size_t bytes);
+
+    /// \brief Closes the frame: per-frame counts, peaks and alarms. Main thread, once a frame.
+    void sampleFrame();
+
+    const TagStats& getStats(MemoryTag tag) const { return stats_[static_cast<int>(tag)]; }
+    static const char* getTagName(MemoryTag tag);
+
+    /// \brief Whether the last sampled frame tripped the allocation alarm for any tag.
+    bool isAlarmActive() const { return alarm_active_; }
+
+    /// \brief Whether the global operator new hooks are linked in (the game, not the microbenchmarks).
+    static bool hooksInstalled();
+    static void markHooksInstalled();
+
+    /// \brief pmr resource charging to a tag, backed by malloc so the global hooks don't count
+    /// its blocks a second time. Lives for the whole program.
+    std::pmr::memory_resource* getResource(MemoryTag tag);
+
+private:
+    friend class MemoryTagScope;
+
+    MemoryTracker() = default;
+    MemoryTracker(const MemoryTracker&) = delete;
+    MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+    static thread_local MemoryTag current_tag_;
+
+    TagStats stats_[MEMORY_TAG_COUNT];
+    uint64_t last_allocations_[MEMORY_TAG_COUNT] = {};
+    uint64_t last_bytes_[MEMORY_TAG_COUNT] = {};
+    bool alarm_active_ = false;
+};
+
+/// \brief Charges allocations on this thread to a tag until the scope ends. Nests.
+class MemoryTagScope {
+public:
+    explicit MemoryTagScope(MemoryTag tag) : previous_(MemoryTracker::current_tag_) {
+        MemoryTracker::current_tag_ = tag;
+    }
+    ~MemoryTagScope() { MemoryTracker::current_tag_ = previous_; }
+
+    MemoryTagScope(const MemoryTagScope&) = delete;
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+private:
+    MemoryTag previous_;
+};
+
+/// \brief pmr adapter that counts what it hands out against one tag.
+class TrackingResource : public std::pmr::memory_resource {
+public:
+    TrackingResource(MemoryTag tag, std::pmr::memory_resource* upstream) : tag_(tag), upstream_(upstream) {}
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    MemoryTag tag_;
+    std::pmr::memory_resource* upstream_;
+};
+
+#endif // MEMORY_TRACKER_H
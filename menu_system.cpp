@@ -1,22 +1,23 @@
 #include "menu_system.h"
+#include <algorithm>
 #include <iostream>
 
 MenuSystem::MenuSystem(GameState& state) : state_(state) {}
 
 void MenuSystem::handleEscMenuInput() {
-    if (state_.showEscMenu && !state_.enhancedInput.isMouseCaptured()) {
+    if (state_.ui.showEscMenu && !state_.enhancedInput.isMouseCaptured()) {
         handleEscMenuClick();
     }
 }
 
 void MenuSystem::handleInventoryInput(InventorySystem& inventorySystem) {
-    if (state_.showInventoryWindow && !state_.enhancedInput.isMouseCaptured()) {
+    if (state_.ui.showInventoryWindow && !state_.enhancedInput.isMouseCaptured()) {
         handleInventoryClick(inventorySystem);
     }
 }
 
 void MenuSystem::handleEscMenuClick() {
-    Vector2 mousePos = GetMousePosition();
+    Vector2 mousePos = state_.enhancedInput.getMousePosition();  // Recorded/replayed with the rest of input
     int screenWidth = GetScreenWidth();
     int screenHeight = GetScreenHeight();
     int menuWidth = 400;
@@ -32,14 +33,14 @@ void MenuSystem::handleEscMenuClick() {
             if (mousePos.x >= menuX + 20 && mousePos.x <= menuX + menuWidth - 20 &&
                 mousePos.y >= buttonY && mousePos.y <= buttonY + 40) {
 
-                state_.selectedMenuOption = i;
+                state_.ui.selectedMenuOption = i;
                 std::cout << "ESC Menu clicked: Option " << i << std::endl;
 
                 switch (i) {
                     case 0: // Resume Game
-                        state_.showEscMenu = false;
+                        state_.ui.showEscMenu = false;
                         state_.enhancedInput.setMouseCaptured(true);
-                        state_.mouseReleased = false;
+                        state_.ui.mouseReleased = false;
                         std::cout << "Resuming game..." << std::endl;
                         break;
 
@@ -70,7 +71,7 @@ void MenuSystem::handleEscMenuClick() {
 }
 
 void MenuSystem::handleInventoryClick(InventorySystem& inventorySystem) {
-    Vector2 mousePos = GetMousePosition();
+    Vector2 mousePos = state_.enhancedInput.getMousePosition();  // Recorded/replayed with the rest of input
     int screenWidth = GetScreenWidth();
     int screenHeight = GetScreenHeight();
     int invWidth = 500;
@@ -78,16 +79,24 @@ void MenuSystem::handleInventoryClick(InventorySystem& inventorySystem) {
     int invX = (screenWidth - invWidth) / 2;
     int invY = (screenHeight - invHeight) / 2;
 
-    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+    // Rows show the same sorted, filtered view UISystemManager draws, starting at the scroll row
+    const AdventurerInventory& inventory = inventorySystem.getInventory();
+    const std::vector<uint32_t>& view = inventory.getView(
+        state_.ui.inventorySearchActive ? state_.ui.inventorySearchQuery : std::string());
+    constexpr int VISIBLE_ROWS = 12;
+    int maxScrollRow = std::max(0, (int)view.size() - VISIBLE_ROWS);
+    state_.ui.inventoryScrollRow = std::clamp(state_.ui.inventoryScrollRow - (int)GetMouseWheelMove(), 0, maxScrollRow);
+
+    if (state_.enhancedInput.isMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
         int itemListY = invY + 85;
         int itemHeight = 18;
 
         int itemIndex = (mousePos.y - itemListY) / itemHeight;
-        if (itemIndex >= 0 && itemIndex < 12 && mousePos.x >= invX + 20 && mousePos.x <= invX + 470) {
-            auto items = inventorySystem.getInventory().getAllItems();
-            if (itemIndex < (int)items.size()) {
-                auto clickedItem = items[itemIndex];
-                state_.lastClickedItem = clickedItem->getName();
+        if (itemIndex >= 0 && itemIndex < VISIBLE_ROWS && mousePos.x >= invX + 20 && mousePos.x <= invX + 470) {
+            size_t viewIndex = (size_t)(state_.ui.inventoryScrollRow + itemIndex);
+            if (viewIndex < view.size()) {
+                auto clickedItem = inventory.getAllItems()[view[viewIndex]];
+                state_.ui.lastClickedItem = clickedItem->getName();
 
                 std::cout << "Inventory Click: " << clickedItem->getName() << " ["
                          << ItemUtils::rarityToString(clickedItem->getRarity()) << "]" << std::endl;
@@ -103,14 +112,17 @@ void MenuSystem::handleInventoryClick(InventorySystem& inventorySystem) {
                     inventorySystem.getInventory().removeItem(clickedItem, 1);
 
                     auto potion = std::dynamic_pointer_cast<AlchemicalPotion>(clickedItem);
-                    if (potion) {
+                    if (potion && inventorySystem.startTimedEffect(*potion)) {
+                        std::cout << "Used " << clickedItem->getName() << " - Effect active for " << potion->getDuration() << " seconds" << std::endl;
+                    } else if (potion) {
                         auto effects = potion->getEffects();
-                        state_.playerHealth = std::min(state_.maxPlayerHealth, state_.playerHealth + effects.health);
-                        state_.playerMana = std::min(state_.maxPlayerMana, state_.playerMana + effects.mana);
-                        state_.playerStamina = std::min(state_.maxPlayerStamina, state_.playerStamina + effects.stamina);
+                        state_.player.health = std::min(state_.player.maxHealth, state_.player.health + effects.health);
+                        state_.player.mana = std::min(state_.player.maxMana, state_.player.mana + effects.mana);
+                        state_.player.stamina = std::min(state_.player.maxStamina, state_.player.stamina + effects.stamina);
                         std::cout << "Used " << clickedItem->getName() << " - Applied effects: HP+" << effects.health << " MP+" << effects.mana << " SP+" << effects.stamina << std::endl;
                     }
                 }
+                state_.notifyChange(StateChange::INVENTORY_ITEM);
             }
         }
     }
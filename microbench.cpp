@@ -0,0 +1,475 @@
+// microbench.cpp - Microbenchmarks for hot engine paths
+//
+// Usage: microbench [--filter substring] [--save baseline.txt] [--baseline baseline.txt] [--threshold pct]
+//
+// Reports median ns/op over several samples and heap allocations per op. With --baseline,
+// each result is compared against the stored one and the run fails if any benchmark got
+// slower than the threshold (default 15%) or allocates more than before.
+#include "collision_system.h"
+#include "environment_manager.h"
+#include "environmental_object.h"
+#include "inventory.h"
+#include "math_utils.h"
+#include "ui_theme_optimized.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// ALLOCATION COUNTING
+// ============================================================================
+
+namespace {
+    std::atomic<uint64_t> g_allocations{0};
+}
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+// ============================================================================
+// HARNESS
+// ============================================================================
+
+constexpr int SAMPLES = 7;
+constexpr double MIN_SAMPLE_SECONDS = 0.02;
+
+template<typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct Result {
+    std::string name;
+    double ns_per_op = 0.0;
+    double allocs_per_op = 0.0;
+};
+
+struct Options {
+    std::string filter;
+    std::string save_path;
+    std::string baseline_path;
+    double threshold_pct = 15.0;
+};
+
+std::vector<Result> g_results;
+Options g_options;
+
+/// Times `body`, which performs `opsPerCall` operations per call. Iteration count grows until
+/// a sample takes MIN_SAMPLE_SECONDS; the median of SAMPLES samples is reported.
+void bench(const std::string& name, size_t opsPerCall, const std::function<void()>& body) {
+    if (!g_options.filter.empty() && name.find(g_options.filter) == std::string::npos) return;
+    using Clock = std::chrono::steady_clock;
+
+    body();  // Warm caches and any lazy state
+    size_t iterations = 1;
+    while (true) {
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) body();
+        if (std::chrono::duration<double>(Clock::now() - start).count() >= MIN_SAMPLE_SECONDS || iterations >= (1u << 30)) break;
+        iterations *= 2;
+    }
+
+    std::vector<double> samples;
+    uint64_t allocations = 0;
+    for (int s = 0; s < SAMPLES; ++s) {
+        uint64_t allocsBefore = g_allocations.load(std::memory_order_relaxed);
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) body();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        allocations += g_allocations.load(std::memory_order_relaxed) - allocsBefore;
+        samples.push_back(ns / static_cast<double>(iterations * opsPerCall));
+    }
+    std::sort(samples.begin(), samples.end());
+
+    Result result;
+    result.name = name;
+    result.ns_per_op = samples[SAMPLES / 2];
+    result.allocs_per_op = static_cast<double>(allocations) / static_cast<double>(SAMPLES * iterations * opsPerCall);
+    std::printf("%-52s %12.2f ns/op %10.3f allocs/op\n", name.c_str(), result.ns_per_op, result.allocs_per_op);
+    g_results.push_back(result);
+}
+
+/// Silences std::cout during setup; object construction logs every add.
+class QuietCout {
+public:
+    QuietCout() : previous_(std::cout.rdbuf(nullptr)) {}
+    ~QuietCout() { std::cout.rdbuf(previous_); }
+private:
+    std::streambuf* previous_;
+};
+
+uint32_t g_seed = 12345u;
+float randomFloat(float lo, float hi) {
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return lo + (hi - lo) * ((g_seed >> 8) / 16777216.0f);
+}
+
+// ============================================================================
+// BENCHMARKS
+// ============================================================================
+
+const char* shapeName(CollisionShape shape) {
+    switch (shape) {
+        case CollisionShape::BOX: return "box";
+        case CollisionShape::SPHERE: return "sphere";
+        case CollisionShape::CYLINDER: return "cylinder";
+        case CollisionShape::CAPSULE: return "capsule";
+    }
+    return "?";
+}
+
+void benchCollision() {
+    const CollisionShape shapes[] = {CollisionShape::BOX, CollisionShape::SPHERE, CollisionShape::CYLINDER, CollisionShape::CAPSULE};
+    constexpr size_t PAIRS = 256;
+
+    for (CollisionShape a : shapes) {
+        for (CollisionShape b : shapes) {
+            // Mix of overlapping and separated pairs so both early-outs and full tests run
+            std::vector<CollisionBounds> lhs(PAIRS), rhs(PAIRS);
+            for (size_t i = 0; i < PAIRS; ++i) {
+                lhs[i] = {a, {randomFloat(-4, 4), randomFloat(0, 2), randomFloat(-4, 4)}, {1.0f, 2.0f, 1.0f}, 0.0f};
+                rhs[i] = {b, {randomFloat(-4, 4), randomFloat(0, 2), randomFloat(-4, 4)}, {1.5f, 1.5f, 1.5f}, 0.0f};
+            }
+            std::string name = std::string("CollisionSystem::checkCollision ") + shapeName(a) + "/" + shapeName(b);
+            bench(name, PAIRS, [&] {
+                int hits = 0;
+                for (size_t i = 0; i < PAIRS; ++i) {
+                    hits += CollisionSystem::checkCollision(lhs[i], rhs[i]) ? 1 : 0;
+                }
+                doNotOptimize(hits);
+            });
+        }
+    }
+}
+
+void benchSpatialGrid() {
+    for (size_t count : {size_t(10), size_t(1000), size_t(100000)}) {
+        EnvironmentManager environment;
+        {
+            QuietCout quiet;
+            float extent = std::sqrt(static_cast<float>(count)) * 4.0f;
+            TreeConfig tree;
+            for (size_t i = 0; i < count; ++i) {
+                environment.addObject(EnvironmentalObjectFactory::createTree(tree, {randomFloat(-extent, extent), 0.0f, randomFloat(-extent, extent)}));
+            }
+        }
+        std::string suffix = " @" + std::to_string(count);
+
+        // rebuild re-inserts every object, so per-op cost is one insert
+        bench("SpatialGrid::insert (rebuild)" + suffix, count, [&] {
+            QuietCout quiet;
+            environment.rebuildSpatialGrid();
+        });
+
+        constexpr size_t QUERIES = 64;
+        std::vector<BoundingBox> areas(QUERIES);
+        float extent = std::sqrt(static_cast<float>(count)) * 4.0f;
+        for (size_t i = 0; i < QUERIES; ++i) {
+            Vector3 c = {randomFloat(-extent, extent), 1.0f, randomFloat(-extent, extent)};
+            areas[i] = {{c.x - 4.0f, c.y - 2.0f, c.z - 4.0f}, {c.x + 4.0f, c.y + 2.0f, c.z + 4.0f}};
+        }
+        std::vector<uint32_t> scratch;
+        bench("SpatialGrid::query 8x4x8" + suffix, QUERIES, [&] {
+            size_t found = 0;
+            for (const BoundingBox& area : areas) {
+                environment.queryCandidates(area, scratch);
+                found += scratch.size();
+            }
+            doNotOptimize(found);
+        });
+    }
+}
+
+void fillInventory(AdventurerInventory& inventory, size_t count) {
+    const ItemType types[] = {ItemType::WEAPON, ItemType::ARMOR, ItemType::CONSUMABLE, ItemType::TREASURE, ItemType::MISC};
+    for (size_t i = 0; i < count; ++i) {
+        auto item = std::make_shared<MysticalItem>("Item " + std::to_string(i * 7919 % count), types[i % 5],
+                                                   randomFloat(0.1f, 10.0f), static_cast<int>(randomFloat(1, 1000)));
+        item->setRarity(static_cast<ItemRarity>(i % 5));
+        inventory.addItem(item);
+    }
+}
+
+void benchInventory() {
+    for (size_t count : {size_t(100), size_t(10000)}) {
+        AdventurerInventory inventory(1.0e9f, static_cast<int>(count));
+        {
+            QuietCout quiet;
+            fillInventory(inventory, count);
+        }
+        std::string suffix = " @" + std::to_string(inventory.getUsedSlots());
+
+        bench("AdventurerInventory::searchItems" + suffix, 1, [&] {
+            doNotOptimize(inventory.searchItems("item 42"));
+        });
+        // Alternating queries so each lookup rescans instead of hitting the cached result
+        bench("AdventurerInventory::getView search" + suffix, 2, [&] {
+            doNotOptimize(inventory.getView("item 4").size());
+            doNotOptimize(inventory.getView("item 5").size());
+        });
+        bench("AdventurerInventory::getView typed" + suffix, 3, [&] {
+            doNotOptimize(inventory.getView("i").size());
+            doNotOptimize(inventory.getView("it").size());
+            doNotOptimize(inventory.getView("ite").size());
+        });
+        bench("AdventurerInventory::getView cached" + suffix, 1, [&] {
+            doNotOptimize(inventory.getView("ite").size());
+        });
+        // Sorts alternate keys so each call rebuilds the permutation
+        bench("AdventurerInventory::sortByName+sortByValue" + suffix, 2, [&] {
+            inventory.sortByName();
+            doNotOptimize(inventory.getView().data());
+            inventory.sortByValue();
+            doNotOptimize(inventory.getView().data());
+        });
+        bench("AdventurerInventory::sortByWeight+sortByRarity" + suffix, 2, [&] {
+            inventory.sortByWeight();
+            doNotOptimize(inventory.getView().data());
+            inventory.sortByRarity();
+            doNotOptimize(inventory.getView().data());
+        });
+        bench("AdventurerInventory::sortByType+sortByName" + suffix, 2, [&] {
+            inventory.sortByType();
+            doNotOptimize(inventory.getView().data());
+            inventory.sortByName();
+            doNotOptimize(inventory.getView().data());
+        });
+        bench("AdventurerInventory::getCurrentWeight" + suffix, 1, [&] {
+            doNotOptimize(inventory.getCurrentWeight());
+        });
+    }
+}
+
+void benchTheme() {
+    using namespace UITypes;
+    ThemeManager& theme = ThemeManager::getInstance();
+    constexpr size_t ROLES = static_cast<size_t>(ColorRole::COLOR_ROLE_COUNT);
+
+    bench("ThemeManager::getColor", ROLES, [&] {
+        for (size_t r = 0; r < ROLES; ++r) {
+            doNotOptimize(theme.getColor(static_cast<ColorRole>(r)));
+        }
+    });
+    bench("ThemeManager::getColor alpha", ROLES, [&] {
+        for (size_t r = 0; r < ROLES; ++r) {
+            doNotOptimize(theme.getColor(static_cast<ColorRole>(r), 0.5f));
+        }
+    });
+    // switchTheme resolves the whole palette up front; lookups after it cost the same
+    bench("ThemeManager::switchTheme+getColor", ROLES, [&] {
+        theme.switchTheme(theme.getCurrentVariant());
+        for (size_t r = 0; r < ROLES; ++r) {
+            doNotOptimize(theme.getColor(static_cast<ColorRole>(r), 0.5f));
+        }
+    });
+}
+
+void benchMath() {
+    constexpr size_t N = 1024;
+    std::vector<Vector3> a(N), b(N);
+    std::vector<Vector2> a2(N), b2(N);
+    for (size_t i = 0; i < N; ++i) {
+        a[i] = {randomFloat(-100, 100), randomFloat(-100, 100), randomFloat(-100, 100)};
+        b[i] = {randomFloat(-100, 100), randomFloat(-100, 100), randomFloat(-100, 100)};
+        a2[i] = {a[i].x, a[i].z};
+        b2[i] = {b[i].x, b[i].z};
+    }
+
+    bench("MathUtils::distance3D", N, [&] {
+        float sum = 0.0f;
+        for (size_t i = 0; i < N; ++i) sum += MathUtils::distance3D(a[i], b[i]);
+        doNotOptimize(sum);
+    });
+    bench("MathUtils::distanceSquared3D", N, [&] {
+        float sum = 0.0f;
+        for (size_t i = 0; i < N; ++i) sum += MathUtils::distanceSquared3D(a[i], b[i]);
+        doNotOptimize(sum);
+    });
+    bench("MathUtils::normalizeVector3D", N, [&] {
+        float sum = 0.0f;
+        for (size_t i = 0; i < N; ++i) sum += MathUtils::normalizeVector3D(a[i]).x;
+        doNotOptimize(sum);
+    });
+    bench("MathUtils::distance2D", N, [&] {
+        float sum = 0.0f;
+        for (size_t i = 0; i < N; ++i) sum += MathUtils::distance2D(a2[i], b2[i]);
+        doNotOptimize(sum);
+    });
+    bench("MathUtils::normalizeVector2D", N, [&] {
+        float sum = 0.0f;
+        for (size_t i = 0; i < N; ++i) sum += MathUtils::normalizeVector2D(a2[i]).x;
+        doNotOptimize(sum);
+    });
+    bench("MathUtils::lerp", N, [&] {
+        float sum = 0.0f;
+        for (size_t i = 0; i < N; ++i) sum += MathUtils::lerp(a[i].x, b[i].x, 0.25f);
+        doNotOptimize(sum);
+    });
+
+    // Batch kernels over the same points, packed
+    std::vector<float> xs(N), ys(N), zs(N), out(N);
+    std::vector<float> maxX(N), maxY(N), maxZ(N);
+    std::vector<uint8_t> overlaps(N);
+    for (size_t i = 0; i < N; ++i) {
+        xs[i] = a[i].x;
+        ys[i] = a[i].y;
+        zs[i] = a[i].z;
+        maxX[i] = xs[i] + randomFloat(0, 20);
+        maxY[i] = ys[i] + randomFloat(0, 20);
+        maxZ[i] = zs[i] + randomFloat(0, 20);
+    }
+    const Vector3 origin = b[0];
+    const std::string isa = std::string(" [") + MathUtils::batchInstructionSet() + "]";
+    bench("MathUtils::distanceSquared3D (one to many)", N, [&] {
+        for (size_t i = 0; i < N; ++i) out[i] = MathUtils::distanceSquared3D(origin, a[i]);
+        doNotOptimize(out[N - 1]);
+    });
+    bench("MathUtils::distanceSquaredBatch" + isa, N, [&] {
+        MathUtils::distanceSquaredBatch(origin, xs.data(), ys.data(), zs.data(), out.data(), N);
+        doNotOptimize(out[N - 1]);
+    });
+    bench("MathUtils::distanceBatch" + isa, N, [&] {
+        MathUtils::distanceBatch(origin, xs.data(), ys.data(), zs.data(), out.data(), N);
+        doNotOptimize(out[N - 1]);
+    });
+    std::vector<float> nx(N), ny(N), nz(N);
+    bench("MathUtils::normalizeBatch" + isa, N, [&] {
+        nx = xs;
+        ny = ys;
+        nz = zs;
+        MathUtils::normalizeBatch(nx.data(), ny.data(), nz.data(), N);
+        doNotOptimize(nx[N - 1]);
+    });
+    BoundingBox query = {{-20.0f, -20.0f, -20.0f}, {20.0f, 20.0f, 20.0f}};
+    bench("MathUtils::overlapAABBBatch" + isa, N, [&] {
+        size_t hits = MathUtils::overlapAABBBatch(query, xs.data(), ys.data(), zs.data(),
+                                                  maxX.data(), maxY.data(), maxZ.data(), overlaps.data(), N);
+        doNotOptimize(hits);
+    });
+}
+
+// ============================================================================
+// BASELINES
+// ============================================================================
+
+bool saveBaseline(const std::string& path) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) return false;
+    out << "# name<TAB>ns_per_op<TAB>allocs_per_op\n";
+    for (const Result& r : g_results) {
+        out << r.name << '\t' << r.ns_per_op << '\t' << r.allocs_per_op << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+/// Returns the number of regressions against the baseline file, or -1 if it can't be read.
+int compareBaseline(const std::string& path, double thresholdPct) {
+    std::ifstream in(path);
+    if (!in) return -1;
+
+    std::map<std::string, Result> baseline;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        Result r;
+        std::string ns, allocs;
+        if (std::getline(fields, r.name, '\t') && std::getline(fields, ns, '\t') && std::getline(fields, allocs)) {
+            r.ns_per_op = std::atof(ns.c_str());
+            r.allocs_per_op = std::atof(allocs.c_str());
+            baseline[r.name] = r;
+        }
+    }
+
+    int regressions = 0;
+    std::printf("\n%-52s %12s %12s %9s\n", "benchmark", "baseline", "current", "delta");
+    for (const Result& r : g_results) {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end()) {
+            std::printf("%-52s %12s %12.2f %9s\n", r.name.c_str(), "-", r.ns_per_op, "new");
+            continue;
+        }
+        const Result& b = it->second;
+        double delta = b.ns_per_op > 0.0 ? (r.ns_per_op - b.ns_per_op) / b.ns_per_op * 100.0 : 0.0;
+        bool slower = delta > thresholdPct;
+        bool moreAllocs = r.allocs_per_op > b.allocs_per_op + 1e-3;
+        if (slower || moreAllocs) ++regressions;
+        std::printf("%-52s %12.2f %12.2f %+8.1f%%%s%s\n", r.name.c_str(), b.ns_per_op, r.ns_per_op, delta,
+                    slower ? "  SLOWER" : "", moreAllocs ? "  MORE ALLOCS" : "");
+    }
+    return regressions;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--filter") == 0) g_options.filter = argv[i + 1];
+        else if (std::strcmp(argv[i], "--save") == 0) g_options.save_path = argv[i + 1];
+        else if (std::strcmp(argv[i], "--baseline") == 0) g_options.baseline_path = argv[i + 1];
+        else if (std::strcmp(argv[i], "--threshold") == 0) g_options.threshold_pct = std::atof(argv[i + 1]);
+        else {
+            std::fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    benchCollision();
+    benchSpatialGrid();
+    benchInventory();
+    benchTheme();
+    benchMath();
+
+    if (!g_options.save_path.empty()) {
+        if (!saveBaseline(g_options.save_path)) {
+            std::fprintf(stderr, "Cannot write baseline %s\n", g_options.save_path.c_str());
+            return EXIT_FAILURE;
+        }
+        std::printf("Baseline saved to %s\n", g_options.save_path.c_str());
+    }
+
+    if (!g_options.baseline_path.empty()) {
+        int regressions = compareBaseline(g_options.baseline_path, g_options.threshold_pct);
+        if (regressions < 0) {
+            std::printf("No baseline at %s; run with --save first\n", g_options.baseline_path.c_str());
+        } else if (regressions > 0) {
+            std::printf("%d regression(s) beyond %.1f%%\n", regressions, g_options.threshold_pct);
+            return EXIT_FAILURE;
+        } else {
+            std::printf("No regressions beyond %.1f%%\n", g_options.threshold_pct);
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,456 @@
+// navigation.cpp
+#include "navigation.h"
+#include "collision_system.h"
+#include "constants.h"
+#include "environment_manager.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+    constexpr float DIAGONAL_COST = 1.41421356f;
+
+    /// Per-thread A* state sized to the grid; stamps avoid clearing it between searches
+    struct SearchScratch {
+        std::vector<uint32_t> visit;    // Search id that last touched the cell
+        std::vector<float> cost;
+        std::vector<int32_t> parent;
+        std::vector<std::pair<float, int32_t>> open;
+        std::vector<int32_t> cells;
+        uint32_t search = 0;
+    };
+
+    thread_local SearchScratch t_scratch;
+
+    float octile(int dx, int dz) {
+        dx = std::abs(dx);
+        dz = std::abs(dz);
+        return (dx > dz) ? (dx - dz) + dz * DIAGONAL_COST : (dz - dx) + dx * DIAGONAL_COST;
+    }
+
+    /// Nearest free cell within SNAP_CELLS rings, or false
+    bool snapToFree(const NavGrid& grid, int& cx, int& cz) {
+        if (!grid.isBlocked(cx, cz)) return true;
+        for (int ring = 1; ring <= NavConstants::SNAP_CELLS; ring++) {
+            for (int dz = -ring; dz <= ring; dz++) {
+                for (int dx = -ring; dx <= ring; dx++) {
+                    if (std::max(std::abs(dx), std::abs(dz)) != ring) continue;
+                    if (!grid.isBlocked(cx + dx, cz + dz)) {
+                        cx += dx;
+                        cz += dz;
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    void addCluster(std::vector<NavGrid::ClusterStamp>& clusters, const NavGrid& grid, uint32_t cluster) {
+        for (const NavGrid::ClusterStamp& existing : clusters) {
+            if (existing.cluster == cluster) return;
+        }
+        clusters.push_back({cluster, grid.clusterVersions[cluster]});
+    }
+}
+
+// ===== NavGrid =====
+
+int NavGrid::toCellX(float x) const {
+    return static_cast<int>(std::floor((x - originX) / NavConstants::CELL_SIZE));
+}
+
+int NavGrid::toCellZ(float z) const {
+    return static_cast<int>(std::floor((z - originZ) / NavConstants::CELL_SIZE));
+}
+
+Vector3 NavGrid::cellCentre(int cx, int cz) const {
+    return {originX + (cx + 0.5f) * NavConstants::CELL_SIZE, 0.0f, originZ + (cz + 0.5f) * NavConstants::CELL_SIZE};
+}
+
+uint32_t NavGrid::clusterOf(int cx, int cz) const {
+    return static_cast<uint32_t>((cz / NavConstants::CLUSTER_CELLS) * clustersX + cx / NavConstants::CLUSTER_CELLS);
+}
+
+bool NavGrid::hasLineOfSight(Vector3 from, Vector3 to) const {
+    // Quarter-cell steps catch every cell the segment clips except exact corner grazes
+    float dx = to.x - from.x, dz = to.z - from.z;
+    float length = std::sqrt(dx * dx + dz * dz);
+    int steps = std::max(1, static_cast<int>(std::ceil(length / (NavConstants::CELL_SIZE * 0.25f))));
+    for (int i = 0; i <= steps; i++) {
+        float t = static_cast<float>(i) / steps;
+        if (isBlocked(toCellX(from.x + dx * t), toCellZ(from.z + dz * t))) return false;
+    }
+    return true;
+}
+
+bool NavGrid::isCurrent(const std::vector<ClusterStamp>& clusters) const {
+    for (const ClusterStamp& stamp : clusters) {
+        if (clusterVersions[stamp.cluster] != stamp.version) return false;
+    }
+    return true;
+}
+
+// ===== Baking =====
+
+std::shared_ptr<NavGrid> PathService::makeGrid() {
+    auto grid = std::make_shared<NavGrid>();
+    int cells = static_cast<int>(std::ceil(NavConstants::HALF_EXTENT * 2.0f / NavConstants::CELL_SIZE));
+    cells = (cells + NavConstants::CLUSTER_CELLS - 1) / NavConstants::CLUSTER_CELLS * NavConstants::CLUSTER_CELLS;
+    grid->width = cells;
+    grid->depth = cells;
+    grid->originX = -NavConstants::HALF_EXTENT;
+    grid->originZ = -NavConstants::HALF_EXTENT;
+    grid->clustersX = cells / NavConstants::CLUSTER_CELLS;
+    grid->clustersZ = cells / NavConstants::CLUSTER_CELLS;
+    grid->blockers.assign(static_cast<size_t>(cells) * cells, 0);
+    grid->clusterVersions.assign(static_cast<size_t>(grid->clustersX) * grid->clustersZ, 0);
+    return grid;
+}
+
+PathService::Obstacle PathService::rasterize(const NavGrid& grid, const CollisionBounds& bounds) {
+    Obstacle obstacle = {nullptr, 0, 0, -1, -1};
+    BoundingBox box = CollisionSystem::enclosingBox(bounds);
+    if (box.min.y > NavConstants::AGENT_HEIGHT || box.max.y < 0.0f) return obstacle;  // Overhead or underground
+
+    // Blocks every cell whose centre an agent couldn't stand on
+    int minX = std::max(0, grid.toCellX(box.min.x - NavConstants::AGENT_RADIUS));
+    int minZ = std::max(0, grid.toCellZ(box.min.z - NavConstants::AGENT_RADIUS));
+    int maxX = std::min(grid.width - 1, grid.toCellX(box.max.x + NavConstants::AGENT_RADIUS));
+    int maxZ = std::min(grid.depth - 1, grid.toCellZ(box.max.z + NavConstants::AGENT_RADIUS));
+    if (minX > maxX || minZ > maxZ) return obstacle;
+    obstacle.minX = minX;
+    obstacle.minZ = minZ;
+    obstacle.maxX = maxX;
+    obstacle.maxZ = maxZ;
+    return obstacle;
+}
+
+void PathService::stamp(NavGrid& grid, const Obstacle& obstacle, int delta, std::vector<uint8_t>& changedClusters) {
+    for (int cz = obstacle.minZ; cz <= obstacle.maxZ; cz++) {
+        uint16_t* row = &grid.blockers[static_cast<size_t>(cz) * grid.width];
+        for (int cx = obstacle.minX; cx <= obstacle.maxX; cx++) {
+            row[cx] = static_cast<uint16_t>(row[cx] + delta);
+        }
+    }
+    if (obstacle.minX > obstacle.maxX) return;
+    for (int kz = obstacle.minZ / NavConstants::CLUSTER_CELLS; kz <= obstacle.maxZ / NavConstants::CLUSTER_CELLS; kz++) {
+        for (int kx = obstacle.minX / NavConstants::CLUSTER_CELLS; kx <= obstacle.maxX / NavConstants::CLUSTER_CELLS; kx++) {
+            changedClusters[kz * grid.clustersX + kx] = 1;
+        }
+    }
+}
+
+void PathService::sync(const EnvironmentManager& environment) {
+    if (grid_ && environment.getRevision() == environment_revision_) return;
+    PROFILE_SCOPE("PathService::sync");
+    environment_revision_ = environment.getRevision();
+
+    // Find what appeared and disappeared before paying for a copy of the grid
+    const auto& objects = environment.getAllObjects();
+    present_scratch_.clear();
+    added_scratch_.clear();
+    for (size_t i = 0; i < objects.size(); ++i) {
+        const EnvironmentalObject* object = objects[i].get();
+        if (!object->collidable) continue;
+        present_scratch_.insert(object);
+        if (!baked_.count(object)) added_scratch_.push_back(static_cast<uint32_t>(i));
+    }
+    size_t removed = baked_.size() + added_scratch_.size() - present_scratch_.size();
+    if (grid_ && added_scratch_.empty() && removed == 0) return;  // Only non-colliders changed
+
+    // Edits go to a copy; searches in flight keep reading the grid they started on
+    std::shared_ptr<NavGrid> grid = grid_ ? std::make_shared<NavGrid>(*grid_) : makeGrid();
+    std::vector<uint8_t> changed(grid->clusterVersions.size(), 0);
+
+    const ColliderCache& colliders = environment.getColliderCache();
+    for (uint32_t index : added_scratch_) {
+        Obstacle obstacle = rasterize(*grid, colliders.getBounds(index));
+        obstacle.object = objects[index];
+        stamp(*grid, obstacle, 1, changed);
+        baked_.emplace(objects[index].get(), std::move(obstacle));
+    }
+
+    for (auto it = baked_.begin(); it != baked_.end() && removed > 0;) {
+        if (present_scratch_.count(it->first)) {
+            ++it;
+            continue;
+        }
+        stamp(*grid, it->second, -1, changed);
+        it = baked_.erase(it);
+    }
+
+    size_t changedCount = 0;
+    for (size_t c = 0; c < changed.size(); ++c) {
+        if (!changed[c]) continue;
+        ++grid->clusterVersions[c];
+        ++changedCount;
+    }
+    grid_ = grid;
+    if (changedCount == 0) return;
+
+    // Delivered paths over the changed clusters are re-planned by their owners
+    for (auto it = live_.begin(); it != live_.end();) {
+        if (grid_->isCurrent(it->second.clusters)) {
+            ++it;
+            continue;
+        }
+        stale_.push_back({it->second.id, it->first, PathStatus::STALE, {}});
+        it = live_.erase(it);
+    }
+
+    std::cout << "NAV: Baked +" << added_scratch_.size() << " -" << removed << " obstacles (" << baked_.size()
+              << " total), " << changedCount << " clusters changed" << std::endl;
+}
+
+bool PathService::isBlocked(Vector3 position) const {
+    return grid_ && grid_->isBlocked(grid_->toCellX(position.x), grid_->toCellZ(position.z));
+}
+
+// ===== Requests =====
+
+PathService::RequestId PathService::requestPath(int owner, Vector3 start, Vector3 goal) {
+    RequestId id = next_id_++;
+    if (owner >= 0) live_.erase(owner);  // Superseded
+
+    if (!grid_) {
+        std::lock_guard<std::mutex> lock(completed_mutex_);
+        completed_.push_back({{id, owner, PathStatus::NOT_FOUND, {}}, start, goal, {}});
+        return id;
+    }
+    if (answerFromCache(id, owner, start, goal)) {
+        ++cache_hits_;
+        return id;
+    }
+    ++cache_misses_;
+    submitSearch(id, owner, start, goal);
+    return id;
+}
+
+void PathService::submitSearch(RequestId id, int owner, Vector3 start, Vector3 goal) {
+    std::shared_ptr<const NavGrid> grid = grid_;
+    JobSystem::getInstance().submit([this, grid, id, owner, start, goal] {
+        PROFILE_SCOPE("PathService::findPath");
+        Completed completed = {{id, owner, PathStatus::NOT_FOUND, {}}, start, goal, {}};
+        completed.result.status = findPath(*grid, start, goal, completed.result.waypoints, completed.clusters);
+        std::lock_guard<std::mutex> lock(completed_mutex_);
+        completed_.push_back(std::move(completed));
+    }, &in_flight_);
+}
+
+bool PathService::answerFromCache(RequestId id, int owner, Vector3 start, Vector3 goal) {
+    auto it = cache_.find(cacheKey(*grid_, start, goal));
+    if (it == cache_.end()) return false;
+    const CacheEntry& entry = it->second;
+    if (!grid_->isCurrent(entry.clusters)) {
+        cache_.erase(it);  // Its slot in cache_order_ is skipped when it comes up
+        return false;
+    }
+
+    // Endpoints differ by up to a cache quantum; reuse the interior only if both ends connect
+    size_t count = entry.waypoints.size();
+    Vector3 ground = {start.x, 0.0f, start.z};
+    Vector3 target = {goal.x, 0.0f, goal.z};
+    const Vector3& first = count > 2 ? entry.waypoints[1] : target;
+    const Vector3& last = count > 2 ? entry.waypoints[count - 2] : ground;
+    if (!grid_->hasLineOfSight(ground, first) || !grid_->hasLineOfSight(last, target)) return false;
+
+    Completed completed = {{id, owner, PathStatus::FOUND, entry.waypoints}, start, goal, entry.clusters};
+    completed.result.waypoints.front() = ground;
+    completed.result.waypoints.back() = target;
+    std::lock_guard<std::mutex> lock(completed_mutex_);
+    completed_.push_back(std::move(completed));
+    return true;
+}
+
+void PathService::collectCompleted(std::vector<PathResult>& out) {
+    out.clear();
+    // Searches requested last step have had the rest of the frame to run; finish the stragglers
+    // so every request is answered exactly one step later however the workers were scheduled
+    JobSystem::getInstance().wait(in_flight_);
+    {
+        std::lock_guard<std::mutex> lock(completed_mutex_);
+        drain_scratch_.swap(completed_);
+    }
+    // Completion order is thread timing; request order isn't
+    std::sort(drain_scratch_.begin(), drain_scratch_.end(),
+              [](const Completed& a, const Completed& b) { return a.result.id < b.result.id; });
+
+    for (Completed& completed : drain_scratch_) {
+        PathResult& result = completed.result;
+        // Planned against a grid that has since changed under it: search again
+        if (result.status == PathStatus::FOUND && !grid_->isCurrent(completed.clusters)) {
+            ++replans_;
+            submitSearch(result.id, result.owner, completed.start, completed.goal);
+            continue;
+        }
+        if (result.status == PathStatus::FOUND) {
+            remember(completed);
+            if (result.owner >= 0) {
+                live_[result.owner] = {result.id, completed.clusters};
+            }
+        }
+        out.push_back(std::move(result));
+    }
+    drain_scratch_.clear();
+
+    for (PathResult& stale : stale_) {
+        out.push_back(std::move(stale));
+    }
+    stale_.clear();
+}
+
+void PathService::releasePath(int owner) {
+    live_.erase(owner);
+}
+
+void PathService::remember(const Completed& completed) {
+    uint64_t key = cacheKey(*grid_, completed.start, completed.goal);
+    auto inserted = cache_.insert({key, CacheEntry{}});
+    inserted.first->second = {completed.result.waypoints, completed.clusters};
+    if (!inserted.second) return;
+
+    cache_order_.push_back(key);
+    while (cache_.size() > static_cast<size_t>(NavConstants::CACHE_CAPACITY) && !cache_order_.empty()) {
+        cache_.erase(cache_order_.front());
+        cache_order_.pop_front();
+    }
+    // Keys whose entries were dropped early linger here; trim them once they pile up
+    if (cache_order_.size() > static_cast<size_t>(NavConstants::CACHE_CAPACITY) * 2) {
+        std::deque<uint64_t> live;
+        for (uint64_t k : cache_order_) {
+            if (cache_.count(k)) live.push_back(k);
+        }
+        cache_order_.swap(live);
+    }
+}
+
+uint64_t PathService::cacheKey(const NavGrid& grid, Vector3 start, Vector3 goal) {
+    auto quantize = [](int cell) { return static_cast<uint64_t>(static_cast<uint16_t>(cell / NavConstants::CACHE_QUANTUM_CELLS)); };
+    return quantize(grid.toCellX(start.x)) | quantize(grid.toCellZ(start.z)) << 16 |
+           quantize(grid.toCellX(goal.x)) << 32 | quantize(grid.toCellZ(goal.z)) << 48;
+}
+
+void PathService::reset() {
+    JobSystem::getInstance().wait(in_flight_);
+    grid_.reset();
+    environment_revision_ = 0;
+    baked_.clear();
+    cache_.clear();
+    cache_order_.clear();
+    live_.clear();
+    stale_.clear();
+    std::lock_guard<std::mutex> lock(completed_mutex_);
+    completed_.clear();
+}
+
+// ===== Search =====
+
+PathStatus PathService::findPath(const NavGrid& grid, Vector3 start, Vector3 goal,
+                                 std::vector<Vector3>& waypoints, std::vector<NavGrid::ClusterStamp>& clusters) {
+    int sx = grid.toCellX(start.x), sz = grid.toCellZ(start.z);
+    int gx = grid.toCellX(goal.x), gz = grid.toCellZ(goal.z);
+    bool goalSnapped = grid.isBlocked(gx, gz);
+    if (!snapToFree(grid, sx, sz) || !snapToFree(grid, gx, gz)) return PathStatus::NOT_FOUND;
+
+    SearchScratch& s = t_scratch;
+    const size_t cellCount = grid.blockers.size();
+    if (s.visit.size() != cellCount) {
+        s.visit.assign(cellCount, 0);
+        s.cost.resize(cellCount);
+        s.parent.resize(cellCount);
+        s.search = 0;
+    }
+    if (++s.search == 0) {  // Wrapped: stale stamps could alias the new id
+        std::fill(s.visit.begin(), s.visit.end(), 0);
+        s.search = 1;
+    }
+
+    auto greater = [](const std::pair<float, int32_t>& a, const std::pair<float, int32_t>& b) { return a.first > b.first; };
+    const int32_t startIndex = sz * grid.width + sx;
+    const int32_t goalIndex = gz * grid.width + gx;
+    s.open.clear();
+    s.visit[startIndex] = s.search;
+    s.cost[startIndex] = 0.0f;
+    s.parent[startIndex] = -1;
+    s.open.push_back({octile(gx - sx, gz - sz), startIndex});
+
+    static const int DX[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+    static const int DZ[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+    int expansions = 0;
+    bool found = false;
+    while (!s.open.empty()) {
+        std::pop_heap(s.open.begin(), s.open.end(), greater);
+        auto [priority, index] = s.open.back();
+        s.open.pop_back();
+        int cx = index % grid.width, cz = index / grid.width;
+        // Lazy deletion: skip entries superseded by a cheaper route
+        if (priority > s.cost[index] + octile(gx - cx, gz - cz) + 1e-4f) continue;
+        if (index == goalIndex) {
+            found = true;
+            break;
+        }
+        if (++expansions > NavConstants::MAX_EXPANSIONS) break;
+
+        for (int d = 0; d < 8; d++) {
+            int nx = cx + DX[d], nz = cz + DZ[d];
+            if (grid.isBlocked(nx, nz)) continue;
+            // No cutting corners past an obstacle
+            if (d >= 4 && (grid.isBlocked(cx + DX[d], cz) || grid.isBlocked(cx, cz + DZ[d]))) continue;
+            int32_t next = nz * grid.width + nx;
+            float cost = s.cost[index] + (d >= 4 ? DIAGONAL_COST : 1.0f);
+            if (s.visit[next] == s.search && s.cost[next] <= cost) continue;
+            s.visit[next] = s.search;
+            s.cost[next] = cost;
+            s.parent[next] = index;
+            s.open.push_back({cost + octile(gx - nx, gz - nz), next});
+            std::push_heap(s.open.begin(), s.open.end(), greater);
+        }
+    }
+    if (!found) return PathStatus::NOT_FOUND;
+
+    s.cells.clear();
+    for (int32_t index = goalIndex; index != -1; index = s.parent[index]) {
+        s.cells.push_back(index);
+    }
+    std::reverse(s.cells.begin(), s.cells.end());
+
+    // String-pull: keep only the cells where a straight walk would leave free space
+    waypoints.clear();
+    waypoints.push_back({start.x, 0.0f, start.z});
+    if (grid.isBlocked(grid.toCellX(start.x), grid.toCellZ(start.z))) {
+        waypoints.back() = grid.cellCentre(sx, sz);  // Snapped: walk out to the free cell first
+    }
+    Vector3 goalPoint = goalSnapped ? grid.cellCentre(gx, gz) : Vector3{goal.x, 0.0f, goal.z};
+    size_t anchor = 0;
+    while (anchor + 1 < s.cells.size()) {
+        size_t furthest = anchor + 1;
+        for (size_t j = s.cells.size() - 1; j > anchor + 1; j--) {
+            Vector3 candidate = (j == s.cells.size() - 1) ? goalPoint : grid.cellCentre(s.cells[j] % grid.width, s.cells[j] / grid.width);
+            if (grid.hasLineOfSight(waypoints.back(), candidate)) {
+                furthest = j;
+                break;
+            }
+        }
+        anchor = furthest;
+        waypoints.push_back(anchor == s.cells.size() - 1 ? goalPoint
+                                                          : grid.cellCentre(s.cells[anchor] % grid.width, s.cells[anchor] / grid.width));
+    }
+    if (waypoints.size() == 1) waypoints.push_back(goalPoint);  // Start and goal share a cell
+
+    // Clusters under the walked segments, for staleness checks
+    clusters.clear();
+    for (size_t i = 0; i + 1 < waypoints.size(); i++) {
+        Vector3 a = waypoints[i], b = waypoints[i + 1];
+        float dx = b.x - a.x, dz = b.z - a.z;
+        int steps = std::max(1, static_cast<int>(std::ceil(std::sqrt(dx * dx + dz * dz) / NavConstants::CELL_SIZE)));
+        for (int k = 0; k <= steps; k++) {
+            float t = static_cast<float>(k) / steps;
+            int cx = std::clamp(grid.toCellX(a.x + dx * t), 0, grid.width - 1);
+            int cz = std::clamp(grid.toCellZ(a.z + dz * t), 0, grid.depth - 1);
+            addCluster(clusters, grid, grid.clusterOf(cx, cz));
+        }
+    }
+    return PathStatus::FOUND;
+}
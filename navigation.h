@@ -0,0 +1,182 @@
+// navigation.h - Walkability grid baked from environment colliders, and async A* paths over it
+#ifndef NAVIGATION_H
+#define NAVIGATION_H
+
+#include "raylib.h"
+#include "job_system.h"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class EnvironmentManager;
+class EnvironmentalObject;
+struct CollisionBounds;
+
+/// \brief One published walkability snapshot. Never edited once PathService hands it out,
+/// so searches read it from any thread.
+///
+/// Cells count the obstacles (inflated by the agent radius) overlapping them; zero is
+/// walkable. Cells are grouped into CLUSTER_CELLS-square clusters whose versions bump
+/// whenever an obstacle covering them is added or removed.
+struct NavGrid {
+    /// \brief Cluster a path crosses, and its version when the path was planned.
+    struct ClusterStamp {
+        uint32_t cluster;
+        uint32_t version;
+    };
+
+    int width = 0;
+    int depth = 0;
+    float originX = 0.0f;       // World position of cell (0, 0)'s minimum corner
+    float originZ = 0.0f;
+    int clustersX = 0;
+    int clustersZ = 0;
+    std::vector<uint16_t> blockers;
+    std::vector<uint32_t> clusterVersions;
+
+    bool inBounds(int cx, int cz) const { return cx >= 0 && cz >= 0 && cx < width && cz < depth; }
+    bool isBlocked(int cx, int cz) const { return !inBounds(cx, cz) || blockers[cz * width + cx] != 0; }
+    int toCellX(float x) const;
+    int toCellZ(float z) const;
+    Vector3 cellCentre(int cx, int cz) const;
+    uint32_t clusterOf(int cx, int cz) const;
+
+    /// \brief Whether a straight walk between two points stays on free cells.
+    bool hasLineOfSight(Vector3 from, Vector3 to) const;
+    /// \brief Whether no cluster a path crosses has changed since it was planned.
+    bool isCurrent(const std::vector<ClusterStamp>& clusters) const;
+};
+
+enum class PathStatus : uint8_t {
+    FOUND,          // waypoints run from the start to the goal
+    NOT_FOUND,      // Goal unreachable, or too far for the expansion limit
+    STALE           // A delivered path now crosses a changed obstacle; request again from where you are
+};
+
+struct PathResult {
+    uint32_t id;
+    int owner;
+    PathStatus status;
+    std::vector<Vector3> waypoints;   // On the ground (y = 0); first is the start, last the goal
+};
+
+/// \brief Pathfinding for walking agents.
+///
+/// sync() keeps a NavGrid in step with the environment's collidable objects: when the
+/// environment's revision changes, only obstacles that appeared or disappeared are
+/// stamped into (or out of) a copy of the grid, which is then published. Paths already
+/// handed out that cross a changed cluster come back as STALE on the next
+/// collectCompleted(), so owners re-plan from where they are; paths still being searched
+/// against the old grid are re-run before delivery.
+///
+/// requestPath() answers from the route cache when a current route with nearby endpoints
+/// exists, and otherwise runs A* on a job against the snapshot current at the call. Results
+/// of either kind are delivered through the next collectCompleted(), which waits for searches
+/// still running and hands results out in request order, so replays see the same paths on
+/// the same steps.
+///
+/// sync(), requestPath(), collectCompleted() and releasePath() must be called from one
+/// thread at a time (the NPC update); only the searches run elsewhere. Collidable objects
+/// are assumed not to move; props that can move aren't re-baked until added again.
+class PathService {
+public:
+    using RequestId = uint32_t;
+
+    static PathService& getInstance() {
+        static PathService instance;
+        return instance;
+    }
+
+    /// \brief Re-bakes obstacles if the environment has changed since the last call.
+    void sync(const EnvironmentManager& environment);
+
+    /// \brief Queues a path search; the result arrives through collectCompleted().
+    /// \param owner Caller's id for the agent (NPC id), tracked for re-planning; -1 for none.
+    /// \return Id carried by the result. A newer request by the same owner supersedes it.
+    RequestId requestPath(int owner, Vector3 start, Vector3 goal);
+
+    /// \brief Waits for outstanding searches and moves their results into out (cleared first), by request id.
+    void collectCompleted(std::vector<PathResult>& out);
+
+    /// \brief Stops tracking the owner's delivered path, e.g. when it has arrived.
+    void releasePath(int owner);
+
+    /// \brief Whether the cell under a world position is blocked. False before the first sync.
+    bool isBlocked(Vector3 position) const;
+
+    /// \brief Drops the grid, caches and tracked paths. Waits for searches in flight.
+    void reset();
+
+    const NavGrid* getGrid() const { return grid_.get(); }
+    size_t getObstacleCount() const { return baked_.size(); }
+    uint64_t getCacheHits() const { return cache_hits_; }
+    uint64_t getCacheMisses() const { return cache_misses_; }
+    uint64_t getReplanCount() const { return replans_; }
+    int getInFlightCount() const { return in_flight_.pending.load(std::memory_order_relaxed); }
+
+private:
+    PathService() = default;
+    PathService(const PathService&) = delete;
+    PathService& operator=(const PathService&) = delete;
+
+    struct Obstacle {
+        std::shared_ptr<const EnvironmentalObject> object;  // Held so the address can't be reused while baked
+        int minX, minZ, maxX, maxZ;                         // Inclusive cell range; empty if off the grid
+    };
+
+    struct Completed {
+        PathResult result;
+        Vector3 start;
+        Vector3 goal;
+        std::vector<NavGrid::ClusterStamp> clusters;
+    };
+
+    struct CacheEntry {
+        std::vector<Vector3> waypoints;
+        std::vector<NavGrid::ClusterStamp> clusters;
+    };
+
+    struct LivePath {
+        RequestId id;
+        std::vector<NavGrid::ClusterStamp> clusters;
+    };
+
+    static std::shared_ptr<NavGrid> makeGrid();
+    static Obstacle rasterize(const NavGrid& grid, const CollisionBounds& bounds);
+    static void stamp(NavGrid& grid, const Obstacle& obstacle, int delta, std::vector<uint8_t>& changedClusters);
+    /// \brief A* plus string-pulling. \return FOUND or NOT_FOUND; fills waypoints and clusters when found.
+    static PathStatus findPath(const NavGrid& grid, Vector3 start, Vector3 goal,
+                               std::vector<Vector3>& waypoints, std::vector<NavGrid::ClusterStamp>& clusters);
+    static uint64_t cacheKey(const NavGrid& grid, Vector3 start, Vector3 goal);
+
+    void submitSearch(RequestId id, int owner, Vector3 start, Vector3 goal);
+    bool answerFromCache(RequestId id, int owner, Vector3 start, Vector3 goal);
+    void remember(const Completed& completed);
+
+    std::shared_ptr<const NavGrid> grid_;
+    uint32_t environment_revision_ = 0;
+    std::unordered_map<const EnvironmentalObject*, Obstacle> baked_;
+    std::unordered_set<const EnvironmentalObject*> present_scratch_;
+    std::vector<uint32_t> added_scratch_;
+
+    std::unordered_map<uint64_t, CacheEntry> cache_;
+    std::deque<uint64_t> cache_order_;      // Insertion order, for eviction
+    std::unordered_map<int, LivePath> live_;
+    std::vector<PathResult> stale_;         // Produced by sync, delivered by collectCompleted
+
+    std::mutex completed_mutex_;
+    std::vector<Completed> completed_;      // Written by searches
+    std::vector<Completed> drain_scratch_;
+    JobSystem::Counter in_flight_;
+
+    RequestId next_id_ = 1;
+    uint64_t cache_hits_ = 0;
+    uint64_t cache_misses_ = 0;
+    uint64_t replans_ = 0;
+};
+
+#endif // NAVIGATION_H
@@ -1,80 +1,399 @@
 // npc.cpp
 #include "npc.h"
+#include "constants.h"
+#include "collision_system.h"
+#include "environment_manager.h"
+#include "environmental_object.h"
+#include "profiler.h"
 #include "math_utils.h"
 #include "raylib.h"
+#include <algorithm>
 #include <cmath>
+#include <iostream>
 
-// MAX_NPCS is now defined in npc.h
-NPC npcs[MAX_NPCS];
+namespace {
+    const char* const TOWNSFOLK_NAMES[] = {"Ada", "Bram", "Cora", "Dell", "Edda", "Finn", "Greta", "Hob",
+                                           "Iris", "Jory", "Kit", "Lena", "Moss", "Nell", "Otto", "Pip"};
+    const char* const TOWNSFOLK_TRADES[] = {"the Baker", "the Smith", "the Miller", "the Weaver", "the Cooper",
+                                            "the Tanner", "the Carter", "the Chandler", "the Farmer", "the Potter"};
+    const char* const TOWNSFOLK_LINES[] = {
+        "Fine day for a walk around the square, isn't it?",
+        "If you're looking for supplies, Buster's store is just north of the well.",
+        "The Mayor's office is west of here. Always busy, that one.",
+        "Mind the trees when you swing that sword around.",
+        "I've lived in this town all my life. Never a dull moment."
+    };
+    const Color TOWNSFOLK_COLORS[] = {BEIGE, BROWN, DARKGREEN, MAROON, DARKBLUE, PURPLE, ORANGE, GRAY};
+
+    template<typename T, size_t N>
+    constexpr size_t countOf(const T (&)[N]) { return N; }
+
+    uint32_t xorshift(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    float unitRandom(uint32_t& state) {
+        return (xorshift(state) >> 8) * (1.0f / 16777216.0f);
+    }
+
+    CollisionBounds npcCapsule(Vector3 base) {
+        CollisionBounds bounds;
+        bounds.shape = CollisionShape::CAPSULE;
+        bounds.position = {base.x, base.y + NPCConstants::HEIGHT / 2, base.z};  // Centre of capsule
+        bounds.size = {NPCConstants::COLLISION_RADIUS, NPCConstants::HEIGHT, 0.0f};
+        bounds.rotation = 0.0f;
+        return bounds;
+    }
+}
+
+int NPCSystem::spawn(const NPC& npc) {
+    int id = getCount();
+    x_.push_back(npc.position.x);
+    y_.push_back(npc.position.y);
+    z_.push_back(npc.position.z);
+    radius_.push_back(NPCConstants::COLLISION_RADIUS);
+    interaction_radius_.push_back(npc.interactionRadius);
+    target_x_.push_back(npc.position.x);
+    target_z_.push_back(npc.position.z);
+    home_x_.push_back(npc.position.x);
+    home_z_.push_back(npc.position.z);
+    pending_time_.push_back(0.0f);
+    think_at_.push_back(0.0f);
+    home_building_.push_back(npc.homeBuilding);
+    rng_.push_back(static_cast<uint32_t>(id + 1) * 2654435761u | 1u);
+    state_.push_back(NPCState::IDLE);
+    detail_.push_back(NPCDetail::FAR);
+    wanders_.push_back(npc.wanders ? 1 : 0);
+    path_request_.push_back(0);
+    path_cursor_.push_back(0);
+    paths_.emplace_back();
+
+    names_.push_back(npc.name);
+    dialogs_.push_back(npc.dialog);
+    colors_.push_back(npc.color);
+    can_interact_.push_back(npc.canInteract ? 1 : 0);
+    anchors_.emplace_back();
+
+    // Stagger first walks so a freshly spawned crowd doesn't set off in step
+    think_at_[id] = time_ + nextRandom(id) * NPCConstants::MAX_IDLE_TIME;
+
+    if (environment_) {
+        registerAnchor(id);
+    }
+    return id;
+}
+
+void NPCSystem::spawnTownsfolk(const EnvironmentManager& environment, int count) {
+    constexpr int MAX_ATTEMPTS = 8;
+    constexpr float TWO_PI = 6.2831853f;
+    const float spacing = NPCConstants::COLLISION_RADIUS * 2.0f + 0.2f;
+    const float innerSq = NPCConstants::TOWN_INNER_RADIUS * NPCConstants::TOWN_INNER_RADIUS;
+    const float outerSq = NPCConstants::TOWN_OUTER_RADIUS * NPCConstants::TOWN_OUTER_RADIUS;
+
+    uint32_t rng = 0x70776E73u;  // Fixed seed: the same town every run
+    int spawned = 0;
+    for (int k = 0; k < count; k++) {
+        for (int attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+            // Uniform over the ring's area
+            float angle = unitRandom(rng) * TWO_PI;
+            float distance = sqrtf(innerSq + unitRandom(rng) * (outerSq - innerSq));
+            Vector3 position = {cosf(angle) * distance, 0.0f, sinf(angle) * distance};
+
+            if (environment.checkCollision(npcCapsule(position))) continue;
+            bool crowded = false;
+            for (int n = 0; n < getCount() && !crowded; n++) {
+                float dx = x_[n] - position.x, dz = z_[n] - position.z;
+                crowded = home_building_[n] < 0 && dx * dx + dz * dz < spacing * spacing;
+            }
+            if (crowded) continue;
+
+            NPC npc;
+            npc.position = position;
+            npc.name = std::string(TOWNSFOLK_NAMES[k % countOf(TOWNSFOLK_NAMES)]) + " " +
+                       TOWNSFOLK_TRADES[(k / countOf(TOWNSFOLK_NAMES)) % countOf(TOWNSFOLK_TRADES)];
+            npc.dialog = TOWNSFOLK_LINES[k % countOf(TOWNSFOLK_LINES)];
+            npc.color = TOWNSFOLK_COLORS[k % countOf(TOWNSFOLK_COLORS)];
+            npc.canInteract = true;
+            npc.interactionRadius = 2.0f;
+            npc.homeBuilding = -1;
+            npc.wanders = true;
+            spawn(npc);
+            ++spawned;
+            break;
+        }
+    }
+    std::cout << "NPC: Spawned " << spawned << " of " << count << " townsfolk" << std::endl;
+}
+
+void NPCSystem::clear() {
+    x_.clear(); y_.clear(); z_.clear();
+    radius_.clear();
+    interaction_radius_.clear();
+    target_x_.clear(); target_z_.clear();
+    home_x_.clear(); home_z_.clear();
+    pending_time_.clear();
+    think_at_.clear();
+    home_building_.clear();
+    rng_.clear();
+    state_.clear();
+    detail_.clear();
+    wanders_.clear();
+    path_request_.clear();
+    path_cursor_.clear();
+    paths_.clear();
+    names_.clear();
+    dialogs_.clear();
+    colors_.clear();
+    can_interact_.clear();
+    anchors_.clear();
+    environment_ = nullptr;
+    think_cursor_ = 0;
+}
+
+void NPCSystem::attach(EnvironmentManager& environment) {
+    environment_ = &environment;
+    for (int id = 0; id < getCount(); id++) {
+        if (!anchors_[id]) {
+            registerAnchor(id);
+        }
+    }
+}
+
+void NPCSystem::registerAnchor(int id) {
+    // Talk range is 1.5x the indicator radius
+    anchors_[id] = std::make_shared<NpcAnchor>(getPosition(id), id, home_building_[id],
+                                               interaction_radius_[id] * 1.5f, names_[id]);
+    environment_->addObject(anchors_[id]);
+}
+
+void NPCSystem::update(float deltaTime, Vector3 viewer, const EnvironmentManager& environment, int engagedNpc) {
+    PROFILE_SCOPE("NPCSystem::update");
+    ++frame_;
+    time_ += deltaTime;
+    const int count = getCount();
+
+    applyPathResults();
+
+    // Someone in conversation stands still until it ends
+    if (isValid(engagedNpc) && state_[engagedNpc] != NPCState::IDLE) {
+        rest(engagedNpc);
+    }
+    if (isValid(engagedNpc)) {
+        think_at_[engagedNpc] = time_ + NPCConstants::MIN_IDLE_TIME;
+    }
+
+    // Tier by distance; the tier sets movement rate, render detail and thinking priority
+    const float nearSq = NPCConstants::NEAR_DISTANCE * NPCConstants::NEAR_DISTANCE;
+    const float midSq = NPCConstants::MID_DISTANCE * NPCConstants::MID_DISTANCE;
+    near_scratch_.clear();
+    dist_sq_scratch_.resize(count);
+    MathUtils::distanceSquaredBatchXZ(viewer.x, viewer.z, x_.data(), z_.data(), dist_sq_scratch_.data(), count);
+    int due = 0;
+    for (int i = 0; i < count; i++) {
+        float distSq = dist_sq_scratch_[i];
+        detail_[i] = distSq < nearSq ? NPCDetail::NEAR : (distSq < midSq ? NPCDetail::MID : NPCDetail::FAR);
+        if (detail_[i] == NPCDetail::NEAR) near_scratch_.push_back(i);
+        if (wanders_[i] && state_[i] == NPCState::IDLE && time_ >= think_at_[i]) ++due;
+    }
+
+    // Movement: reduced-rate tiers step on staggered frames with the time they skipped
+    {
+        PROFILE_SCOPE("NPC movement");
+        for (int i = 0; i < count; i++) {
+            if (state_[i] != NPCState::WALKING) continue;
+            pending_time_[i] += deltaTime;
+            uint32_t interval = detail_[i] == NPCDetail::NEAR ? 1u
+                              : detail_[i] == NPCDetail::MID ? static_cast<uint32_t>(NPCConstants::MID_UPDATE_INTERVAL) * update_interval_scale_
+                                                             : static_cast<uint32_t>(NPCConstants::FAR_UPDATE_INTERVAL) * update_interval_scale_;
+            if ((frame_ + static_cast<uint32_t>(i)) % interval != 0) continue;
+            step(i, std::min(pending_time_[i], NPCConstants::MAX_STEP_TIME), viewer, environment);
+            pending_time_[i] = 0.0f;
+        }
+    }
+
+    // Thinking: nearby NPCs that are due always get a turn, the rest share the budget
+    PROFILE_SCOPE("NPC thinking");
+    auto isDue = [this](int i) {
+        return wanders_[i] && state_[i] == NPCState::IDLE && time_ >= think_at_[i];
+    };
+    int thoughts = 0;
+    for (int i : near_scratch_) {
+        if (!isDue(i)) continue;
+        think(i);
+        ++thoughts;
+    }
+
+    int budgeted = 0;
+    for (int visited = 0; visited < count && budgeted < NPCConstants::THINK_BUDGET; visited++) {
+        int i = static_cast<int>(think_cursor_);
+        think_cursor_ = (think_cursor_ + 1) % static_cast<size_t>(count);
+        if (detail_[i] == NPCDetail::NEAR || !isDue(i)) continue;
+        think(i);
+        ++thoughts;
+        ++budgeted;
+    }
+
+    last_think_count_ = thoughts;
+    think_backlog_ = due - thoughts;
+}
+
+void NPCSystem::think(int id) {
+    constexpr float TWO_PI = 6.2831853f;
+    float angle = nextRandom(id) * TWO_PI;
+    float distance = nextRandom(id) * NPCConstants::WANDER_RADIUS;
+    target_x_[id] = home_x_[id] + cosf(angle) * distance;
+    target_z_[id] = home_z_[id] + sinf(angle) * distance;
+    requestWalk(id);
+}
+
+void NPCSystem::requestWalk(int id) {
+    state_[id] = NPCState::PLANNING;
+    path_request_[id] = PathService::getInstance().requestPath(id, getPosition(id), {target_x_[id], 0.0f, target_z_[id]});
+}
+
+void NPCSystem::applyPathResults() {
+    PathService& paths = PathService::getInstance();
+    paths.collectCompleted(path_results_);
+    for (PathResult& result : path_results_) {
+        int id = result.owner;
+        // Superseded requests, and results for NPCs from before a clear(), are dropped
+        if (!isValid(id) || path_request_[id] != result.id) continue;
+
+        switch (result.status) {
+            case PathStatus::FOUND:
+                paths_[id] = std::move(result.waypoints);
+                path_cursor_[id] = 1;  // [0] is where the NPC stood
+                state_[id] = NPCState::WALKING;
+                pending_time_[id] = 0.0f;
+                break;
+            case PathStatus::NOT_FOUND:
+                rest(id);
+                break;
+            case PathStatus::STALE:
+                // Something was built or streamed across the route: re-plan from here
+                if (state_[id] == NPCState::WALKING) requestWalk(id);
+                break;
+        }
+    }
+}
+
+void NPCSystem::step(int id, float deltaTime, Vector3 viewer, const EnvironmentManager& environment) {
+    const std::vector<Vector3>& path = paths_[id];
+    uint32_t& cursor = path_cursor_[id];
+    float dx = 0.0f, dz = 0.0f, distance = 0.0f;
+    for (; cursor < path.size(); ++cursor) {
+        dx = path[cursor].x - x_[id];
+        dz = path[cursor].z - z_[id];
+        distance = sqrtf(dx * dx + dz * dz);
+        if (distance > NPCConstants::ARRIVE_DISTANCE) break;
+    }
+    if (cursor >= path.size()) {
+        rest(id);  // Arrived
+        return;
+    }
+
+    float move = std::min(NPCConstants::WALK_SPEED * deltaTime, distance);
+    Vector3 next = {x_[id] + dx / distance * move, y_[id], z_[id] + dz / distance * move};
+
+    // Give way to the player
+    float px = next.x - viewer.x, pz = next.z - viewer.z;
+    float personal = radius_[id] + PlayerConstants::RADIUS;
+    bool blocked = px * px + pz * pz < personal * personal;
+
+    // The path already avoids the world, short of what changed since it was planned.
+    // Far NPCs skip each other; bumping into someone out of sight goes unnoticed.
+    if (!blocked) blocked = PathService::getInstance().isBlocked(next);
+    if (!blocked && detail_[id] != NPCDetail::FAR) {
+        blocked = checkCollision(environment, next, radius_[id], NPCConstants::HEIGHT, id);
+    }
+    if (blocked) {
+        rest(id);  // Picks somewhere else after the pause
+        return;
+    }
+
+    x_[id] = next.x;
+    z_[id] = next.z;
+    // The environment re-buckets the anchor on its next update
+    if (anchors_[id]) anchors_[id]->position = next;
+}
+
+void NPCSystem::rest(int id) {
+    if (path_request_[id] != 0) {
+        PathService::getInstance().releasePath(id);
+        path_request_[id] = 0;
+    }
+    paths_[id].clear();
+    state_[id] = NPCState::IDLE;
+    think_at_[id] = time_ + NPCConstants::MIN_IDLE_TIME +
+                    nextRandom(id) * (NPCConstants::MAX_IDLE_TIME - NPCConstants::MIN_IDLE_TIME);
+}
+
+float NPCSystem::nextRandom(int id) {
+    return unitRandom(rng_[id]);
+}
+
+bool NPCSystem::checkCollision(const EnvironmentManager& environment, Vector3 capsulePos, float capsuleRadius,
+                               float capsuleHeight, int excludeNPC) const {
+    // Grid buckets trail NPC moves by a frame, so reach past the largest step as well
+    const float reach = capsuleRadius + NPCConstants::COLLISION_RADIUS +
+                        NPCConstants::WALK_SPEED * NPCConstants::MAX_STEP_TIME;
+    BoundingBox area = {{capsulePos.x - reach, capsulePos.y, capsulePos.z - reach},
+                        {capsulePos.x + reach, capsulePos.y + capsuleHeight, capsulePos.z + reach}};
+    environment.queryCandidates(area, query_scratch_);
+
+    const auto& objects = environment.getAllObjects();
+    for (uint32_t index : query_scratch_) {
+        const NpcAnchor* anchor = objectCast<NpcAnchor>(objects[index].get());
+        if (!anchor) continue;
+        int n = anchor->getNpcIndex();
+        if (n == excludeNPC || !isValid(n)) continue;
+
+        float capsuleBottom = capsulePos.y;
+        float capsuleTop = capsulePos.y + capsuleHeight;
+        float npcBottom = y_[n];
+        float npcTop = y_[n] + NPCConstants::HEIGHT;
+        if (capsuleTop < npcBottom || capsuleBottom > npcTop) continue;
+
+        float dx = capsulePos.x - x_[n];
+        float dz = capsulePos.z - z_[n];
+        float reachXZ = radius_[n] + capsuleRadius;
+        if (dx * dx + dz * dz <= reachXZ * reachXZ) return true;
+    }
+    return false;
+}
 
 // Initialize NPCs with proper building positioning
 void initNPCs() {
+    NPCSystem& npcs = NPCSystem::getInstance();
+    npcs.clear();
+
     // Mayor White in Mayor's Building - positioned relative to building interior
-    npcs[0] = {
+    npcs.spawn({
         .position = {-12.0f, 0.0f, 0.0f},  // Inside Mayor's Office at building center
         .name = "Mayor White",
         .dialog = "Greetings, citizen! Welcome to my office. What brings you here today?",
         .color = WHITE,
         .canInteract = true,
-        .interactionRadius = 2.5f
-    };
+        .interactionRadius = 2.5f,
+        .homeBuilding = 0
+    });
 
     // Buster Shoppin in Shop Building - positioned relative to building interior
-    npcs[1] = {
+    npcs.spawn({
         .position = {0.0f, 0.0f, 12.0f},  // Inside General Store at building center
         .name = "Buster Shoppin",
         .dialog = "Welcome to my shop! I've got all sorts of goods and supplies for sale.",
         .color = GREEN,
         .canInteract = true,
-        .interactionRadius = 2.5f
-    };
+        .interactionRadius = 2.5f,
+        .homeBuilding = 1
+    });
 }
 
-bool checkNPCCollision(Vector3 capsulePos, float capsuleRadius, float capsuleHeight, int excludeNPC) {
-    for (int n = 0; n < MAX_NPCS; n++) {
-        if (n == excludeNPC) continue;
-
-        const float npcRadius = 0.6f;
-        const float npcHeight = 2.0f;
-
-        float capsuleBottom = capsulePos.y;
-        float capsuleTop = capsulePos.y + capsuleHeight;
-        float npcBottom = npcs[n].position.y;
-        float npcTop = npcs[n].position.y + npcHeight;
-
-        if (capsuleTop < npcBottom || capsuleBottom > npcTop) continue;
-
-        float dx = capsulePos.x - npcs[n].position.x;
-        float dz = capsulePos.z - npcs[n].position.z;
-        float distance2D = sqrtf(dx * dx + dz * dz);
-
-        if (distance2D <= npcRadius + capsuleRadius) return true;
-    }
-    return false;
+bool checkNPCCollision(const EnvironmentManager& environment, Vector3 capsulePos, float capsuleRadius,
+                       float capsuleHeight, int excludeNPC) {
+    return NPCSystem::getInstance().checkCollision(environment, capsulePos, capsuleRadius, capsuleHeight, excludeNPC);
 }
-
-// Render NPC function
-void renderNPC(NPC npc, Camera3D camera, float currentTime) {
-    // Draw NPC body (cylinder)
-    Vector3 npcPos = npc.position;
-    DrawCylinder(npcPos, 0.6f, 0.6f, 2.0f, 16, npc.color);
-
-    // Draw NPC head (sphere)
-    Vector3 headPos = {npcPos.x, npcPos.y + 2.2f, npcPos.z};
-    DrawSphere(headPos, 0.4f, npc.color);
-
-    // Draw NPC name above head (convert 3D to 2D screen position)
-    Vector3 namePos3D = {npcPos.x, npcPos.y + 3.0f, npcPos.z};
-    Vector2 namePos2D = GetWorldToScreen(namePos3D, camera);
-    DrawText(npc.name.c_str(), (int)namePos2D.x - 50, (int)namePos2D.y - 20, 16, npc.color);
-
-    // Draw interaction indicator if player is close
-    float distance = MathUtils::distance3D(npc.position, camera.position);
-
-    if (distance <= npc.interactionRadius) {
-        // Pulsing interaction indicator
-        float pulse = 0.8f + sinf(currentTime * 3.0f) * 0.2f;
-        Vector3 indicatorPos = {npcPos.x, npcPos.y + 3.5f, npcPos.z};
-        DrawSphere(indicatorPos, 0.2f * pulse, YELLOW);
-    }
-}
\ No newline at end of file
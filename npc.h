@@ -3,8 +3,17 @@
 #define NPC_H
 
 #include "raylib.h"
+#include "navigation.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
+class EnvironmentManager;
+class NpcAnchor;
+
+/// \brief Spawn description for one NPC; NPCSystem copies it into its arrays.
 struct NPC {
     Vector3 position;
     std::string name;
@@ -12,12 +21,152 @@ struct NPC {
     Color color;
     bool canInteract;
     float interactionRadius;
+    int homeBuilding = -1;   // Building the NPC stays inside, or -1 for outdoors
+    bool wanders = false;    // Strolls around its spawn point between pauses
 };
 
-const int MAX_NPCS = 2;
-extern NPC npcs[MAX_NPCS];
+enum class NPCState : uint8_t { IDLE, PLANNING, WALKING };  // PLANNING: waiting on PathService
+
+/// \brief Crowd LOD tier, from the NPC's distance to the camera.
+enum class NPCDetail : uint8_t { NEAR, MID, FAR };
+
+/// \brief Every NPC in the game, stored as parallel arrays indexed by NPC id.
+///
+/// Per-frame data (position, radii, state, walk target, LOD tier) lives in tight arrays
+/// the update walks front to back; names, dialog and colours sit in separate arrays only
+/// rendering and dialog touch. Each NPC also gets an NpcAnchor in the environment's
+/// spatial grid, so interaction queries and checkNPCCollision find NPCs near a point
+/// without looping over all of them.
+///
+/// update() moves walking NPCs at a rate set by their LOD tier: near ones every frame,
+/// mid and far ones every MID/FAR_UPDATE_INTERVAL frames (times the interval scale) with the
+/// skipped time folded in.
+/// Choosing the next walk target ("thinking") is spread across frames: nearby NPCs that
+/// are due always think, the rest are visited round-robin up to THINK_BUDGET a frame.
+/// Walks follow paths from PathService, so NPCs go around buildings and the well; the
+/// PathService must be synced with the environment before each update.
+/// Ids are stable for the life of the game; Mayor White is 0 and Buster Shoppin 1.
+class NPCSystem {
+public:
+    static NPCSystem& getInstance() {
+        static NPCSystem instance;
+        return instance;
+    }
+
+    /// \brief Adds an NPC. Registered with the environment straight away once attach() has run.
+    /// \return The NPC's id.
+    int spawn(const NPC& npc);
+
+    /// \brief Spawns `count` wandering townsfolk around the town square, deterministically.
+    /// Spots inside environment colliders or on top of another NPC are skipped.
+    void spawnTownsfolk(const EnvironmentManager& environment, int count);
+
+    /// \brief Removes every NPC and forgets the attached environment. Anchors already added
+    /// to an environment stay there.
+    void clear();
+
+    /// \brief Adds an NpcAnchor per NPC to the environment's grid; later spawns follow.
+    void attach(EnvironmentManager& environment);
+
+    /// \brief Re-tiers, moves and thinks for one frame.
+    /// \param deltaTime Simulation step in seconds.
+    /// \param viewer Camera position; sets LOD tiers, and NPCs step around it.
+    /// \param environment Environment walking NPCs collide with. Reads its spatial grid, so
+    /// nothing else may query it concurrently.
+    /// \param engagedNpc NPC in dialog with the player, held still; -1 for none.
+    void update(float deltaTime, Vector3 viewer, const EnvironmentManager& environment, int engagedNpc = -1);
+
+    /// \brief Capsule test against NPCs near the capsule, found through the environment's grid.
+    /// \param capsulePos Bottom centre of the capsule.
+    /// \param excludeNPC NPC to ignore (the one being moved), or -1.
+    bool checkCollision(const EnvironmentManager& environment, Vector3 capsulePos, float capsuleRadius,
+                        float capsuleHeight, int excludeNPC = -1) const;
+
+    /// \brief Whether the player can currently see the NPC: indoor NPCs only from inside
+    /// their building, outdoor NPCs only from outside.
+    bool isVisible(int id, bool isInBuilding, int currentBuilding) const {
+        return home_building_[id] < 0 ? !isInBuilding : (isInBuilding && currentBuilding == home_building_[id]);
+    }
+
+    int getCount() const { return static_cast<int>(x_.size()); }
+    bool isValid(int id) const { return id >= 0 && id < getCount(); }
+
+    Vector3 getPosition(int id) const { return {x_[id], y_[id], z_[id]}; }
+    float getCollisionRadius(int id) const { return radius_[id]; }
+    float getInteractionRadius(int id) const { return interaction_radius_[id]; }
+    int getHomeBuilding(int id) const { return home_building_[id]; }
+    NPCState getState(int id) const { return state_[id]; }
+    NPCDetail getDetail(int id) const { return detail_[id]; }
 
+    const std::string& getName(int id) const { return names_[id]; }
+    const std::string& getDialog(int id) const { return dialogs_[id]; }
+    Color getColor(int id) const { return colors_[id]; }
+    bool canInteract(int id) const { return can_interact_[id] != 0; }
+
+    /// \brief Thoughts run in the last update, and NPCs left waiting for a turn.
+    int getLastThinkCount() const { return last_think_count_; }
+    int getThinkBacklog() const { return think_backlog_; }
+
+    /// \brief Multiplies the MID and FAR movement intervals; 1 is the normal rate.
+    void setUpdateIntervalScale(int scale) { update_interval_scale_ = static_cast<uint32_t>(std::max(scale, 1)); }
+    int getUpdateIntervalScale() const { return static_cast<int>(update_interval_scale_); }
+
+private:
+    NPCSystem() = default;
+    NPCSystem(const NPCSystem&) = delete;
+    NPCSystem& operator=(const NPCSystem&) = delete;
+
+    void registerAnchor(int id);
+    void think(int id);
+    void requestWalk(int id);
+    void applyPathResults();
+    void step(int id, float deltaTime, Vector3 viewer, const EnvironmentManager& environment);
+    void rest(int id);
+    float nextRandom(int id);   // [0, 1), per-NPC stream so replays pick the same walks
+
+    // Hot: read or written every update
+    std::vector<float> x_, y_, z_;
+    std::vector<float> radius_;
+    std::vector<float> interaction_radius_;
+    std::vector<float> target_x_, target_z_;   // Walk goal; the path's last waypoint
+    std::vector<float> home_x_, home_z_;       // Wander centre
+    std::vector<float> pending_time_;          // Walking time not yet integrated (reduced-rate tiers)
+    std::vector<float> think_at_;              // Simulation time the NPC next picks a walk
+    std::vector<int> home_building_;
+    std::vector<uint32_t> rng_;
+    std::vector<NPCState> state_;
+    std::vector<NPCDetail> detail_;
+    std::vector<uint8_t> wanders_;
+    std::vector<uint32_t> path_request_;       // PathService request being waited on or walked; 0 for none
+    std::vector<uint32_t> path_cursor_;        // Waypoint being walked to
+    std::vector<std::vector<Vector3>> paths_;
+
+    // Cold: rendering and dialog
+    std::vector<std::string> names_;
+    std::vector<std::string> dialogs_;
+    std::vector<Color> colors_;
+    std::vector<uint8_t> can_interact_;
+    std::vector<std::shared_ptr<NpcAnchor>> anchors_;
+
+    EnvironmentManager* environment_ = nullptr;
+    uint32_t frame_ = 0;
+    float time_ = 0.0f;
+    size_t think_cursor_ = 0;
+    int last_think_count_ = 0;
+    int think_backlog_ = 0;
+    uint32_t update_interval_scale_ = 1;
+
+    std::vector<int> near_scratch_;
+    std::vector<float> dist_sq_scratch_;       // Ground-plane distance² to the viewer, per NPC
+    std::vector<PathResult> path_results_;
+    mutable std::vector<uint32_t> query_scratch_;
+};
+
+/// \brief Spawns the named cast (Mayor White, Buster Shoppin) into a cleared NPCSystem.
 void initNPCs();
-bool checkNPCCollision(Vector3 capsulePos, float capsuleRadius, float capsuleHeight, int excludeNPC = -1);
 
-#endif
\ No newline at end of file
+/// \brief NPCSystem::checkCollision on the shared instance.
+bool checkNPCCollision(const EnvironmentManager& environment, Vector3 capsulePos, float capsuleRadius,
+                       float capsuleHeight, int excludeNPC = -1);
+
+#endif
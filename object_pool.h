@@ -0,0 +1,223 @@
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/// \brief Fixed-size object pool with slab storage, a lock-free free list and generational handles.
+///
+/// Slots live in slabs of SlabSize that are never moved or freed while the pool exists, so
+/// pointers stay valid until the slot is released. Acquire and release are lock-free and
+/// may be called from any thread; only growing by a slab takes a mutex. Handles carry a
+/// generation, so a handle to a released slot resolves to nullptr instead of a reused object.
+template<typename T, uint32_t SlabSize = 64>
+class ObjectPool {
+public:
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+    /// \brief Stable reference to a pooled object.
+    struct Handle {
+        uint32_t index = INVALID_INDEX;
+        uint32_t generation = 0;
+
+        bool isValid() const { return index != INVALID_INDEX; }
+        bool operator==(const Handle& other) const { return index == other.index && generation == other.generation; }
+        bool operator!=(const Handle& other) const { return !(*this == other); }
+    };
+
+    ObjectPool() = default;
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    /// \brief Destroys objects still alive and frees all slabs.
+    ~ObjectPool() {
+        uint32_t slabs = slab_count_.load(std::memory_order_acquire);
+        for (uint32_t s = 0; s < slabs; ++s) {
+            Slot* slab = slabs_[s].load(std::memory_order_relaxed);
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                for (uint32_t i = 0; i < SlabSize; ++i) {
+                    if (isLive(slab[i].generation.load(std::memory_order_relaxed))) {
+                        slab[i].object()->~T();
+                    }
+                }
+            }
+            delete[] slab;
+        }
+    }
+
+    /// \brief Constructs an object in a free slot.
+    /// \return Handle to the new object.
+    template<typename... Args>
+    Handle create(Args&&... args) {
+        uint32_t index = acquireSlot();
+        Slot& slot = slotAt(index);
+        new (slot.storage) T(std::forward<Args>(args)...);
+        return {index, slot.generation.load(std::memory_order_relaxed)};
+    }
+
+    /// \brief Destroys the object and frees its slot. Stale handles are ignored.
+    void destroy(Handle handle) {
+        T* obj = get(handle);
+        if (!obj) return;
+        obj->~T();
+        releaseSlot(handle.index);
+    }
+
+    /// \brief Resolves a handle.
+    /// \return Object, or nullptr if the handle is invalid or its slot was released.
+    T* get(Handle handle) const {
+        if (handle.index >= getCapacity()) return nullptr;
+        Slot& slot = slotAt(handle.index);
+        if (slot.generation.load(std::memory_order_acquire) != handle.generation) return nullptr;
+        return slot.object();
+    }
+
+    /// \brief Takes an uninitialised slot, for allocator adaptors.
+    void* allocate() {
+        return slotAt(acquireSlot()).storage;
+    }
+
+    /// \brief Returns a slot from allocate(); the caller has already destroyed its contents.
+    void deallocate(void* ptr) {
+        releaseSlot(reinterpret_cast<Slot*>(ptr)->index);
+    }
+
+    /// \brief Gets number of slots in use.
+    size_t getLiveCount() const { return live_count_.load(std::memory_order_relaxed); }
+
+    /// \brief Gets number of slots across all slabs.
+    size_t getCapacity() const { return size_t(slab_count_.load(std::memory_order_acquire)) * SlabSize; }
+
+private:
+    static constexpr uint32_t MAX_SLABS = 4096;
+
+    struct Slot {
+        // Storage first, so a pointer to the object is a pointer to its slot
+        alignas(T) unsigned char storage[sizeof(T)];
+        std::atomic<uint32_t> generation{0};   // Odd while live
+        std::atomic<uint32_t> next{INVALID_INDEX};
+        uint32_t index = 0;
+
+        T* object() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    std::atomic<Slot*> slabs_[MAX_SLABS] = {};
+    std::atomic<uint32_t> slab_count_{0};
+    // Free list head: ABA tag in the high 32 bits, slot index in the low 32
+    std::atomic<uint64_t> free_head_{INVALID_INDEX};
+    std::atomic<size_t> live_count_{0};
+    std::mutex grow_mutex_;
+
+    static bool isLive(uint32_t generation) { return (generation & 1u) != 0; }
+    static uint64_t pack(uint64_t head, uint32_t index) { return (((head >> 32) + 1) << 32) | index; }
+
+    Slot& slotAt(uint32_t index) const {
+        return slabs_[index / SlabSize].load(std::memory_order_acquire)[index % SlabSize];
+    }
+
+    uint32_t acquireSlot() {
+        uint64_t head = free_head_.load(std::memory_order_acquire);
+        while (true) {
+            uint32_t index = static_cast<uint32_t>(head);
+            if (index == INVALID_INDEX) {
+                grow();
+                head = free_head_.load(std::memory_order_acquire);
+                continue;
+            }
+            // A stale read of next is harmless: the tagged CAS fails and we retry
+            uint32_t next = slotAt(index).next.load(std::memory_order_relaxed);
+            if (free_head_.compare_exchange_weak(head, pack(head, next), std::memory_order_acq_rel, std::memory_order_acquire)) {
+                slotAt(index).generation.fetch_add(1, std::memory_order_release);
+                live_count_.fetch_add(1, std::memory_order_relaxed);
+                return index;
+            }
+        }
+    }
+
+    void releaseSlot(uint32_t index) {
+        Slot& slot = slotAt(index);
+        slot.generation.fetch_add(1, std::memory_order_release);
+        live_count_.fetch_sub(1, std::memory_order_relaxed);
+        pushChain(index, index);
+    }
+
+    /// \brief Pushes a linked run first..last (last.next is overwritten) onto the free list.
+    void pushChain(uint32_t first, uint32_t last) {
+        uint64_t head = free_head_.load(std::memory_order_relaxed);
+        do {
+            slotAt(last).next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        } while (!free_head_.compare_exchange_weak(head, pack(head, first), std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void grow() {
+        std::lock_guard<std::mutex> lock(grow_mutex_);
+        // Another thread may have grown or released while we waited
+        if (static_cast<uint32_t>(free_head_.load(std::memory_order_acquire)) != INVALID_INDEX) return;
+
+        uint32_t slabIndex = slab_count_.load(std::memory_order_relaxed);
+        if (slabIndex >= MAX_SLABS) throw std::bad_alloc();
+
+        Slot* slab = new Slot[SlabSize];
+        uint32_t base = slabIndex * SlabSize;
+        for (uint32_t i = 0; i < SlabSize; ++i) {
+            slab[i].index = base + i;
+            slab[i].next.store(i + 1 < SlabSize ? base + i + 1 : INVALID_INDEX, std::memory_order_relaxed);
+        }
+        slabs_[slabIndex].store(slab, std::memory_order_release);
+        slab_count_.store(slabIndex + 1, std::memory_order_release);
+        pushChain(base, base + SlabSize - 1);
+    }
+};
+
+/// \brief Raw storage block so one pool can serve any type of a given size and alignment.
+template<size_t Size, size_t Align>
+struct PoolBlock {
+    alignas(Align) unsigned char bytes[Size];
+};
+
+/// \brief Allocator that serves single-object allocations from a process-wide ObjectPool.
+///
+/// Meant for std::allocate_shared: the control block and object land in one pooled slot,
+/// and the last owner can release from any thread. Array allocations fall back to the heap.
+template<typename T>
+struct PoolAllocator {
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        if (n == 1) return static_cast<T*>(sharedPool().allocate());
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+    }
+
+    void deallocate(T* ptr, size_t n) {
+        if (n == 1) {
+            sharedPool().deallocate(ptr);
+        } else {
+            ::operator delete(ptr, std::align_val_t(alignof(T)));
+        }
+    }
+
+    using Pool = ObjectPool<PoolBlock<sizeof(T), alignof(T)>>;
+
+    /// \brief Pool shared by every allocator of this block size; intentionally never destroyed,
+    /// since pooled shared_ptrs may outlive static destruction.
+    static Pool& sharedPool() {
+        static Pool* pool = new Pool();
+        return *pool;
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>&) const { return true; }
+    template<typename U>
+    bool operator!=(const PoolAllocator<U>&) const { return false; }
+};
+
+#endif
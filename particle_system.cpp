@@ -0,0 +1,226 @@
+// particle_system.cpp
+#include "particle_system.h"
+#include "constants.h"
+#include "math_utils.h"
+#include "render_stats.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    struct ParticleLook {
+        float minLife, maxLife;   // Seconds
+        float speed;              // Launch speed, metres per second
+        float gravity;            // Vertical acceleration; positive floats upward
+        float drag;               // Fraction of velocity lost per second
+        float startSize, endSize; // Quad half-extent over the particle's life
+        Color startColor, endColor;
+    };
+
+    constexpr ParticleLook LOOKS[] = {
+        // BLADE_TRAIL: short-lived embers left along the blade tip's path
+        {0.15f, 0.30f, 0.2f, 0.0f, 4.0f, 0.06f, 0.01f, {255, 161, 0, 200}, {253, 249, 0, 0}},
+        // HIT_SPARK: fast, falling sparks thrown off a struck target
+        {0.25f, 0.50f, 4.0f, -9.8f, 1.5f, 0.05f, 0.02f, {255, 230, 120, 255}, {255, 80, 0, 0}},
+        // DUST: slow motes drifting up around the well
+        {3.0f, 5.0f, 0.15f, 0.05f, 0.2f, 0.08f, 0.12f, {200, 180, 140, 90}, {200, 180, 140, 0}},
+    };
+    static_assert(sizeof(LOOKS) / sizeof(LOOKS[0]) == static_cast<size_t>(ParticleType::COUNT),
+                  "one look per particle type");
+
+    unsigned char mix(unsigned char a, unsigned char b, float t) {
+        return static_cast<unsigned char>(static_cast<float>(a) + (static_cast<float>(b) - static_cast<float>(a)) * t);
+    }
+
+    Vector3 cross(Vector3 a, Vector3 b) {
+        return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+    }
+}
+
+ParticleSystem::EmitterHandle ParticleSystem::createEmitter(ParticleType type, Vector3 position, float rate) {
+    EmitterHandle handle = emitters_.create();
+    *emitters_.get(handle) = {type, position, position, rate, 0.0f};
+    active_emitters_.push_back(handle);
+    return handle;
+}
+
+void ParticleSystem::moveEmitter(EmitterHandle handle, Vector3 position) {
+    if (ParticleEmitter* emitter = emitters_.get(handle)) {
+        emitter->position = position;
+    }
+}
+
+void ParticleSystem::destroyEmitter(EmitterHandle handle) {
+    if (!emitters_.get(handle)) return;
+    emitters_.destroy(handle);
+    active_emitters_.erase(std::find(active_emitters_.begin(), active_emitters_.end(), handle));
+}
+
+void ParticleSystem::setBudget(int perType) {
+    budget_ = std::clamp(perType, 0, ParticleConstants::MAX_PER_TYPE);
+}
+
+void ParticleSystem::burst(ParticleType type, Vector3 position, int count, Vector3 direction) {
+    for (int i = 0; i < count; i++) {
+        spawn(type, position, direction);
+    }
+}
+
+void ParticleSystem::spawn(ParticleType type, Vector3 position, Vector3 direction) {
+    Particles& p = particles_[static_cast<int>(type)];
+    if (p.x.size() >= static_cast<size_t>(budget_)) return;
+    const ParticleLook& look = LOOKS[static_cast<int>(type)];
+
+    // Random direction in the unit cube, normalized; aimed bursts add it as spread
+    Vector3 jitter = MathUtils::normalizeVector3D({nextRandom() * 2.0f - 1.0f, nextRandom() * 2.0f - 1.0f,
+                                                  nextRandom() * 2.0f - 1.0f});
+    float speed = look.speed * (0.5f + 0.5f * nextRandom());
+    Vector3 velocity = MathUtils::isVectorZero3D(direction)
+        ? Vector3{jitter.x * speed, jitter.y * speed, jitter.z * speed}
+        : Vector3{(direction.x + jitter.x * 0.5f) * speed, (direction.y + jitter.y * 0.5f) * speed,
+                  (direction.z + jitter.z * 0.5f) * speed};
+
+    p.x.push_back(position.x);
+    p.y.push_back(position.y);
+    p.z.push_back(position.z);
+    p.vx.push_back(velocity.x);
+    p.vy.push_back(velocity.y);
+    p.vz.push_back(velocity.z);
+    p.age.push_back(0.0f);
+    p.life.push_back(MathUtils::lerp(look.minLife, look.maxLife, nextRandom()));
+}
+
+void ParticleSystem::update(float deltaTime, const Camera3D& camera) {
+    // Emitters spread this frame's spawns along the path they moved, so fast blades leave
+    // an unbroken trail instead of clumps at each frame's tip position
+    for (EmitterHandle handle : active_emitters_) {
+        ParticleEmitter& emitter = *emitters_.get(handle);
+        emitter.carry += emitter.rate * deltaTime;
+        int count = static_cast<int>(emitter.carry);
+        emitter.carry -= static_cast<float>(count);
+        for (int i = 1; i <= count; i++) {
+            float t = static_cast<float>(i) / static_cast<float>(count);
+            spawn(emitter.type, {MathUtils::lerp(emitter.previous.x, emitter.position.x, t),
+                                 MathUtils::lerp(emitter.previous.y, emitter.position.y, t),
+                                 MathUtils::lerp(emitter.previous.z, emitter.position.z, t)}, {0.0f, 0.0f, 0.0f});
+        }
+        emitter.previous = emitter.position;
+    }
+
+    Vector3 forward = MathUtils::normalizeVector3D({camera.target.x - camera.position.x,
+                                                    camera.target.y - camera.position.y,
+                                                    camera.target.z - camera.position.z});
+    Vector3 right = MathUtils::normalizeVector3D(cross(forward, camera.up));
+    Vector3 up = cross(right, forward);
+
+    for (int type = 0; type < static_cast<int>(ParticleType::COUNT); type++) {
+        Particles& p = particles_[type];
+        const ParticleLook& look = LOOKS[type];
+        const float damping = std::max(0.0f, 1.0f - look.drag * deltaTime);
+
+        // Step and compact in one pass; survivors keep their order
+        size_t live = 0;
+        for (size_t i = 0; i < p.x.size(); i++) {
+            float age = p.age[i] + deltaTime;
+            if (age >= p.life[i]) continue;
+            float vx = p.vx[i] * damping;
+            float vy = p.vy[i] * damping + look.gravity * deltaTime;
+            float vz = p.vz[i] * damping;
+            p.x[live] = p.x[i] + vx * deltaTime;
+            p.y[live] = p.y[i] + vy * deltaTime;
+            p.z[live] = p.z[i] + vz * deltaTime;
+            p.vx[live] = vx;
+            p.vy[live] = vy;
+            p.vz[live] = vz;
+            p.age[live] = age;
+            p.life[live] = p.life[i];
+            live++;
+        }
+        p.x.resize(live);
+        p.y.resize(live);
+        p.z.resize(live);
+        p.vx.resize(live);
+        p.vy.resize(live);
+        p.vz.resize(live);
+        p.age.resize(live);
+        p.life.resize(live);
+
+        // Quad corners in raylib billboard order: top-left, bottom-left, bottom-right, top-right
+        p.vertices.resize(live * 12);
+        p.colors.resize(live * 4);
+        for (size_t i = 0; i < live; i++) {
+            float t = p.age[i] / p.life[i];
+            float size = MathUtils::lerp(look.startSize, look.endSize, t);
+            Vector3 r = {right.x * size, right.y * size, right.z * size};
+            Vector3 u = {up.x * size, up.y * size, up.z * size};
+
+            float* v = &p.vertices[i * 12];
+            v[0] = p.x[i] - r.x + u.x;  v[1] = p.y[i] - r.y + u.y;  v[2] = p.z[i] - r.z + u.z;
+            v[3] = p.x[i] - r.x - u.x;  v[4] = p.y[i] - r.y - u.y;  v[5] = p.z[i] - r.z - u.z;
+            v[6] = p.x[i] + r.x - u.x;  v[7] = p.y[i] + r.y - u.y;  v[8] = p.z[i] + r.z - u.z;
+            v[9] = p.x[i] + r.x + u.x;  v[10] = p.y[i] + r.y + u.y; v[11] = p.z[i] + r.z + u.z;
+
+            unsigned char* c = &p.colors[i * 4];
+            c[0] = mix(look.startColor.r, look.endColor.r, t);
+            c[1] = mix(look.startColor.g, look.endColor.g, t);
+            c[2] = mix(look.startColor.b, look.endColor.b, t);
+            c[3] = mix(look.startColor.a, look.endColor.a, t);
+        }
+    }
+}
+
+void ParticleSystem::draw() {
+    last_draw_calls_ = 0;
+
+    // Translucent quads test depth but don't write it, so overlapping particles don't cut
+    // holes in each other; the batch is flushed on both sides so the mask applies to them only
+    rlDrawRenderBatchActive();
+    rlDisableDepthMask();
+    for (const Particles& p : particles_) {
+        size_t count = p.colors.size() / 4;
+        if (count == 0) continue;
+
+        rlCheckRenderBatchLimit(4 * static_cast<int>(count));
+        rlBegin(RL_QUADS);
+        for (size_t i = 0; i < count; i++) {
+            const unsigned char* c = &p.colors[i * 4];
+            const float* v = &p.vertices[i * 12];
+            rlColor4ub(c[0], c[1], c[2], c[3]);
+            rlVertex3f(v[0], v[1], v[2]);
+            rlVertex3f(v[3], v[4], v[5]);
+            rlVertex3f(v[6], v[7], v[8]);
+            rlVertex3f(v[9], v[10], v[11]);
+        }
+        rlEnd();
+        RenderStats::getInstance().recordShape(4 * static_cast<uint32_t>(count));
+        last_draw_calls_++;
+    }
+    rlDrawRenderBatchActive();
+    rlEnableDepthMask();
+}
+
+void ParticleSystem::clear() {
+    for (EmitterHandle handle : active_emitters_) {
+        emitters_.destroy(handle);
+    }
+    active_emitters_.clear();
+    for (Particles& p : particles_) {
+        p = Particles{};
+    }
+}
+
+size_t ParticleSystem::getLiveCount() const {
+    size_t total = 0;
+    for (const Particles& p : particles_) {
+        total += p.x.size();
+    }
+    return total;
+}
+
+float ParticleSystem::nextRandom() {
+    // xorshift32: cheap, and the same effects every run
+    rng_ ^= rng_ << 13;
+    rng_ ^= rng_ >> 17;
+    rng_ ^= rng_ << 5;
+    return static_cast<float>(rng_ >> 8) * (1.0f / 16777216.0f);
+}
@@ -0,0 +1,96 @@
+// particle_system.h - Pooled emitters, worker-side particle simulation and one batched draw per type
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+
+#include "raylib.h"
+#include "constants.h"
+#include "object_pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// \brief Kinds of particle; each has its own look, motion and vertex buffer.
+enum class ParticleType : uint8_t { BLADE_TRAIL, HIT_SPARK, DUST, COUNT };
+
+/// \brief Continuous particle source, e.g. a swinging blade's tip.
+struct ParticleEmitter {
+    ParticleType type;
+    Vector3 position;
+    Vector3 previous;    // Position at the last update; spawns are spread from here to position
+    float rate;          // Particles per second
+    float carry;         // Fraction of a particle left over from the last update
+};
+
+/// \brief Particles for combat and ambient effects.
+///
+/// Each type keeps its live particles in parallel arrays and a persistent vertex buffer of
+/// camera-facing quads. update() simulates, culls dead particles and rewrites the quads,
+/// so it can run on a worker; draw() only streams the prepared quads to rlgl in one block
+/// per type, which raylib sends to the GPU as a single draw call.
+///
+/// Emitters come from a pool and are edited by handle; burst() spawns one-off effects.
+/// Nothing here is locked: emitting and update() must happen on one thread at a time (the
+/// update graph runs combat before particles), and draw() after update() has finished.
+class ParticleSystem {
+public:
+    using EmitterPool = ObjectPool<ParticleEmitter, 16>;
+    using EmitterHandle = EmitterPool::Handle;
+
+    static ParticleSystem& getInstance() {
+        static ParticleSystem instance;
+        return instance;
+    }
+
+    /// \brief Starts a continuous emitter.
+    EmitterHandle createEmitter(ParticleType type, Vector3 position, float rate);
+
+    /// \brief Moves an emitter; particles spawn along the way it travelled. Stale handles are ignored.
+    void moveEmitter(EmitterHandle handle, Vector3 position);
+
+    /// \brief Stops an emitter. Its particles live out their lifetime.
+    void destroyEmitter(EmitterHandle handle);
+
+    /// \brief Spawns count particles at once, thrown around direction (or every way if zero).
+    void burst(ParticleType type, Vector3 position, int count, Vector3 direction = {0.0f, 0.0f, 0.0f});
+
+    /// \brief Runs emitters, steps particles and rebuilds each type's quads facing the camera.
+    void update(float deltaTime, const Camera3D& camera);
+
+    /// \brief Draws every type's quads. Call inside BeginMode3D, after opaque geometry.
+    void draw();
+
+    /// \brief Removes all particles and emitters.
+    void clear();
+
+    size_t getLiveCount() const;
+
+    /// \brief Caps live particles per type; spawns past the cap are dropped. Clamped to MAX_PER_TYPE.
+    void setBudget(int perType);
+    int getBudget() const { return budget_; }
+    int getLastDrawCalls() const { return last_draw_calls_; }
+
+private:
+    ParticleSystem() = default;
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+    struct Particles {
+        std::vector<float> x, y, z;
+        std::vector<float> vx, vy, vz;
+        std::vector<float> age, life;
+        std::vector<float> vertices;        // 4 corners x xyz per live particle, rebuilt by update()
+        std::vector<unsigned char> colors;  // RGBA per live particle
+    };
+
+    void spawn(ParticleType type, Vector3 position, Vector3 direction);
+    float nextRandom();   // [0, 1)
+
+    Particles particles_[static_cast<int>(ParticleType::COUNT)];
+    EmitterPool emitters_;
+    std::vector<EmitterHandle> active_emitters_;
+    uint32_t rng_ = 0x9E3779B9u;
+    int last_draw_calls_ = 0;
+    int budget_ = ParticleConstants::MAX_PER_TYPE;
+};
+
+#endif // PARTICLE_SYSTEM_H
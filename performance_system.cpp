@@ -1,31 +1,45 @@
 #include "performance_system.h"
+#include "memory_tracker.h"
+#include "frame_arena.h"
+#include "render_stats.h"
+#include "constants.h"
 #include <iostream>
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 #include <stdexcept>  // For error handling
 
-SystemTimer::SystemTimer(const std::string& timerName) : name_(timerName) {}
+SystemTimer::SystemTimer(const std::string& timerName)
+    : name_(timerName), profile_name_(Profiler::getInstance().intern(timerName)) {}
 
 void SystemTimer::start() {
-    start_time_ = std::chrono::high_resolution_clock::now();
+    start_ns_ = Profiler::now();
 }
 
 void SystemTimer::end() {
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - start_time_);
-    float frameTimeMs = static_cast<float>(duration.count()) / 1000.0f;  // Convert to milliseconds
-    
-    if (frameTimeMs < 0.0f) {
+    uint64_t endNs = Profiler::now();
+    if (endNs < start_ns_) {
         throw std::runtime_error("Negative time measured in " + name_ + " timer");
     }
+    float frameTimeMs = static_cast<float>(endNs - start_ns_) / 1.0e6f;  // Convert to milliseconds
+
+    Profiler& profiler = Profiler::getInstance();
+    if (profiler.isEnabled()) {
+        profiler.record(profile_name_, start_ns_, endNs, Profiler::threadDepth());
+    }
     
     total_time_ += frameTimeMs;
     max_time_ = std::max(max_time_, frameTimeMs);
+    last_time_ = frameTimeMs;
     call_count_++;
 }
 
 void SystemTimer::reset() {
     total_time_ = 0.0f;
     max_time_ = 0.0f;
+    last_time_ = 0.0f;
     call_count_ = 0;
 }
 
@@ -37,6 +51,51 @@ float SystemTimer::getMaxMs() const {
     return max_time_;
 }
 
+uint32_t FrameTimeHistogram::bucketFor(uint64_t micros) {
+    if (micros < SUB_BUCKETS) return static_cast<uint32_t>(micros);
+    // Shift so the value lands in [SUB_BUCKETS / 2, SUB_BUCKETS); the shift is the magnitude
+    uint32_t magnitude = 0;
+    while ((micros >> magnitude) >= SUB_BUCKETS) ++magnitude;
+    if (magnitude >= MAX_MAGNITUDE) return BUCKET_COUNT - 1;
+    uint32_t sub = static_cast<uint32_t>(micros >> magnitude) - SUB_BUCKETS / 2;
+    return SUB_BUCKETS + (magnitude - 1) * (SUB_BUCKETS / 2) + sub;
+}
+
+uint64_t FrameTimeHistogram::bucketUpperMicros(uint32_t bucket) {
+    if (bucket < SUB_BUCKETS) return bucket + 1;
+    uint32_t offset = bucket - SUB_BUCKETS;
+    uint32_t magnitude = offset / (SUB_BUCKETS / 2) + 1;
+    uint64_t sub = offset % (SUB_BUCKETS / 2) + SUB_BUCKETS / 2;
+    return (sub + 1) << magnitude;
+}
+
+void FrameTimeHistogram::record(float seconds) {
+    uint64_t micros = static_cast<uint64_t>(std::max(seconds, 0.0f) * 1.0e6f);
+    counts_[bucketFor(micros)]++;
+    total_count_++;
+}
+
+float FrameTimeHistogram::getPercentileMs(float percentile) const {
+    if (total_count_ == 0) return 0.0f;
+    float clamped = std::clamp(percentile, 0.0f, 100.0f);
+    uint64_t target = static_cast<uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(total_count_)));
+    target = std::max<uint64_t>(target, 1);
+
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts_[i];
+        if (seen >= target) {
+            return static_cast<float>(bucketUpperMicros(i)) / 1000.0f;
+        }
+    }
+    return static_cast<float>(bucketUpperMicros(BUCKET_COUNT - 1)) / 1000.0f;
+}
+
+void FrameTimeHistogram::reset() {
+    std::fill(std::begin(counts_), std::end(counts_), 0u);
+    total_count_ = 0;
+}
+
 AdvancedFrameStats::AdvancedFrameStats() {
     frame_history_.resize(HISTORY_SIZE, 0.0f);
 }
@@ -49,6 +108,8 @@ void PerformanceMonitorSystem::update(float deltaTime) {
     }
 
     stats_.frame_count_++;
+    stats_.histogram_.record(deltaTime);
+    MemoryTracker::getInstance().sampleFrame();
     
     // Rolling average
     stats_.frame_history_[stats_.history_index_] = deltaTime;
@@ -72,6 +133,7 @@ void PerformanceMonitorSystem::update(float deltaTime) {
     if (deltaTime > AdvancedFrameStats::CRITICAL_THRESHOLD) {
         stats_.budget_critical_++;
         stats_.performance_warning_active_ = true;
+        recordHitch(deltaTime);
         std::cout << "CRITICAL: Frame time " << (deltaTime * 1000.0f) << "ms exceeded " 
                   << (AdvancedFrameStats::CRITICAL_THRESHOLD * 1000.0f) << "ms budget!" << std::endl;
     } else if (deltaTime > AdvancedFrameStats::WARNING_THRESHOLD) {
@@ -88,10 +150,103 @@ void PerformanceMonitorSystem::update(float deltaTime) {
     }
 }
 
+void PerformanceMonitorSystem::recordHitch(float deltaTime) {
+    HitchRecord hitch;
+    hitch.frame_ = stats_.frame_count_;
+    hitch.profiler_frame_ = Profiler::getInstance().getFrameIndex();
+    hitch.frame_time_ms_ = deltaTime * 1000.0f;
+    for (const SystemTimer* timer : {&stats_.collision_timer_, &stats_.rendering_timer_, &stats_.input_timer_,
+                                     &stats_.ui_timer_, &stats_.physics_timer_}) {
+        hitch.system_ms_.emplace_back(timer->name_, timer->last_time_);
+    }
+
+    stats_.hitch_count_++;
+    hitch_log_.write(hitch);
+    stats_.hitches_.push_back(std::move(hitch));
+    if (stats_.hitches_.size() > AdvancedFrameStats::MAX_HITCH_RECORDS) {
+        stats_.hitches_.pop_front();
+    }
+}
+
+// HitchLogWriter
+HitchLogWriter::HitchLogWriter(const char* path, long maxBytes) : path_(path), max_bytes_(maxBytes) {}
+
+HitchLogWriter::~HitchLogWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void HitchLogWriter::write(const HitchRecord& hitch) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(hitch);
+        if (!running_) {
+            running_ = true;
+            thread_ = std::thread(&HitchLogWriter::writerLoop, this);
+        }
+    }
+    wake_.notify_one();
+}
+
+void HitchLogWriter::writerLoop() {
+    Profiler::getInstance().setThreadName("Hitch Log");
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [this] { return !queue_.empty() || !running_; });
+        if (queue_.empty()) return;   // Stopping with nothing left to write
+        writing_.swap(queue_);
+        lock.unlock();
+        append(writing_);
+        writing_.clear();
+        lock.lock();
+    }
+}
+
+void HitchLogWriter::append(const std::vector<HitchRecord>& hitches) {
+    if (size_ < 0) {
+        std::ifstream existing(path_, std::ios::binary | std::ios::ate);
+        size_ = existing ? static_cast<long>(existing.tellg()) : 0;
+    }
+
+    std::ofstream log;
+    std::ostringstream line;
+    for (const HitchRecord& hitch : hitches) {
+        // Rolling log: once it passes the size cap, the current file becomes .1 and a new one starts
+        if (size_ > max_bytes_) {
+            log.close();
+            std::string rotated = path_ + ".1";
+            std::remove(rotated.c_str());
+            std::rename(path_.c_str(), rotated.c_str());
+            size_ = 0;
+        }
+        if (!log.is_open()) {
+            log.open(path_, std::ios::app);
+            if (!log) return;
+        }
+
+        line.str("");
+        line << "frame " << hitch.frame_ << " (profiler frame " << hitch.profiler_frame_ << "): "
+             << hitch.frame_time_ms_ << "ms";
+        for (const auto& [name, ms] : hitch.system_ms_) {
+            line << " | " << name << " " << ms << "ms";
+        }
+        line << "\n";
+        std::string text = line.str();
+        log << text;
+        size_ += static_cast<long>(text.size());
+    }
+}
+
 void PerformanceMonitorSystem::renderOverlay(int x, int y) {
     // **PERFORMANCE WINDOW**
     int perfWidth = 380;
-    int perfHeight = stats_.show_detailed_stats_ ? 180 : 100;
+    int perfHeight = stats_.show_detailed_stats_ ? 239 + 12 * (MEMORY_TAG_COUNT + RENDER_PASS_COUNT + 1) : 100;
     
     DrawRectangle(x, y, perfWidth, perfHeight, Fade(DARKGREEN, 0.8f));
     DrawRectangleLines(x, y, perfWidth, perfHeight, LIME);
@@ -104,7 +259,8 @@ void PerformanceMonitorSystem::renderOverlay(int x, int y) {
     float currentFPS = 1.0f / stats_.average_frame_time_;
     Color fpsColor = (currentFPS >= 55.0f) ? GREEN : ((currentFPS >= 45.0f) ? YELLOW : RED);
     
-    DrawText(TextFormat("FPS: %.1f | Frame: %.2fms", currentFPS, avgMs), x + 10, y + 25, 12, fpsColor);
+    DrawText(TextFormat("FPS: %.1f | Frame: %.2fms | p99: %.2fms", currentFPS, avgMs,
+                        stats_.histogram_.getPercentileMs(99.0f)), x + 10, y + 25, 12, fpsColor);
     
     // **PERFORMANCE STATUS**
     if (stats_.performance_warning_active_) {
@@ -153,6 +309,43 @@ void PerformanceMonitorSystem::renderOverlay(int x, int y) {
         DrawText(TextFormat("Physics: %.2fms (%.1f calls)", 
                  stats_.physics_timer_.getAverageMs(), static_cast<float>(stats_.physics_timer_.call_count_)), 
                  x + 10, detailY, 10, WHITE);
+        detailY += 17;
+
+        // **MEMORY** - Per-subsystem heap use; red rows allocated past the per-frame alarm
+        const MemoryTracker& memory = MemoryTracker::getInstance();
+        DrawText(MemoryTracker::hooksInstalled() ? "--- MEMORY (cur / peak / allocs per frame) ---"
+                                                 : "--- MEMORY (pmr only, no new hooks) ---",
+                 x + 10, detailY, 12, memory.isAlarmActive() ? RED : YELLOW);
+        detailY += 15;
+        for (int t = 0; t < MEMORY_TAG_COUNT; t++) {
+            MemoryTag tag = static_cast<MemoryTag>(t);
+            const MemoryTracker::TagStats& m = memory.getStats(tag);
+            bool alarm = tag != MemoryTag::UNTAGGED &&
+                         m.frameAllocations > static_cast<uint32_t>(MemoryConstants::FRAME_ALLOC_ALARM);
+            DrawText(TextFormat("%-11s %7.2fMB / %7.2fMB  %4u (%5.1fKB)", MemoryTracker::getTagName(tag),
+                                m.currentBytes / (1024.0 * 1024.0), m.peakBytes / (1024.0 * 1024.0),
+                                m.frameAllocations, m.frameBytes / 1024.0),
+                     x + 10, detailY, 10, alarm ? RED : WHITE);
+            detailY += 12;
+        }
+        const FrameArena& arena = FrameArena::getInstance();
+        DrawText(TextFormat("Frame arena %6.1fKB / %6.1fKB peak  %d block(s)", arena.getUsedBytes() / 1024.0,
+                            arena.getPeakBytes() / 1024.0, arena.getBlockCount()),
+                 x + 10, detailY, 10, arena.getBlockCount() > 1 ? YELLOW : WHITE);
+        detailY += 15;
+
+        // **RENDER** - What each pass sent to rlgl last frame; binds are where its batch flushed
+        const RenderStats& render = RenderStats::getInstance();
+        DrawText("--- RENDER (draws / verts / tex / shader binds) ---", x + 10, detailY, 12, YELLOW);
+        detailY += 15;
+        for (int p = 0; p <= RENDER_PASS_COUNT; p++) {
+            bool total = p == RENDER_PASS_COUNT;
+            RenderPassStats r = total ? render.getTotal() : render.getPass(static_cast<RenderPass>(p));
+            DrawText(TextFormat("%-12s %5u  %8u  %4u  %4u", total ? "Total" : RenderStats::getPassName(static_cast<RenderPass>(p)),
+                                r.draws, r.vertices, r.textureBinds, r.shaderBinds),
+                     x + 10, detailY, 10, total ? LIME : WHITE);
+            detailY += 12;
+        }
     }
     
     // **CONTROLS**
@@ -168,6 +361,9 @@ void PerformanceMonitorSystem::reset() {
     stats_.budget_critical_ = 0;
     stats_.worst_frame_time_ = 0.0f;
     stats_.performance_warning_active_ = false;
+    stats_.histogram_.reset();
+    stats_.hitches_.clear();
+    stats_.hitch_count_ = 0;
     
     // Reset system timers
     stats_.collision_timer_.reset();
@@ -191,15 +387,32 @@ std::string PerformanceMonitorSystem::getReport() const {
     float avgMs = stats_.average_frame_time_ * 1000.0f;
     float targetMs = AdvancedFrameStats::TARGET_FRAME_TIME * 1000.0f;
     
+    std::ostringstream report;
     if (avgMs <= targetMs) {
-        return "EXCELLENT - Meeting 60fps target";
+        report << "EXCELLENT - Meeting 60fps target";
     } else if (avgMs <= targetMs * 1.2f) {
-        return "GOOD - Minor frame time variance";
+        report << "GOOD - Minor frame time variance";
     } else if (avgMs <= targetMs * 1.5f) {
-        return "ACCEPTABLE - Some performance issues";
+        report << "ACCEPTABLE - Some performance issues";
     } else {
-        return "POOR - Significant performance problems";
+        report << "POOR - Significant performance problems";
     }
+
+    // Averages hide hitches; the tail percentiles are what players feel
+    const FrameTimeHistogram& h = stats_.histogram_;
+    char percentiles[128];
+    std::snprintf(percentiles, sizeof(percentiles), " | p50 %.2fms p95 %.2fms p99 %.2fms p99.9 %.2fms",
+                  h.getPercentileMs(50.0f), h.getPercentileMs(95.0f), h.getPercentileMs(99.0f), h.getPercentileMs(99.9f));
+    report << percentiles << " | hitches " << stats_.hitch_count_;
+
+    if (!stats_.hitches_.empty()) {
+        const HitchRecord& last = stats_.hitches_.back();
+        report << " | last hitch frame " << last.frame_ << " " << last.frame_time_ms_ << "ms:";
+        for (const auto& [name, ms] : last.system_ms_) {
+            report << " " << name << " " << ms << "ms";
+        }
+    }
+    return report.str();
 }
 
 void PerformanceMonitorSystem::logWarnings() const {
@@ -214,10 +427,55 @@ void PerformanceMonitorSystem::logWarnings() const {
     }
 }
 
+bool PerformanceMonitorSystem::exportJson(const std::string& path,
+                                          const std::vector<std::pair<std::string, double>>& metadata) const {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        std::cout << "PERFORMANCE: Cannot write " << path << std::endl;
+        return false;
+    }
+
+    const FrameTimeHistogram& h = stats_.histogram_;
+    out << "{\n";
+    for (const auto& [key, value] : metadata) {
+        out << "  \"" << key << "\": " << value << ",\n";
+    }
+    out << "  \"frames\": " << stats_.frame_count_ << ",\n"
+        << "  \"avg_ms\": " << stats_.average_frame_time_ * 1000.0f << ",\n"
+        << "  \"min_ms\": " << (stats_.frame_count_ > 0 ? stats_.min_frame_time_ * 1000.0f : 0.0f) << ",\n"
+        << "  \"max_ms\": " << stats_.max_frame_time_ * 1000.0f << ",\n"
+        << "  \"p50_ms\": " << h.getPercentileMs(50.0f) << ",\n"
+        << "  \"p95_ms\": " << h.getPercentileMs(95.0f) << ",\n"
+        << "  \"p99_ms\": " << h.getPercentileMs(99.0f) << ",\n"
+        << "  \"p999_ms\": " << h.getPercentileMs(99.9f) << ",\n"
+        << "  \"budget_warnings\": " << stats_.budget_warnings_ << ",\n"
+        << "  \"budget_critical\": " << stats_.budget_critical_ << ",\n"
+        << "  \"hitches\": " << stats_.hitch_count_ << ",\n"
+        << "  \"timers\": {";
+
+    bool first = true;
+    for (const SystemTimer* timer : {&stats_.collision_timer_, &stats_.rendering_timer_, &stats_.input_timer_,
+                                     &stats_.ui_timer_, &stats_.physics_timer_}) {
+        out << (first ? "\n" : ",\n") << "    \"" << timer->name_ << "\": {\"avg_ms\": " << timer->getAverageMs()
+            << ", \"max_ms\": " << timer->getMaxMs() << ", \"calls\": " << timer->call_count_ << "}";
+        first = false;
+    }
+    out << "\n  }\n}\n";
+    return static_cast<bool>(out);
+}
+
 const AdvancedFrameStats& PerformanceMonitorSystem::getStats() const {
     return stats_;
 }
 
+AdvancedFrameStats& PerformanceMonitorSystem::getStats() {
+    return stats_;
+}
+
+const std::deque<HitchRecord>& PerformanceMonitorSystem::getHitches() const {
+    return stats_.hitches_;
+}
+
 void PerformanceMonitorSystem::toggleDetailedStats() {
     stats_.show_detailed_stats_ = !stats_.show_detailed_stats_;
 }
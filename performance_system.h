@@ -3,19 +3,28 @@
 
 #include "raylib.h"
 #include <float.h>  // For FLT_MAX
+#include <cstdint>
+#include <deque>
 #include <vector>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <memory>   // For smart pointers if needed
+#include "profiler.h"
 
 /// \brief Timer for individual systems.
-/// Tracks timing for specific systems with average and max times.
+/// Tracks timing for specific systems with average and max times; each start/end pair is
+/// also recorded as a profiler scope under the timer's name.
 struct SystemTimer {
-    std::chrono::high_resolution_clock::time_point start_time_;
+    uint64_t start_ns_ = 0;
     float total_time_ = 0.0f;
     float max_time_ = 0.0f;
+    float last_time_ = 0.0f;  // Most recent start/end pair, for hitch snapshots
     int call_count_ = 0;
     std::string name_;
+    const char* profile_name_;  // Interned copy of name_ for profiler events
     
     /// \brief Constructor.
     /// \param timerName Name of the timer.
@@ -39,6 +48,78 @@ struct SystemTimer {
     float getMaxMs() const;
 };
 
+/// \brief Log-linear frame-time histogram (HDR-style): fixed memory, about 1.5% relative error.
+///
+/// Values are recorded in microseconds. Below SUB_BUCKETS each microsecond has its own bucket;
+/// above, every power of two is split into SUB_BUCKETS / 2 equal buckets, so resolution scales
+/// with the value and percentiles stay accurate from sub-millisecond frames to multi-second stalls.
+struct FrameTimeHistogram {
+    static constexpr uint32_t SUB_BUCKETS = 128;
+    static constexpr uint32_t MAX_MAGNITUDE = 18;  // 128us << 17 covers ~16s
+    static constexpr uint32_t BUCKET_COUNT = SUB_BUCKETS + (MAX_MAGNITUDE - 1) * (SUB_BUCKETS / 2);
+
+    uint32_t counts_[BUCKET_COUNT] = {};
+    uint64_t total_count_ = 0;
+
+    /// \brief Records one frame.
+    /// \param seconds Frame time in seconds.
+    void record(float seconds);
+
+    /// \brief Gets the frame time at or below which `percentile` of frames fall.
+    /// \param percentile In [0, 100].
+    /// \return Upper edge of the matching bucket, in milliseconds; 0 when empty.
+    float getPercentileMs(float percentile) const;
+
+    /// \brief Clears all counts.
+    void reset();
+
+    static uint32_t bucketFor(uint64_t micros);
+    static uint64_t bucketUpperMicros(uint32_t bucket);
+};
+
+/// \brief Per-system breakdown captured when a frame exceeds CRITICAL_THRESHOLD.
+struct HitchRecord {
+    int frame_ = 0;
+    uint32_t profiler_frame_ = 0;    // Matches the "frame" arg of events in an exported trace
+    float frame_time_ms_ = 0.0f;
+    std::vector<std::pair<std::string, float>> system_ms_;  // Timer name -> last measured ms
+};
+
+/// \brief Appends hitch records to the rolling hitch log on a background thread.
+///
+/// Hitch frames are already over budget, so they only copy the record into a queue; the
+/// writer thread, started by the first record, does the size check, rotation and append.
+/// Records still queued at destruction are written before the thread is joined.
+class HitchLogWriter {
+public:
+    /// \brief Constructor.
+    /// \param path Log file; rotated to path + ".1" once it passes maxBytes.
+    /// \param maxBytes Size cap.
+    HitchLogWriter(const char* path, long maxBytes);
+    ~HitchLogWriter();
+
+    HitchLogWriter(const HitchLogWriter&) = delete;
+    HitchLogWriter& operator=(const HitchLogWriter&) = delete;
+
+    /// \brief Queues a record for the log. Never touches the file.
+    void write(const HitchRecord& hitch);
+
+private:
+    void writerLoop();
+    void append(const std::vector<HitchRecord>& hitches);
+
+    std::string path_;
+    long max_bytes_;
+    long size_ = -1;                        // Writer thread; -1 until the file has been measured
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<HitchRecord> queue_;        // Guarded by mutex_
+    std::vector<HitchRecord> writing_;      // Writer thread
+    bool running_ = false;                  // Guarded by mutex_
+    std::thread thread_;
+};
+
 /// \brief Advanced frame statistics.
 struct AdvancedFrameStats {
     // Basic frame timing
@@ -60,6 +141,14 @@ struct AdvancedFrameStats {
     std::vector<float> frame_history_;
     static constexpr int HISTORY_SIZE = 60;  // 1 second at 60fps
     int history_index_ = 0;
+
+    // Whole-session distribution and recent hitches
+    FrameTimeHistogram histogram_;
+    std::deque<HitchRecord> hitches_;
+    static constexpr size_t MAX_HITCH_RECORDS = 32;
+    int hitch_count_ = 0;
+    static constexpr const char* HITCH_LOG_PATH = "performance_hitches.log";
+    static constexpr long HITCH_LOG_MAX_BYTES = 256 * 1024;  // Rotated to .1 past this
     
     // System-specific performance tracking
     SystemTimer collision_timer_{"Collision"};
@@ -99,23 +188,41 @@ public:
     /// \return True if good.
     bool isGood() const;
 
-    /// \brief Gets performance report string.
+    /// \brief Gets performance report string: rating, percentiles and hitch count.
     /// \return Report string.
     std::string getReport() const;
 
     /// \brief Logs any warnings.
     void logWarnings() const;
 
+    /// \brief Writes frame statistics, percentiles, hitches and timers as JSON.
+    /// \param path Output file.
+    /// \param metadata Extra top-level numeric fields (frame count, object count, ...).
+    /// \return True on success.
+    bool exportJson(const std::string& path, const std::vector<std::pair<std::string, double>>& metadata = {}) const;
+
     // Accessors
     /// \brief Gets stats reference.
     /// \return Stats.
     const AdvancedFrameStats& getStats() const;
 
+    /// \brief Gets mutable stats, so PROFILE_SYSTEM can reach the timers.
+    /// \return Stats.
+    AdvancedFrameStats& getStats();
+
+    /// \brief Gets recorded hitches, oldest first.
+    /// \return Hitch records.
+    const std::deque<HitchRecord>& getHitches() const;
+
     /// \brief Toggles detailed stats display.
     void toggleDetailedStats();
 
 private:
     AdvancedFrameStats stats_;
+    HitchLogWriter hitch_log_{AdvancedFrameStats::HITCH_LOG_PATH, AdvancedFrameStats::HITCH_LOG_MAX_BYTES};
+
+    /// \brief Captures the timer breakdown for a hitch frame and queues it for the hitch log.
+    void recordHitch(float deltaTime);
 };
 
 /// \brief Scoped timer for RAII timing.
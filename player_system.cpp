@@ -3,10 +3,12 @@
 #include "constants.h"
 #include "raylib.h"
 #include "raymath.h"  // For Vector3Subtract, Vector3Add, Vector3Normalize, Vector3CrossProduct, Vector3Scale
-#include "math_utils.h"  // For MathUtils::distance3D
-#include <iostream>  // For std::cout debug output
+#include "math_utils.h"  // For MathUtils::distanceSquared3D
+#include "async_log.h"  // For BW_LOG
+#include "performance_system.h"  // For SystemTimer
 
-void updatePlayer(Camera3D& camera, GameState& state, const EnvironmentManager& environment, float deltaTime) {
+void updatePlayer(Camera3D& camera, GameState& state, const EnvironmentManager& environment, float deltaTime,
+                  SystemTimer* collisionTimer) {
     const float gravity = PlayerConstants::GRAVITY;
     const float jump_strength = PlayerConstants::JUMP_STRENGTH;
     const float ground_level = PlayerConstants::GROUND_LEVEL;
@@ -15,38 +17,37 @@ void updatePlayer(Camera3D& camera, GameState& state, const EnvironmentManager&
     const float player_height = PlayerConstants::HEIGHT;
 
     // **JUMPING LOGIC** - Enhanced with input check and state management
-    if (!state.isInDialog && !state.showInventoryWindow && !state.showEscMenu && 
-        state.enhancedInput.isActionPressed("jump") && state.isGrounded && !state.isJumping) {
-        state.isJumping = true;
-        state.isGrounded = false;
-        state.jumpVelocity = jump_strength;
-        state.testSpaceJump = true;
-        std::cout << "Jump initiated: velocity=" << state.jumpVelocity << std::endl;
+    if (!state.dialog.active && !state.ui.showInventoryWindow && !state.ui.showEscMenu && 
+        state.enhancedInput.isActionPressed(InputActions::JUMP) && state.player.isGrounded && !state.player.isJumping) {
+        state.player.isJumping = true;
+        state.player.isGrounded = false;
+        state.player.jumpVelocity = jump_strength;
+        state.tests.spaceJump = true;
+        BW_LOG(DEBUG_PLAYER, DEBUG_DETAILED, "Jump initiated: velocity={}", state.player.jumpVelocity);
     }
 
-    if (state.isJumping || !state.isGrounded) {
-        state.jumpVelocity += gravity * deltaTime;
-        state.playerY += state.jumpVelocity * deltaTime;
+    if (state.player.isJumping || !state.player.isGrounded) {
+        state.player.jumpVelocity += gravity * deltaTime;
+        state.player.y += state.player.jumpVelocity * deltaTime;
 
-        if (state.playerY <= ground_level) {
-            state.playerY = ground_level;
-            state.isJumping = false;
-            state.isGrounded = true;
-            state.jumpVelocity = 0.0f;
-            std::cout << "Landed: y=" << state.playerY << std::endl;
+        if (state.player.y <= ground_level) {
+            state.player.y = ground_level;
+            state.player.isJumping = false;
+            state.player.isGrounded = true;
+            state.player.jumpVelocity = 0.0f;
+            BW_LOG(DEBUG_PLAYER, DEBUG_DETAILED, "Landed: y={}", state.player.y);
         }
     }
 
-    camera.position.y = state.playerY + eye_height;
+    camera.position.y = state.player.y + eye_height;
 
     // Only update camera when not in dialog mode, inventory closed, and ESC menu closed
-    if (!state.isInDialog && !state.showInventoryWindow && !state.showEscMenu) {
+    if (!state.dialog.active && !state.ui.showInventoryWindow && !state.ui.showEscMenu) {
         // Debug: Log movement state
         static int movementDebugCounter = 0;
         if (movementDebugCounter++ % 120 == 0) {  // Log every 2 seconds at 60 FPS
-            std::cout << "MOVEMENT ENABLED: Dialog=" << state.isInDialog
-                      << ", Inventory=" << state.showInventoryWindow
-                      << ", EscMenu=" << state.showEscMenu << std::endl;
+            BW_LOG(DEBUG_PLAYER, DEBUG_VERBOSE, "MOVEMENT ENABLED: Dialog={}, Inventory={}, EscMenu={}",
+                   state.dialog.active, state.ui.showInventoryWindow, state.ui.showEscMenu);
         }
         // **MANUAL MOVEMENT**: Calculate precise linear movement vectors to fix strafing curvature
         Vector3 originalPosition = camera.position;
@@ -58,7 +59,7 @@ void updatePlayer(Camera3D& camera, GameState& state, const EnvironmentManager&
         // Debug what we get from enhanced input
         static int inputDebugCounter = 0;
         if (inputDebugCounter++ % 60 == 0) {
-            std::cout << "PLAYER: Got mouse delta from input (" << mouseDelta.x << "," << mouseDelta.y << ")" << std::endl;
+            BW_LOG(DEBUG_PLAYER, DEBUG_VERBOSE, "PLAYER: Got mouse delta from input ({},{})", mouseDelta.x, mouseDelta.y);
         }
 
         // Update camera angles for smooth rotation
@@ -68,8 +69,8 @@ void updatePlayer(Camera3D& camera, GameState& state, const EnvironmentManager&
         // Debug mouse input application - more frequent
         static int mouseDebugCounter = 0;
         if (mouseDebugCounter++ % 60 == 0) {
-            std::cout << "CAMERA: Mouse delta (" << mouseDelta.x << ", " << mouseDelta.y
-                      << ") Yaw: " << yaw << " Pitch: " << pitch << std::endl;
+            BW_LOG(DEBUG_PLAYER, DEBUG_VERBOSE, "CAMERA: Mouse delta ({}, {}) Yaw: {} Pitch: {}",
+                   mouseDelta.x, mouseDelta.y, yaw, pitch);
         }
 
         yaw -= mouseDelta.x * sensitivity;
@@ -89,7 +90,7 @@ void updatePlayer(Camera3D& camera, GameState& state, const EnvironmentManager&
         // Debug camera target
         static int cameraTargetCounter = 0;
         if (cameraTargetCounter++ % 120 == 0) {
-            std::cout << "CAMERA TARGET: (" << camera.target.x << ", " << camera.target.y << ", " << camera.target.z << ")" << std::endl;
+            BW_LOG(DEBUG_PLAYER, DEBUG_VERBOSE, "CAMERA TARGET: ({}, {}, {})", camera.target.x, camera.target.y, camera.target.z);
         }
         
         // **LINEAR MOVEMENT**: Calculate precise movement vectors
@@ -109,16 +110,16 @@ void updatePlayer(Camera3D& camera, GameState& state, const EnvironmentManager&
         Vector3 movement = {0.0f, 0.0f, 0.0f};
         
         // **PHASE 2 ENHANCEMENT**: Movement input using enhanced input manager with action bindings
-        if (state.enhancedInput.isActionDown("move_forward")) {
+        if (state.enhancedInput.isActionDown(InputActions::MOVE_FORWARD)) {
             movement = Vector3Add(movement, Vector3Scale(forward, moveSpeed));
         }
-        if (state.enhancedInput.isActionDown("move_backward")) {
+        if (state.enhancedInput.isActionDown(InputActions::MOVE_BACKWARD)) {
             movement = Vector3Add(movement, Vector3Scale(forward, -moveSpeed));
         }
-        if (state.enhancedInput.isActionDown("strafe_right")) {  // Strafe right - perfectly linear
+        if (state.enhancedInput.isActionDown(InputActions::STRAFE_RIGHT)) {  // Strafe right - perfectly linear
             movement = Vector3Add(movement, Vector3Scale(right, moveSpeed));
         }
-        if (state.enhancedInput.isActionDown("strafe_left")) {  // Strafe left - perfectly linear
+        if (state.enhancedInput.isActionDown(InputActions::STRAFE_LEFT)) {  // Strafe left - perfectly linear
             movement = Vector3Add(movement, Vector3Scale(right, -moveSpeed));
         }
         
@@ -130,12 +131,14 @@ void updatePlayer(Camera3D& camera, GameState& state, const EnvironmentManager&
         if (Vector3Length(totalMovement) > 0.01f) {
             static int moveCounter = 0;
             if (++moveCounter % 30 == 0) {
-                std::cout << "Player movement: (" << totalMovement.x << ", " << totalMovement.y << ", " << totalMovement.z << ")" << std::endl;
+                BW_LOG(DEBUG_PLAYER, DEBUG_VERBOSE, "Player movement: ({}, {}, {})", totalMovement.x, totalMovement.y, totalMovement.z);
             }
         }
 
         // Apply collision detection and resolution
-        CollisionSystem::resolveCollisions(intendedPosition, originalPosition, player_radius, player_height, state.playerY, eye_height, ground_level, environment, state.isInBuilding, state.currentBuilding);
+        if (collisionTimer) collisionTimer->start();
+        CollisionSystem::resolveCollisions(intendedPosition, originalPosition, player_radius, player_height, state.player.y, eye_height, ground_level, environment, state.player.isInBuilding, state.player.currentBuilding);
+        if (collisionTimer) collisionTimer->end();
 
         // Set final camera position after collision resolution
         camera.position = intendedPosition;
@@ -144,14 +147,15 @@ void updatePlayer(Camera3D& camera, GameState& state, const EnvironmentManager&
         camera.target = Vector3Add(camera.position, viewDirection);
 
         // Update playerY based on new camera y
-        state.playerY = camera.position.y - eye_height;
+        state.player.y = camera.position.y - eye_height;
 
         // Debug: Log final position changes
         static Vector3 lastPosition = {0, 0, 0};
-        if (MathUtils::distance3D(camera.position, lastPosition) > 0.1f) {
+        if (MathUtils::distanceSquared3D(camera.position, lastPosition) > 0.1f * 0.1f) {
             static int posCounter = 0;
             if (++posCounter % 30 == 0) {
-                std::cout << "Final position: (" << camera.position.x << ", " << camera.position.y << ", " << camera.position.z << ") | In building: " << state.isInBuilding << std::endl;
+                BW_LOG(DEBUG_PLAYER, DEBUG_VERBOSE, "Final position: ({}, {}, {}) | In building: {}",
+                       camera.position.x, camera.position.y, camera.position.z, state.player.isInBuilding);
             }
             lastPosition = camera.position;
         }
@@ -5,11 +5,15 @@
 #include "game_state.h"
 #include "environment_manager.h"
 
+struct SystemTimer;
+
 /// \brief Updates the player's state including movement, jumping, and collisions.
 /// \param camera The camera to update.
 /// \param state The game state.
 /// \param environment The environment manager.
 /// \param deltaTime Time since last frame.
-void updatePlayer(Camera3D& camera, GameState& state, const EnvironmentManager& environment, float deltaTime);
+/// \param collisionTimer Times collision resolution when set.
+void updatePlayer(Camera3D& camera, GameState& state, const EnvironmentManager& environment, float deltaTime,
+                  SystemTimer* collisionTimer = nullptr);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    thread_local uint32_t t_depth = 0;
+
+    void writeEscaped(std::ostream& out, const char* text) {
+        for (const char* c = text; *c; ++c) {
+            if (*c == '"' || *c == '\\') out << '\\';
+            out << *c;
+        }
+    }
+}
+
+uint64_t Profiler::now() {
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch).count());
+}
+
+uint32_t& Profiler::threadDepth() {
+    return t_depth;
+}
+
+void Profiler::beginFrame() {
+    uint64_t nowNs = now();
+    if (frame_open_ && isEnabled()) {
+        record("Frame", frame_start_ns_, nowNs, 0);
+    }
+    frame_start_ns_ = nowNs;
+    frame_open_ = true;
+    frame_index_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    ThreadBuffer& buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    buffer.thread_name = name;
+}
+
+const char* Profiler::intern(const std::string& name) {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    return interned_.insert(name).first->c_str();
+}
+
+Profiler::ThreadBuffer& Profiler::localBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        auto created = std::make_unique<ThreadBuffer>();
+        created->events = std::make_unique<EventSlot[]>(RING_CAPACITY);
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        created->thread_id = static_cast<uint32_t>(buffers_.size());
+        created->thread_name = "Thread " + std::to_string(created->thread_id);
+        buffer = created.get();
+        buffers_.push_back(std::move(created));  // Kept after the thread exits so its events still export
+    }
+    return *buffer;
+}
+
+void Profiler::record(const char* name, uint64_t startNs, uint64_t endNs, uint32_t depth) {
+    ThreadBuffer& buffer = localBuffer();
+    uint64_t written = buffer.written.load(std::memory_order_relaxed);
+    // Seqlock writer: announce the overwrite before touching the slot, publish after
+    buffer.claimed.store(written + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    EventSlot& event = buffer.events[written % RING_CAPACITY];
+    event.name.store(name, std::memory_order_relaxed);
+    event.start_ns.store(startNs, std::memory_order_relaxed);
+    event.end_ns.store(endNs, std::memory_order_relaxed);
+    event.depth.store(depth, std::memory_order_relaxed);
+    event.frame.store(frame_index_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    buffer.written.store(written + 1, std::memory_order_release);
+}
+
+void Profiler::recordCounter(const ProfileCounter& counter) {
+    if (!isEnabled()) return;
+    if (counters_.empty()) counters_.resize(COUNTER_CAPACITY);
+    ProfileCounter& slot = counters_[counters_written_ % COUNTER_CAPACITY];
+    slot = counter;
+    if (slot.series_count > ProfileCounter::MAX_SERIES) slot.series_count = ProfileCounter::MAX_SERIES;
+    ++counters_written_;
+}
+
+bool Profiler::exportChromeTrace(const std::string& path) const {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        std::cout << "PROFILER: Cannot write " << path << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    size_t eventCount = 0;
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) out << ",\n";
+        first = false;
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    char timing[64];
+    for (const auto& buffer : buffers_) {
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread_id
+            << ",\"args\":{\"name\":\"";
+        writeEscaped(out, buffer->thread_name.c_str());
+        out << "\"}}";
+
+        // Copy the ring, then drop whatever the owner started overwriting while we copied
+        uint64_t written = buffer->written.load(std::memory_order_acquire);
+        uint64_t begin = written > RING_CAPACITY ? written - RING_CAPACITY : 0;
+        export_scratch_.clear();
+        for (uint64_t i = begin; i < written; ++i) {
+            const EventSlot& slot = buffer->events[i % RING_CAPACITY];
+            export_scratch_.push_back({slot.name.load(std::memory_order_relaxed),
+                                       slot.start_ns.load(std::memory_order_relaxed),
+                                       slot.end_ns.load(std::memory_order_relaxed),
+                                       slot.depth.load(std::memory_order_relaxed),
+                                       slot.frame.load(std::memory_order_relaxed)});
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t claimed = buffer->claimed.load(std::memory_order_relaxed);
+        uint64_t valid = claimed > RING_CAPACITY ? claimed - RING_CAPACITY : 0;
+        size_t skip = valid > begin ? static_cast<size_t>(std::min<uint64_t>(valid - begin, export_scratch_.size())) : 0;
+
+        for (size_t e = skip; e < export_scratch_.size(); ++e) {
+            const ProfileEvent& event = export_scratch_[e];
+            separator();
+            // Complete events in microseconds; viewers rebuild nesting from the intervals
+            std::snprintf(timing, sizeof(timing), "\"ts\":%.3f,\"dur\":%.3f",
+                          event.start_ns / 1000.0, (event.end_ns - event.start_ns) / 1000.0);
+            out << "{\"name\":\"";
+            writeEscaped(out, event.name);
+            out << "\",\"cat\":\"browserwind\",\"ph\":\"X\"," << timing
+                << ",\"pid\":1,\"tid\":" << buffer->thread_id
+                << ",\"args\":{\"frame\":" << event.frame << ",\"depth\":" << event.depth << "}}";
+            ++eventCount;
+        }
+    }
+
+    // Counter tracks; viewers draw each track's series stacked over time
+    uint64_t counterBegin = counters_written_ > COUNTER_CAPACITY ? counters_written_ - COUNTER_CAPACITY : 0;
+    for (uint64_t i = counterBegin; i < counters_written_; ++i) {
+        const ProfileCounter& counter = counters_[i % COUNTER_CAPACITY];
+        separator();
+        std::snprintf(timing, sizeof(timing), "\"ts\":%.3f", counter.time_ns / 1000.0);
+        out << "{\"name\":\"";
+        writeEscaped(out, counter.name);
+        out << "\",\"cat\":\"browserwind\",\"ph\":\"C\"," << timing << ",\"pid\":1,\"args\":{";
+        for (uint32_t s = 0; s < counter.series_count; ++s) {
+            out << (s ? ",\"" : "\"");
+            writeEscaped(out, counter.series[s]);
+            out << "\":" << counter.values[s];
+        }
+        out << "}}";
+    }
+    out << "\n]}\n";
+
+    std::cout << "PROFILER: Wrote " << eventCount << " events from " << buffers_.size() << " threads and "
+              << (counters_written_ - counterBegin) << " counter samples to " << path << std::endl;
+    return static_cast<bool>(out);
+}
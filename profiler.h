@@ -0,0 +1,156 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/// \brief One completed profiler scope.
+struct ProfileEvent {
+    const char* name = nullptr;   // Static or interned; never owned
+    uint64_t start_ns = 0;        // Since the profiler epoch
+    uint64_t end_ns = 0;
+    uint32_t depth = 0;           // Nesting level on its thread
+    uint32_t frame = 0;           // Frame index when the scope closed
+};
+
+/// \brief One sample of a counter track: up to MAX_SERIES named values at one instant.
+struct ProfileCounter {
+    static constexpr int MAX_SERIES = 4;
+    const char* name = nullptr;                  // Track name; static or interned
+    uint64_t time_ns = 0;
+    const char* series[MAX_SERIES] = {};         // Static or interned
+    double values[MAX_SERIES] = {};
+    uint32_t series_count = 0;
+};
+
+/// \brief Hierarchical frame profiler with per-thread ring buffers.
+///
+/// Scopes are pushed by the thread that closes them into that thread's own ring, so
+/// recording takes no lock and never allocates after the first scope on a thread. Old events
+/// are overwritten once a ring is full; exports cover the most recent RING_CAPACITY scopes
+/// per thread. Rings are read like a seqlock, so exporting while background threads (the
+/// save writer, path searches) keep recording drops the few slots they overwrote mid-copy
+/// instead of tearing them. Timestamps come from steady_clock.
+class Profiler {
+public:
+    static constexpr size_t RING_CAPACITY = 1 << 15;  // Events kept per thread
+    static constexpr size_t COUNTER_CAPACITY = 1 << 14;  // Counter samples kept
+    static constexpr const char* TRACE_PATH = "profile_trace.json";
+
+    static Profiler& getInstance() {
+        static Profiler instance;
+        return instance;
+    }
+
+    /// \brief Gets nanoseconds since the profiler was created.
+    static uint64_t now();
+
+    /// \brief Marks a frame boundary; closes the previous "Frame" scope on this thread.
+    void beginFrame();
+
+    /// \brief Gets index of the current frame.
+    uint32_t getFrameIndex() const { return frame_index_.load(std::memory_order_relaxed); }
+
+    /// \brief Enables or disables recording; disabled scopes cost one atomic load.
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /// \brief Names the calling thread in exported traces.
+    void setThreadName(const std::string& name);
+
+    /// \brief Returns a pointer to a stable copy of `name`, for scopes with runtime names.
+    const char* intern(const std::string& name);
+
+    /// \brief Records a finished scope on the calling thread.
+    void record(const char* name, uint64_t startNs, uint64_t endNs, uint32_t depth);
+
+    /// \brief Records a counter sample (stacked values under one track). Main thread only.
+    void recordCounter(const ProfileCounter& counter);
+
+    /// \brief Writes recorded scopes and counters as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+    /// Main thread, between frames; other threads may keep recording.
+    /// \param path Output file.
+    /// \return True on success.
+    bool exportChromeTrace(const std::string& path = TRACE_PATH) const;
+
+    /// \brief Per-thread nesting depth, maintained by ProfileScope.
+    static uint32_t& threadDepth();
+
+private:
+    // Ring slot; fields are relaxed atomics so the exporter can copy them while the owner writes
+    struct EventSlot {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> start_ns{0};
+        std::atomic<uint64_t> end_ns{0};
+        std::atomic<uint32_t> depth{0};
+        std::atomic<uint32_t> frame{0};
+    };
+
+    struct ThreadBuffer {
+        std::unique_ptr<EventSlot[]> events;
+        std::atomic<uint64_t> written{0};  // Total ever written; ring index is written % capacity
+        std::atomic<uint64_t> claimed{0};  // Bumped before a slot is overwritten; written lags it mid-write
+        uint32_t thread_id = 0;
+        std::string thread_name;
+    };
+
+    Profiler() = default;
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    ThreadBuffer& localBuffer();
+
+    std::atomic<bool> enabled_{true};
+    std::atomic<uint32_t> frame_index_{0};
+    uint64_t frame_start_ns_ = 0;        // Main thread only
+    bool frame_open_ = false;
+    mutable std::mutex registry_mutex_;  // Guards buffers_ and interned_ membership, not event writes
+    mutable std::vector<ProfileEvent> export_scratch_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    std::unordered_set<std::string> interned_;
+    std::vector<ProfileCounter> counters_;  // Main-thread ring, sized on first sample
+    uint64_t counters_written_ = 0;
+};
+
+/// \brief RAII scope: records [construction, destruction) under `name` on the calling thread.
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : name_(name) {
+        if (!Profiler::getInstance().isEnabled()) {
+            name_ = nullptr;
+            return;
+        }
+        depth_ = Profiler::threadDepth()++;
+        start_ns_ = Profiler::now();
+    }
+
+    ~ProfileScope() {
+        if (!name_) return;
+        Profiler::threadDepth()--;
+        Profiler::getInstance().record(name_, start_ns_, Profiler::now(), depth_);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name_;
+    uint64_t start_ns_ = 0;
+    uint32_t depth_ = 0;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+/// Times the rest of the enclosing block. `name` must be a string literal or interned.
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(_profileScope, __LINE__)(name)
+
+/// Times the rest of the enclosing function under its own name.
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+
+#endif
@@ -0,0 +1,85 @@
+// quality_scaler.cpp
+#include "quality_scaler.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+QualityScaler::QualityScaler()
+    : window_(QualityConstants::WINDOW_FRAMES, 0.0f), scratch_(QualityConstants::WINDOW_FRAMES, 0.0f),
+      settings_(settingsFor(0)) {}
+
+bool QualityScaler::update(float frameTime) {
+    window_[window_index_] = frameTime;
+    window_index_ = (window_index_ + 1) % window_.size();
+    window_count_ = std::min(window_count_ + 1, window_.size());
+    since_raise_ += frameTime;
+    if (raised_ && since_raise_ > QualityConstants::PROBE_TIME) {
+        raised_ = false;    // The raised level held
+    }
+    if (window_count_ < window_.size()) return false;
+
+    std::copy(window_.begin(), window_.end(), scratch_.begin());
+    size_t rank = static_cast<size_t>(QualityConstants::PERCENTILE / 100.0f * (scratch_.size() - 1));
+    std::nth_element(scratch_.begin(), scratch_.begin() + rank, scratch_.end());
+    float percentile = scratch_[rank];
+    percentile_ms_ = percentile * 1000.0f;
+
+    if (percentile > target_frame_time_ * QualityConstants::DOWNSHIFT_RATIO) {
+        good_time_ = 0.0f;
+        if (level_ + 1 >= QualityConstants::LEVEL_COUNT) return false;
+        if (raised_) {
+            // The level just raised to can't hold: back off before probing again
+            upshift_delay_ = std::min(upshift_delay_ * 2.0f, QualityConstants::MAX_UPSHIFT_DELAY);
+            raised_ = false;
+        }
+        setLevel(level_ + 1, "over budget");
+        return true;
+    }
+
+    if (percentile <= target_frame_time_ * QualityConstants::UPSHIFT_RATIO) {
+        good_time_ += frameTime;
+        if (level_ > 0 && good_time_ >= upshift_delay_) {
+            raised_ = true;
+            since_raise_ = 0.0f;
+            setLevel(level_ - 1, "headroom");
+            return true;
+        }
+    } else {
+        good_time_ = 0.0f;  // Between the thresholds: hold
+    }
+    return false;
+}
+
+QualitySettings QualityScaler::settingsFor(int level) {
+    level = std::clamp(level, 0, QualityConstants::LEVEL_COUNT - 1);
+    float t = static_cast<float>(level) / static_cast<float>(QualityConstants::LEVEL_COUNT - 1);
+    auto lerp = [t](float high, float low) { return high + (low - high) * t; };
+
+    QualitySettings settings;
+    settings.lodDistance = lerp(RenderConstants::LOD_MAX_DISTANCE, QualityConstants::MIN_LOD_DISTANCE);
+    settings.cullDistance = lerp(RenderConstants::LOD_MAX_DISTANCE, QualityConstants::MIN_CULL_DISTANCE);
+    settings.particleBudget = static_cast<int>(std::lround(lerp(static_cast<float>(ParticleConstants::MAX_PER_TYPE),
+                                                                static_cast<float>(QualityConstants::MIN_PARTICLE_BUDGET))));
+    settings.npcIntervalScale = static_cast<int>(std::lround(lerp(1.0f, static_cast<float>(QualityConstants::MAX_NPC_INTERVAL_SCALE))));
+    settings.uiRefreshInterval = lerp(0.0f, QualityConstants::MAX_UI_REFRESH_INTERVAL);
+    return settings;
+}
+
+void QualityScaler::setLevel(int level, const char* reason) {
+    std::cout << "QUALITY: Level " << level_ << " -> " << level << " (" << reason << ", p"
+              << QualityConstants::PERCENTILE << " " << percentile_ms_ << "ms, target "
+              << target_frame_time_ * 1000.0f << "ms)" << std::endl;
+    level_ = level;
+    settings_ = settingsFor(level);
+    std::cout << "QUALITY: LOD " << settings_.lodDistance << "m, cull " << settings_.cullDistance
+              << "m, particles " << settings_.particleBudget << ", NPC interval x" << settings_.npcIntervalScale
+              << ", UI refresh " << settings_.uiRefreshInterval << "s, next raise after "
+              << upshift_delay_ << "s" << std::endl;
+    resetWindow();
+}
+
+void QualityScaler::resetWindow() {
+    window_count_ = 0;
+    window_index_ = 0;
+    good_time_ = 0.0f;
+}
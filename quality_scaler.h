@@ -0,0 +1,66 @@
+// quality_scaler.h - Steps render and update quality to keep frame times within budget
+#ifndef QUALITY_SCALER_H
+#define QUALITY_SCALER_H
+
+#include "constants.h"
+#include <vector>
+
+/// \brief What one quality level asks of the systems it drives.
+struct QualitySettings {
+    float lodDistance;          // EnvironmentManager LOD tiers
+    float cullDistance;         // EnvironmentManager far plane and cull range
+    int particleBudget;         // ParticleSystem live particles per type
+    int npcIntervalScale;       // NPCSystem MID/FAR movement interval multiplier
+    float uiRefreshInterval;    // UIPanelCache seconds a stale panel may keep its recording
+};
+
+/// \brief Feedback controller from the rolling frame-time percentile to a quality level.
+///
+/// update() takes each frame's time and keeps QualityConstants::WINDOW_FRAMES of them. When
+/// the window's PERCENTILE passes the target by DOWNSHIFT_RATIO, quality drops one level;
+/// once it has stayed under UPSHIFT_RATIO for the upshift delay, it rises one level. Both
+/// thresholds and the delay are the hysteresis: a capped frame rate sits at the target, so
+/// the controller can only probe for headroom by raising. A raise that is undone within
+/// PROBE_TIME doubles the delay before the next one, so a level that can't hold isn't retried
+/// every few seconds. The window restarts after each change, so a level is judged only by
+/// its own frames. Every change is logged.
+class QualityScaler {
+public:
+    QualityScaler();
+
+    /// \brief Sets the frame time to stay within, usually 1 / target FPS.
+    void setTargetFrameTime(float seconds) { target_frame_time_ = seconds; }
+
+    /// \brief Records a frame and steps the level if the window calls for it.
+    /// \param frameTime Wall time of the frame in seconds.
+    /// \return True when the level changed; getSettings() then holds the new values.
+    bool update(float frameTime);
+
+    int getLevel() const { return level_; }
+    const QualitySettings& getSettings() const { return settings_; }
+
+    /// \brief Gets the window percentile from the last frame, in milliseconds; 0 until the window fills.
+    float getPercentileMs() const { return percentile_ms_; }
+
+    /// \brief Settings for a level, interpolated between the normal constants (0) and the lowest level.
+    static QualitySettings settingsFor(int level);
+
+private:
+    void setLevel(int level, const char* reason);
+    void resetWindow();
+
+    std::vector<float> window_;
+    std::vector<float> scratch_;    // Reused by the percentile's nth_element
+    size_t window_count_ = 0;
+    size_t window_index_ = 0;
+    float target_frame_time_ = 1.0f / 60.0f;
+    float percentile_ms_ = 0.0f;
+    float good_time_ = 0.0f;        // Seconds the window has been under the upshift threshold
+    float since_raise_ = 0.0f;      // Seconds since the last raise
+    float upshift_delay_ = QualityConstants::UPSHIFT_DELAY;
+    bool raised_ = false;           // The last change was a raise still inside PROBE_TIME
+    int level_ = 0;
+    QualitySettings settings_;
+};
+
+#endif // QUALITY_SCALER_H
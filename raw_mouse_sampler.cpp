@@ -0,0 +1,116 @@
+// raw_mouse_sampler.cpp
+#include "raw_mouse_sampler.h"
+#include "profiler.h"
+#include <iostream>
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#define RAW_MOUSE_SUPPORTED 1
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr int POLL_TIMEOUT_MS = 10;   // How quickly stop() is noticed while the mouse is idle
+    constexpr int PACKET_SIZE = 3;        // PS/2: flags, dx, dy
+}
+
+RawMouseSampler::~RawMouseSampler() {
+    stop();
+}
+
+bool RawMouseSampler::start(const std::string& device) {
+    stop();
+#ifdef RAW_MOUSE_SUPPORTED
+    fd_ = ::open(device.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd_ < 0) {
+        std::cout << "INPUT: Cannot open raw mouse device " << device << ", using per-frame mouse input" << std::endl;
+        return false;
+    }
+    running_.store(true, std::memory_order_relaxed);
+    thread_ = std::thread(&RawMouseSampler::samplerLoop, this);
+    std::cout << "INPUT: Sampling raw mouse motion from " << device << std::endl;
+    return true;
+#else
+    std::cout << "INPUT: Raw mouse sampling is not supported on this platform (" << device << ")" << std::endl;
+    return false;
+#endif
+}
+
+void RawMouseSampler::stop() {
+    running_.store(false, std::memory_order_relaxed);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+#ifdef RAW_MOUSE_SUPPORTED
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+    fd_ = -1;
+    while (queue_.front() != nullptr) {
+        queue_.pop();
+    }
+}
+
+Vector2 RawMouseSampler::drain(Clock::time_point until) {
+    const Clock::rep cutoff = until.time_since_epoch().count();
+    Vector2 total = {0.0f, 0.0f};
+    while (const Sample* sample = queue_.front()) {
+        if (sample->timestamp > cutoff) break;
+        total.x += sample->dx;
+        total.y += sample->dy;
+        queue_.pop();
+    }
+    return total;
+}
+
+void RawMouseSampler::samplerLoop() {
+    Profiler::getInstance().setThreadName("Raw Mouse");
+#ifdef RAW_MOUSE_SUPPORTED
+    unsigned char buffer[PACKET_SIZE * 64];
+    int buffered = 0;  // Bytes of a packet split across reads
+
+    while (running_.load(std::memory_order_relaxed)) {
+        pollfd descriptor = {fd_, POLLIN, 0};
+        int ready = ::poll(&descriptor, 1, POLL_TIMEOUT_MS);
+        if (ready <= 0 || !(descriptor.revents & POLLIN)) {
+            if (descriptor.revents & (POLLERR | POLLHUP)) {
+                std::cout << "INPUT: Raw mouse device closed, sampler stopped" << std::endl;
+                break;
+            }
+            continue;
+        }
+
+        ssize_t count = ::read(fd_, buffer + buffered, sizeof(buffer) - buffered);
+        if (count <= 0) continue;
+        const Clock::rep now = Clock::now().time_since_epoch().count();
+        int length = buffered + static_cast<int>(count);
+
+        int offset = 0;
+        while (length - offset >= PACKET_SIZE) {
+            unsigned char flags = buffer[offset];
+            if (!(flags & 0x08)) {
+                ++offset;  // Bit 3 is always set in the first byte; resynchronize
+                continue;
+            }
+            // 9-bit two's complement: the sign bits live in the flags byte. Device +y is up.
+            int dx = buffer[offset + 1] - ((flags & 0x10) ? 256 : 0);
+            int dy = buffer[offset + 2] - ((flags & 0x20) ? 256 : 0);
+            offset += PACKET_SIZE;
+            if (dx == 0 && dy == 0) continue;  // Button-only report
+
+            Sample sample = {now, static_cast<float>(dx), static_cast<float>(-dy)};
+            if (!queue_.tryPush(sample)) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        buffered = length - offset;
+        for (int i = 0; i < buffered; i++) {
+            buffer[i] = buffer[offset + i];
+        }
+    }
+#endif
+    running_.store(false, std::memory_order_relaxed);
+}
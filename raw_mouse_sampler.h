@@ -0,0 +1,68 @@
+// raw_mouse_sampler.h - High-rate mouse motion read on its own thread
+#ifndef RAW_MOUSE_SAMPLER_H
+#define RAW_MOUSE_SAMPLER_H
+
+#include "raylib.h"
+#include "spsc_queue.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+/// \brief Reads relative mouse motion straight from the OS device at the mouse's own
+/// report rate, timestamping every report.
+///
+/// raylib only sees the mouse once per rendered frame, so at low frame rates a whole
+/// frame's motion lands in one simulation step. The sampler thread pushes timestamped
+/// reports into a lock-free SPSC queue instead, and the input manager drains them up to
+/// each fixed step's wall-clock end, so look motion is spread over the steps it happened
+/// in. Linux only (PS/2 protocol devices such as /dev/input/mice, which need read
+/// access); start() fails elsewhere and callers keep raylib's per-frame delta.
+class RawMouseSampler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Sample {
+        Clock::rep timestamp;   // Clock ticks when the report was read
+        float dx;               // Device counts; +y is down, as on screen
+        float dy;
+    };
+
+    // ~1 second of 1000 Hz reports; older motion is dropped if the consumer stalls that long
+    static constexpr size_t QUEUE_CAPACITY = 1024;
+
+    RawMouseSampler() = default;
+    ~RawMouseSampler();
+
+    RawMouseSampler(const RawMouseSampler&) = delete;
+    RawMouseSampler& operator=(const RawMouseSampler&) = delete;
+
+    /// \brief Opens the device and starts the sampler thread.
+    /// \param device Device path, e.g. /dev/input/mice.
+    /// \return False if the device can't be read; nothing is started.
+    bool start(const std::string& device);
+
+    /// \brief Stops the thread and closes the device. Queued samples are discarded.
+    void stop();
+
+    bool isRunning() const { return running_.load(std::memory_order_relaxed); }
+
+    /// \brief Sums the motion reported at or before `until`; later reports stay queued.
+    /// Consumer side: call from one thread only.
+    Vector2 drain(Clock::time_point until);
+
+    /// \brief Gets reports dropped because the queue was full.
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    void samplerLoop();
+
+    int fd_ = -1;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> dropped_{0};
+    SpscQueue<Sample, QUEUE_CAPACITY> queue_;
+};
+
+#endif // RAW_MOUSE_SAMPLER_H
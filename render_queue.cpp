@@ -0,0 +1,262 @@
+#include "render_queue.h"
+#include "render_stats.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+// Flat-colour instancing shader: raylib feeds per-instance model matrices to
+// the attribute bound at SHADER_LOC_MATRIX_MODEL and view*projection as mvp.
+const char* INSTANCED_VS = R"(
+#version 330
+in vec3 vertexPosition;
+in mat4 instanceTransform;
+uniform mat4 mvp;
+void main() {
+    gl_Position = mvp * instanceTransform * vec4(vertexPosition, 1.0);
+}
+)";
+
+const char* INSTANCED_FS = R"(
+#version 330
+uniform vec4 colDiffuse;
+out vec4 finalColor;
+void main() {
+    finalColor = colDiffuse;
+}
+)";
+
+}  // namespace
+
+RenderQueue::~RenderQueue() {
+    // GPU resources must already be released via unload() while the context exists
+    if (gpu_ready_ && IsWindowReady()) {
+        unload();
+    }
+}
+
+uint64_t RenderQueue::makeKey(Kind kind, int slices, int rings, Color color) {
+    uint32_t rgba = (uint32_t(color.r) << 24) | (uint32_t(color.g) << 16) | (uint32_t(color.b) << 8) | color.a;
+    uint64_t translucent = color.a < 255 ? TRANSLUCENT_BIT : 0;
+    return translucent | (uint64_t(kind) << 56) | (uint64_t(uint16_t(slices) & 0xFFF) << 44) |
+           (uint64_t(uint16_t(rings) & 0xFFF) << 32) | rgba;
+}
+
+void RenderQueue::push(Kind kind, Color color, Vector3 a, Vector3 b, float rotation, int slices, int rings, float radius) {
+    items_.push_back({makeKey(kind, slices, rings, color), kind, color, a, b, rotation, radius,
+                      static_cast<int16_t>(slices), static_cast<int16_t>(rings)});
+}
+
+void RenderQueue::submitCube(Vector3 center, Vector3 size, Color color) {
+    push(Kind::CUBE, color, center, size, 0.0f, 0, 0);
+}
+
+void RenderQueue::submitCubeRotated(Vector3 center, Vector3 size, float rotationY, Color color, bool wires) {
+    push(wires ? Kind::CUBE_ROTATED_WIRES : Kind::CUBE_ROTATED, color, center, size, rotationY, 0, 0);
+}
+
+void RenderQueue::submitCubeWires(Vector3 center, Vector3 size, Color color) {
+    push(Kind::CUBE_WIRES, color, center, size, 0.0f, 0, 0);
+}
+
+void RenderQueue::submitCylinder(Vector3 base, float radiusTop, float radiusBottom, float height, int slices, Color color) {
+    // Only straight cylinders can reuse a scaled unit mesh
+    Kind kind = radiusTop == radiusBottom ? Kind::CYLINDER : Kind::CYLINDER_TAPERED;
+    push(kind, color, base, {radiusTop, radiusBottom, height}, 0.0f, slices, 0);
+}
+
+void RenderQueue::submitCylinderWires(Vector3 base, float radiusTop, float radiusBottom, float height, int slices, Color color) {
+    push(Kind::CYLINDER_WIRES, color, base, {radiusTop, radiusBottom, height}, 0.0f, slices, 0);
+}
+
+void RenderQueue::submitCylinderEx(Vector3 start, Vector3 end, float radiusStart, float radiusEnd, int slices, Color color) {
+    push(Kind::CYLINDER_EX, color, start, end, radiusEnd, slices, 0, radiusStart);
+}
+
+void RenderQueue::submitSphere(Vector3 center, float radius, int rings, int slices, Color color) {
+    push(Kind::SPHERE, color, center, {radius, radius, radius}, 0.0f, slices, rings);
+}
+
+void RenderQueue::submitSphereWires(Vector3 center, float radius, int rings, int slices, Color color) {
+    push(Kind::SPHERE_WIRES, color, center, {radius, radius, radius}, 0.0f, slices, rings);
+}
+
+bool RenderQueue::ensureGpu() {
+    if (gpu_ready_) return true;
+    if (gpu_failed_ || !IsWindowReady()) return false;
+
+    Shader shader = LoadShaderFromMemory(INSTANCED_VS, INSTANCED_FS);
+    if (shader.id == rlGetShaderIdDefault()) {
+        std::cout << "RENDER QUEUE: Instancing shader unavailable, using immediate-mode fallback" << std::endl;
+        gpu_failed_ = true;
+        return false;
+    }
+    shader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(shader, "mvp");
+    shader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(shader, "instanceTransform");
+    shader.locs[SHADER_LOC_COLOR_DIFFUSE] = GetShaderLocation(shader, "colDiffuse");
+
+    material_ = LoadMaterialDefault();
+    material_.shader = shader;
+    gpu_ready_ = true;
+    return true;
+}
+
+const Mesh& RenderQueue::unitMesh(Kind kind, int slices, int rings) {
+    uint32_t id = (uint32_t(kind) << 24) | (uint32_t(slices & 0xFFF) << 12) | uint32_t(rings & 0xFFF);
+    auto it = meshes_.find(id);
+    if (it != meshes_.end()) return it->second;
+
+    Mesh mesh;
+    switch (kind) {
+        case Kind::CYLINDER: mesh = GenMeshCylinder(1.0f, 1.0f, slices); break;
+        case Kind::SPHERE:   mesh = GenMeshSphere(1.0f, rings, slices); break;
+        default:             mesh = GenMeshCube(1.0f, 1.0f, 1.0f); break;
+    }
+    return meshes_.emplace(id, mesh).first->second;
+}
+
+Matrix RenderQueue::instanceTransform(const Item& item) {
+    switch (item.kind) {
+        case Kind::CYLINDER:
+            // Unit cylinder spans y in [0, 1] like DrawCylinder; b = {radius, radius, height}
+            return MatrixMultiply(MatrixScale(item.b.x, item.b.z, item.b.x), MatrixTranslate(item.a.x, item.a.y, item.a.z));
+        default:
+            return MatrixMultiply(MatrixScale(item.b.x, item.b.y, item.b.z), MatrixTranslate(item.a.x, item.a.y, item.a.z));
+    }
+}
+
+void RenderQueue::drawImmediate(const Item& item) {
+    switch (item.kind) {
+        case Kind::CUBE:
+            DrawCube(item.a, item.b.x, item.b.y, item.b.z, item.color);
+            break;
+        case Kind::CUBE_WIRES:
+            DrawCubeWires(item.a, item.b.x, item.b.y, item.b.z, item.color);
+            break;
+        case Kind::CUBE_ROTATED:
+        case Kind::CUBE_ROTATED_WIRES:
+            rlPushMatrix();
+            rlTranslatef(item.a.x, item.a.y, item.a.z);
+            rlRotatef(item.rotation, 0.0f, 1.0f, 0.0f);
+            if (item.kind == Kind::CUBE_ROTATED) {
+                DrawCube({0, 0, 0}, item.b.x, item.b.y, item.b.z, item.color);
+            } else {
+                DrawCubeWires({0, 0, 0}, item.b.x, item.b.y, item.b.z, item.color);
+            }
+            rlPopMatrix();
+            break;
+        case Kind::CYLINDER:
+        case Kind::CYLINDER_TAPERED:
+            DrawCylinder(item.a, item.b.x, item.b.y, item.b.z, item.slices, item.color);
+            break;
+        case Kind::CYLINDER_WIRES:
+            DrawCylinderWires(item.a, item.b.x, item.b.y, item.b.z, item.slices, item.color);
+            break;
+        case Kind::CYLINDER_EX:
+            DrawCylinderEx(item.a, item.b, item.radius, item.rotation, item.slices, item.color);
+            break;
+        case Kind::SPHERE:
+            DrawSphereEx(item.a, item.b.x, item.rings, item.slices, item.color);
+            break;
+        case Kind::SPHERE_WIRES:
+            DrawSphereWires(item.a, item.b.x, item.rings, item.slices, item.color);
+            break;
+    }
+}
+
+uint32_t RenderQueue::immediateVertices(const Item& item) {
+    // What raylib's rmodels emits for each shape
+    uint32_t slices = static_cast<uint32_t>(std::max<int>(item.slices, 3));
+    uint32_t rings = static_cast<uint32_t>(std::max<int>(item.rings, 0));
+    switch (item.kind) {
+        case Kind::CUBE:
+        case Kind::CUBE_ROTATED:
+            return 36;
+        case Kind::CUBE_WIRES:
+        case Kind::CUBE_ROTATED_WIRES:
+            return 24;
+        case Kind::CYLINDER:
+        case Kind::CYLINDER_TAPERED:
+        case Kind::CYLINDER_EX:
+            return slices * 12;  // Side quads and both caps
+        case Kind::CYLINDER_WIRES:
+            return slices * 8;
+        case Kind::SPHERE:
+        case Kind::SPHERE_WIRES:
+            return (rings + 2) * static_cast<uint32_t>(std::max<int>(item.slices, 0)) * 6;
+    }
+    return 0;
+}
+
+void RenderQueue::flush() {
+    last_item_count_ = items_.size();
+    last_draw_calls_ = 0;
+    if (items_.empty()) return;
+
+    // Stable so immediate items keep submission order within a key
+    std::stable_sort(items_.begin(), items_.end(), [](const Item& l, const Item& r) { return l.key < r.key; });
+
+    // Translucent keys sort last, so blended items still go over everything opaque
+    auto firstTranslucent = std::partition_point(items_.begin(), items_.end(),
+                                                 [](const Item& item) { return (item.key & TRANSLUCENT_BIT) == 0; });
+    size_t split = static_cast<size_t>(firstTranslucent - items_.begin());
+
+    // Instanced draws reach the GPU at once while immediate ones wait in rlgl's batch, so the
+    // translucent half stays immediate to land behind the opaque items in that batch
+    bool instancing = ensureGpu();
+    drawRange(0, split, instancing);
+    drawRange(split, items_.size(), false);
+
+    items_.clear();  // Keeps capacity for next frame
+}
+
+void RenderQueue::drawRange(size_t begin, size_t end, bool instancing) {
+    RenderStats& stats = RenderStats::getInstance();
+
+    // Instanced batches first, then every immediate item together: all of the range's
+    // instancing-shader draws are adjacent and rlgl's default-shader batch is built once
+    immediate_scratch_.clear();
+    for (size_t i = begin; i < end;) {
+        size_t groupEnd = i + 1;
+        while (groupEnd < end && items_[groupEnd].key == items_[i].key) ++groupEnd;
+
+        const Item& first = items_[i];
+        if (instancing && isInstanced(first.kind) && groupEnd - i > 1) {
+            instance_scratch_.clear();
+            for (size_t k = i; k < groupEnd; ++k) {
+                instance_scratch_.push_back(instanceTransform(items_[k]));
+            }
+            const Mesh& mesh = unitMesh(first.kind, first.slices, first.rings);
+            material_.maps[MATERIAL_MAP_DIFFUSE].color = first.color;
+            DrawMeshInstanced(mesh, material_, instance_scratch_.data(), static_cast<int>(instance_scratch_.size()));
+            stats.recordDraw(static_cast<uint32_t>(mesh.vertexCount * instance_scratch_.size()),
+                             material_.maps[MATERIAL_MAP_DIFFUSE].texture.id, material_.shader.id);
+            ++last_draw_calls_;
+        } else {
+            for (size_t k = i; k < groupEnd; ++k) {
+                immediate_scratch_.push_back(static_cast<uint32_t>(k));
+            }
+        }
+        i = groupEnd;
+    }
+
+    for (uint32_t k : immediate_scratch_) {
+        drawImmediate(items_[k]);
+        stats.recordShape(immediateVertices(items_[k]));
+        ++last_draw_calls_;
+    }
+}
+
+void RenderQueue::unload() {
+    for (auto& [id, mesh] : meshes_) {
+        UnloadMesh(mesh);
+    }
+    meshes_.clear();
+    if (gpu_ready_) {
+        UnloadMaterial(material_);  // Also releases the instancing shader
+        material_ = Material{};
+        gpu_ready_ = false;
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include "raylib.h"
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+/// \brief Collects opaque world draw calls for a frame, then sorts and batches them.
+///
+/// Solid cubes, uniform cylinders and spheres are keyed by mesh + colour and drawn with
+/// one DrawMeshInstanced call per key. Shapes that can't share a unit mesh (wireframes,
+/// tapered cylinders, rotated pieces) and keys with a single item are kept as immediate
+/// items and drawn after the batches, still grouped by kind, so the instancing shader and
+/// rlgl's default one each stay bound for one run. Translucent colours sort after all of
+/// that. If the instancing shader is unavailable, every item falls back to the equivalent
+/// immediate-mode raylib call.
+class RenderQueue {
+public:
+    ~RenderQueue();
+
+    /// \brief Queues a solid axis-aligned cube.
+    void submitCube(Vector3 center, Vector3 size, Color color);
+
+    /// \brief Queues a cube rotated about Y (degrees) around its centre.
+    void submitCubeRotated(Vector3 center, Vector3 size, float rotationY, Color color, bool wires = false);
+
+    /// \brief Queues cube wireframe.
+    void submitCubeWires(Vector3 center, Vector3 size, Color color);
+
+    /// \brief Queues a cylinder from base upward, as DrawCylinder.
+    void submitCylinder(Vector3 base, float radiusTop, float radiusBottom, float height, int slices, Color color);
+
+    /// \brief Queues cylinder wireframe.
+    void submitCylinderWires(Vector3 base, float radiusTop, float radiusBottom, float height, int slices, Color color);
+
+    /// \brief Queues a cylinder between two points, as DrawCylinderEx.
+    void submitCylinderEx(Vector3 start, Vector3 end, float radiusStart, float radiusEnd, int slices, Color color);
+
+    /// \brief Queues a sphere.
+    void submitSphere(Vector3 center, float radius, int rings, int slices, Color color);
+
+    /// \brief Queues sphere wireframe.
+    void submitSphereWires(Vector3 center, float radius, int rings, int slices, Color color);
+
+    /// \brief Sorts and draws everything queued, then empties the queue. Call inside BeginMode3D.
+    void flush();
+
+    /// \brief Releases GPU meshes and the instancing shader. Call before CloseWindow.
+    void unload();
+
+    /// \brief Gets number of draw calls issued by the last flush.
+    size_t getLastDrawCalls() const { return last_draw_calls_; }
+
+    /// \brief Gets number of items drawn by the last flush.
+    size_t getLastItemCount() const { return last_item_count_; }
+
+private:
+    enum class Kind : uint8_t {
+        // Instanced kinds share a unit mesh scaled per instance
+        CUBE, CYLINDER, SPHERE,
+        // Immediate kinds
+        CUBE_ROTATED, CUBE_ROTATED_WIRES, CUBE_WIRES, CYLINDER_TAPERED, CYLINDER_WIRES, CYLINDER_EX, SPHERE_WIRES
+    };
+
+    struct Item {
+        uint64_t key;           // Translucency, kind, tessellation and colour: sort and batch key
+        Kind kind;
+        Color color;
+        Vector3 a;              // Centre, base or start
+        Vector3 b;              // Size, {radiusTop, radiusBottom, height}, end, or {radius, _, _}
+        float rotation;         // Degrees about Y, or end radius for CYLINDER_EX
+        float radius;           // Start radius for CYLINDER_EX
+        int16_t slices;
+        int16_t rings;
+    };
+
+    std::vector<Item> items_;
+    std::vector<Matrix> instance_scratch_;
+    std::vector<uint32_t> immediate_scratch_;    // Indices of the range's immediate items
+    std::unordered_map<uint32_t, Mesh> meshes_;  // Unit meshes by (kind, slices, rings)
+    Material material_{};
+    bool gpu_ready_ = false;
+    bool gpu_failed_ = false;
+    size_t last_draw_calls_ = 0;
+    size_t last_item_count_ = 0;
+
+    static constexpr uint64_t TRANSLUCENT_BIT = uint64_t(1) << 63;
+
+    static uint64_t makeKey(Kind kind, int slices, int rings, Color color);
+    static bool isInstanced(Kind kind) { return kind <= Kind::SPHERE; }
+    void push(Kind kind, Color color, Vector3 a, Vector3 b, float rotation, int slices, int rings, float radius = 0.0f);
+    bool ensureGpu();
+    const Mesh& unitMesh(Kind kind, int slices, int rings);
+    static Matrix instanceTransform(const Item& item);
+    static void drawImmediate(const Item& item);
+    static uint32_t immediateVertices(const Item& item);
+    void drawRange(size_t begin, size_t end, bool instancing);
+};
+
+#endif
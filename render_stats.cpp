@@ -0,0 +1,76 @@
+#include "render_stats.h"
+#include "profiler.h"
+#include "rlgl.h"
+
+void RenderPassStats::add(const RenderPassStats& other) {
+    draws += other.draws;
+    vertices += other.vertices;
+    textureBinds += other.textureBinds;
+    shaderBinds += other.shaderBinds;
+}
+
+void RenderStats::recordDraw(uint32_t vertices, unsigned int textureId, unsigned int shaderId) {
+    RenderPassStats& stats = current_[static_cast<size_t>(pass_)];
+    ++stats.draws;
+    stats.vertices += vertices;
+    if (textureId != bound_texture_) {
+        ++stats.textureBinds;
+        bound_texture_ = textureId;
+    }
+    if (shaderId != bound_shader_) {
+        ++stats.shaderBinds;
+        bound_shader_ = shaderId;
+    }
+}
+
+void RenderStats::recordShape(uint32_t vertices) {
+    recordDraw(vertices, rlGetTextureIdDefault(), rlGetShaderIdDefault());
+}
+
+void RenderStats::endFrame() {
+    last_ = current_;
+    current_ = {};
+    pass_ = RenderPass::WORLD;
+    // Each frame starts from whatever EndDrawing left bound; count its first draw as a bind
+    bound_texture_ = NO_BINDING;
+    bound_shader_ = NO_BINDING;
+
+    Profiler& profiler = Profiler::getInstance();
+    if (!profiler.isEnabled()) return;
+    static const char* const TRACKS[RENDER_PASS_COUNT] = {"Render: World", "Render: Interactions", "Render: Overlay"};
+    uint64_t now = Profiler::now();
+    for (int p = 0; p < RENDER_PASS_COUNT; ++p) {
+        const RenderPassStats& stats = last_[p];
+        ProfileCounter counter;
+        counter.name = TRACKS[p];
+        counter.time_ns = now;
+        counter.series[0] = "draws";
+        counter.values[0] = stats.draws;
+        counter.series[1] = "vertices";
+        counter.values[1] = stats.vertices;
+        counter.series[2] = "texture binds";
+        counter.values[2] = stats.textureBinds;
+        counter.series[3] = "shader binds";
+        counter.values[3] = stats.shaderBinds;
+        counter.series_count = 4;
+        profiler.recordCounter(counter);
+    }
+}
+
+RenderPassStats RenderStats::getTotal() const {
+    RenderPassStats total;
+    for (const RenderPassStats& stats : last_) {
+        total.add(stats);
+    }
+    return total;
+}
+
+const char* RenderStats::getPassName(RenderPass pass) {
+    switch (pass) {
+        case RenderPass::WORLD: return "World";
+        case RenderPass::INTERACTIONS: return "Interactions";
+        case RenderPass::OVERLAY: return "Overlay";
+        case RenderPass::COUNT: break;
+    }
+    return "Unknown";
+}
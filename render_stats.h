@@ -0,0 +1,92 @@
+// render_stats.h - Per-pass draw, vertex and state-change counters
+#ifndef RENDER_STATS_H
+#define RENDER_STATS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/// \brief RenderSystem passes that submissions are counted against.
+enum class RenderPass : uint8_t { WORLD, INTERACTIONS, OVERLAY, COUNT };
+constexpr int RENDER_PASS_COUNT = static_cast<int>(RenderPass::COUNT);
+
+/// \brief What one pass handed to rlgl in a frame.
+struct RenderPassStats {
+    uint32_t draws = 0;           // Immediate shapes, instanced mesh draws, text runs, blits
+    uint32_t vertices = 0;        // Instanced draws count every instance's vertices
+    uint32_t textureBinds = 0;    // Draws whose texture differs from the draw before
+    uint32_t shaderBinds = 0;     // Draws whose shader differs from the draw before
+
+    void add(const RenderPassStats& other);
+};
+
+/// \brief Counts submissions at the code paths that talk to rlgl, grouped by render pass.
+///
+/// rlgl doesn't expose its batch counters, so the choke points that batch their own
+/// geometry (RenderQueue, TextLayoutCache, UIPanelCache, ParticleSystem and RenderSystem's
+/// own draws) report here instead. A texture or shader change is where rlgl has to flush
+/// its batch, so the bind counts are the flushes those paths cause. Loose raylib shape calls
+/// in the UI aren't counted; they share the default font's atlas and don't flush.
+///
+/// Main thread only. The last finished frame is what the getters return, so the overlay
+/// that draws the numbers isn't reading a half-counted frame.
+class RenderStats {
+public:
+    static constexpr uint32_t CIRCLE_3D_VERTICES = 72;   // DrawCircle3D: 36 line segments
+
+    static RenderStats& getInstance() {
+        static RenderStats instance;
+        return instance;
+    }
+
+    /// \brief Makes subsequent draws count against `pass`.
+    void setPass(RenderPass pass) { pass_ = pass; }
+    RenderPass getCurrentPass() const { return pass_; }
+
+    /// \brief Counts one submission.
+    /// \param vertices Vertices sent, after instancing.
+    /// \param textureId GL texture the draw samples.
+    /// \param shaderId GL program the draw uses.
+    void recordDraw(uint32_t vertices, unsigned int textureId, unsigned int shaderId);
+
+    /// \brief Counts a raylib shape call: rlgl's default texture and shader.
+    void recordShape(uint32_t vertices);
+
+    /// \brief Publishes this frame's counts, samples them into the profiler and starts a new frame.
+    void endFrame();
+
+    const RenderPassStats& getPass(RenderPass pass) const { return last_[static_cast<size_t>(pass)]; }
+    RenderPassStats getTotal() const;
+
+    static const char* getPassName(RenderPass pass);
+
+private:
+    RenderStats() = default;
+    RenderStats(const RenderStats&) = delete;
+    RenderStats& operator=(const RenderStats&) = delete;
+
+    static constexpr unsigned int NO_BINDING = ~0u;
+
+    std::array<RenderPassStats, RENDER_PASS_COUNT> current_{};
+    std::array<RenderPassStats, RENDER_PASS_COUNT> last_{};
+    RenderPass pass_ = RenderPass::WORLD;
+    unsigned int bound_texture_ = NO_BINDING;   // State rlgl is left in by the previous draw
+    unsigned int bound_shader_ = NO_BINDING;
+};
+
+/// \brief RAII pass switch that restores the enclosing pass, for passes nested in another.
+class RenderPassScope {
+public:
+    explicit RenderPassScope(RenderPass pass) : previous_(RenderStats::getInstance().getCurrentPass()) {
+        RenderStats::getInstance().setPass(pass);
+    }
+    ~RenderPassScope() { RenderStats::getInstance().setPass(previous_); }
+
+    RenderPassScope(const RenderPassScope&) = delete;
+    RenderPassScope& operator=(const RenderPassScope&) = delete;
+
+private:
+    RenderPass previous_;
+};
+
+#endif
@@ -1,9 +1,18 @@
 #include "render_system.h"
 #include "math_utils.h"
 #include "ui_system.h"  // For g_uiSystem
+#include "profiler.h"  // For PROFILE_SCOPE
+#include "frustum.h"
+#include "particle_system.h"
+#include "memory_tracker.h"
+#include "frame_arena.h"
+#include "render_stats.h"
+#include "performance_system.h"  // For SystemTimer
 #include <iostream>
 
-extern NPC npcs[MAX_NPCS];  // From npc.cpp
+namespace {
+    constexpr uint32_t INDICATOR_SPHERE_VERTICES = (16 + 2) * 16 * 6;  // DrawSphere: 16 rings, 16 slices
+}
 
 RenderSystem::RenderSystem(GameState& state, EnvironmentManager& environment, SimplePerformanceStats& performanceStats)
     : state_(state), environment_(environment), performanceStats_(performanceStats) {}
@@ -13,92 +22,125 @@ void RenderSystem::renderAll(const Camera3D& camera, float time) {
         ClearBackground(RAYWHITE);
 
         BeginMode3D(camera);
+            RenderStats::getInstance().setPass(RenderPass::WORLD);
             render3DWorld(camera, time);
         EndMode3D();
 
+        RenderStats::getInstance().setPass(RenderPass::OVERLAY);
+        if (uiTimer_) uiTimer_->start();
         render2DOverlays(camera, time);
+        if (uiTimer_) uiTimer_->end();
     EndDrawing();
+
+    // Every string built for this frame has been drawn
+    FrameArena::getInstance().reset();
+    RenderStats::getInstance().endFrame();
 }
 
 void RenderSystem::render3DWorld(const Camera3D& camera, float time) {
-    // Render ground
-    Color groundColor = LIGHTGRAY;
-    if (state_.isJumping) {
-        groundColor = Fade(SKYBLUE, 0.8f);
-    } else if (!state_.isGrounded) {
-        groundColor = Fade(YELLOW, 0.6f);
-    }
-    DrawPlane({0.0f, 0.0f, 0.0f}, {16.0f, 16.0f}, groundColor);
+    float aspect = GetScreenHeight() > 0 ? static_cast<float>(GetScreenWidth()) / GetScreenHeight() : 1.0f;
+    CellVisibility cells = CellVisibility::compute(camera, aspect, environment_, state_.player.isInBuilding, state_.player.currentBuilding);
+    RenderStats& stats = RenderStats::getInstance();
+
+    // Opaque world pieces from every cell go into one queue, sorted by shader and mesh at the flush
+    RenderQueue& opaque = environment_.getRenderQueue();
+
+    // Exterior cell: ground and environment, through the doorway only when indoors
+    if (cells.exterior) {
+        Color groundColor = LIGHTGRAY;
+        if (state_.player.isJumping) {
+            groundColor = Fade(SKYBLUE, 0.8f);
+        } else if (!state_.player.isGrounded) {
+            groundColor = Fade(YELLOW, 0.6f);
+        }
+        DrawPlane({0.0f, 0.0f, 0.0f}, {16.0f, 16.0f}, groundColor);
+        stats.recordShape(4);
 
-    // Re-enable environment rendering
-    environment_.renderAll(camera);
+        environment_.submitVisible(camera, cells.throughPortal ? &cells.portal : nullptr);
+    }
 
-    // Render NPCs
-    for (int n = 0; n < MAX_NPCS; n++) {
-        bool shouldDrawNPC = false;
-        if (state_.isInBuilding) {
-            if (state_.currentBuilding == 0 && n == 0) shouldDrawNPC = true;
-            if (state_.currentBuilding == 1 && n == 1) shouldDrawNPC = true;
-        }
-        if (shouldDrawNPC) {
-            renderNPC(npcs[n], camera, time);
+    // Render NPCs: full model near, simplified at mid range, nothing past it.
+    // isVisible already keeps each NPC to its own cell.
+    {
+        PROFILE_SCOPE("RenderSystem::renderNPCs");
+        const NPCSystem& npcs = NPCSystem::getInstance();
+        Frustum frustum = Frustum::fromCamera(camera, aspect, RenderConstants::CAMERA_NEAR_PLANE, NPCConstants::MID_DISTANCE);
+        for (int n = 0; n < npcs.getCount(); n++) {
+            if (npcs.getDetail(n) == NPCDetail::FAR) continue;
+            if (!npcs.isVisible(n, state_.player.isInBuilding, state_.player.currentBuilding)) continue;
+            Vector3 p = npcs.getPosition(n);
+            BoundingBox bounds = {{p.x - 0.8f, p.y - 0.8f, p.z - 0.8f}, {p.x + 0.8f, p.y + 3.2f, p.z + 0.8f}};
+            if (!frustum.intersects(bounds)) continue;
+            if (npcs.getDetail(n) == NPCDetail::NEAR) {
+                renderNPC(npcs, n, camera, time, opaque);
+            } else {
+                renderNPCSimple(npcs, n, opaque);
+            }
         }
     }
 
     // Render combat
     renderCombat(camera, time);
 
-    // Render building interiors
-    if (state_.isInBuilding && state_.currentBuilding >= 0) {
-        auto objects = environment_.getAllObjects();
-        for (const auto& obj : objects) {
-            if (auto building = std::dynamic_pointer_cast<Building>(obj)) {
-                if (building->getId() == state_.currentBuilding) {
-                    renderBuildingInterior(*building);
-                    break;
-                }
-            }
-        }
+    // Interior cell the camera is in
+    if (cells.interior) {
+        renderBuildingInterior(*cells.interior, opaque);
+    }
+
+    {
+        PROFILE_SCOPE("RenderSystem::flushOpaque");
+        opaque.flush();
     }
 
     // Render interactions
     render3DInteractions(camera);
+
+    // Translucent effects last, over everything opaque
+    ParticleSystem::getInstance().draw();
 }
 
-void RenderSystem::render3DInteractions(const Camera3D& camera) {
-    auto interactiveObjects = environment_.getInteractiveObjects();
-    for (const auto& obj : interactiveObjects) {
-        if (auto building = std::dynamic_pointer_cast<Building>(obj)) {
-            Vector3 doorPos = building->getDoorPosition();
-            float distance = MathUtils::distance3D(doorPos, camera.position);
-
-            if (distance <= EnvironmentConstants::INTERACTION_DISTANCE && !state_.isInBuilding) {
-                float pulse = 0.7f + sinf(GetTime() * 5.0f) * 0.3f;
-                Vector3 indicatorPos = {doorPos.x, doorPos.y + 3.0f, doorPos.z};
-                DrawSphere(indicatorPos, 0.25f * pulse, YELLOW);
-                DrawCircle3D(doorPos, 3.0f, {0, 1, 0}, 90, Fade(YELLOW, 0.3f));
-            } else if (distance <= 5.0f && !state_.isInBuilding) {
-                DrawCircle3D(doorPos, 3.0f, {0, 1, 0}, 90, Fade(YELLOW, 0.1f));
-            }
+void RenderSystem::render3DInteractions([[maybe_unused]] const Camera3D& camera) {
+    if (state_.player.isInBuilding) return;
+    RenderPassScope pass(RenderPass::INTERACTIONS);
+    RenderStats& stats = RenderStats::getInstance();
+
+    // Nearest first, from this frame's interaction query
+    for (const NearbyInteractable& nearby : environment_.getNearbyInteractables()) {
+        if (nearby.kind != ObjectKind::BUILDING) continue;
+        Vector3 doorPos = nearby.anchor;
+
+        if (nearby.distance <= EnvironmentConstants::INTERACTION_DISTANCE) {
+            float pulse = 0.7f + sinf(GetTime() * 5.0f) * 0.3f;
+            Vector3 indicatorPos = {doorPos.x, doorPos.y + 3.0f, doorPos.z};
+            DrawSphere(indicatorPos, 0.25f * pulse, YELLOW);
+            DrawCircle3D(doorPos, 3.0f, {0, 1, 0}, 90, Fade(YELLOW, 0.3f));
+            stats.recordShape(INDICATOR_SPHERE_VERTICES);
+            stats.recordShape(RenderStats::CIRCLE_3D_VERTICES);
+        } else if (nearby.distance <= 5.0f) {
+            DrawCircle3D(doorPos, 3.0f, {0, 1, 0}, 90, Fade(YELLOW, 0.1f));
+            stats.recordShape(RenderStats::CIRCLE_3D_VERTICES);
+        } else {
+            break;  // Sorted, so the rest are farther still
         }
     }
 }
 
 void RenderSystem::render2DOverlays(const Camera3D& camera, float time) {
+    MemoryTagScope memoryTag(MemoryTag::UI);
+
     // Location text
-    std::string locationText = getLocationText();
-    Color locationColor = (state_.isInBuilding) ? YELLOW : WHITE;
-    DrawText(locationText.c_str(), 10, 40, 16, locationColor);
+    const char* locationText = getLocationText();
+    Color locationColor = (state_.player.isInBuilding) ? YELLOW : WHITE;
+    DrawText(locationText, 10, 40, 16, locationColor);
 
     // Jump text
-    std::string jumpText = getJumpText();
-    if (!jumpText.empty()) {
-        DrawText(jumpText.c_str(), 10, 160, 16, WHITE);
+    if (const char* jumpText = getJumpText()) {
+        DrawText(jumpText, 10, 160, 16, WHITE);
     }
 
     // UI system
     {
-        // PROFILE_SYSTEM(performanceStats_, ui); // TEMPORARILY DISABLED
+        PROFILE_SCOPE("UI");
         g_uiSystem->renderAllUI(camera, state_, time);
     }
 
@@ -106,38 +148,25 @@ void RenderSystem::render2DOverlays(const Camera3D& camera, float time) {
     // renderAdvancedPerformanceOverlay(performanceStats_, GetScreenWidth() - 310, 10); // TEMPORARILY DISABLED
 
     // Projected labels
-    renderProjectedLabels(camera, environment_, state_.isInBuilding, state_.currentBuilding);
+    renderProjectedLabels(camera, environment_, state_.player.isInBuilding, state_.player.currentBuilding);
 
     // Debug camera pos
     DrawText(TextFormat("Camera: %.1f, %.1f, %.1f", camera.position.x, camera.position.y, camera.position.z),
              10, GetScreenHeight() - 30, 16, WHITE);
 }
 
-std::string RenderSystem::getLocationText() const {
-    std::string locationText = "Town Square";
-    if (state_.isInBuilding && state_.currentBuilding >= 0) {
-        auto objects = environment_.getAllObjects();
-        bool foundBuilding = false;
-        for (const auto& obj : objects) {
-            if (auto building = std::dynamic_pointer_cast<Building>(obj)) {
-                if (building->getId() == state_.currentBuilding) {
-                    locationText = "Inside: " + building->getName();
-                    foundBuilding = true;
-                    break;
-                }
-            }
-        }
-        if (!foundBuilding) {
-            locationText = "Inside Building";
-        }
+const char* RenderSystem::getLocationText() const {
+    if (state_.player.isInBuilding && state_.player.currentBuilding >= 0) {
+        const Building* building = environment_.findBuilding(state_.player.currentBuilding);
+        return building ? FrameArena::getInstance().format("Inside: %s", building->getName().c_str()) : "Inside Building";
     }
-    return locationText;
+    return "Town Square";
 }
 
-std::string RenderSystem::getJumpText() const {
-    if (state_.isJumping) {
-        float jumpHeight = state_.playerY - 0.0f;  // groundLevel
-        return TextFormat("Jumping: %.1fm", jumpHeight);
+const char* RenderSystem::getJumpText() const {
+    if (state_.player.isJumping) {
+        float jumpHeight = state_.player.y - 0.0f;  // groundLevel
+        return FrameArena::getInstance().format("Jumping: %.1fm", jumpHeight);
     }
-    return "";
+    return nullptr;
 }
\ No newline at end of file
@@ -8,27 +8,34 @@
 #include "constants.h"
 #include "render_utils.h"  // For renderBuildingInterior, renderNPC, etc.
 #include "ui_system.h"     // For g_uiSystem
-#include "npc.h"           // For MAX_NPCS, npcs
+#include "npc.h"           // For NPCSystem
 #include "combat.h"        // For renderCombat
+#include "cell_visibility.h"
 
 // Forward declaration for SimplePerformanceStats
 struct SimplePerformanceStats;
+struct SystemTimer;
 
 class RenderSystem {
 public:
     RenderSystem(GameState& state, EnvironmentManager& environment, SimplePerformanceStats& performanceStats);
     void renderAll(const Camera3D& camera, float time);
 
+    /// \brief Times the 2D overlay (HUD and UI) pass with `timer`; null stops timing it.
+    void setUITimer(SystemTimer* timer) { uiTimer_ = timer; }
+
 private:
     GameState& state_;
     EnvironmentManager& environment_;
     SimplePerformanceStats& performanceStats_;
+    SystemTimer* uiTimer_ = nullptr;
 
     void render3DWorld(const Camera3D& camera, float time);
     void render3DInteractions(const Camera3D& camera);
     void render2DOverlays(const Camera3D& camera, float time);
-    std::string getLocationText() const;
-    std::string getJumpText() const;
+    /// \brief HUD strings; the text lives in the frame arena until this frame's EndDrawing.
+    const char* getLocationText() const;
+    const char* getJumpText() const;   // nullptr when not jumping
 };
 
 #endif // RENDER_SYSTEM_H
\ No newline at end of file
@@ -1,7 +1,10 @@
 // render_utils.cpp
 #include "render_utils.h"
 #include "math_utils.h"
+#include "constants.h"
 #include "ui_theme_optimized.h"
+#include "dialog_system.h"
+#include "render_stats.h"
 #include <iostream>
 #include <cmath>
 
@@ -15,13 +18,68 @@ Color fadeColor(Color color, float alpha) {
     };
 }
 
-void renderBuildingInterior(const Building& building) {
-    // Simplified interior - just render floor and subtle ambient lighting
+namespace {
+
+Color shade(Color c, float factor) {
+    return {static_cast<unsigned char>(c.r * factor), static_cast<unsigned char>(c.g * factor),
+            static_cast<unsigned char>(c.b * factor), c.a};
+}
+
+// Slab of wall from `from` to `to` along its length, `bottom` to `top` in height
+void drawWallSlab(RenderQueue& queue, Vector3 centre, bool alongX, float from, float to, float bottom, float top, Color color) {
+    const float thickness = 0.1f;
+    if (to <= from || top <= bottom) return;
+    float mid = (from + to) / 2;
+    Vector3 pos = alongX ? Vector3{centre.x + mid, (bottom + top) / 2, centre.z}
+                         : Vector3{centre.x, (bottom + top) / 2, centre.z + mid};
+    queue.submitCube(pos, {alongX ? to - from : thickness, top - bottom, alongX ? thickness : to - from}, color);
+}
+
+}  // namespace
+
+void renderBuildingInterior(const Building& building, RenderQueue& queue) {
+    // Simplified interior - floor, walls, ceiling and subtle ambient lighting
     Vector3 buildingSize = building.getSize();
 
     // Simple floor
     Vector3 floorPos = {building.position.x, building.position.y - buildingSize.y/2 + 0.02f, building.position.z};
-    DrawCube(floorPos, buildingSize.x * 0.95f, 0.04f, buildingSize.z * 0.95f, DARKGRAY);
+    queue.submitCube(floorPos, {buildingSize.x * 0.95f, 0.04f, buildingSize.z * 0.95f}, DARKGRAY);
+
+    // Walls and ceiling just inside the shell, whose faces point away from here and are culled.
+    // With the exterior only drawn through the doorway, they are what hides the rest of it.
+    const Vector3 c = building.position;
+    const float inset = 0.07f;
+    float floorY = c.y - buildingSize.y / 2;
+    float ceilingY = c.y + buildingSize.y / 2 - inset;
+    Color wallColor = shade(building.getColor(), 0.55f);
+    queue.submitCube({c.x, ceilingY, c.z}, {buildingSize.x, 0.1f, buildingSize.z}, shade(wallColor, 0.8f));
+
+    Vector3 doorway[4];
+    building.getDoorway(doorway);
+    Vector3 door = building.getDoorPosition();
+    float doorX = door.x - c.x, doorZ = door.z - c.z;
+    bool doorOnZWall = std::fabs(doorZ) * buildingSize.x >= std::fabs(doorX) * buildingSize.z;
+    float doorHalfWidth = std::sqrt(MathUtils::distanceSquared3D(doorway[0], doorway[1])) / 2;
+    float doorTop = doorway[2].y;
+
+    for (int side = 0; side < 4; ++side) {
+        bool alongX = side < 2;  // The two walls facing +/-z run along x
+        float sign = (side % 2) ? 1.0f : -1.0f;
+        float halfLength = (alongX ? buildingSize.x : buildingSize.z) / 2;
+        Vector3 centre = alongX ? Vector3{c.x, 0.0f, c.z + sign * (buildingSize.z / 2 - inset)}
+                                : Vector3{c.x + sign * (buildingSize.x / 2 - inset), 0.0f, c.z};
+        float doorOffset = alongX ? doorZ : doorX;
+        bool hasDoor = alongX == doorOnZWall && (doorOffset > 0) == (sign > 0);
+        if (!hasDoor) {
+            drawWallSlab(queue, centre, alongX, -halfLength, halfLength, floorY, ceilingY, wallColor);
+            continue;
+        }
+        // Leave the doorway open: the portal the exterior is seen through
+        float doorMid = alongX ? doorX : doorZ;
+        drawWallSlab(queue, centre, alongX, -halfLength, doorMid - doorHalfWidth, floorY, ceilingY, wallColor);
+        drawWallSlab(queue, centre, alongX, doorMid + doorHalfWidth, halfLength, floorY, ceilingY, wallColor);
+        drawWallSlab(queue, centre, alongX, doorMid - doorHalfWidth, doorMid + doorHalfWidth, doorTop, ceilingY, wallColor);
+    }
 
     // Subtle ambient lighting - very dim corner lights
     float cornerOffset = buildingSize.x * 0.35f;
@@ -33,73 +91,91 @@ void renderBuildingInterior(const Building& building) {
     };
 
     for (int i = 0; i < 4; i++) {
-        DrawSphere(corners[i], 0.2f, Fade(WHITE, 0.05f));
+        queue.submitSphere(corners[i], 0.2f, 16, 16, Fade(WHITE, 0.05f));
     }
 }
 
-void renderNPC(const NPC& npc, Camera3D camera, float currentTime) {
-    DrawCylinder(npc.position, 0.8f, 0.5f, 1.6f, 12, npc.color);
-    DrawCylinderWires(npc.position, 0.8f, 0.5f, 1.6f, 12, BLACK);
+void renderNPC(const NPCSystem& npcs, int id, Camera3D camera, float currentTime, RenderQueue& queue) {
+    const Vector3 position = npcs.getPosition(id);
+    const Color color = npcs.getColor(id);
+    const float interactionRadius = npcs.getInteractionRadius(id);
 
-    Vector3 headPos = {npc.position.x, npc.position.y + 1.8f, npc.position.z};
-    DrawSphere(headPos, 0.45f, npc.color);
-    DrawSphereWires(headPos, 0.45f, 12, 8, BLACK);
+    queue.submitCylinder(position, 0.8f, 0.5f, 1.6f, 12, color);
+    queue.submitCylinderWires(position, 0.8f, 0.5f, 1.6f, 12, BLACK);
 
-    Vector3 leftArmPos = {npc.position.x - 0.6f, npc.position.y + 0.8f, npc.position.z};
-    Vector3 rightArmPos = {npc.position.x + 0.6f, npc.position.y + 0.8f, npc.position.z};
-    DrawCylinder(leftArmPos, 0.15f, 0.15f, 0.8f, 8, Fade(npc.color, 0.9f));
-    DrawCylinder(rightArmPos, 0.15f, 0.15f, 0.8f, 8, Fade(npc.color, 0.9f));
+    Vector3 headPos = {position.x, position.y + 1.8f, position.z};
+    queue.submitSphere(headPos, 0.45f, 16, 16, color);
+    queue.submitSphereWires(headPos, 0.45f, 12, 8, BLACK);
 
-    Vector3 leftLegPos = {npc.position.x - 0.25f, npc.position.y - 0.4f, npc.position.z};
-    Vector3 rightLegPos = {npc.position.x + 0.25f, npc.position.y - 0.4f, npc.position.z};
-    DrawCylinder(leftLegPos, 0.2f, 0.15f, 0.8f, 8, Fade(npc.color, 0.8f));
-    DrawCylinder(rightLegPos, 0.2f, 0.15f, 0.8f, 8, Fade(npc.color, 0.8f));
+    Vector3 leftArmPos = {position.x - 0.6f, position.y + 0.8f, position.z};
+    Vector3 rightArmPos = {position.x + 0.6f, position.y + 0.8f, position.z};
+    queue.submitCylinder(leftArmPos, 0.15f, 0.15f, 0.8f, 8, Fade(color, 0.9f));
+    queue.submitCylinder(rightArmPos, 0.15f, 0.15f, 0.8f, 8, Fade(color, 0.9f));
 
-    float distance = MathUtils::distance3D(npc.position, camera.position);
+    Vector3 leftLegPos = {position.x - 0.25f, position.y - 0.4f, position.z};
+    Vector3 rightLegPos = {position.x + 0.25f, position.y - 0.4f, position.z};
+    queue.submitCylinder(leftLegPos, 0.2f, 0.15f, 0.8f, 8, Fade(color, 0.8f));
+    queue.submitCylinder(rightLegPos, 0.2f, 0.15f, 0.8f, 8, Fade(color, 0.8f));
 
-    if (distance <= npc.interactionRadius) {
+    float distanceSq = MathUtils::distanceSquared3D(position, camera.position);
+    float outerRadius = interactionRadius * 1.8f;
+
+    // Rings have no queue kind and go straight to rlgl
+    RenderStats& stats = RenderStats::getInstance();
+    if (distanceSq <= interactionRadius * interactionRadius) {
         float pulse = 0.8f + sinf(currentTime * 6.0f) * 0.4f;
-        Vector3 indicatorPos = {npc.position.x, npc.position.y + 3.0f, npc.position.z};
-        DrawSphere(indicatorPos, 0.2f * pulse, GREEN);
+        Vector3 indicatorPos = {position.x, position.y + 3.0f, position.z};
+        queue.submitSphere(indicatorPos, 0.2f * pulse, 16, 16, GREEN);
 
-        DrawCircle3D(npc.position, npc.interactionRadius, {0, 1, 0}, 90, Fade(GREEN, 0.4f));
+        DrawCircle3D(position, interactionRadius, {0, 1, 0}, 90, Fade(GREEN, 0.4f));
+        stats.recordShape(RenderStats::CIRCLE_3D_VERTICES);
 
-        DrawCylinder(npc.position, 0.85f, 0.55f, 1.65f, 12, Fade(YELLOW, 0.2f));
-    } else if (distance <= npc.interactionRadius * 1.8f) {
-        DrawCircle3D(npc.position, npc.interactionRadius, {0, 1, 0}, 90, Fade(YELLOW, 0.15f));
+        queue.submitCylinder(position, 0.85f, 0.55f, 1.65f, 12, Fade(YELLOW, 0.2f));
+    } else if (distanceSq <= outerRadius * outerRadius) {
+        DrawCircle3D(position, interactionRadius, {0, 1, 0}, 90, Fade(YELLOW, 0.15f));
+        stats.recordShape(RenderStats::CIRCLE_3D_VERTICES);
     }
 }
 
+void renderNPCSimple(const NPCSystem& npcs, int id, RenderQueue& queue) {
+    // Mid-distance crowd: body and head only, no outlines or indicators
+    const Vector3 position = npcs.getPosition(id);
+    const Color color = npcs.getColor(id);
+    queue.submitCylinder(position, 0.8f, 0.5f, 1.6f, RenderConstants::CYLINDER_SEGMENTS_LOW, color);
+    queue.submitSphere({position.x, position.y + 1.8f, position.z}, 0.45f, 16, 16, color);
+}
+
 void renderProjectedLabels(Camera3D camera, const EnvironmentManager& environment, bool isInBuilding, int currentBuilding) {
-    auto objects = environment.getAllObjects();
+    const auto& objects = environment.getAllObjects();
     int screenWidth = GetScreenWidth();
     int screenHeight = GetScreenHeight();
 
-    for (const auto& obj : objects) {
-        if (auto building = std::dynamic_pointer_cast<Building>(obj)) {
-            Vector3 signPos = building->getDoorPosition();
+    // Signs and name tags within the frame's interaction query radius
+    for (const NearbyInteractable& nearby : environment.getNearbyInteractables()) {
+        const EnvironmentalObject* obj = objects[nearby.index].get();
+
+        if (const Building* building = objectCast<Building>(obj)) {
+            Vector3 signPos = nearby.anchor;
             signPos.y += 2.2f;
             Vector2 screenPos = GetWorldToScreen(signPos, camera);
             if (screenPos.x > 0 && screenPos.x < screenWidth && screenPos.y > 0 && screenPos.y < screenHeight) {
-                int textWidth = MeasureText(building->getName().c_str(), 20);
-                DrawText(building->getName().c_str(), screenPos.x - textWidth / 2, screenPos.y - 20, 20, BLACK);
+                const std::string& name = building->getName();
+                int textWidth = MeasureText(name.c_str(), 20);
+                DrawText(name.c_str(), screenPos.x - textWidth / 2, screenPos.y - 20, 20, BLACK);
             }
-        }
-    }
-
-    for (int n = 0; n < MAX_NPCS; n++) {
-        bool shouldLabelNPC = false;
-        if (isInBuilding) {
-            if (currentBuilding == 0 && n == 0) shouldLabelNPC = true;
-            if (currentBuilding == 1 && n == 1) shouldLabelNPC = true;
-        }
-        if (shouldLabelNPC) {
-            Vector3 labelPos = npcs[n].position;
+        } else if (const NpcAnchor* anchor = objectCast<NpcAnchor>(obj)) {
+            const NPCSystem& npcs = NPCSystem::getInstance();
+            int id = anchor->getNpcIndex();
+            if (!npcs.isVisible(id, isInBuilding, currentBuilding)) continue;
+            // Indoors there's one NPC to a room; outside only tag the people close by
+            if (!isInBuilding && nearby.distance > NPCConstants::LABEL_DISTANCE) continue;
+            const std::string& name = npcs.getName(id);
+            Vector3 labelPos = npcs.getPosition(id);
             labelPos.y += 2.5f;
             Vector2 screenPos = GetWorldToScreen(labelPos, camera);
             if (screenPos.x > 0 && screenPos.x < screenWidth && screenPos.y > 0 && screenPos.y < screenHeight) {
-                int textWidth = MeasureText(npcs[n].name.c_str(), 18);
-                DrawText(npcs[n].name.c_str(), screenPos.x - textWidth / 2, screenPos.y - 20, 18, WHITE);
+                int textWidth = MeasureText(name.c_str(), 18);
+                DrawText(name.c_str(), screenPos.x - textWidth / 2, screenPos.y - 20, 18, WHITE);
             }
         }
     }
@@ -109,20 +185,20 @@ void renderUI([[maybe_unused]] Camera3D camera, float currentTime, const GameSta
     int screenWidth = GetScreenWidth();
     int screenHeight = GetScreenHeight();
 
-    if (!state.isInDialog && !state.mouseReleased) {
+    if (!state.dialog.active && !state.ui.mouseReleased) {
         int centerX = screenWidth / 2;
         int centerY = screenHeight / 2;
         Color crosshairColor = UITypes::GetThemeColor(UITypes::ColorRole::ACCENT);
         DrawLine(centerX - 10, centerY, centerX + 10, centerY, crosshairColor);
         DrawLine(centerX, centerY - 10, centerX, centerY + 10, crosshairColor);
-    } else if (state.isInDialog) {
+    } else if (state.dialog.active) {
         int centerX = screenWidth / 2;
         int centerY = screenHeight / 2;
         Color accentColor = UITypes::GetThemeColor(UITypes::ColorRole::ACCENT);
         DrawCircle(centerX, centerY, 8, fadeColor(accentColor, 0.5f));
         DrawCircleLines(centerX, centerY, 8, accentColor);
         DrawText("DIALOG", centerX - 25, centerY - 25, 10, accentColor);
-    } else if (state.mouseReleased) {
+    } else if (state.ui.mouseReleased) {
         int centerX = screenWidth / 2;
         int centerY = screenHeight / 2;
         Color bgColor = UITypes::GetThemeColor(UITypes::ColorRole::BACKGROUND);
@@ -137,7 +213,7 @@ void renderUI([[maybe_unused]] Camera3D camera, float currentTime, const GameSta
 
     DrawFPS(10, 10);
 
-    if (state.showInteractPrompt && !state.isInDialog) {
+    if (state.ui.showInteractPrompt && !state.dialog.active) {
         float alpha = 0.8f + sinf(currentTime * 3.0f) * 0.1f;
         Color bgColor = UITypes::GetThemeColor(UITypes::ColorRole::BACKGROUND);
         Color accentColor = UITypes::GetThemeColor(UITypes::ColorRole::ACCENT);
@@ -146,7 +222,7 @@ void renderUI([[maybe_unused]] Camera3D camera, float currentTime, const GameSta
         DrawRectangle(5, 280, 400, 50, fadeColor(bgColor, alpha));
         DrawRectangleLines(5, 280, 400, 50, accentColor);
 
-        DrawText(state.interactPromptText.c_str(), 15, 290, 14, accentColor);
+        DrawText(state.ui.interactPromptText.c_str(), 15, 290, 14, accentColor);
         DrawText("[E] to interact", 15, 305, 12, textColor);
 
         DrawCircle(385, 305, 3, accentColor);
@@ -176,10 +252,10 @@ void renderUI([[maybe_unused]] Camera3D camera, float currentTime, const GameSta
     }
 
     // Mouse state indicator with theme colors
-    Color mouseStateColor = state.mouseReleased ?
+    Color mouseStateColor = state.ui.mouseReleased ?
         UITypes::GetThemeColor(UITypes::ColorRole::WARNING) :
         UITypes::GetThemeColor(UITypes::ColorRole::SUCCESS);
-    const char* mouseStateText = state.mouseReleased ? "MOUSE FREE" : "MOUSE CAPTURED";
+    const char* mouseStateText = state.ui.mouseReleased ? "MOUSE FREE" : "MOUSE CAPTURED";
     Color bgColor = UITypes::GetThemeColor(UITypes::ColorRole::BACKGROUND);
     Color textColor = UITypes::GetThemeColor(UITypes::ColorRole::TEXT_PRIMARY);
 
@@ -210,56 +286,56 @@ void renderTestingPanel(const GameState& state, const std::string& locationText,
     DrawText("=== MOVEMENT & CONTROLS ===", 15, yOffset, 14, accentColor);
     yOffset += 18;
 
-    Color mouseColor = state.testMouseCaptured ? successColor : errorColor;
-    DrawText(TextFormat("🖱️  Mouse Capture: %s", state.testMouseCaptured ? "✓ WORKING" : "✗ BROKEN"), 20, yOffset, 12, mouseColor);
+    Color mouseColor = state.tests.mouseCaptured ? successColor : errorColor;
+    DrawText(TextFormat("🖱️  Mouse Capture: %s", state.tests.mouseCaptured ? "✓ WORKING" : "✗ BROKEN"), 20, yOffset, 12, mouseColor);
     yOffset += 15;
 
-    Color wasdColor = state.testWASDMovement ? successColor : warningColor;
-    DrawText(TextFormat("🏃 WASD Movement: %s", state.testWASDMovement ? "✓ TESTED" : "⏳ UNTESTED"), 20, yOffset, 12, wasdColor);
+    Color wasdColor = state.tests.wasdMovement ? successColor : warningColor;
+    DrawText(TextFormat("🏃 WASD Movement: %s", state.tests.wasdMovement ? "✓ TESTED" : "⏳ UNTESTED"), 20, yOffset, 12, wasdColor);
     yOffset += 15;
 
-    Color jumpColor = state.testSpaceJump ? successColor : warningColor;
-    DrawText(TextFormat("🦘 Space Jump: %s", state.testSpaceJump ? "✓ TESTED" : "⏳ UNTESTED"), 20, yOffset, 12, jumpColor);
+    Color jumpColor = state.tests.spaceJump ? successColor : warningColor;
+    DrawText(TextFormat("🦘 Space Jump: %s", state.tests.spaceJump ? "✓ TESTED" : "⏳ UNTESTED"), 20, yOffset, 12, jumpColor);
     yOffset += 15;
 
-    Color lookColor = state.testMouseLook ? successColor : warningColor;
-    DrawText(TextFormat("👁️  Mouse Look: %s", state.testMouseLook ? "✓ TESTED" : "⏳ UNTESTED"), 20, yOffset, 12, lookColor);
+    Color lookColor = state.tests.mouseLook ? successColor : warningColor;
+    DrawText(TextFormat("👁️  Mouse Look: %s", state.tests.mouseLook ? "✓ TESTED" : "⏳ UNTESTED"), 20, yOffset, 12, lookColor);
     yOffset += 18;
 
     DrawText("=== COMBAT SYSTEM ===", 15, yOffset, 14, accentColor);
     yOffset += 18;
 
-    Color swingColor = state.testMeleeSwing ? successColor : warningColor;
-    DrawText(TextFormat("⚔️  Melee Attack: %s", state.testMeleeSwing ? "✓ TESTED" : "⏳ UNTESTED"), 20, yOffset, 12, swingColor);
+    Color swingColor = state.tests.meleeSwing ? successColor : warningColor;
+    DrawText(TextFormat("⚔️  Melee Attack: %s", state.tests.meleeSwing ? "✓ TESTED" : "⏳ UNTESTED"), 20, yOffset, 12, swingColor);
     yOffset += 15;
 
-    Color hitColor = state.testMeleeHitDetection ? successColor : warningColor;
-    DrawText(TextFormat("Hit Detection: %s", state.testMeleeHitDetection ? "TESTED" : "UNTESTED"), 20, yOffset, 12, hitColor);
+    Color hitColor = state.tests.meleeHitDetection ? successColor : warningColor;
+    DrawText(TextFormat("Hit Detection: %s", state.tests.meleeHitDetection ? "TESTED" : "UNTESTED"), 20, yOffset, 12, hitColor);
     yOffset += 18;
 
     DrawText("=== WORLD INTERACTION ===", 15, yOffset, 14, accentColor);
     yOffset += 18;
 
-    Color buildingColor = state.testBuildingEntry ? successColor : warningColor;
-    DrawText(TextFormat("🏛️  Building Entry: %s", state.testBuildingEntry ? "✓ TESTED" : "⏳ UNTESTED"), 20, yOffset, 12, buildingColor);
+    Color buildingColor = state.tests.buildingEntry ? successColor : warningColor;
+    DrawText(TextFormat("🏛️  Building Entry: %s", state.tests.buildingEntry ? "✓ TESTED" : "⏳ UNTESTED"), 20, yOffset, 12, buildingColor);
     yOffset += 15;
 
-    Color npcColor = state.testNPCInteraction ? successColor : warningColor;
-    DrawText(TextFormat("👥 NPC Dialog: %s", state.testNPCInteraction ? "✓ TESTED" : "⏳ UNTESTED"), 20, yOffset, 12, npcColor);
+    Color npcColor = state.tests.npcInteraction ? successColor : warningColor;
+    DrawText(TextFormat("👥 NPC Dialog: %s", state.tests.npcInteraction ? "✓ TESTED" : "⏳ UNTESTED"), 20, yOffset, 12, npcColor);
     yOffset += 18;
 
     DrawText("=== SYSTEM STATUS ===", 15, yOffset, 14, accentColor);
     yOffset += 18;
 
-    Color mouseStateColor = state.mouseReleased ? warningColor : successColor;
-    DrawText(TextFormat("🖱️  Mouse State: %s", state.mouseReleased ? "FREE" : "CAPTURED"), 20, yOffset, 12, mouseStateColor);
+    Color mouseStateColor = state.ui.mouseReleased ? warningColor : successColor;
+    DrawText(TextFormat("🖱️  Mouse State: %s", state.ui.mouseReleased ? "FREE" : "CAPTURED"), 20, yOffset, 12, mouseStateColor);
     yOffset += 15;
 
     DrawText(TextFormat("📍 Location: %s", locationText.c_str()), 20, yOffset, 12, locationColor);
     yOffset += 15;
 
-    Color dialogColor = state.isInDialog ? UITypes::GetThemeColor(UITypes::ColorRole::INFO) : textSecondary;
-    DrawText(TextFormat("💬 Dialog: %s", state.isInDialog ? "ACTIVE" : "INACTIVE"), 20, yOffset, 12, dialogColor);
+    Color dialogColor = state.dialog.active ? UITypes::GetThemeColor(UITypes::ColorRole::INFO) : textSecondary;
+    DrawText(TextFormat("💬 Dialog: %s", state.dialog.active ? "ACTIVE" : "INACTIVE"), 20, yOffset, 12, dialogColor);
     yOffset += 20;
 
     DrawText("TEST ALL FEATURES:", 15, yOffset, 12, textPrimary);
@@ -284,12 +360,12 @@ void renderGameStats(const GameState& state) {
     DrawRectangleLines(5, 450, 250, 100, borderColor);
 
     DrawText("📊 GAME STATISTICS", 15, 455, 16, textPrimary);
-    DrawText(TextFormat("🏆 Score: %d points", state.score), 20, 475, 12, textSecondary);
-    DrawText(TextFormat("⚔️  Swings: %d", state.swingsPerformed), 20, 490, 12, textSecondary);
-    DrawText(TextFormat("Hits: %d", state.meleeHits), 20, 505, 12, textSecondary);
-    float accuracy = state.swingsPerformed > 0 ? (float)state.meleeHits / state.swingsPerformed * 100.0f : 0.0f;
+    DrawText(TextFormat("🏆 Score: %d points", state.combat.score), 20, 475, 12, textSecondary);
+    DrawText(TextFormat("⚔️  Swings: %d", state.combat.swingsPerformed), 20, 490, 12, textSecondary);
+    DrawText(TextFormat("Hits: %d", state.combat.meleeHits), 20, 505, 12, textSecondary);
+    float accuracy = state.combat.swingsPerformed > 0 ? (float)state.combat.meleeHits / state.combat.swingsPerformed * 100.0f : 0.0f;
     DrawText(TextFormat("📈 Accuracy: %.1f%%", accuracy), 20, 520, 12, textSecondary);
-    DrawText(TextFormat("🏢 Buildings: %d/2", state.testBuildingEntry ? 1 : 0), 20, 535, 12, accentColor);
+    DrawText(TextFormat("🏢 Buildings: %d/2", state.tests.buildingEntry ? 1 : 0), 20, 535, 12, accentColor);
 }
 
 void renderDialogWindow(const GameState& state) {
@@ -306,7 +382,8 @@ void renderDialogWindow(const GameState& state) {
 
     DrawText("Conversation", 40, 260, 18, textPrimary);
 
-    DrawText(state.dialogText.c_str(), 40, 285, 14, textSecondary);
+    const DialogView& view = DialogSystem::getInstance().getView(state);
+    DrawText(view.text.c_str(), 40, 285, 14, textSecondary);
 
     const int buttonY = 320;
     const int buttonHeight = 30;
@@ -316,7 +393,7 @@ void renderDialogWindow(const GameState& state) {
 
     Vector2 mousePos = GetMousePosition();
 
-    for (int i = 0; i < state.numDialogOptions; i++) {
+    for (int i = 0; i < view.optionCount; i++) {
         int buttonX = startX + (i * buttonSpacing);
 
         bool isHovered = (mousePos.y >= buttonY && mousePos.y <= buttonY + buttonHeight &&
@@ -331,7 +408,7 @@ void renderDialogWindow(const GameState& state) {
         DrawRectangle(buttonX, buttonY, buttonWidth, buttonHeight, buttonColor);
         DrawRectangleLines(buttonX, buttonY, buttonWidth, buttonHeight, borderColor);
 
-        DrawText(state.dialogOptions[i].c_str(), buttonX + 10, buttonY + 8, 12, textPrimary);
+        DrawText(view.options[i].data(), buttonX + 10, buttonY + 8, 12, textPrimary);
 
         if (isHovered) {
             DrawText(">", buttonX - 15, buttonY + 8, 12, accentColor);
@@ -370,26 +447,26 @@ void renderPlayerStatsUI(const GameState& state) {
     DrawText("PLAYER STATUS", statsX + 10, statsY + 5, 14, textPrimary);
 
     // Health bar
-    float healthPercent = (float)state.playerHealth / state.maxPlayerHealth;
-    DrawText(TextFormat("HP: %d/%d", state.playerHealth, state.maxPlayerHealth),
+    float healthPercent = (float)state.player.health / state.player.maxHealth;
+    DrawText(TextFormat("HP: %d/%d", state.player.health, state.player.maxHealth),
              statsX + 10, statsY + 25, 12, healthColor);
     DrawRectangle(statsX + 10, statsY + 40, 180, 8, fadeColor(bgColor, 0.6f));
     DrawRectangle(statsX + 10, statsY + 40, (int)(180 * healthPercent), 8, healthColor);
 
     // Mana bar
-    float manaPercent = (float)state.playerMana / state.maxPlayerMana;
-    DrawText(TextFormat("MP: %d/%d", state.playerMana, state.maxPlayerMana),
+    float manaPercent = (float)state.player.mana / state.player.maxMana;
+    DrawText(TextFormat("MP: %d/%d", state.player.mana, state.player.maxMana),
              statsX + 10, statsY + 55, 12, manaColor);
     DrawRectangle(statsX + 10, statsY + 70, 180, 8, fadeColor(bgColor, 0.6f));
     DrawRectangle(statsX + 10, statsY + 70, (int)(180 * manaPercent), 8, manaColor);
 
     // Level and experience
-    DrawText(TextFormat("Level %d", state.playerLevel), statsX + 10, statsY + 85, 12, experienceColor);
-    DrawText(TextFormat("XP: %d", state.playerExperience), statsX + 100, statsY + 85, 12, experienceColor);
+    DrawText(TextFormat("Level %d", state.player.level), statsX + 10, statsY + 85, 12, experienceColor);
+    DrawText(TextFormat("XP: %d", state.player.experience), statsX + 100, statsY + 85, 12, experienceColor);
 
     // Equipment bonuses (if any)
     if (state.inventorySystem) {
-        auto totalStats = state.inventorySystem->getTotalBonuses();
+        const ItemStats& totalStats = state.inventorySystem->getTotalBonuses();
         if (totalStats.damage > 0 || totalStats.armor > 0) {
             Color successColor = UITypes::GetThemeColor(UITypes::ColorRole::SUCCESS);
             DrawText(TextFormat("DMG+%d ARM+%d", totalStats.damage, totalStats.armor),
@@ -401,27 +478,27 @@ void renderPlayerStatsUI(const GameState& state) {
 void printFinalSummary(const GameState& state) {
     std::cout << "\nTOWN EXPLORATION TEST SUMMARY:" << std::endl;
     std::cout << "==================================" << std::endl;
-    std::cout << (state.testMouseCaptured ? "[OK]" : "[X]") << " Mouse Capture: " << (state.testMouseCaptured ? "WORKING" : "NOT WORKING") << std::endl;
-    std::cout << (state.testWASDMovement ? "[OK]" : "[X]") << " WASD Movement: " << (state.testWASDMovement ? "WORKING" : "NOT TESTED") << std::endl;
-    std::cout << (state.testSpaceJump ? "[OK]" : "[X]") << " Space Jump: " << (state.testSpaceJump ? "WORKING" : "NOT TESTED") << std::endl;
-    std::cout << (state.testMouseLook ? "[OK]" : "[X]") << " Mouse Look: " << (state.testMouseLook ? "WORKING" : "NOT TESTED") << std::endl;
-    std::cout << (state.testMeleeSwing ? "[OK]" : "[X]") << " Longsword Swing: " << (state.testMeleeSwing ? "WORKING" : "NOT TESTED") << std::endl;
-    std::cout << (state.testMeleeHitDetection ? "[OK]" : "[X]") << " Melee Hit Detection: " << (state.testMeleeHitDetection ? "WORKING" : "NOT TESTED") << std::endl;
-    std::cout << (state.testBuildingEntry ? "[OK]" : "[X]") << " Building Entry: " << (state.testBuildingEntry ? "WORKING" : "NOT TESTED") << std::endl;
-    std::cout << (state.testNPCInteraction ? "[OK]" : "[X]") << " NPC Interaction: " << (state.testNPCInteraction ? "WORKING" : "NOT TESTED") << std::endl;
-
-    int workingFeatures = (state.testMouseCaptured ? 1 : 0) + (state.testWASDMovement ? 1 : 0) +
-                          (state.testSpaceJump ? 1 : 0) + (state.testMouseLook ? 1 : 0) +
-                          (state.testMeleeSwing ? 1 : 0) + (state.testMeleeHitDetection ? 1 : 0) +
-                          (state.testBuildingEntry ? 1 : 0) + (state.testNPCInteraction ? 1 : 0);
-
-    std::cout << "\n🏆 Final Score: " << state.score << " points" << std::endl;
+    std::cout << (state.tests.mouseCaptured ? "[OK]" : "[X]") << " Mouse Capture: " << (state.tests.mouseCaptured ? "WORKING" : "NOT WORKING") << std::endl;
+    std::cout << (state.tests.wasdMovement ? "[OK]" : "[X]") << " WASD Movement: " << (state.tests.wasdMovement ? "WORKING" : "NOT TESTED") << std::endl;
+    std::cout << (state.tests.spaceJump ? "[OK]" : "[X]") << " Space Jump: " << (state.tests.spaceJump ? "WORKING" : "NOT TESTED") << std::endl;
+    std::cout << (state.tests.mouseLook ? "[OK]" : "[X]") << " Mouse Look: " << (state.tests.mouseLook ? "WORKING" : "NOT TESTED") << std::endl;
+    std::cout << (state.tests.meleeSwing ? "[OK]" : "[X]") << " Longsword Swing: " << (state.tests.meleeSwing ? "WORKING" : "NOT TESTED") << std::endl;
+    std::cout << (state.tests.meleeHitDetection ? "[OK]" : "[X]") << " Melee Hit Detection: " << (state.tests.meleeHitDetection ? "WORKING" : "NOT TESTED") << std::endl;
+    std::cout << (state.tests.buildingEntry ? "[OK]" : "[X]") << " Building Entry: " << (state.tests.buildingEntry ? "WORKING" : "NOT TESTED") << std::endl;
+    std::cout << (state.tests.npcInteraction ? "[OK]" : "[X]") << " NPC Interaction: " << (state.tests.npcInteraction ? "WORKING" : "NOT TESTED") << std::endl;
+
+    int workingFeatures = (state.tests.mouseCaptured ? 1 : 0) + (state.tests.wasdMovement ? 1 : 0) +
+                          (state.tests.spaceJump ? 1 : 0) + (state.tests.mouseLook ? 1 : 0) +
+                          (state.tests.meleeSwing ? 1 : 0) + (state.tests.meleeHitDetection ? 1 : 0) +
+                          (state.tests.buildingEntry ? 1 : 0) + (state.tests.npcInteraction ? 1 : 0);
+
+    std::cout << "\n🏆 Final Score: " << state.combat.score << " points" << std::endl;
     std::cout << "Features Working: " << workingFeatures << "/8" << std::endl;
-    std::cout << "🗡️  Swings Performed: " << state.swingsPerformed << std::endl;
-    std::cout << "Melee Hits: " << state.meleeHits << std::endl;
-    std::cout << "🏢 Buildings Visited: " << (state.testBuildingEntry ? "YES" : "NO") << std::endl;
-    std::cout << "👥 NPCs Talked To: " << (state.testNPCInteraction ? "YES" : "NO") << std::endl;
-    std::cout << "💬 Dialog Conversations: " << (state.isInDialog ? "ACTIVE" : "COMPLETED") << std::endl;
+    std::cout << "🗡️  Swings Performed: " << state.combat.swingsPerformed << std::endl;
+    std::cout << "Melee Hits: " << state.combat.meleeHits << std::endl;
+    std::cout << "🏢 Buildings Visited: " << (state.tests.buildingEntry ? "YES" : "NO") << std::endl;
+    std::cout << "👥 NPCs Talked To: " << (state.tests.npcInteraction ? "YES" : "NO") << std::endl;
+    std::cout << "💬 Dialog Conversations: " << (state.dialog.active ? "ACTIVE" : "COMPLETED") << std::endl;
 
     if (workingFeatures == 8) {
         std::cout << "ALL FEATURES WORKING PERFECTLY!" << std::endl;
@@ -433,7 +510,7 @@ void printFinalSummary(const GameState& state) {
 }
 
 void renderEscMenu(GameState& state) {  // **NON-CONST** to update selectedMenuOption
-    if (!state.showEscMenu) return;
+    if (!state.ui.showEscMenu) return;
 
     // **FULL SCREEN OVERLAY** - Dark background
     int screenWidth = GetScreenWidth();
@@ -478,13 +555,13 @@ void renderEscMenu(GameState& state) {  // **NON-CONST** to update selectedMenuO
         if (mousePos.x >= menuX + 20 && mousePos.x <= menuX + menuWidth - 20 &&
             mousePos.y >= buttonY && mousePos.y <= buttonY + buttonHeight) {
             hoveredOption = i;
-            state.selectedMenuOption = i;  // **AUTO-UPDATE** selection on hover
+            state.ui.selectedMenuOption = i;  // **AUTO-UPDATE** selection on hover
             break;
         }
     }
 
     for (int i = 0; i < 4; i++) {
-        bool isSelected = (i == state.selectedMenuOption);
+        bool isSelected = (i == state.ui.selectedMenuOption);
         Color optionColor = isSelected ? accentColor : textPrimary;
         Color buttonBgColor = isSelected ? fadeColor(accentColor, 0.3f) : fadeColor(surfaceColor, 0.1f);
 
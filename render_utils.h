@@ -7,10 +7,13 @@
 #include "npc.h"
 #include "environment_manager.h"
 #include "game_state.h"
+#include "render_queue.h"
 #include <string>
 
-void renderBuildingInterior(const Building& building);
-void renderNPC(const NPC& npc, Camera3D camera, float currentTime);
+// World pieces are queued, not drawn; RenderSystem flushes the queue with the rest of the opaque world
+void renderBuildingInterior(const Building& building, RenderQueue& queue);
+void renderNPC(const NPCSystem& npcs, int id, Camera3D camera, float currentTime, RenderQueue& queue);
+void renderNPCSimple(const NPCSystem& npcs, int id, RenderQueue& queue);
 void renderProjectedLabels(Camera3D camera, const EnvironmentManager& environment, bool isInBuilding, int currentBuilding);
 void renderUI(Camera3D camera, float currentTime, const GameState& state, bool testBuildingCollision);
 void renderTestingPanel(const GameState& state, const std::string& locationText, Color locationColor);
@@ -0,0 +1,131 @@
+#include "save_writer.h"
+#include "profiler.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+#ifdef _WIN32
+#include <io.h>
+#define SAVE_FSYNC(fd) _commit(fd)
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#define SAVE_FSYNC(fd) ::fsync(fd)
+#endif
+
+void SaveWriter::submit(const std::string& path, std::vector<char> bytes) {
+    // Held across the start so a concurrent stop() can't join the thread being replaced
+    std::lock_guard<std::mutex> lifecycle(lifecycle_mutex_);
+    bool start = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bool merged = false;
+        for (Job& job : queue_) {
+            if (job.path == path) {
+                job.bytes = std::move(bytes);  // Still waiting; the newer snapshot wins
+                merged = true;
+                break;
+            }
+        }
+        if (!merged) queue_.push_back({path, std::move(bytes)});
+        if (!running_) {
+            running_ = true;
+            start = true;
+        }
+    }
+
+    // Joined and started outside mutex_: the old writer needs it to finish
+    if (start) {
+        if (thread_.joinable()) thread_.join();
+        thread_ = std::thread(&SaveWriter::writerLoop, this);
+    }
+    work_cv_.notify_one();
+}
+
+void SaveWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this] { return queue_.empty() && !writing_; });
+}
+
+void SaveWriter::stop() {
+    std::lock_guard<std::mutex> lifecycle(lifecycle_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    work_cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool SaveWriter::writeAtomically(const std::string& path, const std::vector<char>& bytes) {
+    std::string tempPath = path + ".tmp";
+    std::FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        std::cerr << "SAVE: Failed to open " << tempPath << std::endl;
+        return false;
+    }
+    // On disk before the rename, or a crash could leave the rename pointing at a truncated file
+    bool written = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size() &&
+                   std::fflush(file) == 0 && SAVE_FSYNC(fileno(file)) == 0;
+    if (std::fclose(file) != 0) written = false;
+    if (!written) {
+        std::cerr << "SAVE: Failed to write " << tempPath << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    std::remove(path.c_str());  // rename() does not replace an existing file here
+#endif
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "SAVE: Failed to replace " << path << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+#ifndef _WIN32
+    // The rename itself lives in the directory; sync it too so the new name survives a crash
+    size_t slash = path.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int dirFd = ::open(directory.c_str(), O_RDONLY);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+#endif
+    return true;
+}
+
+void SaveWriter::writerLoop() {
+    Profiler::getInstance().setThreadName("Save Writer");
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [this] { return !running_ || !queue_.empty(); });
+            if (queue_.empty()) return;  // Stopping with nothing left to write
+            job = std::move(queue_.front());
+            queue_.pop_front();
+            writing_ = true;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        bool ok;
+        {
+            PROFILE_SCOPE("SaveWriter::write");
+            ok = writeAtomically(job.path, job.bytes);
+        }
+        float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (ok) {
+            std::cout << "SAVE: Wrote " << job.bytes.size() << " bytes to " << job.path << " in " << ms << " ms" << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            writing_ = false;
+            if (queue_.empty()) idle_cv_.notify_all();
+        }
+    }
+}
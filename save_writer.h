@@ -0,0 +1,60 @@
+#ifndef SAVE_WRITER_H
+#define SAVE_WRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// \brief Background thread that writes finished save images to disk.
+///
+/// The caller serializes on its own thread (a snapshot in memory) and hands over the bytes;
+/// the writer puts them in `<path>.tmp`, fsyncs, and renames over `path`, so a crash mid-write
+/// leaves the previous save intact. A newer image for a path that is still queued replaces
+/// the older one instead of being written after it.
+class SaveWriter {
+public:
+    static SaveWriter& getInstance() {
+        static SaveWriter instance;
+        return instance;
+    }
+
+    /// \brief Queues `bytes` to replace the file at `path`. Starts the thread on first use.
+    void submit(const std::string& path, std::vector<char> bytes);
+
+    /// \brief Blocks until every queued image is on disk.
+    void flush();
+
+    /// \brief Finishes queued writes and joins the thread; submit() restarts it.
+    void stop();
+
+    /// \brief Writes `bytes` to `path` via a temporary file and rename, on the calling thread.
+    /// \return True on success.
+    static bool writeAtomically(const std::string& path, const std::vector<char>& bytes);
+
+private:
+    struct Job {
+        std::string path;
+        std::vector<char> bytes;
+    };
+
+    SaveWriter() = default;
+    ~SaveWriter() { stop(); }
+    SaveWriter(const SaveWriter&) = delete;
+    SaveWriter& operator=(const SaveWriter&) = delete;
+
+    void writerLoop();
+
+    std::thread thread_;
+    std::mutex lifecycle_mutex_;        // Serialises starting and joining thread_; never taken by the writer
+    std::mutex mutex_;
+    std::condition_variable work_cv_;   // Signals the writer: job queued or stopping
+    std::condition_variable idle_cv_;   // Signals flush(): queue drained
+    std::deque<Job> queue_;
+    bool writing_ = false;               // A job has been popped and is being written
+    bool running_ = false;
+};
+
+#endif
@@ -0,0 +1,317 @@
+// simulation_server.cpp
+#include "simulation_server.h"
+#include "collision_system.h"
+#include "environment_manager.h"
+#include "environmental_object.h"
+#include "job_system.h"
+#include "world_builder.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+namespace {
+
+CapsuleQuery capsuleAt(Vector3 feet, float radius, float height) {
+    CollisionBounds bounds;
+    bounds.shape = CollisionShape::CAPSULE;
+    bounds.position = {feet.x, feet.y + height * 0.5f, feet.z};
+    bounds.size = {radius, height, 0.0f};
+    bounds.rotation = 0.0f;
+    return CapsuleQuery::fromBounds(bounds);
+}
+
+}  // namespace
+
+// ===== SharedWorld =====
+
+void SharedWorld::addEnvironment(const EnvironmentManager& environment) {
+    for (const auto& obj : environment.getAllObjects()) {
+        addObject(*obj);
+    }
+}
+
+void SharedWorld::addPlacements(const std::vector<ObjectPlacement>& placements) {
+    for (const ObjectPlacement& placement : placements) {
+        addObject(*placement.create());
+    }
+}
+
+void SharedWorld::addObject(const EnvironmentalObject& obj) {
+    CollisionBounds bounds = obj.getCollisionBounds();
+    bool hasShape = bounds.size.x != 0.0f || bounds.size.y != 0.0f || bounds.size.z != 0.0f;
+    if (!obj.collidable || !hasShape) return;
+
+    uint32_t index = count_++;
+    colliders_.update(index, obj);
+    BoundingBox box = CollisionSystem::enclosingBox(bounds);
+    for (int x = toCell(box.min.x); x <= toCell(box.max.x); ++x) {
+        for (int z = toCell(box.min.z); z <= toCell(box.max.z); ++z) {
+            cells_[makeKey(x, z)].push_back(index);
+        }
+    }
+}
+
+void SharedWorld::collectColliders(const BoundingBox& area, std::vector<uint32_t>& out) const {
+    out.clear();
+    for (int x = toCell(area.min.x); x <= toCell(area.max.x); ++x) {
+        for (int z = toCell(area.min.z); z <= toCell(area.max.z); ++z) {
+            auto cell = cells_.find(makeKey(x, z));
+            if (cell != cells_.end()) {
+                out.insert(out.end(), cell->second.begin(), cell->second.end());
+            }
+        }
+    }
+    // Sorted instead of stamped: a move overlaps a few cells, and nothing is written to the world
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+SharedWorld::CellKey SharedWorld::makeKey(int x, int z) {
+    return (static_cast<CellKey>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z);
+}
+
+int SharedWorld::toCell(float coord) {
+    return static_cast<int>(std::floor(coord / ServerConstants::COLLIDER_CELL_SIZE));
+}
+
+// ===== SimulationInstance =====
+
+SimulationInstance::SimulationInstance(uint32_t seed, const SharedWorld& world, int npcCount)
+    : world_(world), random_(seed * 2654435761u + 1u) {
+    inventory_.addStartingItems();  // Items are per instance; their definitions are shared
+    spawn(player_, PlayerConstants::RADIUS, PlayerConstants::HEIGHT);
+    player_.goal = randomPoint();
+    npcs_.resize(static_cast<size_t>(std::max(npcCount, 0)));
+    for (Walker& npc : npcs_) {
+        spawn(npc, NPCConstants::COLLISION_RADIUS, NPCConstants::HEIGHT);
+        npc.goal = npc.position;
+        npc.idle = NPCConstants::MIN_IDLE_TIME + nextRandom() * (NPCConstants::MAX_IDLE_TIME - NPCConstants::MIN_IDLE_TIME);
+    }
+}
+
+float SimulationInstance::nextRandom() {
+    random_ = random_ * 1664525u + 1013904223u;
+    return (random_ >> 8) / 16777216.0f;
+}
+
+Vector3 SimulationInstance::randomPoint() {
+    float angle = nextRandom() * 2.0f * PI;
+    float radius = std::sqrt(nextRandom()) * ServerConstants::BOT_WANDER_RADIUS;
+    return {std::cos(angle) * radius, 0.0f, std::sin(angle) * radius};
+}
+
+void SimulationInstance::spawn(Walker& walker, float radius, float height) {
+    constexpr int SPAWN_ATTEMPTS = 16;
+    for (int attempt = 0; attempt < SPAWN_ATTEMPTS; ++attempt) {
+        walker.position = randomPoint();
+        CapsuleQuery capsule = capsuleAt(walker.position, radius, height);
+        BoundingBox area = {{capsule.x - radius, 0.0f, capsule.z - radius}, {capsule.x + radius, 0.0f, capsule.z + radius}};
+        world_.collectColliders(area, scratch_);
+        if (world_.getColliders().firstCapsuleHit(capsule, scratch_.data(), scratch_.size()) < 0) return;
+    }
+    // Crowded spot: keep the last try; the walker may be stuck inside a collider, but it still ticks
+}
+
+bool SimulationInstance::walk(Walker& walker, float speed, float radius, float height, float deltaTime) {
+    float dx = walker.goal.x - walker.position.x;
+    float dz = walker.goal.z - walker.position.z;
+    float distance = std::sqrt(dx * dx + dz * dz);
+    if (distance < NPCConstants::ARRIVE_DISTANCE) return true;
+
+    float step = std::min(speed * deltaTime, distance);
+    float moveX = dx / distance * step, moveZ = dz / distance * step;
+
+    // Same slide as CollisionSystem::resolveCollisions, against the shared world's grid
+    CapsuleQuery capsule = capsuleAt(walker.position, radius, height);
+    auto query = [this](const BoundingBox& area, std::vector<uint32_t>& out) { world_.collectColliders(area, out); };
+    CollisionSystem::slideCapsule(capsule, moveX, moveZ, world_.getColliders(), query, scratch_);
+
+    float movedX = capsule.x - walker.position.x, movedZ = capsule.z - walker.position.z;
+    walker.position.x = capsule.x;
+    walker.position.z = capsule.z;
+
+    // Mostly blocked for a while: the goal is behind a wall or inside a building
+    if (movedX * movedX + movedZ * movedZ < 0.0625f * step * step) {
+        walker.blocked += deltaTime;
+        if (walker.blocked > ServerConstants::BOT_STUCK_TIME) {
+            walker.blocked = 0.0f;
+            return true;
+        }
+    } else {
+        walker.blocked = 0.0f;
+    }
+    return false;
+}
+
+void SimulationInstance::tickPlayer(float deltaTime) {
+    PlayerState& player = state_.player;
+    CombatState& combat = state_.combat;
+
+    if (player.isGrounded && nextRandom() < ServerConstants::BOT_JUMP_CHANCE) {
+        player.isJumping = true;
+        player.isGrounded = false;
+        player.jumpVelocity = PlayerConstants::JUMP_STRENGTH;
+    }
+    if (player.isJumping || !player.isGrounded) {
+        player.jumpVelocity += PlayerConstants::GRAVITY * deltaTime;
+        player.y += player.jumpVelocity * deltaTime;
+        if (player.y <= PlayerConstants::GROUND_LEVEL) {
+            player.y = PlayerConstants::GROUND_LEVEL;
+            player.isJumping = false;
+            player.isGrounded = true;
+            player.jumpVelocity = 0.0f;
+        }
+    }
+
+    if (walk(player_, PlayerConstants::MOVE_SPEED, PlayerConstants::RADIUS, PlayerConstants::HEIGHT, deltaTime)) {
+        player_.goal = randomPoint();
+    }
+    player.lastCameraPos = {player_.position.x, player.y + PlayerConstants::EYE_HEIGHT, player_.position.z};
+
+    if (time_ - combat.lastSwingTime > combat.swingCooldown && player.stamina >= ServerConstants::BOT_STAMINA_PER_SWING &&
+        nextRandom() < 0.05f) {
+        combat.lastSwingTime = time_;
+        ++combat.swingsPerformed;
+        player.stamina -= ServerConstants::BOT_STAMINA_PER_SWING;
+    }
+    stamina_regen_ += deltaTime;
+    if (stamina_regen_ >= 1.0f) {
+        stamina_regen_ -= 1.0f;
+        player.stamina = std::min(player.maxStamina, player.stamina + ServerConstants::BOT_STAMINA_PER_SWING);
+    }
+    inventory_.update(deltaTime);
+}
+
+void SimulationInstance::tickCrowd(float deltaTime) {
+    for (Walker& npc : npcs_) {
+        if (npc.idle > 0.0f) {
+            npc.idle -= deltaTime;
+            if (npc.idle <= 0.0f) {
+                float angle = nextRandom() * 2.0f * PI;
+                float reach = nextRandom() * NPCConstants::WANDER_RADIUS;
+                npc.goal = {npc.position.x + std::cos(angle) * reach, 0.0f, npc.position.z + std::sin(angle) * reach};
+            }
+            continue;
+        }
+        if (walk(npc, NPCConstants::WALK_SPEED, NPCConstants::COLLISION_RADIUS, NPCConstants::HEIGHT, deltaTime)) {
+            npc.idle = NPCConstants::MIN_IDLE_TIME + nextRandom() * (NPCConstants::MAX_IDLE_TIME - NPCConstants::MIN_IDLE_TIME);
+        }
+    }
+}
+
+void SimulationInstance::tick(float deltaTime) {
+    tickPlayer(deltaTime);
+    tickCrowd(deltaTime);
+    time_ += deltaTime;
+    ++tick_count_;
+}
+
+uint64_t SimulationInstance::checksum() const {
+    uint64_t hash = 1469598103934665603ull;  // FNV-1a over quantised positions
+    auto mix = [&hash](float value) {
+        hash ^= static_cast<uint64_t>(static_cast<int64_t>(std::lround(value * 1000.0f)));
+        hash *= 1099511628211ull;
+    };
+    mix(player_.position.x);
+    mix(player_.position.z);
+    mix(state_.player.y);
+    for (const Walker& npc : npcs_) {
+        mix(npc.position.x);
+        mix(npc.position.z);
+    }
+    return hash;
+}
+
+// ===== Server =====
+
+int runSimulationServer(const ServerOptions& options) {
+    using Clock = std::chrono::steady_clock;
+    JobSystem& jobs = JobSystem::getInstance();
+    jobs.start(options.workers);
+    unsigned cores = jobs.getWorkerCount() + 1;  // The main thread runs slices while it waits
+
+    // ===== SHARED, READ-ONLY WORLD =====
+    SharedWorld world;
+    {
+        EnvironmentManager environment;
+        initializeWorld(environment);
+        world.addEnvironment(environment);
+        if (options.townScale > 0) {
+            TownOptions town;
+            town.seed = options.townSeed;
+            town.objectCount = static_cast<size_t>(options.townScale) * getDefaultWorldObjectCount(environment);
+            world.addPlacements(generateTown(town));
+        }
+    }
+    std::cout << "SERVER: Shared world has " << world.getColliderCount() << " colliders" << std::endl;
+
+    // ===== PER-INSTANCE STATE =====
+    std::vector<std::unique_ptr<SimulationInstance>> instances;
+    instances.reserve(static_cast<size_t>(std::max(options.instances, 0)));
+    for (int i = 0; i < options.instances; ++i) {
+        instances.push_back(std::make_unique<SimulationInstance>(static_cast<uint32_t>(i), world, options.npcsPerInstance));
+    }
+    std::cout << "SERVER: " << instances.size() << " instances x " << options.npcsPerInstance << " NPCs, "
+              << options.ticks << " ticks each on " << cores << " cores" << std::endl;
+
+    // ===== SCHEDULER =====
+    // One job per instance per slice: long enough to amortise scheduling, short enough to balance
+    const float deltaTime = SimulationConstants::FIXED_DELTA_TIME;
+    double slowestSliceMs = 0.0;
+    Clock::time_point start = Clock::now();
+    for (int done = 0; done < options.ticks; done += ServerConstants::SLICE_TICKS) {
+        int sliceTicks = std::min(ServerConstants::SLICE_TICKS, options.ticks - done);
+        Clock::time_point sliceStart = Clock::now();
+        jobs.parallelFor(instances.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                for (int t = 0; t < sliceTicks; ++t) {
+                    instances[i]->tick(deltaTime);
+                }
+            }
+        });
+        slowestSliceMs = std::max(slowestSliceMs, std::chrono::duration<double, std::milli>(Clock::now() - sliceStart).count());
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    jobs.stop();
+
+    // ===== REPORT =====
+    uint64_t totalTicks = 0, swings = 0, checksum = 0;
+    for (const auto& instance : instances) {
+        totalTicks += instance->getTickCount();
+        swings += static_cast<uint64_t>(instance->getState().combat.swingsPerformed);
+        checksum = checksum * 31 + instance->checksum();
+    }
+    double ticksPerSecond = seconds > 0.0 ? totalTicks / seconds : 0.0;
+    double ticksPerCore = ticksPerSecond / cores;
+    double realtimeInstances = ticksPerSecond * deltaTime;  // Instances one process could keep at full rate
+
+    std::cout << "SERVER: " << totalTicks << " ticks in " << seconds << " s: " << ticksPerSecond << " ticks/s, "
+              << ticksPerCore << " ticks/s per core, " << realtimeInstances << " real-time instances" << std::endl;
+    std::cout << "SERVER: Slowest slice " << slowestSliceMs << " ms, " << swings << " swings, checksum " << checksum << std::endl;
+
+    if (options.outputPath.empty()) return EXIT_SUCCESS;
+    std::ofstream out(options.outputPath, std::ios::trunc);
+    if (!out) {
+        std::cout << "SERVER: Cannot write " << options.outputPath << std::endl;
+        return EXIT_FAILURE;
+    }
+    out << "{\n"
+        << "  \"instances\": " << instances.size() << ",\n"
+        << "  \"npcs_per_instance\": " << options.npcsPerInstance << ",\n"
+        << "  \"ticks_per_instance\": " << options.ticks << ",\n"
+        << "  \"cores\": " << cores << ",\n"
+        << "  \"colliders\": " << world.getColliderCount() << ",\n"
+        << "  \"seconds\": " << seconds << ",\n"
+        << "  \"ticks_per_second\": " << ticksPerSecond << ",\n"
+        << "  \"ticks_per_second_per_core\": " << ticksPerCore << ",\n"
+        << "  \"realtime_instances\": " << realtimeInstances << ",\n"
+        << "  \"slowest_slice_ms\": " << slowestSliceMs << ",\n"
+        << "  \"checksum\": " << checksum << "\n"
+        << "}\n";
+    std::cout << "SERVER: Results written to " << options.outputPath << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+// simulation_server.h - Headless multi-instance simulation for bots and load tests
+#ifndef SIMULATION_SERVER_H
+#define SIMULATION_SERVER_H
+
+#include "raylib.h"
+#include "collider_cache.h"
+#include "constants.h"
+#include "game_state.h"  // For SimulationState
+#include "inventory.h"
+#include "world_streamer.h"  // For ObjectPlacement
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class EnvironmentManager;
+class EnvironmentalObject;
+
+/// \brief Settings for a headless server run (Browserwind --server).
+struct ServerOptions {
+    int instances = ServerConstants::DEFAULT_INSTANCES;
+    int ticks = ServerConstants::DEFAULT_TICKS;      // Steps per instance
+    int npcsPerInstance = ServerConstants::NPCS_PER_INSTANCE;
+    unsigned workers = 0;                            // Worker threads; 0 picks hardware_concurrency - 1
+    int townScale = 0;                               // > 0 adds a generated town (see generateTown) to the shared world
+    uint32_t townSeed = 1;
+    std::string outputPath;                          // Non-empty: write the results as JSON
+};
+
+/// \brief Static collision world shared read-only by every SimulationInstance.
+///
+/// A snapshot of collider shapes in a ColliderCache, indexed through a flat XZ grid that
+/// is built once. Unlike EnvironmentManager's grid, queries keep no state in the world,
+/// so any number of threads can query it at once. Fill it before creating instances and
+/// hand those only a const reference.
+class SharedWorld {
+public:
+    /// \brief Snapshots every collidable object in an environment.
+    void addEnvironment(const EnvironmentManager& environment);
+
+    /// \brief Snapshots placements, creating each object just long enough to read its shape.
+    void addPlacements(const std::vector<ObjectPlacement>& placements);
+
+    /// \brief Collects colliders whose bounds overlap an area on the ground plane.
+    /// \param area Area to query; Y is ignored.
+    /// \param out Cleared, then filled with unique collider indices.
+    void collectColliders(const BoundingBox& area, std::vector<uint32_t>& out) const;
+
+    const ColliderCache& getColliders() const { return colliders_; }
+    size_t getColliderCount() const { return count_; }
+
+private:
+    using CellKey = uint64_t;
+
+    void addObject(const EnvironmentalObject& obj);
+    static CellKey makeKey(int x, int z);
+    static int toCell(float coord);
+
+    ColliderCache colliders_;
+    std::unordered_map<CellKey, std::vector<uint32_t>> cells_;
+    uint32_t count_ = 0;
+};
+
+/// \brief One headless simulation: a bot player and its own crowd in the shared world.
+///
+/// Everything an instance changes is its own, so instances tick on any thread in parallel;
+/// the world, item definitions and constants are shared. Bots walk to random goals, slide
+/// along colliders like the player does, jump and swing now and then. Each instance is
+/// seeded, so a run is reproducible whatever threads its ticks land on.
+class SimulationInstance {
+public:
+    /// \param seed Seed for the bot and crowd.
+    /// \param world World to collide with; must outlive the instance.
+    /// \param npcCount Crowd size.
+    SimulationInstance(uint32_t seed, const SharedWorld& world, int npcCount);
+
+    /// \brief Advances one step.
+    void tick(float deltaTime);
+
+    const SimulationState& getState() const { return state_; }
+    uint64_t getTickCount() const { return tick_count_; }
+
+    /// \brief Order-sensitive hash of the bot and crowd positions, to compare runs.
+    uint64_t checksum() const;
+
+private:
+    struct Walker {
+        Vector3 position = {0.0f, 0.0f, 0.0f};  // Feet
+        Vector3 goal = {0.0f, 0.0f, 0.0f};
+        float idle = 0.0f;      // Seconds to wait before walking on
+        float blocked = 0.0f;   // Seconds spent mostly blocked
+    };
+
+    float nextRandom();
+    Vector3 randomPoint();
+    void spawn(Walker& walker, float radius, float height);
+    /// \brief Walks toward the goal; true once arrived.
+    bool walk(Walker& walker, float speed, float radius, float height, float deltaTime);
+    void tickPlayer(float deltaTime);
+    void tickCrowd(float deltaTime);
+
+    const SharedWorld& world_;
+    SimulationState state_;
+    Walker player_;
+    std::vector<Walker> npcs_;
+    InventorySystem inventory_;
+    std::vector<uint32_t> scratch_;
+    uint32_t random_;
+    uint64_t tick_count_ = 0;
+    float time_ = 0.0f;
+    float stamina_regen_ = 0.0f;
+};
+
+/// \brief Builds the shared world, then ticks options.instances instances across the job
+/// system in slices of ServerConstants::SLICE_TICKS steps and reports ticks per second,
+/// overall and per core.
+/// \return EXIT_SUCCESS, or EXIT_FAILURE if the results could not be written.
+int runSimulationServer(const ServerOptions& options);
+
+#endif // SIMULATION_SERVER_H
@@ -0,0 +1,258 @@
+// spatial_audio.cpp
+#include "spatial_audio.h"
+#include "environment_manager.h"
+#include "ui_audio.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+// Indexed by WorldSound
+const char* const WORLD_SOUND_PATHS[] = {
+    "assets/sounds/world_well.wav",
+    "assets/sounds/world_npc_voice.wav",
+    "assets/sounds/world_swing.wav",
+    "assets/sounds/world_door.wav",
+};
+static_assert(sizeof(WORLD_SOUND_PATHS) / sizeof(WORLD_SOUND_PATHS[0]) == static_cast<size_t>(WorldSound::WORLD_SOUND_COUNT),
+              "WORLD_SOUND_PATHS needs an entry per WorldSound");
+
+}  // namespace
+
+void SpatialAudio::initialize() {
+    if (!IsAudioDeviceReady()) {
+        std::cout << "AUDIO: No audio device, world sounds disabled" << std::endl;
+        return;
+    }
+
+    for (size_t i = 0; i < SOUND_COUNT; ++i) {
+        SoundBank& bank = banks_[i];
+        if (bank.soundCount > 0) continue;
+
+        Sound sound = LoadSound(WORLD_SOUND_PATHS[i]);
+        if (sound.stream.buffer == nullptr) {
+            std::cout << "AUDIO: Failed to load world sound: " << WORLD_SOUND_PATHS[i] << std::endl;
+            continue;
+        }
+        bank.sounds[0] = sound;
+        bank.soundCount = 1;
+        while (bank.soundCount < AudioConstants::VOICES_PER_WORLD_SOUND) {
+            bank.sounds[bank.soundCount++] = LoadSoundAlias(sound);
+        }
+    }
+}
+
+void SpatialAudio::shutdown() {
+    for (EmitterVoice& voice : voices_) {
+        releaseVoice(voice);
+    }
+    for (SoundBank& bank : banks_) {
+        for (size_t i = bank.soundCount; i-- > 0;) {
+            StopSound(bank.sounds[i]);
+            if (i > 0) {
+                UnloadSoundAlias(bank.sounds[i]);
+            }
+        }
+        if (bank.soundCount > 0) {
+            UnloadSound(bank.sounds[0]);
+        }
+        bank = SoundBank();
+    }
+}
+
+void SpatialAudio::update(const Camera3D& camera, const EnvironmentManager& environment, bool indoors) {
+    PROFILE_SCOPE("SpatialAudio::update");
+
+    listener_.position = camera.position;
+    listener_.indoors = indoors;
+    float forwardX = camera.target.x - camera.position.x;
+    float forwardZ = camera.target.z - camera.position.z;
+    float forwardLength = std::sqrt(forwardX * forwardX + forwardZ * forwardZ);
+    if (forwardLength > 0.0001f) {
+        listener_.right = {-forwardZ / forwardLength, 0.0f, forwardX / forwardLength};
+    }
+
+    // Gather: only objects the grid puts near the listener, minus the other side of the wall
+    candidate_emitters_.clear();
+    candidate_x_.clear();
+    candidate_y_.clear();
+    candidate_z_.clear();
+    candidate_radius_.clear();
+    candidate_volume_.clear();
+
+    const float reach = AudioConstants::MAX_AUDIBLE_DISTANCE;
+    BoundingBox area = {{camera.position.x - reach, camera.position.y - reach, camera.position.z - reach},
+                        {camera.position.x + reach, camera.position.y + reach, camera.position.z + reach}};
+    environment.queryCandidates(area, query_scratch_);
+    const auto& objects = environment.getAllObjects();
+    for (uint32_t index : query_scratch_) {
+        const EnvironmentalObject& object = *objects[index];
+        const AudioEmitterComponent* emitter = object.getComponent<AudioEmitterComponent>();
+        if (emitter == nullptr || !isAudible(emitter->getSpace(), indoors)) continue;
+        if (banks_[static_cast<size_t>(emitter->getSound())].soundCount == 0) continue;
+
+        candidate_emitters_.push_back(emitter);
+        candidate_x_.push_back(object.position.x);
+        candidate_y_.push_back(object.position.y);
+        candidate_z_.push_back(object.position.z);
+        candidate_radius_.push_back(emitter->getRadius());
+        candidate_volume_.push_back(emitter->getVolume());
+    }
+
+    // Score every candidate in one pass over the flat arrays
+    const size_t count = candidate_emitters_.size();
+    candidate_dist_sq_.resize(count);
+    const float listenerX = camera.position.x;
+    const float listenerY = camera.position.y;
+    const float listenerZ = camera.position.z;
+    for (size_t i = 0; i < count; ++i) {
+        float dx = candidate_x_[i] - listenerX;
+        float dy = candidate_y_[i] - listenerY;
+        float dz = candidate_z_[i] - listenerZ;
+        candidate_dist_sq_[i] = dx * dx + dy * dy + dz * dz;
+    }
+
+    selected_.clear();
+    for (size_t i = 0; i < count; ++i) {
+        if (candidate_dist_sq_[i] < candidate_radius_[i] * candidate_radius_[i]) {
+            selected_.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    if (selected_.size() > AudioConstants::MAX_EMITTER_VOICES) {
+        std::nth_element(selected_.begin(), selected_.begin() + AudioConstants::MAX_EMITTER_VOICES, selected_.end(),
+                         [this](uint32_t a, uint32_t b) { return candidate_dist_sq_[a] < candidate_dist_sq_[b]; });
+        selected_.resize(AudioConstants::MAX_EMITTER_VOICES);
+    }
+
+    const size_t selectedCount = selected_.size();
+    selected_gain_.resize(selectedCount);
+    selected_pan_.resize(selectedCount);
+    for (size_t j = 0; j < selectedCount; ++j) {
+        uint32_t i = selected_[j];
+        mix({candidate_x_[i], candidate_y_[i], candidate_z_[i]}, candidate_radius_[i], candidate_volume_[i],
+            selected_gain_[j], selected_pan_[j]);
+    }
+
+    // Emitters that stay selected keep their voice, so loops carry on rather than restart
+    for (EmitterVoice& voice : voices_) {
+        voice.kept = false;
+    }
+    std::array<bool, AudioConstants::MAX_EMITTER_VOICES> bound{};
+    for (size_t j = 0; j < selectedCount; ++j) {
+        const AudioEmitterComponent* emitter = candidate_emitters_[selected_[j]];
+        for (EmitterVoice& voice : voices_) {
+            if (voice.alias != NO_ALIAS && !voice.kept && voice.emitter == emitter && voice.sound == emitter->getSound()) {
+                voice.kept = true;
+                voice.gain = selected_gain_[j];
+                voice.pan = selected_pan_[j];
+                bound[j] = true;
+                break;
+            }
+        }
+    }
+    for (EmitterVoice& voice : voices_) {
+        if (voice.alias != NO_ALIAS && !voice.kept) {
+            releaseVoice(voice);
+        }
+    }
+    for (size_t j = 0; j < selectedCount; ++j) {
+        if (bound[j]) continue;
+        const AudioEmitterComponent* emitter = candidate_emitters_[selected_[j]];
+        auto freeVoice = std::find_if(voices_.begin(), voices_.end(),
+                                      [](const EmitterVoice& voice) { return voice.alias == NO_ALIAS; });
+        uint8_t alias = findFreeAlias(emitter->getSound());
+        if (freeVoice == voices_.end() || alias == NO_ALIAS) continue;
+
+        banks_[static_cast<size_t>(emitter->getSound())].heldByEmitters |= 1u << alias;
+        freeVoice->emitter = emitter;
+        freeVoice->sound = emitter->getSound();
+        freeVoice->alias = alias;
+        freeVoice->gain = selected_gain_[j];
+        freeVoice->pan = selected_pan_[j];
+        freeVoice->kept = true;
+    }
+
+    // Push the mix; emitters loop by restarting when their sound runs out
+    float settings = settingsVolume();
+    for (EmitterVoice& voice : voices_) {
+        if (voice.alias == NO_ALIAS) continue;
+        Sound& sound = banks_[static_cast<size_t>(voice.sound)].sounds[voice.alias];
+        SetSoundVolume(sound, voice.gain * settings);
+        SetSoundPan(sound, voice.pan);
+        if (!IsSoundPlaying(sound)) {
+            PlaySound(sound);
+        }
+    }
+}
+
+bool SpatialAudio::playAt(WorldSound sound, Vector3 position, float volume, AudioSpace space) {
+    if (banks_[static_cast<size_t>(sound)].soundCount == 0 || !isAudible(space, listener_.indoors)) return false;
+
+    float gain = 0.0f;
+    float pan = 0.5f;
+    mix(position, AudioConstants::ONE_SHOT_RADIUS, volume, gain, pan);
+    if (gain <= 0.0f) return false;
+
+    uint8_t alias = findFreeAlias(sound);
+    if (alias == NO_ALIAS) return false;
+
+    Sound& voice = banks_[static_cast<size_t>(sound)].sounds[alias];
+    SetSoundVolume(voice, gain * settingsVolume());
+    SetSoundPan(voice, pan);
+    PlaySound(voice);
+    return true;
+}
+
+size_t SpatialAudio::getActiveEmitterVoiceCount() const {
+    return static_cast<size_t>(std::count_if(voices_.begin(), voices_.end(),
+                                             [](const EmitterVoice& voice) { return voice.alias != NO_ALIAS; }));
+}
+
+bool SpatialAudio::isAudible(AudioSpace space, bool indoors) {
+    return space == AudioSpace::ANY || (space == AudioSpace::INDOOR) == indoors;
+}
+
+void SpatialAudio::mix(Vector3 source, float radius, float volume, float& gain, float& pan) const {
+    float dx = source.x - listener_.position.x;
+    float dy = source.y - listener_.position.y;
+    float dz = source.z - listener_.position.z;
+    float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+    if (distance >= radius) {
+        gain = 0.0f;
+        pan = 0.5f;
+        return;
+    }
+
+    // Quadratic falloff reaches silence exactly at the radius
+    float falloff = 1.0f - distance / radius;
+    gain = volume * falloff * falloff;
+
+    // raylib pans fully left at 1.0 and right at 0.0
+    float side = distance > 0.0001f ? (dx * listener_.right.x + dz * listener_.right.z) / distance : 0.0f;
+    pan = 0.5f - 0.5f * side;
+}
+
+uint8_t SpatialAudio::findFreeAlias(WorldSound sound) const {
+    const SoundBank& bank = banks_[static_cast<size_t>(sound)];
+    for (uint8_t alias = 0; alias < bank.soundCount; ++alias) {
+        if (!(bank.heldByEmitters & (1u << alias)) && !IsSoundPlaying(bank.sounds[alias])) {
+            return alias;
+        }
+    }
+    return NO_ALIAS;
+}
+
+void SpatialAudio::releaseVoice(EmitterVoice& voice) {
+    if (voice.alias == NO_ALIAS) return;
+    SoundBank& bank = banks_[static_cast<size_t>(voice.sound)];
+    StopSound(bank.sounds[voice.alias]);
+    bank.heldByEmitters &= ~(1u << voice.alias);
+    voice = EmitterVoice();
+}
+
+float SpatialAudio::settingsVolume() {
+    const UIAudio::AudioManager& audio = UIAudio::AudioManager::getInstance();
+    return audio.getMasterVolume() * audio.getSFXVolume();
+}
@@ -0,0 +1,143 @@
+// spatial_audio.h - Positional world sounds voiced from the environment's spatial index
+#ifndef SPATIAL_AUDIO_H
+#define SPATIAL_AUDIO_H
+
+#include "raylib.h"
+#include "constants.h"
+#include "environmental_object.h"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class EnvironmentManager;
+
+enum class WorldSound : uint8_t {
+    WELL_WATER,         // Looping water ambience
+    NPC_VOICE,          // NPC greeting
+    SWORD_SWING,        // Player melee swing
+    DOOR,               // Building door opening or closing
+    WORLD_SOUND_COUNT
+};
+
+/// \brief Where a sound can be heard from. The listener hears only its own side of a
+/// building wall; ANY plays on both (doors, heard from either side).
+enum class AudioSpace : uint8_t { OUTDOOR, INDOOR, ANY };
+
+/// \brief Makes an environmental object a looping positional sound source.
+///
+/// Objects carrying one are found through EnvironmentManager's spatial grid, so only
+/// emitters near the listener are ever looked at.
+class AudioEmitterComponent : public Component {
+public:
+    AudioEmitterComponent(WorldSound sound, float radius, float volume = 1.0f, AudioSpace space = AudioSpace::OUTDOOR)
+        : sound_(sound), radius_(radius < AudioConstants::MAX_AUDIBLE_DISTANCE ? radius : AudioConstants::MAX_AUDIBLE_DISTANCE),
+          volume_(volume), space_(space) {}
+
+    WorldSound getSound() const { return sound_; }
+    /// \brief Distance at which the emitter fades to silence.
+    float getRadius() const { return radius_; }
+    float getVolume() const { return volume_; }
+    AudioSpace getSpace() const { return space_; }
+
+    std::string getTypeName() const override { return "AudioEmitterComponent"; }
+    ecs::ComponentTypeId getTypeId() const override { return ecs::typeId<AudioEmitterComponent>(); }
+
+private:
+    WorldSound sound_;
+    float radius_;
+    float volume_;
+    AudioSpace space_;
+};
+
+/// \brief Mixes positional world sounds for the camera.
+///
+/// Each update queries the environment grid for emitters within MAX_AUDIBLE_DISTANCE,
+/// drops the ones on the far side of a building wall, and scores the rest in one pass
+/// over flat arrays. Only the MAX_EMITTER_VOICES nearest audible emitters get voices;
+/// emitters that stay selected keep theirs, so loops don't restart. Attenuation and
+/// panning for the selected voices are computed together, then pushed to raylib.
+///
+/// Uses the device opened by UIAudio and follows its master and SFX volumes. Main thread only.
+class SpatialAudio {
+public:
+    static SpatialAudio& getInstance() {
+        static SpatialAudio instance;
+        return instance;
+    }
+
+    /// \brief Loads the world sounds. Needs the audio device; missing files stay silent.
+    void initialize();
+    void shutdown();
+
+    /// \brief Re-selects and re-mixes emitter voices for the listener.
+    /// \param camera Camera the sounds are heard from.
+    /// \param environment Environment whose grid holds the emitters.
+    /// \param indoors PlayerState::isInBuilding; outdoor emitters are culled while set.
+    void update(const Camera3D& camera, const EnvironmentManager& environment, bool indoors);
+
+    /// \brief Plays a one-shot at a world position, mixed for the last update's listener.
+    /// \return False if it was out of range, on the other side of a wall, or had no free voice.
+    bool playAt(WorldSound sound, Vector3 position, float volume = 1.0f, AudioSpace space = AudioSpace::OUTDOOR);
+
+    /// \brief Gets emitters the last update scored, after the indoor/outdoor cull.
+    size_t getCandidateCount() const { return candidate_emitters_.size(); }
+    size_t getActiveEmitterVoiceCount() const;
+
+private:
+    SpatialAudio() = default;
+    ~SpatialAudio() = default;
+    SpatialAudio(const SpatialAudio&) = delete;
+    SpatialAudio& operator=(const SpatialAudio&) = delete;
+
+    static constexpr size_t SOUND_COUNT = static_cast<size_t>(WorldSound::WORLD_SOUND_COUNT);
+    static constexpr uint8_t NO_ALIAS = 0xFF;
+    static_assert(AudioConstants::VOICES_PER_WORLD_SOUND <= 32, "SoundBank::heldByEmitters is a 32-bit mask");
+
+    struct SoundBank {
+        std::array<Sound, AudioConstants::VOICES_PER_WORLD_SOUND> sounds{};  // [0] owns the samples
+        uint8_t soundCount = 0;
+        uint32_t heldByEmitters = 0;    // Bit per alias bound to an emitter voice
+    };
+
+    struct EmitterVoice {
+        const AudioEmitterComponent* emitter = nullptr;  // Identity only; never dereferenced
+        WorldSound sound = WorldSound::WELL_WATER;
+        uint8_t alias = NO_ALIAS;
+        float gain = 0.0f;
+        float pan = 0.5f;
+        bool kept = false;
+    };
+
+    struct Listener {
+        Vector3 position{};
+        Vector3 right{1.0f, 0.0f, 0.0f};
+        bool indoors = false;
+    };
+
+    static bool isAudible(AudioSpace space, bool indoors);
+    /// \brief Gain and raylib pan (0.5 is centre) for a source, before the volume settings.
+    void mix(Vector3 source, float radius, float volume, float& gain, float& pan) const;
+    uint8_t findFreeAlias(WorldSound sound) const;
+    void releaseVoice(EmitterVoice& voice);
+    static float settingsVolume();
+
+    std::array<SoundBank, SOUND_COUNT> banks_;
+    std::array<EmitterVoice, AudioConstants::MAX_EMITTER_VOICES> voices_;
+    Listener listener_;
+
+    // Per-update scratch, reused so steady-state updates don't allocate
+    std::vector<uint32_t> query_scratch_;
+    std::vector<const AudioEmitterComponent*> candidate_emitters_;
+    std::vector<float> candidate_x_;
+    std::vector<float> candidate_y_;
+    std::vector<float> candidate_z_;
+    std::vector<float> candidate_radius_;
+    std::vector<float> candidate_volume_;
+    std::vector<float> candidate_dist_sq_;
+    std::vector<uint32_t> selected_;
+    std::vector<float> selected_gain_;
+    std::vector<float> selected_pan_;
+};
+
+#endif // SPATIAL_AUDIO_H
@@ -0,0 +1,71 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+/// \brief Bounded single-producer/single-consumer ring buffer.
+///
+/// One thread pushes, one other thread peeks and pops; neither ever blocks or takes a
+/// lock. Each side keeps a cached copy of the other's index and only reloads it when the
+/// queue looks full (producer) or empty (consumer), so steady traffic doesn't bounce the
+/// shared cache lines. Capacity must be a power of two; one slot is kept free.
+template<typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "Elements are copied in and out without construction");
+
+public:
+    /// \brief Producer side. \return False if the queue is full; the element is not queued.
+    bool tryPush(const T& value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t next = (tail + 1) & MASK;
+        if (next == cached_head_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (next == cached_head_) return false;
+        }
+        slots_[tail] = value;
+        tail_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /// \brief Consumer side. \return Oldest element, or null if empty. Valid until pop().
+    const T* front() {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) return nullptr;
+        }
+        return &slots_[head];
+    }
+
+    /// \brief Consumer side. Drops the element front() returned; only call after a non-null front().
+    void pop() {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        head_.store((head + 1) & MASK, std::memory_order_release);
+    }
+
+    /// \brief Approximate when called while the other side is running.
+    size_t size() const {
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return (tail - head) & MASK;
+    }
+
+    static constexpr size_t capacity() { return Capacity - 1; }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+    static constexpr size_t CACHE_LINE = 64;
+
+    // Consumer-owned line, producer-owned line, then the slots
+    alignas(CACHE_LINE) std::atomic<size_t> head_{0};
+    size_t cached_tail_ = 0;
+    alignas(CACHE_LINE) std::atomic<size_t> tail_{0};
+    size_t cached_head_ = 0;
+    alignas(CACHE_LINE) std::array<T, Capacity> slots_{};
+};
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,38 @@
+// state_change.cpp
+#include "state_change.h"
+
+const char* StateChange::getName(Property property) {
+    switch (property) {
+        case PAUSE_MENU: return "pause_menu";
+        case TESTING_PANEL: return "testing_panel";
+        case PERFORMANCE_TOGGLE: return "performance_toggle";
+        case INVENTORY: return "inventory";
+        case QUICK_USE: return "quick_use";
+        case INVENTORY_ITEM: return "inventory_item";
+        case WINDOW_CLOSE: return "window_close";
+        case MELEE_SWING: return "melee_swing";
+        case VALIDATED: return "validated";
+        case RESET: return "reset";
+        case COMBAT_HIT: return "combat_hit";
+    }
+    return "unknown";
+}
+
+void StateChangeBus::subscribe(StateChangeMask mask, Listener listener) {
+    subscriptions_.push_back({mask, std::move(listener)});
+}
+
+StateChangeMask StateChangeBus::dispatch() {
+    StateChangeMask changed = pending_;
+    if (changed == 0) return 0;
+    pending_ = 0;  // Cleared first: what listeners post now waits for the next dispatch
+
+    // Indexed: a listener may subscribe another, which can reallocate the vector
+    for (size_t i = 0; i < subscriptions_.size(); ++i) {
+        StateChangeMask relevant = changed & subscriptions_[i].mask;
+        if (relevant != 0) {
+            subscriptions_[i].listener(relevant);
+        }
+    }
+    return changed;
+}
@@ -0,0 +1,67 @@
+// state_change.h - Typed, per-frame GameState change notifications
+#ifndef STATE_CHANGE_H
+#define STATE_CHANGE_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/// \brief Bit set of StateChange properties.
+using StateChangeMask = uint32_t;
+
+namespace StateChange {
+    /// What changed. One bit each, so a frame's changes and a listener's interests are masks.
+    enum Property : StateChangeMask {
+        PAUSE_MENU = 1u << 0,
+        TESTING_PANEL = 1u << 1,
+        PERFORMANCE_TOGGLE = 1u << 2,
+        INVENTORY = 1u << 3,          // Inventory window opened or closed
+        QUICK_USE = 1u << 4,
+        INVENTORY_ITEM = 1u << 5,     // An item was used from the inventory window
+        WINDOW_CLOSE = 1u << 6,
+        MELEE_SWING = 1u << 7,
+        VALIDATED = 1u << 8,          // validateAndRepair ran, e.g. after a load: anything may differ
+        RESET = 1u << 9,              // resetToDefaults ran
+        COMBAT_HIT = 1u << 10         // A swing landed: score, hits or weapon wear changed
+    };
+
+    constexpr StateChangeMask ALL = ~0u;
+    constexpr int PROPERTY_COUNT = 11;
+
+    /// \brief Lower-case name, for logs.
+    const char* getName(Property property);
+}
+
+/// \brief Coalesces change notifications and delivers them once per dispatch.
+///
+/// post() only sets a bit, so raising a change from the middle of input handling costs
+/// nothing and calls nobody. dispatch() then hands each listener the changes since the
+/// last dispatch that fall in its mask; a listener whose mask saw nothing isn't called.
+/// Changes posted by listeners during a dispatch are delivered by the next one, so a
+/// listener never re-enters the bus. Main thread only.
+class StateChangeBus {
+public:
+    using Listener = std::function<void(StateChangeMask changed)>;
+
+    /// \brief Adds a listener for the properties in `mask`.
+    void subscribe(StateChangeMask mask, Listener listener);
+
+    void post(StateChange::Property property) { pending_ |= property; }
+
+    /// \brief Delivers and clears the pending changes.
+    /// \return The changes that were delivered.
+    StateChangeMask dispatch();
+
+    StateChangeMask getPending() const { return pending_; }
+
+private:
+    struct Subscription {
+        StateChangeMask mask;
+        Listener listener;
+    };
+
+    std::vector<Subscription> subscriptions_;
+    StateChangeMask pending_ = 0;
+};
+
+#endif // STATE_CHANGE_H
@@ -0,0 +1,213 @@
+// telemetry.cpp
+#include "telemetry.h"
+#include "constants.h"
+#include "game_state.h"  // For SimulationSnapshot
+#include "profiler.h"
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#if defined(__linux__) || defined(__APPLE__)
+#define TELEMETRY_SOCKETS 1
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  // macOS: the client socket gets SO_NOSIGPIPE instead
+#endif
+#endif
+
+TelemetryExporter::~TelemetryExporter() {
+    stop();
+}
+
+bool TelemetryExporter::start(int port, const SimulationSnapshot* simulation) {
+    if (isRunning()) return true;
+    simulation_ = simulation;
+
+#ifdef TELEMETRY_SOCKETS
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        std::cout << "TELEMETRY: Cannot create socket, telemetry disabled" << std::endl;
+        return false;
+    }
+    int reuse = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listen_fd_, TelemetryConstants::LISTEN_BACKLOG) != 0) {
+        std::cout << "TELEMETRY: Cannot listen on 127.0.0.1:" << port << ", telemetry disabled" << std::endl;
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    running_.store(true, std::memory_order_relaxed);
+    thread_ = std::thread(&TelemetryExporter::serveLoop, this);
+    std::cout << "TELEMETRY: Serving metrics on http://127.0.0.1:" << port << "/metrics" << std::endl;
+    return true;
+#else
+    (void)port;
+    std::cout << "TELEMETRY: Sockets unavailable on this platform, telemetry disabled" << std::endl;
+    return false;
+#endif
+}
+
+void TelemetryExporter::stop() {
+    running_.store(false, std::memory_order_relaxed);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+#ifdef TELEMETRY_SOCKETS
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+    }
+#endif
+}
+
+void TelemetryExporter::publish(const TelemetrySample& sample) {
+    slots_[write_slot_] = sample;
+    // Release the copy and take back whichever slot the server isn't holding
+    write_slot_ = latest_.exchange(write_slot_ | FRESH, std::memory_order_acq_rel) & ~FRESH;
+}
+
+void TelemetryExporter::serveLoop() {
+#ifdef TELEMETRY_SOCKETS
+    Profiler::getInstance().setThreadName("Telemetry");
+    pollfd listener = {listen_fd_, POLLIN, 0};
+    while (running_.load(std::memory_order_relaxed)) {
+        if (::poll(&listener, 1, TelemetryConstants::ACCEPT_TIMEOUT_MS) <= 0) continue;
+        int client = ::accept(listen_fd_, nullptr, nullptr);
+        if (client < 0) continue;
+        respond(client);
+        ::close(client);
+    }
+#endif
+}
+
+void TelemetryExporter::respond(int client) {
+#ifdef TELEMETRY_SOCKETS
+    // Read the request head; any path gets the metrics, which is all a scraper asks for
+    char request[TelemetryConstants::MAX_REQUEST_BYTES];
+    size_t received = 0;
+    pollfd reader = {client, POLLIN, 0};
+    while (received < sizeof(request) - 1 && ::poll(&reader, 1, TelemetryConstants::REQUEST_TIMEOUT_MS) > 0) {
+        ssize_t length = ::recv(client, request + received, sizeof(request) - 1 - received, 0);
+        if (length <= 0) break;
+        received += static_cast<size_t>(length);
+        request[received] = '\0';
+        if (std::strstr(request, "\r\n\r\n")) break;
+    }
+    if (received == 0) return;
+#ifdef SO_NOSIGPIPE
+    int noSignal = 1;
+    ::setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &noSignal, sizeof(noSignal));
+#endif
+
+    if (latest_.load(std::memory_order_relaxed) & FRESH) {
+        read_slot_ = latest_.exchange(read_slot_, std::memory_order_acq_rel) & ~FRESH;
+    }
+    std::string body = format(slots_[read_slot_], simulation_);
+
+    std::ostringstream head;
+    head << "HTTP/1.1 200 OK\r\n"
+         << "Content-Type: text/plain; version=0.0.4\r\n"
+         << "Content-Length: " << body.size() << "\r\n"
+         << "Connection: close\r\n\r\n";
+    std::string response = head.str() + body;
+    for (size_t sent = 0; sent < response.size();) {
+        ssize_t length = ::send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (length <= 0) break;
+        sent += static_cast<size_t>(length);
+    }
+#else
+    (void)client;
+#endif
+}
+
+std::string TelemetryExporter::format(const TelemetrySample& sample, const SimulationSnapshot* simulation) {
+    std::ostringstream out;
+    auto metric = [&out](const char* name, const char* type, const char* help) {
+        out << "# HELP browserwind_" << name << ' ' << help << "\n# TYPE browserwind_" << name << ' ' << type << '\n';
+    };
+
+    metric("frame", "counter", "Frames run when the sample was taken.");
+    out << "browserwind_frame " << sample.frame << '\n';
+    metric("uptime_seconds", "gauge", "Seconds since the game started.");
+    out << "browserwind_uptime_seconds " << sample.uptimeSeconds << '\n';
+
+    metric("frame_time_ms", "summary", "Frame time percentiles over the session.");
+    out << "browserwind_frame_time_ms{quantile=\"0.5\"} " << sample.p50Ms << '\n'
+        << "browserwind_frame_time_ms{quantile=\"0.95\"} " << sample.p95Ms << '\n'
+        << "browserwind_frame_time_ms{quantile=\"0.99\"} " << sample.p99Ms << '\n';
+    metric("frame_time_average_ms", "gauge", "Frame time averaged over the last second.");
+    out << "browserwind_frame_time_average_ms " << sample.averageFrameMs << '\n';
+    metric("frame_time_max_ms", "gauge", "Slowest frame of the session.");
+    out << "browserwind_frame_time_max_ms " << sample.maxFrameMs << '\n';
+    metric("frame_budget_exceeded_total", "counter", "Frames over the warning and critical budgets.");
+    out << "browserwind_frame_budget_exceeded_total{level=\"warning\"} " << sample.budgetWarnings << '\n'
+        << "browserwind_frame_budget_exceeded_total{level=\"critical\"} " << sample.budgetCritical << '\n';
+    metric("hitches_total", "counter", "Hitches recorded.");
+    out << "browserwind_hitches_total " << sample.hitches << '\n';
+
+    metric("system_time_ms", "gauge", "Per-system timer average and maximum.");
+    for (int i = 0; i < sample.timerCount; ++i) {
+        const TelemetrySample::Timer& timer = sample.timers[i];
+        out << "browserwind_system_time_ms{system=\"" << timer.name << "\",stat=\"avg\"} " << timer.averageMs << '\n'
+            << "browserwind_system_time_ms{system=\"" << timer.name << "\",stat=\"max\"} " << timer.maxMs << '\n';
+    }
+
+    metric("theme_cache_lookups_total", "counter", "Theme colour and font cache lookups (debug builds).");
+    out << "browserwind_theme_cache_lookups_total{cache=\"color\",result=\"hit\"} " << sample.themeColorHits << '\n'
+        << "browserwind_theme_cache_lookups_total{cache=\"color\",result=\"miss\"} " << sample.themeColorMisses << '\n'
+        << "browserwind_theme_cache_lookups_total{cache=\"font\",result=\"hit\"} " << sample.themeFontHits << '\n'
+        << "browserwind_theme_cache_lookups_total{cache=\"font\",result=\"miss\"} " << sample.themeFontMisses << '\n';
+
+    metric("memory_bytes", "gauge", "Live bytes per memory tag.");
+    for (int tag = 0; tag < MEMORY_TAG_COUNT; ++tag) {
+        out << "browserwind_memory_bytes{tag=\"" << MemoryTracker::getTagName(static_cast<MemoryTag>(tag)) << "\"} "
+            << sample.memoryBytes[tag] << '\n';
+    }
+    metric("memory_peak_bytes", "gauge", "Peak bytes per memory tag.");
+    for (int tag = 0; tag < MEMORY_TAG_COUNT; ++tag) {
+        out << "browserwind_memory_peak_bytes{tag=\"" << MemoryTracker::getTagName(static_cast<MemoryTag>(tag)) << "\"} "
+            << sample.memoryPeakBytes[tag] << '\n';
+    }
+    metric("memory_frame_allocations", "gauge", "Allocations per memory tag in the last sampled frame.");
+    for (int tag = 0; tag < MEMORY_TAG_COUNT; ++tag) {
+        out << "browserwind_memory_frame_allocations{tag=\"" << MemoryTracker::getTagName(static_cast<MemoryTag>(tag)) << "\"} "
+            << sample.memoryFrameAllocations[tag] << '\n';
+    }
+
+    metric("objects", "gauge", "Live object counts.");
+    out << "browserwind_objects{kind=\"environment\"} " << sample.environmentObjects << '\n'
+        << "browserwind_objects{kind=\"rendered\"} " << sample.renderedObjects << '\n'
+        << "browserwind_objects{kind=\"npc\"} " << sample.npcs << '\n'
+        << "browserwind_objects{kind=\"particle\"} " << sample.particles << '\n'
+        << "browserwind_objects{kind=\"asset\"} " << sample.assets << '\n';
+    metric("asset_gpu_bytes", "gauge", "Texture and mesh bytes resident in the asset cache.");
+    out << "browserwind_asset_gpu_bytes " << sample.assetGpuBytes << '\n';
+    metric("quality_level", "gauge", "Quality scaler level; 0 is full quality.");
+    out << "browserwind_quality_level " << sample.qualityLevel << '\n';
+
+    if (simulation && simulation->getGeneration() > 0) {
+        SimulationState state = simulation->read();
+        metric("player", "gauge", "Player state from the latest simulation step.");
+        out << "browserwind_player{stat=\"health\"} " << state.player.health << '\n'
+            << "browserwind_player{stat=\"mana\"} " << state.player.mana << '\n'
+            << "browserwind_player{stat=\"stamina\"} " << state.player.stamina << '\n'
+            << "browserwind_player{stat=\"level\"} " << state.player.level << '\n';
+        metric("combat_total", "counter", "Swings, hits and score.");
+        out << "browserwind_combat_total{stat=\"swings\"} " << state.combat.swingsPerformed << '\n'
+            << "browserwind_combat_total{stat=\"hits\"} " << state.combat.meleeHits << '\n'
+            << "browserwind_combat_total{stat=\"score\"} " << state.combat.score << '\n';
+    }
+    return out.str();
+}
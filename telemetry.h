@@ -0,0 +1,113 @@
+// telemetry.h - Live performance counters served as Prometheus text from a background thread
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "memory_tracker.h"  // For MEMORY_TAG_COUNT
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+class SimulationSnapshot;
+
+/// \brief Counters copied out of the running game in one go. Plain data, so publishing is a copy.
+struct TelemetrySample {
+    static constexpr int MAX_TIMERS = 8;
+
+    struct Timer {
+        const char* name = nullptr;     // Interned by the profiler; lives for the program
+        float averageMs = 0.0f;
+        float maxMs = 0.0f;
+    };
+
+    uint64_t frame = 0;
+    double uptimeSeconds = 0.0;
+
+    // Frame times, from PerformanceMonitorSystem
+    float averageFrameMs = 0.0f;
+    float p50Ms = 0.0f;
+    float p95Ms = 0.0f;
+    float p99Ms = 0.0f;
+    float maxFrameMs = 0.0f;
+    int budgetWarnings = 0;
+    int budgetCritical = 0;
+    int hitches = 0;
+    Timer timers[MAX_TIMERS];
+    int timerCount = 0;
+
+    // Theme lookups (counted in debug builds only)
+    uint64_t themeColorHits = 0;
+    uint64_t themeColorMisses = 0;
+    uint64_t themeFontHits = 0;
+    uint64_t themeFontMisses = 0;
+
+    // Memory per MemoryTag
+    uint64_t memoryBytes[MEMORY_TAG_COUNT] = {};
+    uint64_t memoryPeakBytes[MEMORY_TAG_COUNT] = {};
+    uint32_t memoryFrameAllocations[MEMORY_TAG_COUNT] = {};
+
+    // Object counts and residency
+    uint32_t environmentObjects = 0;
+    uint32_t renderedObjects = 0;
+    uint32_t npcs = 0;
+    uint32_t particles = 0;
+    uint32_t assets = 0;
+    uint64_t assetGpuBytes = 0;
+    int qualityLevel = 0;
+};
+
+/// \brief Serves the latest TelemetrySample, plus the published simulation state, over HTTP
+/// in the Prometheus text format.
+///
+/// The main thread hands samples over with publish(), a copy into a triple buffer and one
+/// atomic exchange, so it never waits on the server thread; the server swaps the newest
+/// sample out the same way and formats it for each scrape. Player and combat numbers are
+/// read from the game's SimulationSnapshot by the server thread itself. The socket listens
+/// on 127.0.0.1 only; ops tooling reaches it through the host.
+///
+/// POSIX sockets; elsewhere start() reports telemetry unavailable.
+class TelemetryExporter {
+public:
+    TelemetryExporter() = default;
+    ~TelemetryExporter();
+
+    TelemetryExporter(const TelemetryExporter&) = delete;
+    TelemetryExporter& operator=(const TelemetryExporter&) = delete;
+
+    /// \brief Opens the listening socket and starts the server thread.
+    /// \param port Local TCP port.
+    /// \param simulation Snapshot to read player state from; may be null. Must outlive the exporter.
+    /// \return False if the socket can't be opened.
+    bool start(int port, const SimulationSnapshot* simulation);
+
+    /// \brief Stops and joins the server thread and closes the socket.
+    void stop();
+
+    bool isRunning() const { return running_.load(std::memory_order_relaxed); }
+
+    /// \brief Makes `sample` what the next scrape reports. Main thread only.
+    void publish(const TelemetrySample& sample);
+
+    /// \brief Formats a sample as Prometheus text.
+    /// \param simulation Snapshot to add player state from; may be null.
+    static std::string format(const TelemetrySample& sample, const SimulationSnapshot* simulation);
+
+private:
+    static constexpr uint32_t FRESH = 4;    // Set in latest_ when it holds a sample the server hasn't taken
+
+    void serveLoop();
+    void respond(int client);
+
+    // Triple buffer: the writer owns one slot, the reader another and latest_ names the third
+    TelemetrySample slots_[3];
+    std::atomic<uint32_t> latest_{1};
+    uint32_t write_slot_ = 0;           // Main thread
+    uint32_t read_slot_ = 2;            // Server thread
+
+    const SimulationSnapshot* simulation_ = nullptr;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    int listen_fd_ = -1;
+};
+
+#endif // TELEMETRY_H
@@ -87,122 +87,257 @@ float easeInOutBounce(float t) {
 // ANIMATION MANAGER IMPLEMENTATION
 // ============================================================================
 
-size_t AnimationManager::createAnimation(AnimationState animation) {
-    animation.isActive = false;
-    animations.push_back(animation);
-    return nextAnimationId++;
+namespace {
+
+constexpr float MIN_DURATION = 0.0001f;
+
+}  // namespace
+
+AnimationHandle AnimationManager::createAnimation(AnimationState animation) {
+    uint32_t index;
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        index = static_cast<uint32_t>(slots.size());
+        slots.emplace_back();
+    }
+
+    Slot& slot = slots[index];
+    animation.duration = std::max(animation.duration, MIN_DURATION);
+    if (static_cast<size_t>(animation.easing) >= EASING_COUNT) {
+        animation.easing = EasingFunction::LINEAR;
+    }
+    slot.state = std::move(animation);
+    slot.live = true;
+    slot.running = false;
+    return {index, slot.generation};
 }
 
-void AnimationManager::startAnimation(size_t animationId) {
-    if (animationId < animations.size()) {
-        animations[animationId].isActive = true;
-        animations[animationId].elapsedTime = 0.0f;
+void AnimationManager::startAnimation(AnimationHandle handle) {
+    Slot* slot = resolve(handle);
+    if (slot == nullptr) return;
+
+    if (slot->running) {
+        EasingGroup& group = groups[static_cast<size_t>(slot->state.easing)];
+        group.elapsed[slot->position] = 0.0f;
+        return;
     }
+
+    const AnimationState& state = slot->state;
+    EasingGroup& group = groups[static_cast<size_t>(state.easing)];
+    slot->position = static_cast<uint32_t>(group.size());
+    slot->running = true;
+    group.elapsed.push_back(0.0f);
+    group.duration.push_back(state.duration);
+    group.startValue.push_back(state.startValue);
+    group.delta.push_back(state.endValue - state.startValue);
+    group.target.push_back(state.target != nullptr ? state.target : &sink);
+    group.looping.push_back(state.isLooping ? 1 : 0);
+    group.slot.push_back(handle.index);
+    group.eased.push_back(0.0f);
 }
 
-void AnimationManager::stopAnimation(size_t animationId) {
-    if (animationId < animations.size()) {
-        animations[animationId].isActive = false;
-        if (animations[animationId].onComplete) {
-            animations[animationId].onComplete();
-        }
+void AnimationManager::stopAnimation(AnimationHandle handle) {
+    Slot* slot = resolve(handle);
+    if (slot == nullptr) return;
+
+    std::function<void()> onComplete = std::move(slot->state.onComplete);
+    detach(handle.index);
+    release(handle.index);
+    if (onComplete) {
+        onComplete();
     }
 }
 
-void AnimationManager::update(float deltaTime) {
-    for (size_t i = 0; i < animations.size(); ++i) {
-        AnimationState& animation = animations[i];
+// Each pass is a flat loop over the group's arrays with the easing function inlined,
+// so the compiler can vectorize the arithmetic passes
+template <float (*Ease)(float)>
+void AnimationManager::advanceGroup(EasingGroup& group, float deltaTime) {
+    const size_t count = group.size();
+    float* elapsed = group.elapsed.data();
+    const float* duration = group.duration.data();
+    const uint8_t* looping = group.looping.data();
+    float* eased = group.eased.data();
+
+    for (size_t i = 0; i < count; ++i) {
+        float time = elapsed[i] + deltaTime;
+        if (time >= duration[i]) {
+            time = looping[i] ? 0.0f : duration[i];
+        }
+        elapsed[i] = time;
+        eased[i] = time / duration[i];
+    }
 
-        if (!animation.isActive) continue;
+    for (size_t i = 0; i < count; ++i) {
+        eased[i] = Ease(eased[i]);
+    }
 
-        animation.elapsedTime += deltaTime;
+    const float* startValue = group.startValue.data();
+    const float* delta = group.delta.data();
+    float* const* target = group.target.data();
+    for (size_t i = 0; i < count; ++i) {
+        *target[i] = startValue[i] + delta[i] * eased[i];
+    }
+}
 
-        // Handle looping animations
-        if (animation.isLooping && animation.elapsedTime >= animation.duration) {
-            animation.elapsedTime = 0.0f;
-        }
-        // Handle completion for non-looping animations
-        else if (!animation.isLooping && animation.elapsedTime >= animation.duration) {
-            animation.elapsedTime = animation.duration;
-            animation.isActive = false;
-            if (animation.onComplete) {
-                animation.onComplete();
+void AnimationManager::update(float deltaTime) {
+    // Indexed by EasingFunction
+    static constexpr GroupKernel KERNELS[EASING_COUNT] = {
+        advanceGroup<linear>,
+        advanceGroup<easeInQuad>,
+        advanceGroup<easeOutQuad>,
+        advanceGroup<easeInOutQuad>,
+        advanceGroup<easeInCubic>,
+        advanceGroup<easeOutCubic>,
+        advanceGroup<easeInOutCubic>,
+        advanceGroup<easeInBack>,
+        advanceGroup<easeOutBack>,
+        advanceGroup<easeInOutBack>,
+        advanceGroup<easeInBounce>,
+        advanceGroup<easeOutBounce>,
+        advanceGroup<easeInOutBounce>,
+    };
+
+    for (size_t easing = 0; easing < EASING_COUNT; ++easing) {
+        EasingGroup& group = groups[easing];
+        if (group.size() == 0) continue;
+
+        KERNELS[easing](group, deltaTime);
+
+        // Completed one-shots already wrote their end value; collect them in a cold pass
+        for (size_t i = 0; i < group.size(); ++i) {
+            if (!group.looping[i] && group.elapsed[i] >= group.duration[i]) {
+                finished.push_back(group.slot[i]);
             }
         }
+    }
 
-        // Calculate progress and apply easing
-        float progress = std::min(animation.elapsedTime / animation.duration, 1.0f);
-        float easedProgress = applyEasing(progress, animation.easing);
-
-        // Calculate current value
-        float currentValue = animation.startValue +
-                           (animation.endValue - animation.startValue) * easedProgress;
+    if (finished.empty()) return;
 
-        // Call update callback
-        if (animation.onUpdate) {
-            animation.onUpdate(currentValue);
+    // Removing first lets onComplete start new animations without touching the groups mid-loop
+    for (uint32_t index : finished) {
+        detach(index);
+    }
+    for (uint32_t index : finished) {
+        std::function<void()> onComplete = std::move(slots[index].state.onComplete);
+        release(index);
+        if (onComplete) {
+            onComplete();
         }
     }
+    finished.clear();
 }
 
 void AnimationManager::clear() {
-    animations.clear();
-    nextAnimationId = 0;
+    slots.clear();
+    freeSlots.clear();
+    for (EasingGroup& group : groups) {
+        group = EasingGroup();
+    }
+    finished.clear();
+}
+
+AnimationManager::Slot* AnimationManager::resolve(AnimationHandle handle) {
+    if (handle.index >= slots.size()) return nullptr;
+    Slot& slot = slots[handle.index];
+    return slot.live && slot.generation == handle.generation ? &slot : nullptr;
+}
+
+const AnimationManager::Slot* AnimationManager::resolve(AnimationHandle handle) const {
+    return const_cast<AnimationManager*>(this)->resolve(handle);
 }
 
-size_t AnimationManager::animateFadeIn(float duration, std::function<void(float)> callback) {
+void AnimationManager::detach(uint32_t slotIndex) {
+    Slot& slot = slots[slotIndex];
+    if (!slot.running) return;
+    slot.running = false;
+
+    // Swap the last running animation into the gap
+    EasingGroup& group = groups[static_cast<size_t>(slot.state.easing)];
+    size_t position = slot.position;
+    size_t last = group.size() - 1;
+    if (position != last) {
+        group.elapsed[position] = group.elapsed[last];
+        group.duration[position] = group.duration[last];
+        group.startValue[position] = group.startValue[last];
+        group.delta[position] = group.delta[last];
+        group.target[position] = group.target[last];
+        group.looping[position] = group.looping[last];
+        group.slot[position] = group.slot[last];
+        slots[group.slot[position]].position = static_cast<uint32_t>(position);
+    }
+    group.elapsed.pop_back();
+    group.duration.pop_back();
+    group.startValue.pop_back();
+    group.delta.pop_back();
+    group.target.pop_back();
+    group.looping.pop_back();
+    group.slot.pop_back();
+    group.eased.pop_back();
+}
+
+void AnimationManager::release(uint32_t slotIndex) {
+    Slot& slot = slots[slotIndex];
+    slot.live = false;
+    slot.state = AnimationState();
+    ++slot.generation;
+    freeSlots.push_back(slotIndex);
+}
+
+AnimationHandle AnimationManager::animateFadeIn(float duration, float* target) {
     AnimationState animation(AnimationType::FADE_IN, EasingFunction::EASE_OUT_QUAD, duration);
     animation.startValue = 0.0f;
     animation.endValue = 1.0f;
-    animation.onUpdate = callback;
+    animation.target = target;
     return createAnimation(animation);
 }
 
-size_t AnimationManager::animateFadeOut(float duration, std::function<void(float)> callback) {
+AnimationHandle AnimationManager::animateFadeOut(float duration, float* target) {
     AnimationState animation(AnimationType::FADE_OUT, EasingFunction::EASE_IN_QUAD, duration);
     animation.startValue = 1.0f;
     animation.endValue = 0.0f;
-    animation.onUpdate = callback;
+    animation.target = target;
     return createAnimation(animation);
 }
 
-size_t AnimationManager::animateScaleIn(float duration, std::function<void(float)> callback) {
+AnimationHandle AnimationManager::animateScaleIn(float duration, float* target) {
     AnimationState animation(AnimationType::SCALE_IN, EasingFunction::EASE_OUT_BACK, duration);
     animation.startValue = 0.0f;
     animation.endValue = 1.0f;
-    animation.onUpdate = callback;
+    animation.target = target;
     return createAnimation(animation);
 }
 
-size_t AnimationManager::animateSlideInLeft(float duration, std::function<void(float)> callback) {
+AnimationHandle AnimationManager::animateSlideInLeft(float duration, float* target) {
     AnimationState animation(AnimationType::SLIDE_IN_LEFT, EasingFunction::EASE_OUT_QUAD, duration);
     animation.startValue = -1.0f;
     animation.endValue = 0.0f;
-    animation.onUpdate = callback;
+    animation.target = target;
     return createAnimation(animation);
 }
 
-size_t AnimationManager::animateSlideInRight(float duration, std::function<void(float)> callback) {
+AnimationHandle AnimationManager::animateSlideInRight(float duration, float* target) {
     AnimationState animation(AnimationType::SLIDE_IN_RIGHT, EasingFunction::EASE_OUT_QUAD, duration);
     animation.startValue = 1.0f;
     animation.endValue = 0.0f;
-    animation.onUpdate = callback;
+    animation.target = target;
     return createAnimation(animation);
 }
 
-size_t AnimationManager::animateBounce(float duration, std::function<void(float)> callback) {
+AnimationHandle AnimationManager::animateBounce(float duration, float* target) {
     AnimationState animation(AnimationType::BOUNCE, EasingFunction::EASE_OUT_BOUNCE, duration);
     animation.startValue = 0.0f;
     animation.endValue = 1.0f;
-    animation.onUpdate = callback;
+    animation.target = target;
     return createAnimation(animation);
 }
 
-size_t AnimationManager::animatePulse(float duration, bool loop, std::function<void(float)> callback) {
+AnimationHandle AnimationManager::animatePulse(float duration, bool loop, float* target) {
     AnimationState animation(AnimationType::PULSE, EasingFunction::EASE_IN_OUT_QUAD, duration, loop);
     animation.startValue = 1.0f;
     animation.endValue = 1.2f;
-    animation.onUpdate = callback;
+    animation.target = target;
     return createAnimation(animation);
 }
 
@@ -225,46 +360,58 @@ float AnimationManager::applyEasing(float t, EasingFunction easing) {
     }
 }
 
-float AnimationManager::getAnimationProgress(size_t animationId) {
-    if (animationId >= animations.size()) return 0.0f;
+float AnimationManager::getAnimationProgress(AnimationHandle handle) const {
+    const Slot* slot = resolve(handle);
+    if (slot == nullptr || !slot->running) return 1.0f;
 
-    const AnimationState& animation = animations[animationId];
-    if (!animation.isActive) return 1.0f;
+    const EasingGroup& group = groups[static_cast<size_t>(slot->state.easing)];
+    return std::min(group.elapsed[slot->position] / group.duration[slot->position], 1.0f);
+}
+
+bool AnimationManager::isRunning(AnimationHandle handle) const {
+    const Slot* slot = resolve(handle);
+    return slot != nullptr && slot->running;
+}
 
-    return std::min(animation.elapsedTime / animation.duration, 1.0f);
+size_t AnimationManager::getRunningCount() const {
+    size_t count = 0;
+    for (const EasingGroup& group : groups) {
+        count += group.size();
+    }
+    return count;
 }
 
 // ============================================================================
 // GLOBAL FUNCTIONS FOR EASY ACCESS
 // ============================================================================
 
-size_t animateUIElement(AnimationType type, float duration, std::function<void(float)> callback) {
+AnimationHandle animateUIElement(AnimationType type, float duration, float* target) {
     switch (type) {
         case AnimationType::FADE_IN:
-            return AnimationManager::getInstance().animateFadeIn(duration, callback);
+            return AnimationManager::getInstance().animateFadeIn(duration, target);
         case AnimationType::FADE_OUT:
-            return AnimationManager::getInstance().animateFadeOut(duration, callback);
+            return AnimationManager::getInstance().animateFadeOut(duration, target);
         case AnimationType::SCALE_IN:
-            return AnimationManager::getInstance().animateScaleIn(duration, callback);
+            return AnimationManager::getInstance().animateScaleIn(duration, target);
         case AnimationType::SLIDE_IN_LEFT:
-            return AnimationManager::getInstance().animateSlideInLeft(duration, callback);
+            return AnimationManager::getInstance().animateSlideInLeft(duration, target);
         case AnimationType::SLIDE_IN_RIGHT:
-            return AnimationManager::getInstance().animateSlideInRight(duration, callback);
+            return AnimationManager::getInstance().animateSlideInRight(duration, target);
         case AnimationType::BOUNCE:
-            return AnimationManager::getInstance().animateBounce(duration, callback);
+            return AnimationManager::getInstance().animateBounce(duration, target);
         case AnimationType::PULSE:
-            return AnimationManager::getInstance().animatePulse(duration, true, callback);
+            return AnimationManager::getInstance().animatePulse(duration, true, target);
         default:
-            return AnimationManager::getInstance().animateFadeIn(duration, callback);
+            return AnimationManager::getInstance().animateFadeIn(duration, target);
     }
 }
 
-void startUIAnimation(size_t animationId) {
-    AnimationManager::getInstance().startAnimation(animationId);
+void startUIAnimation(AnimationHandle handle) {
+    AnimationManager::getInstance().startAnimation(handle);
 }
 
-void stopUIAnimation(size_t animationId) {
-    AnimationManager::getInstance().stopAnimation(animationId);
+void stopUIAnimation(AnimationHandle handle) {
+    AnimationManager::getInstance().stopAnimation(handle);
 }
 
 } // namespace UIAnimation
@@ -3,6 +3,8 @@
 #define UI_ANIMATION_H
 
 #include "raylib.h"
+#include <array>
+#include <cstdint>
 #include <functional>
 #include <vector>
 #include <memory>
@@ -44,25 +46,38 @@ enum class EasingFunction {
     EASE_IN_OUT_BOUNCE
 };
 
+/// \brief Identifies a running animation. Stale once it finishes or is stopped, after
+/// which the slot may be reused; calls with a stale handle are ignored.
+struct AnimationHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+    bool isValid() const { return index != UINT32_MAX; }
+};
+
 struct AnimationState {
     AnimationType type;
     EasingFunction easing;
     float duration;       // Total animation duration in seconds
-    float elapsedTime;    // Time elapsed since animation started
     float startValue;     // Starting value (alpha, scale, position, etc.)
     float endValue;       // Target value
-    bool isActive;        // Whether animation is currently running
     bool isLooping;       // Whether animation should loop
-    std::function<void(float)> onUpdate;  // Callback with current progress (0-1)
-    std::function<void()> onComplete;     // Callback when animation finishes
+    float* target;        // Receives the current value every update; must outlive the animation
+    std::function<void()> onComplete;     // Called once when animation finishes or is stopped
 
     AnimationState(AnimationType t = AnimationType::FADE_IN,
                    EasingFunction e = EasingFunction::EASE_OUT_QUAD,
                    float dur = 0.3f, bool loop = false)
-        : type(t), easing(e), duration(dur), elapsedTime(0.0f),
-          startValue(0.0f), endValue(1.0f), isActive(false), isLooping(loop) {}
+        : type(t), easing(e), duration(dur), startValue(0.0f), endValue(1.0f),
+          isLooping(loop), target(nullptr) {}
 };
 
+/// \brief Tween engine for UI animations.
+///
+/// Running animations are stored as parallel arrays, one set per easing function, so
+/// update() advances each group with a loop over contiguous floats and one easing
+/// function the compiler inlines, then writes the values straight into the bound
+/// targets. Finished animations are swapped out of their group, keeping the arrays
+/// dense, and their slots are recycled behind generation-checked handles.
 class AnimationManager {
 public:
     static AnimationManager& getInstance() {
@@ -71,33 +86,75 @@ public:
     }
 
     // Animation management
-    size_t createAnimation(AnimationState animation);
-    void startAnimation(size_t animationId);
-    void stopAnimation(size_t animationId);
+    AnimationHandle createAnimation(AnimationState animation);
+    /// \brief Runs a created animation from its start value; restarts it if already running.
+    void startAnimation(AnimationHandle handle);
+    /// \brief Stops an animation where it is, calls its onComplete and invalidates the handle.
+    void stopAnimation(AnimationHandle handle);
     void update(float deltaTime);
     void clear();
 
-    // Quick animation methods
-    size_t animateFadeIn(float duration = 0.3f, std::function<void(float)> callback = nullptr);
-    size_t animateFadeOut(float duration = 0.3f, std::function<void(float)> callback = nullptr);
-    size_t animateScaleIn(float duration = 0.4f, std::function<void(float)> callback = nullptr);
-    size_t animateSlideInLeft(float duration = 0.3f, std::function<void(float)> callback = nullptr);
-    size_t animateSlideInRight(float duration = 0.3f, std::function<void(float)> callback = nullptr);
-    size_t animateBounce(float duration = 0.6f, std::function<void(float)> callback = nullptr);
-    size_t animatePulse(float duration = 1.0f, bool loop = true, std::function<void(float)> callback = nullptr);
+    // Quick animation methods; created stopped, like createAnimation()
+    AnimationHandle animateFadeIn(float duration = 0.3f, float* target = nullptr);
+    AnimationHandle animateFadeOut(float duration = 0.3f, float* target = nullptr);
+    AnimationHandle animateScaleIn(float duration = 0.4f, float* target = nullptr);
+    AnimationHandle animateSlideInLeft(float duration = 0.3f, float* target = nullptr);
+    AnimationHandle animateSlideInRight(float duration = 0.3f, float* target = nullptr);
+    AnimationHandle animateBounce(float duration = 0.6f, float* target = nullptr);
+    AnimationHandle animatePulse(float duration = 1.0f, bool loop = true, float* target = nullptr);
 
     // Utility functions
     float applyEasing(float t, EasingFunction easing);
-    float getAnimationProgress(size_t animationId);
+    /// \brief Gets 0-1 progress of a running animation; 1 once it has finished or stopped.
+    float getAnimationProgress(AnimationHandle handle) const;
+    bool isRunning(AnimationHandle handle) const;
+    size_t getRunningCount() const;
 
 private:
+    static constexpr size_t EASING_COUNT = static_cast<size_t>(EasingFunction::EASE_IN_OUT_BOUNCE) + 1;
+
+    // Running animations of one easing function, as parallel arrays
+    struct EasingGroup {
+        std::vector<float> elapsed;
+        std::vector<float> duration;
+        std::vector<float> startValue;
+        std::vector<float> delta;       // endValue - startValue
+        std::vector<float*> target;     // Never null; unbound animations write to a sink
+        std::vector<uint8_t> looping;
+        std::vector<uint32_t> slot;
+        std::vector<float> eased;       // Scratch for the easing pass
+
+        size_t size() const { return elapsed.size(); }
+    };
+
+    struct Slot {
+        AnimationState state;
+        uint32_t generation = 0;
+        uint32_t position = 0;          // Index in its easing group while running
+        bool live = false;
+        bool running = false;
+    };
+
+    using GroupKernel = void (*)(EasingGroup& group, float deltaTime);
+
     AnimationManager() = default;
     ~AnimationManager() = default;
     AnimationManager(const AnimationManager&) = delete;
     AnimationManager& operator=(const AnimationManager&) = delete;
 
-    std::vector<AnimationState> animations;
-    size_t nextAnimationId = 0;
+    template <float (*Ease)(float)>
+    static void advanceGroup(EasingGroup& group, float deltaTime);
+
+    Slot* resolve(AnimationHandle handle);
+    const Slot* resolve(AnimationHandle handle) const;
+    void detach(uint32_t slotIndex);
+    void release(uint32_t slotIndex);
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::array<EasingGroup, EASING_COUNT> groups;
+    std::vector<uint32_t> finished;     // Reused by update()
+    float sink = 0.0f;
 };
 
 // ============================================================================
@@ -122,10 +179,9 @@ float easeInOutBounce(float t);
 // GLOBAL FUNCTIONS FOR EASY ACCESS
 // ============================================================================
 
-size_t animateUIElement(AnimationType type, float duration = 0.3f,
-                       std::function<void(float)> callback = nullptr);
-void startUIAnimation(size_t animationId);
-void stopUIAnimation(size_t animationId);
+AnimationHandle animateUIElement(AnimationType type, float duration = 0.3f, float* target = nullptr);
+void startUIAnimation(AnimationHandle handle);
+void stopUIAnimation(AnimationHandle handle);
 
 } // namespace UIAnimation
 
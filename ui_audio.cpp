@@ -1,9 +1,106 @@
 // ui_audio.cpp - Implementation of the UI audio system
 #include "ui_audio.h"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 
 namespace UIAudio {
 
+namespace {
+
+struct EffectInfo {
+    SoundCategory category;
+    uint8_t priority;       // Higher steals from lower
+    uint8_t voices;         // Concurrent plays of this effect, up to MAX_VOICES_PER_EFFECT
+};
+
+// Indexed by SoundEffect
+constexpr EffectInfo EFFECT_INFO[] = {
+    {SoundCategory::INTERFACE, 1, 3},   // UI_CLICK
+    {SoundCategory::INTERFACE, 0, 2},   // UI_HOVER
+    {SoundCategory::INTERFACE, 2, 2},   // UI_OPEN
+    {SoundCategory::INTERFACE, 2, 2},   // UI_CLOSE
+    {SoundCategory::FEEDBACK, 3, 2},    // UI_SUCCESS
+    {SoundCategory::ALERT, 3, 2},       // UI_ERROR
+    {SoundCategory::FEEDBACK, 2, 2},    // UI_NOTIFICATION
+    {SoundCategory::FEEDBACK, 1, 4},    // UI_ITEM_PICKUP
+    {SoundCategory::ALERT, 3, 1},       // UI_INVENTORY_FULL
+    {SoundCategory::FEEDBACK, 3, 2},    // UI_QUEST_UPDATE
+};
+static_assert(sizeof(EFFECT_INFO) / sizeof(EFFECT_INFO[0]) == static_cast<size_t>(SoundEffect::SOUND_EFFECT_COUNT),
+              "EFFECT_INFO needs an entry per SoundEffect");
+
+// Indexed by SoundCategory
+constexpr size_t CATEGORY_VOICE_LIMITS[] = {4, 4, 2};
+
+constexpr unsigned int MIXER_CHANNELS = 2;  // raylib mixes in interleaved stereo float
+
+/// Per-sample gain for one music stream. The main thread publishes a target and a ramp
+/// length; the stream processor, on the audio thread, walks the gain towards it.
+struct GainRamp {
+    std::atomic<float> target{0.0f};
+    std::atomic<uint32_t> rampFrames{0};
+    std::atomic<uint32_t> serial{0};
+
+    // Audio thread only, once the processor is attached
+    uint32_t seenSerial = 0;
+    float current = 0.0f;
+    float rampTarget = 0.0f;
+    float step = 0.0f;
+    uint32_t remaining = 0;
+
+    // Only while no processor is attached
+    void reset(float gain) {
+        target.store(gain, std::memory_order_relaxed);
+        rampFrames.store(0, std::memory_order_relaxed);
+        seenSerial = serial.load(std::memory_order_relaxed);
+        current = rampTarget = gain;
+        remaining = 0;
+    }
+
+    void publish(float gain, uint32_t frames) {
+        target.store(gain, std::memory_order_relaxed);
+        rampFrames.store(frames, std::memory_order_relaxed);
+        serial.fetch_add(1, std::memory_order_release);
+    }
+
+    void process(float* samples, unsigned int frames) {
+        uint32_t latest = serial.load(std::memory_order_acquire);
+        if (latest != seenSerial) {
+            seenSerial = latest;
+            rampTarget = target.load(std::memory_order_relaxed);
+            remaining = std::max<uint32_t>(1, rampFrames.load(std::memory_order_relaxed));
+            step = (rampTarget - current) / static_cast<float>(remaining);
+        }
+
+        for (unsigned int frame = 0; frame < frames; ++frame) {
+            if (remaining > 0) {
+                current = --remaining == 0 ? rampTarget : current + step;
+            }
+            for (unsigned int channel = 0; channel < MIXER_CHANNELS; ++channel) {
+                samples[frame * MIXER_CHANNELS + channel] *= current;
+            }
+        }
+    }
+};
+
+GainRamp trackGains[static_cast<size_t>(MusicTrack::MUSIC_TRACK_COUNT)];
+
+// raylib processors take no user data, so each track gets its own entry point
+template <size_t Track>
+void processTrack(void* buffer, unsigned int frames) {
+    trackGains[Track].process(static_cast<float*>(buffer), frames);
+}
+
+// Indexed by MusicTrack
+constexpr AudioCallback TRACK_PROCESSORS[] = {
+    processTrack<0>, processTrack<1>, processTrack<2>, processTrack<3>, processTrack<4>,
+};
+static_assert(sizeof(TRACK_PROCESSORS) / sizeof(TRACK_PROCESSORS[0]) == static_cast<size_t>(MusicTrack::MUSIC_TRACK_COUNT),
+              "TRACK_PROCESSORS needs an entry per MusicTrack");
+
+}  // namespace
+
 // ============================================================================
 // AUDIO MANAGER IMPLEMENTATION
 // ============================================================================
@@ -33,17 +130,20 @@ void AudioManager::shutdown() {
     stopAllSounds();
     stopAllMusic();
 
-    // Unload all sound effects
-    for (auto& pair : soundEffects) {
-        UnloadSound(pair.second);
+    // Unload all sound effects, aliases before the sound that owns their samples
+    for (EffectBank& bank : effects) {
+        for (size_t i = bank.soundCount; i-- > 1;) {
+            UnloadSoundAlias(bank.sounds[i]);
+        }
+        if (bank.soundCount > 0) {
+            UnloadSound(bank.sounds[0]);
+        }
+        bank = EffectBank();
     }
-    soundEffects.clear();
 
-    // Unload all music tracks
-    for (auto& pair : musicTracks) {
-        UnloadMusicStream(pair.second);
+    for (TrackStream& stream : tracks) {
+        stream = TrackStream();
     }
-    musicTracks.clear();
 
     // Close audio device
     CloseAudioDevice();
@@ -51,9 +151,17 @@ void AudioManager::shutdown() {
 }
 
 void AudioManager::loadSoundEffect(SoundEffect effect, const std::string& filePath) {
+    EffectBank& bank = effects[static_cast<size_t>(effect)];
+    if (bank.soundCount > 0) return;
+
     Sound sound = LoadSound(filePath.c_str());
     if (sound.stream.buffer != nullptr) {  // Check if sound loaded successfully
-        soundEffects[effect] = sound;
+        bank.sounds[0] = sound;
+        bank.soundCount = 1;
+        size_t voices = std::min<size_t>(EFFECT_INFO[static_cast<size_t>(effect)].voices, MAX_VOICES_PER_EFFECT);
+        while (bank.soundCount < voices) {
+            bank.sounds[bank.soundCount++] = LoadSoundAlias(sound);
+        }
         std::cout << "Loaded sound effect: " << filePath << std::endl;
     } else {
         std::cout << "Warning: Failed to load sound effect: " << filePath << std::endl;
@@ -63,26 +171,114 @@ void AudioManager::loadSoundEffect(SoundEffect effect, const std::string& filePa
 void AudioManager::playSoundEffect(SoundEffect effect, float volume) {
     if (!settings.soundEnabled) return;
 
-    auto it = soundEffects.find(effect);
-    if (it != soundEffects.end()) {
-        float effectiveVolume = (volume < 0.0f) ?
-            calculateEffectiveVolume(settings.sfxVolume) : volume;
-        SetSoundVolume(it->second, effectiveVolume);
-        PlaySound(it->second);
+    Voice* voice = acquireVoice(effect);
+    if (voice == nullptr) return;
+
+    Sound& sound = effects[static_cast<size_t>(effect)].sounds[voice->sound];
+    float effectiveVolume = (volume < 0.0f) ?
+        calculateEffectiveVolume(settings.sfxVolume) : volume;
+    SetSoundVolume(sound, effectiveVolume);
+    PlaySound(sound);
+}
+
+AudioManager::Voice* AudioManager::acquireVoice(SoundEffect effect) {
+    const EffectBank& bank = effects[static_cast<size_t>(effect)];
+    if (bank.soundCount == 0) return nullptr;
+
+    reapVoices();
+    const EffectInfo& info = EFFECT_INFO[static_cast<size_t>(effect)];
+
+    // Every alias of this effect busy: retrigger its oldest play
+    uint32_t busySounds = 0;
+    Voice* oldestSame = nullptr;
+    for (Voice& voice : voices) {
+        if (voice.active && voice.effect == effect) {
+            busySounds |= 1u << voice.sound;
+            if (oldestSame == nullptr || voice.sequence < oldestSame->sequence) {
+                oldestSame = &voice;
+            }
+        }
+    }
+    if (busySounds == (1u << bank.soundCount) - 1) {
+        StopSound(bank.sounds[oldestSame->sound]);
+        oldestSame->sequence = ++voiceSequence;
+        return oldestSame;
+    }
+
+    size_t inCategory = 0;
+    Voice* freeVoice = nullptr;
+    for (Voice& voice : voices) {
+        if (voice.active) {
+            inCategory += voice.category == info.category ? 1 : 0;
+        } else if (freeVoice == nullptr) {
+            freeVoice = &voice;
+        }
     }
+
+    // Over budget: steal the oldest of the lowest priority, from this category if it is
+    // the one that's full, otherwise from the whole pool
+    bool categoryFull = inCategory >= CATEGORY_VOICE_LIMITS[static_cast<size_t>(info.category)];
+    if (categoryFull || freeVoice == nullptr) {
+        Voice* victim = nullptr;
+        for (Voice& voice : voices) {
+            if (!voice.active || (categoryFull && voice.category != info.category)) continue;
+            if (victim == nullptr || voice.priority < victim->priority ||
+                (voice.priority == victim->priority && voice.sequence < victim->sequence)) {
+                victim = &voice;
+            }
+        }
+        if (victim == nullptr || victim->priority > info.priority) return nullptr;
+
+        StopSound(effects[static_cast<size_t>(victim->effect)].sounds[victim->sound]);
+        victim->active = false;
+        freeVoice = victim;
+    }
+
+    uint8_t sound = 0;
+    while (busySounds & (1u << sound)) {
+        ++sound;
+    }
+
+    freeVoice->effect = effect;
+    freeVoice->sound = sound;
+    freeVoice->priority = info.priority;
+    freeVoice->category = info.category;
+    freeVoice->sequence = ++voiceSequence;
+    freeVoice->active = true;
+    return freeVoice;
+}
+
+void AudioManager::reapVoices() {
+    for (Voice& voice : voices) {
+        if (voice.active && !IsSoundPlaying(effects[static_cast<size_t>(voice.effect)].sounds[voice.sound])) {
+            voice.active = false;
+        }
+    }
+}
+
+size_t AudioManager::getActiveVoiceCount() const {
+    size_t count = 0;
+    for (const Voice& voice : voices) {
+        if (voice.active && IsSoundPlaying(effects[static_cast<size_t>(voice.effect)].sounds[voice.sound])) {
+            ++count;
+        }
+    }
+    return count;
 }
 
 void AudioManager::stopAllSounds() {
-    for (auto& pair : soundEffects) {
-        StopSound(pair.second);
+    for (Voice& voice : voices) {
+        if (voice.active) {
+            StopSound(effects[static_cast<size_t>(voice.effect)].sounds[voice.sound]);
+            voice.active = false;
+        }
     }
 }
 
 void AudioManager::loadMusicTrack(MusicTrack track, const std::string& filePath) {
-    Music music = LoadMusicStream(filePath.c_str());
-    if (music.stream.buffer != nullptr) {  // Check if music loaded successfully
-        musicTracks[track] = music;
-        std::cout << "Loaded music track: " << filePath << std::endl;
+    if (FileExists(filePath.c_str())) {
+        tracks[static_cast<size_t>(track)].path = filePath;
+        std::cout << "Registered music track: " << filePath << std::endl;
     } else {
         std::cout << "Warning: Failed to load music track: " << filePath << std::endl;
     }
@@ -91,40 +287,76 @@ void AudioManager::loadMusicTrack(MusicTrack track, const std::string& filePath)
 void AudioManager::playMusicTrack(MusicTrack track, bool loop) {
     if (!settings.musicEnabled) return;
 
-    auto it = musicTracks.find(track);
-    if (it != musicTracks.end()) {
-        float effectiveVolume = calculateEffectiveVolume(settings.musicVolume);
-        SetMusicVolume(it->second, effectiveVolume);
-        musicVolumes[track] = effectiveVolume;  // Track current volume
-        PlayMusicStream(it->second);
-        if (loop) {
-            // Music will loop automatically when using PlayMusicStream with loop enabled
+    size_t index = static_cast<size_t>(track);
+    TrackStream& stream = tracks[index];
+    if (stream.path.empty()) return;
+
+    if (!stream.open) {
+        // Small stream buffers keep the decoded audio in flight, and the latency, low
+        SetAudioStreamBufferSizeDefault(MUSIC_BUFFER_FRAMES);
+        stream.music = LoadMusicStream(stream.path.c_str());
+        SetAudioStreamBufferSizeDefault(0);
+        if (stream.music.stream.buffer == nullptr) {
+            std::cout << "Warning: Failed to stream music track: " << stream.path << std::endl;
+            return;
         }
+        stream.open = true;
+        playingTracks[playingCount++] = track;
+
+        // The processor applies the volume, so the stream itself plays at full scale
+        stream.volume = 1.0f;
+        stream.fadeEndTime = 0.0;
+        SetMusicVolume(stream.music, 1.0f);
+        trackGains[index].reset(calculateEffectiveVolume(settings.musicVolume));
+        AttachAudioStreamProcessor(stream.music.stream, TRACK_PROCESSORS[index]);
     }
+
+    stream.music.looping = loop;
+    PlayMusicStream(stream.music);
 }
 
 void AudioManager::stopMusicTrack(MusicTrack track) {
-    auto it = musicTracks.find(track);
-    if (it != musicTracks.end()) {
-        StopMusicStream(it->second);
+    closeTrack(track);
+}
+
+void AudioManager::closeTrack(MusicTrack track) {
+    size_t index = static_cast<size_t>(track);
+    TrackStream& stream = tracks[index];
+    if (!stream.open) return;
+
+    DetachAudioStreamProcessor(stream.music.stream, TRACK_PROCESSORS[index]);
+    StopMusicStream(stream.music);
+    UnloadMusicStream(stream.music);
+    stream.music = Music{};
+    stream.open = false;
+
+    auto end = playingTracks.begin() + playingCount;
+    auto it = std::find(playingTracks.begin(), end, track);
+    if (it != end) {
+        *it = playingTracks[--playingCount];
     }
 }
 
 void AudioManager::fadeMusicTrack(MusicTrack track, float targetVolume, float duration) {
-    auto it = musicTracks.find(track);
-    if (it != musicTracks.end()) {
-        float currentVolume = musicVolumes[track];  // Use tracked volume
-        fadeTargets[track] = targetVolume;
-        fadeSpeeds[track] = (targetVolume - currentVolume) / duration;
-    }
+    TrackStream& stream = tracks[static_cast<size_t>(track)];
+    if (!stream.open) return;
+
+    stream.volume = std::max(0.0f, std::min(1.0f, targetVolume));
+    stream.fadeEndTime = GetTime() + duration;
+    publishTrackGain(track, duration);
+}
+
+void AudioManager::publishTrackGain(MusicTrack track, float rampSeconds) {
+    const TrackStream& stream = tracks[static_cast<size_t>(track)];
+    float gain = calculateEffectiveVolume(stream.volume * settings.musicVolume);
+    uint32_t frames = static_cast<uint32_t>(std::max(0.0f, rampSeconds) * stream.music.stream.sampleRate);
+    trackGains[static_cast<size_t>(track)].publish(gain, frames);
 }
 
 void AudioManager::stopAllMusic() {
-    for (auto& pair : musicTracks) {
-        StopMusicStream(pair.second);
+    while (playingCount > 0) {
+        closeTrack(playingTracks[playingCount - 1]);
     }
-    fadeTargets.clear();
-    fadeSpeeds.clear();
 }
 
 void AudioManager::setMasterVolume(float volume) {
@@ -157,58 +389,41 @@ void AudioManager::setMusicEnabled(bool enabled) {
     }
 }
 
-void AudioManager::update(float deltaTime) {
-    // Update music streams (required for streaming)
-    for (auto& pair : musicTracks) {
-        UpdateMusicStream(pair.second);
-    }
-
-    // Handle music fading
-    for (auto it = fadeTargets.begin(); it != fadeTargets.end(); ) {
-        auto musicIt = musicTracks.find(it->first);
-        if (musicIt != musicTracks.end()) {
-            float currentVolume = musicVolumes[it->first];  // Use tracked volume
-            float newVolume = currentVolume + (fadeSpeeds[it->first] * deltaTime);
-
-            // Check if we've reached the target
-            if ((fadeSpeeds[it->first] > 0 && newVolume >= it->second) ||
-                (fadeSpeeds[it->first] < 0 && newVolume <= it->second)) {
-                newVolume = it->second;
-                musicVolumes[it->first] = newVolume;  // Update tracked volume
-                SetMusicVolume(musicIt->second, calculateEffectiveVolume(newVolume));
-                it = fadeTargets.erase(it);
-            } else {
-                musicVolumes[it->first] = newVolume;  // Update tracked volume
-                SetMusicVolume(musicIt->second, calculateEffectiveVolume(newVolume));
-                ++it;
-            }
-        } else {
-            it = fadeTargets.erase(it);
+void AudioManager::update([[maybe_unused]] float deltaTime) {
+    // Refill the streams that are playing; fades run on the audio thread
+    for (size_t i = playingCount; i-- > 0;) {
+        TrackStream& stream = tracks[static_cast<size_t>(playingTracks[i])];
+        UpdateMusicStream(stream.music);
+        if (!IsMusicStreamPlaying(stream.music)) {
+            closeTrack(playingTracks[i]);  // A track that doesn't loop has ended
         }
     }
 }
 
 void AudioManager::updateVolumes() {
     // Update all currently playing sounds
-    for (auto& pair : soundEffects) {
-        float effectiveVolume = calculateEffectiveVolume(settings.sfxVolume);
-        SetSoundVolume(pair.second, effectiveVolume);
+    float effectiveVolume = calculateEffectiveVolume(settings.sfxVolume);
+    for (const Voice& voice : voices) {
+        if (voice.active) {
+            SetSoundVolume(effects[static_cast<size_t>(voice.effect)].sounds[voice.sound], effectiveVolume);
+        }
     }
 
-    // Update all music tracks and track their volumes
-    for (auto& pair : musicTracks) {
-        float effectiveVolume = calculateEffectiveVolume(settings.musicVolume);
-        SetMusicVolume(pair.second, effectiveVolume);
-        musicVolumes[pair.first] = effectiveVolume;  // Update tracked volume
+    // Music ramps to the new level, finishing any fade on its original schedule
+    double now = GetTime();
+    for (size_t i = 0; i < playingCount; ++i) {
+        const TrackStream& stream = tracks[static_cast<size_t>(playingTracks[i])];
+        float ramp = std::max(VOLUME_RAMP_SECONDS, static_cast<float>(stream.fadeEndTime - now));
+        publishTrackGain(playingTracks[i], ramp);
     }
 }
 
 bool AudioManager::isSoundLoaded(SoundEffect effect) {
-    return soundEffects.find(effect) != soundEffects.end();
+    return effects[static_cast<size_t>(effect)].soundCount > 0;
 }
 
 bool AudioManager::isMusicLoaded(MusicTrack track) {
-    return musicTracks.find(track) != musicTracks.end();
+    return !tracks[static_cast<size_t>(track)].path.empty();
 }
 
 float AudioManager::calculateEffectiveVolume(float baseVolume) const {
@@ -3,7 +3,8 @@
 #define UI_AUDIO_H
 
 #include "raylib.h"
-#include <unordered_map>
+#include <array>
+#include <cstdint>
 #include <string>
 #include <memory>
 
@@ -23,7 +24,16 @@ enum class SoundEffect {
     UI_NOTIFICATION,    // General notifications
     UI_ITEM_PICKUP,     // Item acquisition
     UI_INVENTORY_FULL,  // Inventory full warning
-    UI_QUEST_UPDATE     // Quest progress updates
+    UI_QUEST_UPDATE,    // Quest progress updates
+    SOUND_EFFECT_COUNT
+};
+
+// Voice budgets are per category; a full category steals from its own lower priorities
+enum class SoundCategory : uint8_t {
+    INTERFACE,          // Clicks, hovers, menus opening and closing
+    FEEDBACK,           // Pickups, quest updates, notifications
+    ALERT,              // Errors and warnings
+    SOUND_CATEGORY_COUNT
 };
 
 enum class MusicTrack {
@@ -31,7 +41,8 @@ enum class MusicTrack {
     GAME_AMBIENT,       // In-game ambient music
     COMBAT,             // Combat music
     VICTORY,            // Victory/achievement music
-    DEFEAT              // Defeat music
+    DEFEAT,             // Defeat music
+    MUSIC_TRACK_COUNT
 };
 
 struct AudioSettings {
@@ -42,8 +53,24 @@ struct AudioSettings {
     bool musicEnabled = true;
 };
 
+/// \brief UI sound effects and streamed music.
+///
+/// Each loaded effect owns a few raylib sound aliases sharing its samples, so one effect
+/// can overlap itself. Playing voices are drawn from a fixed pool of MAX_VOICES with a
+/// limit per SoundCategory; when a category is full the oldest voice of the lowest
+/// priority is stolen, or the new sound is dropped if everything playing outranks it.
+///
+/// Music tracks are only registered up front. A track opens its file stream when played
+/// and closes it when stopped, with MUSIC_BUFFER_FRAMES of decoded audio in flight.
+/// Track volume, fades and settings changes are ramped per sample by a processor on the
+/// stream, on the audio thread, so update() only refills the tracks that are playing.
 class AudioManager {
 public:
+    static constexpr size_t MAX_VOICES = 12;
+    static constexpr size_t MAX_VOICES_PER_EFFECT = 4;
+    static constexpr unsigned int MUSIC_BUFFER_FRAMES = 4096;
+    static constexpr float VOLUME_RAMP_SECONDS = 0.02f;   // Settings changes ramp over this to avoid clicks
+
     static AudioManager& getInstance() {
         static AudioManager instance;
         return instance;
@@ -59,9 +86,11 @@ public:
     void stopAllSounds();
 
     // Music management
+    /// \brief Registers a track's file; it is opened and streamed only while playing.
     void loadMusicTrack(MusicTrack track, const std::string& filePath);
     void playMusicTrack(MusicTrack track, bool loop = true);
     void stopMusicTrack(MusicTrack track);
+    /// \brief Ramps a track's volume, relative to the music volume setting, to `targetVolume`.
     void fadeMusicTrack(MusicTrack track, float targetVolume, float duration);
     void stopAllMusic();
 
@@ -84,6 +113,7 @@ public:
     float getMasterVolume() const { return settings.masterVolume; }
     float getSFXVolume() const { return settings.sfxVolume; }
     float getMusicVolume() const { return settings.musicVolume; }
+    size_t getActiveVoiceCount() const;
 
 private:
     AudioManager() = default;
@@ -91,13 +121,42 @@ private:
     AudioManager(const AudioManager&) = delete;
     AudioManager& operator=(const AudioManager&) = delete;
 
+    struct EffectBank {
+        std::array<Sound, MAX_VOICES_PER_EFFECT> sounds{};  // [0] owns the samples, the rest alias it
+        uint8_t soundCount = 0;                             // 0 while not loaded
+    };
+
+    struct Voice {
+        SoundEffect effect = SoundEffect::UI_CLICK;
+        uint8_t sound = 0;          // Index into the effect's sounds
+        uint8_t priority = 0;
+        SoundCategory category = SoundCategory::INTERFACE;
+        uint32_t sequence = 0;      // Start order, for stealing the oldest
+        bool active = false;
+    };
+
+    struct TrackStream {
+        std::string path;
+        Music music{};
+        bool open = false;
+        float volume = 1.0f;        // Fade level, relative to the music setting
+        double fadeEndTime = 0.0;
+    };
+
+    Voice* acquireVoice(SoundEffect effect);
+    void reapVoices();
+    void closeTrack(MusicTrack track);
+    void publishTrackGain(MusicTrack track, float rampSeconds);
+
     AudioSettings settings;
 
-    std::unordered_map<SoundEffect, Sound> soundEffects;
-    std::unordered_map<MusicTrack, Music> musicTracks;
-    std::unordered_map<MusicTrack, float> musicVolumes;  // Track current music volumes
-    std::unordered_map<MusicTrack, float> fadeTargets;
-    std::unordered_map<MusicTrack, float> fadeSpeeds;
+    std::array<EffectBank, static_cast<size_t>(SoundEffect::SOUND_EFFECT_COUNT)> effects;
+    std::array<Voice, MAX_VOICES> voices;
+    uint32_t voiceSequence = 0;
+
+    std::array<TrackStream, static_cast<size_t>(MusicTrack::MUSIC_TRACK_COUNT)> tracks;
+    std::array<MusicTrack, static_cast<size_t>(MusicTrack::MUSIC_TRACK_COUNT)> playingTracks{};
+    size_t playingCount = 0;
 
     // Internal volume calculations
     float calculateEffectiveVolume(float baseVolume) const;
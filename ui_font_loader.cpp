@@ -0,0 +1,190 @@
+// ui_font_loader.cpp
+#include "ui_font_loader.h"
+#include "profiler.h"
+#include "rlgl.h"
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+// Turns the distance stored in the atlas alpha into coverage, with the edge softened across
+// one screen pixel whatever the scale
+const char* SDF_FS = R"(
+#version 330
+in vec2 fragTexCoord;
+in vec4 fragColor;
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+out vec4 finalColor;
+void main() {
+    float distance = texture(texture0, fragTexCoord).a - 0.5;
+    float width = length(vec2(dFdx(distance), dFdy(distance)));
+    float alpha = smoothstep(-width, width, distance);
+    finalColor = vec4(fragColor.rgb, fragColor.a * alpha) * colDiffuse;
+}
+)";
+
+}  // namespace
+
+FontLoader::~FontLoader() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        running_ = false;
+    }
+    queue_cv_.notify_all();
+    if (loader_thread_.joinable()) {
+        loader_thread_.join();
+    }
+    // Atlases the main thread never took; CPU memory only
+    for (size_t i = upload_cursor_; i < uploading_.size(); ++i) {
+        discard(uploading_[i]);
+    }
+    for (Rasterized& done : completed_) {
+        discard(done);
+    }
+}
+
+void FontLoader::request(const std::string& path) {
+    Entry& entry = fonts_[path];
+    if (entry.state != State::NONE) return;
+    entry.state = State::LOADING;
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        load_queue_.push(path);
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        if (!running_) {
+            running_ = true;
+            loader_thread_ = std::thread(&FontLoader::loaderLoop, this);
+        }
+    }
+    queue_cv_.notify_one();
+}
+
+const Font* FontLoader::find(const std::string& path) const {
+    auto it = fonts_.find(path);
+    return it != fonts_.end() && it->second.state == State::READY ? &it->second.font : nullptr;
+}
+
+FontLoader::State FontLoader::getState(const std::string& path) const {
+    auto it = fonts_.find(path);
+    return it != fonts_.end() ? it->second.state : State::NONE;
+}
+
+int FontLoader::processUploads(float budgetMs) {
+    if (upload_cursor_ >= uploading_.size()) {
+        // Only lock to swap buffers; the worker never waits on uploads
+        uploading_.clear();
+        upload_cursor_ = 0;
+        std::lock_guard<std::mutex> lock(completed_mutex_);
+        if (completed_.empty()) return 0;
+        uploading_.swap(completed_);
+    }
+
+    if (shader_.id == 0) {
+        shader_ = LoadShaderFromMemory(nullptr, SDF_FS);
+        if (shader_.id == rlGetShaderIdDefault()) {
+            std::cout << "FONT LOADER: Distance-field shader unavailable, theme fonts disabled" << std::endl;
+        }
+    }
+    bool shaderReady = shader_.id != rlGetShaderIdDefault();
+
+    auto start = std::chrono::steady_clock::now();
+    auto budget = std::chrono::duration<float, std::milli>(budgetMs);
+    int uploaded = 0;
+    while (upload_cursor_ < uploading_.size()) {
+        Rasterized& done = uploading_[upload_cursor_++];
+        Entry& entry = fonts_[done.path];
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+
+        if (shaderReady && done.atlas.data != nullptr) {
+            done.font.texture = LoadTextureFromImage(done.atlas);
+        }
+        if (done.font.texture.id == 0) {
+            discard(done);
+            entry.state = State::FAILED;
+        } else {
+            // Bilinear sampling interpolates the distance field, which is what keeps edges smooth
+            SetTextureFilter(done.font.texture, TEXTURE_FILTER_BILINEAR);
+            UnloadImage(done.atlas);
+            entry.font = done.font;
+            entry.state = State::READY;
+            ++uploaded;
+        }
+
+        // Always upload at least one so a tight budget still makes progress
+        if (std::chrono::steady_clock::now() - start >= budget) break;
+    }
+    return uploaded;
+}
+
+void FontLoader::unloadAll() {
+    for (auto& [path, entry] : fonts_) {
+        if (entry.state == State::READY) {
+            UnloadFont(entry.font);
+            entry.font = Font{};
+            entry.state = State::NONE;
+        }
+    }
+    if (shader_.id != 0 && shader_.id != rlGetShaderIdDefault()) {
+        UnloadShader(shader_);
+    }
+    shader_ = Shader{};
+}
+
+void FontLoader::loaderLoop() {
+    Profiler::getInstance().setThreadName("Font Loader");
+    while (true) {
+        std::string path;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return !running_ || !load_queue_.empty(); });
+            if (!running_) return;
+            path = std::move(load_queue_.front());
+            load_queue_.pop();
+        }
+
+        Rasterized result;
+        result.path = path;
+        if (!rasterize(path, result)) {
+            std::cout << "FONT LOADER: Failed to load " << path << ", using the default font" << std::endl;
+        }
+
+        // Failures are handed over too, so the main thread marks them and stops asking
+        std::lock_guard<std::mutex> lock(completed_mutex_);
+        completed_.push_back(std::move(result));
+    }
+}
+
+bool FontLoader::rasterize(const std::string& path, Rasterized& out) {
+    int dataSize = 0;
+    unsigned char* data = LoadFileData(path.c_str(), &dataSize);
+    if (data == nullptr) return false;
+
+    Font& font = out.font;
+    font.baseSize = UIConstants::FONT_SDF_BASE_SIZE;
+    font.glyphCount = UIConstants::FONT_GLYPH_COUNT;
+    font.glyphPadding = 0;  // The SDF bitmaps already carry their own falloff margin
+    font.glyphs = LoadFontData(data, dataSize, font.baseSize, nullptr, font.glyphCount, FONT_SDF);
+    UnloadFileData(data);
+    if (font.glyphs == nullptr) {
+        font = Font{};
+        return false;
+    }
+
+    // Skyline packing; the atlas stays on the CPU until the main thread uploads it
+    out.atlas = GenImageFontAtlas(font.glyphs, &font.recs, font.glyphCount, font.baseSize, font.glyphPadding, 1);
+    if (out.atlas.data == nullptr) {
+        discard(out);
+        return false;
+    }
+    return true;
+}
+
+void FontLoader::discard(Rasterized& done) {
+    UnloadImage(done.atlas);
+    UnloadFontData(done.font.glyphs, done.font.glyphCount);
+    MemFree(done.font.recs);
+    done.atlas = Image{};
+    done.font = Font{};
+}
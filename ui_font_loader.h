@@ -0,0 +1,91 @@
+// ui_font_loader.h - Background font rasterization with budgeted GPU uploads
+#ifndef UI_FONT_LOADER_H
+#define UI_FONT_LOADER_H
+
+#include "raylib.h"
+#include "constants.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/// \brief Loads theme fonts as signed-distance-field atlases without stalling the frame.
+///
+/// A worker thread reads the font file, rasterizes the glyphs as SDF bitmaps and packs
+/// the atlas image; the main thread only uploads finished atlases, within a per-frame
+/// time budget. An SDF atlas stays sharp when scaled, so each file is rasterized once at
+/// UIConstants::FONT_SDF_BASE_SIZE and serves every text size and DPI scale. SDF fonts
+/// must be drawn inside BeginShaderMode(getShader()).
+class FontLoader {
+public:
+    enum class State : uint8_t { NONE, LOADING, READY, FAILED };
+
+    FontLoader() = default;
+    ~FontLoader();
+
+    FontLoader(const FontLoader&) = delete;
+    FontLoader& operator=(const FontLoader&) = delete;
+
+    /// \brief Queues a font file for loading; starts the worker on first use. Repeats are ignored.
+    /// \param path Font file path.
+    void request(const std::string& path);
+
+    /// \brief Gets a loaded font, or null while it is loading, failed or was never requested.
+    const Font* find(const std::string& path) const;
+
+    State getState(const std::string& path) const;
+
+    /// \brief Uploads finished atlases until the time budget runs out; the rest wait a frame.
+    /// Needs the GL context. \return Number of fonts that became ready.
+    int processUploads(float budgetMs = UIConstants::FONT_UPLOAD_BUDGET_MS);
+
+    /// \brief Distance-field shader for drawing loaded fonts. Valid once any font is ready.
+    const Shader& getShader() const { return shader_; }
+
+    /// \brief Unloads every font and the shader. Needs the GL context.
+    void unloadAll();
+
+    /// \brief Gets fonts requested but not yet uploaded.
+    size_t getPendingCount() const { return pending_.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        State state = State::NONE;
+        Font font{};
+    };
+
+    // Worker output: glyph data and the packed atlas, still on the CPU
+    struct Rasterized {
+        std::string path;
+        Font font{};
+        Image atlas{};
+    };
+
+    void loaderLoop();
+    static bool rasterize(const std::string& path, Rasterized& out);
+    /// \brief Frees a rasterized font that won't be uploaded.
+    static void discard(Rasterized& done);
+
+    std::unordered_map<std::string, Entry> fonts_;  // Main thread only
+    Shader shader_{};
+
+    std::queue<std::string> load_queue_;
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+
+    std::vector<Rasterized> completed_;      // Filled by the worker under completed_mutex_
+    std::mutex completed_mutex_;
+    std::vector<Rasterized> uploading_;      // Main-thread only; swapped with completed_
+    size_t upload_cursor_ = 0;
+
+    std::thread loader_thread_;
+    bool running_ = false;                   // Guarded by queue_mutex_
+    std::atomic<size_t> pending_{0};
+};
+
+#endif // UI_FONT_LOADER_H
@@ -0,0 +1,583 @@
+// ui_layout.cpp - Measure/arrange layout passes with per-node caching
+#include "ui_layout.h"
+#include <algorithm>
+#include <cmath>
+
+namespace UILayout {
+
+namespace {
+
+bool sameRect(const Rectangle& a, const Rectangle& b) {
+    return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+
+float nonNegative(float value) {
+    return value > 0.0f ? value : 0.0f;
+}
+
+bool isResolvedUpFront(SizeConstraint type) {
+    return type == SizeConstraint::FIXED || type == SizeConstraint::PERCENTAGE;
+}
+
+float resolveAxis(SizeConstraint type, float value, float available, float content) {
+    switch (type) {
+        case SizeConstraint::FIXED: return value;
+        case SizeConstraint::PERCENTAGE: return available * value / 100.0f;
+        default: return content;  // AUTO, MIN_CONTENT, MAX_CONTENT
+    }
+}
+
+// Places a child of `size` along one axis of [start, start + extent), margins inside the extent.
+// Centered positions are floored so panels stay on whole pixels.
+void alignAxis(Alignment align, float start, float extent, float size, float margin, float& outPos, float& outSize) {
+    float inner = nonNegative(extent - 2.0f * margin);
+    if (align == Alignment::STRETCH) {
+        outPos = start + margin;
+        outSize = inner;
+        return;
+    }
+    float freeSpace = inner - size;
+    outSize = size;
+    switch (align) {
+        case Alignment::CENTER: outPos = start + margin + std::floor(freeSpace * 0.5f); break;
+        case Alignment::END: outPos = start + margin + freeSpace; break;
+        default: outPos = start + margin; break;  // START; SPACE_* only apply along a flex axis
+    }
+}
+
+void markTreeDirty(LayoutNode& node) {
+    node.markDirty();
+    for (const auto& child : node.getChildren()) {
+        markTreeDirty(*child);
+    }
+}
+
+void applyDebugColor(LayoutNode& node, Color color) {
+    node.setDebugColor(color);
+    for (const auto& child : node.getChildren()) {
+        applyDebugColor(*child, color);
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// LAYOUT NODE
+// ============================================================================
+
+LayoutNode::LayoutNode(const std::string& id, LayoutType type) : id_(id), layoutType_(type) {}
+
+void LayoutNode::addChild(std::shared_ptr<LayoutNode> child) {
+    if (!child || child.get() == this) return;
+    if (child->parent_) {
+        auto& siblings = child->parent_->children_;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), child), siblings.end());
+        child->parent_->markDirty();
+    }
+    child->parent_ = this;
+    LayoutNode* added = child.get();
+    children_.push_back(std::move(child));
+    added->markDirty();
+}
+
+void LayoutNode::removeChild(const std::string& childId) {
+    auto it = std::find_if(children_.begin(), children_.end(),
+                           [&childId](const std::shared_ptr<LayoutNode>& child) { return child->id_ == childId; });
+    if (it == children_.end()) return;
+    (*it)->parent_ = nullptr;
+    children_.erase(it);
+    markDirty();
+}
+
+std::shared_ptr<LayoutNode> LayoutNode::findChild(const std::string& id) const {
+    for (const auto& child : children_) {
+        if (child->id_ == id) return child;
+        if (auto found = child->findChild(id)) return found;
+    }
+    return nullptr;
+}
+
+void LayoutNode::markDirty() {
+    for (LayoutNode* node = this; node; node = node->parent_) {
+        // A dirty node's ancestors are already dirty
+        if (node != this && node->measureDirty_ && node->arrangeDirty_) break;
+        node->measureDirty_ = true;
+        node->arrangeDirty_ = true;
+    }
+}
+
+void LayoutNode::computeLayout(float parentWidth, float parentHeight) {
+    measure(parentWidth, parentHeight);
+    arrange({0.0f, 0.0f, parentWidth, parentHeight});
+}
+
+Vector2 LayoutNode::measure(float availableWidth, float availableHeight) {
+    if (!measureDirty_ && measuredAvailable_.x == availableWidth && measuredAvailable_.y == availableHeight) {
+        return desiredSize_;
+    }
+
+    const LayoutConstraint& c = constraints_;
+
+    // Children get the node's own size when it's known up front, otherwise what the parent offered
+    float innerWidth = isResolvedUpFront(c.widthType) ? resolveAxis(c.widthType, c.widthValue, availableWidth, 0.0f)
+                                                      : availableWidth;
+    float innerHeight = isResolvedUpFront(c.heightType) ? resolveAxis(c.heightType, c.heightValue, availableHeight, 0.0f)
+                                                        : availableHeight;
+    Vector2 childExtent = measureChildren(nonNegative(innerWidth - 2.0f * padding_),
+                                          nonNegative(innerHeight - 2.0f * padding_));
+    Vector2 ownContent = measureContent();
+    float contentWidth = std::max(childExtent.x, ownContent.x) + 2.0f * padding_;
+    float contentHeight = std::max(childExtent.y, ownContent.y) + 2.0f * padding_;
+
+    float width = resolveAxis(c.widthType, c.widthValue, availableWidth, contentWidth);
+    float height = resolveAxis(c.heightType, c.heightValue, availableHeight, contentHeight);
+    if (c.aspectRatio > 0.0f) {
+        if (isResolvedUpFront(c.widthType) && !isResolvedUpFront(c.heightType)) {
+            height = width / c.aspectRatio;
+        } else if (isResolvedUpFront(c.heightType) && !isResolvedUpFront(c.widthType)) {
+            width = height * c.aspectRatio;
+        }
+    }
+
+    desiredSize_ = {std::min(std::max(width, c.minWidth), c.maxWidth),
+                    std::min(std::max(height, c.minHeight), c.maxHeight)};
+    measuredAvailable_ = {availableWidth, availableHeight};
+    measureDirty_ = false;
+    return desiredSize_;
+}
+
+Vector2 LayoutNode::measureChildren(float availableWidth, float availableHeight) {
+    if (children_.empty()) return {0.0f, 0.0f};
+
+    Vector2 extent = {0.0f, 0.0f};
+    switch (layoutType_) {
+        case LayoutType::FLEX_VERTICAL:
+        case LayoutType::FLEX_HORIZONTAL:
+            for (const auto& child : children_) {
+                float margins = 2.0f * child->margin_;
+                child->measure(nonNegative(availableWidth - margins), nonNegative(availableHeight - margins));
+            }
+            return calculateFlexSize(children_, layoutType_, spacing_);
+
+        case LayoutType::GRID: {
+            size_t columns = static_cast<size_t>(gridColumns_);
+            float cellWidth = nonNegative((availableWidth - spacing_ * (columns - 1)) / columns);
+            float widestCell = 0.0f;
+            for (size_t start = 0; start < children_.size(); start += columns) {
+                float rowHeight = 0.0f;
+                for (size_t i = start; i < std::min(start + columns, children_.size()); ++i) {
+                    float margins = 2.0f * children_[i]->margin_;
+                    Vector2 size = children_[i]->measure(nonNegative(cellWidth - margins), nonNegative(availableHeight - margins));
+                    widestCell = std::max(widestCell, size.x + margins);
+                    rowHeight = std::max(rowHeight, size.y + margins);
+                }
+                extent.y += rowHeight + (start > 0 ? spacing_ : 0.0f);
+            }
+            size_t usedColumns = std::min(columns, children_.size());
+            extent.x = widestCell * usedColumns + spacing_ * (usedColumns - 1);
+            return extent;
+        }
+
+        case LayoutType::ABSOLUTE:
+            for (const auto& child : children_) {
+                float margins = 2.0f * child->margin_;
+                Vector2 size = child->measure(nonNegative(availableWidth - child->offset_.x - margins),
+                                              nonNegative(availableHeight - child->offset_.y - margins));
+                extent.x = std::max(extent.x, child->offset_.x + size.x + margins);
+                extent.y = std::max(extent.y, child->offset_.y + size.y + margins);
+            }
+            return extent;
+
+        default:  // RELATIVE, STACK
+            for (const auto& child : children_) {
+                float margins = 2.0f * child->margin_;
+                Vector2 size = child->measure(nonNegative(availableWidth - margins), nonNegative(availableHeight - margins));
+                extent.x = std::max(extent.x, size.x + margins);
+                extent.y = std::max(extent.y, size.y + margins);
+            }
+            return extent;
+    }
+}
+
+void LayoutNode::arrange(const Rectangle& bounds) {
+    if (!arrangeDirty_ && sameRect(bounds, bounds_)) return;
+
+    Rectangle previous = bounds_;
+    bounds_ = bounds;
+
+    // Re-measure children against the real content box; unchanged ones answer from cache
+    Rectangle content = contentBox();
+    measureChildren(content.width, content.height);
+
+    switch (layoutType_) {
+        case LayoutType::ABSOLUTE: computeAbsoluteLayout(); break;
+        case LayoutType::FLEX_VERTICAL: computeFlexVerticalLayout(); break;
+        case LayoutType::FLEX_HORIZONTAL: computeFlexHorizontalLayout(); break;
+        case LayoutType::GRID: computeGridLayout(); break;
+        default: computeRelativeLayout(); break;  // RELATIVE, STACK
+    }
+    arrangeDirty_ = false;
+
+    if (previous.width != bounds_.width || previous.height != bounds_.height) onSizeChanged();
+    if (previous.x != bounds_.x || previous.y != bounds_.y) onPositionChanged();
+    onLayoutChanged();
+}
+
+Rectangle LayoutNode::contentBox() const {
+    return {bounds_.x + padding_, bounds_.y + padding_,
+            nonNegative(bounds_.width - 2.0f * padding_), nonNegative(bounds_.height - 2.0f * padding_)};
+}
+
+void LayoutNode::computeAbsoluteLayout() {
+    Rectangle content = contentBox();
+    for (const auto& child : children_) {
+        Vector2 size = child->desiredSize_;
+        child->arrange({content.x + child->offset_.x + child->margin_, content.y + child->offset_.y + child->margin_,
+                        size.x, size.y});
+    }
+}
+
+void LayoutNode::computeRelativeLayout() {
+    Rectangle content = contentBox();
+    for (const auto& child : children_) {
+        Rectangle rect;
+        alignAxis(child->horizontalAlignment_, content.x, content.width, child->desiredSize_.x, child->margin_,
+                  rect.x, rect.width);
+        alignAxis(child->verticalAlignment_, content.y, content.height, child->desiredSize_.y, child->margin_,
+                  rect.y, rect.height);
+        child->arrange(rect);
+    }
+}
+
+void LayoutNode::computeFlexVerticalLayout() {
+    computeFlexLayout(true);
+}
+
+void LayoutNode::computeFlexHorizontalLayout() {
+    computeFlexLayout(false);
+}
+
+void LayoutNode::computeFlexLayout(bool vertical) {
+    if (children_.empty()) return;
+
+    Rectangle content = contentBox();
+    size_t count = children_.size();
+    Vector2 total = calculateFlexSize(children_, vertical ? LayoutType::FLEX_VERTICAL : LayoutType::FLEX_HORIZONTAL, spacing_);
+    float freeSpace = nonNegative(vertical ? content.height - total.y : content.width - total.x);
+
+    // The node's own alignment on the main axis justifies the items
+    float cursor = 0.0f;
+    float gap = spacing_;
+    switch (vertical ? verticalAlignment_ : horizontalAlignment_) {
+        case Alignment::CENTER: cursor = std::floor(freeSpace * 0.5f); break;
+        case Alignment::END: cursor = freeSpace; break;
+        case Alignment::SPACE_BETWEEN: if (count > 1) gap += freeSpace / (count - 1); break;
+        case Alignment::SPACE_AROUND: gap += freeSpace / count; cursor = freeSpace / count * 0.5f; break;
+        case Alignment::SPACE_EVENLY: gap += freeSpace / (count + 1); cursor = freeSpace / (count + 1); break;
+        default: break;
+    }
+
+    float position = (vertical ? content.y : content.x) + cursor;
+    for (const auto& child : children_) {
+        float margin = child->margin_;
+        Vector2 size = child->desiredSize_;
+        Rectangle rect;
+        if (vertical) {
+            alignAxis(child->horizontalAlignment_, content.x, content.width, size.x, margin, rect.x, rect.width);
+            rect.y = position + margin;
+            rect.height = size.y;
+            position += size.y + 2.0f * margin + gap;
+        } else {
+            alignAxis(child->verticalAlignment_, content.y, content.height, size.y, margin, rect.y, rect.height);
+            rect.x = position + margin;
+            rect.width = size.x;
+            position += size.x + 2.0f * margin + gap;
+        }
+        child->arrange(rect);
+    }
+}
+
+void LayoutNode::computeGridLayout() {
+    Rectangle content = contentBox();
+    size_t columns = static_cast<size_t>(gridColumns_);
+    float cellWidth = nonNegative((content.width - spacing_ * (columns - 1)) / columns);
+
+    float rowY = content.y;
+    for (size_t start = 0; start < children_.size(); start += columns) {
+        size_t end = std::min(start + columns, children_.size());
+        float rowHeight = 0.0f;
+        for (size_t i = start; i < end; ++i) {
+            rowHeight = std::max(rowHeight, children_[i]->desiredSize_.y + 2.0f * children_[i]->margin_);
+        }
+        for (size_t i = start; i < end; ++i) {
+            LayoutNode& child = *children_[i];
+            float cellX = content.x + (i - start) * (cellWidth + spacing_);
+            Rectangle rect;
+            alignAxis(child.horizontalAlignment_, cellX, cellWidth, child.desiredSize_.x, child.margin_, rect.x, rect.width);
+            alignAxis(child.verticalAlignment_, rowY, rowHeight, child.desiredSize_.y, child.margin_, rect.y, rect.height);
+            child.arrange(rect);
+        }
+        rowY += rowHeight + spacing_;
+    }
+}
+
+void LayoutNode::debugRender() const {
+    DrawRectangleLinesEx(bounds_, 1.0f, debugColor_);
+    for (const auto& child : children_) {
+        child->debugRender();
+    }
+}
+
+// ============================================================================
+// LAYOUT MANAGER
+// ============================================================================
+
+LayoutManager::LayoutManager() {
+    updateBreakpoint();
+}
+
+LayoutManager::~LayoutManager() = default;
+
+void LayoutManager::setScreenSize(int width, int height) {
+    // Resized subtrees are found by the passes' own cache keys; nothing needs marking here
+    screenSize_ = {static_cast<float>(width), static_cast<float>(height)};
+    updateBreakpoint();
+}
+
+void LayoutManager::setRootLayout(std::shared_ptr<LayoutNode> root) {
+    rootLayout_ = std::move(root);
+    laidOutScreen_ = {0, 0};
+}
+
+std::shared_ptr<LayoutNode> LayoutManager::createNode(const std::string& id, LayoutType type) {
+    auto node = std::make_shared<LayoutNode>(id, type);
+    if (!id.empty()) {
+        nodeRegistry_[id] = node;
+    }
+    return node;
+}
+
+std::shared_ptr<LayoutNode> LayoutManager::findNode(const std::string& id) const {
+    auto it = nodeRegistry_.find(id);
+    if (it != nodeRegistry_.end()) return it->second;
+    if (!rootLayout_) return nullptr;
+    return rootLayout_->getId() == id ? rootLayout_ : rootLayout_->findChild(id);
+}
+
+void LayoutManager::removeNode(const std::string& id) {
+    std::shared_ptr<LayoutNode> node = findNode(id);
+    if (!node) return;
+    if (node->getParent()) {
+        node->getParent()->removeChild(id);
+    }
+    if (node == rootLayout_) {
+        rootLayout_.reset();
+    }
+    nodeRegistry_.erase(id);
+}
+
+void LayoutManager::recomputeLayout() {
+    if (!rootLayout_) return;
+    markTreeDirty(*rootLayout_);
+    updateLayout();
+}
+
+void LayoutManager::updateLayout() {
+    if (!rootLayout_) return;
+    if (!rootLayout_->isDirty() && laidOutScreen_.x == screenSize_.x && laidOutScreen_.y == screenSize_.y) return;
+
+    rootLayout_->computeLayout(screenSize_.x, screenSize_.y);
+    laidOutScreen_ = screenSize_;
+    ++layoutPasses_;
+}
+
+void LayoutManager::clear() {
+    rootLayout_.reset();
+    nodeRegistry_.clear();
+    laidOutScreen_ = {0, 0};
+}
+
+LayoutManager::Breakpoint LayoutManager::getCurrentBreakpoint() const {
+    return currentBreakpoint_;
+}
+
+void LayoutManager::setBreakpoint(Breakpoint breakpoint) {
+    currentBreakpoint_ = breakpoint;  // Holds until the next resize
+}
+
+void LayoutManager::updateBreakpoint() {
+    currentBreakpoint_ = calculateBreakpoint(screenSize_.x);
+}
+
+LayoutManager::Breakpoint LayoutManager::calculateBreakpoint(float width) const {
+    if (width < 768.0f) return Breakpoint::MOBILE;
+    if (width < 1024.0f) return Breakpoint::TABLET;
+    if (width <= 1440.0f) return Breakpoint::DESKTOP;
+    return Breakpoint::WIDESCREEN;
+}
+
+Rectangle LayoutManager::scaleRectForDPI(const Rectangle& rect) const {
+    return {rect.x * dpiScale_, rect.y * dpiScale_, rect.width * dpiScale_, rect.height * dpiScale_};
+}
+
+Vector2 LayoutManager::scaleVecForDPI(const Vector2& vec) const {
+    return {vec.x * dpiScale_, vec.y * dpiScale_};
+}
+
+float LayoutManager::scaleValueForDPI(float value) const {
+    return value * dpiScale_;
+}
+
+void LayoutManager::applyThemeToLayout(std::shared_ptr<LayoutNode> node,
+                                       [[maybe_unused]] UITypes::ColorRole backgroundColor,
+                                       UITypes::ColorRole borderColor) {
+    // Nodes only draw their debug outline; panels paint their own backgrounds
+    if (node) {
+        applyDebugColor(*node, UITypes::GetThemeColor(borderColor));
+    }
+}
+
+void LayoutManager::renderDebugLayout() const {
+    if (debugRendering_ && rootLayout_) {
+        rootLayout_->debugRender();
+    }
+}
+
+// ============================================================================
+// LAYOUT CONSTRAINTS AND UTILITIES
+// ============================================================================
+
+LayoutConstraint makeFixedConstraint(float width, float height) {
+    LayoutConstraint constraint;
+    constraint.widthType = SizeConstraint::FIXED;
+    constraint.heightType = SizeConstraint::FIXED;
+    constraint.widthValue = width;
+    constraint.heightValue = height;
+    return constraint;
+}
+
+LayoutConstraint makePercentageConstraint(float widthPercent, float heightPercent) {
+    LayoutConstraint constraint;
+    constraint.widthType = SizeConstraint::PERCENTAGE;
+    constraint.heightType = SizeConstraint::PERCENTAGE;
+    constraint.widthValue = widthPercent;
+    constraint.heightValue = heightPercent;
+    return constraint;
+}
+
+LayoutConstraint makeAutoConstraint() {
+    return LayoutConstraint{};
+}
+
+LayoutConstraint makeMinMaxConstraint(float minWidth, float maxWidth, float minHeight, float maxHeight) {
+    LayoutConstraint constraint;
+    constraint.minWidth = minWidth;
+    constraint.maxWidth = maxWidth;
+    constraint.minHeight = minHeight;
+    constraint.maxHeight = maxHeight;
+    return constraint;
+}
+
+Vector2 calculateFlexSize(const std::vector<std::shared_ptr<LayoutNode>>& children, LayoutType layoutType, float spacing) {
+    Vector2 size = {0.0f, 0.0f};
+    bool vertical = layoutType == LayoutType::FLEX_VERTICAL;
+    for (const auto& child : children) {
+        Vector2 desired = child->getDesiredSize();
+        float margins = 2.0f * child->getMargin();
+        if (vertical) {
+            size.x = std::max(size.x, desired.x + margins);
+            size.y += desired.y + margins;
+        } else {
+            size.x += desired.x + margins;
+            size.y = std::max(size.y, desired.y + margins);
+        }
+    }
+    if (children.size() > 1) {
+        (vertical ? size.y : size.x) += spacing * (children.size() - 1);
+    }
+    return size;
+}
+
+bool isMobileLayout() {
+    return LayoutManager::getInstance().getCurrentBreakpoint() == LayoutManager::Breakpoint::MOBILE;
+}
+
+bool isTabletLayout() {
+    return LayoutManager::getInstance().getCurrentBreakpoint() == LayoutManager::Breakpoint::TABLET;
+}
+
+bool isDesktopLayout() {
+    return LayoutManager::getInstance().getCurrentBreakpoint() == LayoutManager::Breakpoint::DESKTOP;
+}
+
+bool isWideScreenLayout() {
+    return LayoutManager::getInstance().getCurrentBreakpoint() == LayoutManager::Breakpoint::WIDESCREEN;
+}
+
+// ============================================================================
+// CONVENIENCE FUNCTIONS
+// ============================================================================
+
+std::shared_ptr<LayoutNode> createPanel(const std::string& id, float width, float height) {
+    auto node = LayoutManager::getInstance().createNode(id, LayoutType::RELATIVE);
+    node->setConstraints(makeFixedConstraint(width, height));
+    return node;
+}
+
+std::shared_ptr<LayoutNode> createButton(const std::string& id, float width, float height) {
+    auto node = LayoutManager::getInstance().createNode(id, LayoutType::RELATIVE);
+    node->setConstraints(makeFixedConstraint(width, height));
+    return node;
+}
+
+std::shared_ptr<LayoutNode> createTextBox(const std::string& id, float width) {
+    auto node = LayoutManager::getInstance().createNode(id, LayoutType::RELATIVE);
+    LayoutConstraint constraint;
+    constraint.widthType = SizeConstraint::FIXED;
+    constraint.widthValue = width;
+    constraint.minHeight = UITypes::GetThemeSpacing(UITypes::SpacingRole::LG);  // One line of body text
+    node->setConstraints(constraint);
+    return node;
+}
+
+std::shared_ptr<LayoutNode> createProgressBar(const std::string& id, float width, float height) {
+    auto node = LayoutManager::getInstance().createNode(id, LayoutType::RELATIVE);
+    node->setConstraints(makeFixedConstraint(width, height));
+    return node;
+}
+
+void addChildToLayout(const std::string& parentId, std::shared_ptr<LayoutNode> child) {
+    if (auto parent = LayoutManager::getInstance().findNode(parentId)) {
+        parent->addChild(std::move(child));
+    }
+}
+
+void removeChildFromLayout(const std::string& parentId, const std::string& childId) {
+    if (auto parent = LayoutManager::getInstance().findNode(parentId)) {
+        parent->removeChild(childId);
+    }
+}
+
+void updateLayoutConstraints(const std::string& nodeId, const LayoutConstraint& constraints) {
+    if (auto node = LayoutManager::getInstance().findNode(nodeId)) {
+        node->setConstraints(constraints);
+    }
+}
+
+Rectangle getSafeArea() {
+    // Desktop windows have no notches or cutouts
+    Vector2 screen = LayoutManager::getInstance().getScreenSize();
+    return {0.0f, 0.0f, screen.x, screen.y};
+}
+
+Rectangle getContentArea() {
+    Rectangle safe = getSafeArea();
+    float inset = UITypes::GetThemeSpacing(UITypes::SpacingRole::SM);
+    return {safe.x + inset, safe.y + inset, nonNegative(safe.width - 2.0f * inset), nonNegative(safe.height - 2.0f * inset)};
+}
+
+Vector2 getCenterPosition(const Rectangle& bounds) {
+    return {bounds.x + bounds.width * 0.5f, bounds.y + bounds.height * 0.5f};
+}
+
+} // namespace UILayout
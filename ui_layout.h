@@ -4,9 +4,11 @@
 
 #include "raylib.h"
 #include "ui_theme_optimized.h"
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <functional>
+#include <string>
 #include <unordered_map>
 
 namespace UILayout {
@@ -15,13 +17,14 @@ namespace UILayout {
 // CONSTRAINT-BASED LAYOUT SYSTEM
 // ============================================================================
 
+// How a node arranges its children inside its padded content box
 enum class LayoutType {
-    ABSOLUTE,       // Fixed positioning
-    RELATIVE,       // Relative to parent
-    FLEX_VERTICAL,  // Vertical flexbox
-    FLEX_HORIZONTAL,// Horizontal flexbox
-    GRID,          // CSS Grid-like
-    STACK          // Z-index stacking
+    ABSOLUTE,       // Fixed positioning: each child at its offset from the content origin
+    RELATIVE,       // Relative to parent: each child placed by its own alignment
+    FLEX_VERTICAL,  // Vertical flexbox: children top to bottom, justified by the node's vertical alignment
+    FLEX_HORIZONTAL,// Horizontal flexbox: children left to right, justified by the node's horizontal alignment
+    GRID,          // CSS Grid-like: fixed column count, equal-width columns, rows as tall as their tallest cell
+    STACK          // Z-index stacking: like RELATIVE, later children drawn over earlier ones
 };
 
 enum class Alignment {
@@ -38,8 +41,8 @@ enum class SizeConstraint {
     FIXED,          // Fixed size in pixels
     PERCENTAGE,     // Percentage of parent
     AUTO,          // Size to content
-    MIN_CONTENT,   // Minimum size based on content
-    MAX_CONTENT    // Maximum size based on content
+    MIN_CONTENT,   // Minimum size based on content (content size; nodes don't wrap)
+    MAX_CONTENT    // Maximum size based on content (content size; nodes don't wrap)
 };
 
 struct LayoutConstraint {
@@ -58,6 +61,14 @@ struct LayoutConstraint {
 // LAYOUT NODE HIERARCHY
 // ============================================================================
 
+/// \brief Node of a two-pass layout tree: measure() works out the size a node wants,
+/// arrange() gives it its final rectangle and places its children.
+///
+/// Both passes cache their result. A node is only re-measured when its available space
+/// changes or it was marked dirty, and only re-arranged when its rectangle changes or it
+/// was marked dirty, so a pass over an unchanged tree returns at the root. Setters that
+/// affect layout mark the node dirty, which also dirties its ancestors (their size may
+/// depend on it); clean siblings keep their cached layout.
 class LayoutNode {
 public:
     LayoutNode(const std::string& id = "", LayoutType type = LayoutType::RELATIVE);
@@ -69,29 +80,41 @@ public:
 
     // Layout properties
     LayoutType getLayoutType() const { return layoutType_; }
-    void setLayoutType(LayoutType type) { layoutType_ = type; }
+    void setLayoutType(LayoutType type) { layoutType_ = type; markDirty(); }
 
-    // Size and position
+    // Size and position. Bounds are the last arranged rectangle in screen coordinates.
     Rectangle getBounds() const { return bounds_; }
-    void setBounds(const Rectangle& bounds) { bounds_ = bounds; }
+    void setBounds(const Rectangle& bounds) { arrange(bounds); }
     Vector2 getPosition() const { return {bounds_.x, bounds_.y}; }
     Vector2 getSize() const { return {bounds_.width, bounds_.height}; }
 
     // Constraints
     LayoutConstraint getConstraints() const { return constraints_; }
-    void setConstraints(const LayoutConstraint& constraints) { constraints_ = constraints; }
+    void setConstraints(const LayoutConstraint& constraints) { constraints_ = constraints; markDirty(); }
 
     // Alignment
     Alignment getHorizontalAlignment() const { return horizontalAlignment_; }
-    void setHorizontalAlignment(Alignment align) { horizontalAlignment_ = align; }
+    void setHorizontalAlignment(Alignment align) { horizontalAlignment_ = align; markDirty(); }
     Alignment getVerticalAlignment() const { return verticalAlignment_; }
-    void setVerticalAlignment(Alignment align) { verticalAlignment_ = align; }
+    void setVerticalAlignment(Alignment align) { verticalAlignment_ = align; markDirty(); }
 
     // Padding and margins
     float getPadding() const { return padding_; }
-    void setPadding(float padding) { padding_ = padding; }
+    void setPadding(float padding) { padding_ = padding; markDirty(); }
     float getMargin() const { return margin_; }
-    void setMargin(float margin) { margin_ = margin; }
+    void setMargin(float margin) { margin_ = margin; markDirty(); }
+
+    // Gap between flex items and grid cells
+    float getSpacing() const { return spacing_; }
+    void setSpacing(float spacing) { spacing_ = spacing; markDirty(); }
+
+    // Position inside an ABSOLUTE parent's content box
+    Vector2 getOffset() const { return offset_; }
+    void setOffset(Vector2 offset) { offset_ = offset; markDirty(); }
+
+    // Column count of a GRID node
+    int getGridColumns() const { return gridColumns_; }
+    void setGridColumns(int columns) { gridColumns_ = columns > 0 ? columns : 1; markDirty(); }
 
     // Hierarchy management
     LayoutNode* getParent() const { return parent_; }
@@ -101,9 +124,21 @@ public:
     std::shared_ptr<LayoutNode> findChild(const std::string& id) const;
 
     // Layout computation
+    /// \brief Lays the node out as a root filling {0, 0, parentWidth, parentHeight}.
     virtual void computeLayout(float parentWidth, float parentHeight);
+    /// \brief Size the node wants inside the given space, margins excluded. Cached.
+    Vector2 measure(float availableWidth, float availableHeight);
+    /// \brief Gives the node its final rectangle and places its children. Cached.
+    void arrange(const Rectangle& bounds);
+    Vector2 getDesiredSize() const { return desiredSize_; }
+    /// \brief Own content size (e.g. text) before children are considered.
+    /// Call markDirty() when what it measures changes.
     virtual Vector2 measureContent() const { return {0, 0}; }
 
+    /// \brief Forces the next pass to re-measure this node and re-measure/re-arrange its ancestors.
+    void markDirty();
+    bool isDirty() const { return measureDirty_ || arrangeDirty_; }
+
     // Event handling
     virtual void onLayoutChanged() {}
     virtual void onSizeChanged() {}
@@ -122,17 +157,32 @@ protected:
     Alignment verticalAlignment_ = Alignment::START;
     float padding_ = 0.0f;
     float margin_ = 0.0f;
+    float spacing_ = 0.0f;
+    Vector2 offset_ = {0, 0};
+    int gridColumns_ = 1;
+
+    // Pass caches
+    Vector2 desiredSize_ = {0, 0};
+    Vector2 measuredAvailable_ = {-1, -1};  // Available space desiredSize_ was measured for
+    bool measureDirty_ = true;
+    bool arrangeDirty_ = true;
 
     LayoutNode* parent_ = nullptr;
     std::vector<std::shared_ptr<LayoutNode>> children_;
 
     Color debugColor_ = RED;
 
+    // Arrange-pass child placement inside contentBox(), one per LayoutType
     void computeAbsoluteLayout();
     void computeRelativeLayout();
     void computeFlexVerticalLayout();
     void computeFlexHorizontalLayout();
     void computeGridLayout();
+
+private:
+    Rectangle contentBox() const;
+    Vector2 measureChildren(float availableWidth, float availableHeight);
+    void computeFlexLayout(bool vertical);
 };
 
 // ============================================================================
@@ -163,8 +213,15 @@ public:
     void removeNode(const std::string& id);
 
     // Layout computation
+    /// \brief Marks the whole tree dirty and lays it out.
     void recomputeLayout();
+    /// \brief Lays the root out over the screen, re-running only dirty or resized subtrees.
     void updateLayout();
+    /// \brief Number of updateLayout() calls that found something to lay out.
+    uint64_t getLayoutPassCount() const { return layoutPasses_; }
+
+    /// \brief Drops the root and every registered node.
+    void clear();
 
     // Breakpoint system (responsive design)
     enum class Breakpoint {
@@ -205,6 +262,8 @@ private:
     std::unordered_map<std::string, std::shared_ptr<LayoutNode>> nodeRegistry_;
     Breakpoint currentBreakpoint_ = Breakpoint::DESKTOP;
     bool debugRendering_ = false;
+    Vector2 laidOutScreen_ = {0, 0};  // Screen size of the last pass
+    uint64_t layoutPasses_ = 0;
 
     void updateBreakpoint();
     Breakpoint calculateBreakpoint(float width) const;
@@ -222,10 +281,9 @@ LayoutConstraint makeMinMaxConstraint(float minWidth, float maxWidth,
                                      float minHeight, float maxHeight);
 
 // Layout utilities
+/// \brief Extent of children laid out along a flex axis, margins and `spacing` gaps included.
 Vector2 calculateFlexSize(const std::vector<std::shared_ptr<LayoutNode>>& children,
-                         LayoutType layoutType, float availableSpace);
-void distributeSpace(std::vector<std::shared_ptr<LayoutNode>>& children,
-                    float totalSpace, Alignment alignment);
+                         LayoutType layoutType, float spacing = 0.0f);
 
 // Responsive utilities
 bool isMobileLayout();
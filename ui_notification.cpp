@@ -1,82 +1,262 @@
 // ui_notification.cpp - Implementation of the notification system
 #include "ui_notification.h"
 #include <algorithm>
+#include <cstdio>
 #include <iostream>
 
 namespace UINotification {
 
+// ============================================================================
+// TEXT POOL
+// ============================================================================
+
+NotificationTextPool::NotificationTextPool() {
+    entries_.reserve(MAX_ENTRIES + 1);
+    entries_.emplace_back();  // EMPTY_ID
+    ids_.reserve(MAX_ENTRIES);
+}
+
+uint32_t NotificationTextPool::acquire(const std::string& text) {
+    if (text.empty()) return EMPTY_ID;
+
+    auto it = ids_.find(text);
+    if (it != ids_.end()) {
+        ++entries_[it->second].refs;
+        return it->second;
+    }
+
+    if (ids_.size() >= MAX_ENTRIES) {
+        sweep();
+    }
+
+    uint32_t id;
+    if (!freeIds_.empty()) {
+        id = freeIds_.back();
+        freeIds_.pop_back();
+    } else {
+        id = static_cast<uint32_t>(entries_.size());
+        entries_.emplace_back();
+    }
+    entries_[id].text = text;  // Reuses the buffer of whatever was swept from this id
+    entries_[id].refs = 1;
+    ids_.emplace(text, id);
+    return id;
+}
+
+void NotificationTextPool::release(uint32_t id) {
+    if (id != EMPTY_ID && entries_[id].refs > 0) {
+        --entries_[id].refs;
+    }
+}
+
+void NotificationTextPool::sweep() {
+    for (auto it = ids_.begin(); it != ids_.end();) {
+        if (entries_[it->second].refs == 0) {
+            freeIds_.push_back(it->second);
+            it = ids_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 // ============================================================================
 // NOTIFICATION MANAGER IMPLEMENTATION
 // ============================================================================
 
+NotificationManager::NotificationManager() {
+    for (size_t i = 0; i < MAX_CAPACITY; ++i) {
+        freeSlots[i] = static_cast<uint8_t>(MAX_CAPACITY - 1 - i);
+    }
+    freeCount = MAX_CAPACITY;
+}
+
 void NotificationManager::addNotification(const NotificationData& notification) {
-    if (notifications.size() >= static_cast<size_t>(maxNotifications)) {
-        notifications.erase(notifications.begin()); // Remove oldest
+    uint32_t titleId = text.acquire(notification.title);
+    uint32_t messageId = text.acquire(notification.message);
+
+    if (!notification.isPersistent) {
+        if (Slot* existing = findCoalescable(titleId, messageId, notification.type, notification.position)) {
+            text.release(titleId);
+            text.release(messageId);
+            coalesce(*existing, GetTime());
+            return;
+        }
     }
 
-    NotificationData newNotification = notification;
-    newNotification.createdTime = GetTime();
-    newNotification.updateColors();
-    notifications.push_back(newNotification);
+    Slot& slot = push(titleId, messageId, notification.type, notification.position,
+                      notification.duration, notification.isPersistent);
+    slot.onClick = notification.onClick;
+    slot.onDismiss = notification.onDismiss;
+    slot.width = notification.width;
+    slot.height = notification.height;
 }
 
 void NotificationManager::addNotification(const std::string& title, const std::string& message,
                                         NotificationType type, NotificationPosition position,
                                         float duration) {
-    NotificationData notification(title, message, type, position, duration);
-    addNotification(notification);
+    uint32_t titleId = text.acquire(title);
+    uint32_t messageId = text.acquire(message);
+
+    if (Slot* existing = findCoalescable(titleId, messageId, type, position)) {
+        text.release(titleId);
+        text.release(messageId);
+        coalesce(*existing, GetTime());
+        return;
+    }
+    push(titleId, messageId, type, position, duration, false);
 }
 
-void NotificationManager::update([[maybe_unused]] float deltaTime) {
-    float currentTime = GetTime();
+NotificationManager::Slot& NotificationManager::push(uint32_t titleId, uint32_t messageId, NotificationType type,
+                                                     NotificationPosition position, float duration, bool persistent) {
+    while (count >= static_cast<size_t>(maxNotifications)) {
+        removeAt(0, false);  // Evict the oldest
+    }
 
-    // Remove expired notifications
-    notifications.erase(
-        std::remove_if(notifications.begin(), notifications.end(),
-            [currentTime](const NotificationData& notification) {
-                return !notification.isPersistent &&
-                       (currentTime - notification.createdTime) > notification.duration;
-            }),
-        notifications.end()
-    );
+    uint8_t index = freeSlots[--freeCount];
+    order[(head + count) % MAX_CAPACITY] = index;
+    ++count;
+
+    Slot& slot = slots[index];
+    slot.titleId = titleId;
+    slot.messageId = messageId;
+    slot.type = type;
+    slot.position = position;
+    slot.duration = duration;
+    slot.createdTime = GetTime();
+    slot.isPersistent = persistent;
+    slot.repeatCount = 1;
+    slot.countLabel[0] = '\0';
+    slot.countLabelX = 0.0f;
+    slot.style = GetNotificationStyle(type);
+    slot.width = 300.0f;
+    slot.height = 80.0f;
+    slot.alpha = 0.0f;
+    layoutDirty = true;
+    return slot;
 }
 
-void NotificationManager::render() {
+NotificationManager::Slot* NotificationManager::findCoalescable(uint32_t titleId, uint32_t messageId,
+                                                                NotificationType type, NotificationPosition position) {
+    if (!coalescing) return nullptr;
+    if (type != NotificationType::ITEM_ACQUIRED && type != NotificationType::EXPERIENCE) return nullptr;
+
+    // Newest first; a burst repeats the same event back to back
+    for (size_t i = count; i-- > 0;) {
+        Slot& slot = at(i);
+        if (slot.type == type && slot.position == position && !slot.isPersistent &&
+            slot.titleId == titleId && slot.messageId == messageId) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+void NotificationManager::coalesce(Slot& slot, float now) {
+    ++slot.repeatCount;
+    std::snprintf(slot.countLabel, sizeof(slot.countLabel), " x%d", slot.repeatCount);
+    if (slot.repeatCount == 2) {
+        slot.countLabelX = (float)MeasureText(text.get(slot.titleId).c_str(), 18);
+    }
+    // Restart the timer without replaying the fade-in
+    slot.createdTime = now - std::min(now - slot.createdTime, fadeTime);
+}
+
+void NotificationManager::removeAt(size_t index, bool notifyDismiss) {
+    size_t ringIndex = (head + index) % MAX_CAPACITY;
+    uint8_t slotIndex = order[ringIndex];
+    Slot& slot = slots[slotIndex];
+
+    std::function<void()> onDismiss;
+    if (notifyDismiss) {
+        onDismiss = std::move(slot.onDismiss);
+    }
+    text.release(slot.titleId);
+    text.release(slot.messageId);
+    slot.titleId = NotificationTextPool::EMPTY_ID;
+    slot.messageId = NotificationTextPool::EMPTY_ID;
+    slot.onClick = nullptr;
+    slot.onDismiss = nullptr;
+
+    // Close the gap by moving the later indices down; notification data stays put
+    if (index == 0) {
+        head = (head + 1) % MAX_CAPACITY;
+    } else {
+        for (size_t i = index; i + 1 < count; ++i) {
+            order[(head + i) % MAX_CAPACITY] = order[(head + i + 1) % MAX_CAPACITY];
+        }
+    }
+    --count;
+    freeSlots[freeCount++] = slotIndex;
+    layoutDirty = true;
+
+    // Last, so a callback that adds a notification sees a consistent ring
+    if (onDismiss) {
+        onDismiss();
+    }
+}
+
+void NotificationManager::update([[maybe_unused]] float deltaTime) {
     float currentTime = GetTime();
 
-    for (size_t i = 0; i < notifications.size(); ++i) {
-        const auto& notification = notifications[i];
-        Vector2 position = calculatePosition(notification, i);
+    for (size_t i = 0; i < count;) {
+        Slot& slot = at(i);
+        float elapsedTime = currentTime - slot.createdTime;
 
-        // Calculate fade alpha
-        float elapsedTime = currentTime - notification.createdTime;
-        float alpha = 1.0f;
+        // Remove expired notifications
+        if (!slot.isPersistent && elapsedTime > slot.duration) {
+            removeAt(i, false);
+            continue;
+        }
 
+        float alpha = 1.0f;
         if (elapsedTime < fadeTime) {
             // Fade in
             alpha = elapsedTime / fadeTime;
-        } else if (!notification.isPersistent &&
-                   elapsedTime > (notification.duration - fadeTime)) {
+        } else if (!slot.isPersistent && elapsedTime > (slot.duration - fadeTime)) {
             // Fade out
-            float remainingTime = notification.duration - elapsedTime;
-            alpha = remainingTime / fadeTime;
+            alpha = (slot.duration - elapsedTime) / fadeTime;
         }
+        slot.alpha = std::max(0.0f, std::min(1.0f, alpha));
+        ++i;
+    }
 
-        alpha = std::max(0.0f, std::min(1.0f, alpha));
-        renderNotification(notification, position, alpha);
+    if (GetScreenWidth() != layoutScreenWidth || GetScreenHeight() != layoutScreenHeight) {
+        layoutDirty = true;
+    }
+    if (layoutDirty) {
+        layout();
+    }
+}
+
+void NotificationManager::render() {
+    if (layoutDirty) {
+        layout();
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const Slot& slot = at(i);
+        if (slot.alpha > 0.0f) {
+            renderNotification(slot);
+        }
     }
 }
 
 void NotificationManager::clear() {
-    notifications.clear();
+    while (count > 0) {
+        removeAt(count - 1, false);
+    }
 }
 
 void NotificationManager::dismissNotification(size_t index) {
-    if (index < notifications.size()) {
-        if (notifications[index].onDismiss) {
-            notifications[index].onDismiss();
-        }
-        notifications.erase(notifications.begin() + index);
+    if (index < count) {
+        removeAt(index, true);
+    }
+}
+
+void NotificationManager::setMaxNotifications(int max) {
+    maxNotifications = std::max(1, std::min(max, static_cast<int>(MAX_CAPACITY)));
+    while (count > static_cast<size_t>(maxNotifications)) {
+        removeAt(0, false);
     }
 }
 
@@ -113,92 +293,102 @@ void NotificationManager::showExperience(const std::string& title, const std::st
     addNotification(title, message, NotificationType::EXPERIENCE);
 }
 
-Vector2 NotificationManager::calculatePosition(const NotificationData& notification, int index) {
-    int screenWidth = GetScreenWidth();
-    int screenHeight = GetScreenHeight();
+void NotificationManager::layout() {
+    layoutScreenWidth = GetScreenWidth();
+    layoutScreenHeight = GetScreenHeight();
+    float screenWidth = (float)layoutScreenWidth;
+    float screenHeight = (float)layoutScreenHeight;
     float spacing = UITypes::GetThemeSpacing(UITypes::SpacingRole::MD);
-    float totalHeight = notification.height + spacing;
-
-    switch (notification.position) {
-        case NotificationPosition::TOP_LEFT:
-            return {spacing, spacing + (float)index * totalHeight};
-
-        case NotificationPosition::TOP_CENTER:
-            return {(float)screenWidth/2 - notification.width/2,
-                   spacing + (float)index * totalHeight};
-
-        case NotificationPosition::TOP_RIGHT:
-            return {(float)screenWidth - notification.width - spacing,
-                   spacing + (float)index * totalHeight};
 
-        case NotificationPosition::BOTTOM_LEFT:
-            return {spacing, (float)screenHeight - (float)(index + 1) * totalHeight - spacing};
-
-        case NotificationPosition::BOTTOM_CENTER:
-            return {(float)screenWidth/2 - notification.width/2,
-                   (float)screenHeight - (float)(index + 1) * totalHeight - spacing};
-
-        case NotificationPosition::BOTTOM_RIGHT:
-            return {(float)screenWidth - notification.width - spacing,
-                   (float)screenHeight - (float)(index + 1) * totalHeight - spacing};
-
-        case NotificationPosition::CENTER:
-            return {(float)screenWidth/2 - notification.width/2,
-                   (float)screenHeight/2 - notification.height/2 + (float)index * totalHeight};
-
-        default:
-            return {spacing, spacing + (float)index * totalHeight};
+    // Each corner stacks its own notifications, oldest nearest the edge
+    std::array<int, 7> stackDepth{};
+    for (size_t i = 0; i < count; ++i) {
+        Slot& slot = at(i);
+        int index = stackDepth[static_cast<size_t>(slot.position)]++;
+        float totalHeight = slot.height + spacing;
+        Vector2 position;
+
+        switch (slot.position) {
+            case NotificationPosition::TOP_LEFT:
+                position = {spacing, spacing + (float)index * totalHeight};
+                break;
+
+            case NotificationPosition::TOP_CENTER:
+                position = {screenWidth/2 - slot.width/2, spacing + (float)index * totalHeight};
+                break;
+
+            case NotificationPosition::TOP_RIGHT:
+                position = {screenWidth - slot.width - spacing, spacing + (float)index * totalHeight};
+                break;
+
+            case NotificationPosition::BOTTOM_LEFT:
+                position = {spacing, screenHeight - (float)(index + 1) * totalHeight - spacing};
+                break;
+
+            case NotificationPosition::BOTTOM_CENTER:
+                position = {screenWidth/2 - slot.width/2, screenHeight - (float)(index + 1) * totalHeight - spacing};
+                break;
+
+            case NotificationPosition::BOTTOM_RIGHT:
+                position = {screenWidth - slot.width - spacing, screenHeight - (float)(index + 1) * totalHeight - spacing};
+                break;
+
+            case NotificationPosition::CENTER:
+                position = {screenWidth/2 - slot.width/2, screenHeight/2 - slot.height/2 + (float)index * totalHeight};
+                break;
+
+            default:
+                position = {spacing, spacing + (float)index * totalHeight};
+                break;
+        }
+        slot.bounds = {position.x, position.y, slot.width, slot.height};
     }
+    layoutDirty = false;
 }
 
-void NotificationManager::renderNotification(const NotificationData& notification,
-                                           Vector2 position, float alpha) {
-    // Create notification bounds
-    Rectangle bounds = {
-        position.x,
-        position.y,
-        notification.width,
-        notification.height
-    };
+void NotificationManager::renderNotification(const Slot& slot) {
+    const Rectangle& bounds = slot.bounds;
+    const NotificationStyle& style = slot.style;
+    float alpha = slot.alpha;
 
     // Apply alpha to colors
-    Color bgColor = Color{notification.backgroundColor.r, notification.backgroundColor.g, notification.backgroundColor.b, (unsigned char)(notification.backgroundColor.a * alpha)};
-    Color titleColor = Color{notification.titleColor.r, notification.titleColor.g, notification.titleColor.b, (unsigned char)(notification.titleColor.a * alpha)};
-    Color messageColor = Color{notification.messageColor.r, notification.messageColor.g, notification.messageColor.b, (unsigned char)(notification.messageColor.a * alpha)};
-    Color borderColor = Color{notification.borderColor.r, notification.borderColor.g, notification.borderColor.b, (unsigned char)(notification.borderColor.a * alpha)};
+    Color bgColor = Color{style.background.r, style.background.g, style.background.b, (unsigned char)(style.background.a * alpha)};
+    Color titleColor = Color{style.title.r, style.title.g, style.title.b, (unsigned char)(style.title.a * alpha)};
+    Color messageColor = Color{style.message.r, style.message.g, style.message.b, (unsigned char)(style.message.a * alpha)};
+    Color borderColor = Color{style.border.r, style.border.g, style.border.b, (unsigned char)(style.border.a * alpha)};
 
     // Draw background with theme
     DrawRectangleRec(bounds, bgColor);
     DrawRectangleLinesEx(bounds, 2.0f, borderColor);
 
+    float padding = UITypes::GetThemeSpacing(UITypes::SpacingRole::MD);
+
     // Draw title
-    if (!notification.title.empty()) {
-        Vector2 titlePos = {
-            bounds.x + UITypes::GetThemeSpacing(UITypes::SpacingRole::MD),
-            bounds.y + UITypes::GetThemeSpacing(UITypes::SpacingRole::SM)
-        };
-        DrawText(notification.title.c_str(), (int)titlePos.x, (int)titlePos.y, 18, titleColor);
+    if (slot.titleId != NotificationTextPool::EMPTY_ID || slot.repeatCount > 1) {
+        int titleX = (int)(bounds.x + padding);
+        int titleY = (int)(bounds.y + UITypes::GetThemeSpacing(UITypes::SpacingRole::SM));
+        DrawText(text.get(slot.titleId).c_str(), titleX, titleY, 18, titleColor);
+        if (slot.repeatCount > 1) {
+            DrawText(slot.countLabel, titleX + (int)slot.countLabelX, titleY, 18, titleColor);
+        }
     }
 
     // Draw message
-    if (!notification.message.empty()) {
-        Vector2 messagePos = {
-            bounds.x + UITypes::GetThemeSpacing(UITypes::SpacingRole::MD),
-            bounds.y + UITypes::GetThemeSpacing(UITypes::SpacingRole::MD) + 18
-        };
-        DrawText(notification.message.c_str(), (int)messagePos.x, (int)messagePos.y, 14, messageColor);
+    if (slot.messageId != NotificationTextPool::EMPTY_ID) {
+        DrawText(text.get(slot.messageId).c_str(), (int)(bounds.x + padding), (int)(bounds.y + padding + 18),
+                 14, messageColor);
     }
 
     // Add a subtle glow effect for important notifications
-    if (notification.type == NotificationType::LEVEL_UP ||
-        notification.type == NotificationType::QUEST) {
+    if (slot.type == NotificationType::LEVEL_UP ||
+        slot.type == NotificationType::QUEST) {
         Rectangle glowBounds = {
             bounds.x - 2,
             bounds.y - 2,
             bounds.width + 4,
             bounds.height + 4
         };
-        Color glowColor = Color{notification.borderColor.r, notification.borderColor.g, notification.borderColor.b, (unsigned char)(notification.borderColor.a * alpha * 0.3f)};
+        Color glowColor = Color{style.border.r, style.border.g, style.border.b, (unsigned char)(style.border.a * alpha * 0.3f)};
         DrawRectangleRec(glowBounds, glowColor);
     }
 }
@@ -4,7 +4,10 @@
 
 #include "raylib.h"
 #include "ui_theme_optimized.h"
+#include <array>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 #include <functional>
@@ -36,6 +39,69 @@ enum class NotificationPosition {
     CENTER
 };
 
+struct NotificationStyle {
+    Color background;
+    Color title;
+    Color message;
+    Color border;
+};
+
+/// \brief Theme colors for a notification type.
+inline NotificationStyle GetNotificationStyle(NotificationType type) {
+    NotificationStyle style{};
+    switch (type) {
+        case NotificationType::INFO:
+            style.background = UITypes::GetThemeColor(UITypes::ColorRole::PRIMARY, 0.9f);
+            style.title = UITypes::GetThemeColor(UITypes::ColorRole::TEXT_PRIMARY);
+            style.message = UITypes::GetThemeColor(UITypes::ColorRole::TEXT_PRIMARY);
+            style.border = UITypes::GetThemeColor(UITypes::ColorRole::ACCENT);
+            break;
+        case NotificationType::SUCCESS:
+            style.background = UITypes::GetThemeColor(UITypes::ColorRole::SUCCESS, 0.2f);
+            style.title = UITypes::GetThemeColor(UITypes::ColorRole::TEXT_PRIMARY);
+            style.message = UITypes::GetThemeColor(UITypes::ColorRole::SUCCESS);
+            style.border = UITypes::GetThemeColor(UITypes::ColorRole::SUCCESS);
+            break;
+        case NotificationType::WARNING:
+            style.background = UITypes::GetThemeColor(UITypes::ColorRole::WARNING, 0.2f);
+            style.title = UITypes::GetThemeColor(UITypes::ColorRole::TEXT_PRIMARY);
+            style.message = UITypes::GetThemeColor(UITypes::ColorRole::WARNING);
+            style.border = UITypes::GetThemeColor(UITypes::ColorRole::WARNING);
+            break;
+        case NotificationType::ERROR:
+            style.background = UITypes::GetThemeColor(UITypes::ColorRole::ERROR, 0.2f);
+            style.title = UITypes::GetThemeColor(UITypes::ColorRole::TEXT_PRIMARY);
+            style.message = UITypes::GetThemeColor(UITypes::ColorRole::ERROR);
+            style.border = UITypes::GetThemeColor(UITypes::ColorRole::ERROR);
+            break;
+        case NotificationType::QUEST:
+            style.background = UITypes::GetThemeColor(UITypes::ColorRole::EPIC, 0.2f);
+            style.title = UITypes::GetThemeColor(UITypes::ColorRole::TEXT_PRIMARY);
+            style.message = UITypes::GetThemeColor(UITypes::ColorRole::EPIC);
+            style.border = UITypes::GetThemeColor(UITypes::ColorRole::EPIC);
+            break;
+        case NotificationType::LEVEL_UP:
+            style.background = UITypes::GetThemeColor(UITypes::ColorRole::EXPERIENCE, 0.2f);
+            style.title = UITypes::GetThemeColor(UITypes::ColorRole::TEXT_PRIMARY);
+            style.message = UITypes::GetThemeColor(UITypes::ColorRole::EXPERIENCE);
+            style.border = UITypes::GetThemeColor(UITypes::ColorRole::EXPERIENCE);
+            break;
+        case NotificationType::ITEM_ACQUIRED:
+            style.background = UITypes::GetThemeColor(UITypes::ColorRole::RARE, 0.2f);
+            style.title = UITypes::GetThemeColor(UITypes::ColorRole::TEXT_PRIMARY);
+            style.message = UITypes::GetThemeColor(UITypes::ColorRole::RARE);
+            style.border = UITypes::GetThemeColor(UITypes::ColorRole::RARE);
+            break;
+        case NotificationType::EXPERIENCE:
+            style.background = UITypes::GetThemeColor(UITypes::ColorRole::EXPERIENCE, 0.15f);
+            style.title = UITypes::GetThemeColor(UITypes::ColorRole::TEXT_PRIMARY);
+            style.message = UITypes::GetThemeColor(UITypes::ColorRole::EXPERIENCE);
+            style.border = UITypes::GetThemeColor(UITypes::ColorRole::EXPERIENCE);
+            break;
+    }
+    return style;
+}
+
 struct NotificationData {
     std::string title;
     std::string message;
@@ -65,61 +131,59 @@ struct NotificationData {
     }
 
     void updateColors() {
-        switch (type) {
-            case NotificationType::INFO:
-                backgroundColor = UITypes::GetThemeColor(UITypes::ColorRole::PRIMARY, 0.9f);
-                titleColor = UITypes::GetThemeColor(UITypes::ColorRole::TEXT_PRIMARY);
-                messageColor = UITypes::GetThemeColor(UITypes::ColorRole::TEXT_PRIMARY);
-                borderColor = UITypes::GetThemeColor(UITypes::ColorRole::ACCENT);
-                break;
-            case NotificationType::SUCCESS:
-                backgroundColor = UITypes::GetThemeColor(UITypes::ColorRole::SUCCESS, 0.2f);
-                titleColor = UITypes::GetThemeColor(UITypes::ColorRole::TEXT_PRIMARY);
-                messageColor = UITypes::GetThemeColor(UITypes::ColorRole::SUCCESS);
-                borderColor = UITypes::GetThemeColor(UITypes::ColorRole::SUCCESS);
-                break;
-            case NotificationType::WARNING:
-                backgroundColor = UITypes::GetThemeColor(UITypes::ColorRole::WARNING, 0.2f);
-                titleColor = UITypes::GetThemeColor(UITypes::ColorRole::TEXT_PRIMARY);
-                messageColor = UITypes::GetThemeColor(UITypes::ColorRole::WARNING);
-                borderColor = UITypes::GetThemeColor(UITypes::ColorRole::WARNING);
-                break;
-            case NotificationType::ERROR:
-                backgroundColor = UITypes::GetThemeColor(UITypes::ColorRole::ERROR, 0.2f);
-                titleColor = UITypes::GetThemeColor(UITypes::ColorRole::TEXT_PRIMARY);
-                messageColor = UITypes::GetThemeColor(UITypes::ColorRole::ERROR);
-                borderColor = UITypes::GetThemeColor(UITypes::ColorRole::ERROR);
-                break;
-            case NotificationType::QUEST:
-                backgroundColor = UITypes::GetThemeColor(UITypes::ColorRole::EPIC, 0.2f);
-                titleColor = UITypes::GetThemeColor(UITypes::ColorRole::TEXT_PRIMARY);
-                messageColor = UITypes::GetThemeColor(UITypes::ColorRole::EPIC);
-                borderColor = UITypes::GetThemeColor(UITypes::ColorRole::EPIC);
-                break;
-            case NotificationType::LEVEL_UP:
-                backgroundColor = UITypes::GetThemeColor(UITypes::ColorRole::EXPERIENCE, 0.2f);
-                titleColor = UITypes::GetThemeColor(UITypes::ColorRole::TEXT_PRIMARY);
-                messageColor = UITypes::GetThemeColor(UITypes::ColorRole::EXPERIENCE);
-                borderColor = UITypes::GetThemeColor(UITypes::ColorRole::EXPERIENCE);
-                break;
-            case NotificationType::ITEM_ACQUIRED:
-                backgroundColor = UITypes::GetThemeColor(UITypes::ColorRole::RARE, 0.2f);
-                titleColor = UITypes::GetThemeColor(UITypes::ColorRole::TEXT_PRIMARY);
-                messageColor = UITypes::GetThemeColor(UITypes::ColorRole::RARE);
-                borderColor = UITypes::GetThemeColor(UITypes::ColorRole::RARE);
-                break;
-            case NotificationType::EXPERIENCE:
-                backgroundColor = UITypes::GetThemeColor(UITypes::ColorRole::EXPERIENCE, 0.15f);
-                titleColor = UITypes::GetThemeColor(UITypes::ColorRole::TEXT_PRIMARY);
-                messageColor = UITypes::GetThemeColor(UITypes::ColorRole::EXPERIENCE);
-                borderColor = UITypes::GetThemeColor(UITypes::ColorRole::EXPERIENCE);
-                break;
-        }
+        NotificationStyle style = GetNotificationStyle(type);
+        backgroundColor = style.background;
+        titleColor = style.title;
+        messageColor = style.message;
+        borderColor = style.border;
     }
 };
 
+/// \brief Interns notification text so repeated titles and messages share one string.
+///
+/// Entries are reference counted by the live notifications that use them. Unused entries
+/// stay cached for the next identical message and are swept only when the pool fills.
+class NotificationTextPool {
+public:
+    static constexpr uint32_t EMPTY_ID = 0;       // Always the empty string
+    static constexpr size_t MAX_ENTRIES = 256;
+
+    NotificationTextPool();
+
+    /// \brief Gets the id of `text`, copying it only on first sight, and takes a reference.
+    uint32_t acquire(const std::string& text);
+    void release(uint32_t id);
+
+    const std::string& get(uint32_t id) const { return entries_[id].text; }
+    size_t size() const { return ids_.size(); }
+
+private:
+    struct Entry {
+        std::string text;
+        uint32_t refs = 0;
+    };
+
+    void sweep();
+
+    std::vector<Entry> entries_;
+    std::unordered_map<std::string, uint32_t> ids_;
+    std::vector<uint32_t> freeIds_;
+};
+
+/// \brief Shows toast notifications from a fixed pool, without allocating per notification.
+///
+/// Notifications live in MAX_CAPACITY pooled slots; the display order is a ring of slot
+/// indices, oldest first, so expiring or evicting one never moves notification data.
+/// Text is interned, colors are resolved once when a notification is added, and screen
+/// rectangles are recomputed only when the set or the screen size changes. update()
+/// works out each fade once per frame, leaving render() to draw.
+///
+/// With coalescing on, an ITEM_ACQUIRED or EXPERIENCE notification matching a live one
+/// bumps that one's repeat count ("x5") and restarts its timer instead of taking a slot.
 class NotificationManager {
 public:
+    static constexpr size_t MAX_CAPACITY = 16;
+
     static NotificationManager& getInstance() {
         static NotificationManager instance;
         return instance;
@@ -135,6 +199,7 @@ public:
     void update(float deltaTime);
     void render();
     void clear();
+    /// \brief Dismisses the notification at `index` in display order, oldest first.
     void dismissNotification(size_t index);
 
     // Quick notification methods
@@ -148,21 +213,69 @@ public:
     void showExperience(const std::string& title, const std::string& message);
 
     // Settings
-    void setMaxNotifications(int max) { maxNotifications = max; }
+    /// \brief Sets how many notifications show at once, clamped to 1..MAX_CAPACITY.
+    void setMaxNotifications(int max);
     void setFadeTime(float time) { fadeTime = time; }
+    void setCoalescing(bool enabled) { coalescing = enabled; }
+    bool isCoalescing() const { return coalescing; }
+
+    size_t getCount() const { return count; }
 
 private:
-    NotificationManager() = default;
+    NotificationManager();
     ~NotificationManager() = default;
     NotificationManager(const NotificationManager&) = delete;
     NotificationManager& operator=(const NotificationManager&) = delete;
 
-    std::vector<NotificationData> notifications;
+    struct Slot {
+        uint32_t titleId = NotificationTextPool::EMPTY_ID;
+        uint32_t messageId = NotificationTextPool::EMPTY_ID;
+        NotificationType type = NotificationType::INFO;
+        NotificationPosition position = NotificationPosition::TOP_RIGHT;
+        float duration = 0.0f;
+        float createdTime = 0.0f;
+        bool isPersistent = false;
+        int repeatCount = 1;
+        char countLabel[16] = {};   // " x5" once coalesced
+        float countLabelX = 0.0f;   // Offset of countLabel from the title start
+        std::function<void()> onClick;
+        std::function<void()> onDismiss;
+
+        NotificationStyle style{};  // Resolved when added
+        float width = 300.0f;
+        float height = 80.0f;
+
+        // Updated by layout() and update()
+        Rectangle bounds{};
+        float alpha = 0.0f;
+    };
+
+    Slot& push(uint32_t titleId, uint32_t messageId, NotificationType type, NotificationPosition position,
+               float duration, bool persistent);
+    Slot* findCoalescable(uint32_t titleId, uint32_t messageId, NotificationType type, NotificationPosition position);
+    void coalesce(Slot& slot, float now);
+    /// \brief Removes the notification at ring position `index`, keeping the rest in order.
+    void removeAt(size_t index, bool notifyDismiss);
+    Slot& at(size_t index) { return slots[order[(head + index) % MAX_CAPACITY]]; }
+
+    void layout();
+    void renderNotification(const Slot& slot);
+
+    std::array<Slot, MAX_CAPACITY> slots;
+    std::array<uint8_t, MAX_CAPACITY> order{};      // Ring of slot indices in display order
+    std::array<uint8_t, MAX_CAPACITY> freeSlots{};  // Stack of unused slot indices
+    size_t head = 0;
+    size_t count = 0;
+    size_t freeCount = 0;
+
+    NotificationTextPool text;
     int maxNotifications = 5;
     float fadeTime = 0.3f;
+    bool coalescing = true;
 
-    Vector2 calculatePosition(const NotificationData& notification, int index);
-    void renderNotification(const NotificationData& notification, Vector2 position, float alpha);
+    bool layoutDirty = true;
+    int layoutScreenWidth = 0;
+    int layoutScreenHeight = 0;
 };
 
 // ============================================================================
@@ -0,0 +1,146 @@
+// ui_panel_cache.cpp
+#include "ui_panel_cache.h"
+#include "ui_theme_optimized.h"
+#include "ui_text_cache.h"
+#include "render_stats.h"
+#include "rlgl.h"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+// State changes that each panel shows, indexed by CachedPanel
+const StateChangeMask PANEL_DEPENDENCIES[] = {
+    StateChange::MELEE_SWING | StateChange::COMBAT_HIT | StateChange::QUICK_USE |
+        StateChange::INVENTORY_ITEM,                                                   // PLAYER_STATS
+    0,                                                                                 // CONTROLS
+    StateChange::MELEE_SWING | StateChange::COMBAT_HIT,                                // GAME_STATS
+    0,                                                                                 // INVENTORY_CHROME
+};
+
+static_assert(sizeof(PANEL_DEPENDENCIES) / sizeof(PANEL_DEPENDENCIES[0]) == static_cast<size_t>(CachedPanel::COUNT),
+              "Every cached panel needs a dependency mask");
+
+uint32_t currentStyleKey() {
+    const UITypes::ThemeManager& theme = UITypes::ThemeManager::getInstance();
+    // Panels recorded with the default font are redrawn once theme fonts finish loading, and
+    // every theme load (a hot-reloaded custom theme keeps its variant) redraws them all
+    return (theme.getThemeRevision() << 20) ^ ((theme.getFontGeneration() << 8) |
+           (static_cast<uint32_t>(theme.getCurrentVariant()) << 1) | (theme.isHighContrast() ? 1u : 0u));
+}
+
+size_t indexOf(CachedPanel panel) {
+    return static_cast<size_t>(panel);
+}
+
+}  // namespace
+
+UIPanelCache::~UIPanelCache() {
+    release();
+}
+
+void UIPanelCache::invalidate(CachedPanel panel) {
+    entries_[indexOf(panel)].dirty = true;
+}
+
+void UIPanelCache::invalidateAll() {
+    for (Entry& entry : entries_) {
+        entry.dirty = true;
+    }
+}
+
+void UIPanelCache::onStateChanged(StateChangeMask changed) {
+    // Bulk state replacement (new game, load) can touch anything
+    if (changed & (StateChange::RESET | StateChange::VALIDATED)) {
+        invalidateAll();
+        return;
+    }
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        if (changed & PANEL_DEPENDENCIES[i]) {
+            entries_[i].dirty = true;
+        }
+    }
+}
+
+void UIPanelCache::release() {
+    for (Entry& entry : entries_) {
+        if (entry.target.id != 0) {
+            UnloadRenderTexture(entry.target);
+        }
+        entry = Entry{};
+    }
+}
+
+bool UIPanelCache::isStale(CachedPanel panel, Rectangle bounds) {
+    uint32_t styleKey = currentStyleKey();
+    if (styleKey != style_key_) {
+        style_key_ = styleKey;
+        invalidateAll();
+    }
+
+    const Entry& entry = entries_[indexOf(panel)];
+    if (entry.target.id == 0 || std::memcmp(&entry.bounds, &bounds, sizeof(Rectangle)) != 0) return true;
+    return entry.dirty && (refresh_interval_ <= 0.0f || GetTime() - entry.recorded_at >= refresh_interval_);
+}
+
+bool UIPanelCache::beginRecord(CachedPanel panel, Rectangle bounds) {
+    Entry& entry = entries_[indexOf(panel)];
+    int width = static_cast<int>(std::ceil(bounds.width)) + 2 * PADDING;
+    int height = static_cast<int>(std::ceil(bounds.height)) + 2 * PADDING;
+
+    if (entry.target.id == 0 || entry.target.texture.width != width || entry.target.texture.height != height) {
+        if (entry.target.id != 0) {
+            UnloadRenderTexture(entry.target);
+        }
+        entry.target = LoadRenderTexture(width, height);
+        if (entry.target.id == 0) {
+            std::cout << "UI: Failed to create " << width << "x" << height
+                      << " panel cache target; drawing panel directly" << std::endl;
+            return false;
+        }
+    }
+    entry.bounds = bounds;
+    entry.dirty = false;
+    entry.recorded_at = GetTime();
+
+    // Shift screen coordinates so the padded bounds land at the target's origin
+    Camera2D offset{};
+    offset.offset = {PADDING - bounds.x, PADDING - bounds.y};
+    offset.zoom = 1.0f;
+
+    // Text queued for the screen goes there before the target is bound
+    TextLayoutCache::getInstance().flushBatched();
+    BeginTextureMode(entry.target);
+    ClearBackground(BLANK);
+    BeginMode2D(offset);
+
+    // Colour blends as usual but alpha accumulates coverage, leaving the target premultiplied
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA,
+                              RL_FUNC_ADD, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+    return true;
+}
+
+void UIPanelCache::endRecord([[maybe_unused]] CachedPanel panel) {
+    TextLayoutCache::getInstance().flushBatched();  // The panel's own text belongs in the target
+    EndBlendMode();
+    EndMode2D();
+    EndTextureMode();
+    ++record_count_;
+}
+
+void UIPanelCache::blit(CachedPanel panel) {
+    const Entry& entry = entries_[indexOf(panel)];
+    const Texture2D& texture = entry.target.texture;
+
+    // Render targets are stored bottom-up, so flip the source rectangle
+    Rectangle source = {0.0f, 0.0f, static_cast<float>(texture.width), -static_cast<float>(texture.height)};
+    Vector2 position = {entry.bounds.x - PADDING, entry.bounds.y - PADDING};
+
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    DrawTextureRec(texture, source, position, WHITE);
+    EndBlendMode();
+    RenderStats::getInstance().recordDraw(4, texture.id, rlGetShaderIdDefault());
+    ++blit_count_;
+}
@@ -0,0 +1,100 @@
+// ui_panel_cache.h - Retained render targets for UI panels that rarely change
+#ifndef UI_PANEL_CACHE_H
+#define UI_PANEL_CACHE_H
+
+#include "raylib.h"
+#include "state_change.h"
+#include <array>
+#include <cstdint>
+
+// Panels recorded into their own render target. Each entry owns one RenderTexture2D.
+enum class CachedPanel : uint8_t {
+    PLAYER_STATS,      // Adventurer Status frame, bars and numbers
+    CONTROLS,          // Static controls help
+    GAME_STATS,        // Score, attacks, hits, accuracy
+    INVENTORY_CHROME,  // Inventory window frame, section labels and empty slot/list backgrounds
+    COUNT
+};
+
+/// \brief Caches UI panels in render targets and composites them with one blit each.
+///
+/// A panel is recorded the first time it is drawn and then reused until it goes stale:
+/// its bounds change, the theme or its fonts change, or a GameState change notification that it
+/// depends on arrives through onStateChanged(). Recording keeps the panel's screen
+/// coordinates, so existing draw code runs unchanged inside the record callback.
+class UIPanelCache {
+public:
+    // Room around the bounds for decorations and ID tags that hang over a panel's edge
+    static constexpr int PADDING = 16;
+
+    // State changes that make some panel stale; subscribe onStateChanged() with this
+    static constexpr StateChangeMask DEPENDENCY_MASK =
+        StateChange::MELEE_SWING | StateChange::COMBAT_HIT | StateChange::QUICK_USE |
+        StateChange::INVENTORY_ITEM | StateChange::VALIDATED | StateChange::RESET;
+
+    UIPanelCache() = default;
+    ~UIPanelCache();
+
+    UIPanelCache(const UIPanelCache&) = delete;
+    UIPanelCache& operator=(const UIPanelCache&) = delete;
+
+    /// \brief Draws a cached panel, first re-recording it if it is stale.
+    /// \param panel Cache slot for the panel.
+    /// \param bounds Screen rectangle the panel draws into (PADDING is added around it).
+    /// \param record Draws the panel in screen coordinates. Skips the cache and draws directly
+    ///               if a render target can't be created.
+    template<typename RecordFn>
+    void draw(CachedPanel panel, Rectangle bounds, RecordFn&& record) {
+        if (!isStale(panel, bounds)) {
+            blit(panel);
+            return;
+        }
+        if (beginRecord(panel, bounds)) {
+            record();
+            endRecord(panel);
+            blit(panel);
+        } else {
+            record();
+        }
+    }
+
+    void invalidate(CachedPanel panel);
+    void invalidateAll();
+
+    /// \brief Lets a panel made stale by a state or style change keep showing its last recording
+    /// for up to `seconds` after it was made, so bursts of changes re-record once. Bounds changes
+    /// always re-record. 0 (the default) re-records at the next draw.
+    void setRefreshInterval(float seconds) { refresh_interval_ = seconds; }
+    float getRefreshInterval() const { return refresh_interval_; }
+
+    /// \brief Invalidates the panels that display what changed.
+    /// \param changed Changes delivered by GameState::dispatchChanges.
+    void onStateChanged(StateChangeMask changed);
+
+    /// \brief Unloads every render target. Needs the GL context.
+    void release();
+
+    uint64_t getRecordCount() const { return record_count_; }
+    uint64_t getBlitCount() const { return blit_count_; }
+
+private:
+    struct Entry {
+        RenderTexture2D target{};
+        Rectangle bounds{};
+        bool dirty = true;
+        double recorded_at = 0.0;   // GetTime() of the last recording
+    };
+
+    bool isStale(CachedPanel panel, Rectangle bounds);
+    bool beginRecord(CachedPanel panel, Rectangle bounds);
+    void endRecord(CachedPanel panel);
+    void blit(CachedPanel panel);
+
+    std::array<Entry, static_cast<size_t>(CachedPanel::COUNT)> entries_{};
+    uint32_t style_key_ = 0;  // Theme variant, contrast and font generation the targets were recorded with
+    uint64_t record_count_ = 0;
+    uint64_t blit_count_ = 0;
+    float refresh_interval_ = 0.0f;
+};
+
+#endif // UI_PANEL_CACHE_H
@@ -4,10 +4,69 @@
 #include "render_utils.h"
 #include "performance_system.h"
 #include "debug_system.h"
+#include "ui_text_cache.h"
+#include "frame_arena.h"
+#include "dialog_system.h"
+#include "render_stats.h"
+#include "asset_cache.h"
 #include <iostream>
 #include <cmath>
 #include <algorithm>
 
+namespace {
+
+// Inventory window layout, as offsets from the window's top edge. Shared by the cached chrome
+// and the live rows drawn over it so the two can't drift apart.
+namespace InventoryRows {
+    constexpr int WINDOW_WIDTH = 700;
+    constexpr int WINDOW_HEIGHT = 500;
+    constexpr int TITLE_HEIGHT = 35;
+    constexpr int STATS = 40;
+    constexpr int SORT_LABEL = 75;
+    constexpr int SORT_BUTTONS = 95;
+    constexpr int SEARCH_LABEL = 130;
+    constexpr int SEARCH_BOX = 150;
+    constexpr int SEARCH_BOX_WIDTH = 300;
+    constexpr int SEARCH_BOX_HEIGHT = 25;
+    constexpr int SORT_OPTION_COUNT = 5;
+    constexpr int SORT_BUTTON_WIDTH = 80;
+    constexpr int SORT_BUTTON_HEIGHT = 25;
+    constexpr int SORT_BUTTON_GAP = 5;
+    constexpr int TIPS_TITLE = 185;
+    constexpr int TIPS = 203;
+    constexpr int EQUIPPED_LABEL = 228;
+    constexpr int EQUIPPED_SLOTS = 248;
+    constexpr int SLOT_HEIGHT = 20;
+    constexpr int SLOT_BOX_HEIGHT = 18;  // Drawn slot background; the rest of SLOT_HEIGHT is the gap
+    constexpr EquipmentSlot EQUIPPED_SLOT_ORDER[] = {EquipmentSlot::MAIN_HAND, EquipmentSlot::OFF_HAND, EquipmentSlot::HEAD,
+                                                     EquipmentSlot::CHEST, EquipmentSlot::LEGS, EquipmentSlot::FEET};
+    constexpr int SLOT_COUNT = sizeof(EQUIPPED_SLOT_ORDER) / sizeof(EQUIPPED_SLOT_ORDER[0]);
+    constexpr int ITEMS_LABEL = EQUIPPED_SLOTS + SLOT_COUNT * SLOT_HEIGHT + 10;
+    constexpr int ITEMS = ITEMS_LABEL + 20;
+    constexpr int ITEM_HEIGHT = 20;
+    constexpr int MAX_VISIBLE_ITEMS = 12;
+
+    constexpr int listBottom() { return ITEMS + MAX_VISIBLE_ITEMS * ITEM_HEIGHT; }
+}
+
+// DrawText()/MeasureText() equivalents through the layout cache: default font, sizes below 10
+// raised to 10, and one pixel of spacing per 10 pixels of size
+constexpr int DEFAULT_FONT_SIZE = 10;
+
+void drawDefaultText(const char* text, int x, int y, int fontSize, Color color) {
+    fontSize = std::max(fontSize, DEFAULT_FONT_SIZE);
+    TextLayoutCache::getInstance().draw(GetFontDefault(), text, {(float)x, (float)y}, (float)fontSize,
+                                        (float)(fontSize / DEFAULT_FONT_SIZE), color);
+}
+
+int measureDefaultText(const char* text, int fontSize) {
+    fontSize = std::max(fontSize, DEFAULT_FONT_SIZE);
+    return (int)TextLayoutCache::getInstance().measure(GetFontDefault(), text, (float)fontSize,
+                                                       (float)(fontSize / DEFAULT_FONT_SIZE)).x;
+}
+
+}  // namespace
+
 // ============================================================================
 // THEME-BASED UI DESIGN SYSTEM - Using existing UIDesign functions
 // ============================================================================
@@ -40,7 +99,7 @@ void drawStyledPanel(const PanelStyle& style, Rectangle bounds) {
     }
 }
 
-void drawStyledButton(const ButtonStyle& style, Rectangle bounds, const std::string& text, bool isHovered, bool isPressed) {
+void drawStyledButton(const ButtonStyle& style, Rectangle bounds, const char* text, bool isHovered, bool isPressed) {
     Color bgColor = style.backgroundColor;
     if (isPressed) {
         bgColor = style.pressedColor;
@@ -55,12 +114,12 @@ void drawStyledButton(const ButtonStyle& style, Rectangle bounds, const std::str
     DrawRectangleLinesEx(bounds, style.borderWidth, style.borderColor);
 
     // Draw text
-    Vector2 textSize = MeasureTextEx(GetFontDefault(), text.c_str(), style.fontStyle.size, style.fontStyle.spacing);
+    Vector2 textSize = TextLayoutCache::getInstance().measure(GetFontDefault(), text, style.fontStyle.size, style.fontStyle.spacing);
     Vector2 textPos = {
         bounds.x + (bounds.width - textSize.x) / 2,
         bounds.y + (bounds.height - textSize.y) / 2
     };
-    DrawText(text.c_str(), textPos.x, textPos.y, style.fontStyle.size, style.textColor);
+    drawDefaultText(text, textPos.x, textPos.y, style.fontStyle.size, style.textColor);
 }
 
 void drawStyledProgressBar(const ProgressBarStyle& style, Rectangle bounds, float progress, const std::string& label) {
@@ -84,17 +143,17 @@ void drawStyledProgressBar(const ProgressBarStyle& style, Rectangle bounds, floa
 
     // Draw label if provided
     if (!label.empty()) {
-        Vector2 textSize = MeasureTextEx(GetFontDefault(), label.c_str(), 10, 1.0f);
+        Vector2 textSize = TextLayoutCache::getInstance().measure(GetFontDefault(), label.c_str(), 10, 1.0f);
         Vector2 textPos = {
             bounds.x + (bounds.width - textSize.x) / 2,
             bounds.y + (bounds.height - textSize.y) / 2
         };
-        DrawText(label.c_str(), textPos.x, textPos.y, 10, UIDesign::getTextNormal());
+        drawDefaultText(label.c_str(), textPos.x, textPos.y, 10, UIDesign::getTextNormal());
     }
 }
 
-void drawStyledText(const std::string& text, Vector2 position, const FontStyle& style) {
-    // Use DrawTextEx with proper font support
+void drawStyledText(const char* text, Vector2 position, const FontStyle& style) {
+    // Theme font if loaded, otherwise the default font; both go through the layout cache
     Font* font = nullptr;
     if (style.size > 16) {
         font = const_cast<Font*>(UITypes::GetThemeFont(UITypes::FontRole::HEADER));
@@ -105,16 +164,22 @@ void drawStyledText(const std::string& text, Vector2 position, const FontStyle&
     }
 
     if (font && font->texture.id != 0) {
-        DrawTextEx(*font, text.c_str(), position, style.size, style.spacing, style.color);
+        // Theme fonts are distance-field atlases: one atlas, sharp at every size. Queued so a
+        // layer's strings share one distance-field shader block, grouped by atlas
+        TextLayoutCache::getInstance().drawBatched(*font, text, position, style.size, style.spacing, style.color,
+                                                   UITypes::ThemeManager::getInstance().getFontShader());
     } else {
         // Fallback to default font
-        DrawText(text.c_str(), (int)position.x, (int)position.y, style.size, style.color);
+        drawDefaultText(text, (int)position.x, (int)position.y, style.size, style.color);
     }
 }
 
-void drawStyledTooltip(const std::string& text, Vector2 position, int maxWidth) {
+void drawStyledTooltip(const char* text, Vector2 position, int maxWidth) {
+    // The tooltip covers whatever is under the cursor, queued text included
+    TextLayoutCache::getInstance().flushBatched();
+
     // Simple tooltip implementation - could be enhanced
-    Vector2 textSize = MeasureTextEx(GetFontDefault(), text.c_str(), UIDesign::getFontSmall().size, 1.0f);
+    Vector2 textSize = TextLayoutCache::getInstance().measure(GetFontDefault(), text, UIDesign::getFontSmall().size, 1.0f);
     Rectangle tooltipBounds = {
         position.x,
         position.y - textSize.y - 5,
@@ -176,8 +241,8 @@ Rectangle positionRectRelative(Rectangle base, int offsetX, int offsetY, int wid
     };
 }
 
-Vector2 getTextSize(const std::string& text, const FontStyle& style) {
-    return MeasureTextEx(GetFontDefault(), text.c_str(), style.size, style.spacing);
+Vector2 getTextSize(const char* text, const FontStyle& style) {
+    return TextLayoutCache::getInstance().measure(GetFontDefault(), text, style.size, style.spacing);
 }
 
 bool isPointInRect(Vector2 point, Rectangle rect) {
@@ -214,64 +279,139 @@ void shutdownUISystem() {
 }
 
 UISystemManager::UISystemManager() : screenWidth_(800), screenHeight_(600) {
+    buildLayoutTree();
     initializeLayout();
 }
 
 UISystemManager::~UISystemManager() {
-    // Cleanup any resources
+    // The layout manager would otherwise keep the tree alive
+    UILayout::LayoutManager::getInstance().clear();
 }
 
 void UISystemManager::setScreenDimensions(int width, int height) {
+    // Called every frame; only a real resize reaches the layout tree
+    if (width == screenWidth_ && height == screenHeight_) return;
     screenWidth_ = width;
     screenHeight_ = height;
+    UILayout::LayoutManager::getInstance().setScreenSize(width, height);
     initializeLayout();
 }
 
+void UISystemManager::buildLayoutTree() {
+    using namespace UILayout;
+    LayoutManager& layout = LayoutManager::getInstance();
+    layout.clear();
+    layoutRoot_ = layout.createNode("screen", LayoutType::STACK);
+
+    // HUD zones, each anchored to the screen edges it hugs
+    struct ZoneSpec {
+        UIZone zone;
+        const char* id;
+        float width, height;
+        Alignment horizontal, vertical;
+        float margin;
+    };
+    const ZoneSpec ZONES[] = {
+        {UIZone::TOP_LEFT, "zone.top_left", 250, 220, Alignment::START, Alignment::START, 10},      // Increased width and height for better spacing
+        {UIZone::TOP_RIGHT, "zone.top_right", 290, 140, Alignment::END, Alignment::START, 10},      // Increased height to prevent overlap between performance and testing panels
+        {UIZone::CENTER, "zone.center", 640, 440, Alignment::CENTER, Alignment::CENTER, 0},         // Modal windows
+        {UIZone::BOTTOM_LEFT, "zone.bottom_left", 380, 170, Alignment::START, Alignment::END, 10},  // Increased space for controls and stats
+        {UIZone::BOTTOM_RIGHT, "zone.bottom_right", 270, 110, Alignment::END, Alignment::END, 10},
+        {UIZone::INTERACTION, "zone.interaction", 350, 50, Alignment::CENTER, Alignment::CENTER, 0}, // Centered interaction prompts
+    };
+    for (const ZoneSpec& spec : ZONES) {
+        auto node = createPanel(spec.id, spec.width, spec.height);
+        node->setHorizontalAlignment(spec.horizontal);
+        node->setVerticalAlignment(spec.vertical);
+        node->setMargin(spec.margin);
+        zoneNodes_[static_cast<size_t>(spec.zone)] = node.get();
+        layoutRoot_->addChild(node);
+    }
+
+    // Inventory window: rows sit at fixed offsets from the window's top-left corner
+    float sideInset = (float)UIDesign::getSpacingLarge();
+    float slotInset = (float)UIDesign::getSpacingXLarge();
+    auto window = layout.createNode("inventory.window", LayoutType::ABSOLUTE);
+    window->setConstraints(makeFixedConstraint(InventoryRows::WINDOW_WIDTH, InventoryRows::WINDOW_HEIGHT));
+    window->setHorizontalAlignment(Alignment::CENTER);
+    window->setVerticalAlignment(Alignment::CENTER);
+
+    auto sortButtons = layout.createNode("inventory.sort_buttons", LayoutType::FLEX_HORIZONTAL);
+    sortButtons->setOffset({sideInset, (float)InventoryRows::SORT_BUTTONS});
+    sortButtons->setSpacing(InventoryRows::SORT_BUTTON_GAP);
+    for (int i = 0; i < InventoryRows::SORT_OPTION_COUNT; ++i) {
+        sortButtons->addChild(createButton("", InventoryRows::SORT_BUTTON_WIDTH, InventoryRows::SORT_BUTTON_HEIGHT));
+    }
+
+    auto equippedSlots = layout.createNode("inventory.equipped_slots", LayoutType::FLEX_VERTICAL);
+    equippedSlots->setOffset({slotInset, (float)InventoryRows::EQUIPPED_SLOTS});
+    equippedSlots->setSpacing(InventoryRows::SLOT_HEIGHT - InventoryRows::SLOT_BOX_HEIGHT);
+    for (int i = 0; i < InventoryRows::SLOT_COUNT; ++i) {
+        equippedSlots->addChild(createPanel("", InventoryRows::WINDOW_WIDTH - 2 * slotInset - 20, InventoryRows::SLOT_BOX_HEIGHT));
+    }
+
+    auto itemRows = layout.createNode("inventory.item_rows", LayoutType::FLEX_VERTICAL);
+    itemRows->setOffset({sideInset, (float)InventoryRows::ITEMS});
+    for (int i = 0; i < InventoryRows::MAX_VISIBLE_ITEMS; ++i) {
+        itemRows->addChild(createPanel("", InventoryRows::WINDOW_WIDTH - 2 * sideInset, InventoryRows::ITEM_HEIGHT));
+    }
+
+    inventoryWindowNode_ = window.get();
+    sortButtonsNode_ = sortButtons.get();
+    equippedSlotsNode_ = equippedSlots.get();
+    itemRowsNode_ = itemRows.get();
+    window->addChild(sortButtons);
+    window->addChild(equippedSlots);
+    window->addChild(itemRows);
+    layoutRoot_->addChild(window);
+
+    layout.setRootLayout(layoutRoot_);
+    layout.setScreenSize(screenWidth_, screenHeight_);
+    layout.updateLayout();
+}
+
 void UISystemManager::initializeLayout() {
     // Clear existing zone reservations
     zoneReservations_.clear();
 }
 
 Rectangle UISystemManager::getZoneBounds(UIZone zone) const {
-    switch (zone) {
-        case UIZone::TOP_LEFT:
-            return {10, 10, 250, 220};  // Increased width and height for better spacing
-        case UIZone::TOP_RIGHT:
-            return {(float)(screenWidth_ - 300), 10, 290, 140};  // Increased height to prevent overlap between performance and testing panels
-        case UIZone::CENTER:
-            return {(float)(screenWidth_ / 2 - 320), (float)(screenHeight_ / 2 - 220), 640, 440};  // Modal windows
-        case UIZone::BOTTOM_LEFT:
-            return {10, (float)(screenHeight_ - 180), 380, 170};  // Increased space for controls and stats
-        case UIZone::BOTTOM_RIGHT:
-            return {(float)(screenWidth_ - 280), (float)(screenHeight_ - 120), 270, 110};
-        case UIZone::INTERACTION:
-            return {(float)(screenWidth_ / 2 - 175), (float)(screenHeight_ / 2 - 25), 350, 50};  // Centered interaction prompts
-        default:
-            return {0, 0, 100, 100};
+    size_t index = static_cast<size_t>(zone);
+    if (index >= zoneNodes_.size()) {
+        return {0, 0, 100, 100};
     }
+    return zoneNodes_[index]->getBounds();
 }
 
 bool UISystemManager::isModalActive(const GameState& state) const {
-    return state.isInDialog || state.showInventoryWindow || state.showEscMenu;
+    return state.dialog.active || state.ui.showInventoryWindow || state.ui.showEscMenu;
 }
 
 void UISystemManager::renderAllUI(Camera3D camera, const GameState& state, float currentTime) {
-    // Update screen dimensions
+    // Update screen dimensions; the layout pass is a no-op unless something changed
     setScreenDimensions(GetScreenWidth(), GetScreenHeight());
+    UILayout::LayoutManager::getInstance().updateLayout();
 
     // Clear previous zone reservations
     clearOverlaps();
 
-    // Render in layer order (background to foreground)
+    // Render in layer order (background to foreground). Each layer's theme text is queued
+    // and drawn at the end of it, over the layer's shapes and under the next layer
+    TextLayoutCache& text = TextLayoutCache::getInstance();
     renderBackgroundLayer(state);
+    text.flushBatched();
 
     if (!isModalActive(state)) {
         renderGameplayLayer(camera, state, currentTime);
+        text.flushBatched();
     }
 
     renderModalLayer(state);
+    text.flushBatched();
     renderOverlayLayer(const_cast<GameState&>(state));  // ESC menu needs to update selection
+    text.flushBatched();
     renderDebugLayer(state, currentTime);
+    text.flushBatched();
 }
 
 void UISystemManager::renderBackgroundLayer(const GameState& state) {
@@ -290,16 +430,16 @@ void UISystemManager::renderGameplayLayer([[maybe_unused]] Camera3D camera, cons
 
 void UISystemManager::renderModalLayer(const GameState& state) {
     // Modal dialogs - render one at a time, centered
-    if (state.isInDialog && state.showDialogWindow) {
+    if (state.dialog.active && state.dialog.showWindow) {
         renderDialogModal(state);
-    } else if (state.showInventoryWindow) {
+    } else if (state.ui.showInventoryWindow) {
         renderInventoryModal(state);
     }
 }
 
 void UISystemManager::renderOverlayLayer(GameState& state) {
     // Full-screen overlays
-    if (state.showEscMenu) {
+    if (state.ui.showEscMenu) {
         renderEscMenuOverlay(state);
     }
 }
@@ -309,10 +449,10 @@ void UISystemManager::renderDebugLayer([[maybe_unused]] const GameState& state,
     renderDiagnosticPanel(state);
     
     // **TAB TOGGLE**: Show detailed testing panel when requested
-    if (state.showTestingPanel) {
+    if (state.ui.showTestingPanel) {
         // Calculate location info for testing panel
-        std::string locationText = state.isInBuilding ? "INSIDE BUILDING" : "OUTSIDE";
-        Color locationColor = state.isInBuilding ? UIDesign::getHealthColor() : UIDesign::getManaColor();
+        const char* locationText = state.player.isInBuilding ? "INSIDE BUILDING" : "OUTSIDE";
+        Color locationColor = state.player.isInBuilding ? UIDesign::getHealthColor() : UIDesign::getManaColor();
         renderDetailedTestingPanel(state, locationText, locationColor);
     } else {
         // Show compact testing status in top-right
@@ -323,7 +463,7 @@ void UISystemManager::renderDebugLayer([[maybe_unused]] const GameState& state,
 // ===== INDIVIDUAL COMPONENT RENDERERS - PROPERLY POSITIONED =====
 
 void UISystemManager::renderCrosshair(const GameState& state) {
-    if (state.isInDialog || state.mouseReleased) return;
+    if (state.dialog.active || state.ui.mouseReleased) return;
 
     int centerX = screenWidth_ / 2;
     int centerY = screenHeight_ / 2;
@@ -341,8 +481,15 @@ void UISystemManager::renderPlayerStats(const GameState& state) {
     // Reserve this zone to prevent collisions
     reserveZone(UIZone::TOP_LEFT, "PlayerStats");
 
-    // Use theme system panel
     Rectangle panelBounds = {(float)panelX, (float)panelY, 230.0f, 135.0f};
+    panelCache_.draw(CachedPanel::PLAYER_STATS, panelBounds, [&]() { drawPlayerStatsPanel(state, panelBounds); });
+}
+
+void UISystemManager::drawPlayerStatsPanel(const GameState& state, Rectangle panelBounds) {
+    int panelX = (int)panelBounds.x;
+    int panelY = (int)panelBounds.y;
+
+    // Use theme system panel
     UIDesign::PanelStyle panelStyle = UIDesign::PanelStyle::getDefault();
     UIDesign::drawStyledPanel(panelStyle, panelBounds);
 
@@ -359,34 +506,34 @@ void UISystemManager::renderPlayerStats(const GameState& state) {
     int contentY = panelY + 30;
 
     // Health bar with enhanced styling
-    float healthPercent = (float)state.playerHealth / state.maxPlayerHealth;
+    float healthPercent = (float)state.player.health / state.player.maxHealth;
     Rectangle healthBarBounds = {(float)(panelX + UIDesign::getSpacingMedium()), (float)contentY, 200.0f, 12.0f};
 
     UIDesign::ProgressBarStyle healthStyle = UIDesign::ProgressBarStyle::getDefault();
     UIDesign::drawStyledProgressBar(healthStyle, healthBarBounds, healthPercent,
-                                  TextFormat("Health: %d/%d", state.playerHealth, state.maxPlayerHealth));
+                                  TextFormat("Health: %d/%d", state.player.health, state.player.maxHealth));
 
     contentY += 20;
 
     // Mana bar with enhanced styling
-    float manaPercent = (float)state.playerMana / state.maxPlayerMana;
+    float manaPercent = (float)state.player.mana / state.player.maxMana;
     Rectangle manaBarBounds = {(float)(panelX + UIDesign::getSpacingMedium()), (float)contentY, 200.0f, 12.0f};
 
     UIDesign::ProgressBarStyle manaStyle = UIDesign::ProgressBarStyle::getDefault();
     UIDesign::drawStyledProgressBar(manaStyle, manaBarBounds, manaPercent,
-                                  TextFormat("Mana: %d/%d", state.playerMana, state.maxPlayerMana));
+                                  TextFormat("Mana: %d/%d", state.player.mana, state.player.maxMana));
 
     contentY += 20;
 
     // Level and experience with enhanced styling
     Vector2 levelPos = {(float)(panelX + UIDesign::getSpacingMedium()), (float)contentY};
-    UIDesign::drawStyledText(TextFormat("Level %d | XP: %d", state.playerLevel, state.playerExperience),
+    UIDesign::drawStyledText(TextFormat("Level %d | XP: %d", state.player.level, state.player.experience),
                                levelPos, UIDesign::getFontBody());
 
     contentY += 18;
 
     // Experience bar
-    float xpPercent = state.playerLevel > 0 ? (float)state.playerExperience / (state.playerLevel * 100) : 0.0f;
+    float xpPercent = state.player.level > 0 ? (float)state.player.experience / (state.player.level * 100) : 0.0f;
     Rectangle xpBarBounds = {(float)(panelX + UIDesign::getSpacingMedium()), (float)contentY, 200.0f, 8.0f};
     UIDesign::ProgressBarStyle xpStyle = UIDesign::ProgressBarStyle::getDefault();
     UIDesign::drawStyledProgressBar(xpStyle, xpBarBounds, xpPercent);
@@ -395,7 +542,7 @@ void UISystemManager::renderPlayerStats(const GameState& state) {
 
     // Equipment bonuses with enhanced styling
     if (state.inventorySystem) {
-        auto totalStats = state.inventorySystem->getTotalBonuses();
+        const ItemStats& totalStats = state.inventorySystem->getTotalBonuses();
         if (totalStats.damage > 0 || totalStats.armor > 0) {
             Vector2 equipPos = {(float)(panelX + UIDesign::getSpacingMedium()), (float)contentY};
             UIDesign::drawStyledText(TextFormat("Equipment: +%d DMG, +%d ARM",
@@ -418,7 +565,7 @@ void UISystemManager::renderPlayerStats(const GameState& state) {
 void UISystemManager::renderPerformanceDisplay([[maybe_unused]] const GameState& state) {
     // **TOP-RIGHT ZONE** - Enhanced performance display with new design system
     Rectangle zone = getZoneBounds(UIZone::TOP_RIGHT);
-    Rectangle panelBounds = {(float)(zone.x + zone.width - 140), (float)(zone.y + 10), 130.0f, 80.0f};
+    Rectangle panelBounds = {(float)(zone.x + zone.width - 140), (float)(zone.y + 10), 130.0f, 108.0f};
 
     // Use new design system panel
     UIDesign::drawStyledPanel(UIDesign::getPanelPopup(), panelBounds);
@@ -441,23 +588,36 @@ void UISystemManager::renderPerformanceDisplay([[maybe_unused]] const GameState&
                     (fps >= 30 ? UIDesign::getTextWarning() : UIDesign::getTextError());
 
     Vector2 fpsPos = {(float)fpsX, (float)fpsY};
-    std::string fpsText = "FPS: " + std::to_string(fps);
+    const char* fpsText = FrameArena::getInstance().format("FPS: %d", fps);
     UIDesign::drawStyledText(fpsText, fpsPos, {UIDesign::getFontSmall().size, fpsColor, false, 1.0f});
 
     // Frame time display
     Vector2 frameTimePos = {(float)fpsX, (float)(fpsY + 16)};
     float frameTime = GetFrameTime() * 1000.0f; // Convert to milliseconds
-    std::string frameTimeText = TextFormat("Frame: %.1fms", frameTime);
+    const char* frameTimeText = FrameArena::getInstance().format("Frame: %.1fms", frameTime);
     UIDesign::drawStyledText(frameTimeText, frameTimePos, UIDesign::getFontTiny());
 
     // Performance status indicator
     Vector2 statusPos = {(float)fpsX, (float)(fpsY + 30)};
-    std::string statusText = fps >= 55 ? "Status: Excellent" :
+    const char* statusText = fps >= 55 ? "Status: Excellent" :
                             (fps >= 30 ? "Status: Good" : "Status: Poor");
     Color statusColor = fps >= 55 ? UIDesign::getTextHighlight() :
                      (fps >= 30 ? UIDesign::getTextWarning() : UIDesign::getTextError());
     UIDesign::drawStyledText(statusText, statusPos, {UIDesign::getFontTiny().size, statusColor, false, 1.0f});
 
+    // Last frame's draw submissions and the texture binds that split rlgl's batch
+    RenderPassStats render = RenderStats::getInstance().getTotal();
+    Vector2 renderPos = {(float)fpsX, (float)(fpsY + 44)};
+    const char* renderText = FrameArena::getInstance().format("Draws: %u  Binds: %u", render.draws, render.textureBinds);
+    UIDesign::drawStyledText(renderText, renderPos, UIDesign::getFontTiny());
+
+    // Resident asset memory against its budget; loads still in flight in brackets
+    const AssetCacheStats& assets = AssetCache::getInstance().getStats();
+    Vector2 assetPos = {(float)fpsX, (float)(fpsY + 58)};
+    const char* assetText = FrameArena::getInstance().format("VRAM: %.0f/%.0fMB (%u)", assets.gpuBytes / (1024.0 * 1024.0),
+                                                             assets.gpuBudget / (1024.0 * 1024.0), assets.loading);
+    UIDesign::drawStyledText(assetText, assetPos, UIDesign::getFontTiny());
+
     // Add ID tag
     Vector2 idPos = {(float)(panelBounds.x + panelBounds.width - 25), (float)(panelBounds.y + 2)};
     UIDesign::drawStyledText("[ID:12]", idPos, {8, UIDesign::getTextSubtle(), false, 1.0f});
@@ -476,12 +636,19 @@ void UISystemManager::renderControlsPanel([[maybe_unused]] const GameState& stat
     // Reserve this zone to prevent collisions
     reserveZone(UIZone::BOTTOM_LEFT, "ControlsPanel");
 
-    // Use new design system panel
     Rectangle panelBounds = {(float)panelX, (float)panelY, (float)(zone.width - 10), 60.0f};
+    panelCache_.draw(CachedPanel::CONTROLS, panelBounds, [&]() { drawControlsPanel(panelBounds); });
+}
+
+void UISystemManager::drawControlsPanel(Rectangle panelBounds) {
+    int panelX = (int)panelBounds.x;
+    int panelY = (int)panelBounds.y;
+
+    // Use new design system panel
     UIDesign::drawStyledPanel(UIDesign::getPanelPopup(), panelBounds);
 
     // Title with enhanced styling
-    Rectangle titleBounds = {(float)panelX, (float)panelY, (float)(zone.width - 10), 20.0f};
+    Rectangle titleBounds = {(float)panelX, (float)panelY, panelBounds.width, 20.0f};
     DrawRectangleRec(titleBounds, UIDesign::fadeColor(UIDesign::getSecondaryAccent(), 0.9f));
     DrawRectangleLinesEx(titleBounds, UIDesign::getBorderThin(), UIDesign::getSecondaryLight());
 
@@ -524,12 +691,19 @@ void UISystemManager::renderGameStats(const GameState& state) {
     // Reserve this zone to prevent collisions
     reserveZone(UIZone::BOTTOM_LEFT, "GameStats");
 
-    // Use new design system panel
     Rectangle panelBounds = {(float)panelX, (float)panelY, (float)(zone.width - 10), 95.0f};
+    panelCache_.draw(CachedPanel::GAME_STATS, panelBounds, [&]() { drawGameStatsPanel(state, panelBounds); });
+}
+
+void UISystemManager::drawGameStatsPanel(const GameState& state, Rectangle panelBounds) {
+    int panelX = (int)panelBounds.x;
+    int panelY = (int)panelBounds.y;
+
+    // Use new design system panel
     UIDesign::drawStyledPanel(UIDesign::getPanelPopup(), panelBounds);
 
     // Title with enhanced styling
-    Rectangle titleBounds = {(float)panelX, (float)panelY, (float)(zone.width - 10), 20.0f};
+    Rectangle titleBounds = {(float)panelX, (float)panelY, panelBounds.width, 20.0f};
     DrawRectangleRec(titleBounds, UIDesign::fadeColor(UIDesign::getExperienceColor(), 0.9f));
     DrawRectangleLinesEx(titleBounds, UIDesign::getBorderThin(), UIDesign::getSecondaryLight());
 
@@ -540,38 +714,38 @@ void UISystemManager::renderGameStats(const GameState& state) {
 
     // Score with enhanced styling
     Vector2 scorePos = {(float)(panelX + UIDesign::getSpacingMedium()), (float)contentY};
-    UIDesign::drawStyledText(TextFormat("Score: %d points", state.score), scorePos, UIDesign::getFontSmall());
+    UIDesign::drawStyledText(TextFormat("Score: %d points", state.combat.score), scorePos, UIDesign::getFontSmall());
 
     contentY += 16;
 
     // Combat stats
     Vector2 combatPos = {(float)(panelX + UIDesign::getSpacingMedium()), (float)contentY};
-    UIDesign::drawStyledText(TextFormat("Attacks: %d", state.swingsPerformed), combatPos, UIDesign::getFontSmall());
+    UIDesign::drawStyledText(TextFormat("Attacks: %d", state.combat.swingsPerformed), combatPos, UIDesign::getFontSmall());
 
     contentY += 14;
 
     Vector2 hitsPos = {(float)(panelX + UIDesign::getSpacingMedium()), (float)contentY};
-    UIDesign::drawStyledText(TextFormat("Hits: %d", state.meleeHits), hitsPos, UIDesign::getFontSmall());
+    UIDesign::drawStyledText(TextFormat("Hits: %d", state.combat.meleeHits), hitsPos, UIDesign::getFontSmall());
 
     contentY += 14;
 
     // Accuracy with color coding
-    float accuracy = state.swingsPerformed > 0 ? (float)state.meleeHits / state.swingsPerformed * 100.0f : 0.0f;
+    float accuracy = state.combat.swingsPerformed > 0 ? (float)state.combat.meleeHits / state.combat.swingsPerformed * 100.0f : 0.0f;
     Color accuracyColor = accuracy >= 80.0f ? UIDesign::getTextHighlight() :
                          (accuracy >= 50.0f ? UIDesign::getTextWarning() : UIDesign::getTextError());
 
     Vector2 accuracyPos = {(float)(panelX + UIDesign::getSpacingMedium()), (float)contentY};
-    std::string accuracyText = TextFormat("Accuracy: %.1f%%", accuracy);
+    const char* accuracyText = FrameArena::getInstance().format("Accuracy: %.1f%%", accuracy);
     UIDesign::drawStyledText(accuracyText, accuracyPos, {UIDesign::getFontSmall().size, accuracyColor, false, 1.0f});
 
     contentY += 14;
 
     // Combat effectiveness indicator
-    std::string effectiveness = accuracy >= 80.0f ? "Excellent" :
+    const char* effectiveness = accuracy >= 80.0f ? "Excellent" :
                                (accuracy >= 60.0f ? "Good" :
                                (accuracy >= 40.0f ? "Fair" : "Poor"));
     Vector2 effectPos = {(float)(panelX + UIDesign::getSpacingMedium()), (float)contentY};
-    UIDesign::drawStyledText(TextFormat("Combat: %s", effectiveness.c_str()), effectPos, UIDesign::getFontTiny());
+    UIDesign::drawStyledText(FrameArena::getInstance().format("Combat: %s", effectiveness), effectPos, UIDesign::getFontTiny());
 
     // Add ID tag
     Vector2 idPos = {(float)(panelBounds.x + panelBounds.width - 25), (float)(panelBounds.y + 2)};
@@ -582,7 +756,7 @@ void UISystemManager::renderGameStats(const GameState& state) {
 }
 
 void UISystemManager::renderInteractionPrompt(const GameState& state, float currentTime) {
-    if (!state.showInteractPrompt || state.isInDialog) return;
+    if (!state.ui.showInteractPrompt || state.dialog.active) return;
 
     // **INTERACTION ZONE** - Enhanced interaction prompt with new design system
     Rectangle zone = getZoneBounds(UIZone::INTERACTION);
@@ -599,7 +773,7 @@ void UISystemManager::renderInteractionPrompt(const GameState& state, float curr
 
     // Main prompt text with enhanced styling
     Vector2 promptPos = {(float)(zone.x + UIDesign::getSpacingMedium()), (float)(zone.y + UIDesign::getSpacingSmall())};
-    UIDesign::drawStyledText(state.interactPromptText, promptPos, UIDesign::getFontBody());
+    UIDesign::drawStyledText(state.ui.interactPromptText, promptPos, UIDesign::getFontBody());
 
     // Action hint
     Vector2 actionPos = {(float)(zone.x + UIDesign::getSpacingMedium()), (float)(zone.y + 22)};
@@ -646,8 +820,8 @@ void UISystemManager::renderDiagnosticPanel(const GameState& state) {
     int contentY = panelY + 65;
 
     // Mouse state with enhanced styling
-    Color mouseStateColor = state.mouseReleased ? UIDesign::getTextWarning() : UIDesign::getTextHighlight();
-    const char* mouseStateText = state.mouseReleased ? "Mouse: FREE" : "Mouse: CAPTURED";
+    Color mouseStateColor = state.ui.mouseReleased ? UIDesign::getTextWarning() : UIDesign::getTextHighlight();
+    const char* mouseStateText = state.ui.mouseReleased ? "Mouse: FREE" : "Mouse: CAPTURED";
     Vector2 mousePos = {(float)(panelX + UIDesign::getSpacingMedium()), (float)contentY};
     UIDesign::drawStyledText(mouseStateText, mousePos, {UIDesign::getFontSmall().size, mouseStateColor, false, 1.0f});
 
@@ -655,15 +829,15 @@ void UISystemManager::renderDiagnosticPanel(const GameState& state) {
 
     // Game state with enhanced styling
     Color gameStateColor;
-    std::string gameStateText;
+    const char* gameStateText;
 
-    if (state.showEscMenu) {
+    if (state.ui.showEscMenu) {
         gameStateColor = UIDesign::getTextError();
         gameStateText = "Game: PAUSED (ESC Menu)";
-    } else if (state.showInventoryWindow) {
+    } else if (state.ui.showInventoryWindow) {
         gameStateColor = UIDesign::getTextWarning();
         gameStateText = "Game: PAUSED (Inventory)";
-    } else if (state.isInDialog) {
+    } else if (state.dialog.active) {
         gameStateColor = UIDesign::getTextWarning();
         gameStateText = "Game: DIALOG ACTIVE";
     } else {
@@ -675,7 +849,7 @@ void UISystemManager::renderDiagnosticPanel(const GameState& state) {
     UIDesign::drawStyledText(gameStateText, gameStatePos, {UIDesign::getFontSmall().size, gameStateColor, false, 1.0f});
 
     // Add status indicator
-    Color statusIndicatorColor = (state.showEscMenu || state.showInventoryWindow || state.isInDialog) ?
+    Color statusIndicatorColor = (state.ui.showEscMenu || state.ui.showInventoryWindow || state.dialog.active) ?
                                 UIDesign::getTextError() : UIDesign::getTextHighlight();
     DrawCircle((float)(panelX + zone.width - 25), (float)(contentY + 6), 4.0f, statusIndicatorColor);
 
@@ -709,16 +883,16 @@ void UISystemManager::renderTestingStatus(const GameState& state) {
     int contentY = panelY + 22;
 
     // Calculate progress
-    int workingFeatures = (state.testWASDMovement ? 1 : 0) + (state.testSpaceJump ? 1 : 0) +
-                          (state.testMouseLook ? 1 : 0) + (state.testMeleeSwing ? 1 : 0) +
-                          (state.testBuildingEntry ? 1 : 0) + (state.testNPCInteraction ? 1 : 0);
+    int workingFeatures = (state.tests.wasdMovement ? 1 : 0) + (state.tests.spaceJump ? 1 : 0) +
+                          (state.tests.mouseLook ? 1 : 0) + (state.tests.meleeSwing ? 1 : 0) +
+                          (state.tests.buildingEntry ? 1 : 0) + (state.tests.npcInteraction ? 1 : 0);
 
     // Progress with enhanced styling and color coding
     Color progressColor = workingFeatures >= 5 ? UIDesign::getTextHighlight() :
                          (workingFeatures >= 3 ? UIDesign::getTextWarning() : UIDesign::getTextError());
 
     Vector2 progressPos = {(float)(panelX + UIDesign::getSpacingMedium()), (float)contentY};
-    std::string progressText = TextFormat("Progress: %d/6 Features", workingFeatures);
+    const char* progressText = FrameArena::getInstance().format("Progress: %d/6 Features", workingFeatures);
     UIDesign::drawStyledText(progressText, progressPos, {UIDesign::getFontSmall().size, progressColor, false, 1.0f});
 
     contentY += 16;
@@ -740,21 +914,21 @@ void UISystemManager::renderTestingStatus(const GameState& state) {
     int indicatorY = contentY;
 
     // WASD indicator
-    Color wasdColor = state.testWASDMovement ? UIDesign::getTextHighlight() : UIDesign::getTextDisabled();
+    Color wasdColor = state.tests.wasdMovement ? UIDesign::getTextHighlight() : UIDesign::getTextDisabled();
     DrawCircle((float)(panelX + UIDesign::getSpacingMedium() + 2), (float)(indicatorY + 4), 3.0f, wasdColor);
 
     Vector2 wasdPos = {(float)(panelX + UIDesign::getSpacingMedium() + 10), (float)indicatorY};
     UIDesign::drawStyledText("WASD", wasdPos, {UIDesign::getFontTiny().size, wasdColor, false, 1.0f});
 
     // Mouse indicator
-    Color mouseColor = state.testMouseLook ? UIDesign::getTextHighlight() : UIDesign::getTextDisabled();
+    Color mouseColor = state.tests.mouseLook ? UIDesign::getTextHighlight() : UIDesign::getTextDisabled();
     DrawCircle((float)(panelX + 70), (float)(indicatorY + 4), 3.0f, mouseColor);
 
     Vector2 mousePos = {(float)(panelX + 78), (float)indicatorY};
     UIDesign::drawStyledText("Mouse", mousePos, {UIDesign::getFontTiny().size, mouseColor, false, 1.0f});
 
     // Combat indicator
-    Color combatColor = state.testMeleeSwing ? UIDesign::getTextHighlight() : UIDesign::getTextDisabled();
+    Color combatColor = state.tests.meleeSwing ? UIDesign::getTextHighlight() : UIDesign::getTextDisabled();
     DrawCircle((float)(panelX + 120), (float)(indicatorY + 4), 3.0f, combatColor);
 
     Vector2 combatTextPos = {(float)(panelX + 128), (float)indicatorY};
@@ -807,7 +981,8 @@ void UISystemManager::renderDialogModal(const GameState& state) {
     DrawRectangleRec(textAreaBounds, UIDesign::fadeColor(UIDesign::getSecondaryDark(), 0.3f));
 
     Vector2 textPos = {(float)(dialogX + UIDesign::getSpacingLarge()), (float)(dialogY + 55)};
-    UIDesign::drawStyledText(state.dialogText, textPos, UIDesign::getFontBody());
+    const DialogView& view = DialogSystem::getInstance().getView(state);
+    UIDesign::drawStyledText(view.text, textPos, UIDesign::getFontBody());
 
     // **DIALOG OPTIONS** - Enhanced button styling with new design system
     const int buttonY = dialogY + 130;
@@ -818,7 +993,7 @@ void UISystemManager::renderDialogModal(const GameState& state) {
 
     Vector2 mousePos = GetMousePosition();
 
-    for (int i = 0; i < state.numDialogOptions; i++) {
+    for (int i = 0; i < view.optionCount; i++) {
         int buttonX = startX + (i * buttonSpacing);
         Rectangle buttonBounds = {(float)buttonX, (float)buttonY, (float)buttonWidth, (float)buttonHeight};
 
@@ -826,7 +1001,7 @@ void UISystemManager::renderDialogModal(const GameState& state) {
 
         // Use new design system button
         UIDesign::drawStyledButton(UIDesign::getButtonPrimary(), buttonBounds,
-                                  state.dialogOptions[i], isHovered, false);
+                                  view.options[i].data(), isHovered, false);
 
         // Add hover indicator
         if (isHovered) {
@@ -879,6 +1054,69 @@ void hideInventoryComponent() {
     // STUB: Old inventory system disabled
 }
 
+void UISystemManager::drawInventoryChrome(Rectangle inventoryBounds) {
+    int inventoryX = (int)inventoryBounds.x;
+    int inventoryY = (int)inventoryBounds.y;
+    int inventoryWidth = (int)inventoryBounds.width;
+    int labelX = inventoryX + UIDesign::getSpacingLarge();
+
+    // Use new design system for main panel
+    UIDesign::drawStyledPanel(UIDesign::getPanelWindow(), inventoryBounds);
+
+    // Add ornate border decoration
+    UIDesign::drawOrnateBorder(inventoryBounds, UIDesign::getPrimaryAccent(), 2);
+
+    // **INVENTORY TITLE** - Enhanced with new design system
+    Rectangle titleBounds = {(float)inventoryX, (float)inventoryY, (float)inventoryWidth, (float)InventoryRows::TITLE_HEIGHT};
+    DrawRectangleRec(titleBounds, UIDesign::fadeColor(UIDesign::getPrimaryAccent(), 0.9f));
+    DrawRectangleLinesEx(titleBounds, UIDesign::getBorderThin(), UIDesign::getPrimaryLight());
+
+    Vector2 titlePos = {(float)labelX, (float)(inventoryY + UIDesign::getSpacingMedium())};
+    UIDesign::drawStyledText("Adventurer's Inventory", titlePos, UIDesign::getFontTitle());
+
+    // Add decorative runes to title
+    UIDesign::drawRuneDecoration({(float)(inventoryX + 20), (float)(inventoryY + 10)}, 8.0f, UIDesign::getPrimaryLight());
+    UIDesign::drawRuneDecoration({(float)(inventoryX + inventoryWidth - 30), (float)(inventoryY + 10)}, 8.0f, UIDesign::getPrimaryLight());
+
+    // **INVENTORY STATS** background; the numbers are drawn live
+    Rectangle statsBounds = {(float)labelX, (float)(inventoryY + InventoryRows::STATS),
+                           (float)(inventoryWidth - 2 * UIDesign::getSpacingLarge()), 30.0f};
+    DrawRectangleRec(statsBounds, UIDesign::fadeColor(UIDesign::getSecondaryDark(), 0.3f));
+
+    UIDesign::drawStyledText("Sort by:", {(float)labelX, (float)(inventoryY + InventoryRows::SORT_LABEL)}, UIDesign::getFontSmall());
+
+    // **SEARCH/FILTER SECTION**
+    UIDesign::drawStyledText("Search:", {(float)labelX, (float)(inventoryY + InventoryRows::SEARCH_LABEL)}, UIDesign::getFontSmall());
+
+    Rectangle searchBoxBounds = {(float)labelX, (float)(inventoryY + InventoryRows::SEARCH_BOX),
+                                (float)InventoryRows::SEARCH_BOX_WIDTH, (float)InventoryRows::SEARCH_BOX_HEIGHT};
+    DrawRectangleRec(searchBoxBounds, UIDesign::fadeColor(UIDesign::getSecondaryDark(), 0.4f));
+    DrawRectangleLinesEx(searchBoxBounds, 1.0f, UIDesign::getSecondaryLight());
+
+    // Search placeholder text
+    Vector2 searchTextPos = {(float)(labelX + 5), (float)(inventoryY + InventoryRows::SEARCH_BOX + 2)};
+    UIDesign::drawStyledText("Type to search items...", searchTextPos, UIDesign::getFontSmall());
+
+    // **FILTER TIPS** - Show helpful filtering information
+    UIDesign::drawStyledText("Quick Search Tips:", {(float)labelX, (float)(inventoryY + InventoryRows::TIPS_TITLE)}, UIDesign::getFontSmall());
+    UIDesign::drawStyledText("Try: 'sword', 'potion', 'rare', 'common', 'quest'",
+                             {(float)labelX, (float)(inventoryY + InventoryRows::TIPS)}, UIDesign::getFontTiny());
+
+    // **EQUIPPED ITEMS SECTION** - Empty slot rows
+    UIDesign::drawStyledText("Equipped Items:", {(float)labelX, (float)(inventoryY + InventoryRows::EQUIPPED_LABEL)}, UIDesign::getFontBody());
+    for (const auto& slot : equippedSlotsNode_->getChildren()) {
+        Rectangle slotBounds = slot->getBounds();
+        DrawRectangleRec(slotBounds, UIDesign::fadeColor(UIDesign::getSecondaryDark(), 0.3f));
+        DrawRectangleLinesEx(slotBounds, 1.0f, UIDesign::getSecondaryLight());
+    }
+
+    // **INVENTORY ITEMS GRID** - List background
+    UIDesign::drawStyledText("Inventory Items:", {(float)labelX, (float)(inventoryY + InventoryRows::ITEMS_LABEL)}, UIDesign::getFontBody());
+    Rectangle itemsAreaBounds = itemRowsNode_->getBounds();
+    DrawRectangleRec(itemsAreaBounds, UIDesign::fadeColor(UIDesign::getSecondaryDark(), 0.2f));
+    DrawRectangleLinesEx(itemsAreaBounds, 1.0f, UIDesign::getSecondaryLight());
+}
+
 void UISystemManager::renderInventoryModal(const GameState& state) {
     std::cout << "DEBUG: Rendering inventory modal through UI system" << std::endl;
 
@@ -909,63 +1147,38 @@ void UISystemManager::renderInventoryModal(const GameState& state) {
     // **FULL-SCREEN MODAL** - Dark overlay for focus
     DrawRectangle(0, 0, screenWidth_, screenHeight_, Fade(BLACK, 0.7f));
 
-    // **CENTERED INVENTORY WINDOW** - Enhanced with new design system
-    int inventoryWidth = 700;
-    int inventoryHeight = 500;
-    int inventoryX = (screenWidth_ - inventoryWidth) / 2;
-    int inventoryY = (screenHeight_ - inventoryHeight) / 2;
+    // **CENTERED INVENTORY WINDOW** - Frame, labels and empty slots come from the panel cache
+    Rectangle inventoryBounds = inventoryWindowNode_->getBounds();
+    int inventoryWidth = (int)inventoryBounds.width;
+    int inventoryHeight = (int)inventoryBounds.height;
+    int inventoryX = (int)inventoryBounds.x;
+    int inventoryY = (int)inventoryBounds.y;
 
-    // Use new design system for main panel
-    Rectangle inventoryBounds = {(float)inventoryX, (float)inventoryY, (float)inventoryWidth, (float)inventoryHeight};
-    UIDesign::drawStyledPanel(UIDesign::getPanelWindow(), inventoryBounds);
-
-    // Add ornate border decoration
-    UIDesign::drawOrnateBorder(inventoryBounds, UIDesign::getPrimaryAccent(), 2);
-
-    // **INVENTORY TITLE** - Enhanced with new design system
-    Rectangle titleBounds = {(float)inventoryX, (float)inventoryY, (float)inventoryWidth, 35.0f};
-    DrawRectangleRec(titleBounds, UIDesign::fadeColor(UIDesign::getPrimaryAccent(), 0.9f));
-    DrawRectangleLinesEx(titleBounds, UIDesign::getBorderThin(), UIDesign::getPrimaryLight());
-
-    Vector2 titlePos = {(float)(inventoryX + UIDesign::getSpacingLarge()), (float)(inventoryY + UIDesign::getSpacingMedium())};
-    UIDesign::drawStyledText("Adventurer's Inventory", titlePos, UIDesign::getFontTitle());
-
-    // Add decorative runes to title
-    UIDesign::drawRuneDecoration({(float)(inventoryX + 20), (float)(inventoryY + 10)}, 8.0f, UIDesign::getPrimaryLight());
-    UIDesign::drawRuneDecoration({(float)(inventoryX + inventoryWidth - 30), (float)(inventoryY + 10)}, 8.0f, UIDesign::getPrimaryLight());
+    Rectangle chromeBounds = inventoryBounds;
+    chromeBounds.height = std::max(chromeBounds.height, (float)InventoryRows::listBottom());  // The item list runs past the frame
+    panelCache_.draw(CachedPanel::INVENTORY_CHROME, chromeBounds, [&]() { drawInventoryChrome(inventoryBounds); });
 
     // **INVENTORY STATS** - Weight and slots
-    int contentY = inventoryY + 40;
-    Rectangle statsBounds = {(float)(inventoryX + UIDesign::getSpacingLarge()), (float)contentY,
-                           (float)(inventoryWidth - 2 * UIDesign::getSpacingLarge()), 30.0f};
-    DrawRectangleRec(statsBounds, UIDesign::fadeColor(UIDesign::getSecondaryDark(), 0.3f));
-
+    int contentY = inventoryY + InventoryRows::STATS;
     auto& inventory = state.inventorySystem->getInventory();
-    std::string statsText = TextFormat("Weight: %.1f/%.1f kg | Slots: %d/%d | Gold: %d",
+    const char* statsText = FrameArena::getInstance().format("Weight: %.1f/%.1f kg | Slots: %d/%d | Gold: %d",
                                      inventory.getCurrentWeight(), inventory.getMaxWeight(),
                                      inventory.getUsedSlots(), inventory.getMaxSlots(),
                                      inventory.getItemQuantity("Gold Septim"));
     Vector2 statsPos = {(float)(inventoryX + UIDesign::getSpacingLarge()), (float)contentY + UIDesign::getSpacingSmall()};
     UIDesign::drawStyledText(statsText, statsPos, UIDesign::getFontSmall());
 
-    contentY += 35;
-
     // **SORTING BUTTONS** - Add sorting functionality
-    Vector2 sortTitlePos = {(float)(inventoryX + UIDesign::getSpacingLarge()), (float)contentY};
-    UIDesign::drawStyledText("Sort by:", sortTitlePos, UIDesign::getFontSmall());
-    contentY += 20;
-
-    // Sort buttons row
-    const char* sortOptions[] = {"Name", "Type", "Value", "Weight", "Rarity"};
+    const char* sortOptions[InventoryRows::SORT_OPTION_COUNT] = {"Name", "Type", "Value", "Weight", "Rarity"};
     Vector2 mousePos = GetMousePosition();
-    const int buttonWidth = 80;
-    const int buttonHeight = 25;
-    const int buttonSpacing = 85;
-    int startX = inventoryX + UIDesign::getSpacingLarge();
+    const auto& sortButtons = sortButtonsNode_->getChildren();
 
-    for (int i = 0; i < 5; i++) {
-        int buttonX = startX + (i * buttonSpacing);
-        Rectangle buttonBounds = {(float)buttonX, (float)contentY, (float)buttonWidth, (float)buttonHeight};
+    for (int i = 0; i < InventoryRows::SORT_OPTION_COUNT; i++) {
+        Rectangle buttonBounds = sortButtons[i]->getBounds();
+        int buttonX = (int)buttonBounds.x;
+        int buttonY = (int)buttonBounds.y;
+        int buttonWidth = (int)buttonBounds.width;
+        int buttonHeight = (int)buttonBounds.height;
 
         bool isHovered = UIDesign::isPointInRect(mousePos, buttonBounds);
         bool isPressed = isHovered && IsMouseButtonPressed(MOUSE_BUTTON_LEFT);
@@ -987,62 +1200,27 @@ void UISystemManager::renderInventoryModal(const GameState& state) {
         DrawRectangleRec(buttonBounds, buttonColor);
         DrawRectangleLinesEx(buttonBounds, 1.0f, UIDesign::getSecondaryLight());
 
-        Vector2 textPos = {(float)(buttonX + buttonWidth/2 - MeasureText(sortOptions[i], UIDesign::getFontSmall().size)/2),
-                          (float)(contentY + buttonHeight/2 - UIDesign::getFontSmall().size/2)};
+        Vector2 textPos = {(float)(buttonX + buttonWidth/2 - measureDefaultText(sortOptions[i], UIDesign::getFontSmall().size)/2),
+                          (float)(buttonY + buttonHeight/2 - UIDesign::getFontSmall().size/2)};
         UIDesign::drawStyledText(sortOptions[i], textPos, UIDesign::getFontSmall());
     }
 
-    contentY += 35;
-
-    // **SEARCH/FILTER SECTION**
-    Vector2 searchTitlePos = {(float)(inventoryX + UIDesign::getSpacingLarge()), (float)contentY};
-    UIDesign::drawStyledText("Search:", searchTitlePos, UIDesign::getFontSmall());
-    contentY += 20;
-
-    // Search input box
-    const int searchBoxWidth = 300;
-    const int searchBoxHeight = 25;
-    Rectangle searchBoxBounds = {(float)(inventoryX + UIDesign::getSpacingLarge()), (float)contentY,
-                                (float)searchBoxWidth, (float)searchBoxHeight};
-
-    // Draw search box
-    DrawRectangleRec(searchBoxBounds, UIDesign::fadeColor(UIDesign::getSecondaryDark(), 0.4f));
-    DrawRectangleLinesEx(searchBoxBounds, 1.0f, UIDesign::getSecondaryLight());
-
-    // Search placeholder text
-    std::string searchText = "Type to search items...";
-    Vector2 searchTextPos = {(float)(inventoryX + UIDesign::getSpacingLarge() + 5), (float)(contentY + 2)};
-    UIDesign::drawStyledText(searchText, searchTextPos, UIDesign::getFontSmall());
-
-    // Clear search button
-    Rectangle clearButtonBounds = {(float)(inventoryX + UIDesign::getSpacingLarge() + searchBoxWidth + 10), (float)contentY,
-                                  60.0f, (float)searchBoxHeight};
+    // **SEARCH/FILTER SECTION** - Clear button; the search box itself is chrome
+    contentY = inventoryY + InventoryRows::SEARCH_BOX;
+    Rectangle clearButtonBounds = {(float)(inventoryX + UIDesign::getSpacingLarge() + InventoryRows::SEARCH_BOX_WIDTH + 10), (float)contentY,
+                                  60.0f, (float)InventoryRows::SEARCH_BOX_HEIGHT};
     bool clearHovered = UIDesign::isPointInRect(mousePos, clearButtonBounds);
 
     DrawRectangleRec(clearButtonBounds, clearHovered ? UIDesign::getButtonSecondary().hoverColor :
                        UIDesign::getButtonSecondary().backgroundColor);
     DrawRectangleLinesEx(clearButtonBounds, 1.0f, UIDesign::getSecondaryLight());
 
-    Vector2 clearTextPos = {(float)(inventoryX + UIDesign::getSpacingLarge() + searchBoxWidth + 15),
-                           (float)(contentY + searchBoxHeight/2 - UIDesign::getFontSmall().size/2)};
+    Vector2 clearTextPos = {(float)(inventoryX + UIDesign::getSpacingLarge() + InventoryRows::SEARCH_BOX_WIDTH + 15),
+                           (float)(contentY + InventoryRows::SEARCH_BOX_HEIGHT/2 - UIDesign::getFontSmall().size/2)};
     UIDesign::drawStyledText("Clear", clearTextPos, UIDesign::getFontSmall());
 
-    contentY += 35;
-
-    // **FILTER TIPS** - Show helpful filtering information
-    Vector2 filterTitlePos = {(float)(inventoryX + UIDesign::getSpacingLarge()), (float)contentY};
-    UIDesign::drawStyledText("Quick Search Tips:", filterTitlePos, UIDesign::getFontSmall());
-    contentY += 18;
-
-    const char* filterTips[] = {"Try: 'sword', 'potion', 'rare', 'common', 'quest'"};
-    Vector2 filterTipsPos = {(float)(inventoryX + UIDesign::getSpacingLarge()), (float)contentY};
-    UIDesign::drawStyledText(filterTips[0], filterTipsPos, UIDesign::getFontTiny());
-    contentY += 25;
-
     // **EQUIPPED ITEMS SECTION**
-    Vector2 equippedTitlePos = {(float)(inventoryX + UIDesign::getSpacingLarge()), (float)contentY};
-    UIDesign::drawStyledText("Equipped Items:", equippedTitlePos, UIDesign::getFontBody());
-    contentY += 20;
+    const auto& slotRows = equippedSlotsNode_->getChildren();
 
     // Show equipped items with enhanced visualization and safety checks
     auto& equipment = state.inventorySystem->getEquipment();
@@ -1059,49 +1237,31 @@ void UISystemManager::renderInventoryModal(const GameState& state) {
         std::cout << "INVENTORY ERROR: Unknown error accessing equipment system" << std::endl;
         // Continue with empty equipment display
     }
-    const EquipmentSlot slotsToShow[] = {EquipmentSlot::MAIN_HAND, EquipmentSlot::OFF_HAND, EquipmentSlot::HEAD,
-                                        EquipmentSlot::CHEST, EquipmentSlot::LEGS, EquipmentSlot::FEET};
 
     int equippedCount = 0;
 
-    for (EquipmentSlot slot : slotsToShow) {
-        if (equippedCount >= 6) break;  // Limit display to prevent overflow
-
+    for (EquipmentSlot slot : InventoryRows::EQUIPPED_SLOT_ORDER) {
         auto item = equipment.getEquippedItem(slot);
-        int slotY = contentY + (equippedCount * 20);
-
-        // Draw slot background with safety checks
-        try {
-            Rectangle slotBounds = {(float)(inventoryX + UIDesign::getSpacingXLarge()), (float)slotY,
-                                   (float)(inventoryWidth - 2 * UIDesign::getSpacingXLarge() - 20), 18.0f};
-            DrawRectangleRec(slotBounds, UIDesign::fadeColor(UIDesign::getSecondaryDark(), 0.3f));
-            DrawRectangleLinesEx(slotBounds, 1.0f, UIDesign::getSecondaryLight());
-        } catch (...) {
-            // Fallback to basic rectangle if theme system fails
-            Rectangle slotBounds = {(float)(inventoryX + 20), (float)slotY, (float)(inventoryWidth - 40), 18.0f};
-            DrawRectangleRec(slotBounds, Fade(DARKGRAY, 0.3f));
-            DrawRectangleLinesEx(slotBounds, 1.0f, GRAY);
-        }
+        int slotY = (int)slotRows[equippedCount]->getBounds().y;
 
         // Slot icon/indicator with safety
-        std::string slotIndicator = "[";
+        const char* slotIndicator;
         switch (slot) {
-            case EquipmentSlot::MAIN_HAND: slotIndicator += "⚔️"; break;
-            case EquipmentSlot::OFF_HAND: slotIndicator += "🛡️"; break;
-            case EquipmentSlot::HEAD: slotIndicator += "👑"; break;
-            case EquipmentSlot::CHEST: slotIndicator += "🦺"; break;
-            case EquipmentSlot::LEGS: slotIndicator += "👖"; break;
-            case EquipmentSlot::FEET: slotIndicator += "👢"; break;
-            default: slotIndicator += "❓"; break;
+            case EquipmentSlot::MAIN_HAND: slotIndicator = "[⚔️]"; break;
+            case EquipmentSlot::OFF_HAND: slotIndicator = "[🛡️]"; break;
+            case EquipmentSlot::HEAD: slotIndicator = "[👑]"; break;
+            case EquipmentSlot::CHEST: slotIndicator = "[🦺]"; break;
+            case EquipmentSlot::LEGS: slotIndicator = "[👖]"; break;
+            case EquipmentSlot::FEET: slotIndicator = "[👢]"; break;
+            default: slotIndicator = "[❓]"; break;
         }
-        slotIndicator += "]";
 
         try {
             Vector2 indicatorPos = {(float)(inventoryX + UIDesign::getSpacingXLarge() + 5), (float)slotY + 1};
             UIDesign::drawStyledText(slotIndicator, indicatorPos, UIDesign::getFontSmall());
         } catch (...) {
             // Fallback to basic text if theme system fails
-            DrawText(slotIndicator.c_str(), inventoryX + 25, slotY + 1, 12, WHITE);
+            DrawText(slotIndicator, inventoryX + 25, slotY + 1, 12, WHITE);
         }
 
         if (item) {
@@ -1130,27 +1290,30 @@ void UISystemManager::renderInventoryModal(const GameState& state) {
             }
 
             Vector2 itemPos = {(float)(inventoryX + UIDesign::getSpacingXLarge() + 30), (float)slotY + 1};
-            std::string itemName = item->getDisplayName();
+            FrameString itemName = makeFrameString();
+            item->writeDisplayName(itemName);
             if (itemName.length() > 25) {
-                itemName = itemName.substr(0, 22) + "...";
+                itemName.resize(22);
+                itemName += "...";
             }
 
-            // Use DrawTextEx for colored text
-            DrawTextEx(GetFontDefault(), itemName.c_str(), itemPos, UIDesign::getFontSmall().size, 1.0f, itemColor);
+            // Colored text at the small font size
+            TextLayoutCache::getInstance().draw(GetFontDefault(), itemName.c_str(), itemPos, UIDesign::getFontSmall().size, 1.0f, itemColor);
 
             // Show item stats briefly
-            std::string statText = "";
-            if (item->getStats().damage > 0) statText += TextFormat("+%d DMG ", item->getStats().damage);
-            if (item->getStats().armor > 0) statText += TextFormat("+%d ARM ", item->getStats().armor);
-            if (item->getStats().health > 0) statText += TextFormat("+%d HP ", item->getStats().health);
+            FrameString statText = makeFrameString();
+            if (item->getStats().damage > 0) appendFormat(statText, "+%d DMG ", item->getStats().damage);
+            if (item->getStats().armor > 0) appendFormat(statText, "+%d ARM ", item->getStats().armor);
+            if (item->getStats().health > 0) appendFormat(statText, "+%d HP ", item->getStats().health);
 
             if (!statText.empty() && statText.length() > 30) {
-                statText = statText.substr(0, 27) + "...";
+                statText.resize(27);
+                statText += "...";
             }
 
             if (!statText.empty()) {
                 Vector2 statPos = {(float)(inventoryX + inventoryWidth - 180), (float)slotY + 1};
-                UIDesign::drawStyledText(statText, statPos, UIDesign::getFontTiny());
+                UIDesign::drawStyledText(statText.c_str(), statPos, UIDesign::getFontTiny());
             }
 
             // Durability indicator
@@ -1175,57 +1338,39 @@ void UISystemManager::renderInventoryModal(const GameState& state) {
         equippedCount++;
     }
 
-    contentY += (equippedCount * 20) + 10;
+    // **INVENTORY ITEMS GRID** - Row rectangles come from the layout tree
+    const auto& itemRows = itemRowsNode_->getChildren();
+    contentY = (int)itemRowsNode_->getBounds().y;
+    const int itemHeight = InventoryRows::ITEM_HEIGHT;
+    const int maxVisibleItems = (int)itemRows.size();
 
-    // **INVENTORY ITEMS GRID**
-    Vector2 itemsTitlePos = {(float)(inventoryX + UIDesign::getSpacingLarge()), (float)contentY};
-    UIDesign::drawStyledText("Inventory Items:", itemsTitlePos, UIDesign::getFontBody());
-    contentY += 20;
+    // Display order (sorted, filtered by search if active) as indices; nothing is copied
+    const auto& allItems = inventory.getAllItems();
+    const std::vector<uint32_t>& view = inventory.getView(
+        state.ui.inventorySearchActive ? state.ui.inventorySearchQuery : std::string());
 
-    // Items list area
-    const int itemHeight = 20;
-    const int maxVisibleItems = 12;
+    // **VIRTUALIZED LIST** - Only the rows that fit are touched, however many items there are
+    // (MenuSystem scrolls; the view can shrink under it, so clamp here too)
+    int maxScrollRow = std::max(0, (int)view.size() - maxVisibleItems);
+    size_t firstRow = (size_t)std::clamp(state.ui.inventoryScrollRow, 0, maxScrollRow);
+    size_t visibleRows = std::min(view.size() - firstRow, (size_t)maxVisibleItems);
 
-    // Draw items background
-    Rectangle itemsAreaBounds = {(float)(inventoryX + UIDesign::getSpacingLarge()), (float)contentY,
-                               (float)(inventoryWidth - 2 * UIDesign::getSpacingLarge()),
-                               (float)(maxVisibleItems * itemHeight)};
-    DrawRectangleRec(itemsAreaBounds, UIDesign::fadeColor(UIDesign::getSecondaryDark(), 0.2f));
-    DrawRectangleLinesEx(itemsAreaBounds, 1.0f, UIDesign::getSecondaryLight());
-
-    // Get items (filtered by search if active) with safety checks
-    std::vector<std::shared_ptr<MysticalItem>> items;
-    try {
-        items = state.inventorySearchActive && !state.inventorySearchQuery.empty() ?
-                inventory.searchItems(state.inventorySearchQuery) :
-                inventory.getAllItems();
-    } catch (const std::exception& e) {
-        std::cout << "INVENTORY ERROR: Failed to get inventory items: " << e.what() << std::endl;
-        items.clear(); // Use empty list as fallback
-    } catch (...) {
-        std::cout << "INVENTORY ERROR: Unknown error getting inventory items" << std::endl;
-        items.clear(); // Use empty list as fallback
-    }
-
-    int displayCount = 0;
-
-    for (size_t i = 0; i < items.size() && displayCount < maxVisibleItems; ++i) {
-        auto& item = items[i];
+    for (size_t row = 0; row < visibleRows; ++row) {
+        const auto& item = allItems[view[firstRow + row]];
 
         // **SAFETY CHECK** - Ensure item is valid
         if (!item) {
-            std::cout << "INVENTORY WARNING: Null item found in inventory at index " << (int)i << std::endl;
+            std::cout << "INVENTORY WARNING: Null item found in inventory at index " << (int)view[firstRow + row] << std::endl;
             continue;
         }
-        int itemY = contentY + (displayCount * itemHeight);
+        Rectangle itemBounds = itemRows[row]->getBounds();
+        int itemY = (int)itemBounds.y;
 
         // Check for hover state
-        Rectangle itemBounds = {(float)(inventoryX + UIDesign::getSpacingLarge()), (float)itemY,
-                               (float)(inventoryWidth - 2 * UIDesign::getSpacingLarge()), (float)itemHeight};
         bool isHovered = UIDesign::isPointInRect(mousePos, itemBounds);
 
         // Enhanced visual feedback for different states
-        if (state.lastClickedItem == item->getName()) {
+        if (state.ui.lastClickedItem == item->getName()) {
             // Selected item - bright highlight
             Rectangle highlightBounds = {(float)(inventoryX + UIDesign::getSpacingLarge()), (float)itemY,
                                        (float)(inventoryWidth - 2 * UIDesign::getSpacingLarge()), (float)itemHeight};
@@ -1252,7 +1397,7 @@ void UISystemManager::renderInventoryModal(const GameState& state) {
 
             // Add click hint for equippable items
             if (item->isEquippable()) {
-                std::string hintText = "Click to equip";
+                const char* hintText = "Click to equip";
                 Vector2 hintPos = {(float)(inventoryX + inventoryWidth - 120), (float)(itemY + itemHeight/2 - UIDesign::getFontTiny().size/2)};
                 UIDesign::drawStyledText(hintText, hintPos, UIDesign::getFontTiny());
             }
@@ -1270,49 +1415,53 @@ void UISystemManager::renderInventoryModal(const GameState& state) {
         }
 
         Vector2 itemPos = {(float)(inventoryX + UIDesign::getSpacingXLarge()), (float)itemY + 2};
-        std::string itemName = item->getDisplayName();
+        FrameString itemName = makeFrameString();
+        item->writeDisplayName(itemName);
         if (itemName.length() > 30) {
-            itemName = itemName.substr(0, 27) + "...";
+            itemName.resize(27);
+            itemName += "...";
         }
 
         // Use enhanced text rendering with color
-        DrawTextEx(GetFontDefault(), itemName.c_str(), itemPos, UIDesign::getFontSmall().size, 1.0f, itemColor);
+        TextLayoutCache::getInstance().draw(GetFontDefault(), itemName.c_str(), itemPos, UIDesign::getFontSmall().size, 1.0f, itemColor);
 
         // Item weight and value
-        std::string itemStats = TextFormat("%.1fkg | %d gold", item->getWeight(), item->getValue());
+        const char* itemStats = FrameArena::getInstance().format("%.1fkg | %d gold", item->getWeight(), item->getValue());
         Vector2 statsPos = {(float)(inventoryX + inventoryWidth - 150), (float)itemY + 2};
         UIDesign::drawStyledText(itemStats, statsPos, UIDesign::getFontTiny());
-
-        displayCount++;
     }
 
     // Show message if no items
-    if (items.empty()) {
+    if (view.empty()) {
         Vector2 noItemsPos = {(float)(inventoryX + inventoryWidth/2 - 60), (float)(contentY + 50)};
         UIDesign::drawStyledText("No items in inventory", noItemsPos, UIDesign::getFontSmall());
     }
 
     // **TOOLTIP SYSTEM** - Show item details on hover
     bool showTooltip = false;
-    std::string tooltipText = "";
-
-    // Check if mouse is hovering over any item
-    for (size_t i = 0; i < items.size() && i < (size_t)maxVisibleItems; ++i) {
-        auto& item = items[i];
-        int itemY = contentY + ((int)i * itemHeight);
-        Rectangle itemBounds = {(float)(inventoryX + UIDesign::getSpacingLarge()), (float)itemY,
-                               (float)(inventoryWidth - 2 * UIDesign::getSpacingLarge()), (float)itemHeight};
+    FrameString tooltipText = makeFrameString();
 
-        if (UIDesign::isPointInRect(mousePos, itemBounds)) {
+    // Check if mouse is hovering over any visible item
+    for (size_t row = 0; row < visibleRows; ++row) {
+        const auto& item = allItems[view[firstRow + row]];
+        if (item && UIDesign::isPointInRect(mousePos, itemRows[row]->getBounds())) {
             showTooltip = true;
-            tooltipText = item->getTooltip();
+            item->writeTooltip(tooltipText);
             break;
         }
     }
 
+    // Scroll position when the list doesn't fit
+    if (maxScrollRow > 0) {
+        const char* rangeText = FrameArena::getInstance().format("%d-%d of %d", (int)firstRow + 1, (int)(firstRow + visibleRows), (int)view.size());
+        Rectangle itemsArea = itemRowsNode_->getBounds();
+        Vector2 rangePos = {itemsArea.x + itemsArea.width - 90, itemsArea.y + itemsArea.height + 2};
+        UIDesign::drawStyledText(rangeText, rangePos, UIDesign::getFontTiny());
+    }
+
     // Show search results count if searching
-    if (state.inventorySearchActive && !state.inventorySearchQuery.empty()) {
-        std::string resultText = TextFormat("Search Results: %d items found", (int)items.size());
+    if (state.ui.inventorySearchActive && !state.ui.inventorySearchQuery.empty()) {
+        const char* resultText = FrameArena::getInstance().format("Search Results: %d items found", (int)view.size());
         Vector2 resultPos = {(float)(inventoryX + UIDesign::getSpacingLarge()), (float)(contentY - 25)};
         UIDesign::drawStyledText(resultText, resultPos, UIDesign::getFontSmall());
     }
@@ -1320,7 +1469,7 @@ void UISystemManager::renderInventoryModal(const GameState& state) {
     // Render tooltip if hovering
     if (showTooltip) {
         Vector2 tooltipPos = {mousePos.x + 15, mousePos.y + 15};
-        UIDesign::drawStyledTooltip(tooltipText, tooltipPos, 300);
+        UIDesign::drawStyledTooltip(tooltipText.c_str(), tooltipPos, 300);
     }
 
     // **INVENTORY CONTROLS HELP**
@@ -1391,13 +1540,13 @@ void UISystemManager::renderEnhancedEscMenu(GameState& state) {
 
         if (UIDesign::isPointInRect(mousePos, optionBounds)) {
             hoveredOption = i;
-            state.selectedMenuOption = i;
+            state.ui.selectedMenuOption = i;
             break;
         }
     }
 
     for (int i = 0; i < 4; i++) {
-        bool isSelected = (i == state.selectedMenuOption);
+        bool isSelected = (i == state.ui.selectedMenuOption);
         Rectangle optionBounds = {(float)(menuX + UIDesign::getSpacingXLarge()), (float)(optionY + i * optionSpacing),
                                  (float)(menuWidth - 2 * UIDesign::getSpacingXLarge()), 45.0f};
 
@@ -1507,7 +1656,7 @@ bool UISystemManager::isZoneOccupied(UIZone zone) const {
 
 // ===== DETAILED TESTING PANEL (TAB TOGGLE) =====
 
-void UISystemManager::renderDetailedTestingPanel(const GameState& state, const std::string& locationText, Color locationColor) {
+void UISystemManager::renderDetailedTestingPanel(const GameState& state, const char* locationText, Color locationColor) {
     // **FULL-SCREEN MODAL** - Dark overlay for focus using design system
     DrawRectangle(0, 0, screenWidth_, screenHeight_, Fade(UIDesign::getPrimaryDark(), 0.7f));
 
@@ -1548,16 +1697,16 @@ void UISystemManager::renderDetailedTestingPanel(const GameState& state, const s
     // Test items with status colors
     auto drawTestItem = [&](const char* label, bool tested, const char* testText, const char* untestedText) {
         Color statusColor = tested ? UIDesign::getTextHighlight() : UIDesign::getTextWarning();
-        std::string text = tested ? std::string(label) + ": " + testText : std::string(label) + ": " + untestedText;
+        const char* text = FrameArena::getInstance().format("%s: %s", label, tested ? testText : untestedText);
         Vector2 itemPos = {(float)(panelX + UIDesign::getSpacingLarge()), (float)yOffset};
         UIDesign::drawStyledText(text, itemPos, {UIDesign::getFontSmall().size, statusColor, false, 1.0f});
         yOffset += 18;
     };
 
-    drawTestItem("Mouse Capture", state.testMouseCaptured, "WORKING", "BROKEN");
-    drawTestItem("WASD Movement", state.testWASDMovement, "TESTED", "TEST W/A/S/D KEYS");
-    drawTestItem("Space Jump", state.testSpaceJump, "TESTED", "TEST SPACE KEY");
-    drawTestItem("Mouse Look", state.testMouseLook, "TESTED", "TEST MOUSE MOVEMENT");
+    drawTestItem("Mouse Capture", state.tests.mouseCaptured, "WORKING", "BROKEN");
+    drawTestItem("WASD Movement", state.tests.wasdMovement, "TESTED", "TEST W/A/S/D KEYS");
+    drawTestItem("Space Jump", state.tests.spaceJump, "TESTED", "TEST SPACE KEY");
+    drawTestItem("Mouse Look", state.tests.mouseLook, "TESTED", "TEST MOUSE MOVEMENT");
 
     yOffset += 10;
 
@@ -1571,8 +1720,8 @@ void UISystemManager::renderDetailedTestingPanel(const GameState& state, const s
                   UIDesign::fadeColor(UIDesign::getHealthColor(), 0.6f));
     yOffset += 30;
 
-    drawTestItem("Melee Attack", state.testMeleeSwing, "TESTED", "TEST LEFT MOUSE CLICK");
-    drawTestItem("Hit Detection", state.testMeleeHitDetection, "TESTED", "HIT TARGETS WITH ATTACKS");
+    drawTestItem("Melee Attack", state.tests.meleeSwing, "TESTED", "TEST LEFT MOUSE CLICK");
+    drawTestItem("Hit Detection", state.tests.meleeHitDetection, "TESTED", "HIT TARGETS WITH ATTACKS");
 
     yOffset += 10;
 
@@ -1586,8 +1735,8 @@ void UISystemManager::renderDetailedTestingPanel(const GameState& state, const s
                   UIDesign::fadeColor(UIDesign::getManaColor(), 0.6f));
     yOffset += 30;
 
-    drawTestItem("Building Entry", state.testBuildingEntry, "TESTED", "OPEN A DOOR - WALK TO BUILDING");
-    drawTestItem("NPC Dialog", state.testNPCInteraction, "TESTED", "TALK TO AN NPC - PRESS E");
+    drawTestItem("Building Entry", state.tests.buildingEntry, "TESTED", "OPEN A DOOR - WALK TO BUILDING");
+    drawTestItem("NPC Dialog", state.tests.npcInteraction, "TESTED", "TALK TO AN NPC - PRESS E");
 
     yOffset += 10;
 
@@ -1602,21 +1751,21 @@ void UISystemManager::renderDetailedTestingPanel(const GameState& state, const s
     yOffset += 30;
 
     // Mouse state with dynamic color
-    Color mouseStateColor = state.mouseReleased ? UIDesign::getTextWarning() : UIDesign::getTextHighlight();
-    std::string mouseText = "Mouse State: " + std::string(state.mouseReleased ? "FREE" : "CAPTURED");
+    Color mouseStateColor = state.ui.mouseReleased ? UIDesign::getTextWarning() : UIDesign::getTextHighlight();
+    const char* mouseText = state.ui.mouseReleased ? "Mouse State: FREE" : "Mouse State: CAPTURED";
     Vector2 mousePos = {(float)(panelX + UIDesign::getSpacingLarge()), (float)yOffset};
     UIDesign::drawStyledText(mouseText, mousePos, {UIDesign::getFontSmall().size, mouseStateColor, false, 1.0f});
     yOffset += 18;
 
     // Location display
-    std::string locationDisplayText = "Location: " + locationText;
+    const char* locationDisplayText = FrameArena::getInstance().format("Location: %s", locationText);
     Vector2 locationPos = {(float)(panelX + UIDesign::getSpacingLarge()), (float)yOffset};
     UIDesign::drawStyledText(locationDisplayText, locationPos, {UIDesign::getFontSmall().size, locationColor, false, 1.0f});
     yOffset += 18;
 
     // Dialog status
-    Color dialogColor = state.isInDialog ? UIDesign::getTextHighlight() : UIDesign::getTextSubtle();
-    std::string dialogText = "Dialog: " + std::string(state.isInDialog ? "ACTIVE" : "INACTIVE");
+    Color dialogColor = state.dialog.active ? UIDesign::getTextHighlight() : UIDesign::getTextSubtle();
+    const char* dialogText = state.dialog.active ? "Dialog: ACTIVE" : "Dialog: INACTIVE";
     Vector2 dialogPos = {(float)(panelX + UIDesign::getSpacingLarge()), (float)yOffset};
     UIDesign::drawStyledText(dialogText, dialogPos, {UIDesign::getFontSmall().size, dialogColor, false, 1.0f});
     yOffset += 25;
@@ -5,6 +5,10 @@
 #include "raylib.h"
 #include "game_state.h"
 #include "inventory.h"
+#include "ui_panel_cache.h"
+#include "ui_layout.h"
+#include <array>
+#include <memory>
 #include <string>
 #include <map>
 #include <vector>
@@ -281,10 +285,19 @@ inline ButtonStyle getButtonSecondary() {
 
 // Enhanced drawing functions with consistent styling
 void drawStyledPanel(const PanelStyle& style, Rectangle bounds);
-void drawStyledButton(const ButtonStyle& style, Rectangle bounds, const std::string& text, bool isHovered = false, bool isPressed = false);
+void drawStyledButton(const ButtonStyle& style, Rectangle bounds, const char* text, bool isHovered = false, bool isPressed = false);
 void drawStyledProgressBar(const ProgressBarStyle& style, Rectangle bounds, float progress, const std::string& label = "");
-void drawStyledText(const std::string& text, Vector2 position, const FontStyle& style);
-void drawStyledTooltip(const std::string& text, Vector2 position, int maxWidth = 250);
+void drawStyledText(const char* text, Vector2 position, const FontStyle& style);
+void drawStyledTooltip(const char* text, Vector2 position, int maxWidth = 250);
+inline void drawStyledButton(const ButtonStyle& style, Rectangle bounds, const std::string& text, bool isHovered = false, bool isPressed = false) {
+    drawStyledButton(style, bounds, text.c_str(), isHovered, isPressed);
+}
+inline void drawStyledText(const std::string& text, Vector2 position, const FontStyle& style) {
+    drawStyledText(text.c_str(), position, style);
+}
+inline void drawStyledTooltip(const std::string& text, Vector2 position, int maxWidth = 250) {
+    drawStyledTooltip(text.c_str(), position, maxWidth);
+}
 
 // Fantasy-themed decorative elements
 void drawOrnateBorder(Rectangle bounds, Color color, int thickness = 2);
@@ -294,7 +307,8 @@ void drawScrollDecoration(Rectangle bounds, Color color);
 // Helper functions
 Rectangle centerRectInRect(Rectangle inner, Rectangle outer);
 Rectangle positionRectRelative(Rectangle base, int offsetX, int offsetY, int width, int height);
-Vector2 getTextSize(const std::string& text, const FontStyle& style);
+Vector2 getTextSize(const char* text, const FontStyle& style);
+inline Vector2 getTextSize(const std::string& text, const FontStyle& style) { return getTextSize(text.c_str(), style); }
 bool isPointInRect(Vector2 point, Rectangle rect);
 
 // Color manipulation - Delegated to theme system
@@ -402,7 +416,8 @@ enum class UIZone {
     CENTER,         // Crosshair, modal dialogs
     BOTTOM_LEFT,    // Controls help, game stats
     BOTTOM_RIGHT,   // Chat, notifications
-    INTERACTION     // Dynamic interaction prompts
+    INTERACTION,    // Dynamic interaction prompts
+    COUNT           // Number of zones, not a zone
 };
 
 // UI element configuration
@@ -442,13 +457,18 @@ public:
     void releaseZone(UIZone zone);
 
     // Toggle panels
-    void renderDetailedTestingPanel(const GameState& state, const std::string& locationText, Color locationColor);
+    void renderDetailedTestingPanel(const GameState& state, const char* locationText, Color locationColor);
 
     // Utility functions
     void setScreenDimensions(int width, int height);
     bool isModalActive(const GameState& state) const;
     void clearOverlaps();
 
+    // Forwarded GameState change notifications; invalidate the cached panels showing that state
+    void onStateChanged(StateChangeMask changed) { panelCache_.onStateChanged(changed); }
+    const UIPanelCache& getPanelCache() const { return panelCache_; }
+    void setPanelRefreshInterval(float seconds) { panelCache_.setRefreshInterval(seconds); }
+
     // Element positioning helpers
     static Rectangle positionInZone(UIZone zone, int width, int height, int offsetX = 0, int offsetY = 0);
     static bool checkUICollision(Rectangle rect1, Rectangle rect2);
@@ -457,6 +477,16 @@ private:
     int screenWidth_;
     int screenHeight_;
     std::map<UIZone, std::string> zoneReservations_;
+    UIPanelCache panelCache_;
+
+    // Layout tree, built once and handed to UILayout::LayoutManager, which only re-lays out
+    // what a resize or content change touched. Nodes are owned by layoutRoot_.
+    std::shared_ptr<UILayout::LayoutNode> layoutRoot_;
+    std::array<UILayout::LayoutNode*, static_cast<size_t>(UIZone::COUNT)> zoneNodes_{};
+    UILayout::LayoutNode* inventoryWindowNode_ = nullptr;
+    UILayout::LayoutNode* sortButtonsNode_ = nullptr;     // One child per sort button
+    UILayout::LayoutNode* equippedSlotsNode_ = nullptr;   // One child per InventoryRows::EQUIPPED_SLOT_ORDER entry
+    UILayout::LayoutNode* itemRowsNode_ = nullptr;        // One child per visible item row
 
     // Individual UI component renderers - organized and positioned
     void renderCrosshair(const GameState& state);
@@ -468,12 +498,19 @@ private:
     void renderDiagnosticPanel(const GameState& state);
     void renderTestingStatus(const GameState& state);
 
+    // Cached panel contents, recorded by panelCache_ when stale
+    void drawPlayerStatsPanel(const GameState& state, Rectangle panelBounds);
+    void drawControlsPanel(Rectangle panelBounds);
+    void drawGameStatsPanel(const GameState& state, Rectangle panelBounds);
+    void drawInventoryChrome(Rectangle inventoryBounds);
+
     // Modal/overlay renderers
     void renderInventoryModal(const GameState& state);
     void renderDialogModal(const GameState& state);
     void renderEscMenuOverlay(GameState& state);
 
     // Layout helpers
+    void buildLayoutTree();
     void initializeLayout();
     Rectangle calculateNonOverlappingPosition(UIZone preferredZone, int width, int height) const;
 };
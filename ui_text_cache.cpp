@@ -0,0 +1,229 @@
+// ui_text_cache.cpp
+#include "ui_text_cache.h"
+#include "render_stats.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr float LINE_SPACING = 2.0f;  // raylib's default SetTextLineSpacing()
+
+uint64_t hashLayoutKey(const char* text, size_t length, unsigned int textureId, float fontSize, float spacing) {
+    // FNV-1a over the text, then the font parameters
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+    mix(text, length);
+    mix(&textureId, sizeof(textureId));
+    mix(&fontSize, sizeof(fontSize));
+    mix(&spacing, sizeof(spacing));
+    return hash;
+}
+
+}  // namespace
+
+const TextLayout& TextLayoutCache::layout(const Font& font, const char* text, float fontSize, float spacing) {
+    size_t length = std::strlen(text);
+    uint64_t key = hashLayoutKey(text, length, font.texture.id, fontSize, spacing);
+
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        const Entry& entry = it->second;
+        if (entry.textureId == font.texture.id && entry.fontSize == fontSize && entry.spacing == spacing &&
+            entry.text.size() == length && std::memcmp(entry.text.data(), text, length) == 0) {
+            ++hits_;
+            return entry.layout;
+        }
+    } else if (entries_.size() >= MAX_ENTRIES) {
+        entries_.clear();
+        it = entries_.end();
+    }
+
+    // Miss, or a hash collision that the new string takes over
+    ++misses_;
+    Entry& entry = it != entries_.end() ? it->second : entries_[key];
+    entry.text.assign(text, length);
+    entry.textureId = font.texture.id;
+    entry.fontSize = fontSize;
+    entry.spacing = spacing;
+    buildLayout(font, text, fontSize, spacing, entry.layout);
+    return entry.layout;
+}
+
+void TextLayoutCache::buildLayout(const Font& font, const char* text, float fontSize, float spacing, TextLayout& out) {
+    // Mirrors DrawTextEx/MeasureTextEx so cached text matches what raylib would draw
+    out.quads.clear();
+    out.size = {0.0f, 0.0f};
+    if (font.glyphs == nullptr || font.baseSize == 0 || text[0] == '\0') return;
+
+    float scale = fontSize / static_cast<float>(font.baseSize);
+    float padding = static_cast<float>(font.glyphPadding);
+    float penX = 0.0f;
+    float penY = 0.0f;
+    // MeasureTextEx takes the widest line's unscaled advances and the longest line's glyph
+    // count separately; keeping its arithmetic keeps measurements identical
+    float lineWidth = 0.0f;
+    int lineGlyphs = 0;
+    float maxLineWidth = 0.0f;
+    int maxLineGlyphs = 0;
+    int lines = 1;
+
+    auto finishLine = [&]() {
+        maxLineWidth = std::max(maxLineWidth, lineWidth);
+        lineWidth = 0.0f;
+        lineGlyphs = 0;
+    };
+
+    for (const char* cursor = text; *cursor != '\0';) {
+        int byteCount = 0;
+        int codepoint = GetCodepointNext(cursor, &byteCount);
+        cursor += byteCount;
+
+        if (codepoint == '\n') {
+            finishLine();
+            penX = 0.0f;
+            penY += fontSize + LINE_SPACING;
+            ++lines;
+            continue;
+        }
+
+        int index = GetGlyphIndex(font, codepoint);
+        const Rectangle& rec = font.recs[index];
+        const GlyphInfo& glyph = font.glyphs[index];
+
+        if (codepoint != ' ' && codepoint != '\t') {
+            GlyphQuad quad;
+            quad.source = {rec.x - padding, rec.y - padding, rec.width + 2.0f * padding, rec.height + 2.0f * padding};
+            quad.dest = {penX + (glyph.offsetX - padding) * scale, penY + (glyph.offsetY - padding) * scale,
+                         quad.source.width * scale, quad.source.height * scale};
+            out.quads.push_back(quad);
+        }
+
+        float advance = glyph.advanceX != 0 ? static_cast<float>(glyph.advanceX) : rec.width;
+        penX += advance * scale + spacing;
+        lineWidth += glyph.advanceX != 0 ? static_cast<float>(glyph.advanceX) : rec.width + glyph.offsetX;
+        maxLineGlyphs = std::max(maxLineGlyphs, ++lineGlyphs);
+    }
+    finishLine();
+
+    out.size = {maxLineWidth * scale + static_cast<float>(maxLineGlyphs - 1) * spacing,
+                fontSize * lines + LINE_SPACING * (lines - 1)};
+}
+
+void TextLayoutCache::emitQuads(unsigned int textureId, const BatchedQuad* quads, size_t count) {
+    // rlgl's batch holds a bounded number of vertices; split long runs across its flushes
+    constexpr size_t CHUNK = 1024;
+    for (size_t start = 0; start < count; start += CHUNK) {
+        size_t end = std::min(count, start + CHUNK);
+        rlCheckRenderBatchLimit(4 * static_cast<int>(end - start));
+        rlSetTexture(textureId);
+        rlBegin(RL_QUADS);
+        rlNormal3f(0.0f, 0.0f, 1.0f);
+        for (size_t i = start; i < end; ++i) {
+            const BatchedQuad& q = quads[i];
+            rlColor4ub(q.tint.r, q.tint.g, q.tint.b, q.tint.a);
+            rlTexCoord2f(q.u0, q.v0); rlVertex2f(q.x0, q.y0);
+            rlTexCoord2f(q.u0, q.v1); rlVertex2f(q.x0, q.y1);
+            rlTexCoord2f(q.u1, q.v1); rlVertex2f(q.x1, q.y1);
+            rlTexCoord2f(q.u1, q.v0); rlVertex2f(q.x1, q.y0);
+        }
+        rlEnd();
+    }
+    rlSetTexture(0);
+}
+
+void TextLayoutCache::draw(const Font& font, const char* text, Vector2 position, float fontSize, float spacing, Color tint) {
+    const TextLayout& laidOut = layout(font, text, fontSize, spacing);
+    if (laidOut.quads.empty()) return;
+
+    float invWidth = 1.0f / static_cast<float>(font.texture.width);
+    float invHeight = 1.0f / static_cast<float>(font.texture.height);
+
+    // All of the string's glyphs in one block against the atlas texture
+    rlCheckRenderBatchLimit(4 * static_cast<int>(laidOut.quads.size()));
+    rlSetTexture(font.texture.id);
+    rlBegin(RL_QUADS);
+    rlColor4ub(tint.r, tint.g, tint.b, tint.a);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+
+    for (const GlyphQuad& quad : laidOut.quads) {
+        float x0 = position.x + quad.dest.x;
+        float y0 = position.y + quad.dest.y;
+        float x1 = x0 + quad.dest.width;
+        float y1 = y0 + quad.dest.height;
+        float u0 = quad.source.x * invWidth;
+        float v0 = quad.source.y * invHeight;
+        float u1 = (quad.source.x + quad.source.width) * invWidth;
+        float v1 = (quad.source.y + quad.source.height) * invHeight;
+
+        rlTexCoord2f(u0, v0); rlVertex2f(x0, y0);
+        rlTexCoord2f(u0, v1); rlVertex2f(x0, y1);
+        rlTexCoord2f(u1, v1); rlVertex2f(x1, y1);
+        rlTexCoord2f(u1, v0); rlVertex2f(x1, y0);
+    }
+
+    rlEnd();
+    rlSetTexture(0);
+    RenderStats::getInstance().recordDraw(4 * static_cast<uint32_t>(laidOut.quads.size()), font.texture.id,
+                                          rlGetShaderIdDefault());
+}
+
+void TextLayoutCache::drawBatched(const Font& font, const char* text, Vector2 position, float fontSize, float spacing,
+                                  Color tint, Shader shader) {
+    if (batched_quads_ > 0 && shader.id != batch_shader_.id) flushBatched();
+    batch_shader_ = shader;
+
+    const TextLayout& laidOut = layout(font, text, fontSize, spacing);
+    if (laidOut.quads.empty()) return;
+
+    AtlasBatch* batch = nullptr;
+    for (AtlasBatch& candidate : batches_) {
+        if (candidate.textureId == font.texture.id) batch = &candidate;
+    }
+    if (!batch) {
+        batches_.push_back({font.texture.id, {}});
+        batch = &batches_.back();
+    }
+
+    float invWidth = 1.0f / static_cast<float>(font.texture.width);
+    float invHeight = 1.0f / static_cast<float>(font.texture.height);
+    for (const GlyphQuad& quad : laidOut.quads) {
+        float x0 = position.x + quad.dest.x;
+        float y0 = position.y + quad.dest.y;
+        batch->quads.push_back({x0, y0, x0 + quad.dest.width, y0 + quad.dest.height,
+                                quad.source.x * invWidth, quad.source.y * invHeight,
+                                (quad.source.x + quad.source.width) * invWidth,
+                                (quad.source.y + quad.source.height) * invHeight, tint});
+    }
+    batched_quads_ += laidOut.quads.size();
+}
+
+void TextLayoutCache::flushBatched() {
+    if (batched_quads_ == 0) return;
+
+    RenderStats& stats = RenderStats::getInstance();
+    BeginShaderMode(batch_shader_);
+    for (AtlasBatch& batch : batches_) {
+        if (batch.quads.empty()) continue;
+        emitQuads(batch.textureId, batch.quads.data(), batch.quads.size());
+        stats.recordDraw(4 * static_cast<uint32_t>(batch.quads.size()), batch.textureId, batch_shader_.id);
+        batch.quads.clear();
+    }
+    EndShaderMode();
+    batched_quads_ = 0;
+}
+
+void TextLayoutCache::clear() {
+    entries_.clear();
+    // Queued quads may name an atlas that was just unloaded
+    for (AtlasBatch& batch : batches_) {
+        batch.quads.clear();
+    }
+    batched_quads_ = 0;
+}
@@ -0,0 +1,102 @@
+// ui_text_cache.h - Measured and laid-out UI text, drawn straight from the font atlas
+#ifndef UI_TEXT_CACHE_H
+#define UI_TEXT_CACHE_H
+
+#include "raylib.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// One glyph of a laid-out string: where it sits in the font atlas and where it lands,
+// relative to the text origin
+struct GlyphQuad {
+    Rectangle source;
+    Rectangle dest;
+};
+
+struct TextLayout {
+    Vector2 size{};                 // Same extents MeasureTextEx reports
+    std::vector<GlyphQuad> quads;   // Visible glyphs only; spaces and tabs just advance
+};
+
+/// \brief Caches text measurements and glyph layouts keyed by (text, font atlas, size, spacing).
+///
+/// Every raylib Font is already a glyph atlas, so a cached layout is just the list of atlas
+/// rectangles for the string. Drawing submits all of a string's quads for one atlas texture
+/// in a single rlgl block instead of decoding, measuring and positioning each glyph again.
+/// HUD strings are mostly identical from frame to frame, so almost every lookup hits.
+class TextLayoutCache {
+public:
+    static constexpr size_t MAX_ENTRIES = 2048;  // Cleared wholesale when full; a frame refills it
+
+    static TextLayoutCache& getInstance() {
+        static TextLayoutCache instance;
+        return instance;
+    }
+
+    /// \brief Returns the layout of `text`, building it on a miss.
+    /// The reference is valid until the next lookup.
+    const TextLayout& layout(const Font& font, const char* text, float fontSize, float spacing);
+
+    Vector2 measure(const Font& font, const char* text, float fontSize, float spacing) {
+        return layout(font, text, fontSize, spacing).size;
+    }
+
+    /// \brief Draws `text` with its top-left at `position`, like DrawTextEx.
+    void draw(const Font& font, const char* text, Vector2 position, float fontSize, float spacing, Color tint);
+
+    /// \brief Queues `text` to be drawn at the next flushBatched(), under `shader`.
+    ///
+    /// Queued strings are drawn grouped by atlas in one shader block, instead of a shader and
+    /// texture switch (two rlgl flushes) per string. They land on top of whatever else is drawn
+    /// before the flush, so callers flush before drawing anything meant to cover them.
+    void drawBatched(const Font& font, const char* text, Vector2 position, float fontSize, float spacing,
+                     Color tint, Shader shader);
+
+    /// \brief Draws everything drawBatched queued and empties the queue; no-op when it's empty.
+    void flushBatched();
+
+    /// \brief Drops every layout and queued quad. ThemeManager calls it whenever fonts load or
+    /// unload, since a recycled atlas texture id would otherwise hit the old font's layouts.
+    void clear();
+
+    uint64_t getHits() const { return hits_; }
+    uint64_t getMisses() const { return misses_; }
+    size_t size() const { return entries_.size(); }
+
+private:
+    TextLayoutCache() = default;
+
+    struct Entry {
+        std::string text;
+        unsigned int textureId = 0;
+        float fontSize = 0.0f;
+        float spacing = 0.0f;
+        TextLayout layout;
+    };
+
+    // One queued quad, already in screen space and atlas UVs
+    struct BatchedQuad {
+        float x0, y0, x1, y1;
+        float u0, v0, u1, v1;
+        Color tint;
+    };
+
+    struct AtlasBatch {
+        unsigned int textureId = 0;
+        std::vector<BatchedQuad> quads;   // Submission order, so overlapping strings keep theirs
+    };
+
+    static void buildLayout(const Font& font, const char* text, float fontSize, float spacing, TextLayout& out);
+    static void emitQuads(unsigned int textureId, const BatchedQuad* quads, size_t count);
+
+    std::unordered_map<uint64_t, Entry> entries_;
+    std::vector<AtlasBatch> batches_;    // One per atlas seen; kept between flushes for their capacity
+    Shader batch_shader_{};
+    size_t batched_quads_ = 0;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
+
+#endif // UI_TEXT_CACHE_H
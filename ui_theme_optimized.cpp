@@ -1,6 +1,11 @@
 // ui_theme_optimized.cpp - High-performance theme system implementation
 #include "ui_theme_optimized.h"
+#include "memory_tracker.h"
+#include "ui_text_cache.h"
 #include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <cmath>
@@ -107,11 +112,31 @@ std::string ThemeData::serialize() const {
     return oss.str();
 }
 
+namespace {
+
+// Reads a non-negative "index" field up to the next ':'
+bool readIndex(std::istream& in, size_t limit, size_t& out) {
+    std::string text;
+    if (!std::getline(in, text, ':') || text.empty()) return false;
+    char* end = nullptr;
+    unsigned long value = std::strtoul(text.c_str(), &end, 10);
+    if (*end != '\0' || value >= limit) return false;
+    out = static_cast<size_t>(value);
+    return true;
+}
+
+}  // namespace
+
 bool ThemeData::deserialize(const std::string& data) {
+    // Lines overwrite what they name and leave everything else, so a file can hold only the
+    // roles it changes. A malformed line fails the whole load.
     std::istringstream iss(data);
     std::string line;
 
     while (std::getline(iss, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+
         std::istringstream lineStream(line);
         std::string type;
         std::getline(lineStream, type, ':');
@@ -125,25 +150,52 @@ bool ThemeData::deserialize(const std::string& data) {
         } else if (type == "AUTHOR") {
             std::getline(lineStream, author_);
         } else if (type == "COLOR") {
+            // COLOR:<role>:<r>,<g>,<b>,<a>:<name>:<description>
             size_t index;
-            lineStream >> index;
-            if (index < colors_.size()) {
-                std::string rgbaStr, name, desc;
-                std::getline(lineStream, rgbaStr, ':');
-                std::getline(lineStream, name, ':');
-                std::getline(lineStream, desc);
-
-                // Parse RGBA
-                std::istringstream rgbaStream(rgbaStr.substr(1)); // Skip first character
-                std::string component;
-                for (int i = 0; i < 4 && std::getline(rgbaStream, component, ','); ++i) {
-                    colors_[index].rgba[i] = static_cast<uint8_t>(std::stoi(component));
-                }
-                colors_[index].name = name;
-                colors_[index].description = desc;
+            std::string rgbaStr, name, desc;
+            if (!readIndex(lineStream, colors_.size(), index) || !std::getline(lineStream, rgbaStr, ':')) return false;
+            int rgba[4];
+            if (std::sscanf(rgbaStr.c_str(), "%d,%d,%d,%d", &rgba[0], &rgba[1], &rgba[2], &rgba[3]) != 4) return false;
+            std::getline(lineStream, name, ':');
+            std::getline(lineStream, desc);
+            for (int i = 0; i < 4; ++i) {
+                colors_[index].rgba[i] = static_cast<uint8_t>(std::clamp(rgba[i], 0, 255));
             }
+            colors_[index].name = name;
+            colors_[index].description = desc;
+        } else if (type == "FONT") {
+            // FONT:<role>:<name>:<path>:<size>; the path may itself contain ':'
+            size_t index;
+            std::string name, rest;
+            if (!readIndex(lineStream, fonts_.size(), index) || !std::getline(lineStream, name, ':') ||
+                !std::getline(lineStream, rest)) return false;
+            size_t sizeAt = rest.find_last_of(':');
+            if (sizeAt == std::string::npos) return false;
+            int baseSize = std::atoi(rest.c_str() + sizeAt + 1);
+            if (baseSize <= 0) return false;
+            FontDefinition& font = fonts_[index];
+            std::string path = rest.substr(0, sizeAt);
+            if (font.filePath != path || font.baseSize != baseSize) {
+                font.font = Font{};   // The manager attaches the new atlas once it's loaded
+                font.loaded = false;
+            }
+            font.name = name;
+            font.filePath = path;
+            font.baseSize = baseSize;
+        } else if (type == "SPACING") {
+            // SPACING:<role>:<value>:<name>:<description>
+            size_t index;
+            std::string valueStr, name, desc;
+            if (!readIndex(lineStream, spacing_.size(), index) || !std::getline(lineStream, valueStr, ':')) return false;
+            char* end = nullptr;
+            float value = std::strtof(valueStr.c_str(), &end);
+            if (end == valueStr.c_str()) return false;
+            std::getline(lineStream, name, ':');
+            std::getline(lineStream, desc);
+            spacing_[index] = {value, name, desc};
+        } else {
+            return false;
         }
-        // Similar parsing for FONT and SPACING...
     }
 
     return validate();
@@ -198,13 +250,161 @@ std::vector<std::string> ThemeData::getValidationErrors() const {
     return errors;
 }
 
+// ============================================================================
+// BUILT-IN PALETTES
+// ============================================================================
+
+namespace {
+
+constexpr size_t COLOR_COUNT = static_cast<size_t>(ColorRole::COLOR_ROLE_COUNT);
+constexpr size_t SPACING_COUNT = static_cast<size_t>(SpacingRole::SPACING_ROLE_COUNT);
+
+using Palette = std::array<Color, COLOR_COUNT>;
+
+struct PaletteColor {
+    ColorRole role;
+    Color color;
+    const char* name;
+    const char* description;
+};
+
+struct PaletteSpacing {
+    SpacingRole role;
+    float value;
+    const char* name;
+    const char* description;
+};
+
+// BRIGHT FANTASY THEME - High contrast, clearly visible colors. Every role is defined here;
+// the other built-in themes only list what they change.
+constexpr PaletteColor CLASSIC_COLORS[] = {
+    // Primary colors - Rich and vibrant
+    {ColorRole::PRIMARY, {100, 150, 200, 255}, "Primary Inventory Blue", "Matching inventory border blue"},
+    {ColorRole::SECONDARY, {200, 180, 160, 255}, "Secondary Bright Bronze", "Ultra bright bronze"},
+    {ColorRole::ACCENT, {255, 220, 160, 255}, "Accent Ultra Gold", "Ultra bright gold accent"},
+
+    {ColorRole::SUCCESS, {160, 255, 180, 255}, "Success Ultra Green", "Ultra bright forest green"},
+    {ColorRole::WARNING, {255, 240, 140, 255}, "Warning Ultra Amber", "Ultra bright amber"},
+    {ColorRole::ERROR, {255, 160, 160, 255}, "Error Ultra Crimson", "Ultra bright crimson"},
+    {ColorRole::INFO, {180, 220, 255, 255}, "Info Ultra Azure", "Ultra bright azure blue"},
+
+    // UI state colors - MATCHING INVENTORY DARK THEME for consistency
+    {ColorRole::BACKGROUND, {25, 30, 45, 255}, "Background Inventory Dark", "Matching inventory dark background"},
+    {ColorRole::SURFACE, {35, 40, 55, 255}, "Surface Inventory Title", "Matching inventory title bar"},
+    {ColorRole::TEXT_PRIMARY, {220, 230, 255, 255}, "Text Inventory Bright", "Matching inventory bright text"},
+
+    {ColorRole::TEXT_SECONDARY, {160, 180, 200, 255}, "Text Inventory Muted", "Matching inventory subtitle text"},
+    {ColorRole::TEXT_DISABLED, {120, 130, 150, 255}, "Text Inventory Disabled", "Muted disabled text"},
+    {ColorRole::BORDER, {100, 150, 200, 255}, "Border Inventory Blue", "Matching inventory blue border"},
+    {ColorRole::HOVER, {120, 170, 220, 220}, "Hover Inventory Blue", "Matching inventory blue with transparency"},
+    {ColorRole::SELECTED, {140, 190, 240, 240}, "Selected Inventory Bright", "Bright inventory blue selection"},
+    {ColorRole::PRESSED, {80, 130, 180, 255}, "Pressed Inventory Dark", "Darker inventory blue for pressed state"},
+
+    // Status colors with fantasy flair - Bright and visible
+    {ColorRole::HEALTH, {255, 80, 80, 255}, "Health Bright Red", "Bright red"},
+    {ColorRole::MANA, {80, 120, 255, 255}, "Mana Bright Blue", "Bright blue"},
+    {ColorRole::STAMINA, {80, 200, 80, 255}, "Stamina Bright Green", "Bright green"},
+    {ColorRole::EXPERIENCE, {255, 220, 80, 255}, "Experience Bright Gold", "Bright gold"},
+
+    // Rarity colors for items - High contrast and readable
+    {ColorRole::COMMON, {180, 180, 180, 255}, "Common Light Gray", "Bright light gray"},
+    {ColorRole::UNCOMMON, {120, 220, 120, 255}, "Uncommon Bright Green", "Bright green"},
+    {ColorRole::RARE, {100, 180, 255, 255}, "Rare Bright Blue", "Bright blue"},
+    {ColorRole::EPIC, {220, 120, 255, 255}, "Epic Bright Purple", "Bright purple"},
+    {ColorRole::LEGENDARY, {255, 180, 60, 255}, "Legendary Bright Orange", "Bright orange"},
+    {ColorRole::ARTIFACT, {255, 100, 180, 255}, "Artifact Bright Pink", "Bright pink"},
+};
+
+// Dark theme colors (darker variants)
+constexpr PaletteColor DARK_COLORS[] = {
+    {ColorRole::BACKGROUND, {5, 5, 10, 255}, "Dark Background", "Very deep space"},
+    {ColorRole::SURFACE, {15, 15, 20, 255}, "Dark Surface", "Deep void"},
+    {ColorRole::TEXT_PRIMARY, {240, 240, 240, 255}, "Bright Text", "High contrast text"},
+    {ColorRole::TEXT_SECONDARY, {200, 200, 200, 255}, "Bright Secondary", "High contrast secondary"},
+};
+
+// Light theme colors
+constexpr PaletteColor LIGHT_COLORS[] = {
+    {ColorRole::BACKGROUND, {245, 245, 250, 255}, "Light Background", "Soft light background"},
+    {ColorRole::SURFACE, {255, 255, 255, 255}, "Light Surface", "Pure white surface"},
+    {ColorRole::TEXT_PRIMARY, {20, 20, 30, 255}, "Dark Text", "High contrast dark text"},
+    {ColorRole::TEXT_SECONDARY, {60, 60, 70, 255}, "Dark Secondary", "Dark secondary text"},
+    {ColorRole::BORDER, {200, 200, 210, 255}, "Light Border", "Subtle light border"},
+    {ColorRole::PRIMARY, {70, 70, 90, 255}, "Light Primary", "Soft blue primary"},
+    {ColorRole::SECONDARY, {120, 110, 100, 255}, "Light Secondary", "Light parchment"},
+};
+
+// High contrast colors meeting WCAG AAA standards
+constexpr PaletteColor ACCESSIBLE_COLORS[] = {
+    {ColorRole::BACKGROUND, {0, 0, 0, 255}, "Black Background", "Pure black for maximum contrast"},
+    {ColorRole::SURFACE, {32, 32, 32, 255}, "Dark Gray Surface", "Dark gray surface"},
+    {ColorRole::TEXT_PRIMARY, {255, 255, 255, 255}, "White Text", "Pure white text"},
+    {ColorRole::TEXT_SECONDARY, {200, 200, 200, 255}, "Light Gray Text", "Light gray secondary text"},
+    {ColorRole::BORDER, {255, 255, 255, 255}, "White Border", "White borders"},
+    {ColorRole::ACCENT, {255, 255, 0, 255}, "Yellow Accent", "High contrast yellow"},
+    {ColorRole::ERROR, {255, 0, 0, 255}, "Red Error", "Pure red for errors"},
+    {ColorRole::SUCCESS, {0, 255, 0, 255}, "Green Success", "Pure green for success"},
+};
+
+// Define spacing for consistent layouts
+constexpr PaletteSpacing DEFAULT_SPACING[] = {
+    {SpacingRole::XS, 4.0f, "Extra Small", "4px spacing"},
+    {SpacingRole::SM, 8.0f, "Small", "8px spacing"},
+    {SpacingRole::MD, 16.0f, "Medium", "16px spacing"},
+    {SpacingRole::LG, 24.0f, "Large", "24px spacing"},
+    {SpacingRole::XL, 32.0f, "Extra Large", "32px spacing"},
+    {SpacingRole::XXL, 48.0f, "Extra Extra Large", "48px spacing"},
+};
+
+static_assert(sizeof(CLASSIC_COLORS) / sizeof(CLASSIC_COLORS[0]) == COLOR_COUNT,
+              "CLASSIC_COLORS must define every ColorRole");
+static_assert(sizeof(DEFAULT_SPACING) / sizeof(DEFAULT_SPACING[0]) == SPACING_COUNT,
+              "DEFAULT_SPACING must define every SpacingRole");
+
+/// \brief Writes `colors` over `base`, so a variant is the classic palette plus its overrides.
+template<size_t N>
+constexpr Palette overlay(Palette base, const PaletteColor (&colors)[N]) {
+    for (size_t i = 0; i < N; ++i) {
+        base[static_cast<size_t>(colors[i].role)] = colors[i].color;
+    }
+    return base;
+}
+
+constexpr Palette CLASSIC_PALETTE = overlay(Palette{}, CLASSIC_COLORS);
+constexpr Palette DARK_PALETTE = overlay(CLASSIC_PALETTE, DARK_COLORS);
+constexpr Palette LIGHT_PALETTE = overlay(CLASSIC_PALETTE, LIGHT_COLORS);
+constexpr Palette ACCESSIBLE_PALETTE = overlay(CLASSIC_PALETTE, ACCESSIBLE_COLORS);
+
+static_assert(CLASSIC_PALETTE[static_cast<size_t>(ColorRole::ARTIFACT)].a == 255,
+              "Classic palette left a role unset");
+
+/// \brief Copies the resolved palette into `theme`, naming each role after the entry that set it.
+template<size_t N>
+void describeColors(ThemeData& theme, const Palette& palette, const PaletteColor (&overrides)[N]) {
+    for (const PaletteColor& entry : CLASSIC_COLORS) {
+        const PaletteColor* source = &entry;
+        for (const PaletteColor& change : overrides) {
+            if (change.role == entry.role) source = &change;
+        }
+        Color color = palette[static_cast<size_t>(entry.role)];
+        theme.setColor(entry.role, {{color.r, color.g, color.b, color.a}, source->name, source->description});
+    }
+}
+
+void describeSpacing(ThemeData& theme) {
+    for (const PaletteSpacing& entry : DEFAULT_SPACING) {
+        theme.setSpacing(entry.role, {entry.value, entry.name, entry.description});
+    }
+}
+
+}  // namespace
+
 // ============================================================================
 // THEME MANAGER IMPLEMENTATION
 // ============================================================================
 
 ThemeManager::ThemeManager() {
     // Initialize caches
-    std::fill(cacheValid_.begin(), cacheValid_.end(), 0);
     std::fill(fontCacheValid_.begin(), fontCacheValid_.end(), 0);
 
     // Initialize default themes
@@ -219,6 +419,7 @@ ThemeManager::~ThemeManager() {
 }
 
 void ThemeManager::initializeDefaultThemes() {
+    MemoryTagScope memoryTag(MemoryTag::THEME);
     createClassicTheme();
     createDarkTheme();
     createLightTheme();
@@ -232,44 +433,7 @@ void ThemeManager::createClassicTheme() {
     classicTheme->setDescription("Gold/brown medieval fantasy theme");
     classicTheme->setAuthor("Browserwind Team");
 
-    // BRIGHT FANTASY THEME - High contrast, clearly visible colors
-    // Primary colors - Rich and vibrant
-    classicTheme->setColor(ColorRole::PRIMARY, {{100, 150, 200, 255}, "Primary Inventory Blue", "Matching inventory border blue"});
-    classicTheme->setColor(ColorRole::SECONDARY, {{200, 180, 160, 255}, "Secondary Bright Bronze", "Ultra bright bronze"});
-    classicTheme->setColor(ColorRole::ACCENT, {{255, 220, 160, 255}, "Accent Ultra Gold", "Ultra bright gold accent"});
-
-    classicTheme->setColor(ColorRole::SUCCESS, {{160, 255, 180, 255}, "Success Ultra Green", "Ultra bright forest green"});
-    classicTheme->setColor(ColorRole::WARNING, {{255, 240, 140, 255}, "Warning Ultra Amber", "Ultra bright amber"});
-    classicTheme->setColor(ColorRole::ERROR, {{255, 160, 160, 255}, "Error Ultra Crimson", "Ultra bright crimson"});
-    classicTheme->setColor(ColorRole::INFO, {{180, 220, 255, 255}, "Info Ultra Azure", "Ultra bright azure blue"});
-
-    // UI state colors - MATCHING INVENTORY DARK THEME for consistency
-    classicTheme->setColor(ColorRole::BACKGROUND, {{25, 30, 45, 255}, "Background Inventory Dark", "Matching inventory dark background"});
-    classicTheme->setColor(ColorRole::SURFACE, {{35, 40, 55, 255}, "Surface Inventory Title", "Matching inventory title bar"});
-    classicTheme->setColor(ColorRole::TEXT_PRIMARY, {{220, 230, 255, 255}, "Text Inventory Bright", "Matching inventory bright text"});
-
-    classicTheme->setColor(ColorRole::TEXT_SECONDARY, {{160, 180, 200, 255}, "Text Inventory Muted", "Matching inventory subtitle text"});
-    classicTheme->setColor(ColorRole::TEXT_DISABLED, {{120, 130, 150, 255}, "Text Inventory Disabled", "Muted disabled text"});
-    classicTheme->setColor(ColorRole::BORDER, {{100, 150, 200, 255}, "Border Inventory Blue", "Matching inventory blue border"});
-    classicTheme->setColor(ColorRole::HOVER, {{120, 170, 220, 220}, "Hover Inventory Blue", "Matching inventory blue with transparency"});
-    classicTheme->setColor(ColorRole::SELECTED, {{140, 190, 240, 240}, "Selected Inventory Bright", "Bright inventory blue selection"});
-    classicTheme->setColor(ColorRole::PRESSED, {{80, 130, 180, 255}, "Pressed Inventory Dark", "Darker inventory blue for pressed state"});
-
-    // Status colors with fantasy flair - Bright and visible
-    classicTheme->setColor(ColorRole::HEALTH, {{255, 80, 80, 255}, "Health Bright Red", "Bright red"});
-    classicTheme->setColor(ColorRole::MANA, {{80, 120, 255, 255}, "Mana Bright Blue", "Bright blue"});
-    classicTheme->setColor(ColorRole::STAMINA, {{80, 200, 80, 255}, "Stamina Bright Green", "Bright green"});
-    classicTheme->setColor(ColorRole::EXPERIENCE, {{255, 220, 80, 255}, "Experience Bright Gold", "Bright gold"});
-
-    // Classic theme colors configured successfully
-
-    // Rarity colors for items - High contrast and readable
-    classicTheme->setColor(ColorRole::COMMON, {{180, 180, 180, 255}, "Common Light Gray", "Bright light gray"});
-    classicTheme->setColor(ColorRole::UNCOMMON, {{120, 220, 120, 255}, "Uncommon Bright Green", "Bright green"});
-    classicTheme->setColor(ColorRole::RARE, {{100, 180, 255, 255}, "Rare Bright Blue", "Bright blue"});
-    classicTheme->setColor(ColorRole::EPIC, {{220, 120, 255, 255}, "Epic Bright Purple", "Bright purple"});
-    classicTheme->setColor(ColorRole::LEGENDARY, {{255, 180, 60, 255}, "Legendary Bright Orange", "Bright orange"});
-    classicTheme->setColor(ColorRole::ARTIFACT, {{255, 100, 180, 255}, "Artifact Bright Pink", "Bright pink"});
+    describeColors(*classicTheme, CLASSIC_PALETTE, CLASSIC_COLORS);
 
     // Define fonts with fantasy names
     FontDefinition headerFont{"Medieval Header", "assets/fonts/medieval_header.ttf", 24, Font{}, false};
@@ -282,13 +446,7 @@ void ThemeManager::createClassicTheme() {
     classicTheme->setFont(FontRole::UI, uiFont);
     classicTheme->setFont(FontRole::MONOSPACE, monoFont);
 
-    // Define spacing for consistent layouts
-    classicTheme->setSpacing(SpacingRole::XS, {4.0f, "Extra Small", "4px spacing"});
-    classicTheme->setSpacing(SpacingRole::SM, {8.0f, "Small", "8px spacing"});
-    classicTheme->setSpacing(SpacingRole::MD, {16.0f, "Medium", "16px spacing"});
-    classicTheme->setSpacing(SpacingRole::LG, {24.0f, "Large", "24px spacing"});
-    classicTheme->setSpacing(SpacingRole::XL, {32.0f, "Extra Large", "32px spacing"});
-    classicTheme->setSpacing(SpacingRole::XXL, {48.0f, "Extra Extra Large", "48px spacing"});
+    describeSpacing(*classicTheme);
 
     themes_[ThemeVariant::CLASSIC] = std::move(classicTheme);
 }
@@ -298,26 +456,10 @@ void ThemeManager::createDarkTheme() {
     darkTheme->setName("Browserwind Dark");
     darkTheme->setDescription("Enhanced dark mode for low-light environments");
 
-    // Dark theme colors (darker variants)
-    darkTheme->setColor(ColorRole::BACKGROUND, {{5, 5, 10, 255}, "Dark Background", "Very deep space"});
-    darkTheme->setColor(ColorRole::SURFACE, {{15, 15, 20, 255}, "Dark Surface", "Deep void"});
-    darkTheme->setColor(ColorRole::TEXT_PRIMARY, {{240, 240, 240, 255}, "Bright Text", "High contrast text"});
-    darkTheme->setColor(ColorRole::TEXT_SECONDARY, {{200, 200, 200, 255}, "Bright Secondary", "High contrast secondary"});
+    describeColors(*darkTheme, DARK_PALETTE, DARK_COLORS);
 
-    // Copy other colors from classic theme but with slight adjustments
+    // Copy fonts from classic theme
     auto classicTheme = themes_[ThemeVariant::CLASSIC].get();
-    for (size_t i = 0; i < static_cast<size_t>(ColorRole::COLOR_ROLE_COUNT); ++i) {
-        ColorRole role = static_cast<ColorRole>(i);
-        if (role != ColorRole::BACKGROUND && role != ColorRole::SURFACE &&
-            role != ColorRole::TEXT_PRIMARY && role != ColorRole::TEXT_SECONDARY) {
-            const ColorDefinition* colorDef = classicTheme->getColor(role);
-            if (colorDef) {
-                darkTheme->setColor(role, *colorDef);
-            }
-        }
-    }
-
-    // Copy fonts and spacing
     for (size_t i = 0; i < static_cast<size_t>(FontRole::FONT_ROLE_COUNT); ++i) {
         FontRole role = static_cast<FontRole>(i);
         const FontDefinition* fontDef = classicTheme->getFont(role);
@@ -326,11 +468,7 @@ void ThemeManager::createDarkTheme() {
         }
     }
 
-    for (size_t i = 0; i < static_cast<size_t>(SpacingRole::SPACING_ROLE_COUNT); ++i) {
-        SpacingRole role = static_cast<SpacingRole>(i);
-        SpacingDefinition spacing{classicTheme->getSpacing(role), "", ""};
-        darkTheme->setSpacing(role, spacing);
-    }
+    describeSpacing(*darkTheme);
 
     themes_[ThemeVariant::DARK] = std::move(darkTheme);
 }
@@ -340,16 +478,8 @@ void ThemeManager::createLightTheme() {
     lightTheme->setName("Browserwind Light");
     lightTheme->setDescription("Light mode variant for bright environments");
 
-    // Light theme colors
-    lightTheme->setColor(ColorRole::BACKGROUND, {{245, 245, 250, 255}, "Light Background", "Soft light background"});
-    lightTheme->setColor(ColorRole::SURFACE, {{255, 255, 255, 255}, "Light Surface", "Pure white surface"});
-    lightTheme->setColor(ColorRole::TEXT_PRIMARY, {{20, 20, 30, 255}, "Dark Text", "High contrast dark text"});
-    lightTheme->setColor(ColorRole::TEXT_SECONDARY, {{60, 60, 70, 255}, "Dark Secondary", "Dark secondary text"});
-    lightTheme->setColor(ColorRole::BORDER, {{200, 200, 210, 255}, "Light Border", "Subtle light border"});
-
-    // Adjust other colors for light theme
-    lightTheme->setColor(ColorRole::PRIMARY, {{70, 70, 90, 255}, "Light Primary", "Soft blue primary"});
-    lightTheme->setColor(ColorRole::SECONDARY, {{120, 110, 100, 255}, "Light Secondary", "Light parchment"});
+    describeColors(*lightTheme, LIGHT_PALETTE, LIGHT_COLORS);
+    describeSpacing(*lightTheme);
 
     themes_[ThemeVariant::LIGHT] = std::move(lightTheme);
 }
@@ -359,62 +489,86 @@ void ThemeManager::createAccessibleTheme() {
     accessibleTheme->setName("Browserwind Accessible");
     accessibleTheme->setDescription("High contrast theme for accessibility");
 
-    // High contrast colors meeting WCAG AAA standards
-    accessibleTheme->setColor(ColorRole::BACKGROUND, {{0, 0, 0, 255}, "Black Background", "Pure black for maximum contrast"});
-    accessibleTheme->setColor(ColorRole::SURFACE, {{32, 32, 32, 255}, "Dark Gray Surface", "Dark gray surface"});
-    accessibleTheme->setColor(ColorRole::TEXT_PRIMARY, {{255, 255, 255, 255}, "White Text", "Pure white text"});
-    accessibleTheme->setColor(ColorRole::TEXT_SECONDARY, {{200, 200, 200, 255}, "Light Gray Text", "Light gray secondary text"});
-    accessibleTheme->setColor(ColorRole::BORDER, {{255, 255, 255, 255}, "White Border", "White borders"});
-    accessibleTheme->setColor(ColorRole::ACCENT, {{255, 255, 0, 255}, "Yellow Accent", "High contrast yellow"});
-    accessibleTheme->setColor(ColorRole::ERROR, {{255, 0, 0, 255}, "Red Error", "Pure red for errors"});
-    accessibleTheme->setColor(ColorRole::SUCCESS, {{0, 255, 0, 255}, "Green Success", "Pure green for success"});
+    describeColors(*accessibleTheme, ACCESSIBLE_PALETTE, ACCESSIBLE_COLORS);
+    describeSpacing(*accessibleTheme);
 
     themes_[ThemeVariant::ACCESSIBLE] = std::move(accessibleTheme);
 }
 
 bool ThemeManager::loadTheme(ThemeVariant variant) {
+    MemoryTagScope memoryTag(MemoryTag::THEME);
     auto it = themes_.find(variant);
-    if (it != themes_.end()) {
-        currentVariant_ = variant;
-        updateColorCache();
-        updateFontCache();
-        return true;
+    if (it == themes_.end()) {
+        return false;
+    }
+
+    // Resolve every role once here; getColor()/getSpacing() just index these tables
+    const ThemeData& theme = *it->second;
+    for (size_t i = 0; i < COLOR_COUNT; ++i) {
+        activeColors_[i] = theme.getRaylibColor(static_cast<ColorRole>(i));
     }
-    return false;
+    for (size_t i = 0; i < SPACING_COUNT; ++i) {
+        activeSpacing_[i] = theme.getSpacing(static_cast<SpacingRole>(i));
+    }
+
+    currentVariant_ = variant;
+    ++themeRevision_;
+    updateFontCache();
+    return true;
 }
 
 bool ThemeManager::switchTheme(ThemeVariant variant) {
     return loadTheme(variant);
 }
 
-Color ThemeManager::getColor(ColorRole role, float alpha) const noexcept {
-    uint32_t cacheKey = getCacheKey(role, alpha);
-    uint32_t cacheIndex = cacheKey % UI_COLOR_CACHE_SIZE;
-
-    // Check cache first
-    if (cacheValid_[cacheIndex]) {
-        metrics_.colorCacheHits++;
-        return colorCache_[cacheIndex];
+bool ThemeManager::loadCustomTheme(const std::string& themePath) {
+    MemoryTagScope memoryTag(MemoryTag::THEME);
+    std::ifstream file(themePath);
+    if (!file) {
+        std::cout << "THEME: Cannot open " << themePath << std::endl;
+        return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+
+    // Start from the active theme so the file only needs the roles it changes
+    auto theme = std::make_unique<ThemeData>();
+    auto current = themes_.find(currentVariant_);
+    if (current != themes_.end() && !theme->deserialize(current->second->serialize())) {
+        theme = std::make_unique<ThemeData>();
+    }
+    if (!theme->deserialize(text.str())) {
+        // A half-edited file shouldn't wipe out a working theme
+        std::cout << "THEME: " << themePath << " is malformed or incomplete, keeping the current theme" << std::endl;
+        for (const std::string& error : theme->getValidationErrors()) {
+            std::cout << "THEME:   " << error << std::endl;
+        }
+        return false;
     }
 
-    // Cache miss - get from theme
-    metrics_.colorCacheMisses++;
-    auto it = themes_.find(currentVariant_);
-    if (it != themes_.end()) {
-        Color color = it->second->getRaylibColor(role, alpha);
-
-        // Color retrieved successfully from theme system
-
-        // Store in cache
-        colorCache_[cacheIndex] = color;
-        cacheValid_[cacheIndex] = 1;
-
-        return color;
+    // Fonts the loader already holds are attached now; new ones load on first use
+    for (size_t i = 0; i < static_cast<size_t>(FontRole::FONT_ROLE_COUNT); ++i) {
+        const FontDefinition* fontDef = theme->getFont(static_cast<FontRole>(i));
+        const Font* font = fontDef ? fontLoader_.find(fontDef->filePath) : nullptr;
+        if (font) {
+            fontDef->font = *font;
+            fontDef->loaded = true;
+        }
     }
 
-    // Fallback color
-    std::cout << "ThemeManager::getColor - FALLBACK for role " << static_cast<int>(role) << std::endl;
-    return Color{255, 255, 255, 255};
+    themes_[ThemeVariant::CUSTOM] = std::move(theme);
+    loadTheme(ThemeVariant::CUSTOM);
+    std::cout << "THEME: Loaded custom theme '" << themes_[ThemeVariant::CUSTOM]->getName() << "' from "
+              << themePath << std::endl;
+    return true;
+}
+
+bool ThemeManager::saveCurrentTheme(const std::string& themePath) const {
+    auto current = themes_.find(currentVariant_);
+    if (current == themes_.end()) return false;
+    std::ofstream file(themePath, std::ios::trunc);
+    file << current->second->serialize();
+    return static_cast<bool>(file);
 }
 
 Color ThemeManager::getColorWithState(ColorRole baseRole, bool hovered,
@@ -433,90 +587,75 @@ Color ThemeManager::getColorWithState(ColorRole baseRole, bool hovered,
 }
 
 const Font* ThemeManager::getFont(FontRole role) const noexcept {
-    uint32_t cacheKey = getFontCacheKey(role);
+    uint32_t cacheIndex = getFontCacheKey(role) % UI_FONT_CACHE_SIZE;
 
     // Check cache first
-    if (fontCacheValid_[cacheKey % UI_FONT_CACHE_SIZE]) {
+    if (fontCacheValid_[cacheIndex]) {
         metrics_.fontCacheHits++;
-        return fontCache_[cacheKey % UI_FONT_CACHE_SIZE];
+        return fontCache_[cacheIndex];
     }
 
     // Cache miss - get from theme
     metrics_.fontCacheMisses++;
+    const Font* font = nullptr;
     auto it = themes_.find(currentVariant_);
     if (it != themes_.end()) {
-        const Font* font = it->second->getRaylibFont(role);
-
-        // Try to load font if not loaded - with comprehensive safety
-        if (!font) {
-            const FontDefinition* fontDef = it->second->getFont(role);
-            if (fontDef && !fontDef->loaded) {
-                // **PERFORMANCE FIX**: Disable expensive font loading entirely
-                // Skip expensive font loading - return nullptr to use default font
-                return nullptr;
-            } else if (fontDef && fontDef->loaded) {
-                // Font is already loaded - validate it's still valid
-                if (fontDef->font.texture.id != 0) {
-                    font = &fontDef->font;
-                } else {
-                    std::cerr << "Warning: Previously loaded font is now invalid for role "
-                             << static_cast<int>(role) << ". Using default font." << std::endl;
-                    static Font defaultFont = GetFontDefault();
-                    font = &defaultFont;
-                }
-            } else {
-                // No font definition found
-                std::cerr << "Warning: No font definition found for role "
-                         << static_cast<int>(role) << ". Using default font." << std::endl;
-                static Font defaultFont = GetFontDefault();
-                font = &defaultFont;
-            }
+        const FontDefinition* fontDef = it->second->getFont(role);
+        if (fontDef && fontDef->isLoaded()) {
+            font = &fontDef->font;
+        } else if (fontDef && !fontDef->filePath.empty()) {
+            // Loads in the background; processFontUploads() invalidates this entry when it lands
+            fontLoader_.request(fontDef->filePath);
         }
+    }
 
-        // Store in cache
-        if (font) {
-            uint32_t cacheIndex = cacheKey % UI_FONT_CACHE_SIZE;
-            fontCache_[cacheIndex] = font;
-            fontCacheValid_[cacheIndex] = 1;
+    // Null is cached too: the default font stays in use until an upload or theme switch
+    fontCache_[cacheIndex] = font;
+    fontCacheValid_[cacheIndex] = 1;
+    return font;
+}
+
+void ThemeManager::processFontUploads(float budgetMs) {
+    if (fontLoader_.getPendingCount() == 0) return;
+    MemoryTagScope memoryTag(MemoryTag::THEME);
+    if (fontLoader_.processUploads(budgetMs) == 0) return;
+
+    // Point every theme's definitions at the shared atlases; themes reuse font files
+    for (auto& [variant, theme] : themes_) {
+        for (size_t i = 0; i < static_cast<size_t>(FontRole::FONT_ROLE_COUNT); ++i) {
+            const FontDefinition* fontDef = theme->getFont(static_cast<FontRole>(i));
+            const Font* font = fontDef ? fontLoader_.find(fontDef->filePath) : nullptr;
+            if (font && !fontDef->loaded) {
+                fontDef->font = *font;
+                fontDef->loaded = true;
+            }
         }
-
-        return font;
     }
-
-    // No theme found
-    std::cerr << "Warning: No theme found for variant " << static_cast<int>(currentVariant_)
-             << ". Using default font." << std::endl;
-    static Font defaultFont = GetFontDefault();
-    return &defaultFont;
-}
-
-float ThemeManager::getSpacing(SpacingRole role) const noexcept {
-    auto it = themes_.find(currentVariant_);
-    if (it != themes_.end()) {
-        return it->second->getSpacing(role);
+    ++fontGeneration_;
+    TextLayoutCache::getInstance().clear();  // Keyed by atlas texture id, which the GPU may recycle
+    updateFontCache();
+}
+
+void ThemeManager::unloadFonts() {
+    for (auto& [variant, theme] : themes_) {
+        for (size_t i = 0; i < static_cast<size_t>(FontRole::FONT_ROLE_COUNT); ++i) {
+            const FontDefinition* fontDef = theme->getFont(static_cast<FontRole>(i));
+            if (fontDef) {
+                fontDef->font = Font{};
+                fontDef->loaded = false;
+            }
+        }
     }
-    return 8.0f; // Default spacing
-}
-
-uint32_t ThemeManager::getCacheKey(ColorRole role, float alpha) const noexcept {
-    // Create a unique key from role and alpha using a better distribution
-    uint32_t roleInt = static_cast<uint32_t>(role);
-    uint32_t alphaInt = static_cast<uint32_t>(alpha * 1000.0f); // Convert to integer
-
-    // Use a simple hash-like function to distribute keys better
-    // This avoids the collision issue with the previous bit-shifting approach
-    uint32_t combined = roleInt * 31 + alphaInt * 7;  // Use prime numbers for better distribution
-    return combined % UI_COLOR_CACHE_SIZE;
+    fontLoader_.unloadAll();
+    ++fontGeneration_;
+    TextLayoutCache::getInstance().clear();  // Keyed by atlas texture id, which the GPU may recycle
+    updateFontCache();
 }
 
 uint32_t ThemeManager::getFontCacheKey(FontRole role) const noexcept {
     return static_cast<uint32_t>(role);
 }
 
-void ThemeManager::updateColorCache() const {
-    std::fill(cacheValid_.begin(), cacheValid_.end(), 0);
-}
-
 void ThemeManager::updateFontCache() const {
     std::fill(fontCacheValid_.begin(), fontCacheValid_.end(), 0);
 }
@@ -577,12 +716,8 @@ void DebugPrintThemeColors(ThemeVariant variant) {
     // Print all color roles
     for (int i = 0; i < static_cast<int>(ColorRole::COLOR_ROLE_COUNT); ++i) {
         ColorRole role = static_cast<ColorRole>(i);
-        uint32_t cacheKey = mgr.getCacheKey(role, 1.0f);
-        uint32_t cacheIndex = cacheKey % UI_COLOR_CACHE_SIZE;
-
         Color color = mgr.getColor(role);
-        std::cout << "Role " << i << " CacheKey: " << cacheKey << " CacheIndex: " << cacheIndex
-                  << " Color: (" << (int)color.r << "," << (int)color.g << "," << (int)color.b << ")" << std::endl;
+        std::cout << "Role " << i << " Color: (" << (int)color.r << "," << (int)color.g << "," << (int)color.b << ")" << std::endl;
     }
     std::cout << "=== END THEME COLOR DEBUG ===" << std::endl;
 }
@@ -3,6 +3,7 @@
 #define UI_THEME_OPTIMIZED_H
 
 #include "raylib.h"
+#include "ui_font_loader.h"
 #include <unordered_map>
 #include <string>
 #include <memory>
@@ -13,7 +14,6 @@
 // PERFORMANCE OPTIMIZATIONS
 // ============================================================================
 
-#define UI_COLOR_CACHE_SIZE 256
 #define UI_FONT_CACHE_SIZE 16
 #define UI_THEME_VERSION "1.0.0"
 
@@ -101,7 +101,8 @@ struct ThemeMetrics {
     bool reducedMotion = false;
     std::string locale = "en";
 
-    // Performance metrics
+    // Performance metrics. Colours are a flat table, so every lookup is a hit; lookups are
+    // only counted in debug builds.
     mutable uint64_t colorCacheHits = 0;
     mutable uint64_t colorCacheMisses = 0;
     mutable uint64_t fontCacheHits = 0;
@@ -210,19 +211,49 @@ public:
 
     // Theme management
     bool loadTheme(ThemeVariant variant);
+
+    /// \brief Loads ThemeData::serialize() text as the CUSTOM theme and switches to it.
+    /// Roles the file leaves out keep the active theme's values, so a file can be partial.
+    /// \return False if the file is missing or malformed; the active theme is left as it was.
     bool loadCustomTheme(const std::string& themePath);
     bool saveCurrentTheme(const std::string& themePath) const;
 
-    // Color access (highly optimized)
-    Color getColor(ColorRole role, float alpha = 1.0f) const noexcept;
+    /// \brief Bumped on every theme load, including reloading the same variant.
+    uint32_t getThemeRevision() const { return themeRevision_; }
+
+    /// \brief Active theme colour for `role`, with its alpha scaled by `alpha`. One indexed load.
+    Color getColor(ColorRole role, float alpha = 1.0f) const noexcept {
+#ifdef BROWSERWIND_DEBUG
+        metrics_.colorCacheHits++;
+#endif
+        Color color = activeColors_[static_cast<size_t>(role)];
+        if (alpha != 1.0f) {
+            color.a = static_cast<unsigned char>(color.a * alpha);
+        }
+        return color;
+    }
     Color getColorWithState(ColorRole baseRole, bool hovered = false,
                            bool selected = false, bool pressed = false) const noexcept;
 
-    // Font access (cached)
+    // Font access (cached). Null until the role's font has loaded; callers fall back to the default font.
     const Font* getFont(FontRole role) const noexcept;
 
+    /// \brief Uploads theme fonts rasterized in the background. Call once per frame on the main thread.
+    void processFontUploads(float budgetMs = UIConstants::FONT_UPLOAD_BUDGET_MS);
+
+    /// \brief Shader to draw theme fonts with; they are distance-field atlases.
+    const Shader& getFontShader() const { return fontLoader_.getShader(); }
+
+    /// \brief Bumped whenever theme fonts load or unload, so retained text can be redrawn.
+    uint32_t getFontGeneration() const { return fontGeneration_; }
+
+    /// \brief Unloads the theme font atlases. Needs the GL context.
+    void unloadFonts();
+
     // Spacing access
-    float getSpacing(SpacingRole role) const noexcept;
+    float getSpacing(SpacingRole role) const noexcept {
+        return activeSpacing_[static_cast<size_t>(role)];
+    }
 
     // Theme switching
     bool switchTheme(ThemeVariant variant);
@@ -248,9 +279,6 @@ public:
     bool modifyColor(ColorRole role, const Color& newColor);
     bool modifyFont(FontRole role, const std::string& fontPath, int baseSize);
 
-    // Debug functions
-    uint32_t getCacheKey(ColorRole role, float alpha = 1.0f) const noexcept;
-
     // Validation
     bool validateCurrentTheme() const;
     std::vector<std::string> getValidationErrors() const;
@@ -268,15 +296,17 @@ private:
     ThemeVariant currentVariant_ = ThemeVariant::CLASSIC;
     ThemeMetrics metrics_;
 
-    // Performance caches
-    mutable std::array<Color, UI_COLOR_CACHE_SIZE> colorCache_;
-    mutable std::array<uint8_t, UI_COLOR_CACHE_SIZE> cacheValid_;
-    mutable uint32_t cacheIndex_ = 0;
+    // Active theme, resolved by loadTheme() so lookups never touch themes_
+    std::array<Color, static_cast<size_t>(ColorRole::COLOR_ROLE_COUNT)> activeColors_{};
+    std::array<float, static_cast<size_t>(SpacingRole::SPACING_ROLE_COUNT)> activeSpacing_{};
 
     // Font cache
     mutable std::array<const Font*, UI_FONT_CACHE_SIZE> fontCache_;
     mutable std::array<uint8_t, UI_FONT_CACHE_SIZE> fontCacheValid_;
     mutable uint32_t fontCacheIndex_ = 0;
+    mutable FontLoader fontLoader_;  // getFont() requests fonts on first use
+    uint32_t fontGeneration_ = 0;
+    uint32_t themeRevision_ = 0;
 
     // Internal methods
     void initializeDefaultThemes();
@@ -287,7 +317,6 @@ private:
 
     uint32_t getFontCacheKey(FontRole role) const noexcept;
 
-    void updateColorCache() const;
     void updateFontCache() const;
 };
 
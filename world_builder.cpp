@@ -2,8 +2,12 @@
 #include "world_builder.h"
 #include "environmental_object.h"
 #include "constants.h"
+#include "world_pack.h"
+#include "job_system.h"
 #include <iostream>
 #include <memory>
+#include <cmath>
+#include <unordered_map>
 
 void initializeWorld(EnvironmentManager& environment) {
     try {
@@ -84,6 +88,9 @@ void initializeWorld(EnvironmentManager& environment) {
         }
         std::cout << "WorldBuilder: Created " << treePositions.size() << " trees around town" << std::endl;
 
+        // Re-bucket now that every object is placed so grid cells are sized from real bounds
+        environment.rebuildSpatialGrid();
+
         std::cout << "WorldBuilder: Complete town world initialization finished successfully!" << std::endl;
         std::cout << "WorldBuilder: Created buildings, well, and environmental objects" << std::endl;
 
@@ -91,4 +98,387 @@ void initializeWorld(EnvironmentManager& environment) {
         std::cerr << "WorldBuilder: Exception during world initialization: " << e.what() << std::endl;
         std::cout << "WorldBuilder: Continuing with minimal world setup" << std::endl;
     }
-}
\ No newline at end of file
+}
+
+namespace {
+
+// Forest cells ring the resident town; the town's own cells stay empty
+constexpr int FOREST_CELL_RADIUS = 8;
+constexpr int TOWN_CELL_RADIUS = 1;
+constexpr int TREES_PER_CELL = 6;
+
+}  // namespace
+
+void registerStreamedWorld(WorldStreamer& streamer) {
+    const float cellSize = EnvironmentConstants::WORLD_CELL_SIZE;
+
+    ObjectPlacement placement;
+    placement.type = ObjectPlacement::Type::TREE;
+    placement.tree = {
+        .trunkRadius = EnvironmentConstants::TREE_TRUNK_RADIUS,
+        .trunkHeight = EnvironmentConstants::TREE_TRUNK_HEIGHT,
+        .foliageRadius = EnvironmentConstants::TREE_FOLIAGE_RADIUS
+    };
+
+    int registered = 0;
+    for (int cx = -FOREST_CELL_RADIUS; cx < FOREST_CELL_RADIUS; ++cx) {
+        for (int cz = -FOREST_CELL_RADIUS; cz < FOREST_CELL_RADIUS; ++cz) {
+            if (cx >= -TOWN_CELL_RADIUS && cx < TOWN_CELL_RADIUS && cz >= -TOWN_CELL_RADIUS && cz < TOWN_CELL_RADIUS) {
+                continue;
+            }
+            // Deterministic per-cell hash so the same trees come back after an unload
+            uint32_t seed = static_cast<uint32_t>(cx * 73856093) ^ static_cast<uint32_t>(cz * 19349663);
+            for (int t = 0; t < TREES_PER_CELL; ++t) {
+                seed = seed * 1664525u + 1013904223u;
+                float u = (seed >> 8) / 16777216.0f;
+                seed = seed * 1664525u + 1013904223u;
+                float v = (seed >> 8) / 16777216.0f;
+                // Inset so foliage stays inside the cell
+                float inset = EnvironmentConstants::TREE_FOLIAGE_RADIUS;
+                placement.position = {cx * cellSize + inset + u * (cellSize - 2.0f * inset), 0.0f,
+                                      cz * cellSize + inset + v * (cellSize - 2.0f * inset)};
+                streamer.addPlacement(placement);
+                ++registered;
+            }
+        }
+    }
+    std::cout << "WorldBuilder: Registered " << registered << " streamed trees in " << streamer.getCellCount() << " cells" << std::endl;
+}
+
+size_t getDefaultWorldObjectCount(const EnvironmentManager& environment) {
+    constexpr int FOREST_CELLS = (2 * FOREST_CELL_RADIUS) * (2 * FOREST_CELL_RADIUS) - (2 * TOWN_CELL_RADIUS) * (2 * TOWN_CELL_RADIUS);
+    return environment.getAllObjects().size() + FOREST_CELLS * TREES_PER_CELL;
+}
+
+namespace {
+
+// Cell layout: a road along every cell edge, and the block inside split into PLOTS x PLOTS
+constexpr float ROAD_HALF_WIDTH = 3.0f;
+constexpr int PLOTS = 2;
+constexpr float PLOT_MARGIN = 1.0f;
+constexpr size_t CELLS_PER_JOB = 16;
+
+// Per-cell generator; the same seed and cell always give the same stream
+struct TownRandom {
+    uint32_t state;
+
+    TownRandom(uint32_t seed, int cx, int cz) {
+        // Mixed so neighbouring cells and seeds don't start on correlated LCG streams
+        uint32_t h = seed ^ (static_cast<uint32_t>(cx) * 73856093u) ^ (static_cast<uint32_t>(cz) * 19349663u);
+        h ^= h >> 16;
+        h *= 0x7FEB352Du;
+        h ^= h >> 15;
+        h *= 0x846CA68Bu;
+        h ^= h >> 16;
+        state = h;
+    }
+
+    float next() {
+        state = state * 1664525u + 1013904223u;
+        return (state >> 8) / 16777216.0f;
+    }
+
+    float range(float lo, float hi) { return lo + next() * (hi - lo); }
+};
+
+const Color BUILDING_COLORS[] = {BEIGE, BROWN, DARKBROWN, MAROON, GRAY, DARKBLUE, DARKGREEN, GOLD};
+const char* const BUILDING_NAMES[] = {"House", "Cottage", "Workshop", "Storehouse", "Inn", "Smithy"};
+
+// Cells of the ring `ring` around the hand-built town, which covers [-TOWN_CELL_RADIUS, TOWN_CELL_RADIUS)
+void collectRing(int ring, std::vector<std::pair<int, int>>& cells) {
+    cells.clear();
+    int lo = -TOWN_CELL_RADIUS - ring, hi = TOWN_CELL_RADIUS + ring - 1;
+    for (int cx = lo; cx <= hi; ++cx) {
+        for (int cz = lo; cz <= hi; ++cz) {
+            if (cx == lo || cx == hi || cz == lo || cz == hi) {
+                cells.push_back({cx, cz});
+            }
+        }
+    }
+}
+
+void generateCell(uint32_t seed, int cx, int cz, std::vector<ObjectPlacement>& out) {
+    const float cellSize = EnvironmentConstants::WORLD_CELL_SIZE;
+    const float plotSize = (cellSize - 2.0f * ROAD_HALF_WIDTH) / PLOTS;
+    TownRandom random(seed, cx, cz);
+
+    ObjectPlacement placement{};  // Zeroed, so the configs a type doesn't use hold no garbage
+    for (int px = 0; px < PLOTS; ++px) {
+        for (int pz = 0; pz < PLOTS; ++pz) {
+            float x0 = cx * cellSize + ROAD_HALF_WIDTH + px * plotSize + PLOT_MARGIN;
+            float z0 = cz * cellSize + ROAD_HALF_WIDTH + pz * plotSize + PLOT_MARGIN;
+            float usable = plotSize - 2.0f * PLOT_MARGIN;
+            float roll = random.next();
+
+            if (roll < 0.55f) {
+                placement.type = ObjectPlacement::Type::BUILDING;
+                Vector3 size = {random.range(5.0f, usable), random.range(3.0f, 6.0f), random.range(5.0f, usable - 2.0f)};
+                // Doors face the road along the plot's outer edge
+                float doorSide = pz == 0 ? -1.0f : 1.0f;
+                placement.building = BuildingConfig{};
+                placement.building.id = -1;  // Not enterable, so no interior needs to find it
+                placement.building.size = size;
+                placement.building.color = BUILDING_COLORS[static_cast<size_t>(random.next() * 8.0f) % 8];
+                placement.building.name = BUILDING_NAMES[static_cast<size_t>(random.next() * 6.0f) % 6];
+                placement.building.door = {
+                    .offset = {0.0f, 0.0f, doorSide * (size.z * 0.5f + 0.1f)},
+                    .width = EnvironmentConstants::BUILDING_DOOR_WIDTH,
+                    .height = EnvironmentConstants::BUILDING_DOOR_HEIGHT,
+                    .rotation = 0.0f,
+                    .color = BROWN
+                };
+                placement.building.canEnter = false;
+                float slackX = usable - size.x, slackZ = usable - size.z;
+                // Pushed toward the road it faces, leaving a yard behind
+                float offsetZ = pz == 0 ? slackZ * 0.25f * random.next() : slackZ * (1.0f - 0.25f * random.next());
+                placement.position = {x0 + size.x * 0.5f + slackX * random.next(), size.y * 0.5f, z0 + size.z * 0.5f + offsetZ};
+                out.push_back(placement);
+            } else if (roll < 0.8f) {
+                placement.type = ObjectPlacement::Type::TREE;
+                placement.tree = {
+                    .trunkRadius = EnvironmentConstants::TREE_TRUNK_RADIUS,
+                    .trunkHeight = random.range(0.75f, 1.25f) * EnvironmentConstants::TREE_TRUNK_HEIGHT,
+                    .foliageRadius = EnvironmentConstants::TREE_FOLIAGE_RADIUS
+                };
+                int trees = 1 + static_cast<int>(random.next() * 3.0f);
+                float inset = EnvironmentConstants::TREE_FOLIAGE_RADIUS;
+                for (int t = 0; t < trees; ++t) {
+                    placement.position = {x0 + inset + random.next() * (usable - 2.0f * inset), 0.0f,
+                                          z0 + inset + random.next() * (usable - 2.0f * inset)};
+                    out.push_back(placement);
+                }
+            } else if (roll < 0.85f) {
+                placement.type = ObjectPlacement::Type::WELL;
+                placement.well = {
+                    .baseRadius = EnvironmentConstants::WELL_BASE_RADIUS,
+                    .height = EnvironmentConstants::WELL_HEIGHT
+                };
+                placement.position = {x0 + usable * 0.5f, placement.well.height * 0.5f, z0 + usable * 0.5f};
+                out.push_back(placement);
+            }
+            // Otherwise an empty yard
+        }
+    }
+}
+
+}  // namespace
+
+std::vector<ObjectPlacement> generateTown(const TownOptions& options) {
+    std::vector<ObjectPlacement> town;
+    std::vector<std::pair<int, int>> cells;
+    std::vector<std::vector<ObjectPlacement>> generated;
+    JobSystem& jobs = JobSystem::getInstance();
+
+    // Ring by ring, so the town grows outward evenly; cells land in ring order whatever thread ran them
+    for (int ring = 1; town.size() < options.objectCount; ++ring) {
+        collectRing(ring, cells);
+        generated.assign(cells.size(), {});
+        jobs.parallelFor(cells.size(), CELLS_PER_JOB, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                generateCell(options.seed, cells[i].first, cells[i].second, generated[i]);
+            }
+        });
+        for (std::vector<ObjectPlacement>& cell : generated) {
+            for (ObjectPlacement& placement : cell) {
+                town.push_back(std::move(placement));
+            }
+        }
+    }
+    if (town.size() > options.objectCount) {
+        town.resize(options.objectCount);  // Drops the tail of the last ring
+    }
+    return town;
+}
+
+size_t registerGeneratedTown(WorldStreamer& streamer, const TownOptions& options) {
+    std::vector<ObjectPlacement> town = generateTown(options);
+    size_t buildings = 0;
+    for (const ObjectPlacement& placement : town) {
+        if (placement.type == ObjectPlacement::Type::BUILDING) ++buildings;
+        streamer.addPlacement(placement);
+    }
+    std::cout << "WorldBuilder: Generated town (seed " << options.seed << "): " << town.size() << " placements, "
+              << buildings << " buildings, in " << streamer.getCellCount() << " cells" << std::endl;
+    return town.size();
+}
+
+bool loadWorldPack(const std::string& path, EnvironmentManager& environment, WorldStreamer& streamer,
+                   LoadedWorldPack* loaded) {
+    WorldPackReader reader;
+    if (!reader.open(path)) {
+        return false;
+    }
+
+    // One entry reused for every record, so only building names allocate
+    WorldPackEntry entry;
+    size_t resident = 0, streamed = 0;
+    if (loaded) {
+        loaded->records.clear();
+        loaded->records.reserve(reader.getRecordCount());
+    }
+    for (size_t i = 0; i < reader.getRecordCount(); ++i) {
+        reader.decode(i, entry);
+        LoadedWorldPack::Record record;
+        record.streamed = entry.streamed;
+        if (entry.streamed) {
+            streamer.addPlacement(entry.placement);
+            record.placement = entry.placement;
+            ++streamed;
+        } else {
+            record.object = entry.placement.create();
+            environment.addObject(record.object);
+            ++resident;
+        }
+        if (loaded) {
+            record.hash = reader.hashRecord(i);
+            loaded->records.push_back(std::move(record));
+        }
+    }
+    if (resident > 0) {
+        environment.rebuildSpatialGrid();
+    }
+
+    std::cout << "WorldBuilder: Loaded pack " << path << " (" << resident << " resident, " << streamed << " streamed)" << std::endl;
+    return true;
+}
+
+bool reloadWorldPack(const std::string& path, EnvironmentManager& environment, WorldStreamer& streamer,
+                     LoadedWorldPack& loaded) {
+    WorldPackReader reader;
+    if (!reader.open(path)) {
+        std::cout << "WorldBuilder: Reload of " << path << " failed, keeping the loaded pack" << std::endl;
+        return false;
+    }
+
+    // Match new records to old ones by content; each old record can be claimed once
+    std::unordered_multimap<uint64_t, size_t> previous;
+    previous.reserve(loaded.records.size());
+    for (size_t i = 0; i < loaded.records.size(); ++i) {
+        previous.emplace(loaded.records[i].hash, i);
+    }
+
+    LoadedWorldPack next;
+    next.records.reserve(reader.getRecordCount());
+    std::vector<bool> kept(loaded.records.size(), false);
+    std::vector<std::shared_ptr<EnvironmentalObject>> removedObjects;
+    std::vector<ObjectPlacement> removedPlacements, addedPlacements;
+    WorldPackEntry entry;
+    size_t addedResident = 0;
+
+    for (size_t i = 0; i < reader.getRecordCount(); ++i) {
+        uint64_t hash = reader.hashRecord(i);
+        auto match = previous.find(hash);
+        if (match != previous.end()) {
+            kept[match->second] = true;
+            next.records.push_back(std::move(loaded.records[match->second]));
+            previous.erase(match);
+            continue;
+        }
+        reader.decode(i, entry);
+        LoadedWorldPack::Record record;
+        record.hash = hash;
+        record.streamed = entry.streamed;
+        if (entry.streamed) {
+            record.placement = entry.placement;
+            addedPlacements.push_back(entry.placement);
+        } else {
+            record.object = entry.placement.create();
+            environment.addObject(record.object);
+            ++addedResident;
+        }
+        next.records.push_back(std::move(record));
+    }
+
+    for (size_t i = 0; i < loaded.records.size(); ++i) {
+        if (kept[i]) continue;
+        LoadedWorldPack::Record& record = loaded.records[i];
+        if (record.streamed) {
+            removedPlacements.push_back(record.placement);
+        } else if (record.object) {
+            removedObjects.push_back(std::move(record.object));
+        }
+    }
+
+    if (!removedObjects.empty()) {
+        environment.removeObjects(removedObjects);
+    }
+    size_t restreamed = 0;
+    if (!removedPlacements.empty() || !addedPlacements.empty()) {
+        restreamed = streamer.patchPlacements(environment, removedPlacements, addedPlacements);
+    }
+    loaded = std::move(next);
+
+    std::cout << "WorldBuilder: Reloaded pack " << path << ": " << addedResident << " resident added, "
+              << removedObjects.size() << " removed; " << addedPlacements.size() << " streamed added, "
+              << removedPlacements.size() << " removed (" << restreamed << " loaded cells restreamed)" << std::endl;
+    return true;
+}
+
+void populateBenchmarkProps(EnvironmentManager& environment, int scale) {
+    constexpr int PROPS_PER_RING = 200;
+    constexpr float FIRST_RING_RADIUS = 30.0f;
+    constexpr float RING_SPACING = 6.0f;
+    if (scale <= 1) return;
+
+    TreeConfig tree = {
+        .trunkRadius = EnvironmentConstants::TREE_TRUNK_RADIUS,
+        .trunkHeight = EnvironmentConstants::TREE_TRUNK_HEIGHT,
+        .foliageRadius = EnvironmentConstants::TREE_FOLIAGE_RADIUS
+    };
+    WellConfig well = {
+        .baseRadius = EnvironmentConstants::WELL_BASE_RADIUS,
+        .height = EnvironmentConstants::WELL_HEIGHT
+    };
+
+    int added = 0;
+    uint32_t seed = 0x9E3779B9u;  // Fixed, so every run benchmarks the same layout
+    for (int ring = 1; ring < scale; ++ring) {
+        float radius = FIRST_RING_RADIUS + (ring - 1) * RING_SPACING;
+        for (int i = 0; i < PROPS_PER_RING; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            float jitter = ((seed >> 8) / 16777216.0f - 0.5f) * RING_SPACING * 0.5f;
+            float angle = (i + 0.5f) * 2.0f * PI / PROPS_PER_RING;
+            Vector3 pos = {std::cos(angle) * (radius + jitter), 0.0f, std::sin(angle) * (radius + jitter)};
+            // One well per ten props keeps a second mesh type in the instanced batches
+            if (i % 10 == 0) {
+                environment.addObject(EnvironmentalObjectFactory::createWell(well, pos));
+            } else {
+                environment.addObject(EnvironmentalObjectFactory::createTree(tree, pos));
+            }
+            ++added;
+        }
+    }
+    std::cout << "WorldBuilder: Added " << added << " benchmark props (scale " << scale << ")" << std::endl;
+}
+
+std::vector<Vector3> buildBenchmarkPath(const EnvironmentManager& environment) {
+    constexpr int SQUARE_LOOP_POINTS = 12;
+    constexpr float SQUARE_LOOP_RADIUS = 8.0f;
+    constexpr float DOOR_STANDOFF = 2.0f;
+    const float eye = PlayerConstants::EYE_HEIGHT;
+
+    std::vector<Vector3> path;
+    for (int i = 0; i <= SQUARE_LOOP_POINTS; ++i) {
+        float angle = i * 2.0f * PI / SQUARE_LOOP_POINTS;
+        path.push_back({std::sin(angle) * SQUARE_LOOP_RADIUS, eye, std::cos(angle) * SQUARE_LOOP_RADIUS});
+    }
+
+    for (const Building* building : environment.getBuildings()) {
+        if (!building->isInteractive()) continue;
+
+        Vector3 door = building->getDoorPosition();
+        float dx = door.x - building->position.x;
+        float dz = door.z - building->position.z;
+        float length = std::sqrt(dx * dx + dz * dz);
+        if (length > 0.0f) {
+            dx /= length;
+            dz /= length;
+        }
+        Vector3 outside = {door.x + dx * DOOR_STANDOFF, eye, door.z + dz * DOOR_STANDOFF};
+        path.push_back(outside);
+        path.push_back({door.x, eye, door.z});
+        path.push_back({building->position.x, eye, building->position.z});
+        path.push_back(outside);
+    }
+    return path;
+}
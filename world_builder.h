@@ -3,7 +3,65 @@
 #define WORLD_BUILDER_H
 
 #include "environment_manager.h"
+#include "world_streamer.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
 
 void initializeWorld(EnvironmentManager& environment);
 
+// What a loaded pack put into the world, record by record, so an edited pack can be patched in
+struct LoadedWorldPack {
+    struct Record {
+        uint64_t hash = 0;                               // WorldPackReader::hashRecord
+        bool streamed = false;
+        ObjectPlacement placement;                       // Streamed records: what the streamer holds
+        std::shared_ptr<EnvironmentalObject> object;     // Resident records: the live object
+    };
+    std::vector<Record> records;
+};
+
+// Loads a binary world pack: resident records go into the environment, streamed ones to the streamer.
+// Pass `loaded` to keep what was added for reloadWorldPack. Returns false if the pack is missing or invalid.
+bool loadWorldPack(const std::string& path, EnvironmentManager& environment, WorldStreamer& streamer,
+                   LoadedWorldPack* loaded = nullptr);
+
+// Re-reads a pack loaded with loadWorldPack and applies only the records that changed: removed
+// and added resident objects update their own spatial grid cells, and only the streamed cells
+// with changed placements are unloaded and restreamed. Unchanged records keep their objects.
+// Returns false, changing nothing, if the new pack is invalid.
+bool reloadWorldPack(const std::string& path, EnvironmentManager& environment, WorldStreamer& streamer,
+                     LoadedWorldPack& loaded);
+
+// Registers the streamed outskirts (forest cells around the town) with the streamer
+void registerStreamedWorld(WorldStreamer& streamer);
+
+// Objects in the default world: the hand-built town plus the forest registerStreamedWorld adds
+size_t getDefaultWorldObjectCount(const EnvironmentManager& environment);
+
+// Settings for generateTown
+struct TownOptions {
+    uint32_t seed = 1;
+    size_t objectCount = 0;  // Placements to generate; rings of cells are added until it is reached
+};
+
+// Procedural town around the hand-built one, whose cells stay empty. Roads run along the
+// streaming cell edges and each cell's block is split into plots that hold a building, trees,
+// a well or nothing. Every cell is generated from its own seed, and rings of cells are
+// generated in parallel on the job system, so the output depends only on the options.
+std::vector<ObjectPlacement> generateTown(const TownOptions& options);
+
+// Generates a town and registers it with the streamer in place of the forest. Returns the
+// number of placements added.
+size_t registerGeneratedTown(WorldStreamer& streamer, const TownOptions& options);
+
+// Adds (scale - 1) rings of deterministic props around the town so benchmarks can stress
+// update, LOD and rendering with more objects. Does nothing for scale <= 1.
+void populateBenchmarkProps(EnvironmentManager& environment, int scale);
+
+// Builds a camera tour at eye height: a loop of the town square, then in and out of every
+// enterable building through its door.
+std::vector<Vector3> buildBenchmarkPath(const EnvironmentManager& environment);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,328 @@
+#include "world_pack.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace WorldPackFormat;
+
+namespace {
+
+bool parseFloats(const std::string& text, float* out, int count) {
+    std::istringstream in(text);
+    for (int i = 0; i < count; ++i) {
+        if (!(in >> out[i])) return false;
+        if (in.peek() == ',') in.ignore();
+    }
+    return true;
+}
+
+bool parseColor(const std::string& text, Color& out) {
+    float v[4] = {0.0f, 0.0f, 0.0f, 255.0f};
+    if (!parseFloats(text, v, 3)) return false;
+    parseFloats(text, v, 4);  // Alpha is optional
+    out = {static_cast<unsigned char>(v[0]), static_cast<unsigned char>(v[1]),
+           static_cast<unsigned char>(v[2]), static_cast<unsigned char>(v[3])};
+    return true;
+}
+
+WorldPackEntry defaultEntry() {
+    WorldPackEntry entry;
+    entry.placement.building.size = {4.0f, 4.0f, 4.0f};
+    entry.placement.building.color = BROWN;
+    return entry;
+}
+
+void packColor(Color c, uint8_t out[4]) {
+    out[0] = c.r; out[1] = c.g; out[2] = c.b; out[3] = c.a;
+}
+
+Color unpackColor(const uint8_t in[4]) {
+    return {in[0], in[1], in[2], in[3]};
+}
+
+}  // namespace
+
+bool parseObjectText(std::istream& in, const std::string& sourceName, std::vector<WorldPackEntry>& out) {
+    WorldPackEntry entry = defaultEntry();
+    std::string type;
+    bool hasObject = false;
+
+    auto finish = [&]() {
+        if (!hasObject) return true;
+        if (type == "building") entry.placement.type = ObjectPlacement::Type::BUILDING;
+        else if (type == "well") entry.placement.type = ObjectPlacement::Type::WELL;
+        else if (type == "tree") entry.placement.type = ObjectPlacement::Type::TREE;
+        else {
+            std::cout << "WORLD PACK: Unknown object type '" << type << "' in " << sourceName << std::endl;
+            return false;
+        }
+        out.push_back(entry);
+        entry = defaultEntry();
+        type.clear();
+        hasObject = false;
+        return true;
+    };
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        if (line == "[object]") {
+            if (!finish()) return false;
+            continue;
+        }
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        std::string key = line.substr(0, eq);
+        std::string value = line.substr(eq + 1);
+        hasObject = true;
+
+        ObjectPlacement& p = entry.placement;
+        float v[3] = {0.0f, 0.0f, 0.0f};
+        bool ok = true;
+        if (key == "type") {
+            type = value;
+        } else if (key == "streamed") {
+            entry.streamed = (value == "true");
+        } else if (key == "position") {
+            ok = parseFloats(value, v, 3);
+            p.position = {v[0], v[1], v[2]};
+        } else if (key == "size") {
+            ok = parseFloats(value, v, 3);
+            p.building.size = {v[0], v[1], v[2]};
+        } else if (key == "color") {
+            ok = parseColor(value, p.building.color);
+        } else if (key == "name") {
+            p.building.name = value;
+        } else if (key == "id") {
+            ok = parseFloats(value, v, 1);
+            p.building.id = static_cast<int>(v[0]);
+        } else if (key == "canEnter") {
+            p.building.canEnter = (value == "true");
+        } else if (key == "doorOffset") {
+            ok = parseFloats(value, v, 3);
+            p.building.door.offset = {v[0], v[1], v[2]};
+        } else if (key == "doorWidth") {
+            ok = parseFloats(value, &p.building.door.width, 1);
+        } else if (key == "doorHeight") {
+            ok = parseFloats(value, &p.building.door.height, 1);
+        } else if (key == "doorRotation") {
+            ok = parseFloats(value, &p.building.door.rotation, 1);
+        } else if (key == "doorColor") {
+            ok = parseColor(value, p.building.door.color);
+        } else if (key == "radius") {
+            ok = parseFloats(value, &p.well.baseRadius, 1);
+        } else if (key == "height") {
+            ok = parseFloats(value, &p.well.height, 1);
+        } else if (key == "trunkRadius") {
+            ok = parseFloats(value, &p.tree.trunkRadius, 1);
+        } else if (key == "trunkHeight") {
+            ok = parseFloats(value, &p.tree.trunkHeight, 1);
+        } else if (key == "foliageRadius") {
+            ok = parseFloats(value, &p.tree.foliageRadius, 1);
+        }
+        if (!ok) {
+            std::cout << "WORLD PACK: Bad value for '" << key << "' in " << sourceName << std::endl;
+            return false;
+        }
+    }
+    return finish();
+}
+
+bool writeWorldPack(const std::string& path, const std::vector<WorldPackEntry>& entries) {
+    std::vector<PackRecord> records(entries.size());
+    std::string strings;
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const ObjectPlacement& p = entries[i].placement;
+        PackRecord& r = records[i];
+        std::memset(&r, 0, sizeof(r));
+        r.flags = entries[i].streamed ? STREAMED : 0;
+        r.id = -1;
+        r.position[0] = p.position.x; r.position[1] = p.position.y; r.position[2] = p.position.z;
+
+        switch (p.type) {
+            case ObjectPlacement::Type::BUILDING: {
+                const BuildingConfig& b = p.building;
+                r.type = BUILDING;
+                r.id = b.id;
+                if (b.canEnter) r.flags |= CAN_ENTER;
+                r.params[0] = b.size.x; r.params[1] = b.size.y; r.params[2] = b.size.z;
+                packColor(b.color, r.color);
+                r.door_offset[0] = b.door.offset.x; r.door_offset[1] = b.door.offset.y; r.door_offset[2] = b.door.offset.z;
+                r.door_width = b.door.width;
+                r.door_height = b.door.height;
+                r.door_rotation = b.door.rotation;
+                packColor(b.door.color, r.door_color);
+                r.name_offset = static_cast<uint32_t>(strings.size());
+                r.name_length = static_cast<uint32_t>(b.name.size());
+                strings += b.name;
+                break;
+            }
+            case ObjectPlacement::Type::WELL:
+                r.type = WELL;
+                r.params[0] = p.well.baseRadius; r.params[1] = p.well.height;
+                break;
+            case ObjectPlacement::Type::TREE:
+                r.type = TREE;
+                r.params[0] = p.tree.trunkRadius; r.params[1] = p.tree.trunkHeight; r.params[2] = p.tree.foliageRadius;
+                break;
+        }
+    }
+
+    PackHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.record_count = static_cast<uint32_t>(records.size());
+    header.record_size = sizeof(PackRecord);
+    header.strings_offset = static_cast<uint32_t>(sizeof(PackHeader) + records.size() * sizeof(PackRecord));
+    header.strings_size = static_cast<uint32_t>(strings.size());
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cout << "WORLD PACK: Cannot write " << path << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(PackRecord)));
+    file.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+    return static_cast<bool>(file);
+}
+
+WorldPackReader::~WorldPackReader() {
+    close();
+}
+
+bool WorldPackReader::open(const std::string& path) {
+    close();
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            data_ = static_cast<const uint8_t*>(mapping);
+            size_ = static_cast<size_t>(st.st_size);
+            mapped_ = true;
+        }
+    }
+    ::close(fd);
+#endif
+
+    if (!data_) {
+        // No mmap (or it failed): read the whole file once instead
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+        fallback_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data_ = fallback_.data();
+        size_ = fallback_.size();
+    }
+
+    if (size_ < sizeof(PackHeader)) {
+        std::cout << "WORLD PACK: " << path << " is too small to be a pack" << std::endl;
+        close();
+        return false;
+    }
+
+    const auto* header = reinterpret_cast<const PackHeader*>(data_);
+    uint64_t recordsEnd = sizeof(PackHeader) + uint64_t(header->record_count) * sizeof(PackRecord);
+    uint64_t stringsEnd = uint64_t(header->strings_offset) + header->strings_size;
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION ||
+        header->record_size != sizeof(PackRecord) || recordsEnd > size_ ||
+        header->strings_offset < recordsEnd || stringsEnd > size_) {
+        std::cout << "WORLD PACK: " << path << " has a bad header or unsupported version" << std::endl;
+        close();
+        return false;
+    }
+
+    header_ = header;
+    records_ = reinterpret_cast<const PackRecord*>(data_ + sizeof(PackHeader));
+    strings_ = reinterpret_cast<const char*>(data_ + header->strings_offset);
+    return true;
+}
+
+void WorldPackReader::close() {
+#ifndef _WIN32
+    if (mapped_) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+#endif
+    fallback_.clear();
+    fallback_.shrink_to_fit();
+    data_ = nullptr;
+    size_ = 0;
+    header_ = nullptr;
+    records_ = nullptr;
+    strings_ = nullptr;
+    mapped_ = false;
+}
+
+void WorldPackReader::decode(size_t index, WorldPackEntry& out) const {
+    const PackRecord& r = records_[index];
+    ObjectPlacement& p = out.placement;
+    out.streamed = (r.flags & STREAMED) != 0;
+    p.position = {r.position[0], r.position[1], r.position[2]};
+
+    switch (r.type) {
+        case BUILDING: {
+            p.type = ObjectPlacement::Type::BUILDING;
+            BuildingConfig& b = p.building;
+            b.id = r.id;
+            b.size = {r.params[0], r.params[1], r.params[2]};
+            b.color = unpackColor(r.color);
+            b.canEnter = (r.flags & CAN_ENTER) != 0;
+            b.door.offset = {r.door_offset[0], r.door_offset[1], r.door_offset[2]};
+            b.door.width = r.door_width;
+            b.door.height = r.door_height;
+            b.door.rotation = r.door_rotation;
+            b.door.color = unpackColor(r.door_color);
+            // Clamp to the table so a corrupt record can't read past the mapping
+            uint32_t offset = std::min(r.name_offset, header_->strings_size);
+            uint32_t length = std::min(r.name_length, header_->strings_size - offset);
+            b.name.assign(strings_ + offset, length);
+            break;
+        }
+        case WELL:
+            p.type = ObjectPlacement::Type::WELL;
+            p.well.baseRadius = r.params[0];
+            p.well.height = r.params[1];
+            break;
+        case TREE:
+        default:
+            p.type = ObjectPlacement::Type::TREE;
+            p.tree.trunkRadius = r.params[0];
+            p.tree.trunkHeight = r.params[1];
+            p.tree.foliageRadius = r.params[2];
+            break;
+    }
+}
+
+uint64_t WorldPackReader::hashRecord(size_t index) const {
+    PackRecord r = records_[index];
+    uint32_t offset = std::min(r.name_offset, header_->strings_size);
+    uint32_t length = std::min(r.name_length, header_->strings_size - offset);
+    r.name_offset = 0;
+
+    // FNV-1a over the record, then its name
+    uint64_t hash = 1469598103934665603ull;
+    auto mix = [&hash](const uint8_t* bytes, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+    mix(reinterpret_cast<const uint8_t*>(&r), sizeof(r));
+    mix(reinterpret_cast<const uint8_t*>(strings_ + offset), length);
+    return hash;
+}
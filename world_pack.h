@@ -0,0 +1,115 @@
+#ifndef WORLD_PACK_H
+#define WORLD_PACK_H
+
+#include "world_streamer.h"
+#include <string>
+#include <vector>
+#include <istream>
+#include <cstdint>
+#include <cstddef>
+
+// ============================================================================
+// ON-DISK FORMAT (little-endian, version 1)
+//
+//   PackHeader
+//   PackRecord[record_count]
+//   string table (building names, not NUL-terminated)
+// ============================================================================
+
+namespace WorldPackFormat {
+    constexpr char MAGIC[4] = {'B', 'W', 'P', 'K'};
+    constexpr uint32_t VERSION = 1;
+
+    enum RecordType : uint8_t { BUILDING = 0, WELL = 1, TREE = 2 };
+    enum RecordFlags : uint8_t { CAN_ENTER = 1 << 0, STREAMED = 1 << 1 };
+
+    struct PackHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t record_count;
+        uint32_t record_size;       // sizeof(PackRecord) when written, checked on load
+        uint32_t strings_offset;    // From file start
+        uint32_t strings_size;
+    };
+
+    struct PackRecord {
+        uint8_t type;
+        uint8_t flags;
+        uint16_t reserved;
+        int32_t id;                 // Building id, -1 otherwise
+        float position[3];
+        float params[3];            // Building size | well {radius, height, 0} | tree {trunkRadius, trunkHeight, foliageRadius}
+        uint8_t color[4];
+        float door_offset[3];
+        float door_width, door_height, door_rotation;
+        uint8_t door_color[4];
+        uint32_t name_offset;       // Into the string table
+        uint32_t name_length;
+    };
+
+    static_assert(sizeof(PackHeader) == 24, "PackHeader layout is part of the file format");
+    static_assert(sizeof(PackRecord) == 72, "PackRecord layout is part of the file format");
+}
+
+/// \brief An object placement plus whether it belongs to a streamed cell or the resident world.
+struct WorldPackEntry {
+    ObjectPlacement placement;
+    bool streamed = false;
+};
+
+/// \brief Parses key=value object descriptions (the format loadObjectAsync reads).
+/// A line `[object]` starts a new object; text without one describes a single object.
+/// \param in Input stream.
+/// \param sourceName Name used in error messages.
+/// \param out Parsed entries are appended here.
+/// \return False on a malformed value or unknown type.
+bool parseObjectText(std::istream& in, const std::string& sourceName, std::vector<WorldPackEntry>& out);
+
+/// \brief Writes entries as a binary pack.
+/// \param path Output file.
+/// \param entries Entries to write.
+/// \return True on success.
+bool writeWorldPack(const std::string& path, const std::vector<WorldPackEntry>& entries);
+
+/// \brief Read-only view of a pack file, memory-mapped where the platform allows.
+///
+/// Records are decoded straight from the mapping into factory configs; nothing is parsed
+/// or copied up front. The mapping lives as long as the reader.
+class WorldPackReader {
+public:
+    WorldPackReader() = default;
+    ~WorldPackReader();
+    WorldPackReader(const WorldPackReader&) = delete;
+    WorldPackReader& operator=(const WorldPackReader&) = delete;
+
+    /// \brief Maps and validates a pack.
+    /// \param path Pack file.
+    /// \return False if missing, truncated, or the wrong version.
+    bool open(const std::string& path);
+
+    /// \brief Unmaps the file.
+    void close();
+
+    /// \brief Gets number of records.
+    size_t getRecordCount() const { return header_ ? header_->record_count : 0; }
+
+    /// \brief Decodes one record into factory configs.
+    /// \param index Record index.
+    /// \param out Entry to fill; the building name is the only allocation.
+    void decode(size_t index, WorldPackEntry& out) const;
+
+    /// \brief Hashes a record's contents, so reloads can tell which records changed.
+    /// Where its name sits in the string table doesn't count; the name itself does.
+    uint64_t hashRecord(size_t index) const;
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    const WorldPackFormat::PackHeader* header_ = nullptr;
+    const WorldPackFormat::PackRecord* records_ = nullptr;
+    const char* strings_ = nullptr;
+    bool mapped_ = false;                 // False when the fallback buffer holds the file
+    std::vector<uint8_t> fallback_;
+};
+
+#endif
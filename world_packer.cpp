@@ -0,0 +1,40 @@
+// world_packer.cpp - Offline tool: packs text object descriptions into a binary world pack
+#include "world_pack.h"
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cout << "Usage: " << argv[0] << " <output.bwpk> <objects.txt>..." << std::endl;
+        std::cout << "  Inputs use the key=value object format; '[object]' separates objects." << std::endl;
+        return 1;
+    }
+
+    std::vector<WorldPackEntry> entries;
+    for (int i = 2; i < argc; ++i) {
+        std::ifstream in(argv[i]);
+        if (!in) {
+            std::cout << "WORLD PACKER: Cannot open " << argv[i] << std::endl;
+            return 1;
+        }
+        size_t before = entries.size();
+        if (!parseObjectText(in, argv[i], entries)) {
+            return 1;
+        }
+        std::cout << "WORLD PACKER: " << argv[i] << ": " << (entries.size() - before) << " objects" << std::endl;
+    }
+
+    if (!writeWorldPack(argv[1], entries)) {
+        return 1;
+    }
+
+    // Read back through the runtime path so a bad pack never ships
+    WorldPackReader reader;
+    if (!reader.open(argv[1]) || reader.getRecordCount() != entries.size()) {
+        std::cout << "WORLD PACKER: Verification of " << argv[1] << " failed" << std::endl;
+        return 1;
+    }
+    std::cout << "WORLD PACKER: Wrote " << entries.size() << " objects to " << argv[1] << std::endl;
+    return 0;
+}
@@ -0,0 +1,269 @@
+#include "world_streamer.h"
+#include "environment_manager.h"
+#include "spatial_audio.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+// Per-object cost outside the object itself: manager slot, cached bounds, collider SoA row,
+// a few grid entries, and the component map nodes (two components per object)
+constexpr size_t INDEX_BYTES_PER_OBJECT =
+    sizeof(std::shared_ptr<EnvironmentalObject>) + sizeof(int) + sizeof(BoundingBox) +
+    7 * sizeof(float) + sizeof(Vector3) + sizeof(CollisionBounds) + 8 * sizeof(uint32_t);
+constexpr size_t COMPONENT_NODE_BYTES = sizeof(std::string) + sizeof(std::unique_ptr<Component>) + 4 * sizeof(void*);
+
+bool sameColor(Color a, Color b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+bool sameVector(Vector3 a, Vector3 b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+// Exact match: placements come from the same decoder, so equal records give equal fields
+bool samePlacement(const ObjectPlacement& a, const ObjectPlacement& b) {
+    if (a.type != b.type || !sameVector(a.position, b.position)) return false;
+    switch (a.type) {
+        case ObjectPlacement::Type::BUILDING: {
+            const BuildingConfig& x = a.building;
+            const BuildingConfig& y = b.building;
+            return x.id == y.id && sameVector(x.size, y.size) && sameColor(x.color, y.color) && x.name == y.name &&
+                   x.canEnter == y.canEnter && sameVector(x.door.offset, y.door.offset) && x.door.width == y.door.width &&
+                   x.door.height == y.door.height && x.door.rotation == y.door.rotation &&
+                   sameColor(x.door.color, y.door.color);
+        }
+        case ObjectPlacement::Type::WELL:
+            return a.well.baseRadius == b.well.baseRadius && a.well.height == b.well.height;
+        case ObjectPlacement::Type::TREE:
+            return a.tree.trunkRadius == b.tree.trunkRadius && a.tree.trunkHeight == b.tree.trunkHeight &&
+                   a.tree.foliageRadius == b.tree.foliageRadius;
+    }
+    return false;
+}
+
+}  // namespace
+
+std::shared_ptr<EnvironmentalObject> ObjectPlacement::create() const {
+    switch (type) {
+        case Type::BUILDING: return EnvironmentalObjectFactory::createBuilding(building, position);
+        case Type::WELL:     return EnvironmentalObjectFactory::createWell(well, position);
+        case Type::TREE:
+        default:             return EnvironmentalObjectFactory::createTree(tree, position);
+    }
+}
+
+size_t ObjectPlacement::estimateBytes() const {
+    size_t objectBytes = 0;
+    switch (type) {
+        case Type::BUILDING:
+            objectBytes = sizeof(Building) + sizeof(BuildingRenderComponent) + sizeof(BuildingPhysicsComponent) +
+                          2 * building.name.capacity();  // Building and its render component each copy the config
+            break;
+        case Type::WELL:
+            objectBytes = sizeof(Well) + sizeof(WellRenderComponent) + sizeof(WellPhysicsComponent) +
+                          sizeof(AudioEmitterComponent) + COMPONENT_NODE_BYTES;  // Water ambience emitter
+            break;
+        case Type::TREE:
+            objectBytes = sizeof(Tree) + sizeof(TreeRenderComponent) + sizeof(TreePhysicsComponent);
+            break;
+    }
+    return objectBytes + 2 * COMPONENT_NODE_BYTES + INDEX_BYTES_PER_OBJECT;
+}
+
+WorldStreamer::WorldStreamer(size_t memoryBudgetBytes) : budget_bytes_(memoryBudgetBytes) {}
+
+WorldStreamer::CellKey WorldStreamer::makeKey(int x, int z) {
+    return (uint64_t(uint32_t(x)) << 32) | uint32_t(z);
+}
+
+int WorldStreamer::toCell(float coord) {
+    return static_cast<int>(std::floor(coord / EnvironmentConstants::WORLD_CELL_SIZE));
+}
+
+float WorldStreamer::distanceToCell(const Cell& cell, const Vector3& pos) {
+    // Horizontal distance to the nearest point of the cell's square
+    const float size = EnvironmentConstants::WORLD_CELL_SIZE;
+    float minX = cell.x * size, minZ = cell.z * size;
+    float dx = pos.x - std::clamp(pos.x, minX, minX + size);
+    float dz = pos.z - std::clamp(pos.z, minZ, minZ + size);
+    return std::sqrt(dx * dx + dz * dz);
+}
+
+WorldStreamer::CellKey WorldStreamer::keyOf(const ObjectPlacement& placement) {
+    return makeKey(toCell(placement.position.x), toCell(placement.position.z));
+}
+
+void WorldStreamer::addPlacement(const ObjectPlacement& placement) {
+    int x = toCell(placement.position.x), z = toCell(placement.position.z);
+    Cell& cell = cells_[makeKey(x, z)];
+    cell.x = x;
+    cell.z = z;
+    cell.placements.push_back(placement);
+    cell.bytes += placement.estimateBytes();
+    dirty_ = true;
+}
+
+WorldStreamer::CellState WorldStreamer::getCellState(const Vector3& pos) const {
+    auto it = cells_.find(makeKey(toCell(pos.x), toCell(pos.z)));
+    return it != cells_.end() ? it->second.state : CellState::UNLOADED;
+}
+
+void WorldStreamer::update(EnvironmentManager& environment, const Vector3& cameraPos) {
+    // Late arrivals from cancelled loads were added during EnvironmentManager::update
+    if (!orphans_.empty()) {
+        environment.removeObjects(orphans_);
+        orphans_.clear();
+    }
+
+    // Cell membership only changes when the camera crosses a cell edge
+    CellKey cameraCell = makeKey(toCell(cameraPos.x), toCell(cameraPos.z));
+    if (cameraCell == last_camera_cell_ && !dirty_) return;
+    last_camera_cell_ = cameraCell;
+    dirty_ = false;
+
+    candidates_.clear();
+    for (auto& [key, cell] : cells_) {
+        float distance = distanceToCell(cell, cameraPos);
+        if (cell.state != CellState::UNLOADED && distance > EnvironmentConstants::STREAM_UNLOAD_RADIUS) {
+            beginUnload(cell);
+        } else if (cell.state == CellState::UNLOADED && distance <= EnvironmentConstants::STREAM_LOAD_RADIUS) {
+            candidates_.push_back(&cell);
+        }
+    }
+
+    std::sort(candidates_.begin(), candidates_.end(), [&cameraPos](const Cell* a, const Cell* b) {
+        return distanceToCell(*a, cameraPos) < distanceToCell(*b, cameraPos);
+    });
+
+    for (Cell* cell : candidates_) {
+        float distance = distanceToCell(*cell, cameraPos);
+        while (resident_bytes_ + cell->bytes > budget_bytes_) {
+            Cell* victim = farthestResident(cameraPos, distance);
+            if (!victim) break;
+            beginUnload(*victim);
+        }
+        if (resident_bytes_ + cell->bytes > budget_bytes_) {
+            // Everything resident is nearer than this cell; farther candidates won't fit either
+            std::cout << "WORLD STREAMER: Memory budget reached (" << resident_bytes_ << "/" << budget_bytes_
+                      << " bytes), deferring cell (" << cell->x << ", " << cell->z << ")" << std::endl;
+            break;
+        }
+        requestLoad(environment, *cell);
+    }
+
+    if (!unload_scratch_.empty()) {
+        environment.removeObjects(unload_scratch_);
+        unload_scratch_.clear();
+    }
+}
+
+size_t WorldStreamer::patchPlacements(EnvironmentManager& environment, const std::vector<ObjectPlacement>& removed,
+                                      const std::vector<ObjectPlacement>& added) {
+    std::vector<CellKey> keys;
+    keys.reserve(removed.size() + added.size());
+    for (const ObjectPlacement& placement : removed) keys.push_back(keyOf(placement));
+    for (const ObjectPlacement& placement : added) keys.push_back(keyOf(placement));
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    // Unload first: a loaded cell's bytes are in resident_bytes_ and must leave with the old set
+    size_t unloaded = 0;
+    for (CellKey key : keys) {
+        auto it = cells_.find(key);
+        if (it != cells_.end() && it->second.state != CellState::UNLOADED) {
+            beginUnload(it->second);
+            ++unloaded;
+        }
+    }
+
+    for (const ObjectPlacement& placement : removed) {
+        auto it = cells_.find(keyOf(placement));
+        if (it == cells_.end()) continue;
+        std::vector<ObjectPlacement>& placements = it->second.placements;
+        auto match = std::find_if(placements.begin(), placements.end(),
+                                  [&placement](const ObjectPlacement& p) { return samePlacement(p, placement); });
+        if (match != placements.end()) placements.erase(match);
+    }
+    for (const ObjectPlacement& placement : added) {
+        addPlacement(placement);
+    }
+    for (CellKey key : keys) {
+        auto it = cells_.find(key);
+        if (it == cells_.end()) continue;
+        it->second.bytes = 0;
+        for (const ObjectPlacement& placement : it->second.placements) {
+            it->second.bytes += placement.estimateBytes();
+        }
+    }
+
+    if (!unload_scratch_.empty()) {
+        environment.removeObjects(unload_scratch_);
+        unload_scratch_.clear();
+    }
+    dirty_ = true;
+    return unloaded;
+}
+
+void WorldStreamer::unloadAll(EnvironmentManager& environment) {
+    for (auto& [key, cell] : cells_) {
+        if (cell.state != CellState::UNLOADED) beginUnload(cell);
+    }
+    unload_scratch_.insert(unload_scratch_.end(), orphans_.begin(), orphans_.end());
+    orphans_.clear();
+    environment.removeObjects(unload_scratch_);
+    unload_scratch_.clear();
+    dirty_ = true;
+}
+
+void WorldStreamer::requestLoad(EnvironmentManager& environment, Cell& cell) {
+    cell.state = CellState::LOADING;
+    cell.requested = cell.placements.size();
+    cell.objects.reserve(cell.requested);
+    ++cell.generation;
+    resident_bytes_ += cell.bytes;
+    ++resident_cells_;
+
+    Cell* target = &cell;  // unordered_map nodes are stable and cells are never erased
+    uint32_t generation = cell.generation;
+    for (const ObjectPlacement& placement : cell.placements) {
+        environment.buildObjectAsync(
+            [placement] { return placement.create(); },
+            [this, target, generation](std::shared_ptr<EnvironmentalObject> obj) {
+                if (target->generation != generation) {
+                    orphans_.push_back(std::move(obj));
+                    return;
+                }
+                target->objects.push_back(std::move(obj));
+                if (target->objects.size() == target->requested) {
+                    target->state = CellState::RESIDENT;
+                }
+            });
+    }
+}
+
+void WorldStreamer::beginUnload(Cell& cell) {
+    for (auto& obj : cell.objects) {
+        unload_scratch_.push_back(std::move(obj));
+    }
+    cell.objects.clear();
+    cell.state = CellState::UNLOADED;
+    ++cell.generation;
+    resident_bytes_ -= cell.bytes;
+    --resident_cells_;
+}
+
+WorldStreamer::Cell* WorldStreamer::farthestResident(const Vector3& pos, float fartherThan) {
+    Cell* farthest = nullptr;
+    float farthestDistance = fartherThan;
+    for (auto& [key, cell] : cells_) {
+        if (cell.state == CellState::UNLOADED) continue;
+        float distance = distanceToCell(cell, pos);
+        if (distance > farthestDistance) {
+            farthest = &cell;
+            farthestDistance = distance;
+        }
+    }
+    return farthest;
+}
@@ -0,0 +1,116 @@
+#ifndef WORLD_STREAMER_H
+#define WORLD_STREAMER_H
+
+#include "raylib.h"
+#include "environmental_object.h"
+#include "constants.h"
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+class EnvironmentManager;
+
+/// \brief One object placement, resolved through EnvironmentalObjectFactory when its cell streams in.
+struct ObjectPlacement {
+    enum class Type : uint8_t { BUILDING, WELL, TREE };
+
+    Type type = Type::TREE;
+    Vector3 position = {0.0f, 0.0f, 0.0f};
+    BuildingConfig building;  // Used when type == BUILDING
+    WellConfig well;          // Used when type == WELL
+    TreeConfig tree;          // Used when type == TREE
+
+    /// \brief Creates the object. Never null; safe to call off the main thread.
+    std::shared_ptr<EnvironmentalObject> create() const;
+
+    /// \brief Rough resident size of the created object and its index entries, for the memory budget.
+    size_t estimateBytes() const;
+};
+
+/// \brief Streams world cells in and out of an EnvironmentManager by distance from the camera.
+///
+/// Cells are square columns of EnvironmentConstants::WORLD_CELL_SIZE on the XZ plane.
+/// Cells inside the load radius are requested through the async loader, nearest first;
+/// cells beyond the (larger) unload radius are removed from the manager. The gap between
+/// the two radii stops cells thrashing at a boundary. Resident plus in-flight cells never
+/// exceed the memory budget: a nearer cell evicts the farthest resident one, and if none is
+/// farther the load waits.
+class WorldStreamer {
+public:
+    enum class CellState : uint8_t { UNLOADED, LOADING, RESIDENT };
+
+    /// \brief Constructor.
+    /// \param memoryBudgetBytes Cap on estimated bytes of resident and loading cells.
+    explicit WorldStreamer(size_t memoryBudgetBytes = EnvironmentConstants::STREAM_MEMORY_BUDGET_BYTES);
+
+    /// \brief Adds a placement to the cell containing its position. Register before the cell first loads.
+    /// \param placement Placement to add.
+    void addPlacement(const ObjectPlacement& placement);
+
+    /// \brief Loads and unloads cells around the camera. Call once per frame after EnvironmentManager::update.
+    /// \param environment Manager receiving the objects.
+    /// \param cameraPos Camera position.
+    void update(EnvironmentManager& environment, const Vector3& cameraPos);
+
+    /// \brief Swaps placements in place, e.g. after a world pack is edited. Only the cells they
+    /// fall in are touched: any that are loaded are unloaded, and reload with their new
+    /// placements on the next update if still in range.
+    /// \param environment Manager holding the cells' objects.
+    /// \param removed Placements to drop; each must match one added earlier exactly.
+    /// \param added Placements to add.
+    /// \return Number of loaded cells that had to be unloaded.
+    size_t patchPlacements(EnvironmentManager& environment, const std::vector<ObjectPlacement>& removed,
+                           const std::vector<ObjectPlacement>& added);
+
+    /// \brief Removes every streamed object from the manager.
+    /// \param environment Manager holding the objects.
+    void unloadAll(EnvironmentManager& environment);
+
+    /// \brief Gets the state of the cell containing a world position.
+    CellState getCellState(const Vector3& pos) const;
+
+    size_t getCellCount() const { return cells_.size(); }
+    size_t getResidentCellCount() const { return resident_cells_; }
+    size_t getResidentBytes() const { return resident_bytes_; }
+    size_t getMemoryBudget() const { return budget_bytes_; }
+
+private:
+    using CellKey = uint64_t;
+
+    struct Cell {
+        int x = 0, z = 0;
+        std::vector<ObjectPlacement> placements;
+        std::vector<std::shared_ptr<EnvironmentalObject>> objects;  // Live objects while loading/resident
+        size_t bytes = 0;            // Sum of placement estimates
+        size_t requested = 0;        // Placements handed to the loader this load
+        uint32_t generation = 0;     // Bumped per load/unload so late arrivals from a cancelled load are spotted
+        CellState state = CellState::UNLOADED;
+    };
+
+    std::unordered_map<CellKey, Cell> cells_;
+    size_t budget_bytes_;
+    size_t resident_bytes_ = 0;      // Resident + loading cells
+    size_t resident_cells_ = 0;
+    CellKey last_camera_cell_ = ~CellKey(0);
+    bool dirty_ = true;              // Re-evaluate even if the camera stayed in its cell
+
+    // Per-update scratch, kept to avoid reallocating
+    std::vector<Cell*> candidates_;
+    std::vector<std::shared_ptr<EnvironmentalObject>> unload_scratch_;
+    // Objects that arrived for a cell unloaded mid-load; removed on the next update once added
+    std::vector<std::shared_ptr<EnvironmentalObject>> orphans_;
+
+    static CellKey makeKey(int x, int z);
+    static CellKey keyOf(const ObjectPlacement& placement);
+    static int toCell(float coord);
+    static float distanceToCell(const Cell& cell, const Vector3& pos);
+
+    void requestLoad(EnvironmentManager& environment, Cell& cell);
+    /// \brief Queues a loading or resident cell's objects for removal; the caller flushes unload_scratch_.
+    void beginUnload(Cell& cell);
+    Cell* farthestResident(const Vector3& pos, float fartherThan);
+};
+
+#endif